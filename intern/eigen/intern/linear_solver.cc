@@ -21,7 +21,9 @@
 
 typedef Eigen::SparseMatrix<double, Eigen::ColMajor> EigenSparseMatrix;
 typedef Eigen::SparseLU<EigenSparseMatrix> EigenSparseLU;
+typedef Eigen::SimplicialLDLT<EigenSparseMatrix> EigenSparseLDLT;
 typedef Eigen::VectorXd EigenVectorX;
+typedef Eigen::MatrixXd EigenMatrixX;
 typedef Eigen::Triplet<double> EigenTriplet;
 
 /* Linear Solver data structure */
@@ -63,6 +65,8 @@ struct LinearSolver {
     m = 0;
     n = 0;
     sparseLU = NULL;
+    sparseLDLT = NULL;
+    use_cholesky = false;
     num_variables = num_variables_;
     num_rhs = num_rhs_;
     num_rows = num_rows_;
@@ -74,6 +78,7 @@ struct LinearSolver {
   ~LinearSolver()
   {
     delete sparseLU;
+    delete sparseLDLT;
   }
 
   State state;
@@ -88,6 +93,8 @@ struct LinearSolver {
   std::vector<EigenVectorX> x;
 
   EigenSparseLU *sparseLU;
+  EigenSparseLDLT *sparseLDLT;
+  bool use_cholesky;
 
   int num_variables;
   std::vector<Variable> variable;
@@ -113,6 +120,13 @@ void EIG_linear_solver_delete(LinearSolver *solver)
   delete solver;
 }
 
+void EIG_linear_least_squares_solver_use_cholesky(LinearSolver *solver)
+{
+  assert(solver->least_squares);
+  assert(solver->state != LinearSolver::STATE_MATRIX_SOLVED);
+  solver->use_cholesky = true;
+}
+
 /* Variables */
 
 void EIG_linear_solver_variable_set(LinearSolver *solver, int rhs, int index, double value)
@@ -277,18 +291,32 @@ bool EIG_linear_solver_solve(LinearSolver *solver)
     EigenSparseMatrix &M = (solver->least_squares) ? solver->MtM : solver->M;
     M.makeCompressed();
 
+    /* AtA is symmetric, use a sparse Cholesky factorization when requested */
+    if (solver->least_squares && solver->use_cholesky) {
+      EigenSparseLDLT *sparseLDLT = new EigenSparseLDLT(M);
+      if (sparseLDLT->info() == Eigen::Success) {
+        solver->sparseLDLT = sparseLDLT;
+      }
+      else {
+        delete sparseLDLT;
+      }
+    }
+
     /* perform sparse LU factorization */
-    EigenSparseLU *sparseLU = new EigenSparseLU();
-    solver->sparseLU = sparseLU;
+    if (solver->sparseLDLT == NULL) {
+      EigenSparseLU *sparseLU = new EigenSparseLU();
+      solver->sparseLU = sparseLU;
 
-    sparseLU->compute(M);
-    result = (sparseLU->info() == Eigen::Success);
+      sparseLU->compute(M);
+      result = (sparseLU->info() == Eigen::Success);
+    }
 
     solver->state = LinearSolver::STATE_MATRIX_SOLVED;
   }
 
   if (result) {
-    /* solve for each right hand side */
+    EigenMatrixX B(solver->m, solver->num_rhs);
+
     for (int rhs = 0; rhs < solver->num_rhs; rhs++) {
       /* modify for locked variables */
       EigenVectorX &b = solver->b[rhs];
@@ -304,22 +332,31 @@ bool EIG_linear_solver_solve(LinearSolver *solver)
         }
       }
 
-      /* solve */
-      if (solver->least_squares) {
-        EigenVectorX Mtb = solver->M.transpose() * b;
-        solver->x[rhs] = solver->sparseLU->solve(Mtb);
-      }
-      else {
-        EigenVectorX &b = solver->b[rhs];
-        solver->x[rhs] = solver->sparseLU->solve(b);
-      }
+      B.col(rhs) = b;
+    }
 
-      if (solver->sparseLU->info() != Eigen::Success)
-        result = false;
+    /* solve all right hand sides at once */
+    if (solver->least_squares) {
+      EigenMatrixX MtB = solver->M.transpose() * B;
+      B = MtB;
     }
 
-    if (result)
+    EigenMatrixX X;
+    if (solver->sparseLDLT) {
+      X = solver->sparseLDLT->solve(B);
+      result = (solver->sparseLDLT->info() == Eigen::Success);
+    }
+    else {
+      X = solver->sparseLU->solve(B);
+      result = (solver->sparseLU->info() == Eigen::Success);
+    }
+
+    if (result) {
+      for (int rhs = 0; rhs < solver->num_rhs; rhs++)
+        solver->x[rhs] = X.col(rhs);
+
       linear_solver_vector_to_variables(solver);
+    }
   }
 
   /* clear for next solve */
@@ -27,6 +27,11 @@ LinearSolver *EIG_linear_least_squares_solver_new(int num_rows,
 
 void EIG_linear_solver_delete(LinearSolver *solver);
 
+/* Factorize AtA of a least squares solver with a sparse Cholesky decomposition instead of LU,
+ * which is faster for well constrained systems. Falls back to LU when the decomposition fails.
+ * Must be called before the first solve. */
+void EIG_linear_least_squares_solver_use_cholesky(LinearSolver *solver);
+
 /* Variables (x). Any locking must be done before matrix construction. */
 
 void EIG_linear_solver_variable_set(LinearSolver *solver, int rhs, int index, double value);
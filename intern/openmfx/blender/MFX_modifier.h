@@ -49,6 +49,8 @@
 extern "C" {
 #endif
 
+struct ReportList;
+
 // A C-enum version of OpenMfx::ParameterType
 enum MfxParamType {
   PARAM_TYPE_UNKNOWN = -1,
@@ -111,6 +113,21 @@ void MFX_modifier_copydata(OpenMfxModifierData *source,
 
 void MFX_modifier_before_update_depsgraph(OpenMfxModifierData *fxmd);
 
+/**
+ * Block until all the frames cooked while MOD_OPENMFX_CACHE_BAKING was set are written to disk.
+ * \param reports: receives the frames that could not be baked.
+ * \return false if any frame could not be baked.
+ */
+bool MFX_modifier_bake_wait(struct ReportList *reports);
+
+/**
+ * Delete the baked frames of the modifier and release the ones mapped for playback, both by
+ * the original modifier and by its evaluated copy in the depsgraph.
+ */
+void MFX_modifier_bake_free(OpenMfxModifierData *fxmd,
+                            struct Depsgraph *depsgraph,
+                            Object *object);
+
 #ifdef __cplusplus
 }
 #endif
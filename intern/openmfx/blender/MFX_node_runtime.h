@@ -27,6 +27,7 @@
 struct bNode;
 namespace OpenMfx {
 class EffectLibrary;
+class EffectInstancePool;
 }
 
 namespace blender::nodes::node_geo_open_mfx_cc {
@@ -38,6 +39,7 @@ namespace blender::nodes::node_geo_open_mfx_cc {
 class RuntimeData {
  public:
    using EffectLibrary = OpenMfx::EffectLibrary;
+   using EffectInstancePool = OpenMfx::EffectInstancePool;
 
  public:
   RuntimeData();
@@ -51,7 +53,11 @@ class RuntimeData {
   void clearMustUpdate();
 
   OfxMeshEffectHandle effectDescriptor() const;
-  OfxMeshEffectHandle effectInstance() const;
+  /**
+   * Instances of the effect, one per concurrent evaluation of the node, or nullptr if the effect
+   * could not be instantiated.
+   */
+  EffectInstancePool *instancePool() const;
   const EffectLibrary &library() const;
   bool mustUpdate() const;
   bool isLibraryLoaded() const;
@@ -60,15 +66,15 @@ class RuntimeData {
   // Release the current plugin registry and reset
   void unloadPlugin();
 
-  void ensureEffectInstance();
-  void freeEffectInstance();
+  void ensureInstancePool();
+  void freeInstancePool();
 
  private:
   bool m_must_update;
   char m_loaded_plugin_path[1024];
   int m_loaded_effect_index;
   OfxMeshEffectHandle m_effect_descriptor;
-  OfxMeshEffectHandle m_effect_instance;
+  EffectInstancePool *m_instance_pool;
   EffectLibrary *m_library;
 };
 
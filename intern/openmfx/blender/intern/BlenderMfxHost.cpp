@@ -33,6 +33,7 @@
 #include "BKE_mesh.h" // BKE_mesh_new_nomain
 #include "BKE_main.h" // BKE_main_blendfile_path_from_global
 #include "BKE_customdata.h"
+#include "BKE_lib_id.h" // BKE_id_free
 
 #include "BLI_math_vector.h"
 #include "BLI_string.h"
@@ -41,10 +42,15 @@
 #include "FN_field.hh" // FieldEvaluator
 
 #include "MFX_util.h"
+#include "mesh_chunks.h"
 
+#include <algorithm>
 #include <cassert>
 
 using blender::GVArray;
+using blender::modifiers::modifier_open_mfx_cc::ChunkedMeshBuilder;
+using blender::modifiers::modifier_open_mfx_cc::MeshChunk;
+using blender::modifiers::modifier_open_mfx_cc::MeshChunker;
 using OpenMfx::AttributeProps;
 
 #ifndef max
@@ -61,6 +67,8 @@ BlenderMfxHost &BlenderMfxHost::GetInstance()
   return d;
 }
 
+thread_local bool BlenderMfxHost::s_deactivateBeforeAllocateCb = false;
+
 // ----------------------------------------------------------------------------
 
 #pragma region [BeforeMeshGet]
@@ -77,11 +85,23 @@ OfxStatus BlenderMfxHost::BeforeMeshGet(OfxMeshHandle ofxMesh)
     return kOfxStatErrBadHandle;
   }
 
+  int chunkIndex = -1;
+  MFX_CHECK(propertySuite->propGetInt(&ofxMesh->properties, kOfxMeshPropChunkIndex, 0, &chunkIndex));
+
   switch (internalData->type) {
     case CallbackContext::Modifier:
+      if (chunkIndex >= 0) {
+        return BeforeMeshGetModifierChunk(
+            ofxMesh, *reinterpret_cast<MeshInternalDataModifier *>(internalData), chunkIndex);
+      }
       return BeforeMeshGetModifier(ofxMesh,
                                    *reinterpret_cast<MeshInternalDataModifier *>(internalData));
     case CallbackContext::Node:
+      // The node does not split meshes, so it exposes them as a single chunk
+      if (chunkIndex > 0) {
+        return kOfxStatErrBadIndex;
+      }
+      MFX_CHECK(propertySuite->propSetInt(&ofxMesh->properties, kOfxMeshPropChunkCount, 0, 1));
       return BeforeMeshGetNode(ofxMesh,
                                *reinterpret_cast<MeshInternalDataNode *>(internalData));
     default:
@@ -131,9 +151,9 @@ OfxStatus BlenderMfxHost::BeforeMeshGetModifier(OfxMeshHandle ofxMesh,
   setupPointWeightAttributes(ofxMesh, "pointWeight", blenderMesh, counts, afterAllocate);
 
   // finished adding attributes, allocate any requested buffers
-  m_deactivateBeforeAllocateCb = true;
+  s_deactivateBeforeAllocateCb = true;
   MFX_CHECK(meshEffectSuite->meshAlloc(ofxMesh));
-  m_deactivateBeforeAllocateCb = false;
+  s_deactivateBeforeAllocateCb = false;
 
   for (auto &callback : afterAllocate) {
     callback();
@@ -144,6 +164,87 @@ OfxStatus BlenderMfxHost::BeforeMeshGetModifier(OfxMeshHandle ofxMesh,
 
 // ----------------------------------------------------------------------------
 
+OfxStatus BlenderMfxHost::BeforeMeshGetModifierChunk(OfxMeshHandle ofxMesh,
+                                                     MeshInternalDataModifier &internalData,
+                                                     int chunkIndex)
+{
+  ElementCounts counts;
+
+  if (NULL == internalData.object) {
+    return kOfxStatErrBadHandle;
+  }
+
+  propSetTransformMatrix(&ofxMesh->properties, internalData.object);
+
+  if (false == internalData.header.is_input) {
+    return setupElementCounts(&ofxMesh->properties, counts);
+  }
+
+  const Mesh *blenderMesh = internalData.blender_mesh;
+  if (NULL == blenderMesh) {
+    return kOfxStatErrBadHandle;
+  }
+
+  int chunkSize = 0;
+  MFX_CHECK(propertySuite->propGetInt(&ofxMesh->properties, kOfxMeshPropChunkSize, 0, &chunkSize));
+  if (chunkSize <= 0) {
+    // Chunks were not requested at describe time, expose the whole mesh as a single chunk
+    chunkSize = max(blenderMesh->totpoly + blenderMesh->totedge, 1);
+  }
+
+  // The partition is computed once and reused for all chunks of the cook
+  if (nullptr == internalData.chunker || internalData.chunker->max_chunk_size() != chunkSize) {
+    internalData.chunker = std::make_shared<MeshChunker>(blenderMesh, chunkSize);
+    internalData.chunk = std::make_shared<MeshChunk>();
+  }
+
+  const int chunkCount = internalData.chunker->chunk_count();
+  MFX_CHECK(propertySuite->propSetInt(&ofxMesh->properties, kOfxMeshPropChunkCount, 0, chunkCount));
+  if (chunkIndex >= chunkCount) {
+    propFreeTransformMatrix(&ofxMesh->properties);
+    return kOfxStatErrBadIndex;
+  }
+
+  MeshChunk &chunk = *internalData.chunk;
+  internalData.chunker->build_chunk(chunkIndex, chunk);
+
+  counts.ofxPointCount = chunk.point_count();
+  counts.ofxCornerCount = chunk.corner_count();
+  counts.ofxFaceCount = chunk.face_count();
+  counts.ofxNoLooseEdge = chunk.has_loose_edges ? 0 : 1;
+  MFX_CHECK(setupElementCounts(&ofxMesh->properties, counts));
+
+  // Point the attributes to the chunk buffers, that remain valid until the next chunk
+  OfxPropertySetHandle attrib;
+  MFX_CHECK(meshEffectSuite->meshGetAttribute(ofxMesh, kOfxMeshAttribPoint, kOfxMeshAttribPointPosition, &attrib));
+  MFX_CHECK(propertySuite->propSetInt(attrib, kOfxMeshAttribPropIsOwner, 0, 0));
+  MFX_CHECK(propertySuite->propSetPointer(attrib, kOfxMeshAttribPropData, 0, (void *)chunk.point_positions.data()));
+  MFX_CHECK(propertySuite->propSetInt(attrib, kOfxMeshAttribPropStride, 0, 3 * sizeof(float)));
+
+  MFX_CHECK(meshEffectSuite->meshGetAttribute(ofxMesh, kOfxMeshAttribCorner, kOfxMeshAttribCornerPoint, &attrib));
+  MFX_CHECK(propertySuite->propSetInt(attrib, kOfxMeshAttribPropIsOwner, 0, 0));
+  MFX_CHECK(propertySuite->propSetPointer(attrib, kOfxMeshAttribPropData, 0, (void *)chunk.corner_points.data()));
+  MFX_CHECK(propertySuite->propSetInt(attrib, kOfxMeshAttribPropStride, 0, sizeof(int)));
+
+  MFX_CHECK(meshEffectSuite->meshGetAttribute(ofxMesh, kOfxMeshAttribFace, kOfxMeshAttribFaceSize, &attrib));
+  MFX_CHECK(propertySuite->propSetInt(attrib, kOfxMeshAttribPropIsOwner, 0, 0));
+  MFX_CHECK(propertySuite->propSetPointer(attrib, kOfxMeshAttribPropData, 0, (void *)chunk.face_sizes.data()));
+  MFX_CHECK(propertySuite->propSetInt(attrib, kOfxMeshAttribPropStride, 0, sizeof(int)));
+
+  MFX_CHECK(meshEffectSuite->attributeDefine(ofxMesh, kOfxMeshAttribPoint, kOfxMeshAttribPointGlobalIndex, 1, kOfxMeshAttribTypeInt, NULL, &attrib));
+  MFX_CHECK(propertySuite->propSetInt(attrib, kOfxMeshAttribPropIsOwner, 0, 0));
+  MFX_CHECK(propertySuite->propSetPointer(attrib, kOfxMeshAttribPropData, 0, (void *)chunk.point_global_indices.data()));
+  MFX_CHECK(propertySuite->propSetInt(attrib, kOfxMeshAttribPropStride, 0, sizeof(int)));
+
+  s_deactivateBeforeAllocateCb = true;
+  MFX_CHECK(meshEffectSuite->meshAlloc(ofxMesh));
+  s_deactivateBeforeAllocateCb = false;
+
+  return kOfxStatOK;
+}
+
+// ----------------------------------------------------------------------------
+
 OfxStatus BlenderMfxHost::BeforeMeshGetNode(OfxMeshHandle ofxMesh,
                                             MeshInternalDataNode &internalData)
 {
@@ -177,9 +278,9 @@ OfxStatus BlenderMfxHost::BeforeMeshGetNode(OfxMeshHandle ofxMesh,
   setupRequestedAttributes(ofxMesh, internalData.requestedAttributes, afterAllocate);
 
   // finished adding attributes, allocate any requested buffers
-  m_deactivateBeforeAllocateCb = true;
+  s_deactivateBeforeAllocateCb = true;
   MFX_CHECK(meshEffectSuite->meshAlloc(ofxMesh));
-  m_deactivateBeforeAllocateCb = false;
+  s_deactivateBeforeAllocateCb = false;
 
   for (auto &callback : afterAllocate) {
     callback();
@@ -211,8 +312,15 @@ OfxStatus BlenderMfxHost::BeforeMeshRelease(OfxMeshHandle ofxMesh)
     return kOfxStatOK;
   }
 
+  int chunkIndex = -1;
+  MFX_CHECK(propertySuite->propGetInt(&ofxMesh->properties, kOfxMeshPropChunkIndex, 0, &chunkIndex));
+
   switch (internalData->type) {
     case CallbackContext::Modifier:
+      if (chunkIndex >= 0) {
+        return BeforeMeshReleaseModifierChunk(
+            ofxMesh, *reinterpret_cast<MeshInternalDataModifier *>(internalData));
+      }
       return BeforeMeshReleaseModifier(ofxMesh,
                                        *reinterpret_cast<MeshInternalDataModifier *>(internalData));
     case CallbackContext::Node:
@@ -287,6 +395,7 @@ OfxStatus BlenderMfxHost::BeforeMeshReleaseModifier(OfxMeshHandle ofxMesh,
 
   extractBasicAttributes(pointPosition, cornerPoint, faceSize, blenderMesh, counts);
   extractUvAttributes(ofxMesh, blenderMesh, counts);
+  extractColorAttributes(ofxMesh, blenderMesh, counts);
 
   if (counts.blenderPolygonCount > 0) {
     // if we're here, this dominates before_mesh_get()/before_mesh_release() total running time!
@@ -304,6 +413,60 @@ OfxStatus BlenderMfxHost::BeforeMeshReleaseModifier(OfxMeshHandle ofxMesh,
 
 // ----------------------------------------------------------------------------
 
+OfxStatus BlenderMfxHost::BeforeMeshReleaseModifierChunk(OfxMeshHandle ofxMesh,
+                                                         MeshInternalDataModifier &internalData)
+{
+  ElementCounts counts;
+
+  propFreeTransformMatrix(&ofxMesh->properties);
+
+  // Unlike BeforeMeshReleaseModifier, the internal data is kept for the next chunks
+  OfxStatus status = countMeshElements(ofxMesh, counts);
+  if (kOfxStatOK != status) {
+    return status;
+  }
+
+  AttributeProps pointPosition, cornerPoint, faceSize, globalIndex;
+  pointPosition.fetchProperties(propertySuite, meshEffectSuite, ofxMesh, kOfxMeshAttribPoint, kOfxMeshAttribPointPosition);
+  cornerPoint.fetchProperties(propertySuite, meshEffectSuite, ofxMesh, kOfxMeshAttribCorner, kOfxMeshAttribCornerPoint);
+  faceSize.fetchProperties(propertySuite, meshEffectSuite, ofxMesh, kOfxMeshAttribFace, kOfxMeshAttribFaceSize);
+  if (kOfxStatOK != globalIndex.fetchProperties(propertySuite, meshEffectSuite, ofxMesh, kOfxMeshAttribPoint, kOfxMeshAttribPointGlobalIndex) ||
+      OpenMfx::AttributeType::Int != globalIndex.type) {
+    globalIndex.data = nullptr;
+  }
+
+  if ((nullptr == pointPosition.data && counts.ofxPointCount > 0) ||
+      (nullptr == cornerPoint.data && counts.ofxCornerCount > 0) ||
+      (nullptr == faceSize.data && counts.ofxFaceCount > 0 && -1 == counts.ofxConstantFaceSize)) {
+    printf("WARNING: Null data pointers\n");
+    return kOfxStatErrBadHandle;
+  }
+
+  if (nullptr == internalData.chunk_builder) {
+    internalData.chunk_builder = std::make_shared<ChunkedMeshBuilder>();
+  }
+
+  // Invalid chunks are dropped, the error gets reported on the modifier once the output is built
+  if (!internalData.chunk_builder->append_chunk(counts.ofxPointCount,
+                                                pointPosition.data,
+                                                pointPosition.stride,
+                                                globalIndex.data,
+                                                globalIndex.stride,
+                                                counts.ofxCornerCount,
+                                                cornerPoint.data,
+                                                cornerPoint.stride,
+                                                counts.ofxFaceCount,
+                                                faceSize.data,
+                                                faceSize.stride,
+                                                counts.ofxConstantFaceSize)) {
+    return kOfxStatErrBadIndex;
+  }
+
+  return kOfxStatOK;
+}
+
+// ----------------------------------------------------------------------------
+
 OfxStatus BlenderMfxHost::BeforeMeshReleaseNode(OfxMeshHandle ofxMesh,
                                                 MeshInternalDataNode &internalData)
 {
@@ -352,7 +515,12 @@ OfxStatus BlenderMfxHost::BeforeMeshReleaseNode(OfxMeshHandle ofxMesh,
 
   extractBasicAttributes(pointPosition, cornerPoint, faceSize, blenderMesh, counts);
   //extractUvAttributes(ofxMesh, blenderMesh, counts);
-  extractExpectedAttributes(ofxMesh, internalData.requestedAttributes, internalData.outputAttributes, blenderMesh, counts);
+  status = extractExpectedAttributes(
+      ofxMesh, internalData.requestedAttributes, internalData.outputAttributes, blenderMesh, counts);
+  if (kOfxStatOK != status) {
+    BKE_id_free(nullptr, blenderMesh);
+    return status;
+  }
 
   if (counts.blenderPolygonCount > 0) {
     // if we're here, this dominates before_mesh_get()/before_mesh_release() total running time!
@@ -377,7 +545,7 @@ OfxStatus BlenderMfxHost::BeforeMeshReleaseNode(OfxMeshHandle ofxMesh,
 
 OfxStatus BlenderMfxHost::BeforeMeshAllocate(OfxMeshHandle ofxMesh)
 {
-  if (m_deactivateBeforeAllocateCb) {
+  if (s_deactivateBeforeAllocateCb) {
     return kOfxStatOK;
   }
 
@@ -740,18 +908,19 @@ OfxStatus BlenderMfxHost::setupCornerColorAttributes(OfxMeshHandle ofxMesh,
                                                      const ElementCounts &counts,
                                                      CallbackList &afterAllocate) const
 {
-  int layerCount = CustomData_number_of_layers(&blenderMesh->ldata, CD_PROP_COLOR);
+  // Byte colors are shared at their native width, the plugin gets normalized bytes
+  int byteLayerCount = CustomData_number_of_layers(&blenderMesh->ldata, CD_PROP_BYTE_COLOR);
   char name[MAX_ATTRIB_NAME];
-  for (int k = 0; k < layerCount; ++k) {
+  for (int k = 0; k < byteLayerCount; ++k) {
     sprintf(name, "%s%d", prefix, k);
 
     MLoopCol *vcolorData = (MLoopCol *)CustomData_get_layer_n(
-        &blenderMesh->ldata, CD_PROP_COLOR, k);
+        &blenderMesh->ldata, CD_PROP_BYTE_COLOR, k);
     if (nullptr != vcolorData) {
       setupCornerAttribute(ofxMesh,
                            name,
-                           3,
-                           kOfxMeshAttribTypeUByte,
+                           4,
+                           kOfxMeshAttribTypeUByteNormalized,
                            kOfxMeshAttribSemanticColor,
                            (char *)&vcolorData[0].r,
                            sizeof(MLoopCol),
@@ -760,6 +929,25 @@ OfxStatus BlenderMfxHost::setupCornerColorAttributes(OfxMeshHandle ofxMesh,
     }
   }
 
+  int floatLayerCount = CustomData_number_of_layers(&blenderMesh->ldata, CD_PROP_COLOR);
+  for (int k = 0; k < floatLayerCount; ++k) {
+    sprintf(name, "%s%d", prefix, byteLayerCount + k);
+
+    MPropCol *vcolorData = (MPropCol *)CustomData_get_layer_n(
+        &blenderMesh->ldata, CD_PROP_COLOR, k);
+    if (nullptr != vcolorData) {
+      setupCornerAttribute(ofxMesh,
+                           name,
+                           4,
+                           kOfxMeshAttribTypeFloat,
+                           kOfxMeshAttribSemanticColor,
+                           (char *)&vcolorData[0].color[0],
+                           sizeof(MPropCol),
+                           counts,
+                           afterAllocate);
+    }
+  }
+
   return kOfxStatOK;
 }
 
@@ -1028,8 +1216,7 @@ OfxStatus BlenderMfxHost::extractUvAttributes(OfxMeshHandle ofxMesh,
     status = meshEffectSuite->meshGetAttribute(ofxMesh, kOfxMeshAttribCorner, name, &uv_attrib);
     if (kOfxStatOK == status) {
       printf("Found!\n");
-      MFX_CHECK(propertySuite->propGetPointer(uv_attrib, kOfxMeshAttribPropData, 0, (void **)&uv_props.data));
-      MFX_CHECK(propertySuite->propGetInt(uv_attrib, kOfxMeshAttribPropStride, 0, &uv_props.stride));
+      MFX_CHECK(uv_props.fetchProperties(propertySuite, uv_attrib));
 
       if (counts.blenderLooseEdgeCount > 0) {
         // TODO implement OFX->Blender UV conversion for loose edge meshes
@@ -1050,10 +1237,19 @@ OfxStatus BlenderMfxHost::extractUvAttributes(OfxMeshHandle ofxMesh,
       MLoopUV *uv_data = (MLoopUV *)CustomData_duplicate_referenced_layer_named(
           &blenderMesh->ldata, CD_MLOOPUV, uvname, counts.ofxCornerCount);
 
-      for (int i = 0; i < counts.ofxCornerCount; ++i) {
-        float *uv = uv_props.at<float>(i);
-        uv_data[i].uv[0] = uv[0];
-        uv_data[i].uv[1] = uv[1];
+      if (OpenMfx::AttributeType::Half == uv_props.type) {
+        for (int i = 0; i < counts.ofxCornerCount; ++i) {
+          const uint16_t *uv = uv_props.at<uint16_t>(i);
+          uv_data[i].uv[0] = OpenMfx::halfToFloat(uv[0]);
+          uv_data[i].uv[1] = OpenMfx::halfToFloat(uv[1]);
+        }
+      }
+      else {
+        for (int i = 0; i < counts.ofxCornerCount; ++i) {
+          float *uv = uv_props.at<float>(i);
+          uv_data[i].uv[0] = uv[0];
+          uv_data[i].uv[1] = uv[1];
+        }
       }
       // elie: What is the new way to signal dirtyness? Or is it no longer required?
       //blenderMesh->runtime.cd_dirty_loop |= CD_MASK_MLOOPUV;
@@ -1064,6 +1260,95 @@ OfxStatus BlenderMfxHost::extractUvAttributes(OfxMeshHandle ofxMesh,
   return kOfxStatOK;
 }
 
+OfxStatus BlenderMfxHost::extractColorAttributes(OfxMeshHandle ofxMesh,
+                                                 Mesh *blenderMesh,
+                                                 const ElementCounts &counts) const
+{
+  if (counts.blenderLooseEdgeCount > 0) {
+    // Same limitation as for UVs, see extractUvAttributes()
+    return kOfxStatOK;
+  }
+
+  char name[MAX_ATTRIB_NAME];
+  int byteLayerIndex = 0, floatLayerIndex = 0;
+  for (int k = 0;; ++k) {
+    OfxPropertySetHandle color_attrib;
+    sprintf(name, "color%d", k);
+    if (kOfxStatOK != meshEffectSuite->meshGetAttribute(
+                          ofxMesh, kOfxMeshAttribCorner, name, &color_attrib)) {
+      break;
+    }
+
+    AttributeProps color_props;
+    MFX_CHECK(color_props.fetchProperties(propertySuite, color_attrib));
+    if (nullptr == color_props.data || color_props.componentCount < 3) {
+      continue;
+    }
+    const int componentCount = std::min(color_props.componentCount, 4);
+
+    switch (color_props.type) {
+      case OpenMfx::AttributeType::UByte:
+      case OpenMfx::AttributeType::UByteNormalized: {
+        // Native width, no conversion needed
+        MLoopCol *color_data = (MLoopCol *)ensureCornerLayer(
+            blenderMesh, CD_PROP_BYTE_COLOR, byteLayerIndex++, name, counts.ofxCornerCount);
+        if (componentCount == 4 && color_props.stride == sizeof(MLoopCol)) {
+          if ((char *)color_data != color_props.data) {
+            memcpy(color_data, color_props.data, sizeof(MLoopCol) * counts.ofxCornerCount);
+          }
+          break;
+        }
+        for (int i = 0; i < counts.ofxCornerCount; ++i) {
+          const unsigned char *color = color_props.at<unsigned char>(i);
+          unsigned char *dst = &color_data[i].r;
+          dst[3] = 255;
+          for (int c = 0; c < componentCount; ++c) {
+            dst[c] = color[c];
+          }
+        }
+        break;
+      }
+      case OpenMfx::AttributeType::Float:
+      case OpenMfx::AttributeType::Half:
+      case OpenMfx::AttributeType::Int:
+      case OpenMfx::AttributeType::Int8:
+      case OpenMfx::AttributeType::Int16: {
+        // Integer colors are widened to float colors, with their values kept as is
+        MPropCol *color_data = (MPropCol *)ensureCornerLayer(
+            blenderMesh, CD_PROP_COLOR, floatLayerIndex++, name, counts.ofxCornerCount);
+        for (int i = 0; i < counts.ofxCornerCount; ++i) {
+          color_data[i].color[3] = 1.0f;
+        }
+        MFX_ENSURE(OpenMfx::copyAttributeComponents(OpenMfx::AttributeType::Float,
+                                                    (char *)color_data,
+                                                    sizeof(MPropCol),
+                                                    color_props.type,
+                                                    color_props.data,
+                                                    color_props.stride,
+                                                    componentCount,
+                                                    0,
+                                                    counts.ofxCornerCount));
+        break;
+      }
+      default:
+        printf("WARNING: unsupported type for color attribute '%s'\n", name);
+        break;
+    }
+  }
+
+  return kOfxStatOK;
+}
+
+void *BlenderMfxHost::ensureCornerLayer(
+    Mesh *blenderMesh, int type, int n, const char *name, int cornerCount)
+{
+  if (n < CustomData_number_of_layers(&blenderMesh->ldata, type)) {
+    return CustomData_duplicate_referenced_layer_n(&blenderMesh->ldata, type, n, cornerCount);
+  }
+  return CustomData_add_layer_named(
+      &blenderMesh->ldata, type, CD_CALLOC, nullptr, cornerCount, name);
+}
+
 OfxStatus BlenderMfxHost::extractExpectedAttributes(
     OfxMeshHandle ofxMesh,
     const std::vector<OfxAttributeStruct>& requestedAttributes,
@@ -1073,8 +1358,8 @@ OfxStatus BlenderMfxHost::extractExpectedAttributes(
 {
   MeshComponent component;
   component.replace(blenderMesh, GeometryOwnershipType::Editable);
-  int i = 0;
-  for (const auto &requestedAttrib : requestedAttributes) {
+  for (size_t i = 0; i < requestedAttributes.size(); ++i) {
+    const OfxAttributeStruct &requestedAttrib = requestedAttributes[i];
     auto key = std::make_pair(requestedAttrib.attachment(), requestedAttrib.name());
     int idx = ofxMesh->attributes.find(key);
     if (idx == -1) {
@@ -1088,15 +1373,53 @@ OfxStatus BlenderMfxHost::extractExpectedAttributes(
     
     //blender::bke::StrongAnonymousAttributeID id(requestedAttrib.name());
     const eAttrDomain domain = ATTR_DOMAIN_POINT;  // TODO
-    blender::bke::SpanAttributeWriter<float> attribute;
-    attribute = component.attributes_for_write()->lookup_or_add_for_write_only_span<float>(outputAttributes[i].get(),
-                                                                   domain);
-    float *destData = attribute.span.data();
-    for (int k = 0; k < counts.ofxPointCount; ++k) {
-      destData[k] = *ofxAttribProps.at<float>(k);
+    // The output socket follows the requested type, compact integers being widened to int, and
+    // the data returned by the effect is converted from whatever type it has been given.
+    OfxStatus status;
+    switch (requestedAttrib.type()) {
+      case OpenMfx::AttributeType::Int:
+      case OpenMfx::AttributeType::Int8:
+      case OpenMfx::AttributeType::Int16: {
+        blender::bke::SpanAttributeWriter<int> attribute =
+            component.attributes_for_write()->lookup_or_add_for_write_only_span<int>(
+                outputAttributes[i].get(), domain);
+        status = OpenMfx::copyAttributeComponents(OpenMfx::AttributeType::Int,
+                                                  (char *)attribute.span.data(),
+                                                  sizeof(int),
+                                                  ofxAttrib.type(),
+                                                  ofxAttribProps.data,
+                                                  ofxAttribProps.stride,
+                                                  1,
+                                                  0,
+                                                  counts.ofxPointCount);
+        attribute.finish();
+        break;
+      }
+      case OpenMfx::AttributeType::Float: {
+        blender::bke::SpanAttributeWriter<float> attribute =
+            component.attributes_for_write()->lookup_or_add_for_write_only_span<float>(
+                outputAttributes[i].get(), domain);
+        status = OpenMfx::copyAttributeComponents(OpenMfx::AttributeType::Float,
+                                                  (char *)attribute.span.data(),
+                                                  sizeof(float),
+                                                  ofxAttrib.type(),
+                                                  ofxAttribProps.data,
+                                                  ofxAttribProps.stride,
+                                                  1,
+                                                  0,
+                                                  counts.ofxPointCount);
+        attribute.finish();
+        break;
+      }
+      default:
+        status = kOfxStatErrUnsupported;
+        break;
+    }
+    if (kOfxStatOK != status) {
+      printf("WARNING: unsupported type for output attribute '%s'\n",
+             requestedAttrib.name().c_str());
+      return status;
     }
-    attribute.finish();
-    ++i;
   }
 
   return kOfxStatOK;
@@ -30,6 +30,7 @@
 #include <OpenMfx/Sdk/Cpp/Host/AttributeProps>
 
 #include <functional>
+#include <memory>
 #include <vector>
 
 struct Mesh;
@@ -38,6 +39,12 @@ struct MLoopCol;
 struct MLoopUV;
 struct MIntProperty;
 
+namespace blender::modifiers::modifier_open_mfx_cc {
+struct MeshChunk;
+class MeshChunker;
+class ChunkedMeshBuilder;
+}  // namespace blender::modifiers::modifier_open_mfx_cc
+
 using CallbackList = std::vector<std::function<void()>>;
 
 class BlenderMfxHost : public OpenMfx::Host {
@@ -71,6 +78,13 @@ class BlenderMfxHost : public OpenMfx::Host {
     Mesh *blender_mesh;
     Mesh *source_mesh;
     Object *object;
+
+    // Only used when the effect streams the mesh with inputGetMeshChunk. For an input, the
+    // partition of blender_mesh and the buffers of the current chunk. For an output, the chunks
+    // released so far, turned into blender_mesh by ChunkedMeshBuilder::finalize() after cooking.
+    std::shared_ptr<blender::modifiers::modifier_open_mfx_cc::MeshChunker> chunker;
+    std::shared_ptr<blender::modifiers::modifier_open_mfx_cc::MeshChunk> chunk;
+    std::shared_ptr<blender::modifiers::modifier_open_mfx_cc::ChunkedMeshBuilder> chunk_builder;
   };
 
   struct MeshInternalDataNode {
@@ -110,6 +124,13 @@ class BlenderMfxHost : public OpenMfx::Host {
                                   MeshInternalDataModifier &internalData);
   OfxStatus BeforeMeshGetNode(OfxMeshHandle ofxMesh,
                               MeshInternalDataNode &internalData);
+  /**
+   * Expose one chunk of the input mesh, see kOfxInputPropRequestChunkSize. Only geometry and the
+   * global point index attribute are streamed, other attributes are not available in chunks.
+   */
+  OfxStatus BeforeMeshGetModifierChunk(OfxMeshHandle ofxMesh,
+                                       MeshInternalDataModifier &internalData,
+                                       int chunkIndex);
 
  protected:
   /**
@@ -127,6 +148,11 @@ class BlenderMfxHost : public OpenMfx::Host {
                                       MeshInternalDataModifier &internalData);
   OfxStatus BeforeMeshReleaseNode(OfxMeshHandle ofxMesh,
                                   MeshInternalDataNode &internalData);
+  /**
+   * Append a chunk written by the effect to the output mesh under construction
+   */
+  OfxStatus BeforeMeshReleaseModifierChunk(OfxMeshHandle ofxMesh,
+                                           MeshInternalDataModifier &internalData);
 
  protected:
   /**
@@ -228,7 +254,8 @@ class BlenderMfxHost : public OpenMfx::Host {
                                        CallbackList &afterAllocate) const;
 
   /**
-   * Set the data pointer and stride for all corner color attributes
+   * Set the data pointer and stride for all corner color attributes. Byte colors are exposed as
+   * normalized unsigned bytes and float colors as floats, both without copy when possible.
    * @param blenderData must not be null
    */
   OfxStatus setupCornerColorAttributes(OfxMeshHandle ofxMesh,
@@ -307,7 +334,23 @@ class BlenderMfxHost : public OpenMfx::Host {
                                 const ElementCounts &counts) const;
 
   /**
-   * Extract all expected attributes
+   * Extract all color attributes from ofx mesh to blender mesh. Byte colors are copied as is,
+   * float, half and integer colors go to float color layers.
+   */
+  OfxStatus extractColorAttributes(OfxMeshHandle ofxMesh,
+                                   Mesh *blenderMesh,
+                                   const ElementCounts &counts) const;
+
+  /**
+   * Get the n-th corner layer of the given custom data type, or add a new one if there are not
+   * enough layers of this type.
+   */
+  static void *ensureCornerLayer(
+      Mesh *blenderMesh, int type, int n, const char *name, int cornerCount);
+
+  /**
+   * Extract all expected attributes, converted to the type of their output socket. Return
+   * kOfxStatErrUnsupported if an attribute cannot be converted.
    */
   OfxStatus extractExpectedAttributes(OfxMeshHandle ofxMesh,
                                       const std::vector<OfxAttributeStruct> &requestedAttributes,
@@ -316,6 +359,7 @@ class BlenderMfxHost : public OpenMfx::Host {
                                       const ElementCounts &counts) const;
 
  private:
-  // Avoid calling before allocate callback from within the before mesh get one
-  bool m_deactivateBeforeAllocateCb = false;
+  // Avoid calling before allocate callback from within the before mesh get one. This is per
+  // thread since several effect instances may be cooking at the same time.
+  static thread_local bool s_deactivateBeforeAllocateCb;
 };
@@ -0,0 +1,561 @@
+/**
+ * OpenMfx modifier for Blender
+ * Copyright (C) 2019 - 2022 Elie Michel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file
+ * \ingroup openmfx
+ */
+
+#include "MEM_guardedalloc.h"
+
+#include "bake_cache.h"
+
+#include "DNA_customdata_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_modifier_types.h"
+#include "DNA_object_types.h"
+
+#include "BKE_customdata.h"
+#include "BKE_lib_id.h"    // BKE_id_free
+#include "BKE_mesh.h"      // BKE_mesh_new_nomain_from_template
+#include "BKE_modifier.h"  // BKE_modifier_path_relbase_from_global
+#include "BKE_report.h"
+
+#include "BLI_fileops.h"
+#include "BLI_mmap.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_utildefines.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdarg>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <vector>
+#ifndef WIN32
+#  include <unistd.h>
+#else
+#  include <io.h>
+#endif
+
+namespace blender::modifiers::modifier_open_mfx_cc {
+
+// ----------------------------------------------------------------------------
+// File layout
+
+static const char BAKE_FILE_MAGIC[8] = {'M', 'F', 'X', 'B', 'A', 'K', 'E', '\0'};
+static const int32_t BAKE_FILE_VERSION = 1;
+
+/**
+ * Header of a frame file. Struct sizes are stored to detect caches written by a build with
+ * different DNA layouts, in which case the cache is simply ignored.
+ */
+struct BakeFrameHeader {
+  char magic[8];
+  int32_t version;
+  int32_t sizeof_mvert, sizeof_medge, sizeof_mloop, sizeof_mpoly, sizeof_mloopuv;
+  int32_t totvert, totedge, totloop, totpoly;
+  int32_t uv_layer_count;
+  int32_t _pad;
+};
+
+/**
+ * Byte offsets of the arrays that follow the header.
+ */
+struct BakeFrameLayout {
+  size_t mvert, medge, mloop, mpoly;
+  /** Start of the first UV layer, each layer is a name followed by totloop MLoopUV. */
+  size_t uv_layers;
+  size_t uv_layer_stride;
+  size_t total_size;
+};
+
+static size_t align_section(size_t size)
+{
+  return (size + 15) & ~size_t(15);
+}
+
+static BakeFrameLayout compute_layout(const BakeFrameHeader &header)
+{
+  BakeFrameLayout layout;
+  size_t offset = align_section(sizeof(BakeFrameHeader));
+  layout.mvert = offset;
+  offset += align_section(sizeof(MVert) * size_t(header.totvert));
+  layout.medge = offset;
+  offset += align_section(sizeof(MEdge) * size_t(header.totedge));
+  layout.mloop = offset;
+  offset += align_section(sizeof(MLoop) * size_t(header.totloop));
+  layout.mpoly = offset;
+  offset += align_section(sizeof(MPoly) * size_t(header.totpoly));
+  layout.uv_layers = offset;
+  layout.uv_layer_stride = align_section(MAX_CUSTOMDATA_LAYER_NAME) +
+                           align_section(sizeof(MLoopUV) * size_t(header.totloop));
+  offset += layout.uv_layer_stride * size_t(header.uv_layer_count);
+  layout.total_size = offset;
+  return layout;
+}
+
+static bool is_header_valid(const BakeFrameHeader &header)
+{
+  return 0 == memcmp(header.magic, BAKE_FILE_MAGIC, sizeof(BAKE_FILE_MAGIC)) &&
+         header.version == BAKE_FILE_VERSION && header.sizeof_mvert == sizeof(MVert) &&
+         header.sizeof_medge == sizeof(MEdge) && header.sizeof_mloop == sizeof(MLoop) &&
+         header.sizeof_mpoly == sizeof(MPoly) && header.sizeof_mloopuv == sizeof(MLoopUV) &&
+         header.totvert >= 0 && header.totedge >= 0 && header.totloop >= 0 &&
+         header.totpoly >= 0 && header.uv_layer_count >= 0;
+}
+
+static bool is_frame_in_range(const OpenMfxModifierData *fxmd, int frame)
+{
+  return frame >= fxmd->cache_frame_start && frame <= fxmd->cache_frame_end;
+}
+
+/**
+ * Find a layer that is saved with the mesh but not stored in the cache, e.g. vertex colors,
+ * generic attributes or custom normals, which would silently be lost on playback.
+ */
+static const CustomDataLayer *find_unsupported_layer(const Mesh *mesh)
+{
+  const CustomData_MeshMasks &mask = CD_MASK_MESH;
+  const std::pair<const CustomData *, uint64_t> domains[] = {
+      {&mesh->vdata, mask.vmask & ~CD_MASK_MVERT},
+      {&mesh->edata, mask.emask & ~CD_MASK_MEDGE},
+      {&mesh->ldata, mask.lmask & ~(CD_MASK_MLOOP | CD_MASK_MLOOPUV)},
+      {&mesh->pdata, mask.pmask & ~CD_MASK_MPOLY},
+  };
+  for (const auto &domain : domains) {
+    const CustomData *data = domain.first;
+    for (int i = 0; i < data->totlayer; ++i) {
+      if (0 != (CD_TYPE_AS_MASK(data->layers[i].type) & domain.second)) {
+        return &data->layers[i];
+      }
+    }
+  }
+  return nullptr;
+}
+
+// ----------------------------------------------------------------------------
+// Background writing, shared by all modifiers
+
+struct WriteTaskData {
+  char filepath[FILE_MAX];
+  char *buffer;
+  size_t size;
+};
+
+static TaskPool *g_write_pool = nullptr;
+static std::mutex g_write_pool_mutex;
+
+/**
+ * Errors raised since the last wait_for_writes(). Not guarded by g_write_pool_mutex because
+ * write tasks add to it while wait_for_writes() holds the pool lock.
+ */
+static std::vector<std::string> g_write_errors;
+static std::mutex g_write_errors_mutex;
+
+static void add_write_error(const char *format, ...) ATTR_PRINTF_FORMAT(1, 2);
+static void add_write_error(const char *format, ...)
+{
+  char message[FILE_MAX + 128];
+  va_list args;
+  va_start(args, format);
+  BLI_vsnprintf(message, sizeof(message), format, args);
+  va_end(args);
+
+  std::lock_guard<std::mutex> lock(g_write_errors_mutex);
+  g_write_errors.push_back(message);
+}
+
+static void write_task(TaskPool *__restrict UNUSED(pool), void *taskdata)
+{
+  WriteTaskData *data = static_cast<WriteTaskData *>(taskdata);
+
+  BLI_make_existing_file(data->filepath);
+  FILE *file = BLI_fopen(data->filepath, "wb");
+  if (nullptr == file) {
+    add_write_error("Could not open '%s' for writing", data->filepath);
+    return;
+  }
+  if (fwrite(data->buffer, 1, data->size, file) != data->size) {
+    add_write_error("Could not write '%s'", data->filepath);
+  }
+  fclose(file);
+}
+
+static void write_task_free(TaskPool *__restrict UNUSED(pool), void *taskdata)
+{
+  WriteTaskData *data = static_cast<WriteTaskData *>(taskdata);
+  MEM_freeN(data->buffer);
+  MEM_freeN(data);
+}
+
+// ----------------------------------------------------------------------------
+// Read-ahead
+
+struct ReadaheadTaskData {
+  BakeCache *cache;
+  int frame;
+  char filepath[FILE_MAX];
+};
+
+// ----------------------------------------------------------------------------
+// Public
+
+BakeCache::BakeCache() : m_readahead_pool(nullptr)
+{
+}
+
+BakeCache::~BakeCache()
+{
+  clear();
+  if (nullptr != m_readahead_pool) {
+    BLI_task_pool_free(m_readahead_pool);
+  }
+}
+
+void BakeCache::frame_filepath(char *dest,
+                               const OpenMfxModifierData *fxmd,
+                               const Object *object,
+                               int frame)
+{
+  char directory[FILE_MAX];
+  BLI_strncpy(directory, fxmd->cache_directory, sizeof(directory));
+  BLI_path_abs(directory, BKE_modifier_path_relbase_from_global(const_cast<Object *>(object)));
+
+  char filename[FILE_MAXFILE];
+  BLI_snprintf(filename,
+               sizeof(filename),
+               "%s_%s_%06d.mfxbake",
+               object->id.name + 2,
+               fxmd->modifier.name,
+               frame);
+  BLI_filename_make_safe(filename);
+
+  BLI_join_dirfile(dest, FILE_MAX, directory, filename);
+}
+
+void BakeCache::write_frame(const OpenMfxModifierData *fxmd,
+                            const Object *object,
+                            int frame,
+                            const Mesh *mesh)
+{
+  if (nullptr == mesh || !is_frame_in_range(fxmd, frame)) {
+    return;
+  }
+
+  const CustomDataLayer *unsupported_layer = find_unsupported_layer(mesh);
+  if (nullptr != unsupported_layer) {
+    add_write_error("Frame %d not baked, the cache cannot store the %s layer '%s'",
+                    frame,
+                    CustomData_layertype_name(unsupported_layer->type),
+                    unsupported_layer->name);
+    return;
+  }
+
+  BakeFrameHeader header;
+  memcpy(header.magic, BAKE_FILE_MAGIC, sizeof(BAKE_FILE_MAGIC));
+  header.version = BAKE_FILE_VERSION;
+  header.sizeof_mvert = sizeof(MVert);
+  header.sizeof_medge = sizeof(MEdge);
+  header.sizeof_mloop = sizeof(MLoop);
+  header.sizeof_mpoly = sizeof(MPoly);
+  header.sizeof_mloopuv = sizeof(MLoopUV);
+  header.totvert = mesh->totvert;
+  header.totedge = mesh->totedge;
+  header.totloop = mesh->totloop;
+  header.totpoly = mesh->totpoly;
+  header.uv_layer_count = CustomData_number_of_layers(&mesh->ldata, CD_MLOOPUV);
+  header._pad = 0;
+
+  const BakeFrameLayout layout = compute_layout(header);
+
+  // Serialization happens on the calling thread because the mesh is owned by the modifier
+  // stack and may be freed as soon as the evaluation moves on.
+  char *buffer = (char *)MEM_callocN(layout.total_size, "openmfx bake frame");
+  memcpy(buffer, &header, sizeof(header));
+  memcpy(buffer + layout.mvert, mesh->mvert, sizeof(MVert) * size_t(mesh->totvert));
+  memcpy(buffer + layout.medge, mesh->medge, sizeof(MEdge) * size_t(mesh->totedge));
+  memcpy(buffer + layout.mloop, mesh->mloop, sizeof(MLoop) * size_t(mesh->totloop));
+  memcpy(buffer + layout.mpoly, mesh->mpoly, sizeof(MPoly) * size_t(mesh->totpoly));
+
+  for (int k = 0; k < header.uv_layer_count; ++k) {
+    char *layer = buffer + layout.uv_layers + k * layout.uv_layer_stride;
+    const int layer_index = CustomData_get_layer_index_n(&mesh->ldata, CD_MLOOPUV, k);
+    const CustomDataLayer &cd_layer = mesh->ldata.layers[layer_index];
+    BLI_strncpy(layer, cd_layer.name, MAX_CUSTOMDATA_LAYER_NAME);
+    memcpy(layer + align_section(MAX_CUSTOMDATA_LAYER_NAME),
+           cd_layer.data,
+           sizeof(MLoopUV) * size_t(mesh->totloop));
+  }
+
+  WriteTaskData *data = (WriteTaskData *)MEM_mallocN(sizeof(WriteTaskData),
+                                                     "openmfx bake write task");
+  frame_filepath(data->filepath, fxmd, object, frame);
+  data->buffer = buffer;
+  data->size = layout.total_size;
+
+  std::lock_guard<std::mutex> lock(g_write_pool_mutex);
+  if (nullptr == g_write_pool) {
+    g_write_pool = BLI_task_pool_create_background(nullptr, TASK_PRIORITY_LOW);
+  }
+  BLI_task_pool_push(g_write_pool, write_task, data, false, write_task_free);
+}
+
+bool BakeCache::wait_for_writes(ReportList *reports)
+{
+  {
+    std::lock_guard<std::mutex> lock(g_write_pool_mutex);
+    if (nullptr != g_write_pool) {
+      BLI_task_pool_work_and_wait(g_write_pool);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(g_write_errors_mutex);
+  const bool success = g_write_errors.empty();
+  if (nullptr != reports) {
+    for (const std::string &message : g_write_errors) {
+      BKE_report(reports, RPT_ERROR, message.c_str());
+    }
+  }
+  g_write_errors.clear();
+  return success;
+}
+
+void BakeCache::free_frames(const OpenMfxModifierData *fxmd, const Object *object)
+{
+  wait_for_writes(nullptr);
+
+  char filepath[FILE_MAX];
+  for (int frame = fxmd->cache_frame_start; frame <= fxmd->cache_frame_end; ++frame) {
+    frame_filepath(filepath, fxmd, object, frame);
+    if (BLI_exists(filepath)) {
+      BLI_delete(filepath, false, false);
+    }
+  }
+}
+
+Mesh *BakeCache::read_frame(const OpenMfxModifierData *fxmd,
+                            const Object *object,
+                            int frame,
+                            const Mesh *template_mesh,
+                            ReadStatus *r_status)
+{
+  if (!is_frame_in_range(fxmd, frame)) {
+    *r_status = ReadStatus::OutOfRange;
+    return nullptr;
+  }
+
+  BLI_mmap_file *file = pop_mapped_frame(frame);
+  if (nullptr == file) {
+    char filepath[FILE_MAX];
+    frame_filepath(filepath, fxmd, object, frame);
+    if (!BLI_exists(filepath)) {
+      *r_status = ReadStatus::Missing;
+      return nullptr;
+    }
+    file = map_frame(filepath, false);
+    if (nullptr == file) {
+      *r_status = ReadStatus::Invalid;
+      return nullptr;
+    }
+  }
+
+  // Frames that follow are mapped while the current one is being consumed downstream.
+  schedule_readahead(fxmd, object, frame);
+
+  BakeFrameHeader header;
+  if (!BLI_mmap_read(file, &header, 0, sizeof(header)) || !is_header_valid(header)) {
+    BLI_mmap_free(file);
+    *r_status = ReadStatus::Invalid;
+    return nullptr;
+  }
+
+  const BakeFrameLayout layout = compute_layout(header);
+
+  Mesh *mesh = BKE_mesh_new_nomain_from_template(
+      template_mesh, header.totvert, header.totedge, 0, header.totloop, header.totpoly);
+
+  bool ok = true;
+  ok &= BLI_mmap_read(file, mesh->mvert, layout.mvert, sizeof(MVert) * size_t(header.totvert));
+  ok &= BLI_mmap_read(file, mesh->medge, layout.medge, sizeof(MEdge) * size_t(header.totedge));
+  ok &= BLI_mmap_read(file, mesh->mloop, layout.mloop, sizeof(MLoop) * size_t(header.totloop));
+  ok &= BLI_mmap_read(file, mesh->mpoly, layout.mpoly, sizeof(MPoly) * size_t(header.totpoly));
+
+  for (int k = 0; ok && k < header.uv_layer_count; ++k) {
+    const size_t layer_offset = layout.uv_layers + k * layout.uv_layer_stride;
+    char name[MAX_CUSTOMDATA_LAYER_NAME];
+    ok &= BLI_mmap_read(file, name, layer_offset, sizeof(name));
+    name[MAX_CUSTOMDATA_LAYER_NAME - 1] = '\0';
+
+    MLoopUV *uv_data = (MLoopUV *)CustomData_get_layer_named(&mesh->ldata, CD_MLOOPUV, name);
+    if (nullptr == uv_data) {
+      uv_data = (MLoopUV *)CustomData_add_layer_named(
+          &mesh->ldata, CD_MLOOPUV, CD_CALLOC, nullptr, header.totloop, name);
+    }
+    ok &= BLI_mmap_read(file,
+                        uv_data,
+                        layer_offset + align_section(MAX_CUSTOMDATA_LAYER_NAME),
+                        sizeof(MLoopUV) * size_t(header.totloop));
+  }
+
+  BLI_mmap_free(file);
+
+  if (!ok) {
+    BKE_id_free(nullptr, mesh);
+    *r_status = ReadStatus::Invalid;
+    return nullptr;
+  }
+
+  *r_status = ReadStatus::Ok;
+  return mesh;
+}
+
+void BakeCache::clear()
+{
+  if (nullptr != m_readahead_pool) {
+    BLI_task_pool_cancel(m_readahead_pool);
+  }
+
+  std::lock_guard<std::mutex> lock(m_mapped_frames_mutex);
+  for (auto &it : m_mapped_frames) {
+    if (nullptr != it.second) {
+      BLI_mmap_free(it.second);
+    }
+  }
+  m_mapped_frames.clear();
+}
+
+// ----------------------------------------------------------------------------
+// Private
+
+BLI_mmap_file *BakeCache::map_frame(const char *filepath, bool touch_pages)
+{
+  const int fd = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+  if (-1 == fd) {
+    return nullptr;
+  }
+  // The mapping remains valid after the descriptor is closed.
+  BLI_mmap_file *file = BLI_mmap_open(fd);
+  close(fd);
+
+  if (nullptr == file || !touch_pages) {
+    return file;
+  }
+
+  BakeFrameHeader header;
+  if (!BLI_mmap_read(file, &header, 0, sizeof(header)) || !is_header_valid(header)) {
+    return file;
+  }
+
+  const size_t total_size = compute_layout(header).total_size;
+  const size_t page_size = 4096;
+  char byte;
+  for (size_t offset = 0; offset < total_size; offset += page_size) {
+    if (!BLI_mmap_read(file, &byte, offset, 1)) {
+      break;
+    }
+  }
+
+  return file;
+}
+
+void BakeCache::schedule_readahead(const OpenMfxModifierData *fxmd,
+                                   const Object *object,
+                                   int frame)
+{
+  const int last_frame = std::min(frame + fxmd->cache_readahead, fxmd->cache_frame_end);
+
+  std::lock_guard<std::mutex> lock(m_mapped_frames_mutex);
+
+  // Drop frames that fell out of the read-ahead window, e.g. when scrubbing backwards.
+  for (auto it = m_mapped_frames.begin(); it != m_mapped_frames.end();) {
+    if (it->first <= frame || it->first > last_frame) {
+      if (nullptr != it->second) {
+        BLI_mmap_free(it->second);
+      }
+      it = m_mapped_frames.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+
+  for (int next_frame = frame + 1; next_frame <= last_frame; ++next_frame) {
+    if (m_mapped_frames.count(next_frame)) {
+      continue;
+    }
+
+    ReadaheadTaskData *data = (ReadaheadTaskData *)MEM_mallocN(sizeof(ReadaheadTaskData),
+                                                               "openmfx bake readahead task");
+    frame_filepath(data->filepath, fxmd, object, next_frame);
+    if (!BLI_exists(data->filepath)) {
+      MEM_freeN(data);
+      continue;
+    }
+    data->cache = this;
+    data->frame = next_frame;
+
+    if (nullptr == m_readahead_pool) {
+      m_readahead_pool = BLI_task_pool_create_background(nullptr, TASK_PRIORITY_LOW);
+    }
+    m_mapped_frames[next_frame] = nullptr;
+    BLI_task_pool_push(m_readahead_pool, readahead_task, data, true, nullptr);
+  }
+}
+
+BLI_mmap_file *BakeCache::pop_mapped_frame(int frame)
+{
+  std::lock_guard<std::mutex> lock(m_mapped_frames_mutex);
+  auto it = m_mapped_frames.find(frame);
+  if (it == m_mapped_frames.end()) {
+    return nullptr;
+  }
+  // If the read-ahead task is still pending, the entry is removed anyway so that the task
+  // releases its mapping when done, and the frame gets read synchronously.
+  BLI_mmap_file *file = it->second;
+  m_mapped_frames.erase(it);
+  return file;
+}
+
+void BakeCache::readahead_task(TaskPool *__restrict pool, void *taskdata)
+{
+  ReadaheadTaskData *data = static_cast<ReadaheadTaskData *>(taskdata);
+  if (BLI_task_pool_current_canceled(pool)) {
+    return;
+  }
+
+  BLI_mmap_file *file = map_frame(data->filepath, true);
+  if (nullptr == file) {
+    return;
+  }
+
+  BakeCache *cache = data->cache;
+  std::lock_guard<std::mutex> lock(cache->m_mapped_frames_mutex);
+  auto it = cache->m_mapped_frames.find(data->frame);
+  if (it != cache->m_mapped_frames.end() && nullptr == it->second) {
+    it->second = file;
+  }
+  else {
+    BLI_mmap_free(file);
+  }
+}
+
+}  // namespace blender::modifiers::modifier_open_mfx_cc
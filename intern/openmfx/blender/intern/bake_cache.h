@@ -0,0 +1,137 @@
+/**
+ * OpenMfx modifier for Blender
+ * Copyright (C) 2019 - 2022 Elie Michel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file
+ * \ingroup openmfx
+ *
+ * On-disk cache of the meshes cooked by an OpenMfx modifier over a frame range.
+ *
+ * Each frame is stored in its own file, laid out as a small header followed by the raw
+ * vertex, edge, loop, poly and UV arrays, each aligned so that the file can be memory-mapped
+ * and copied into a new Blender mesh with one memcpy per array.
+ */
+
+#pragma once
+
+#include "BLI_mmap.h"
+
+#include <map>
+#include <mutex>
+
+struct Mesh;
+struct Object;
+struct OpenMfxModifierData;
+struct ReportList;
+struct TaskPool;
+
+namespace blender::modifiers::modifier_open_mfx_cc {
+
+class BakeCache {
+ public:
+  /**
+   * Outcome of read_frame().
+   */
+  enum class ReadStatus {
+    Ok,
+    /** The frame is out of the cache range. */
+    OutOfRange,
+    /** The file of the frame does not exist. */
+    Missing,
+    /** The file of the frame exists but could not be read back. */
+    Invalid,
+  };
+
+  BakeCache();
+  ~BakeCache();
+
+  /**
+   * Absolute path of the file storing the given frame. dest must be FILE_MAX long.
+   */
+  static void frame_filepath(char *dest,
+                             const OpenMfxModifierData *fxmd,
+                             const Object *object,
+                             int frame);
+
+  /**
+   * Serialize the mesh on the calling thread and hand the file writing over to a background
+   * task, so that the next frame can start cooking right away.
+   * Meshes with layers that the cache does not store are refused, and so are frames that
+   * could not be written. Both get reported by the next call to wait_for_writes().
+   */
+  static void write_frame(const OpenMfxModifierData *fxmd,
+                          const Object *object,
+                          int frame,
+                          const Mesh *mesh);
+
+  /**
+   * Block until all frames handed to write_frame() are on disk.
+   * @param reports receives the errors raised since the last call, may be null to discard them
+   * @return false if any frame could not be written
+   */
+  static bool wait_for_writes(ReportList *reports);
+
+  /**
+   * Remove the files of all frames in the cache range.
+   */
+  static void free_frames(const OpenMfxModifierData *fxmd, const Object *object);
+
+  /**
+   * Build a new mesh from the cached frame, or return nullptr if the frame is not cached.
+   * Frames that follow are then read ahead in the background, up to fxmd->cache_readahead.
+   * @param template_mesh used for BKE_mesh_new_nomain_from_template()
+   * @param r_status tells why no mesh was returned
+   */
+  Mesh *read_frame(const OpenMfxModifierData *fxmd,
+                   const Object *object,
+                   int frame,
+                   const Mesh *template_mesh,
+                   ReadStatus *r_status);
+
+  /**
+   * Release all memory mapped frames and cancel pending read-ahead.
+   */
+  void clear();
+
+ private:
+  /**
+   * Map the file of a frame in memory and touch all of its pages so that the read of the
+   * next frame during playback does not stall on disk.
+   */
+  static BLI_mmap_file *map_frame(const char *filepath, bool touch_pages);
+
+  void schedule_readahead(const OpenMfxModifierData *fxmd, const Object *object, int frame);
+
+  /**
+   * Take ownership of a read-ahead mapping, if any.
+   */
+  BLI_mmap_file *pop_mapped_frame(int frame);
+
+  static void readahead_task(TaskPool *__restrict pool, void *taskdata);
+
+ private:
+  /**
+   * Frames that have already been mapped by read-ahead tasks, indexed by frame number.
+   * A null value means that a task is pending for this frame.
+   */
+  std::map<int, BLI_mmap_file *> m_mapped_frames;
+  std::mutex m_mapped_frames_mutex;
+
+  TaskPool *m_readahead_pool;
+};
+
+}  // namespace blender::modifiers::modifier_open_mfx_cc
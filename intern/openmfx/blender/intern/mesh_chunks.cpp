@@ -0,0 +1,443 @@
+/**
+ * OpenMfx modifier for Blender
+ * Copyright (C) 2019 - 2022 Elie Michel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file
+ * \ingroup openmfx
+ */
+
+#include "mesh_chunks.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_customdata.h"
+#include "BKE_mesh.h"
+
+#include "BLI_math_vector.h"
+#include "BLI_sort.hh"
+#include "BLI_string.h"
+#include "BLI_task.hh"
+#include "BLI_utildefines.h"
+
+#include "MEM_guardedalloc.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace blender::modifiers::modifier_open_mfx_cc {
+
+/**
+ * Spread the 10 lowest bits of x so that there are two zero bits between each of them.
+ */
+static uint32_t expand_bits(uint32_t x)
+{
+  x = (x * 0x00010001u) & 0xFF0000FFu;
+  x = (x * 0x00000101u) & 0x0F00F00Fu;
+  x = (x * 0x00000011u) & 0xC30C30C3u;
+  x = (x * 0x00000005u) & 0x49249249u;
+  return x;
+}
+
+static uint32_t morton_code(const float co[3], const float min[3], const float scale[3])
+{
+  uint32_t code = 0;
+  for (int k = 0; k < 3; ++k) {
+    const float t = (co[k] - min[k]) * scale[k];
+    const uint32_t q = static_cast<uint32_t>(std::clamp(t, 0.0f, 1023.0f));
+    code |= expand_bits(q) << (2 - k);
+  }
+  return code;
+}
+
+// ----------------------------------------------------------------------------
+
+MeshChunker::MeshChunker(const Mesh *mesh, int max_chunk_size)
+    : m_mesh(mesh), m_max_chunk_size(std::max(max_chunk_size, 1))
+{
+  const MVert *mvert = mesh->mvert;
+  const MLoop *mloop = mesh->mloop;
+  const MPoly *mpoly = mesh->mpoly;
+  const MEdge *medge = mesh->medge;
+
+  // Loose edges are streamed as 2-corner faces
+  std::vector<int> loose_edges;
+  for (int j = 0; j < mesh->totedge; ++j) {
+    if (medge[j].flag & ME_LOOSEEDGE) {
+      loose_edges.push_back(j);
+    }
+  }
+
+  const int element_count = mesh->totpoly + static_cast<int>(loose_edges.size());
+  if (element_count == 0) {
+    return;
+  }
+
+  float min[3], max[3], scale[3];
+  INIT_MINMAX(min, max);
+  for (int i = 0; i < mesh->totvert; ++i) {
+    minmax_v3v3_v3(min, max, mvert[i].co);
+  }
+  for (int k = 0; k < 3; ++k) {
+    const float extent = max[k] - min[k];
+    scale[k] = extent > 0.0f ? 1023.0f / extent : 0.0f;
+  }
+
+  // Sort (code, element) pairs along the Morton curve
+  std::vector<uint64_t> keys(element_count);
+  threading::parallel_for(IndexRange(element_count), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      float centroid[3] = {0.0f, 0.0f, 0.0f};
+      if (i < mesh->totpoly) {
+        const MPoly &poly = mpoly[i];
+        for (int l = 0; l < poly.totloop; ++l) {
+          add_v3_v3(centroid, mvert[mloop[poly.loopstart + l].v].co);
+        }
+        if (poly.totloop > 0) {
+          mul_v3_fl(centroid, 1.0f / poly.totloop);
+        }
+      }
+      else {
+        const MEdge &edge = medge[loose_edges[i - mesh->totpoly]];
+        mid_v3_v3v3(centroid, mvert[edge.v1].co, mvert[edge.v2].co);
+      }
+      keys[i] = (static_cast<uint64_t>(morton_code(centroid, min, scale)) << 32) |
+                static_cast<uint32_t>(i);
+    }
+  });
+  parallel_sort(keys.begin(), keys.end());
+
+  m_face_order.resize(element_count);
+  for (int i = 0; i < element_count; ++i) {
+    const int element = static_cast<int>(keys[i] & 0xFFFFFFFFu);
+    m_face_order[i] = element < mesh->totpoly ? element :
+                                                mesh->totpoly + loose_edges[element - mesh->totpoly];
+  }
+}
+
+int MeshChunker::chunk_count() const
+{
+  const int element_count = static_cast<int>(m_face_order.size());
+  return (element_count + m_max_chunk_size - 1) / m_max_chunk_size;
+}
+
+void MeshChunker::build_chunk(int chunk_index, MeshChunk &chunk) const
+{
+  chunk.point_positions.clear();
+  chunk.point_global_indices.clear();
+  chunk.corner_points.clear();
+  chunk.face_sizes.clear();
+  chunk.has_loose_edges = false;
+
+  const int begin = chunk_index * m_max_chunk_size;
+  const int end = std::min(begin + m_max_chunk_size, static_cast<int>(m_face_order.size()));
+  if (begin >= end) {
+    return;
+  }
+
+  const Mesh *mesh = m_mesh;
+  Map<int, int> global_to_local;
+  global_to_local.reserve(end - begin);
+
+  auto add_corner = [&](int global_point) {
+    const int local_point = global_to_local.lookup_or_add_cb(global_point, [&]() {
+      const int index = chunk.point_count();
+      chunk.point_global_indices.push_back(global_point);
+      const float *co = mesh->mvert[global_point].co;
+      chunk.point_positions.insert(chunk.point_positions.end(), co, co + 3);
+      return index;
+    });
+    chunk.corner_points.push_back(local_point);
+  };
+
+  // Faces first, then loose edges, which is what the host expects from a non chunked mesh
+  for (int i = begin; i < end; ++i) {
+    const int element = m_face_order[i];
+    if (element < mesh->totpoly) {
+      const MPoly &poly = mesh->mpoly[element];
+      for (int l = 0; l < poly.totloop; ++l) {
+        add_corner(mesh->mloop[poly.loopstart + l].v);
+      }
+      chunk.face_sizes.push_back(poly.totloop);
+    }
+  }
+  for (int i = begin; i < end; ++i) {
+    const int element = m_face_order[i];
+    if (element >= mesh->totpoly) {
+      const MEdge &edge = mesh->medge[element - mesh->totpoly];
+      add_corner(edge.v1);
+      add_corner(edge.v2);
+      chunk.face_sizes.push_back(2);
+      chunk.has_loose_edges = true;
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+ChunkedMeshBuilder::ChunkedMeshBuilder()
+    : m_chunk_count(0),
+      m_mvert(nullptr),
+      m_mloop(nullptr),
+      m_mpoly(nullptr),
+      m_medge(nullptr),
+      m_totvert(0),
+      m_totloop(0),
+      m_totpoly(0),
+      m_totedge(0),
+      m_vert_capacity(0),
+      m_loop_capacity(0),
+      m_poly_capacity(0),
+      m_edge_capacity(0)
+{
+}
+
+ChunkedMeshBuilder::~ChunkedMeshBuilder()
+{
+  clear();
+}
+
+void ChunkedMeshBuilder::clear()
+{
+  MEM_SAFE_FREE(m_mvert);
+  MEM_SAFE_FREE(m_mloop);
+  MEM_SAFE_FREE(m_mpoly);
+  MEM_SAFE_FREE(m_medge);
+  m_totvert = m_totloop = m_totpoly = m_totedge = 0;
+  m_vert_capacity = m_loop_capacity = m_poly_capacity = m_edge_capacity = 0;
+  m_global_to_vert.clear();
+  m_chunk_count = 0;
+  m_error.clear();
+}
+
+template<typename T>
+void ChunkedMeshBuilder::reserve(T *&buffer, int &capacity, int count, const char *name)
+{
+  if (count <= capacity) {
+    return;
+  }
+  const int new_capacity = std::max(count, capacity + capacity / 2);
+  if (nullptr == buffer) {
+    buffer = static_cast<T *>(MEM_malloc_arrayN(new_capacity, sizeof(T), name));
+  }
+  else {
+    buffer = static_cast<T *>(MEM_reallocN(buffer, sizeof(T) * new_capacity));
+  }
+  capacity = new_capacity;
+}
+
+bool ChunkedMeshBuilder::append_chunk(int point_count,
+                                      const char *positions,
+                                      int position_stride,
+                                      const char *global_indices,
+                                      int global_index_stride,
+                                      int corner_count,
+                                      const char *corner_points,
+                                      int corner_point_stride,
+                                      int face_count,
+                                      const char *face_sizes,
+                                      int face_size_stride,
+                                      int constant_face_size)
+{
+  // Check the corners and faces before appending anything, so that a bad chunk leaves no partial
+  // geometry
+  auto corner_point = [&](int c) {
+    return *reinterpret_cast<const int *>(corner_points + c * corner_point_stride);
+  };
+  auto face_size = [&](int f) {
+    return -1 != constant_face_size ?
+               constant_face_size :
+               *reinterpret_cast<const int *>(face_sizes + f * face_size_stride);
+  };
+  char message[256] = "";
+  for (int c = 0; c < corner_count; ++c) {
+    const int p = corner_point(c);
+    if (p < 0 || p >= point_count) {
+      BLI_snprintf(message,
+                   sizeof(message),
+                   "Corner %d of an output chunk refers to point %d, out of its %d points",
+                   c,
+                   p,
+                   point_count);
+      break;
+    }
+  }
+  if (message[0] == '\0' && -1 == constant_face_size && nullptr == face_sizes && face_count > 0) {
+    BLI_strncpy(message,
+                "Output chunk has neither face sizes nor a constant face size",
+                sizeof(message));
+  }
+  int64_t face_corner_count = 0;
+  for (int f = 0; f < face_count && message[0] == '\0'; ++f) {
+    const int size = face_size(f);
+    // 2-corner faces are loose edges, smaller ones are nothing Blender can represent
+    if (size < 3 && size != 2) {
+      BLI_snprintf(message,
+                   sizeof(message),
+                   "Face %d of an output chunk has %d corners, at least 3 are needed",
+                   f,
+                   size);
+    }
+    face_corner_count += size;
+  }
+  if (message[0] == '\0' && face_corner_count != corner_count) {
+    BLI_snprintf(message,
+                 sizeof(message),
+                 "Faces of an output chunk use %lld corners instead of its %d corners",
+                 static_cast<long long>(face_corner_count),
+                 corner_count);
+  }
+  if (message[0] != '\0') {
+    if (m_error.empty()) {
+      m_error = message;
+    }
+    return false;
+  }
+
+  ++m_chunk_count;
+
+  // Points, merged by global index when available
+  std::vector<int> local_to_vert(point_count);
+  reserve(m_mvert, m_vert_capacity, m_totvert + point_count, "ChunkedMeshBuilder verts");
+  for (int i = 0; i < point_count; ++i) {
+    const int global_index = nullptr != global_indices ?
+                                 *reinterpret_cast<const int *>(global_indices +
+                                                                i * global_index_stride) :
+                                 -1;
+    if (global_index >= 0) {
+      const int *existing = m_global_to_vert.lookup_ptr(global_index);
+      if (nullptr != existing) {
+        local_to_vert[i] = *existing;
+        continue;
+      }
+      m_global_to_vert.add_new(global_index, m_totvert);
+    }
+    MVert &mv = m_mvert[m_totvert];
+    memset(&mv, 0, sizeof(MVert));
+    copy_v3_v3(mv.co, reinterpret_cast<const float *>(positions + i * position_stride));
+    local_to_vert[i] = m_totvert++;
+  }
+
+  // Faces, 2-corner faces becoming loose edges
+  reserve(m_mloop, m_loop_capacity, m_totloop + corner_count, "ChunkedMeshBuilder loops");
+  reserve(m_mpoly, m_poly_capacity, m_totpoly + face_count, "ChunkedMeshBuilder polys");
+  auto corner_vert = [&](int c) { return local_to_vert[corner_point(c)]; };
+  int c = 0;
+  for (int f = 0; f < face_count; ++f) {
+    const int size = face_size(f);
+    if (size == 2) {
+      reserve(m_medge, m_edge_capacity, m_totedge + 1, "ChunkedMeshBuilder edges");
+      MEdge &me = m_medge[m_totedge++];
+      memset(&me, 0, sizeof(MEdge));
+      me.v1 = corner_vert(c);
+      me.v2 = corner_vert(c + 1);
+      me.flag = ME_EDGEDRAW | ME_EDGERENDER | ME_LOOSEEDGE;
+    }
+    else {
+      MPoly &mp = m_mpoly[m_totpoly++];
+      memset(&mp, 0, sizeof(MPoly));
+      mp.loopstart = m_totloop;
+      mp.totloop = size;
+      for (int l = 0; l < size; ++l) {
+        MLoop &ml = m_mloop[m_totloop++];
+        ml.v = corner_vert(c + l);
+        ml.e = 0;
+      }
+    }
+    c += size;
+  }
+
+  return true;
+}
+
+Mesh *ChunkedMeshBuilder::finalize(const Mesh *template_mesh)
+{
+  // Only keep the primary layers of the template, they are replaced right below
+  const CustomData_MeshMasks mask{};
+  Mesh *mesh = nullptr != template_mesh ?
+                   BKE_mesh_new_nomain_from_template_ex(template_mesh, 0, 0, 0, 0, 0, mask) :
+                   BKE_mesh_new_nomain(0, 0, 0, 0, 0);
+
+  // Give back the unused capacity before handing the buffers over to the mesh
+  if (m_totvert < m_vert_capacity && m_totvert > 0) {
+    m_mvert = static_cast<MVert *>(MEM_reallocN(m_mvert, sizeof(MVert) * m_totvert));
+  }
+  if (m_totloop < m_loop_capacity && m_totloop > 0) {
+    m_mloop = static_cast<MLoop *>(MEM_reallocN(m_mloop, sizeof(MLoop) * m_totloop));
+  }
+  if (m_totpoly < m_poly_capacity && m_totpoly > 0) {
+    m_mpoly = static_cast<MPoly *>(MEM_reallocN(m_mpoly, sizeof(MPoly) * m_totpoly));
+  }
+  if (m_totedge < m_edge_capacity && m_totedge > 0) {
+    m_medge = static_cast<MEdge *>(MEM_reallocN(m_medge, sizeof(MEdge) * m_totedge));
+  }
+
+  mesh->totvert = m_totvert;
+  mesh->totedge = m_totedge;
+  mesh->totloop = m_totloop;
+  mesh->totpoly = m_totpoly;
+
+  CustomData_free_layers(&mesh->vdata, CD_MVERT, 0);
+  CustomData_free_layers(&mesh->edata, CD_MEDGE, 0);
+  CustomData_free_layers(&mesh->ldata, CD_MLOOP, 0);
+  CustomData_free_layers(&mesh->pdata, CD_MPOLY, 0);
+
+  // Empty buffers are freed by clear() below, CustomData allocates its own empty layers
+  CustomData_add_layer(&mesh->vdata,
+                       CD_MVERT,
+                       m_totvert > 0 ? CD_ASSIGN : CD_CALLOC,
+                       m_totvert > 0 ? m_mvert : nullptr,
+                       m_totvert);
+  CustomData_add_layer(&mesh->edata,
+                       CD_MEDGE,
+                       m_totedge > 0 ? CD_ASSIGN : CD_CALLOC,
+                       m_totedge > 0 ? m_medge : nullptr,
+                       m_totedge);
+  CustomData_add_layer(&mesh->ldata,
+                       CD_MLOOP,
+                       m_totloop > 0 ? CD_ASSIGN : CD_CALLOC,
+                       m_totloop > 0 ? m_mloop : nullptr,
+                       m_totloop);
+  CustomData_add_layer(&mesh->pdata,
+                       CD_MPOLY,
+                       m_totpoly > 0 ? CD_ASSIGN : CD_CALLOC,
+                       m_totpoly > 0 ? m_mpoly : nullptr,
+                       m_totpoly);
+  if (m_totvert > 0) {
+    m_mvert = nullptr;
+  }
+  if (m_totedge > 0) {
+    m_medge = nullptr;
+  }
+  if (m_totloop > 0) {
+    m_mloop = nullptr;
+  }
+  if (m_totpoly > 0) {
+    m_mpoly = nullptr;
+  }
+  BKE_mesh_update_customdata_pointers(mesh, false);
+
+  if (mesh->totpoly > 0) {
+    BKE_mesh_calc_edges(mesh, mesh->totedge > 0, false);
+  }
+
+  clear();
+  return mesh;
+}
+
+}  // namespace blender::modifiers::modifier_open_mfx_cc
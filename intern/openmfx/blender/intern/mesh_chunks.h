@@ -0,0 +1,176 @@
+/**
+ * OpenMfx modifier for Blender
+ * Copyright (C) 2019 - 2022 Elie Michel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file
+ * \ingroup openmfx
+ *
+ * Streaming of meshes to and from effects that request their inputs in chunks
+ * (see kOfxInputPropRequestChunkSize).
+ *
+ * On the input side, faces are ordered along a Morton curve of their centroid so that each chunk
+ * covers a compact region of space and references as few points as possible. On the output side,
+ * chunks are appended directly into the final Blender arrays, so that neither the host nor the
+ * effect ever holds more than one chunk on top of the meshes themselves.
+ */
+
+#pragma once
+
+#include "BLI_map.hh"
+
+#include <string>
+#include <vector>
+
+struct MEdge;
+struct MLoop;
+struct MPoly;
+struct MVert;
+struct Mesh;
+
+namespace blender::modifiers::modifier_open_mfx_cc {
+
+/**
+ * A range of faces of a mesh, together with the points they use, remapped to local indices.
+ * Loose edges are exposed as 2-corner faces, like in the non chunked case.
+ */
+struct MeshChunk {
+  std::vector<float> point_positions;  // 3 floats per point
+  std::vector<int> point_global_indices;
+  std::vector<int> corner_points;
+  std::vector<int> face_sizes;
+  bool has_loose_edges = false;
+
+  int point_count() const
+  {
+    return static_cast<int>(point_global_indices.size());
+  }
+  int corner_count() const
+  {
+    return static_cast<int>(corner_points.size());
+  }
+  int face_count() const
+  {
+    return static_cast<int>(face_sizes.size());
+  }
+};
+
+/**
+ * Split an input mesh into spatially coherent chunks of at most max_chunk_size faces.
+ */
+class MeshChunker {
+ public:
+  MeshChunker(const Mesh *mesh, int max_chunk_size);
+
+  int chunk_count() const;
+
+  int max_chunk_size() const
+  {
+    return m_max_chunk_size;
+  }
+
+  /**
+   * Fill the chunk with the faces of the given index. Buffers of the chunk are reused from one
+   * call to the other so that they only grow up to the size of the largest chunk.
+   */
+  void build_chunk(int chunk_index, MeshChunk &chunk) const;
+
+ private:
+  const Mesh *m_mesh;
+  int m_max_chunk_size;
+
+  // Polygons and loose edges (encoded as totpoly + edge index) sorted along the Morton curve
+  std::vector<int> m_face_order;
+};
+
+/**
+ * Assemble the chunks returned by an effect into a single Blender mesh.
+ */
+class ChunkedMeshBuilder {
+ public:
+  ChunkedMeshBuilder();
+  ~ChunkedMeshBuilder();
+
+  ChunkedMeshBuilder(const ChunkedMeshBuilder &) = delete;
+  ChunkedMeshBuilder &operator=(const ChunkedMeshBuilder &) = delete;
+
+  /**
+   * Append a chunk. Corners refer to the points of the chunk. If global_indices is not null,
+   * points that share the same non negative global index as a point of a previous chunk are
+   * merged into it.
+   * @param positions 3 floats per point, with the given stride in bytes
+   * @param face_sizes may be null when constant_face_size is not -1
+   * @return false if a corner refers to a point out of the chunk, or if the face sizes do not
+   * split the corners into faces of at least 3 corners or loose edges of 2, in which case nothing
+   * is appended and error() tells why
+   */
+  bool append_chunk(int point_count,
+                    const char *positions,
+                    int position_stride,
+                    const char *global_indices,
+                    int global_index_stride,
+                    int corner_count,
+                    const char *corner_points,
+                    int corner_point_stride,
+                    int face_count,
+                    const char *face_sizes,
+                    int face_size_stride,
+                    int constant_face_size);
+
+  bool is_empty() const
+  {
+    return m_chunk_count == 0;
+  }
+
+  /**
+   * Description of the first chunk that failed to append, empty if none did
+   */
+  const std::string &error() const
+  {
+    return m_error;
+  }
+
+  /**
+   * Move the accumulated geometry into a new mesh, and reset the builder.
+   * @param template_mesh used for BKE_mesh_new_nomain_from_template(), may be null
+   */
+  Mesh *finalize(const Mesh *template_mesh);
+
+ private:
+  void clear();
+
+  /**
+   * Grow the buffer of type T to hold at least count elements, by at least 50% at a time.
+   */
+  template<typename T> static void reserve(T *&buffer, int &capacity, int count, const char *name);
+
+ private:
+  int m_chunk_count;
+
+  MVert *m_mvert;
+  MLoop *m_mloop;
+  MPoly *m_mpoly;
+  MEdge *m_medge;
+  int m_totvert, m_totloop, m_totpoly, m_totedge;
+  int m_vert_capacity, m_loop_capacity, m_poly_capacity, m_edge_capacity;
+
+  // Output vertex of each global point index met so far
+  Map<int, int> m_global_to_vert;
+
+  std::string m_error;
+};
+
+}  // namespace blender::modifiers::modifier_open_mfx_cc
@@ -0,0 +1,188 @@
+/**
+ * OpenMfx modifier for Blender
+ * Copyright (C) 2019 - 2022 Elie Michel
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "testing/testing.h"
+
+#include "mesh_chunks.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+
+#include "BLI_math_vec_types.hh"
+
+#include <algorithm>
+#include <vector>
+
+namespace blender::modifiers::modifier_open_mfx_cc::tests {
+
+class ChunkedMeshBuilderTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+
+  /**
+   * Append a chunk from tightly packed arrays, global_indices and face_sizes may be empty.
+   */
+  bool append(const std::vector<float> &positions,
+              const std::vector<int> &global_indices,
+              const std::vector<int> &corner_points,
+              const std::vector<int> &face_sizes,
+              int face_count = -1,
+              int constant_face_size = -1)
+  {
+    return builder.append_chunk(static_cast<int>(positions.size() / 3),
+                                reinterpret_cast<const char *>(positions.data()),
+                                3 * sizeof(float),
+                                global_indices.empty() ?
+                                    nullptr :
+                                    reinterpret_cast<const char *>(global_indices.data()),
+                                sizeof(int),
+                                static_cast<int>(corner_points.size()),
+                                reinterpret_cast<const char *>(corner_points.data()),
+                                sizeof(int),
+                                face_count != -1 ? face_count :
+                                                   static_cast<int>(face_sizes.size()),
+                                face_sizes.empty() ?
+                                    nullptr :
+                                    reinterpret_cast<const char *>(face_sizes.data()),
+                                sizeof(int),
+                                constant_face_size);
+  }
+
+  /**
+   * Vertex indices of the corners of each polygon of the mesh.
+   */
+  static std::vector<std::vector<int>> polys(const Mesh *mesh)
+  {
+    std::vector<std::vector<int>> result;
+    for (int i = 0; i < mesh->totpoly; ++i) {
+      const MPoly &poly = mesh->mpoly[i];
+      std::vector<int> verts;
+      for (int l = 0; l < poly.totloop; ++l) {
+        verts.push_back(static_cast<int>(mesh->mloop[poly.loopstart + l].v));
+      }
+      result.push_back(verts);
+    }
+    return result;
+  }
+
+  /**
+   * Vertices of the loose edges, sorted since computing the other edges reorders them.
+   */
+  static std::vector<std::pair<int, int>> loose_edges(const Mesh *mesh)
+  {
+    std::vector<std::pair<int, int>> result;
+    for (int i = 0; i < mesh->totedge; ++i) {
+      const MEdge &edge = mesh->medge[i];
+      if (edge.flag & ME_LOOSEEDGE) {
+        result.emplace_back(static_cast<int>(edge.v1), static_cast<int>(edge.v2));
+      }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  ChunkedMeshBuilder builder;
+};
+
+TEST_F(ChunkedMeshBuilderTest, MergeGlobalIndices)
+{
+  /* Two triangles sharing the edge 1-2, each in its own chunk, plus a point of the second chunk
+   * without a global index, which is never merged. */
+  ASSERT_TRUE(append({0, 0, 0, 1, 0, 0, 0, 1, 0}, {0, 1, 2}, {0, 1, 2}, {3}));
+  ASSERT_TRUE(append({0, 1, 0, 1, 1, 0, 1, 0, 0, 5, 5, 5}, {2, 3, 1, -1}, {2, 1, 0}, {3}));
+  EXPECT_FALSE(builder.is_empty());
+
+  Mesh *mesh = builder.finalize(nullptr);
+  EXPECT_TRUE(builder.is_empty());
+  ASSERT_EQ(mesh->totvert, 5);
+  EXPECT_V3_NEAR(mesh->mvert[3].co, float3(1, 1, 0), 1e-6f);
+  EXPECT_V3_NEAR(mesh->mvert[4].co, float3(5, 5, 5), 1e-6f);
+  EXPECT_EQ(polys(mesh), (std::vector<std::vector<int>>{{0, 1, 2}, {1, 3, 2}}));
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(ChunkedMeshBuilderTest, LooseEdges)
+{
+  /* A quad and a loose edge in a first chunk, another loose edge alone in the second one. */
+  ASSERT_TRUE(append({0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 2, 2, 2},
+                     {},
+                     {0, 1, 2, 3, 3, 4},
+                     {4, 2}));
+  ASSERT_TRUE(append({3, 3, 3, 4, 4, 4}, {}, {1, 0}, {2}));
+
+  Mesh *mesh = builder.finalize(nullptr);
+  ASSERT_EQ(mesh->totvert, 7);
+  EXPECT_EQ(polys(mesh), (std::vector<std::vector<int>>{{0, 1, 2, 3}}));
+  EXPECT_EQ(loose_edges(mesh), (std::vector<std::pair<int, int>>{{3, 4}, {6, 5}}));
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(ChunkedMeshBuilderTest, ConstantFaceSize)
+{
+  /* Face sizes are not needed when they are all the same. */
+  ASSERT_TRUE(append({0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0}, {}, {0, 1, 2, 0, 2, 3}, {}, 2, 3));
+  ASSERT_TRUE(append({0, 0, 0, 1, 0, 0}, {}, {0, 1}, {}, 1, 2));
+
+  Mesh *mesh = builder.finalize(nullptr);
+  ASSERT_EQ(mesh->totvert, 6);
+  EXPECT_EQ(polys(mesh), (std::vector<std::vector<int>>{{0, 1, 2}, {0, 2, 3}}));
+  EXPECT_EQ(loose_edges(mesh), (std::vector<std::pair<int, int>>{{4, 5}}));
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(ChunkedMeshBuilderTest, RejectInvalidChunks)
+{
+  const std::vector<float> positions = {0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0};
+
+  /* Corner out of the points of the chunk. */
+  EXPECT_FALSE(append(positions, {}, {0, 1, 4}, {3}));
+  EXPECT_FALSE(append(positions, {}, {0, -1, 2}, {3}));
+  /* Face sizes running past the corners, or not using all of them. */
+  EXPECT_FALSE(append(positions, {}, {0, 1, 2}, {4}));
+  EXPECT_FALSE(append(positions, {}, {0, 1, 2, 3}, {3}));
+  EXPECT_FALSE(append(positions, {}, {0, 1, 2, 0, 2, 3}, {}, 2, 4));
+  EXPECT_FALSE(append(positions, {}, {0, 1, 2}, {}, 0));
+  /* Faces too small to be polygons or loose edges. */
+  EXPECT_FALSE(append(positions, {}, {0, 1, 2, 3}, {3, 1}));
+  EXPECT_FALSE(append(positions, {}, {0, 1, 2}, {3, 0}));
+  EXPECT_FALSE(append(positions, {}, {0, 1, 2}, {2, 1}));
+  EXPECT_FALSE(append(positions, {}, {0, 1, 2}, {-1, 4}));
+  EXPECT_FALSE(append(positions, {}, {0, 1}, {}, 2, 1));
+  /* No face sizes at all. */
+  EXPECT_FALSE(append(positions, {}, {0, 1, 2}, {}, 1));
+
+  /* Nothing was appended, and the first error is the one kept. */
+  EXPECT_TRUE(builder.is_empty());
+  EXPECT_EQ(builder.error(), "Corner 2 of an output chunk refers to point 4, out of its 4 points");
+
+  /* Valid chunks are still appended after rejected ones. */
+  EXPECT_TRUE(append(positions, {}, {0, 1, 2, 3}, {4}));
+  Mesh *mesh = builder.finalize(nullptr);
+  EXPECT_EQ(mesh->totvert, 4);
+  EXPECT_EQ(polys(mesh), (std::vector<std::vector<int>>{{0, 1, 2, 3}}));
+  EXPECT_TRUE(builder.error().empty());
+  BKE_id_free(nullptr, mesh);
+}
+
+}  // namespace blender::modifiers::modifier_open_mfx_cc::tests
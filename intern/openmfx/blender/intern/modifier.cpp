@@ -37,6 +37,7 @@
 #include "BLI_string.h"
 
 using RuntimeData = blender::modifiers::modifier_open_mfx_cc::RuntimeData;
+using BakeCache = blender::modifiers::modifier_open_mfx_cc::BakeCache;
 
 /**
  * Ensure that fxmd->modifier.runtime points to a valid RuntimeData and return
@@ -132,3 +133,26 @@ void MFX_modifier_before_update_depsgraph(OpenMfxModifierData *fxmd)
   RuntimeData *runtime = ensure_runtime(fxmd);
   runtime->set_input_prop_in_rna(fxmd);
 }
+
+bool MFX_modifier_bake_wait(ReportList *reports)
+{
+  return BakeCache::wait_for_writes(reports);
+}
+
+void MFX_modifier_bake_free(OpenMfxModifierData *fxmd, Depsgraph *depsgraph, Object *object)
+{
+  RuntimeData *runtime = (RuntimeData *)fxmd->modifier.runtime;
+  if (NULL != runtime) {
+    runtime->bake_cache.clear();
+  }
+
+  // Read-ahead mappings outlive the removal of their file, so the evaluated copy that plays the
+  // cache back must drop them too.
+  ModifierData *md_eval = BKE_modifier_get_evaluated(depsgraph, object, &fxmd->modifier);
+  if (NULL != md_eval && NULL != md_eval->runtime) {
+    ((RuntimeData *)md_eval->runtime)->bake_cache.clear();
+  }
+
+  BakeCache::free_frames(fxmd, object);
+  fxmd->flag &= ~MOD_OPENMFX_CACHED;
+}
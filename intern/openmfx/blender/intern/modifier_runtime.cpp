@@ -26,6 +26,7 @@
 #include "BlenderMfxHost.h"
 
 #include "MFX_convert.h"
+#include "mesh_chunks.h"
 
 #include "DNA_mesh_types.h" // Mesh
 #include "DNA_modifier_types.h"
@@ -38,18 +39,22 @@
 #include "BLI_math_vector.h"
 #include "BLI_string.h"
 #include "BLI_path_util.h"
+#include "BLI_task.hh"
 
 #include "DEG_depsgraph.h"
 #include "DEG_depsgraph_query.h"
 
 #include "MFX_util.h"
 
+#include <OpenMfx/Sdk/Cpp/Host/CookBatcher>
+#include <OpenMfx/Sdk/Cpp/Host/EffectInstancePool>
 #include <OpenMfx/Sdk/Cpp/Host/EffectLibrary>
 #include <OpenMfx/Sdk/Cpp/Host/EffectRegistry>
 #include <OpenMfx/Sdk/Cpp/Host/MeshEffect>
 #include <OpenMfx/Sdk/Cpp/Host/messages>
 #include <OpenMfx/Sdk/Cpp/Host/Host>
 
+#include <string>
 #include <vector>
 #include <cassert>
 
@@ -58,6 +63,48 @@ using MeshInternalDataModifier = BlenderMfxHost::MeshInternalDataModifier;
 
 namespace blender::modifiers::modifier_open_mfx_cc {
 
+/**
+ * Modifiers of different objects are evaluated in parallel, the batcher groups the ones that
+ * cook the same effect at the same time.
+ */
+static OpenMfx::CookBatcher &cook_batcher()
+{
+  static OpenMfx::CookBatcher batcher;
+  return batcher;
+}
+
+/**
+ * Key of the modifiers that can be cooked in the same batch: same effect, same parameter values
+ * and extra inputs, evaluated in the same depsgraph.
+ */
+static std::string batch_key(const OpenMfxModifierData *fxmd,
+                             const OpenMfx::EffectLibrary *library,
+                             int effect_index,
+                             const Depsgraph *depsgraph)
+{
+  std::string key;
+  auto append = [&key](const void *data, size_t size) {
+    key.append(static_cast<const char *>(data), size);
+  };
+  append(&library, sizeof(library));
+  append(&effect_index, sizeof(effect_index));
+  append(&depsgraph, sizeof(depsgraph));
+  for (int i = 0; i < fxmd->num_parameters; ++i) {
+    const OpenMfxParameter &parameter = fxmd->parameters[i];
+    append(&parameter.type, sizeof(parameter.type));
+    append(parameter.float_vec_value, sizeof(parameter.float_vec_value));
+    append(parameter.integer_vec_value, sizeof(parameter.integer_vec_value));
+    append(parameter.string_value, strlen(parameter.string_value) + 1);
+  }
+  for (int i = 0; i < fxmd->num_extra_inputs; ++i) {
+    const OpenMfxInput &input = fxmd->extra_inputs[i];
+    append(&input.connected_object, sizeof(input.connected_object));
+    append(&input.request_geometry, sizeof(input.request_geometry));
+    append(&input.request_transform, sizeof(input.request_transform));
+  }
+  return key;
+}
+
 // ----------------------------------------------------------------------------
 // Public
 
@@ -68,8 +115,9 @@ RuntimeData::RuntimeData()
   effect_index = 0;
   mfx_host = nullptr;
   effect_desc = nullptr;
-  effect_instance = nullptr;
+  instance_pool = nullptr;
   library = nullptr;
+  m_message_type = OfxMessageType::Invalid;
 }
 
 RuntimeData::~RuntimeData()
@@ -108,7 +156,7 @@ void RuntimeData::set_effect_index(int effect_index)
   }
   
   if (-1 != this->effect_index) {
-    free_effect_instance();
+    free_instance_pool();
   }
 
   if (is_plugin_valid()) {
@@ -118,13 +166,14 @@ void RuntimeData::set_effect_index(int effect_index)
   }
 
   if (-1 != this->effect_index) {
-    ensure_effect_instance();
+    ensure_instance_pool();
   }
 }
 
-void RuntimeData::get_parameters_from_rna(OpenMfxModifierData *fxmd)
+void RuntimeData::get_parameters_from_rna(OpenMfxModifierData *fxmd,
+                                          OfxMeshEffectHandle effect_instance)
 {
-  OfxParamSetStruct& parameters = this->effect_instance->parameters;
+  OfxParamSetStruct& parameters = effect_instance->parameters;
   assert(parameters.count() == fxmd->num_parameters);
   for (int i = 0 ; i < fxmd->num_parameters ; ++i) {
     MFX_copy_parameter_value_from_rna(&parameters[i], fxmd->parameters + i);
@@ -133,23 +182,19 @@ void RuntimeData::get_parameters_from_rna(OpenMfxModifierData *fxmd)
 
 void RuntimeData::set_message_in_rna(OpenMfxModifierData *fxmd)
 {
-  if (NULL == this->effect_instance) {
-    return;
-  }
-
-  OfxMessageType type = this->effect_instance->messageType;
+  std::lock_guard<std::mutex> lock(m_message_mutex);
+  OfxMessageType type = m_message_type;
 
   if (type != OfxMessageType::Invalid) {
-    BLI_strncpy(fxmd->message, this->effect_instance->message, MOD_OPENMFX_MAX_MESSAGE);
-    fxmd->message[MOD_OPENMFX_MAX_MESSAGE - 1] = '\0';
+    BLI_strncpy(fxmd->message, m_message.c_str(), MOD_OPENMFX_MAX_MESSAGE);
   }
 
   if (type == OfxMessageType::Error || type == OfxMessageType::Fatal) {
-    BKE_modifier_set_error(NULL, &fxmd->modifier, this->effect_instance->message);
+    BKE_modifier_set_error(NULL, &fxmd->modifier, "%s", m_message.c_str());
   }
 }
 
-bool RuntimeData::ensure_effect_instance()
+bool RuntimeData::ensure_instance_pool()
 {
 
   if (false == is_plugin_valid()) {
@@ -170,8 +215,8 @@ bool RuntimeData::ensure_effect_instance()
     }
   }
 
-  if (nullptr == this->effect_instance) {
-    mfx_host->CreateInstance(this->effect_desc, this->effect_instance);
+  if (nullptr == this->instance_pool) {
+    this->instance_pool = new OpenMfx::EffectInstancePool(mfx_host, this->effect_desc);
   }
 
   return true;
@@ -208,26 +253,73 @@ Mesh *RuntimeData::cook(OpenMfxModifierData *fxmd,
                                   Mesh *mesh,
                                   Object *object)
 {
-  if (false == this->ensure_effect_instance()) {
+  const int frame = (int)DEG_get_ctime(depsgraph);
+  const bool is_baking = 0 != (fxmd->flag & MOD_OPENMFX_CACHE_BAKING);
+
+  // Playback from the bake cache
+  if (!is_baking && 0 != (fxmd->flag & MOD_OPENMFX_USE_CACHE)) {
+    BakeCache::ReadStatus read_status;
+    Mesh *cached_mesh = this->bake_cache.read_frame(fxmd, object, frame, mesh, &read_status);
+    if (NULL != cached_mesh) {
+      return cached_mesh;
+    }
+
+    // A baked frame went missing or got corrupted, the bake is no longer complete so the frame
+    // is cooked instead.
+    const bool is_cached = 0 != (fxmd->flag & MOD_OPENMFX_CACHED);
+    if (read_status == BakeCache::ReadStatus::Invalid ||
+        (read_status == BakeCache::ReadStatus::Missing && is_cached)) {
+      BKE_modifier_set_error(object,
+                             &fxmd->modifier,
+                             read_status == BakeCache::ReadStatus::Missing ?
+                                 "Baked frame %d is missing, cooking it instead" :
+                                 "Baked frame %d could not be read, cooking it instead",
+                             frame);
+      fxmd->flag &= ~MOD_OPENMFX_CACHED;
+      if (DEG_is_active(depsgraph)) {
+        ModifierData *md_orig = BKE_modifier_get_original(object, &fxmd->modifier);
+        if (NULL != md_orig) {
+          ((OpenMfxModifierData *)md_orig)->flag &= ~MOD_OPENMFX_CACHED;
+        }
+      }
+    }
+  }
+
+  if (false == this->ensure_instance_pool()) {
+    printf("failed to get effect instance\n");
+    return NULL;
+  }
+
+  if (mfx_host->SupportsBatch(this->effect_desc)) {
+    return this->cook_grouped(fxmd, depsgraph, mesh, object);
+  }
+
+  // Inputs and parameters are stored in the instance, so each concurrent cook needs its own.
+  OpenMfx::EffectInstancePool::Lease lease(*this->instance_pool);
+  OfxMeshEffectHandle effect_instance = lease.get();
+  if (nullptr == effect_instance) {
     printf("failed to get effect instance\n");
     return NULL;
   }
 
   OfxMeshInputHandle input, output;
-  mfx_host->meshEffectSuite->inputGetHandle(this->effect_instance, kOfxMeshMainInput, &input, NULL);
-  mfx_host->meshEffectSuite->inputGetHandle(this->effect_instance, kOfxMeshMainOutput, &output, NULL);
+  mfx_host->meshEffectSuite->inputGetHandle(effect_instance, kOfxMeshMainInput, &input, NULL);
+  mfx_host->meshEffectSuite->inputGetHandle(effect_instance, kOfxMeshMainOutput, &output, NULL);
 
   // Get parameters
-  this->get_parameters_from_rna(fxmd);
+  this->get_parameters_from_rna(fxmd, effect_instance);
 
   // Test if we can skip cooking
   bool isIdentity = true;
   char *inputToPassThrough = nullptr;
-  mfx_host->IsIdentity(this->effect_instance, &isIdentity, &inputToPassThrough);
+  mfx_host->IsIdentity(effect_instance, &isIdentity, &inputToPassThrough);
 
   if (isIdentity) {
     printf("effect is identity, skipping cooking\n");
     // TODO: handle cases where 'inputToPassThrough' is not 'MainInput'
+    if (is_baking) {
+      BakeCache::write_frame(fxmd, object, frame, mesh);
+    }
     return mesh;
   }
 
@@ -249,7 +341,7 @@ Mesh *RuntimeData::cook(OpenMfxModifierData *fxmd,
   for (int i = 0; i < fxmd->num_extra_inputs; ++i) {
     OfxMeshInputHandle input;
     mfx_host->meshEffectSuite->inputGetHandle(
-        this->effect_instance, fxmd->extra_inputs[i].name, &input, NULL);
+        effect_instance, fxmd->extra_inputs[i].name, &input, NULL);
 
     Object *object = fxmd->extra_inputs[i].connected_object;
 
@@ -279,7 +371,16 @@ Mesh *RuntimeData::cook(OpenMfxModifierData *fxmd,
   mfx_host->propertySuite->propSetPointer(
       &output->mesh.properties, kOfxMeshPropInternalData, 0, (void *)&output_data);
 
-  if (!mfx_host->Cook(this->effect_instance)) {
+  // Modifiers of other objects may be evaluated meanwhile, and cooks of thread unsafe effects
+  // wait for each other, so the waiting thread must not pick up another modifier evaluation.
+  bool success = false;
+  threading::isolate_task([&]() { success = mfx_host->Cook(effect_instance); });
+  this->save_message(effect_instance);
+  if (!success) {
+    return nullptr;
+  }
+
+  if (!finalize_chunked_output(fxmd, object, output_data, mesh)) {
     return nullptr;
   }
 
@@ -288,9 +389,125 @@ Mesh *RuntimeData::cook(OpenMfxModifierData *fxmd,
 
   this->set_message_in_rna(fxmd);
 
+  if (is_baking) {
+    BakeCache::write_frame(fxmd, object, frame, output_data.blender_mesh);
+  }
+
   return output_data.blender_mesh;
 }
 
+Mesh *RuntimeData::cook_grouped(OpenMfxModifierData *fxmd,
+                                const Depsgraph *depsgraph,
+                                Mesh *mesh,
+                                Object *object)
+{
+  const int frame = (int)DEG_get_ctime(depsgraph);
+  const bool is_baking = 0 != (fxmd->flag & MOD_OPENMFX_CACHE_BAKING);
+
+  // The thread that cooks the batch uses its own modifier for the parameters and extra inputs, so
+  // the items of a batch must agree on all of them.
+  BatchItem item = {fxmd, mesh, object, nullptr};
+  cook_batcher().cook(batch_key(fxmd, this->library, this->effect_index, depsgraph),
+                      &item,
+                      [&](void **items, int count) {
+                        this->cook_batch(
+                            fxmd, depsgraph, reinterpret_cast<BatchItem *const *>(items), count);
+                      });
+
+  if (nullptr == item.result) {
+    return nullptr;
+  }
+
+  this->set_message_in_rna(fxmd);
+
+  if (is_baking) {
+    BakeCache::write_frame(fxmd, object, frame, item.result);
+  }
+
+  return item.result;
+}
+
+void RuntimeData::cook_batch(OpenMfxModifierData *fxmd,
+                             const Depsgraph *depsgraph,
+                             BatchItem *const *items,
+                             int count)
+{
+  OpenMfx::EffectInstancePool::Lease lease(*this->instance_pool);
+  OfxMeshEffectHandle effect_instance = lease.get();
+  if (nullptr == effect_instance) {
+    printf("failed to get effect instance\n");
+    return;
+  }
+
+  this->get_parameters_from_rna(fxmd, effect_instance);
+
+  bool isIdentity = true;
+  mfx_host->IsIdentity(effect_instance, &isIdentity, nullptr);
+  if (isIdentity) {
+    for (int b = 0; b < count; ++b) {
+      items[b]->result = items[b]->mesh;
+    }
+    return;
+  }
+
+  // Bind one internal data per input and item, they must remain in scope until after the cook.
+  // Extra inputs are shared by all items of the batch.
+  const int input_count = 2 + fxmd->num_extra_inputs;
+  std::vector<MeshInternalDataModifier> item_data(static_cast<size_t>(count) * input_count);
+  mfx_host->PrepareBatch(effect_instance, count);
+
+  for (int i = 0; i < input_count; ++i) {
+    const char *name = i == 0 ? kOfxMeshMainInput :
+                       i == 1 ? kOfxMeshMainOutput :
+                                fxmd->extra_inputs[i - 2].name;
+    OfxMeshInputHandle input;
+    if (kOfxStatOK !=
+        mfx_host->meshEffectSuite->inputGetHandle(effect_instance, name, &input, NULL)) {
+      continue;
+    }
+
+    Object *extra_object = nullptr;
+    Mesh *extra_mesh = nullptr;
+    if (i >= 2) {
+      extra_object = fxmd->extra_inputs[i - 2].connected_object;
+      if (extra_object != NULL && fxmd->extra_inputs[i - 2].request_geometry) {
+        Object *object_eval = DEG_get_evaluated_object(depsgraph, extra_object);
+        extra_mesh = BKE_modifier_get_evaluated_mesh_from_evaluated_object(object_eval);
+      }
+    }
+
+    for (int b = 0; b < count; ++b) {
+      MeshInternalDataModifier &data = item_data[static_cast<size_t>(b) * input_count + i];
+      data.header.is_input = i != 1;
+      data.header.type = BlenderMfxHost::CallbackContext::Modifier;
+      data.blender_mesh = i == 0 ? items[b]->mesh : i == 1 ? NULL : extra_mesh;
+      data.source_mesh = i == 1 ? items[b]->mesh : NULL;
+      data.object = i < 2 ? items[b]->object : extra_object;
+      mfx_host->propertySuite->propSetPointer(
+          &input->batch_meshes[b].properties, kOfxMeshPropInternalData, 0, (void *)&data);
+    }
+  }
+
+  bool success = false;
+  threading::isolate_task([&]() { success = mfx_host->CookBatch(effect_instance); });
+
+  for (int b = 0; b < count; ++b) {
+    // Each modifier of the batch reports the message of the cook
+    RuntimeData *item_runtime = static_cast<RuntimeData *>(items[b]->fxmd->modifier.runtime);
+    item_runtime->save_message(effect_instance);
+
+    // When the host falls back to cooking items one by one, some of them may have succeeded
+    MeshInternalDataModifier &output_data = item_data[static_cast<size_t>(b) * input_count + 1];
+    if (finalize_chunked_output(items[b]->fxmd, items[b]->object, output_data, items[b]->mesh)) {
+      items[b]->result = output_data.blender_mesh;
+    }
+  }
+
+  if (!success) {
+    printf("failed to cook a batch of %d meshes\n", count);
+  }
+}
+
 void RuntimeData::reload_effect_info(OpenMfxModifierData *fxmd)
 {
   // Free previous info
@@ -495,18 +712,48 @@ void RuntimeData::set_input_prop_in_rna(OpenMfxModifierData *fxmd)
 // ----------------------------------------------------------------------------
 // Private
 
-void RuntimeData::free_effect_instance()
+bool RuntimeData::finalize_chunked_output(OpenMfxModifierData *fxmd,
+                                          Object *object,
+                                          MeshInternalDataModifier &output_data,
+                                          Mesh *source_mesh)
+{
+  // A chunk was rejected, building the others would yield a mesh with holes
+  if (nullptr != output_data.chunk_builder && !output_data.chunk_builder->error().empty()) {
+    BKE_modifier_set_error(
+        object, &fxmd->modifier, "%s", output_data.chunk_builder->error().c_str());
+    return false;
+  }
+
+  // The effect may have written its output chunk by chunk rather than at once
+  if (nullptr == output_data.blender_mesh && nullptr != output_data.chunk_builder &&
+      !output_data.chunk_builder->is_empty()) {
+    output_data.blender_mesh = output_data.chunk_builder->finalize(source_mesh);
+    if (BKE_mesh_validate(output_data.blender_mesh, true, true)) {
+      printf("Warning: Mesh returned by the OpenMfx plugin had to be fixed.\n");
+    }
+  }
+  return true;
+}
+
+void RuntimeData::free_instance_pool()
 {
   if (is_plugin_valid() && -1 != this->effect_index) {
-    if (nullptr != this->effect_instance) {
-      mfx_host->DestroyInstance(this->effect_instance);
-      this->effect_instance = nullptr;
+    if (nullptr != this->instance_pool) {
+      delete this->instance_pool;
+      this->instance_pool = nullptr;
     }
 
     this->effect_index = -1;
   }
 }
 
+void RuntimeData::save_message(OfxMeshEffectHandle effect_instance)
+{
+  std::lock_guard<std::mutex> lock(m_message_mutex);
+  m_message_type = effect_instance->messageType;
+  m_message = effect_instance->message;
+}
+
 void RuntimeData::ensure_host()
 {
   if (nullptr == this->mfx_host) {
@@ -518,7 +765,7 @@ void RuntimeData::reset_plugin_path()
 {
   if (is_plugin_valid()) {
     printf("Unloading OFX plugin %s\n", this->plugin_path);
-    free_effect_instance();
+    free_instance_pool();
 
     char abs_path[FILE_MAX];
     MFX_normalize_plugin_path(abs_path, this->plugin_path);
@@ -21,18 +21,23 @@
  */
 
 #include <OpenMfx/Sdk/Cpp/Host/Host>
+#include <OpenMfx/Sdk/Cpp/Host/EffectInstancePool>
 #include <OpenMfx/Sdk/Cpp/Host/EffectLibrary>
+#include <OpenMfx/Sdk/Cpp/Host/messages>
 
 #include "ofxCore.h"
 
+#include "bake_cache.h"
+
 #include "DNA_mesh_types.h"
 #include "DNA_modifier_types.h"
 #include "DNA_object_types.h"
 
 #include <map>
+#include <mutex>
 #include <string>
 
-class BlenderMfxHost;
+#include "BlenderMfxHost.h"
 
 namespace blender::modifiers::modifier_open_mfx_cc {
 
@@ -61,17 +66,18 @@ class RuntimeData {
   /**
    * Set parameter values from Blender's RNA to the Open Mesh Effect host's structure.
    */
-  void get_parameters_from_rna(OpenMfxModifierData *fxmd);
+  void get_parameters_from_rna(OpenMfxModifierData *fxmd, OfxMeshEffectHandle effect_instance);
 
   /**
-   * Copy messages returned by the plugin in the RNA
+   * Copy messages returned by the plugin during the last cook in the RNA
    */
   void set_message_in_rna(OpenMfxModifierData *fxmd);
 
   /**
-   * Ensures that the effect descriptor and instances are valid (may fail, and hence return false)
+   * Ensures that the effect descriptor and instance pool are valid (may fail, and hence return
+   * false)
    */
-  bool ensure_effect_instance();
+  bool ensure_instance_pool();
 
   /**
    * Tells whether the plugin specified by plugin_path is valid. If true, then 'registry' can be
@@ -147,15 +153,65 @@ class RuntimeData {
   OfxMeshEffectHandle effect_desc;
 
   /**
-   * Effect instance, used for cooking
+   * Instances of the effect, used for cooking. The modifier is cooked from several threads at
+   * once by the bake and apply operators and when evaluated in several depsgraphs, each cook
+   * leases its own instance, or a shared one for fully thread safe effects.
    */
-  OfxMeshEffectHandle effect_instance;
+  OpenMfx::EffectInstancePool *instance_pool;
+
+  /**
+   * Playback of the frames baked on disk
+   */
+  BakeCache bake_cache;
 
 private:
   /**
-   * Free the descriptor and instance, if it had been allocated (otherwise does nothing)
+   * A mesh to cook in a batch, and the modifier it is evaluated for
+   */
+  struct BatchItem {
+    OpenMfxModifierData *fxmd;
+    Mesh *mesh;
+    Object *object;
+    /** Output of the effect, nullptr if it failed to cook */
+    Mesh *result;
+  };
+
+  /**
+   * Cook the mesh along with the ones of the other modifiers that use the same effect with the
+   * same parameters and are evaluated at the same time, for effects that support batches.
+   */
+  Mesh *cook_grouped(OpenMfxModifierData *fxmd,
+                     const Depsgraph *depsgraph,
+                     Mesh *mesh,
+                     Object *object);
+
+  /**
+   * Apply the effect to several meshes at once, with the parameters and extra inputs of fxmd.
+   * Plugins that support it get all meshes in a single cook call.
    */
-  void free_effect_instance();
+  void cook_batch(OpenMfxModifierData *fxmd,
+                  const Depsgraph *depsgraph,
+                  BatchItem *const *items,
+                  int count);
+
+  /**
+   * Turn the chunks released by the effect into the output mesh, if it was streamed.
+   * \return false and set the modifier error if the effect released an invalid chunk.
+   */
+  static bool finalize_chunked_output(OpenMfxModifierData *fxmd,
+                                      Object *object,
+                                      BlenderMfxHost::MeshInternalDataModifier &output_data,
+                                      Mesh *source_mesh);
+
+  /**
+   * Free the descriptor and instances, if they had been allocated (otherwise does nothing)
+   */
+  void free_instance_pool();
+
+  /**
+   * Keep the message of the instance that just cooked for set_message_in_rna()
+   */
+  void save_message(OfxMeshEffectHandle effect_instance);
 
   /**
    * Ensures that the ofx_host member if a valid OfxHost
@@ -175,6 +231,10 @@ private:
   bool m_is_plugin_valid;
 
   std::map<std::string, OfxParamStruct> m_saved_parameter_values;
+
+  OfxMessageType m_message_type;
+  std::string m_message;
+  std::mutex m_message_mutex;
 };
 
 }  // namespace blender::modifiers::modifier_open_mfx_cc
@@ -31,6 +31,7 @@
 
 #include "BlenderMfxHost.h"
 
+#include <OpenMfx/Sdk/Cpp/Host/EffectInstancePool>
 #include <OpenMfx/Sdk/Cpp/Host/EffectRegistry>
 #include <OpenMfx/Sdk/Cpp/Host/EffectLibrary>
 
@@ -45,7 +46,7 @@ RuntimeData::RuntimeData()
   m_loaded_plugin_path[0] = '\0';
   m_loaded_effect_index = -1;
   m_effect_descriptor = nullptr;
-  m_effect_instance = nullptr;
+  m_instance_pool = nullptr;
   m_library = nullptr;
   m_must_update = true;
 }
@@ -65,8 +66,8 @@ RuntimeData &RuntimeData::operator=(const RuntimeData &other)
 
   EffectRegistry.incrementLibraryReference(m_library);
 
-  if (other.m_effect_instance != nullptr) {
-    ensureEffectInstance();
+  if (other.m_instance_pool != nullptr) {
+    ensureInstancePool();
   }
   return *this;
 }
@@ -105,7 +106,7 @@ bool RuntimeData::setEffectIndex(int effect_index)
   }
 
   if (-1 != m_loaded_effect_index) {
-    freeEffectInstance();
+    freeInstancePool();
   }
 
   if (isLibraryLoaded()) {
@@ -116,7 +117,7 @@ bool RuntimeData::setEffectIndex(int effect_index)
   }
 
   if (-1 != m_loaded_effect_index) {
-    ensureEffectInstance();
+    ensureInstancePool();
   }
 
   m_must_update = true;
@@ -133,9 +134,9 @@ OfxMeshEffectHandle RuntimeData::effectDescriptor() const
   return m_effect_descriptor;
 }
 
-OfxMeshEffectHandle RuntimeData::effectInstance() const
+OpenMfx::EffectInstancePool *RuntimeData::instancePool() const
 {
-  return m_effect_instance;
+  return m_instance_pool;
 }
 
 const OpenMfx::EffectLibrary &RuntimeData::library() const
@@ -152,7 +153,7 @@ void RuntimeData::unloadPlugin()
 {
   if (isLibraryLoaded()) {
     printf("Unloading OFX plugin %s\n", m_loaded_plugin_path);
-    freeEffectInstance();
+    freeInstancePool();
 
     EffectRegistry.releaseLibrary(m_library);
     m_library = nullptr;
@@ -166,10 +167,10 @@ bool RuntimeData::isLibraryLoaded() const
   return m_library != nullptr;
 }
 
-void RuntimeData::ensureEffectInstance()
+void RuntimeData::ensureInstancePool()
 {
-  if (nullptr != m_effect_instance)
-    return; // Instance already available
+  if (nullptr != m_instance_pool)
+    return; // Pool already available
 
   if (!isLibraryLoaded() || m_loaded_effect_index == -1)
     return; // Invalid effect
@@ -179,18 +180,24 @@ void RuntimeData::ensureEffectInstance()
   if (m_effect_descriptor == nullptr)
     return; // Invalid effect
 
+  // Create a first instance right away to make sure that the effect can be instantiated. Other
+  // ones are added on demand when the node gets evaluated in several contexts at once.
   auto &host = BlenderMfxHost::GetInstance();
-  if (!host.CreateInstance(m_effect_descriptor, m_effect_instance)) {
-    m_effect_instance = nullptr;
+  m_instance_pool = new EffectInstancePool(&host, m_effect_descriptor);
+  OfxMeshEffectHandle instance = m_instance_pool->acquire();
+  if (nullptr == instance) {
+    delete m_instance_pool;
+    m_instance_pool = nullptr;
+    return;
   }
+  m_instance_pool->release(instance);
 }
 
-void RuntimeData::freeEffectInstance()
+void RuntimeData::freeInstancePool()
 {
-  if (nullptr != m_effect_instance) {
-    auto &host = BlenderMfxHost::GetInstance();
-    host.DestroyInstance(m_effect_instance);
-    m_effect_instance = nullptr;
+  if (nullptr != m_instance_pool) {
+    delete m_instance_pool;
+    m_instance_pool = nullptr;
   }
   m_effect_descriptor = nullptr;
   m_loaded_effect_index = -1;
@@ -126,6 +126,16 @@ attributes include a position for points, a point index for corners and a corner
  */
 #define kOfxMeshAttribFaceSize "OfxMeshAttribFaceSize"
 
+/** @brief Name of the point attribute giving, in a mesh chunk, the index of each point in the
+ * whole mesh.
+ *
+ * This integer attribute is defined by the host on the chunks returned by
+ * OfxMeshEffectSuiteV1::inputGetMeshChunk. When a plugin defines it on the chunks of its output,
+ * points of different chunks that share the same global index are merged back into a single point.
+ * \see kOfxMeshPropChunkIndex
+ */
+#define kOfxMeshAttribPointGlobalIndex "OfxMeshAttribPointGlobalIndex"
+
 /** @brief Attribute type unsigned integer 8 bit
  */
 #define kOfxMeshAttribTypeUByte "OfxMeshAttribTypeUByte"
@@ -138,6 +148,24 @@ attributes include a position for points, a point index for corners and a corner
  */
 #define kOfxMeshAttribTypeFloat "OfxMeshAttribTypeFloat"
 
+/** @brief Attribute type signed integer 8 bit
+ */
+#define kOfxMeshAttribTypeInt8 "OfxMeshAttribTypeInt8"
+
+/** @brief Attribute type signed integer 16 bit
+ */
+#define kOfxMeshAttribTypeInt16 "OfxMeshAttribTypeInt16"
+
+/** @brief Attribute type float 16 bit (IEEE 754 half precision)
+ */
+#define kOfxMeshAttribTypeHalf "OfxMeshAttribTypeHalf"
+
+/** @brief Attribute type unsigned integer 8 bit, representing a value in the [0, 1] range
+
+The stored byte \e b stands for the value \e b / 255. This is typically used for colors.
+ */
+#define kOfxMeshAttribTypeUByteNormalized "OfxMeshAttribTypeUByteNormalized"
+
 /** @brief Attribute semantic for texture coordinates (sometimes called "UV")
 
 Such attribute is usually attached to corners (or sometimes to points), has 2 floats or 3 floats
@@ -255,6 +283,41 @@ For more details on how to deal with actions, see \ref MeshEffectActions.
  */
 #define kOfxMeshEffectActionCook                "OfxMeshEffectActionCook"
 
+/** @brief
+
+ This action cooks the effect on several independent sets of input and output
+ meshes at once, all sharing the same parameter values. It is only called on
+ effects whose descriptor sets \ref kOfxMeshEffectPropSupportsBatch to true.
+ It lets a plug-in amortize its setup (lookup tables, acceleration structures,
+ thread pools) across meshes, and process the items of the batch concurrently.
+
+ Within this action, meshes are fetched with
+ OfxMeshEffectSuiteV1::inputGetBatchMesh rather than inputGetMesh. Each item of
+ the batch must be cooked as if the regular cook action had been called for it.
+
+ @param  handle handle to the instance, cast to an \ref OfxMeshEffectHandle
+ @param  inArgs has the following properties
+     -  \ref kOfxPropTime the time at which to cook
+     -  \ref kOfxMeshEffectPropBatchSize the number of items in the batch
+
+ @param  outArgs is redundant and should be set to NULL
+
+      \pre
+         -  \ref kOfxActionCreateInstance has been called on the instance
+
+ @returns
+      -  \ref kOfxStatOK, the effect cooked all items normally
+      -  \ref kOfxStatReplyDefault, the action was not trapped and the host should
+     call the cook action once per item instead
+      -  \ref kOfxStatErrMemory, in which case the action may be called again after
+     a memory purge
+      -  \ref kOfxStatFailed, something wrong, but no error code appropriate,
+     plugin to post message
+      -  \ref kOfxStatErrFatal
+
+ */
+#define kOfxMeshEffectActionCookBatch           "OfxMeshEffectActionCookBatch"
+
 /** @brief
 
  This action is unique to OFX Mesh Effect plug-ins. Because a plugin is
@@ -331,6 +394,55 @@ true might enable optimizations from the host.
  */
 #define kOfxMeshEffectPropIsDeformation "OfxMeshEffectPropIsDeformation"
 
+/** @brief Tells whether the effect implements \ref kOfxMeshEffectActionCookBatch
+
+   - Type - bool X 1
+   - Property Set - mesh effect descriptor passed to kOfxActionDescribe (read/write)
+   - Default - false
+
+When false, a host that has several meshes to cook with the same parameters calls
+the regular cook action once per mesh.
+ */
+#define kOfxMeshEffectPropSupportsBatch "OfxMeshEffectPropSupportsBatch"
+
+/** @brief Number of items cooked by \ref kOfxMeshEffectActionCookBatch
+
+   - Type - int X 1
+   - Property Set - inArgs of the cook batch action (read only)
+ */
+#define kOfxMeshEffectPropBatchSize "OfxMeshEffectPropBatchSize"
+
+/** @brief Indicates how many cook actions may run at the same time for an effect
+
+   - Type - string X 1
+   - Property Set - mesh effect descriptor passed to kOfxActionDescribe (read/write)
+   - Default - ::kOfxMeshEffectThreadSafetyInstanceSafe
+   - Valid Values - This must be one of
+      - ::kOfxMeshEffectThreadSafetyUnsafe
+      - ::kOfxMeshEffectThreadSafetyInstanceSafe
+      - ::kOfxMeshEffectThreadSafetyFullySafe
+
+This is the mesh counterpart of kOfxImageEffectPluginRenderThreadSafety. Hosts
+may create several instances of an instance safe effect so that the same node
+can be cooked in different contexts concurrently.
+ */
+#define kOfxMeshEffectPropThreadSafety "OfxMeshEffectPropThreadSafety"
+
+/** @brief Only a single cook action may run at any time, across all the
+ instances of all unsafe effects */
+#define kOfxMeshEffectThreadSafetyUnsafe "OfxMeshEffectThreadSafetyUnsafe"
+
+/** @brief Each instance cooks one mesh at a time, but different instances of the
+ effect may cook concurrently */
+#define kOfxMeshEffectThreadSafetyInstanceSafe "OfxMeshEffectThreadSafetyInstanceSafe"
+
+/** @brief Any instance may cook concurrently with itself or with other instances
+
+ Hosts may then keep a single instance of the effect for all concurrent cooks,
+ so state that differs from one cook to another must not be stored in the
+ instance data. */
+#define kOfxMeshEffectThreadSafetyFullySafe "OfxMeshEffectThreadSafetyFullySafe"
+
 /** @brief The plugin handle passed to the initial 'describe' action.
 
    - Type - pointer X 1
@@ -456,6 +568,46 @@ This will decide wether the effect will forward the attributes of source meshes.
 #define kOfxInputPropRequestIOMap "OfxInputPropRequestIOMap"
 
 
+/** @brief Maximum number of faces per chunk when streaming the mesh of an input
+
+    - Type - int X 1
+    - Property Set - an input's property set
+
+Can be set in describe mode to tell the host that the effect will fetch this input chunk by chunk
+with OfxMeshEffectSuiteV1::inputGetMeshChunk rather than at once with inputGetMesh. Chunks are
+spatially coherent groups of at most this number of faces, so that only one chunk at a time needs
+to be in memory on both sides. Default to 0, meaning that the mesh is not split.
+ */
+#define kOfxInputPropRequestChunkSize "OfxInputPropRequestChunkSize"
+
+/** @brief Index of the chunk held by a mesh, or -1
+
+    - Type - int X 1
+    - Property Set - a mesh instance (read only)
+
+This is -1 for meshes returned by inputGetMesh and the chunk index for meshes returned by
+inputGetMeshChunk. A chunk is a regular mesh whose corners refer to its own points, but its
+points also hold a \ref kOfxMeshAttribPointGlobalIndex attribute.
+ */
+#define kOfxMeshPropChunkIndex "OfxMeshPropChunkIndex"
+
+/** @brief Total number of chunks of an input mesh
+
+    - Type - int X 1
+    - Property Set - a mesh instance (read only)
+
+Set by the host on the meshes returned by inputGetMeshChunk on inputs. For the output, the effect
+decides how many chunks it writes and this property is not used.
+ */
+#define kOfxMeshPropChunkCount "OfxMeshPropChunkCount"
+
+/** @brief Maximum number of faces of a chunk, copied from \ref kOfxInputPropRequestChunkSize
+
+    - Type - int X 1
+    - Property Set - a mesh instance (read only)
+ */
+#define kOfxMeshPropChunkSize "OfxMeshPropChunkSize"
+
 /** @brief As a member of a mesh effect, pointer to the I/O map used in the attribute propagation phase
 
     - Type - Pointer X 1
@@ -511,8 +663,9 @@ An attribute can have between 1 and 4 components.
     - Type - string X 1
     - Property Set - a mesh attribute (read only)
 
-Possible values are \ref kOfxMeshAttribTypeFloat, \ref kOfxMeshAttribTypeInt
-or \ref kOfxMeshAttribTypeUByte
+Possible values are \ref kOfxMeshAttribTypeFloat, \ref kOfxMeshAttribTypeInt,
+\ref kOfxMeshAttribTypeUByte, \ref kOfxMeshAttribTypeInt8, \ref kOfxMeshAttribTypeInt16,
+\ref kOfxMeshAttribTypeHalf or \ref kOfxMeshAttribTypeUByteNormalized
 */
 #define kOfxMeshAttribPropType "OfxMeshAttribPropType"
 
@@ -860,6 +1013,66 @@ By default, the attribute data is not owned by the mesh (kOfxMeshAttribPropIsOwn
  */
   int (*abort)(OfxMeshEffectHandle meshEffect);
 
+  /** @brief Get a handle for a chunk of the mesh in an input at the indicated time
+
+      \arg input       - the input to extract the mesh chunk from
+      \arg time        - time to fetch the mesh at
+      \arg chunkIndex  - index of the chunk, starting from 0
+      \arg meshHandle  - mesh containing the chunk's data
+      \arg propertySet - property set containing the mesh properties (may be NULL)
+
+  This behaves like inputGetMesh but only returns a spatially coherent range of at most
+  \ref kOfxInputPropRequestChunkSize faces, together with the points they use, remapped to local
+  indices. The total number of chunks is given by the \ref kOfxMeshPropChunkCount property of the
+  returned mesh. Each chunk must be released with inputReleaseMesh before the next one is fetched.
+
+  When called on the output, each released chunk is appended to the output mesh, so that the
+  effect never needs to allocate the whole output at once.
+
+      \pre
+        - input was returned by inputGetHandle
+        - the previous chunk of the same input has been released
+
+  @returns
+      - ::kOfxStatOK           - the chunk was successfully fetched and returned in the handle,
+      - ::kOfxStatErrBadIndex  - the chunk index is past the last chunk of the input,
+      - ::kOfxStatErrBadHandle - the input handle was invalid,
+      - ::kOfxStatErrMemory    - the host had not enough memory to complete the operation, plugin should abort whatever it was doing.
+  */
+  OfxStatus (*inputGetMeshChunk)(OfxMeshInputHandle input,
+                                 OfxTime time,
+                                 int chunkIndex,
+                                 OfxMeshHandle *meshHandle,
+                                 OfxPropertySetHandle *propertySet);
+
+  /** @brief Get a handle for the mesh of an item of a batch in an input
+
+      \arg input       - the input to extract the mesh from
+      \arg time        - time to fetch the mesh at
+      \arg batchIndex  - index of the item, between 0 and \ref kOfxMeshEffectPropBatchSize
+      \arg meshHandle  - mesh containing the mesh's data
+      \arg propertySet - property set containing the mesh properties (may be NULL)
+
+  This behaves like inputGetMesh for the given item of the batch. The meshes of
+  different items are independent, so they may be fetched, filled and released
+  from different threads.
+
+      \pre
+        - called from inside the \ref kOfxMeshEffectActionCookBatch action
+        - input was returned by inputGetHandle
+
+  @returns
+      - ::kOfxStatOK           - the mesh was successfully fetched and returned in the handle,
+      - ::kOfxStatErrBadIndex  - the batch index is out of range, or no batch is being cooked,
+      - ::kOfxStatErrBadHandle - the input handle was invalid,
+      - ::kOfxStatErrMemory    - the host had not enough memory to complete the operation, plugin should abort whatever it was doing.
+  */
+  OfxStatus (*inputGetBatchMesh)(OfxMeshInputHandle input,
+                                 OfxTime time,
+                                 int batchIndex,
+                                 OfxMeshHandle *meshHandle,
+                                 OfxPropertySetHandle *propertySet);
+
 } OfxMeshEffectSuiteV1;
 
 
@@ -215,4 +215,6 @@ const OfxMeshEffectSuiteV1 meshEffectSuiteV1 = {
   meshGetPropertySet, // OfxStatus (*meshGetPropertySet)(OfxMeshHandle mesh,
   meshAlloc, // OfxStatus (*meshAlloc)(OfxMeshHandle meshHandle);
   NULL, // int (*abort)(OfxMeshEffectHandle meshEffect);
+  NULL, // OfxStatus (*inputGetMeshChunk)(OfxMeshInputHandle input,
+  NULL, // OfxStatus (*inputGetBatchMesh)(OfxMeshInputHandle input,
 };
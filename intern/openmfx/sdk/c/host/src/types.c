@@ -79,8 +79,14 @@ OfxStatus attributeAlloc(OfxMeshAttributePropertySet *attrib, OfxMeshPropertySet
     component_size = sizeof(float);
   } else if (0 == strcmp(attrib->type, kOfxMeshAttribTypeInt)) {
     component_size = sizeof(int);
-  } else if (0 == strcmp(attrib->type, kOfxMeshAttribTypeUByte)) {
+  } else if (0 == strcmp(attrib->type, kOfxMeshAttribTypeUByte) ||
+             0 == strcmp(attrib->type, kOfxMeshAttribTypeUByteNormalized)) {
     component_size = sizeof(unsigned char);
+  } else if (0 == strcmp(attrib->type, kOfxMeshAttribTypeInt8)) {
+    component_size = sizeof(signed char);
+  } else if (0 == strcmp(attrib->type, kOfxMeshAttribTypeInt16) ||
+             0 == strcmp(attrib->type, kOfxMeshAttribTypeHalf)) {
+    component_size = sizeof(short);
   } else {
     assert(0);
   }
@@ -0,0 +1,252 @@
+/*
+ * Copyright 2019-2022 Elie Michel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AttributeConversion.h"
+
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+namespace OpenMfx {
+
+int byteSizeOf(AttributeType type) {
+    switch (type) {
+    case AttributeType::UByte:
+    case AttributeType::UByteNormalized:
+        return sizeof(unsigned char);
+    case AttributeType::Int:
+        return sizeof(int);
+    case AttributeType::Float:
+        return sizeof(float);
+    case AttributeType::Int8:
+        return sizeof(int8_t);
+    case AttributeType::Int16:
+    case AttributeType::Half:
+        return sizeof(uint16_t);
+    case AttributeType::Unknown:
+    default:
+        return 0;
+    }
+}
+
+float halfToFloat(uint16_t half) {
+    uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1f;
+    uint32_t mantissa = half & 0x3ff;
+
+    uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        }
+        else {
+            // Subnormal half, renormalize it
+            exponent = 127 - 15 + 1;
+            while (0 == (mantissa & 0x400)) {
+                mantissa <<= 1;
+                --exponent;
+            }
+            mantissa &= 0x3ff;
+            bits = sign | (exponent << 23) | (mantissa << 13);
+        }
+    }
+    else if (exponent == 0x1f) {
+        // Infinity or NaN
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    }
+    else {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+    int32_t exponent = (int32_t)((bits >> 23) & 0xff) - 127 + 15;
+    uint32_t mantissa = bits & 0x7fffff;
+
+    if (((bits >> 23) & 0xff) == 0xff) {
+        // Infinity or NaN
+        return sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0);
+    }
+    if (exponent >= 0x1f) {
+        return sign | 0x7c00;
+    }
+    if (exponent <= 0) {
+        if (exponent < -10) {
+            return sign;
+        }
+        // Subnormal half
+        mantissa |= 0x800000;
+        uint32_t shift = (uint32_t)(14 - exponent);
+        uint16_t result = (uint16_t)(mantissa >> shift);
+        // Round to nearest even
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (result & 1))) {
+            ++result;
+        }
+        return sign | result;
+    }
+
+    uint16_t result = (uint16_t)((exponent << 10) | (mantissa >> 13));
+    // Round to nearest even, a carry into the exponent is the correct result
+    uint32_t remainder = mantissa & 0x1fff;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (result & 1))) {
+        ++result;
+    }
+    return sign | result;
+}
+
+// // Component conversion
+
+/**
+ * Read the k-th component of an element as a double. Normalized types are mapped to [0, 1].
+ */
+static double readComponent(AttributeType type, const char* element, int k)
+{
+    switch (type) {
+    case AttributeType::UByte:
+        return (double)((const unsigned char*)element)[k];
+    case AttributeType::Int:
+        return (double)((const int*)element)[k];
+    case AttributeType::Float:
+        return (double)((const float*)element)[k];
+    case AttributeType::Int8:
+        return (double)((const int8_t*)element)[k];
+    case AttributeType::Int16:
+        return (double)((const int16_t*)element)[k];
+    case AttributeType::Half:
+        return (double)halfToFloat(((const uint16_t*)element)[k]);
+    case AttributeType::UByteNormalized:
+        return (double)((const unsigned char*)element)[k] / 255.0;
+    default:
+        return 0.0;
+    }
+}
+
+template <typename T>
+static T roundAndClamp(double value)
+{
+    if (std::isnan(value)) {
+        return (T)0;
+    }
+    value = std::round(value);
+    value = std::max(value, (double)std::numeric_limits<T>::min());
+    value = std::min(value, (double)std::numeric_limits<T>::max());
+    return (T)value;
+}
+
+/**
+ * Write the k-th component of an element from a double, rounding and clamping it to the
+ * range of the destination type.
+ */
+static void writeComponent(AttributeType type, char* element, int k, double value)
+{
+    switch (type) {
+    case AttributeType::UByte:
+        ((unsigned char*)element)[k] = roundAndClamp<unsigned char>(value);
+        break;
+    case AttributeType::Int:
+        ((int*)element)[k] = roundAndClamp<int>(value);
+        break;
+    case AttributeType::Float:
+        ((float*)element)[k] = (float)value;
+        break;
+    case AttributeType::Int8:
+        ((int8_t*)element)[k] = roundAndClamp<int8_t>(value);
+        break;
+    case AttributeType::Int16:
+        ((int16_t*)element)[k] = roundAndClamp<int16_t>(value);
+        break;
+    case AttributeType::Half:
+        ((uint16_t*)element)[k] = floatToHalf((float)value);
+        break;
+    case AttributeType::UByteNormalized:
+        ((unsigned char*)element)[k] = roundAndClamp<unsigned char>(value * 255.0);
+        break;
+    default:
+        break;
+    }
+}
+
+static bool isFloatingPoint(AttributeType type)
+{
+    return type == AttributeType::Float || type == AttributeType::Half;
+}
+
+OfxStatus copyAttributeComponents(AttributeType destinationType,
+                                  char* destinationData,
+                                  int destinationStride,
+                                  AttributeType sourceType,
+                                  const char* sourceData,
+                                  int sourceStride,
+                                  int componentCount,
+                                  int start,
+                                  int count)
+{
+    if (sourceType == AttributeType::Unknown || destinationType == AttributeType::Unknown) {
+        return kOfxStatErrUnsupported;
+    }
+
+    if (sourceType == destinationType)
+    {
+        size_t componentByteSize = (size_t)byteSizeOf(sourceType);
+        for (int i = 0; i < count; ++i) {
+            const char* src = &sourceData[(size_t)(start + i) * sourceStride];
+            char* dst = &destinationData[(size_t)(start + i) * destinationStride];
+            memcpy(dst, src, componentCount * componentByteSize);
+        }
+        return kOfxStatOK;
+    }
+
+    // Conversions between plain bytes and floating point numbers have always
+    // been normalized, in both directions
+    if (sourceType == AttributeType::UByte && isFloatingPoint(destinationType)) {
+        sourceType = AttributeType::UByteNormalized;
+    }
+    if (destinationType == AttributeType::UByte && isFloatingPoint(sourceType)) {
+        destinationType = AttributeType::UByteNormalized;
+    }
+
+    // Plain bytes and normalized bytes share the same storage
+    bool isRawByteCopy =
+        (sourceType == AttributeType::UByte && destinationType == AttributeType::UByteNormalized) ||
+        (sourceType == AttributeType::UByteNormalized && destinationType == AttributeType::UByte);
+
+    for (int i = 0; i < count; ++i) {
+        const char* src = &sourceData[(size_t)(start + i) * sourceStride];
+        char* dst = &destinationData[(size_t)(start + i) * destinationStride];
+        for (int k = 0; k < componentCount; ++k)
+        {
+            if (isRawByteCopy) {
+                dst[k] = src[k];
+                continue;
+            }
+            writeComponent(destinationType, dst, k, readComponent(sourceType, src, k));
+        }
+    }
+    return kOfxStatOK;
+}
+
+} // namespace OpenMfx
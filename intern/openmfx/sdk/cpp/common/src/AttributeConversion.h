@@ -0,0 +1,68 @@
+/*
+ * Copyright 2019-2022 Elie Michel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <ofxCore.h>
+
+#include <cstdint>
+
+// Attribute component types and conversions, shared by the Host SDK and the
+// Plugin SDK so that both sides convert attribute data the same way.
+
+namespace OpenMfx {
+
+enum class AttributeType {
+    Unknown = -1,
+    UByte, // kOfxMeshAttribTypeUByte
+    Int,   // kOfxMeshAttribTypeInt
+    Float, // kOfxMeshAttribTypeFloat
+    Int8,  // kOfxMeshAttribTypeInt8
+    Int16, // kOfxMeshAttribTypeInt16
+    Half,  // kOfxMeshAttribTypeHalf
+    UByteNormalized, // kOfxMeshAttribTypeUByteNormalized
+};
+
+/**
+ * Return the size in bytes of one component of a type, or 0 if the type is unknown
+ */
+int byteSizeOf(AttributeType type);
+
+/**
+ * Convert between 16 bit (half precision) and 32 bit floating point numbers.
+ * Out of range values are rounded to infinity.
+ */
+float halfToFloat(uint16_t half);
+uint16_t floatToHalf(float value);
+
+/**
+ * Copy the first componentCount components of elements start to start + count
+ * from one attribute buffer to another, converting them between types.
+ * Integer destinations are rounded and clamped to their range. Plain bytes
+ * are normalized to [0, 1] when converted to or from floating point types.
+ * Return kOfxStatErrUnsupported if one of the types is unknown.
+ */
+OfxStatus copyAttributeComponents(AttributeType destinationType,
+                                  char* destinationData,
+                                  int destinationStride,
+                                  AttributeType sourceType,
+                                  const char* sourceData,
+                                  int sourceStride,
+                                  int componentCount,
+                                  int start,
+                                  int count);
+
+} // namespace OpenMfx
@@ -35,6 +35,18 @@ AttributeType attributeTypeAsEnum(const char* mfxType)
     if (0 == strcmp(mfxType, kOfxMeshAttribTypeFloat)) {
         return AttributeType::Float;
     }
+    if (0 == strcmp(mfxType, kOfxMeshAttribTypeInt8)) {
+        return AttributeType::Int8;
+    }
+    if (0 == strcmp(mfxType, kOfxMeshAttribTypeInt16)) {
+        return AttributeType::Int16;
+    }
+    if (0 == strcmp(mfxType, kOfxMeshAttribTypeHalf)) {
+        return AttributeType::Half;
+    }
+    if (0 == strcmp(mfxType, kOfxMeshAttribTypeUByteNormalized)) {
+        return AttributeType::UByteNormalized;
+    }
     WARN_LOG << "Unknown attribute type: " << mfxType;
     return AttributeType::Unknown;
 }
@@ -47,6 +59,14 @@ const char* attributeTypeAsString(AttributeType type) {
         return kOfxMeshAttribTypeInt;
     case AttributeType::Float:
         return kOfxMeshAttribTypeFloat;
+    case AttributeType::Int8:
+        return kOfxMeshAttribTypeInt8;
+    case AttributeType::Int16:
+        return kOfxMeshAttribTypeInt16;
+    case AttributeType::Half:
+        return kOfxMeshAttribTypeHalf;
+    case AttributeType::UByteNormalized:
+        return kOfxMeshAttribTypeUByteNormalized;
     case AttributeType::Unknown:
     default:
         WARN_LOG << "Unknown attribute type: " << (int)type;
@@ -54,22 +74,6 @@ const char* attributeTypeAsString(AttributeType type) {
     }
 }
 
-int byteSizeOf(AttributeType type) {
-    switch (type)
-    {
-    case AttributeType::UByte:
-        return sizeof(unsigned char);
-    case AttributeType::Int:
-        return sizeof(int);
-    case AttributeType::Float:
-        return sizeof(float);
-    case AttributeType::Unknown:
-    default:
-        ERR_LOG << "Unknown type";
-        return 0;
-    }
-}
-
 AttributeAttachment attributeAttachmentAsEnum(const char* mfxAttachment) {
     if (0 == strcmp(mfxAttachment, kOfxMeshAttribPoint)) {
         return AttributeAttachment::Point;
@@ -19,18 +19,13 @@
 #include <ofxProperty.h>
 #include <ofxMeshEffect.h>
 
+#include <OpenMfx/Sdk/Cpp/AttributeConversion>
+
 // This file is close to MfxAttributeEnums but the Plugin SDK and the Host SDK
 // follow different naming conventions (maybe this should change)
 
 namespace OpenMfx {
 
-enum class AttributeType {
-    Unknown = -1,
-    UByte, // kOfxMeshAttribTypeUByte
-    Int,   // kOfxMeshAttribTypeInt
-    Float, // kOfxMeshAttribTypeFloat
-};
-
 enum class AttributeAttachment {
     Invalid = -1,
     Point,  // kOfxMeshAttribPoint
@@ -57,11 +52,6 @@ AttributeType attributeTypeAsEnum(const char* mfxType);
  */
 const char* attributeTypeAsString(AttributeType type);
 
-/**
- * Return the size in bytes of a type
- */
-int byteSizeOf(AttributeType type);
-
 /**
  * Convert an attachment string from MeshEffect API to its local enum counterpart
  */
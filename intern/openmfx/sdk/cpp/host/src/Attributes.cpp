@@ -142,36 +142,13 @@ bool OfxAttributeStruct::copy_data_from(const OfxAttributeStruct& source, int st
     // TODO: use at least OpenMP
     int componentCount = std::min(sourceComponentCount, destinationComponentCount);
 
-    if (sourceType == destinationType)
-    {
-        size_t componentByteSize = byteSizeOf(sourceType);
-        if (componentByteSize == 0) return false;
-
-        for (int i = 0; i < count; ++i) {
-            const void* src = (void*)&sourceData[(start + i) * sourceStride];
-            void* dst = (void*)&destinationData[(start + i) * destinationStride];
-            memcpy(dst, src, componentCount * componentByteSize);
-        }
-        return true;
+    OfxStatus status = copyAttributeComponents(
+        destinationType, destinationData, destinationStride,
+        sourceType, sourceData, sourceStride,
+        componentCount, start, count);
+    if (kOfxStatOK != status) {
+        WARN_LOG << "unsupported input/output type combinason in copyAttribute: " << (int)sourceType << " -> " << (int)destinationType;
+        return false;
     }
-
-    switch (destinationType) {
-    case AttributeType::Float:
-        switch (sourceType) {
-        case AttributeType::UByte:
-            for (int i = 0; i < count; ++i) {
-                const unsigned char* src = (unsigned char*)&sourceData[(start + i) * sourceStride];
-                float* dst = (float*)&destinationData[(start + i) * destinationStride];
-                for (int k = 0; k < componentCount; ++k)
-                {
-                    dst[k] = (float)src[k] / 255.0f;
-                }
-            }
-            return true;
-            break;
-        }
-        break;
-    }
-    WARN_LOG << "unsupported input/output type combinason in copyAttribute: " << (int)sourceType << " -> " << (int)destinationType;
-    return false;
+    return true;
 }
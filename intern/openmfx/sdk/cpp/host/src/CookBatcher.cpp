@@ -0,0 +1,61 @@
+/*
+ * Copyright 2019-2022 Elie Michel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CookBatcher.h"
+
+namespace OpenMfx {
+
+void CookBatcher::cook(const std::string &key, void *item, const CookFunction &cookItems)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  Group &group = m_groups[key];
+  ++group.users;
+
+  Ticket ticket = {item, false};
+  group.pending.push_back(&ticket);
+
+  while (!ticket.done) {
+    if (group.cooking) {
+      group.cookDone.wait(lock);
+      continue;
+    }
+
+    // Nobody is cooking this key, take everything submitted so far
+    std::vector<Ticket *> batch;
+    batch.swap(group.pending);
+    group.cooking = true;
+    lock.unlock();
+
+    std::vector<void *> items(batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+      items[i] = batch[i]->item;
+    }
+    cookItems(items.data(), static_cast<int>(items.size()));
+
+    lock.lock();
+    for (Ticket *t : batch) {
+      t->done = true;
+    }
+    group.cooking = false;
+    group.cookDone.notify_all();
+  }
+
+  if (--group.users == 0) {
+    m_groups.erase(key);
+  }
+}
+
+}  // namespace OpenMfx
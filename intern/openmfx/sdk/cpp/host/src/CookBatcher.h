@@ -0,0 +1,77 @@
+/*
+ * Copyright 2019-2022 Elie Michel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace OpenMfx {
+
+/**
+ * Groups the cooks that several threads of a host request at the same time,
+ * so that they can go to the effect in a single batch (see Host::CookBatch()).
+ * This is meant for hosts that evaluate their nodes in parallel, e.g. the
+ * same effect applied to many objects of a scene: items submitted with the
+ * same key (typically the effect and its parameter values) while a batch of
+ * that key is cooking are cooked together in the next batch.
+ *
+ * No thread ever waits for items to be submitted: the first item of a key is
+ * cooked right away, possibly alone, so a host whose evaluation order makes
+ * some node wait for another one cannot dead-lock on the batcher.
+ */
+class CookBatcher {
+ public:
+  /**
+   * Cook the given items at once. Called without any lock held, by one of
+   * the threads that submitted the items, and must not throw.
+   */
+  using CookFunction = std::function<void(void **items, int count)>;
+
+  CookBatcher() = default;
+  CookBatcher(const CookBatcher &) = delete;
+  CookBatcher &operator=(const CookBatcher &) = delete;
+
+  /**
+   * Cook the item, together with the items of the same key submitted by
+   * other threads meanwhile. Returns once the item has been cooked, either by
+   * this thread or by another one, with the cook function of whichever thread
+   * cooked it.
+   */
+  void cook(const std::string &key, void *item, const CookFunction &cookItems);
+
+ private:
+  struct Ticket {
+    void *item;
+    bool done;
+  };
+
+  struct Group {
+    std::vector<Ticket *> pending;
+    bool cooking = false;
+    int users = 0;
+    std::condition_variable cookDone;
+  };
+
+  std::mutex m_mutex;
+  std::map<std::string, Group> m_groups;
+};
+
+}  // namespace OpenMfx
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2019-2022 Elie Michel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "EffectInstancePool.h"
+#include "Host.h"
+#include "MeshEffect.h"
+
+#include <OpenMfx/Sdk/Cpp/Common>
+
+#include <cassert>
+
+namespace OpenMfx {
+
+EffectInstancePool::EffectInstancePool(Host *host, OfxMeshEffectHandle effectDescriptor)
+    : m_host(host), m_descriptor(effectDescriptor), m_sharedInstance(nullptr)
+{
+}
+
+EffectInstancePool::~EffectInstancePool()
+{
+  assert(m_idleInstances.size() == m_instances.size()); // some instances were not released
+  for (OfxMeshEffectHandle instance : m_instances) {
+    if (nullptr != m_sharedInstance) {
+      m_host->ReleaseSharedInstance(instance);
+    }
+    else {
+      m_host->DestroyInstance(instance);
+    }
+  }
+  if (nullptr != m_sharedInstance) {
+    m_host->DestroyInstance(m_sharedInstance);
+  }
+}
+
+OfxMeshEffectHandle EffectInstancePool::acquire()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_idleInstances.empty()) {
+      OfxMeshEffectHandle instance = m_idleInstances.back();
+      m_idleInstances.pop_back();
+      return instance;
+    }
+    if (nullptr != m_sharedInstance) {
+      // Sharing does not call the plug-in, no need to release the lock
+      OfxMeshEffectHandle instance = m_host->ShareInstance(m_sharedInstance);
+      m_instances.push_back(instance);
+      return instance;
+    }
+  }
+
+  // Create the instance outside of the lock, this calls the plug-in
+  OfxMeshEffectHandle instance = nullptr;
+  if (!m_host->CreateInstance(m_descriptor, instance)) {
+    return nullptr;
+  }
+  LOG << "Created instance #" << instanceCount() + 1 << " of effect " << m_descriptor->plugin->pluginIdentifier;
+
+  if (!m_host->IsFullySafe(instance)) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_instances.push_back(instance);
+    return instance;
+  }
+
+  // Fully safe effects keep this instance aside and cook on handles of it
+  OfxMeshEffectHandle redundantInstance = nullptr;
+  OfxMeshEffectHandle sharedHandle = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (nullptr == m_sharedInstance) {
+      m_sharedInstance = instance;
+    }
+    else {
+      // Another thread created it meanwhile
+      redundantInstance = instance;
+    }
+    sharedHandle = m_host->ShareInstance(m_sharedInstance);
+    m_instances.push_back(sharedHandle);
+  }
+  if (nullptr != redundantInstance) {
+    m_host->DestroyInstance(redundantInstance);
+  }
+  return sharedHandle;
+}
+
+void EffectInstancePool::release(OfxMeshEffectHandle effectInstance)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_idleInstances.push_back(effectInstance);
+}
+
+int EffectInstancePool::instanceCount() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return static_cast<int>(m_instances.size());
+}
+
+}  // namespace OpenMfx
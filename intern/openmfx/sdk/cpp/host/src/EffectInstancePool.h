@@ -0,0 +1,98 @@
+/*
+ * Copyright 2019-2022 Elie Michel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <ofxMeshEffect.h>
+
+#include <mutex>
+#include <vector>
+
+namespace OpenMfx {
+
+class Host;
+
+/**
+ * A pool of instances of the same effect descriptor, for hosts that may cook
+ * the same node in several contexts at once (e.g. a node group used several
+ * times). Since inputs and parameters are stored in the instance, each
+ * concurrent cook needs its own instance: acquire() hands out an idle one and
+ * only creates a new instance when all of them are busy.
+ *
+ * This does not replace the thread safety declared by the effect: cooks of
+ * kOfxMeshEffectThreadSafetyUnsafe effects are still serialized by Host::Cook().
+ * Effects that declare kOfxMeshEffectThreadSafetyFullySafe get a single
+ * instance, and concurrent cooks run on shared handles of it (see
+ * Host::ShareInstance()) rather than on new instances.
+ */
+class EffectInstancePool {
+ public:
+  /**
+   * The descriptor must remain valid for the lifetime of the pool.
+   */
+  EffectInstancePool(Host *host, OfxMeshEffectHandle effectDescriptor);
+  ~EffectInstancePool();
+  EffectInstancePool(const EffectInstancePool &) = delete;
+  EffectInstancePool &operator=(const EffectInstancePool &) = delete;
+
+  /**
+   * Get an instance that no other thread is using, or nullptr if a new
+   * instance was needed and could not be created. Each acquired instance must
+   * be given back with release().
+   */
+  OfxMeshEffectHandle acquire();
+  void release(OfxMeshEffectHandle effectInstance);
+
+  /**
+   * Total number of handles created by the pool, busy or not
+   */
+  int instanceCount() const;
+
+  OfxMeshEffectHandle descriptor() const { return m_descriptor; }
+
+  /**
+   * Scoped acquisition of an instance
+   */
+  class Lease {
+   public:
+    Lease(EffectInstancePool &pool) : m_pool(pool), m_instance(pool.acquire()) {}
+    ~Lease() { if (nullptr != m_instance) m_pool.release(m_instance); }
+    Lease(const Lease &) = delete;
+    Lease &operator=(const Lease &) = delete;
+
+    OfxMeshEffectHandle get() const { return m_instance; }
+
+   private:
+    EffectInstancePool &m_pool;
+    OfxMeshEffectHandle m_instance;
+  };
+
+ private:
+  Host *m_host;
+  OfxMeshEffectHandle m_descriptor;
+
+  mutable std::mutex m_mutex;
+  std::vector<OfxMeshEffectHandle> m_instances;
+  std::vector<OfxMeshEffectHandle> m_idleInstances;
+
+  /**
+   * The only actual instance of a fully thread safe effect, never cooked
+   * itself so that it can be shared at any time. Null for other effects.
+   */
+  OfxMeshEffectHandle m_sharedInstance;
+};
+
+}  // namespace OpenMfx
@@ -29,9 +29,14 @@
 #include <OpenMfx/Sdk/Cpp/Common>
 
 #include <cstring>
+#include <mutex>
+#include <utility>
 
 using namespace OpenMfx;
 
+// Serializes the cooks of all effects that declared kOfxMeshEffectThreadSafetyUnsafe
+static std::mutex s_unsafeCookMutex;
+
 // ----------------------------------------------------
 // Static constructor
 
@@ -241,6 +246,22 @@ void Host::DestroyInstance(OfxMeshEffectHandle effectInstance) {
 	delete effectInstance;
 }
 
+OfxMeshEffectHandle Host::ShareInstance(OfxMeshEffectHandle effectInstance) {
+	OfxMeshEffectHandle sharedInstance = new OfxMeshEffectStruct(effectInstance->host, effectInstance->plugin);
+	sharedInstance->deep_copy_from(*effectInstance);
+
+	for (int i = 0; i < sharedInstance->inputs.count(); ++i) {
+		InitInput(sharedInstance->inputs[i]);
+	}
+
+	return sharedInstance;
+}
+
+void Host::ReleaseSharedInstance(OfxMeshEffectHandle sharedInstance) {
+	// No kOfxActionDestroyInstance, the plugin never saw this handle get created
+	delete sharedInstance;
+}
+
 bool Host::IsIdentity(OfxMeshEffectHandle effectInstance, bool* isIdentity, char** inputToPassThrough) {
 	OfxStatus status;
 	OfxPlugin* plugin = effectInstance->plugin;
@@ -286,6 +307,11 @@ bool Host::Cook(OfxMeshEffectHandle effectInstance) {
 	OfxStatus status;
 	OfxPlugin* plugin = effectInstance->plugin;
 
+	std::unique_lock<std::mutex> lock(s_unsafeCookMutex, std::defer_lock);
+	if (IsThreadUnsafe(effectInstance)) {
+		lock.lock();
+	}
+
 	status = plugin->mainEntry(kOfxMeshEffectActionCook, effectInstance, NULL, NULL);
 	LOG << kOfxMeshEffectActionCook << " action returned status " << status << "(" << ofxStatusName(status) << ")";
 
@@ -306,6 +332,91 @@ bool Host::Cook(OfxMeshEffectHandle effectInstance) {
 	return true;
 }
 
+void Host::PrepareBatch(OfxMeshEffectHandle effectInstance, int batchSize) {
+	for (int i = 0; i < effectInstance->inputs.count(); ++i) {
+		OfxMeshInputStruct& input = effectInstance->inputs[i];
+		input.batch_meshes.clear();
+		input.batch_meshes.resize(batchSize);
+	}
+}
+
+bool Host::SupportsBatch(OfxMeshEffectHandle effectInstance) const {
+	const OfxPropertySetStruct& props = effectInstance->properties;
+	int i = props.find(kOfxMeshEffectPropSupportsBatch);
+	return i > -1 && props[i].value[0].as_int != 0;
+}
+
+bool Host::IsThreadUnsafe(OfxMeshEffectHandle effectInstance) const {
+	return HasThreadSafety(effectInstance, kOfxMeshEffectThreadSafetyUnsafe);
+}
+
+bool Host::IsFullySafe(OfxMeshEffectHandle effect) const {
+	return HasThreadSafety(effect, kOfxMeshEffectThreadSafetyFullySafe);
+}
+
+bool Host::CookBatch(OfxMeshEffectHandle effectInstance) {
+	OfxStatus status = kOfxStatReplyDefault;
+	OfxPlugin* plugin = effectInstance->plugin;
+	int batchSize = 0;
+	if (effectInstance->inputs.count() > 0) {
+		batchSize = static_cast<int>(effectInstance->inputs[0].batch_meshes.size());
+	}
+
+	if (SupportsBatch(effectInstance)) {
+		OfxPropertySetStruct inArgs(PropertySetContext::ActionCookBatchIn);
+		propertySuite->propSetInt(&inArgs, kOfxPropTime, 0, 0);
+		propertySuite->propSetInt(&inArgs, kOfxMeshEffectPropBatchSize, 0, batchSize);
+
+		std::unique_lock<std::mutex> lock(s_unsafeCookMutex, std::defer_lock);
+		if (IsThreadUnsafe(effectInstance)) {
+			lock.lock();
+		}
+
+		status = plugin->mainEntry(kOfxMeshEffectActionCookBatch, effectInstance, &inArgs, NULL);
+		LOG << kOfxMeshEffectActionCookBatch << " action returned status " << status << "(" << ofxStatusName(status) << ")";
+	}
+
+	bool success = true;
+	if (kOfxStatReplyDefault == status) {
+		// Cook items one by one, each time in place of the regular meshes of the inputs
+		for (int b = 0; b < batchSize; ++b) {
+			for (int i = 0; i < effectInstance->inputs.count(); ++i) {
+				OfxMeshInputStruct& input = effectInstance->inputs[i];
+				std::swap(input.mesh, input.batch_meshes[b]);
+			}
+			success = Cook(effectInstance) && success;
+			for (int i = 0; i < effectInstance->inputs.count(); ++i) {
+				OfxMeshInputStruct& input = effectInstance->inputs[i];
+				std::swap(input.mesh, input.batch_meshes[b]);
+			}
+		}
+	}
+	else {
+		switch (status) {
+		case kOfxStatErrMemory:
+			ERR_LOG << "Not enough memory for cooking a batch with plug-in '" << plugin->pluginIdentifier << "'";
+			success = false;
+			break;
+
+		case kOfxStatFailed:
+			ERR_LOG << "Error while cooking a batch with plug-in '" << plugin->pluginIdentifier << "'";
+			success = false;
+			break;
+
+		case kOfxStatErrFatal:
+			ERR_LOG << "Fatal error while cooking a batch with plug-in '" << plugin->pluginIdentifier << "'";
+			success = false;
+			break;
+		}
+	}
+
+	for (int i = 0; i < effectInstance->inputs.count(); ++i) {
+		effectInstance->inputs[i].batch_meshes.clear();
+	}
+
+	return success;
+}
+
 // ----------------------------------------------------
 // Static callbacks
 
@@ -385,3 +496,11 @@ const void* Host::FetchSuite(OfxPropertySetHandle host, const char* suiteName, i
 	ERR_LOG << "Suite '" << suiteName << "' is not supported by this host.";
 	return NULL;
 }
+
+bool Host::HasThreadSafety(OfxMeshEffectHandle effect, const char* threadSafety)
+{
+	const OfxPropertySetStruct& props = effect->properties;
+	int i = props.find(kOfxMeshEffectPropThreadSafety);
+	return i > -1 && nullptr != props[i].value[0].as_const_char &&
+		0 == strcmp(props[i].value[0].as_const_char, threadSafety);
+}
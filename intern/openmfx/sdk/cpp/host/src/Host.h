@@ -65,6 +65,18 @@ public: // Utility wrappers around plugin->mainEntry
 	bool CreateInstance(OfxMeshEffectHandle effectDescriptor, OfxMeshEffectHandle& effectInstance);
 	void DestroyInstance(OfxMeshEffectHandle effectInstance);
 
+	/**
+	 * Get another handle onto an instance of a fully thread safe effect, so
+	 * that it can be cooked concurrently with itself. The plugin is not asked
+	 * to create a new instance: the handle shares the properties of the
+	 * instance, including kOfxPropInstanceData, but has its own inputs and
+	 * parameter values for the host to bind a different cook to. The instance
+	 * must not be in use while being shared, and the shared handles must be
+	 * released with ReleaseSharedInstance() before it gets destroyed.
+	 */
+	OfxMeshEffectHandle ShareInstance(OfxMeshEffectHandle effectInstance);
+	void ReleaseSharedInstance(OfxMeshEffectHandle sharedInstance);
+
 	/**
 	 * Cooking and querying whether the instance has an effect produces different
 	 * results depending on the value that has been assigned to the effect's
@@ -75,6 +87,40 @@ public: // Utility wrappers around plugin->mainEntry
 	bool IsIdentity(OfxMeshEffectHandle effectInstance, bool* isIdentity, char** inputToPassThrough);
 	bool Cook(OfxMeshEffectHandle effectInstance);
 
+	/**
+	 * Allocate one mesh per item of a batch in each input of the instance, in
+	 * the batch_meshes member of the inputs, so that the caller can attach its
+	 * kOfxMeshPropInternalData to each of them before calling CookBatch().
+	 */
+	void PrepareBatch(OfxMeshEffectHandle effectInstance, int batchSize);
+
+	/**
+	 * Cook all items prepared with PrepareBatch(). Effects that declare
+	 * kOfxMeshEffectPropSupportsBatch get them in a single call to the
+	 * kOfxMeshEffectActionCookBatch action, the others are cooked once per
+	 * item with the regular cook action. Batch meshes are released afterwards.
+	 */
+	bool CookBatch(OfxMeshEffectHandle effectInstance);
+
+	/**
+	 * Tell whether the effect cooks batches natively.
+	 */
+	bool SupportsBatch(OfxMeshEffectHandle effectInstance) const;
+
+	/**
+	 * Tell whether the effect declared kOfxMeshEffectThreadSafetyUnsafe, in
+	 * which case Cook() and CookBatch() hold a lock shared by all unsafe
+	 * effects. Hosts that run cooks from within a thread pool should make sure
+	 * that a thread waiting for this lock cannot pick up another cook.
+	 */
+	bool IsThreadUnsafe(OfxMeshEffectHandle effectInstance) const;
+
+	/**
+	 * Tell whether the effect declared kOfxMeshEffectThreadSafetyFullySafe,
+	 * in which case a single instance may cook concurrently with itself.
+	 */
+	bool IsFullySafe(OfxMeshEffectHandle effect) const;
+
 protected:
 	/**
 	 * Callback responsible for converting from and back to host's internal
@@ -112,6 +158,11 @@ private:
 
 	static const void * FetchSuite(OfxPropertySetHandle host, const char* suiteName, int suiteVersion);
 
+	/**
+	 * Tell whether kOfxMeshEffectPropThreadSafety of the effect has the given value
+	 */
+	static bool HasThreadSafety(OfxMeshEffectHandle effect, const char* threadSafety);
+
 public:
 	const OfxPropertySuiteV1* propertySuite;
 	const OfxParameterSuiteV1* parameterSuite;
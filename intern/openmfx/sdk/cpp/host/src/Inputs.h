@@ -23,6 +23,7 @@
 #include <ofxCore.h>
 
 #include <string>
+#include <vector>
 
 struct OfxMeshInputStruct {
  public:
@@ -58,6 +59,8 @@ struct OfxMeshInputStruct {
   OfxAttributeSetStruct
       requested_attributes;  // not technically attributes, e.g. data info are not used
   OfxMeshStruct mesh;
+  // One mesh per item while cooking a batch, see OpenMfx::Host::CookBatch(), not deep copied
+  std::vector<OfxMeshStruct> batch_meshes;
   OfxHost *host;  // weak pointer, do not deep copy
 
  private:
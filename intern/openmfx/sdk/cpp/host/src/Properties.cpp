@@ -52,12 +52,16 @@ bool OfxPropertySetStruct::check_property_context(PropertySetContext context, Pr
     case PropertySetContext::MeshEffect:
         return (
             (0 == strcmp(property, kOfxMeshEffectPropContext) && type == PropertyType::String) ||
+            (0 == strcmp(property, kOfxMeshEffectPropSupportsBatch) && type == PropertyType::Int) ||
+            (0 == strcmp(property, kOfxMeshEffectPropThreadSafety) && type == PropertyType::String) ||
+            (0 == strcmp(property, kOfxPropInstanceData) && type == PropertyType::Pointer) ||
             false
             );
     case PropertySetContext::Input:
         return (
             (0 == strcmp(property, kOfxPropLabel) && type == PropertyType::String) ||
             (0 == strcmp(property, kOfxInputPropRequestIOMap) && type == PropertyType::Int) ||
+            (0 == strcmp(property, kOfxInputPropRequestChunkSize) && type == PropertyType::Int) ||
             false
             );
     case PropertySetContext::Host:
@@ -82,6 +86,9 @@ bool OfxPropertySetStruct::check_property_context(PropertySetContext context, Pr
             (0 == strcmp(property, kOfxMeshPropAttributeCount) && type == PropertyType::Int) ||
             (0 == strcmp(property, kOfxMeshPropTransformMatrix) && type == PropertyType::Pointer) ||
             (0 == strcmp(property, kOfxMeshPropIOMap) && type == PropertyType::Pointer) ||
+            (0 == strcmp(property, kOfxMeshPropChunkIndex) && type == PropertyType::Int) ||
+            (0 == strcmp(property, kOfxMeshPropChunkCount) && type == PropertyType::Int) ||
+            (0 == strcmp(property, kOfxMeshPropChunkSize) && type == PropertyType::Int) ||
             false
             );
     case PropertySetContext::Param:
@@ -122,6 +129,11 @@ bool OfxPropertySetStruct::check_property_context(PropertySetContext context, Pr
             (0 == strcmp(property, kOfxPropName) && type == PropertyType::String) ||
             (0 == strcmp(property, kOfxPropTime) && type == PropertyType::Int) ||
             false);
+    case PropertySetContext::ActionCookBatchIn:
+        return (
+            (0 == strcmp(property, kOfxPropTime) && type == PropertyType::Int) ||
+            (0 == strcmp(property, kOfxMeshEffectPropBatchSize) && type == PropertyType::Int) ||
+            false);
     case PropertySetContext::Other:
     default:
         printf("Warning: PROP_CTX_OTHER is depreciated.\n");
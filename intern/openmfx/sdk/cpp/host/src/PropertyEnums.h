@@ -34,6 +34,7 @@ enum class PropertySetContext {
   Attrib,
   ActionIdentityIn,
   ActionIdentityOut,
+  ActionCookBatchIn,
   Other,
   // kOfxTypeParameterInstance
 };
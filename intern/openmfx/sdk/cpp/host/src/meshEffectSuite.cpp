@@ -63,7 +63,9 @@ const OfxMeshEffectSuiteV1 gMeshEffectSuiteV1 = {
     /* meshGetAttribute */ meshGetAttribute,
     /* meshGetPropertySet */ meshGetPropertySet,
     /* meshAlloc */ meshAlloc,
-    /* abort */ ofxAbort};
+    /* abort */ ofxAbort,
+    /* inputGetMeshChunk */ inputGetMeshChunk,
+    /* inputGetBatchMesh */ inputGetBatchMesh};
 
 OfxStatus getPropertySet(OfxMeshEffectHandle meshEffect, OfxPropertySetHandle *propHandle)
 {
@@ -129,8 +131,7 @@ OfxStatus inputRequestAttribute(OfxMeshInputHandle input,
   if (componentCount < 1 || componentCount > 4) {
     return kOfxStatErrValue;
   }
-  if (0 != strcmp(type, kOfxMeshAttribTypeInt) && 0 != strcmp(type, kOfxMeshAttribTypeFloat) &&
-      0 != strcmp(type, kOfxMeshAttribTypeUByte)) {
+  if (AttributeType::Unknown == attributeTypeAsEnum(type)) {
     return kOfxStatErrValue;
   }
 
@@ -159,20 +160,32 @@ OfxStatus inputRequestAttribute(OfxMeshInputHandle input,
   return kOfxStatOK;
 }
 
-OfxStatus inputGetMesh(OfxMeshInputHandle input,
-                       OfxTime time,
-                       OfxMeshHandle *meshHandle,
-                       OfxPropertySetHandle *propertySet)
+/**
+ * Common implementation of inputGetMesh, inputGetMeshChunk and inputGetBatchMesh, chunkIndex
+ * being -1 when not fetching a chunk.
+ */
+static OfxStatus getMeshOrChunk(OfxMeshInputHandle input,
+                                OfxMeshHandle inputMeshHandle,
+                                int chunkIndex,
+                                OfxMeshHandle *meshHandle,
+                                OfxPropertySetHandle *propertySet)
 {
-  (void)time;
-  OfxMeshHandle inputMeshHandle = &input->mesh;
-  OfxPropertySetHandle inputMeshProperties = &input->mesh.properties;
+  OfxPropertySetHandle inputMeshProperties = &inputMeshHandle->properties;
   propSetPointer(inputMeshProperties, kOfxMeshPropHostHandle, 0, (void *)input->host);
   propSetInt(inputMeshProperties, kOfxMeshPropPointCount, 0, 0);
   propSetInt(inputMeshProperties, kOfxMeshPropCornerCount, 0, 0);
   propSetInt(inputMeshProperties, kOfxMeshPropFaceCount, 0, 0);
   propSetInt(inputMeshProperties, kOfxMeshPropAttributeCount, 0, 0);
 
+  // Chunking info, forwarded from the input to the host callbacks
+  int chunkSize = 0;
+  if (input->properties.find(kOfxInputPropRequestChunkSize) >= 0) {
+    propGetInt(&input->properties, kOfxInputPropRequestChunkSize, 0, &chunkSize);
+  }
+  propSetInt(inputMeshProperties, kOfxMeshPropChunkIndex, 0, chunkIndex);
+  propSetInt(inputMeshProperties, kOfxMeshPropChunkSize, 0, chunkSize);
+  propSetInt(inputMeshProperties, kOfxMeshPropChunkCount, 0, chunkIndex >= 0 ? 0 : 1);
+
   // Default attributes
   inputMeshHandle->attributes.clear();
 
@@ -220,6 +233,41 @@ OfxStatus inputGetMesh(OfxMeshInputHandle input,
   return kOfxStatOK;
 }
 
+OfxStatus inputGetMesh(OfxMeshInputHandle input,
+                       OfxTime time,
+                       OfxMeshHandle *meshHandle,
+                       OfxPropertySetHandle *propertySet)
+{
+  (void)time;
+  return getMeshOrChunk(input, &input->mesh, -1, meshHandle, propertySet);
+}
+
+OfxStatus inputGetMeshChunk(OfxMeshInputHandle input,
+                            OfxTime time,
+                            int chunkIndex,
+                            OfxMeshHandle *meshHandle,
+                            OfxPropertySetHandle *propertySet)
+{
+  (void)time;
+  if (chunkIndex < 0) {
+    return kOfxStatErrBadIndex;
+  }
+  return getMeshOrChunk(input, &input->mesh, chunkIndex, meshHandle, propertySet);
+}
+
+OfxStatus inputGetBatchMesh(OfxMeshInputHandle input,
+                            OfxTime time,
+                            int batchIndex,
+                            OfxMeshHandle *meshHandle,
+                            OfxPropertySetHandle *propertySet)
+{
+  (void)time;
+  if (batchIndex < 0 || batchIndex >= static_cast<int>(input->batch_meshes.size())) {
+    return kOfxStatErrBadIndex;
+  }
+  return getMeshOrChunk(input, &input->batch_meshes[batchIndex], -1, meshHandle, propertySet);
+}
+
 OfxStatus inputReleaseMesh(OfxMeshHandle meshHandle)
 {
   // Call internal callback before actually releasing data
@@ -253,9 +301,7 @@ OfxStatus attributeDefine(OfxMeshHandle meshHandle,
   if (componentCount < 1 || componentCount > 4) {
     return kOfxStatErrValue;
   }
-  if (0 != strcmp(type, kOfxMeshAttribTypeInt) &&
-      0 != strcmp(type, kOfxMeshAttribTypeFloat) &&
-      0 != strcmp(type, kOfxMeshAttribTypeUByte)) {
+  if (AttributeType::Unknown == attributeTypeAsEnum(type)) {
     return kOfxStatErrValue;
   }
 
@@ -389,17 +435,8 @@ OfxStatus meshAlloc(OfxMeshHandle meshHandle)
         return status;
       }
 
-      size_t byteSize = 0;
-      if (0 == strcmp(type, kOfxMeshAttribTypeUByte)) {
-        byteSize = sizeof(unsigned char);
-      }
-      else if (0 == strcmp(type, kOfxMeshAttribTypeInt)) {
-        byteSize = sizeof(int);
-      }
-      else if (0 == strcmp(type, kOfxMeshAttribTypeFloat)) {
-        byteSize = sizeof(float);
-      }
-      else {
+      size_t byteSize = byteSizeOf(attributeTypeAsEnum(type));
+      if (0 == byteSize) {
         return kOfxStatErrBadHandle;
       }
 
@@ -486,17 +523,8 @@ OfxStatus meshAlloc(OfxMeshHandle meshHandle)
       return status;
     }
 
-    size_t byteSize = 0;
-    if (0 == strcmp(type, kOfxMeshAttribTypeUByte)) {
-      byteSize = sizeof(unsigned char);
-    }
-    else if (0 == strcmp(type, kOfxMeshAttribTypeInt)) {
-      byteSize = sizeof(int);
-    }
-    else if (0 == strcmp(type, kOfxMeshAttribTypeFloat)) {
-      byteSize = sizeof(float);
-    }
-    else {
+    size_t byteSize = byteSizeOf(attributeTypeAsEnum(type));
+    if (0 == byteSize) {
       return kOfxStatErrBadHandle;
     }
 
@@ -52,6 +52,16 @@ OfxStatus inputGetMesh(OfxMeshInputHandle input,
                        OfxMeshHandle *meshHandle,
                        OfxPropertySetHandle *propertySet);
 OfxStatus inputReleaseMesh(OfxMeshHandle meshHandle);
+OfxStatus inputGetMeshChunk(OfxMeshInputHandle input,
+                            OfxTime time,
+                            int chunkIndex,
+                            OfxMeshHandle *meshHandle,
+                            OfxPropertySetHandle *propertySet);
+OfxStatus inputGetBatchMesh(OfxMeshInputHandle input,
+                            OfxTime time,
+                            int batchIndex,
+                            OfxMeshHandle *meshHandle,
+                            OfxPropertySetHandle *propertySet);
 
 // Future behavior: attributes will be NOT owned by default
 OfxStatus attributeDefine(OfxMeshHandle meshHandle,
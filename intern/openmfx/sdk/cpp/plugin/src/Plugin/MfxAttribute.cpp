@@ -1,8 +1,41 @@
 #include "MfxAttribute.h"
 #include "macros.h"
 
+#include <OpenMfx/Sdk/Cpp/AttributeConversion>
+#include <OpenMfx/Sdk/Cpp/Logger>
+
 #include <cstring>
 
+//-----------------------------------------------------------------------------
+
+/**
+ * The conversions are implemented once in the SDK common code, on its own type enum
+ */
+static OpenMfx::AttributeType toCommonType(MfxAttributeType type)
+{
+    switch (type) {
+    case MfxAttributeType::UByte:
+        return OpenMfx::AttributeType::UByte;
+    case MfxAttributeType::Int:
+        return OpenMfx::AttributeType::Int;
+    case MfxAttributeType::Float:
+        return OpenMfx::AttributeType::Float;
+    case MfxAttributeType::Int8:
+        return OpenMfx::AttributeType::Int8;
+    case MfxAttributeType::Int16:
+        return OpenMfx::AttributeType::Int16;
+    case MfxAttributeType::Half:
+        return OpenMfx::AttributeType::Half;
+    case MfxAttributeType::UByteNormalized:
+        return OpenMfx::AttributeType::UByteNormalized;
+    case MfxAttributeType::Unknown:
+    default:
+        return OpenMfx::AttributeType::Unknown;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
 MfxAttribute::MfxAttribute(const MfxHost& host, OfxPropertySetHandle properties)
 	: MfxBase(host)
 	, m_properties(properties)
@@ -16,52 +49,14 @@ OfxStatus MfxAttribute::copyAttributeData(MfxAttributeProps& destination, const
         ? source.componentCount
         : destination.componentCount;
 
-    if (source.type == destination.type)
-    {
-        size_t componentByteSize = 0;
-        switch (source.type)
-        {
-        case MfxAttributeType::UByte:
-            componentByteSize = sizeof(unsigned char);
-            break;
-        case MfxAttributeType::Int:
-            componentByteSize = sizeof(int);
-            break;
-        case MfxAttributeType::Float:
-            componentByteSize = sizeof(float);
-            break;
-        default:
-            printf("Error: unsupported attribute type: %d\n", (int)source.type);
-            return kOfxStatErrFatal;
-        }
-
-        for (int i = 0; i < count; ++i) {
-            const void* src = (void*)&source.data[(start + i) * source.stride];
-            void* dst = (void*)&destination.data[(start + i) * destination.stride];
-            memcpy(dst, src, componentCount * componentByteSize);
-        }
-        return kOfxStatOK;
-    }
-
-    switch (destination.type) {
-    case MfxAttributeType::Float:
-        switch (source.type) {
-        case MfxAttributeType::UByte:
-            for (int i = 0; i < count; ++i) {
-                const unsigned char* src = (unsigned char*)&source.data[(start + i) * source.stride];
-                float* dst = (float*)&destination.data[(start + i) * destination.stride];
-                for (int k = 0; k < componentCount; ++k)
-                {
-                    dst[k] = (float)src[k] / 255.0f;
-                }
-            }
-            return kOfxStatOK;
-            break;
-        }
-        break;
-    }
-    printf("Warning: unsupported input/output type combinason in copyAttribute: %d -> %d\n", (int)source.type, (int)destination.type);
-    return kOfxStatErrUnsupported;
+    OfxStatus status = OpenMfx::copyAttributeComponents(
+        toCommonType(destination.type), destination.data, destination.stride,
+        toCommonType(source.type), source.data, source.stride,
+        componentCount, start, count);
+    if (kOfxStatOK != status) {
+        ERR_LOG << "Unsupported input/output type combination in copyAttribute: " << (int)source.type << " -> " << (int)destination.type;
+    }
+    return status;
 }
 
 //-----------------------------------------------------------------------------
@@ -120,7 +115,19 @@ MfxAttributeType MfxAttribute::attributeTypeAsEnum(const char* mfxType)
     if (0 == strcmp(mfxType, kOfxMeshAttribTypeFloat)) {
         return MfxAttributeType::Float;
     }
-    printf("Warning: unknown attribute type: %s\n", mfxType);
+    if (0 == strcmp(mfxType, kOfxMeshAttribTypeInt8)) {
+        return MfxAttributeType::Int8;
+    }
+    if (0 == strcmp(mfxType, kOfxMeshAttribTypeInt16)) {
+        return MfxAttributeType::Int16;
+    }
+    if (0 == strcmp(mfxType, kOfxMeshAttribTypeHalf)) {
+        return MfxAttributeType::Half;
+    }
+    if (0 == strcmp(mfxType, kOfxMeshAttribTypeUByteNormalized)) {
+        return MfxAttributeType::UByteNormalized;
+    }
+    WARN_LOG << "Unknown attribute type: " << mfxType;
     return MfxAttributeType::Unknown;
 }
 
@@ -132,13 +139,33 @@ const char* MfxAttribute::attributeTypeAsString(MfxAttributeType type) {
         return kOfxMeshAttribTypeInt;
     case MfxAttributeType::Float:
         return kOfxMeshAttribTypeFloat;
+    case MfxAttributeType::Int8:
+        return kOfxMeshAttribTypeInt8;
+    case MfxAttributeType::Int16:
+        return kOfxMeshAttribTypeInt16;
+    case MfxAttributeType::Half:
+        return kOfxMeshAttribTypeHalf;
+    case MfxAttributeType::UByteNormalized:
+        return kOfxMeshAttribTypeUByteNormalized;
     case MfxAttributeType::Unknown:
     default:
-        printf("Warning: unknown attribute type: %d\n", (int)type);
+        WARN_LOG << "Unknown attribute type: " << (int)type;
         return "";
     }
 }
 
+size_t MfxAttribute::byteSizeOf(MfxAttributeType type) {
+    return (size_t)OpenMfx::byteSizeOf(toCommonType(type));
+}
+
+float MfxAttribute::halfToFloat(uint16_t half) {
+    return OpenMfx::halfToFloat(half);
+}
+
+uint16_t MfxAttribute::floatToHalf(float value) {
+    return OpenMfx::floatToHalf(value);
+}
+
 MfxAttributeAttachment MfxAttribute::attributeAttachmentAsEnum(const char* mfxAttachment) {
     if (0 == strcmp(mfxAttachment, kOfxMeshAttribPoint)) {
         return MfxAttributeAttachment::Point;
@@ -152,7 +179,7 @@ MfxAttributeAttachment MfxAttribute::attributeAttachmentAsEnum(const char* mfxAt
     if (0 == strcmp(mfxAttachment, kOfxMeshAttribMesh)) {
         return MfxAttributeAttachment::Mesh;
     }
-    printf("Warning: unknown attribute attachment: %s\n", mfxAttachment);
+    WARN_LOG << "Unknown attribute attachment: " << mfxAttachment;
     return MfxAttributeAttachment::Mesh;
 }
 
@@ -186,7 +213,7 @@ MfxAttributeSemantic MfxAttribute::attributeSemanticAsEnum(const char* mfxSemant
     if (0 == strcmp(mfxSemantic, kOfxMeshAttribSemanticWeight)) {
         return MfxAttributeSemantic::Weight;
     }
-    printf("Warning: unknown attribute semantic: %s\n", mfxSemantic);
+    WARN_LOG << "Unknown attribute semantic: " << mfxSemantic;
     return MfxAttributeSemantic::None;
 }
 
@@ -203,7 +230,7 @@ const char* MfxAttribute::attributeSemanticAsString(MfxAttributeSemantic semanti
     case MfxAttributeSemantic::None:
         return nullptr;
     default:
-        printf("Warning: unknown attribute semantic: %d\n", (int)semantic);
+        WARN_LOG << "Unknown attribute semantic: " << (int)semantic;
         return nullptr;
     }
 }
@@ -6,6 +6,9 @@
 #include "ofxCore.h"
 #include "ofxMeshEffect.h"
 
+#include <cstdint>
+#include <cstddef>
+
 /**
  * An attribute is part of a mesh, it is an information attached to either each
  * point, each corner, each face or only once for the whole mesh.
@@ -56,6 +59,18 @@ public:
 	 */
 	static const char* attributeTypeAsString(MfxAttributeType type);
 
+	/**
+	 * Return the size in bytes of one component of the given type
+	 */
+	static size_t byteSizeOf(MfxAttributeType type);
+
+	/**
+	 * Convert between 16 bit (half precision) and 32 bit floating point numbers, to read and
+	 * write MfxAttributeType::Half attributes.
+	 */
+	static float halfToFloat(uint16_t half);
+	static uint16_t floatToHalf(float value);
+
 	/**
 	 * Convert an attachment string from MeshEffect API to its local enum counterpart
 	 */
@@ -5,6 +5,10 @@ enum class MfxAttributeType {
     UByte,
     Int,
     Float,
+    Int8,
+    Int16,
+    Half,
+    UByteNormalized,
 };
 
 enum class MfxAttributeAttachment {
@@ -49,6 +49,12 @@ OfxStatus MfxEffect::MainEntry(const char *action,
             SetupCook((OfxMeshEffectHandle)handle);
             return Cook((OfxMeshEffectHandle)handle);
         }
+        if (0 == strcmp(action, kOfxMeshEffectActionCookBatch)) {
+            int batchSize = 0;
+            MFX_ENSURE(propertySuite->propGetInt(inArgs, kOfxMeshEffectPropBatchSize, 0, &batchSize));
+            SetupCook((OfxMeshEffectHandle)handle);
+            return CookBatch((OfxMeshEffectHandle)handle, batchSize);
+        }
         if (0 == strcmp(action, kOfxMeshEffectActionIsIdentity)) {
             SetupIsIdentity((OfxMeshEffectHandle)handle);
             return IsIdentity((OfxMeshEffectHandle)handle);
@@ -134,6 +140,20 @@ MfxParamDef<bool> MfxEffect::AddParam(const char* name, bool defaultValue)
     return MfxParamDef<bool>(host(), paramProps);
 }
 
+void MfxEffect::SetSupportsBatch(bool supported)
+{
+    OfxPropertySetHandle effectProps;
+    MFX_ENSURE(meshEffectSuite->getPropertySet(m_descriptor, &effectProps));
+    MFX_ENSURE(propertySuite->propSetInt(effectProps, kOfxMeshEffectPropSupportsBatch, 0, supported ? 1 : 0));
+}
+
+void MfxEffect::SetThreadSafety(const char* threadSafety)
+{
+    OfxPropertySetHandle effectProps;
+    MFX_ENSURE(meshEffectSuite->getPropertySet(m_descriptor, &effectProps));
+    MFX_ENSURE(propertySuite->propSetString(effectProps, kOfxMeshEffectPropThreadSafety, 0, threadSafety));
+}
+
 //-----------------------------------------------------------------------------
 
 MfxInput MfxEffect::GetInput(const char* name)
@@ -69,6 +69,15 @@ protected:
 	virtual OfxStatus Cook(OfxMeshEffectHandle instance)
 	{ (void)instance; return kOfxStatOK; }
 
+	/**
+	 * Equivalent of the \ref kOfxMeshEffectActionCookBatch, only called when
+	 * \ref SetSupportsBatch was called in Describe(). Meshes of the items are
+	 * accessed with \ref MfxInput::GetBatchMesh. The default implementation
+	 * lets the host call Cook() once per item.
+	 */
+	virtual OfxStatus CookBatch(OfxMeshEffectHandle instance, int batchSize)
+	{ (void)instance; (void)batchSize; return kOfxStatReplyDefault; }
+
 	/// Equivalent of the \ref kOfxMeshEffectActionIsIdentity
     virtual OfxStatus IsIdentity(OfxMeshEffectHandle instance)
     { (void)instance; return kOfxStatReplyDefault; }
@@ -97,6 +106,21 @@ protected:
 	MfxParamDef<double3> AddParam(const char *name, const double3 & defaultValue);
 	MfxParamDef<bool> AddParam(const char* name, bool defaultValue);
 
+	/**
+	 * Tell the host that this effect overrides \ref CookBatch to cook several
+	 * meshes sharing the same parameters in a single call.
+	 * Can **only** be used during the \ref Describe action.
+	 */
+	void SetSupportsBatch(bool supported = true);
+
+	/**
+	 * Declare how many cooks of this effect may run concurrently, one of
+	 * \ref kOfxMeshEffectThreadSafetyUnsafe, \ref kOfxMeshEffectThreadSafetyInstanceSafe
+	 * (the default) or \ref kOfxMeshEffectThreadSafetyFullySafe.
+	 * Can **only** be used during the \ref Describe action.
+	 */
+	void SetThreadSafety(const char* threadSafety);
+
 protected:
 	// Utility methods to be used during the Cook() action only:
 
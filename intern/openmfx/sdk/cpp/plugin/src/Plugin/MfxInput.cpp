@@ -20,3 +20,33 @@ MfxMesh MfxInput::GetMesh()
 	}
 	return MfxMesh(host(), mesh, meshProps);
 }
+
+MfxMesh MfxInput::GetMeshChunk(int chunkIndex)
+{
+	OfxTime time = 0;
+	OfxMeshHandle mesh;
+	OfxPropertySetHandle meshProps;
+	OfxStatus status;
+	if (nullptr == host().meshEffectSuite->inputGetMeshChunk) {
+		// Hosts that do not support streaming expose the whole mesh as a single chunk
+		return chunkIndex == 0 ? GetMesh() : MfxMesh(host(), NULL, NULL);
+	}
+	status = host().meshEffectSuite->inputGetMeshChunk(m_input, time, chunkIndex, &mesh, &meshProps);
+	if (kOfxStatOK != status) {
+		mesh = NULL;
+	}
+	return MfxMesh(host(), mesh, meshProps);
+}
+
+MfxMesh MfxInput::GetBatchMesh(int batchIndex)
+{
+	OfxTime time = 0;
+	OfxMeshHandle mesh;
+	OfxPropertySetHandle meshProps;
+	OfxStatus status;
+	status = host().meshEffectSuite->inputGetBatchMesh(m_input, time, batchIndex, &mesh, &meshProps);
+	if (kOfxStatOK != status) {
+		mesh = NULL;
+	}
+	return MfxMesh(host(), mesh, meshProps);
+}
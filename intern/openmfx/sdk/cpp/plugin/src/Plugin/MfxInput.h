@@ -23,6 +23,22 @@ public:
 	 */
 	MfxMesh GetMesh();
 
+	/**
+	 * Get one chunk of the mesh flowing through this input, when the input
+	 * was defined with \ref MfxInputDef::RequestChunkSize. The returned mesh
+	 * is not valid (see \ref MfxMesh::IsValid) past the last chunk, whose
+	 * index is given by the chunkCount of \ref MfxMeshProps.
+	 * For the output, each chunk is appended to the output mesh when released.
+	 */
+	MfxMesh GetMeshChunk(int chunkIndex);
+
+	/**
+	 * Get the mesh of an item of the batch, to be used within
+	 * \ref MfxEffect::CookBatch only. Meshes of different items may be
+	 * processed from different threads.
+	 */
+	MfxMesh GetBatchMesh(int batchIndex);
+
 private:
 	OfxMeshInputHandle m_input;
 };
@@ -51,6 +51,12 @@ MfxInputDef& MfxInputDef::RequestIOMap(bool request)
 	return *this;
 }
 
+MfxInputDef& MfxInputDef::RequestChunkSize(int maxFaceCount)
+{
+	MFX_ENSURE(propertySuite->propSetInt(m_properties, kOfxInputPropRequestChunkSize, 0, maxFaceCount));
+	return *this;
+}
+
 MfxInputDef& MfxInputDef::RequestGeometry(bool request)
 {
 	MFX_ENSURE(propertySuite->propSetInt(m_properties, kOfxInputPropRequestGeometry, 0, request ? 1 : 0));
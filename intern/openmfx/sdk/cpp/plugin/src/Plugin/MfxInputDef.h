@@ -48,6 +48,14 @@ public:
 
 	MfxInputDef& RequestIOMap(bool request = true);
 
+	/**
+	 * Tell the host that this input will be read chunk by chunk with
+	 * \ref MfxInput::GetMeshChunk, each chunk holding at most maxFaceCount
+	 * spatially close faces. This keeps the memory footprint of very large
+	 * meshes low, at the cost of only seeing part of the mesh at a time.
+	 */
+	MfxInputDef& RequestChunkSize(int maxFaceCount);
+
 	/**
 	 * Set the geometry matrix dependency flag of this input.
 	 * By default, an input does depend on its geometry, but this may be turned off
@@ -26,6 +26,14 @@ void MfxMesh::FetchProperties(MfxMeshProps& props)
     MFX_ENSURE(propertySuite->propGetInt(m_properties, kOfxMeshPropAttributeCount, 0, &props.attributeCount));
 
     props.noLooseEdge = (bool)noLooseEdge;
+
+    // Chunk properties are not set by hosts that do not support streaming
+    if (kOfxStatOK != host().propertySuite->propGetInt(m_properties, kOfxMeshPropChunkIndex, 0, &props.chunkIndex)) {
+        props.chunkIndex = -1;
+    }
+    if (kOfxStatOK != host().propertySuite->propGetInt(m_properties, kOfxMeshPropChunkCount, 0, &props.chunkCount)) {
+        props.chunkCount = 1;
+    }
 }
 
 MfxMesh MfxMesh::AllocateAndFetchIOMap(int output_points_count, int origin_points_pool_size) {
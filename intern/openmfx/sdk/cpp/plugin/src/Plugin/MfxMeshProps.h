@@ -59,4 +59,15 @@ struct MfxMeshProps
      * are the names of these attributes.*
      */
     int attributeCount;
+
+    /**
+     * Index of the chunk held by this mesh when it was returned by
+     * \ref MfxInput::GetMeshChunk, -1 otherwise.
+     */
+    int chunkIndex;
+
+    /**
+     * Number of chunks of the input mesh, 1 when the mesh is not split.
+     */
+    int chunkCount;
 };
@@ -0,0 +1,214 @@
+/*
+ * Copyright 2019 Elie Michel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testing/testing.h"
+
+#include <OpenMfx/Sdk/Cpp/AttributeConversion>
+#include <OpenMfx/Sdk/Cpp/Host/Attributes>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using OpenMfx::AttributeType;
+using OpenMfx::copyAttributeComponents;
+using OpenMfx::floatToHalf;
+using OpenMfx::halfToFloat;
+
+TEST(attribute_conversion_test, HalfToFloat)
+{
+  EXPECT_EQ(halfToFloat(0x0000), 0.0f);
+  EXPECT_TRUE(std::signbit(halfToFloat(0x8000)));
+  EXPECT_EQ(halfToFloat(0x3c00), 1.0f);
+  EXPECT_EQ(halfToFloat(0xc000), -2.0f);
+  EXPECT_EQ(halfToFloat(0x7bff), 65504.0f);
+
+  // Subnormals
+  EXPECT_EQ(halfToFloat(0x0001), std::ldexp(1.0f, -24));
+  EXPECT_EQ(halfToFloat(0x03ff), std::ldexp(1023.0f, -24));
+  EXPECT_EQ(halfToFloat(0x8200), -std::ldexp(1.0f, -15));
+  EXPECT_EQ(halfToFloat(0x0400), std::ldexp(1.0f, -14));
+
+  // Infinities and NaN
+  EXPECT_EQ(halfToFloat(0x7c00), std::numeric_limits<float>::infinity());
+  EXPECT_EQ(halfToFloat(0xfc00), -std::numeric_limits<float>::infinity());
+  EXPECT_TRUE(std::isnan(halfToFloat(0x7e00)));
+  EXPECT_TRUE(std::isnan(halfToFloat(0x7c01)));
+}
+
+TEST(attribute_conversion_test, FloatToHalf)
+{
+  EXPECT_EQ(floatToHalf(0.0f), 0x0000);
+  EXPECT_EQ(floatToHalf(-0.0f), 0x8000);
+  EXPECT_EQ(floatToHalf(1.0f), 0x3c00);
+  EXPECT_EQ(floatToHalf(-2.0f), 0xc000);
+  EXPECT_EQ(floatToHalf(65504.0f), 0x7bff);
+
+  // Subnormals, and values too small to be represented
+  EXPECT_EQ(floatToHalf(std::ldexp(1.0f, -24)), 0x0001);
+  EXPECT_EQ(floatToHalf(std::ldexp(1023.0f, -24)), 0x03ff);
+  EXPECT_EQ(floatToHalf(-std::ldexp(1.0f, -15)), 0x8200);
+  EXPECT_EQ(floatToHalf(std::ldexp(1.0f, -14)), 0x0400);
+  EXPECT_EQ(floatToHalf(std::ldexp(1.0f, -26)), 0x0000);
+  EXPECT_EQ(floatToHalf(-std::ldexp(1.0f, -30)), 0x8000);
+  EXPECT_EQ(floatToHalf(std::numeric_limits<float>::denorm_min()), 0x0000);
+
+  // Infinities, NaN and overflows
+  EXPECT_EQ(floatToHalf(std::numeric_limits<float>::infinity()), 0x7c00);
+  EXPECT_EQ(floatToHalf(-std::numeric_limits<float>::infinity()), 0xfc00);
+  EXPECT_EQ(floatToHalf(1e10f), 0x7c00);
+  EXPECT_EQ(floatToHalf(-65536.0f), 0xfc00);
+  const uint16_t nan = floatToHalf(std::numeric_limits<float>::quiet_NaN());
+  EXPECT_EQ(nan & 0x7c00, 0x7c00);
+  EXPECT_NE(nan & 0x03ff, 0);
+}
+
+TEST(attribute_conversion_test, FloatToHalfRounding)
+{
+  // Ties go to the even mantissa
+  EXPECT_EQ(floatToHalf(1.0f + std::ldexp(1.0f, -11)), 0x3c00);
+  EXPECT_EQ(floatToHalf(1.0f + std::ldexp(3.0f, -11)), 0x3c02);
+  EXPECT_EQ(floatToHalf(1.0f + std::ldexp(1.0f, -11) + std::ldexp(1.0f, -20)), 0x3c01);
+  EXPECT_EQ(floatToHalf(1.0f + std::ldexp(1.0f, -11) - std::ldexp(1.0f, -20)), 0x3c00);
+
+  // Same in the subnormal range
+  EXPECT_EQ(floatToHalf(std::ldexp(1.0f, -25)), 0x0000);
+  EXPECT_EQ(floatToHalf(std::ldexp(3.0f, -25)), 0x0002);
+  EXPECT_EQ(floatToHalf(std::ldexp(5.0f, -26)), 0x0001);
+
+  // A carry propagates to the exponent, up to the smallest normal and to infinity
+  EXPECT_EQ(floatToHalf(std::ldexp(4095.0f, -12)), 0x3c00);
+  EXPECT_EQ(floatToHalf(std::ldexp(2047.0f, -25)), 0x0400);
+  EXPECT_EQ(floatToHalf(65519.0f), 0x7bff);
+  EXPECT_EQ(floatToHalf(65520.0f), 0x7c00);
+
+  // Every finite half survives a round trip through float
+  for (uint32_t half = 0; half < 0x10000; ++half) {
+    if ((half & 0x7c00) != 0x7c00) {
+      EXPECT_EQ(floatToHalf(halfToFloat((uint16_t)half)), half);
+    }
+  }
+}
+
+TEST(attribute_conversion_test, CopyStridedComponents)
+{
+  // Interleaved source with a padding component that must not be read
+  struct Vertex {
+    float position[2];
+    float padding;
+  };
+  std::vector<Vertex> source = {
+      {{0.0f, 0.0f}, 9.0f}, {{2.5f, -2.5f}, 9.0f}, {{1e10f, -1e10f}, 9.0f}, {{0.4f, 7.0f}, 9.0f}};
+
+  // Destination with a different stride, elements out of [start, start + count[ are untouched
+  std::vector<int8_t> destination(4 * 3, 42);
+  ASSERT_EQ(copyAttributeComponents(AttributeType::Int8,
+                                    reinterpret_cast<char *>(destination.data()),
+                                    3 * sizeof(int8_t),
+                                    AttributeType::Float,
+                                    reinterpret_cast<const char *>(source.data()),
+                                    sizeof(Vertex),
+                                    2,
+                                    1,
+                                    2),
+            kOfxStatOK);
+  EXPECT_EQ(destination,
+            (std::vector<int8_t>{42, 42, 42, 3, -3, 42, 127, -128, 42, 42, 42, 42}));
+
+  // Same type, copied component by component rather than as a single block
+  std::vector<float> copy(4 * 4, -1.0f);
+  ASSERT_EQ(copyAttributeComponents(AttributeType::Float,
+                                    reinterpret_cast<char *>(copy.data()),
+                                    4 * sizeof(float),
+                                    AttributeType::Float,
+                                    reinterpret_cast<const char *>(source.data()),
+                                    sizeof(Vertex),
+                                    2,
+                                    0,
+                                    4),
+            kOfxStatOK);
+  EXPECT_EQ(copy[4 * 1 + 0], 2.5f);
+  EXPECT_EQ(copy[4 * 3 + 1], 7.0f);
+  EXPECT_EQ(copy[4 * 3 + 2], -1.0f);
+
+  // Half to int through a strided half buffer
+  std::vector<uint16_t> halves = {floatToHalf(-3.5f), 0, floatToHalf(100.0f), 0};
+  std::vector<int> ints(2, 0);
+  ASSERT_EQ(copyAttributeComponents(AttributeType::Int,
+                                    reinterpret_cast<char *>(ints.data()),
+                                    sizeof(int),
+                                    AttributeType::Half,
+                                    reinterpret_cast<const char *>(halves.data()),
+                                    2 * sizeof(uint16_t),
+                                    1,
+                                    0,
+                                    2),
+            kOfxStatOK);
+  EXPECT_EQ(ints, (std::vector<int>{-4, 100}));
+
+  EXPECT_EQ(copyAttributeComponents(AttributeType::Unknown,
+                                    reinterpret_cast<char *>(ints.data()),
+                                    sizeof(int),
+                                    AttributeType::Int,
+                                    reinterpret_cast<const char *>(ints.data()),
+                                    sizeof(int),
+                                    1,
+                                    0,
+                                    2),
+            kOfxStatErrUnsupported);
+}
+
+namespace {
+
+/** Attribute borrowing a buffer of the given type and component count. */
+void setup_attribute(OfxAttributeStruct &attribute,
+                     AttributeType type,
+                     int componentCount,
+                     void *data,
+                     int byteStride)
+{
+  attribute.setType(type);
+  attribute.setComponentCount(componentCount);
+  attribute.setData(data);
+  attribute.setByteStride(byteStride);
+}
+
+}  // namespace
+
+TEST(attribute_conversion_test, CopyMismatchedComponentCount)
+{
+  // Only the components that both attributes have are copied
+  std::vector<float> source = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<int16_t> narrow(2 * 2, 0);
+  std::vector<int16_t> wide(2 * 4, -1);
+
+  OfxAttributeStruct sourceAttribute, narrowAttribute, wideAttribute;
+  setup_attribute(sourceAttribute, AttributeType::Float, 3, source.data(), 3 * sizeof(float));
+  setup_attribute(narrowAttribute, AttributeType::Int16, 2, narrow.data(), 2 * sizeof(int16_t));
+  setup_attribute(wideAttribute, AttributeType::Int16, 4, wide.data(), 4 * sizeof(int16_t));
+
+  ASSERT_TRUE(narrowAttribute.copy_data_from(sourceAttribute, 0, 2));
+  EXPECT_EQ(narrow, (std::vector<int16_t>{1, 2, 4, 5}));
+
+  ASSERT_TRUE(wideAttribute.copy_data_from(sourceAttribute, 0, 2));
+  EXPECT_EQ(wide, (std::vector<int16_t>{1, 2, 3, -1, 4, 5, 6, -1}));
+
+  // And back, the third float component is left as is
+  std::fill(source.begin(), source.end(), 0.0f);
+  ASSERT_TRUE(sourceAttribute.copy_data_from(narrowAttribute, 1, 1));
+  EXPECT_EQ(source, (std::vector<float>{0.0f, 0.0f, 0.0f, 4.0f, 5.0f, 0.0f}));
+}
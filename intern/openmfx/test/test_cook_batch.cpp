@@ -0,0 +1,300 @@
+/*
+ * Copyright 2019 Elie Michel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testing/testing.h"
+
+#include <OpenMfx/Sdk/Cpp/Host/AttributeProps>
+#include <OpenMfx/Sdk/Cpp/Host/CookBatcher>
+#include <OpenMfx/Sdk/Cpp/Host/Host>
+#include <OpenMfx/Sdk/Cpp/Host/MeshEffect>
+#include <OpenMfx/Sdk/Cpp/Host/MeshProps>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Effects of test_cook_batch_plugin.cpp, the plug-in SDK is not meant to share a translation unit
+ * with the host one. */
+OfxExport OfxPlugin *OfxGetPlugin(int nth);
+
+namespace {
+
+struct TriangleMesh {
+  std::vector<std::array<float, 3>> points;
+  std::vector<std::array<int, 3>> triangles;
+  bool is_input = true;
+};
+
+/**
+ * Host exposing TriangleMesh to the effects
+ */
+class TriangleMeshHost : public OpenMfx::Host {
+ protected:
+  OfxStatus BeforeMeshGet(OfxMeshHandle ofxMesh) override
+  {
+    TriangleMesh *mesh = nullptr;
+    propertySuite->propGetPointer(
+        &ofxMesh->properties, kOfxMeshPropInternalData, 0, (void **)&mesh);
+    if (nullptr == mesh) {
+      return kOfxStatErrFatal;
+    }
+    if (!mesh->is_input) {
+      return kOfxStatOK;
+    }
+
+    OpenMfx::MeshProps props;
+    props.pointCount = static_cast<int>(mesh->points.size());
+    props.cornerCount = 3 * static_cast<int>(mesh->triangles.size());
+    props.faceCount = static_cast<int>(mesh->triangles.size());
+    props.constantFaceSize = 3;
+    props.noLooseEdge = true;
+    props.setProperties(propertySuite, &ofxMesh->properties);
+
+    // The data is borrowed from the TriangleMesh
+    for (int i = 0; i < ofxMesh->attributes.count(); ++i) {
+      OpenMfx::Attribute &attribute = ofxMesh->attributes[i];
+      propertySuite->propSetInt(&attribute.properties, kOfxMeshAttribPropIsOwner, 0, 0);
+      if (attribute.attachment() == OpenMfx::AttributeAttachment::Point &&
+          attribute.name() == kOfxMeshAttribPointPosition) {
+        attribute.setComponentCount(3);
+        attribute.setType(OpenMfx::AttributeType::Float);
+        attribute.setData((void *)mesh->points.data());
+        attribute.setByteStride(3 * sizeof(float));
+      }
+      else if (attribute.attachment() == OpenMfx::AttributeAttachment::Corner &&
+               attribute.name() == kOfxMeshAttribCornerPoint) {
+        attribute.setComponentCount(1);
+        attribute.setType(OpenMfx::AttributeType::Int);
+        attribute.setData((void *)mesh->triangles.data());
+        attribute.setByteStride(sizeof(int));
+      }
+      else if (attribute.attachment() == OpenMfx::AttributeAttachment::Face &&
+               attribute.name() == kOfxMeshAttribFaceSize) {
+        attribute.setComponentCount(1);
+        attribute.setType(OpenMfx::AttributeType::Int);
+        attribute.setData(nullptr);
+        attribute.setByteStride(0);
+      }
+    }
+    return kOfxStatOK;
+  }
+
+  OfxStatus BeforeMeshRelease(OfxMeshHandle ofxMesh) override
+  {
+    TriangleMesh *mesh = nullptr;
+    propertySuite->propGetPointer(
+        &ofxMesh->properties, kOfxMeshPropInternalData, 0, (void **)&mesh);
+    if (nullptr == mesh) {
+      return kOfxStatErrFatal;
+    }
+    if (mesh->is_input) {
+      return kOfxStatOK;
+    }
+
+    OpenMfx::MeshProps props;
+    props.fetchProperties(propertySuite, &ofxMesh->properties);
+    if (props.constantFaceSize != 3) {
+      return kOfxStatErrUnsupported;
+    }
+    mesh->points.resize(props.pointCount);
+    mesh->triangles.resize(props.faceCount);
+
+    OpenMfx::AttributeProps attributeProps;
+    for (int i = 0; i < ofxMesh->attributes.count(); ++i) {
+      OpenMfx::Attribute &attribute = ofxMesh->attributes[i];
+      attributeProps.fetchProperties(propertySuite, &attribute.properties);
+      if (attribute.attachment() == OpenMfx::AttributeAttachment::Point &&
+          attribute.name() == kOfxMeshAttribPointPosition) {
+        for (int j = 0; j < props.pointCount; ++j) {
+          const float *p = attributeProps.at<float>(j);
+          mesh->points[j] = {p[0], p[1], p[2]};
+        }
+      }
+      else if (attribute.attachment() == OpenMfx::AttributeAttachment::Corner &&
+               attribute.name() == kOfxMeshAttribCornerPoint) {
+        for (int j = 0; j < props.faceCount; ++j) {
+          for (int k = 0; k < 3; ++k) {
+            mesh->triangles[j][k] = *attributeProps.at<int>(3 * j + k);
+          }
+        }
+      }
+    }
+    return kOfxStatOK;
+  }
+};
+
+/** A strip of triangles, different for each item. */
+TriangleMesh strip_mesh(int triangle_count, float z)
+{
+  TriangleMesh mesh;
+  for (int i = 0; i < triangle_count + 2; ++i) {
+    mesh.points.push_back({static_cast<float>(i / 2), static_cast<float>(i % 2), z});
+  }
+  for (int i = 0; i < triangle_count; ++i) {
+    mesh.triangles.push_back({i, i + 1, i + 2});
+  }
+  return mesh;
+}
+
+class cook_batch_test : public testing::Test {
+ protected:
+  void SetUp() override
+  {
+    plugin = OfxGetPlugin(0);
+    ASSERT_TRUE(host.LoadPlugin(plugin));
+    batch_plugin = OfxGetPlugin(1);
+    ASSERT_TRUE(host.LoadPlugin(batch_plugin));
+  }
+
+  void TearDown() override
+  {
+    host.UnloadPlugin(batch_plugin);
+    host.UnloadPlugin(plugin);
+  }
+
+  /**
+   * Cook each input on its own, or all of them in a single batch.
+   */
+  std::vector<TriangleMesh> cook(OfxPlugin *effect_plugin,
+                                 std::vector<TriangleMesh> &inputs,
+                                 bool batched)
+  {
+    std::vector<TriangleMesh> outputs(inputs.size());
+    for (TriangleMesh &output : outputs) {
+      output.is_input = false;
+    }
+
+    OfxMeshEffectHandle descriptor, instance;
+    EXPECT_TRUE(host.GetDescriptor(effect_plugin, descriptor));
+    EXPECT_TRUE(host.CreateInstance(descriptor, instance));
+    EXPECT_EQ(host.SupportsBatch(instance), effect_plugin == batch_plugin);
+
+    OfxMeshInputStruct &input = instance->inputs[instance->inputs.find(kOfxMeshMainInput)];
+    OfxMeshInputStruct &output = instance->inputs[instance->inputs.find(kOfxMeshMainOutput)];
+    if (batched) {
+      host.PrepareBatch(instance, static_cast<int>(inputs.size()));
+      for (size_t b = 0; b < inputs.size(); ++b) {
+        host.propertySuite->propSetPointer(
+            &input.batch_meshes[b].properties, kOfxMeshPropInternalData, 0, &inputs[b]);
+        host.propertySuite->propSetPointer(
+            &output.batch_meshes[b].properties, kOfxMeshPropInternalData, 0, &outputs[b]);
+      }
+      EXPECT_TRUE(host.CookBatch(instance));
+    }
+    else {
+      for (size_t b = 0; b < inputs.size(); ++b) {
+        host.propertySuite->propSetPointer(
+            &input.mesh.properties, kOfxMeshPropInternalData, 0, &inputs[b]);
+        host.propertySuite->propSetPointer(
+            &output.mesh.properties, kOfxMeshPropInternalData, 0, &outputs[b]);
+        EXPECT_TRUE(host.Cook(instance));
+      }
+    }
+
+    host.DestroyInstance(instance);
+    host.ReleaseDescriptor(descriptor);
+    return outputs;
+  }
+
+  TriangleMeshHost host;
+  OfxPlugin *plugin = nullptr;
+  OfxPlugin *batch_plugin = nullptr;
+};
+
+}  // namespace
+
+TEST_F(cook_batch_test, BatchedMatchesUnbatched)
+{
+  std::vector<TriangleMesh> inputs = {
+      strip_mesh(1, 0.0f), strip_mesh(6, 1.0f), strip_mesh(3, -2.0f)};
+
+  const std::vector<TriangleMesh> reference = cook(plugin, inputs, false);
+  ASSERT_EQ(reference.size(), inputs.size());
+  for (size_t b = 0; b < inputs.size(); ++b) {
+    ASSERT_EQ(reference[b].points.size(), inputs[b].points.size());
+    EXPECT_EQ(reference[b].triangles, inputs[b].triangles);
+    EXPECT_FLOAT_EQ(reference[b].points[0][0], inputs[b].points[0][0] + 0.5f);
+    EXPECT_FLOAT_EQ(reference[b].points[0][2], inputs[b].points[0][2] + 2.0f);
+  }
+
+  // Effect cooking the batch itself, and host cooking the items of the batch one by one
+  for (OfxPlugin *effect_plugin : {batch_plugin, plugin}) {
+    for (bool batched : {false, true}) {
+      const std::vector<TriangleMesh> outputs = cook(effect_plugin, inputs, batched);
+      ASSERT_EQ(outputs.size(), reference.size());
+      for (size_t b = 0; b < outputs.size(); ++b) {
+        EXPECT_EQ(outputs[b].points, reference[b].points);
+        EXPECT_EQ(outputs[b].triangles, reference[b].triangles);
+      }
+    }
+  }
+}
+
+TEST(cook_batcher_test, CookEachItemOnce)
+{
+  OpenMfx::CookBatcher batcher;
+  const int thread_count = 8;
+  std::vector<int> cook_counts(thread_count, 0);
+  std::vector<std::vector<int>> batches;
+  std::mutex batches_mutex;
+  std::atomic<int> submitted_count(0);
+
+  auto cook_items = [&](void **items, int count) {
+    {
+      std::lock_guard<std::mutex> lock(batches_mutex);
+      std::vector<int> batch;
+      for (int i = 0; i < count; ++i) {
+        int *item = static_cast<int *>(items[i]);
+        cook_counts[*item]++;
+        batch.push_back(*item);
+      }
+      batches.push_back(batch);
+    }
+    // Keep the first batch cooking until the other items are queued behind it
+    while (submitted_count < thread_count) {
+      std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  };
+
+  std::vector<int> items(thread_count);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_count; ++i) {
+    items[i] = i;
+    threads.emplace_back([&, i]() {
+      // Odd and even items must never share a batch
+      const std::string key = i % 2 ? "odd" : "even";
+      ++submitted_count;
+      batcher.cook(key, &items[i], cook_items);
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < thread_count; ++i) {
+    EXPECT_EQ(cook_counts[i], 1);
+  }
+  EXPECT_LT(int(batches.size()), thread_count);
+  for (const std::vector<int> &batch : batches) {
+    for (int item : batch) {
+      EXPECT_EQ(item % 2, batch[0] % 2);
+    }
+  }
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2019 Elie Michel
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <OpenMfx/Sdk/Cpp/Plugin/MfxEffect>
+#include <OpenMfx/Sdk/Cpp/Plugin/MfxRegister>
+
+/**
+ * Move the points of the input by a fixed offset, with or without support for batches.
+ */
+template<bool SupportsBatch> class OffsetEffect : public MfxEffect {
+ protected:
+  OfxStatus Describe(OfxMeshEffectHandle) override
+  {
+    AddInput(kOfxMeshMainInput);
+    AddInput(kOfxMeshMainOutput);
+    AddParam("offset", double3{0.5, -1.0, 2.0});
+    SetSupportsBatch(SupportsBatch);
+    return kOfxStatOK;
+  }
+
+  OfxStatus Cook(OfxMeshEffectHandle) override
+  {
+    return Offset(GetInput(kOfxMeshMainInput).GetMesh(),
+                  GetInput(kOfxMeshMainOutput).GetMesh());
+  }
+
+  OfxStatus CookBatch(OfxMeshEffectHandle, int batchSize) override
+  {
+    const double3 offset = GetParam<double3>("offset").GetValue();
+    for (int b = 0; b < batchSize; ++b) {
+      OfxStatus status = Offset(GetInput(kOfxMeshMainInput).GetBatchMesh(b),
+                                GetInput(kOfxMeshMainOutput).GetBatchMesh(b),
+                                offset);
+      if (kOfxStatOK != status) {
+        return status;
+      }
+    }
+    return kOfxStatOK;
+  }
+
+ public:
+  const char *GetName() override
+  {
+    return SupportsBatch ? "OffsetBatch" : "Offset";
+  }
+
+ private:
+  OfxStatus Offset(MfxMesh input_mesh, MfxMesh output_mesh)
+  {
+    return Offset(input_mesh, output_mesh, GetParam<double3>("offset").GetValue());
+  }
+
+  OfxStatus Offset(MfxMesh input_mesh, MfxMesh output_mesh, const double3 &offset)
+  {
+    MfxMeshProps input_props;
+    input_mesh.FetchProperties(input_props);
+
+    output_mesh.GetCornerAttribute(kOfxMeshAttribCornerPoint)
+        .ForwardFrom(input_mesh.GetCornerAttribute(kOfxMeshAttribCornerPoint));
+    output_mesh.Allocate(input_props.pointCount,
+                         input_props.cornerCount,
+                         input_props.faceCount,
+                         input_props.noLooseEdge,
+                         input_props.constantFaceSize);
+
+    MfxAttributeProps input_positions, output_positions;
+    input_mesh.GetPointAttribute(kOfxMeshAttribPointPosition).FetchProperties(input_positions);
+    output_mesh.GetPointAttribute(kOfxMeshAttribPointPosition).FetchProperties(output_positions);
+    for (int i = 0; i < input_props.pointCount; ++i) {
+      const float *in_p = input_positions.at<float>(i);
+      float *out_p = output_positions.at<float>(i);
+      for (int k = 0; k < 3; ++k) {
+        out_p[k] = in_p[k] + static_cast<float>(offset[k]);
+      }
+    }
+
+    output_mesh.Release();
+    input_mesh.Release();
+    return kOfxStatOK;
+  }
+};
+
+MfxRegister(OffsetEffect<false>, OffsetEffect<true>)
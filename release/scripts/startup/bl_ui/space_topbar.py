@@ -462,6 +462,8 @@ class TOPBAR_MT_file_import(Menu):
             self.layout.operator("wm.obj_import", text="Wavefront (.obj)")
         if bpy.app.build_options.io_stl:
             self.layout.operator("wm.stl_import", text="STL (.stl) (experimental)")
+        if bpy.app.build_options.io_ply:
+            self.layout.operator("wm.ply_import", text="Stanford PLY (.ply) (experimental)")
 
 
 class TOPBAR_MT_file_export(Menu):
@@ -488,6 +490,10 @@ class TOPBAR_MT_file_export(Menu):
 
         if bpy.app.build_options.io_wavefront_obj:
             self.layout.operator("wm.obj_export", text="Wavefront (.obj)")
+        if bpy.app.build_options.io_stl:
+            self.layout.operator("wm.stl_export", text="STL (.stl) (experimental)")
+        if bpy.app.build_options.io_ply:
+            self.layout.operator("wm.ply_export", text="Stanford PLY (.ply) (experimental)")
 
         self.layout.operator("wm.obj_export", text="Wavefront (.obj) (experimental)")
 
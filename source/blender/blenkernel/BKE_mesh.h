@@ -661,6 +661,26 @@ void BKE_mesh_normals_loop_custom_set(const struct MVert *mverts,
                                       const float (*polynors)[3],
                                       int numPolys,
                                       short (*r_clnors_data)[2]);
+/**
+ * Same as #BKE_mesh_normals_loop_custom_set, reusing loop normal spaces the caller already has.
+ *
+ * \param lnors_spacearr: When not empty, the #MLNOR_SPACEARR_LOOP_INDEX spaces of the mesh,
+ * computed with a split angle of PI or from existing custom normals (both ignore the angle).
+ * It is updated to match the new custom normals, and still has to be freed by the caller.
+ */
+void BKE_mesh_normals_loop_custom_set_ex(const struct MVert *mverts,
+                                         const float (*vert_normals)[3],
+                                         int numVerts,
+                                         struct MEdge *medges,
+                                         int numEdges,
+                                         struct MLoop *mloops,
+                                         float (*r_custom_loopnors)[3],
+                                         int numLoops,
+                                         struct MPoly *mpolys,
+                                         const float (*polynors)[3],
+                                         int numPolys,
+                                         short (*r_clnors_data)[2],
+                                         MLoopNorSpaceArray *lnors_spacearr);
 void BKE_mesh_normals_loop_custom_from_vertices_set(const struct MVert *mverts,
                                                     const float (*vert_normals)[3],
                                                     float (*r_custom_vertnors)[3],
@@ -918,13 +938,15 @@ void BKE_mesh_calc_relative_deform(const struct MPoly *mpoly,
 /* *** mesh_validate.cc *** */
 
 /**
- * Validates and corrects a Mesh.
+ * Validates and corrects a Mesh. The mesh is checked with #BKE_mesh_validate_defects first,
+ * the serial #BKE_mesh_validate_arrays only runs when there are defects to fix.
  *
  * \returns true if a change is made.
  */
 bool BKE_mesh_validate(struct Mesh *me, bool do_verbose, bool cddata_check_mask);
 /**
  * Checks if a Mesh is valid without any modification. This is always verbose.
+ * Layers found valid by a previous call are skipped, see #BKE_mesh_validate_defects.
  * \returns True if the mesh is valid.
  */
 bool BKE_mesh_is_valid(struct Mesh *me);
@@ -934,6 +956,77 @@ bool BKE_mesh_is_valid(struct Mesh *me);
  */
 bool BKE_mesh_validate_material_indices(struct Mesh *me);
 
+/** Problems found by #BKE_mesh_validate_defects. */
+typedef enum eMeshDefectType {
+  /** A vertex has a coordinate that isn't finite. */
+  MESH_DEFECT_VERT_CO_NONFINITE = 0,
+  /** A vertex away from the origin has a zero normal. */
+  MESH_DEFECT_VERT_NORMAL_ZERO,
+  /** Both vertices of an edge are the same (#MeshDefect.other). */
+  MESH_DEFECT_EDGE_VERTS_EQUAL,
+  /** An edge uses the vertex #MeshDefect.other, which is out of range. */
+  MESH_DEFECT_EDGE_VERT_RANGE,
+  /** An edge uses the same vertices as the edge #MeshDefect.other. */
+  MESH_DEFECT_EDGE_DUPLICATE,
+  /** Tessellated faces without polygons, these are only handled by the full validation. */
+  MESH_DEFECT_FACES_LEGACY,
+  /** A polygon has a negative material index (#MeshDefect.other). */
+  MESH_DEFECT_POLY_MATERIAL,
+  /** A polygon has less than three loops, or uses loops out of range. */
+  MESH_DEFECT_POLY_LOOP_RANGE,
+  /** A polygon uses the vertex #MeshDefect.other more than once. */
+  MESH_DEFECT_POLY_VERT_DUPLICATE,
+  /** A polygon uses the same vertices as the polygon #MeshDefect.other. */
+  MESH_DEFECT_POLY_DUPLICATE,
+  /** A loop uses the vertex #MeshDefect.other, which is out of range. */
+  MESH_DEFECT_LOOP_VERT_RANGE,
+  /** A loop uses the edge #MeshDefect.other, which is out of range. */
+  MESH_DEFECT_LOOP_EDGE_RANGE,
+  /** A loop uses the edge #MeshDefect.other, which doesn't connect it to the next loop. */
+  MESH_DEFECT_LOOP_EDGE_MISMATCH,
+  /** A loop isn't used by any polygon. */
+  MESH_DEFECT_LOOP_UNUSED,
+  /** A loop is used by more than one polygon. */
+  MESH_DEFECT_LOOP_SHARED,
+  /** A deform weight of a vertex isn't finite or is outside of the 0-1 range. */
+  MESH_DEFECT_DVERT_WEIGHT,
+  /** A deform weight of a vertex uses the invalid group #MeshDefect.other. */
+  MESH_DEFECT_DVERT_GROUP,
+  /** A selection history element has an index out of range. */
+  MESH_DEFECT_SELECT_INDEX,
+} eMeshDefectType;
+
+typedef struct MeshDefect {
+  eMeshDefectType type;
+  /** Index of the element with the defect, the element type depends on #type. */
+  int index;
+  /** Second element involved in the defect, or -1. */
+  int other;
+} MeshDefect;
+
+/**
+ * Check the mesh for the same problems as #BKE_mesh_validate_arrays without changing it.
+ * The checks run in parallel, duplicate edges and polygons are found with a hash table
+ * partitioned between the threads.
+ *
+ * With \a use_cache, layers found valid by a previous call are skipped as long as their arrays
+ * weren't reallocated or resized, and no changes were tagged with #BKE_mesh_normals_tag_dirty,
+ * #BKE_mesh_tag_coords_changed or #BKE_mesh_runtime_clear_geometry. This relies on the same
+ * tagging as the other runtime caches, so it shouldn't be used for data that may be changed
+ * without tagging (from Python for example). Deform weights are always checked.
+ *
+ * \return The defects sorted by type and index (to be freed with #MEM_freeN),
+ * or null when the mesh is valid.
+ */
+MeshDefect *BKE_mesh_validate_defects(struct Mesh *me, bool use_cache, int *r_defects_num);
+/** Forget the layers found valid by #BKE_mesh_validate_defects. */
+void BKE_mesh_validate_cache_free(struct Mesh *me);
+/**
+ * Forget that the vertex positions and normals were found valid by #BKE_mesh_validate_defects.
+ * Called when they are changed or tagged dirty.
+ */
+void BKE_mesh_validate_cache_tag_verts_changed(struct Mesh *me);
+
 /**
  * Validate the mesh, \a do_fixes requires \a mesh to be non-null.
  *
@@ -321,6 +321,22 @@ static void cachefile_handle_free(CacheFile *cache_file)
 #endif
 }
 
+static void cachefile_handle_prefetch_update(CacheFile *cache_file)
+{
+#ifdef WITH_ALEMBIC
+  if (cache_file->handle == NULL || cache_file->type != CACHEFILE_TYPE_ALEMBIC) {
+    return;
+  }
+
+  const size_t budget = cache_file->use_prefetch ?
+                            (size_t)cache_file->prefetch_cache_size * 1024 * 1024 :
+                            0;
+  ABC_set_prefetch_budget(cache_file->handle, budget);
+#else
+  UNUSED_VARS(cache_file);
+#endif
+}
+
 void *BKE_cachefile_add(Main *bmain, const char *name)
 {
   CacheFile *cache_file = BKE_id_new(bmain, ID_CF, name);
@@ -351,6 +367,7 @@ void BKE_cachefile_eval(Main *bmain, Depsgraph *depsgraph, CacheFile *cache_file
 
   /* Test if filepath change or if we can keep the existing handle. */
   if (STREQ(cache_file->handle_filepath, filepath)) {
+    cachefile_handle_prefetch_update(cache_file);
     return;
   }
 
@@ -373,6 +390,8 @@ void BKE_cachefile_eval(Main *bmain, Depsgraph *depsgraph, CacheFile *cache_file
   }
 #endif
 
+  cachefile_handle_prefetch_update(cache_file);
+
   if (DEG_is_active(depsgraph)) {
     /* Flush object paths back to original data-block for UI. */
     CacheFile *cache_file_orig = (CacheFile *)DEG_get_original_id(&cache_file->id);
@@ -96,6 +96,7 @@ void BKE_mesh_normals_tag_dirty(Mesh *mesh)
 {
   mesh->runtime.vert_normals_dirty = true;
   mesh->runtime.poly_normals_dirty = true;
+  BKE_mesh_validate_cache_tag_verts_changed(mesh);
 }
 
 float (*BKE_mesh_vertex_normals_for_write(Mesh *mesh))[3]
@@ -1741,6 +1742,85 @@ void BKE_mesh_normals_loop_split(const MVert *mverts,
 #undef INDEX_INVALID
 #undef IS_EDGE_SHARP
 
+/**
+ * Each smooth fan is processed by a single loop, the first one listed by its lnor space.
+ */
+static bool lnor_space_is_fan_head(const MLoopNorSpace *lnor_space, const int ml_index)
+{
+  return (lnor_space->flags & MLNOR_SPACE_IS_SINGLE) ||
+         POINTER_AS_INT(lnor_space->loops->link) == ml_index;
+}
+
+/**
+ * Tag the edges between faces of given smooth fan which custom normals differ as sharp.
+ * \return true if at least one edge was not sharp yet.
+ */
+static bool mesh_normals_loop_custom_fan_tag_sharp(const MLoopNorSpace *lnor_space,
+                                                   MEdge *medges,
+                                                   const MLoop *mloops,
+                                                   const float (*custom_loopnors)[3],
+                                                   const MPoly *mpolys,
+                                                   const int *loop_to_poly)
+{
+  /* Notes:
+   * - Loops in this linklist are ordered (in reversed order compared to how they were
+   *   discovered by BKE_mesh_normals_loop_split(), but this is not a problem).
+   *   Which means if we find a mismatching clnor,
+   *   we know all remaining loops will have to be in a new, different smooth fan/lnor space.
+   * - In smooth fan case, we compare each clnor against a ref one,
+   *   to avoid small differences adding up into a real big one in the end!
+   * - Other fans may tag the same edges concurrently, hence the atomic flag update.
+   */
+  bool changed = false;
+  const MLoop *prev_ml = nullptr;
+  const float *org_nor = nullptr;
+
+  auto tag_sharp = [&](const int lidx, const MLoop *ml) {
+    /* Current normal differs too much from org one, we have to tag the edge between
+     * previous loop's face and current's one as sharp.
+     * We know those two loops do not point to the same edge,
+     * since we do not allow reversed winding in a same smooth fan. */
+    const MPoly *mp = &mpolys[loop_to_poly[lidx]];
+    const MLoop *mlp =
+        &mloops[(lidx == mp->loopstart) ? mp->loopstart + mp->totloop - 1 : lidx - 1];
+    MEdge *me = &medges[(prev_ml->e == mlp->e) ? prev_ml->e : ml->e];
+    if (!(me->flag & ME_SHARP) &&
+        !(atomic_fetch_and_or_int16(&me->flag, ME_SHARP) & ME_SHARP)) {
+      changed = true;
+    }
+  };
+
+  for (const LinkNode *loops = lnor_space->loops; loops; loops = loops->next) {
+    const int lidx = POINTER_AS_INT(loops->link);
+    const MLoop *ml = &mloops[lidx];
+    const float *nor = custom_loopnors[lidx];
+
+    if (!org_nor) {
+      org_nor = nor;
+    }
+    else if (dot_v3v3(org_nor, nor) < LNOR_SPACE_TRIGO_THRESHOLD) {
+      tag_sharp(lidx, ml);
+      org_nor = nor;
+    }
+
+    prev_ml = ml;
+  }
+
+  /* We also have to check between last and first loops,
+   * otherwise we may miss some sharp edges here!
+   * This is just a simplified version of above loop.
+   * See T45984. */
+  const LinkNode *loops = lnor_space->loops;
+  if (loops && org_nor) {
+    const int lidx = POINTER_AS_INT(loops->link);
+    if (dot_v3v3(org_nor, custom_loopnors[lidx]) < LNOR_SPACE_TRIGO_THRESHOLD) {
+      tag_sharp(lidx, &mloops[lidx]);
+    }
+  }
+
+  return changed;
+}
+
 /**
  * Compute internal representation of given custom normals (as an array of float[2]).
  * It also makes sure the mesh matches those custom normals, by setting sharp edges flag as needed
@@ -1749,6 +1829,7 @@ void BKE_mesh_normals_loop_split(const MVert *mverts,
  * (this allows to set whole vert's normals at once, useful in some cases).
  * r_custom_loopnors is expected to have normalized normals, or zero ones,
  * in which case they will be replaced by default loop/vertex normal.
+ * When r_lnors_spacearr already holds the lnor spaces of the mesh, they are used as-is.
  */
 static void mesh_normals_loop_custom_set(const MVert *mverts,
                                          const float (*vert_normals)[3],
@@ -1762,148 +1843,32 @@ static void mesh_normals_loop_custom_set(const MVert *mverts,
                                          const float (*polynors)[3],
                                          const int numPolys,
                                          short (*r_clnors_data)[2],
-                                         const bool use_vertices)
+                                         const bool use_vertices,
+                                         MLoopNorSpaceArray *r_lnors_spacearr)
 {
+  using namespace blender;
   /* We *may* make that poor #BKE_mesh_normals_loop_split() even more complex by making it handling
    * that feature too, would probably be more efficient in absolute.
    * However, this function *is not* performance-critical, since it is mostly expected to be called
    * by io add-ons when importing custom normals, and modifier
    * (and perhaps from some editing tools later?).
-   * So better to keep some simplicity here, and just call #BKE_mesh_normals_loop_split() twice! */
-  MLoopNorSpaceArray lnors_spacearr = {nullptr};
-  BLI_bitmap *done_loops = BLI_BITMAP_NEW((size_t)numLoops, __func__);
-  float(*lnors)[3] = (float(*)[3])MEM_calloc_arrayN((size_t)numLoops, sizeof(*lnors), __func__);
+   * So better to keep some simplicity here, and just call #BKE_mesh_normals_loop_split() twice!
+   * Modifiers usually already computed the lnor spaces, and can pass them to skip the first call,
+   * the second one is only needed when some edges had to be tagged sharp. */
+  MLoopNorSpaceArray lnors_spacearr_local = {nullptr};
+  MLoopNorSpaceArray &lnors_spacearr = r_lnors_spacearr ? *r_lnors_spacearr :
+                                                          lnors_spacearr_local;
+  float(*lnors)[3] = nullptr;
   int *loop_to_poly = (int *)MEM_malloc_arrayN((size_t)numLoops, sizeof(int), __func__);
   /* In this case we always consider split nors as ON,
    * and do not want to use angle to define smooth fans! */
   const bool use_split_normals = true;
   const float split_angle = (float)M_PI;
 
-  BLI_SMALLSTACK_DECLARE(clnors_data, short *);
-
-  /* Compute current lnor spacearr. */
-  BKE_mesh_normals_loop_split(mverts,
-                              vert_normals,
-                              numVerts,
-                              medges,
-                              numEdges,
-                              mloops,
-                              lnors,
-                              numLoops,
-                              mpolys,
-                              polynors,
-                              numPolys,
-                              use_split_normals,
-                              split_angle,
-                              &lnors_spacearr,
-                              nullptr,
-                              loop_to_poly);
-
-  /* Set all given zero vectors to their default value. */
-  if (use_vertices) {
-    for (int i = 0; i < numVerts; i++) {
-      if (is_zero_v3(r_custom_loopnors[i])) {
-        copy_v3_v3(r_custom_loopnors[i], vert_normals[i]);
-      }
-    }
-  }
-  else {
-    for (int i = 0; i < numLoops; i++) {
-      if (is_zero_v3(r_custom_loopnors[i])) {
-        copy_v3_v3(r_custom_loopnors[i], lnors[i]);
-      }
-    }
-  }
-
-  BLI_assert(lnors_spacearr.data_type == MLNOR_SPACEARR_LOOP_INDEX);
-
-  /* Now, check each current smooth fan (one lnor space per smooth fan!),
-   * and if all its matching custom lnors are not (enough) equal, add sharp edges as needed.
-   * This way, next time we run BKE_mesh_normals_loop_split(), we'll get lnor spacearr/smooth fans
-   * matching given custom lnors.
-   * Note this code *will never* unsharp edges! And quite obviously,
-   * when we set custom normals per vertices, running this is absolutely useless. */
-  if (!use_vertices) {
-    for (int i = 0; i < numLoops; i++) {
-      if (!lnors_spacearr.lspacearr[i]) {
-        /* This should not happen in theory, but in some rare case (probably ugly geometry)
-         * we can get some nullptr loopspacearr at this point. :/
-         * Maybe we should set those loops' edges as sharp? */
-        BLI_BITMAP_ENABLE(done_loops, i);
-        if (G.debug & G_DEBUG) {
-          printf("WARNING! Getting invalid nullptr loop space for loop %d!\n", i);
-        }
-        continue;
-      }
-
-      if (!BLI_BITMAP_TEST(done_loops, i)) {
-        /* Notes:
-         * - In case of mono-loop smooth fan, we have nothing to do.
-         * - Loops in this linklist are ordered (in reversed order compared to how they were
-         *   discovered by BKE_mesh_normals_loop_split(), but this is not a problem).
-         *   Which means if we find a mismatching clnor,
-         *   we know all remaining loops will have to be in a new, different smooth fan/lnor space.
-         * - In smooth fan case, we compare each clnor against a ref one,
-         *   to avoid small differences adding up into a real big one in the end!
-         */
-        if (lnors_spacearr.lspacearr[i]->flags & MLNOR_SPACE_IS_SINGLE) {
-          BLI_BITMAP_ENABLE(done_loops, i);
-          continue;
-        }
-
-        LinkNode *loops = lnors_spacearr.lspacearr[i]->loops;
-        MLoop *prev_ml = nullptr;
-        const float *org_nor = nullptr;
-
-        while (loops) {
-          const int lidx = POINTER_AS_INT(loops->link);
-          MLoop *ml = &mloops[lidx];
-          const int nidx = lidx;
-          float *nor = r_custom_loopnors[nidx];
-
-          if (!org_nor) {
-            org_nor = nor;
-          }
-          else if (dot_v3v3(org_nor, nor) < LNOR_SPACE_TRIGO_THRESHOLD) {
-            /* Current normal differs too much from org one, we have to tag the edge between
-             * previous loop's face and current's one as sharp.
-             * We know those two loops do not point to the same edge,
-             * since we do not allow reversed winding in a same smooth fan. */
-            const MPoly *mp = &mpolys[loop_to_poly[lidx]];
-            const MLoop *mlp =
-                &mloops[(lidx == mp->loopstart) ? mp->loopstart + mp->totloop - 1 : lidx - 1];
-            medges[(prev_ml->e == mlp->e) ? prev_ml->e : ml->e].flag |= ME_SHARP;
-
-            org_nor = nor;
-          }
-
-          prev_ml = ml;
-          loops = loops->next;
-          BLI_BITMAP_ENABLE(done_loops, lidx);
-        }
-
-        /* We also have to check between last and first loops,
-         * otherwise we may miss some sharp edges here!
-         * This is just a simplified version of above while loop.
-         * See T45984. */
-        loops = lnors_spacearr.lspacearr[i]->loops;
-        if (loops && org_nor) {
-          const int lidx = POINTER_AS_INT(loops->link);
-          MLoop *ml = &mloops[lidx];
-          const int nidx = lidx;
-          float *nor = r_custom_loopnors[nidx];
-
-          if (dot_v3v3(org_nor, nor) < LNOR_SPACE_TRIGO_THRESHOLD) {
-            const MPoly *mp = &mpolys[loop_to_poly[lidx]];
-            const MLoop *mlp =
-                &mloops[(lidx == mp->loopstart) ? mp->loopstart + mp->totloop - 1 : lidx - 1];
-            medges[(prev_ml->e == mlp->e) ? prev_ml->e : ml->e].flag |= ME_SHARP;
-          }
-        }
-      }
+  auto compute_lnor_spaces = [&]() {
+    if (lnors == nullptr) {
+      lnors = (float(*)[3])MEM_malloc_arrayN((size_t)numLoops, sizeof(*lnors), __func__);
     }
-
-    /* And now, recompute our new auto lnors and lnor spacearr! */
     BKE_lnor_spacearr_clear(&lnors_spacearr);
     BKE_mesh_normals_loop_split(mverts,
                                 vert_normals,
@@ -1921,70 +1886,172 @@ static void mesh_normals_loop_custom_set(const MVert *mverts,
                                 &lnors_spacearr,
                                 nullptr,
                                 loop_to_poly);
+  };
+
+  /* Compute current lnor spacearr, unless given. */
+  if (lnors_spacearr.lspacearr == nullptr) {
+    compute_lnor_spaces();
+  }
+  else if (!use_vertices) {
+    threading::parallel_for(IndexRange(numPolys), 1024, [&](const IndexRange range) {
+      for (const int mp_index : range) {
+        const MPoly &mp = mpolys[mp_index];
+        for (const int ml_index : IndexRange(mp.loopstart, mp.totloop)) {
+          loop_to_poly[ml_index] = mp_index;
+        }
+      }
+    });
+  }
+
+  BLI_assert(lnors_spacearr.data_type == MLNOR_SPACEARR_LOOP_INDEX);
+
+  /* Set all given zero vectors to their default value. */
+  if (use_vertices) {
+    threading::parallel_for(IndexRange(numVerts), 4096, [&](const IndexRange range) {
+      for (const int i : range) {
+        if (is_zero_v3(r_custom_loopnors[i])) {
+          copy_v3_v3(r_custom_loopnors[i], vert_normals[i]);
+        }
+      }
+    });
   }
   else {
-    BLI_bitmap_set_all(done_loops, true, (size_t)numLoops);
+    /* The automatic normal of each loop is the one of its smooth fan. */
+    threading::parallel_for(IndexRange(numLoops), 4096, [&](const IndexRange range) {
+      for (const int i : range) {
+        if (is_zero_v3(r_custom_loopnors[i]) && lnors_spacearr.lspacearr[i]) {
+          copy_v3_v3(r_custom_loopnors[i], lnors_spacearr.lspacearr[i]->vec_lnor);
+        }
+      }
+    });
+  }
+
+  /* Now, check each current smooth fan (one lnor space per smooth fan!),
+   * and if all its matching custom lnors are not (enough) equal, add sharp edges as needed.
+   * This way, next time we run BKE_mesh_normals_loop_split(), we'll get lnor spacearr/smooth fans
+   * matching given custom lnors.
+   * Note this code *will never* unsharp edges! And quite obviously,
+   * when we set custom normals per vertices, running this is absolutely useless. */
+  if (!use_vertices) {
+    const bool sharp_tagged = threading::parallel_reduce(
+        IndexRange(numLoops),
+        1024,
+        false,
+        [&](const IndexRange range, bool changed) {
+          for (const int i : range) {
+            const MLoopNorSpace *lnor_space = lnors_spacearr.lspacearr[i];
+            if (!lnor_space) {
+              /* This should not happen in theory, but in some rare case (probably ugly geometry)
+               * we can get some nullptr loopspacearr at this point. :/
+               * Maybe we should set those loops' edges as sharp? */
+              if (G.debug & G_DEBUG) {
+                printf("WARNING! Getting invalid nullptr loop space for loop %d!\n", i);
+              }
+              continue;
+            }
+            /* In case of mono-loop smooth fan, we have nothing to do. */
+            if ((lnor_space->flags & MLNOR_SPACE_IS_SINGLE) ||
+                !lnor_space_is_fan_head(lnor_space, i)) {
+              continue;
+            }
+            changed |= mesh_normals_loop_custom_fan_tag_sharp(
+                lnor_space, medges, mloops, r_custom_loopnors, mpolys, loop_to_poly);
+          }
+          return changed;
+        },
+        [](const bool a, const bool b) { return a || b; });
+
+    /* And now, recompute our new auto lnors and lnor spacearr! */
+    if (sharp_tagged) {
+      compute_lnor_spaces();
+    }
   }
 
   /* And we just have to convert plain object-space custom normals to our
-   * lnor space-encoded ones. */
-  for (int i = 0; i < numLoops; i++) {
-    if (!lnors_spacearr.lspacearr[i]) {
-      BLI_BITMAP_DISABLE(done_loops, i);
-      if (G.debug & G_DEBUG) {
-        printf("WARNING! Still getting invalid nullptr loop space in second loop for loop %d!\n",
-               i);
+   * lnor space-encoded ones. Each loop belongs to a single smooth fan, so the fans
+   * can be encoded in parallel. */
+  threading::parallel_for(IndexRange(numLoops), 1024, [&](const IndexRange range) {
+    for (const int i : range) {
+      MLoopNorSpace *lnor_space = lnors_spacearr.lspacearr[i];
+      if (!lnor_space) {
+        if (G.debug & G_DEBUG) {
+          printf("WARNING! Still getting invalid nullptr loop space in second loop for loop %d!\n",
+                 i);
+        }
+        continue;
+      }
+      if (!lnor_space_is_fan_head(lnor_space, i)) {
+        continue;
+      }
+
+      if (lnor_space->flags & MLNOR_SPACE_IS_SINGLE) {
+        BLI_assert(POINTER_AS_INT(lnor_space->loops) == i);
+        const int nidx = use_vertices ? (int)mloops[i].v : i;
+        BKE_lnor_space_custom_normal_to_data(lnor_space, r_custom_loopnors[nidx], r_clnors_data[i]);
+        continue;
       }
-      continue;
-    }
 
-    if (BLI_BITMAP_TEST_BOOL(done_loops, i)) {
       /* Note we accumulate and average all custom normals in current smooth fan,
        * to avoid getting different clnors data (tiny differences in plain custom normals can
        * give rather huge differences in computed 2D factors). */
-      LinkNode *loops = lnors_spacearr.lspacearr[i]->loops;
-      if (lnors_spacearr.lspacearr[i]->flags & MLNOR_SPACE_IS_SINGLE) {
-        BLI_assert(POINTER_AS_INT(loops) == i);
-        const int nidx = use_vertices ? (int)mloops[i].v : i;
-        float *nor = r_custom_loopnors[nidx];
-
-        BKE_lnor_space_custom_normal_to_data(lnors_spacearr.lspacearr[i], nor, r_clnors_data[i]);
-        BLI_BITMAP_DISABLE(done_loops, i);
+      int avg_nor_count = 0;
+      float avg_nor[3];
+      short clnor_data_tmp[2];
+
+      zero_v3(avg_nor);
+      for (const LinkNode *loops = lnor_space->loops; loops; loops = loops->next) {
+        const int lidx = POINTER_AS_INT(loops->link);
+        const int nidx = use_vertices ? (int)mloops[lidx].v : lidx;
+        add_v3_v3(avg_nor, r_custom_loopnors[nidx]);
+        avg_nor_count++;
       }
-      else {
-        int avg_nor_count = 0;
-        float avg_nor[3];
-        short clnor_data_tmp[2], *clnor_data;
-
-        zero_v3(avg_nor);
-        while (loops) {
-          const int lidx = POINTER_AS_INT(loops->link);
-          const int nidx = use_vertices ? (int)mloops[lidx].v : lidx;
-          float *nor = r_custom_loopnors[nidx];
-
-          avg_nor_count++;
-          add_v3_v3(avg_nor, nor);
-          BLI_SMALLSTACK_PUSH(clnors_data, (short *)r_clnors_data[lidx]);
-
-          loops = loops->next;
-          BLI_BITMAP_DISABLE(done_loops, lidx);
-        }
 
-        mul_v3_fl(avg_nor, 1.0f / (float)avg_nor_count);
-        BKE_lnor_space_custom_normal_to_data(lnors_spacearr.lspacearr[i], avg_nor, clnor_data_tmp);
+      mul_v3_fl(avg_nor, 1.0f / (float)avg_nor_count);
+      BKE_lnor_space_custom_normal_to_data(lnor_space, avg_nor, clnor_data_tmp);
 
-        while ((clnor_data = (short *)BLI_SMALLSTACK_POP(clnors_data))) {
-          clnor_data[0] = clnor_data_tmp[0];
-          clnor_data[1] = clnor_data_tmp[1];
-        }
+      for (const LinkNode *loops = lnor_space->loops; loops; loops = loops->next) {
+        const int lidx = POINTER_AS_INT(loops->link);
+        r_clnors_data[lidx][0] = clnor_data_tmp[0];
+        r_clnors_data[lidx][1] = clnor_data_tmp[1];
       }
     }
-  }
+  });
 
-  MEM_freeN(lnors);
+  MEM_SAFE_FREE(lnors);
   MEM_freeN(loop_to_poly);
-  MEM_freeN(done_loops);
-  BKE_lnor_spacearr_free(&lnors_spacearr);
+  if (r_lnors_spacearr == nullptr) {
+    BKE_lnor_spacearr_free(&lnors_spacearr_local);
+  }
+}
+
+void BKE_mesh_normals_loop_custom_set_ex(const MVert *mverts,
+                                         const float (*vert_normals)[3],
+                                         const int numVerts,
+                                         MEdge *medges,
+                                         const int numEdges,
+                                         MLoop *mloops,
+                                         float (*r_custom_loopnors)[3],
+                                         const int numLoops,
+                                         MPoly *mpolys,
+                                         const float (*polynors)[3],
+                                         const int numPolys,
+                                         short (*r_clnors_data)[2],
+                                         MLoopNorSpaceArray *lnors_spacearr)
+{
+  mesh_normals_loop_custom_set(mverts,
+                               vert_normals,
+                               numVerts,
+                               medges,
+                               numEdges,
+                               mloops,
+                               r_custom_loopnors,
+                               numLoops,
+                               mpolys,
+                               polynors,
+                               numPolys,
+                               r_clnors_data,
+                               false,
+                               lnors_spacearr);
 }
 
 void BKE_mesh_normals_loop_custom_set(const MVert *mverts,
@@ -2012,7 +2079,8 @@ void BKE_mesh_normals_loop_custom_set(const MVert *mverts,
                                polynors,
                                numPolys,
                                r_clnors_data,
-                               false);
+                               false,
+                               nullptr);
 }
 
 void BKE_mesh_normals_loop_custom_from_vertices_set(const MVert *mverts,
@@ -2040,7 +2108,8 @@ void BKE_mesh_normals_loop_custom_from_vertices_set(const MVert *mverts,
                                polynors,
                                numPolys,
                                r_clnors_data,
-                               true);
+                               true,
+                               nullptr);
 }
 
 static void mesh_set_custom_normals(Mesh *mesh, float (*r_custom_nors)[3], const bool use_vertices)
@@ -2069,7 +2138,8 @@ static void mesh_set_custom_normals(Mesh *mesh, float (*r_custom_nors)[3], const
                                BKE_mesh_poly_normals_ensure(mesh),
                                mesh->totpoly,
                                clnors,
-                               use_vertices);
+                               use_vertices,
+                               nullptr);
 }
 
 void BKE_mesh_set_custom_normals(Mesh *mesh, float (*r_custom_loopnors)[3])
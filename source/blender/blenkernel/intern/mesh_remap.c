@@ -22,6 +22,8 @@
 #include "BLI_memarena.h"
 #include "BLI_polyfill_2d.h"
 #include "BLI_rand.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_bvhutils.h"
@@ -115,27 +117,39 @@ float BKE_mesh_remap_calc_difference_from_mesh(const SpaceTransform *space_trans
                                                Mesh *me_src)
 {
   BVHTreeFromMesh treedata = {NULL};
-  BVHTreeNearest nearest = {0};
-  float hit_dist;
 
   float result = 0.0f;
   int i;
 
   BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_VERTS, 2);
-  nearest.index = -1;
 
-  for (i = 0; i < numverts_dst; i++) {
-    float tmp_co[3];
+  float(*cos_dst)[3] = MEM_malloc_arrayN((size_t)numverts_dst, sizeof(*cos_dst), __func__);
+  BVHTreeNearest *nearest = MEM_malloc_arrayN((size_t)numverts_dst, sizeof(*nearest), __func__);
 
-    copy_v3_v3(tmp_co, verts_dst[i].co);
+  for (i = 0; i < numverts_dst; i++) {
+    copy_v3_v3(cos_dst[i], verts_dst[i].co);
 
     /* Convert the vertex to tree coordinates, if needed. */
     if (space_transform) {
-      BLI_space_transform_apply(space_transform, tmp_co);
+      BLI_space_transform_apply(space_transform, cos_dst[i]);
     }
 
-    if (mesh_remap_bvhtree_query_nearest(&treedata, &nearest, tmp_co, FLT_MAX, &hit_dist)) {
-      result += 1.0f / (hit_dist + 1.0f);
+    nearest[i].index = -1;
+    nearest[i].dist_sq = FLT_MAX;
+  }
+
+  /* This is evaluated for many transforms, query all vertices in parallel. */
+  BLI_bvhtree_find_nearest_batch(treedata.tree,
+                                 (const float(*)[3])cos_dst,
+                                 numverts_dst,
+                                 nearest,
+                                 treedata.nearest_callback,
+                                 &treedata,
+                                 0);
+
+  for (i = 0; i < numverts_dst; i++) {
+    if (nearest[i].index != -1) {
+      result += 1.0f / (sqrtf(nearest[i].dist_sq) + 1.0f);
     }
     else {
       /* No source for this dest vertex! */
@@ -143,6 +157,9 @@ float BKE_mesh_remap_calc_difference_from_mesh(const SpaceTransform *space_trans
     }
   }
 
+  MEM_freeN(cos_dst);
+  MEM_freeN(nearest);
+
   result = ((float)numverts_dst / result) - 1.0f;
 
 #if 0
@@ -346,16 +363,15 @@ void BKE_mesh_remap_free(MeshPairRemap *map)
   map->mem = NULL;
 }
 
-static void mesh_remap_item_define(MeshPairRemap *map,
-                                   const int index,
-                                   const float UNUSED(hit_dist),
-                                   const int island,
-                                   const int sources_num,
-                                   const int *indices_src,
-                                   const float *weights_src)
+static void mesh_remap_item_define_ex(MeshPairRemap *map,
+                                      MemArena *mem,
+                                      const int index,
+                                      const int island,
+                                      const int sources_num,
+                                      const int *indices_src,
+                                      const float *weights_src)
 {
   MeshPairRemapItem *mapit = &map->items[index];
-  MemArena *mem = map->mem;
 
   if (sources_num) {
     mapit->sources_num = sources_num;
@@ -376,6 +392,17 @@ static void mesh_remap_item_define(MeshPairRemap *map,
   mapit->island = island;
 }
 
+static void mesh_remap_item_define(MeshPairRemap *map,
+                                   const int index,
+                                   const float UNUSED(hit_dist),
+                                   const int island,
+                                   const int sources_num,
+                                   const int *indices_src,
+                                   const float *weights_src)
+{
+  mesh_remap_item_define_ex(map, map->mem, index, island, sources_num, indices_src, weights_src);
+}
+
 void BKE_mesh_remap_item_define_invalid(MeshPairRemap *map, const int index)
 {
   mesh_remap_item_define(map, index, FLT_MAX, 0, 0, NULL, NULL);
@@ -470,6 +497,294 @@ typedef struct IslandResult {
 /* Will be enough in 99% of cases. */
 #define MREMAP_DEFAULT_BUFSIZE 32
 
+/**
+ * Thread local data of the parallel mappings, every destination element is mapped independently.
+ *
+ * Items are allocated from a thread local arena, merged into the map's one when the task
+ * is done. All buffers are allocated on first use.
+ */
+typedef struct MeshRemapTLS {
+  MeshPairRemap *r_map;
+  /** Protects `r_map->mem` when merging the thread local arena. */
+  ThreadMutex *r_map_lock;
+  MemArena *mem;
+
+  /** Nearest hit of the previous element, used as starting point for the next query. */
+  BVHTreeNearest nearest;
+  BVHTreeRayHit rayhit;
+
+  /** Buffers of #mesh_remap_interp_poly_data_get. */
+  size_t buff_size_interp;
+  float (*vcos_interp)[3];
+  int *indices_interp;
+  float *weights_interp;
+
+  /** Sampling modes, accumulated weights of all source elements. */
+  int *indices_src;
+  float *weights_src;
+  RNG *rng;
+  size_t tmp_poly_size;
+  float (*poly_vcos_2d)[2];
+  int (*tri_vidx_2d)[3];
+
+  /** Loops mapping, results of each source island for the loops of a destination poly. */
+  IslandResult **islands_res;
+  int islands_res_num;
+  size_t islands_res_buff_size;
+  BLI_AStarSolution as_solution;
+} MeshRemapTLS;
+
+static void mesh_remap_tls_item_define(MeshRemapTLS *tls,
+                                       const int index,
+                                       const int island,
+                                       const int sources_num,
+                                       const int *indices_src,
+                                       const float *weights_src)
+{
+  if (tls->mem == NULL) {
+    tls->mem = BLI_memarena_new(BLI_MEMARENA_STD_BUFSIZE, __func__);
+  }
+  mesh_remap_item_define_ex(
+      tls->r_map, tls->mem, index, island, sources_num, indices_src, weights_src);
+}
+
+static void mesh_remap_tls_interp_ensure(MeshRemapTLS *tls)
+{
+  if (tls->vcos_interp == NULL) {
+    tls->buff_size_interp = MREMAP_DEFAULT_BUFSIZE;
+    tls->vcos_interp = MEM_mallocN(sizeof(*tls->vcos_interp) * tls->buff_size_interp, __func__);
+    tls->indices_interp = MEM_mallocN(sizeof(*tls->indices_interp) * tls->buff_size_interp,
+                                      __func__);
+    tls->weights_interp = MEM_mallocN(sizeof(*tls->weights_interp) * tls->buff_size_interp,
+                                      __func__);
+  }
+}
+
+static void mesh_remap_tls_src_ensure(MeshRemapTLS *tls,
+                                      const size_t indices_num,
+                                      const size_t src_num)
+{
+  if (tls->weights_src == NULL) {
+    tls->indices_src = MEM_mallocN(sizeof(*tls->indices_src) * indices_num, __func__);
+    tls->weights_src = MEM_mallocN(sizeof(*tls->weights_src) * src_num, __func__);
+  }
+}
+
+static void mesh_remap_tls_free(const void *__restrict UNUSED(userdata), void *__restrict chunk)
+{
+  MeshRemapTLS *tls = chunk;
+
+  if (tls->mem) {
+    BLI_mutex_lock(tls->r_map_lock);
+    BLI_memarena_merge(tls->r_map->mem, tls->mem);
+    BLI_mutex_unlock(tls->r_map_lock);
+    BLI_memarena_free(tls->mem);
+  }
+
+  MEM_SAFE_FREE(tls->vcos_interp);
+  MEM_SAFE_FREE(tls->indices_interp);
+  MEM_SAFE_FREE(tls->weights_interp);
+  MEM_SAFE_FREE(tls->indices_src);
+  MEM_SAFE_FREE(tls->weights_src);
+  MEM_SAFE_FREE(tls->poly_vcos_2d);
+  MEM_SAFE_FREE(tls->tri_vidx_2d);
+  if (tls->rng) {
+    BLI_rng_free(tls->rng);
+  }
+  if (tls->islands_res) {
+    for (int i = 0; i < tls->islands_res_num; i++) {
+      MEM_freeN(tls->islands_res[i]);
+    }
+    MEM_freeN(tls->islands_res);
+  }
+  BLI_astar_solution_free(&tls->as_solution);
+}
+
+/**
+ * Run \a func for every destination element, \a grain_size is the minimum number of elements
+ * handled by a task, depending on how expensive mapping a single element is.
+ */
+static void mesh_remap_parallel_range(MeshPairRemap *r_map,
+                                      const int items_num,
+                                      const int grain_size,
+                                      void *userdata,
+                                      TaskParallelRangeFunc func)
+{
+  ThreadMutex r_map_lock;
+  BLI_mutex_init(&r_map_lock);
+
+  MeshRemapTLS tls = {
+      .r_map = r_map,
+      .r_map_lock = &r_map_lock,
+  };
+  tls.nearest.index = -1;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = items_num > grain_size;
+  settings.min_iter_per_thread = grain_size;
+  settings.userdata_chunk = &tls;
+  settings.userdata_chunk_size = sizeof(tls);
+  settings.func_free = mesh_remap_tls_free;
+  BLI_task_parallel_range(0, items_num, userdata, func, &settings);
+
+  BLI_mutex_end(&r_map_lock);
+}
+
+typedef struct MeshRemapVertsData {
+  int mode;
+  const SpaceTransform *space_transform;
+  float max_dist;
+  float ray_radius;
+  BVHTreeFromMesh *treedata;
+
+  const MVert *verts_dst;
+  const float (*vert_normals_dst)[3];
+
+  const MEdge *edges_src;
+  MPoly *polys_src;
+  MLoop *loops_src;
+  const float (*vcos_src)[3];
+} MeshRemapVertsData;
+
+static void mesh_remap_verts_cb(void *__restrict userdata,
+                                const int i,
+                                const TaskParallelTLS *__restrict tls_v)
+{
+  const MeshRemapVertsData *data = userdata;
+  MeshRemapTLS *tls = tls_v->userdata_chunk;
+  const int mode = data->mode;
+  const float full_weight = 1.0f;
+  const float max_dist_sq = data->max_dist * data->max_dist;
+  float hit_dist;
+  float tmp_co[3], tmp_no[3];
+
+  copy_v3_v3(tmp_co, data->verts_dst[i].co);
+
+  if (mode == MREMAP_MODE_VERT_POLYINTERP_VNORPROJ) {
+    copy_v3_v3(tmp_no, data->vert_normals_dst[i]);
+
+    /* Convert the vertex to tree coordinates, if needed. */
+    if (data->space_transform) {
+      BLI_space_transform_apply(data->space_transform, tmp_co);
+      BLI_space_transform_apply_normal(data->space_transform, tmp_no);
+    }
+
+    if (mesh_remap_bvhtree_query_raycast(data->treedata,
+                                         &tls->rayhit,
+                                         tmp_co,
+                                         tmp_no,
+                                         data->ray_radius,
+                                         data->max_dist,
+                                         &hit_dist)) {
+      const MLoopTri *lt = &data->treedata->looptri[tls->rayhit.index];
+      MPoly *mp_src = &data->polys_src[lt->poly];
+      mesh_remap_tls_interp_ensure(tls);
+      const int sources_num = mesh_remap_interp_poly_data_get(mp_src,
+                                                              data->loops_src,
+                                                              data->vcos_src,
+                                                              tls->rayhit.co,
+                                                              &tls->buff_size_interp,
+                                                              &tls->vcos_interp,
+                                                              false,
+                                                              &tls->indices_interp,
+                                                              &tls->weights_interp,
+                                                              true,
+                                                              NULL);
+
+      mesh_remap_tls_item_define(
+          tls, i, 0, sources_num, tls->indices_interp, tls->weights_interp);
+    }
+    else {
+      /* No source for this dest vertex! */
+      BKE_mesh_remap_item_define_invalid(tls->r_map, i);
+    }
+    return;
+  }
+
+  /* Convert the vertex to tree coordinates, if needed. */
+  if (data->space_transform) {
+    BLI_space_transform_apply(data->space_transform, tmp_co);
+  }
+
+  if (!mesh_remap_bvhtree_query_nearest(
+          data->treedata, &tls->nearest, tmp_co, max_dist_sq, &hit_dist)) {
+    /* No source for this dest vertex! */
+    BKE_mesh_remap_item_define_invalid(tls->r_map, i);
+    return;
+  }
+
+  const BVHTreeNearest *nearest = &tls->nearest;
+
+  if (mode == MREMAP_MODE_VERT_NEAREST) {
+    mesh_remap_tls_item_define(tls, i, 0, 1, &nearest->index, &full_weight);
+  }
+  else if (ELEM(mode, MREMAP_MODE_VERT_EDGE_NEAREST, MREMAP_MODE_VERT_EDGEINTERP_NEAREST)) {
+    const MEdge *me = &data->edges_src[nearest->index];
+    const float *v1cos = data->vcos_src[me->v1];
+    const float *v2cos = data->vcos_src[me->v2];
+
+    if (mode == MREMAP_MODE_VERT_EDGE_NEAREST) {
+      const float dist_v1 = len_squared_v3v3(tmp_co, v1cos);
+      const float dist_v2 = len_squared_v3v3(tmp_co, v2cos);
+      const int index = (int)((dist_v1 > dist_v2) ? me->v2 : me->v1);
+      mesh_remap_tls_item_define(tls, i, 0, 1, &index, &full_weight);
+    }
+    else if (mode == MREMAP_MODE_VERT_EDGEINTERP_NEAREST) {
+      int indices[2];
+      float weights[2];
+
+      indices[0] = (int)me->v1;
+      indices[1] = (int)me->v2;
+
+      /* Weight is inverse of point factor here... */
+      weights[0] = line_point_factor_v3(tmp_co, v2cos, v1cos);
+      CLAMP(weights[0], 0.0f, 1.0f);
+      weights[1] = 1.0f - weights[0];
+
+      mesh_remap_tls_item_define(tls, i, 0, 2, indices, weights);
+    }
+  }
+  else {
+    const MLoopTri *lt = &data->treedata->looptri[nearest->index];
+    MPoly *mp = &data->polys_src[lt->poly];
+
+    mesh_remap_tls_interp_ensure(tls);
+    if (mode == MREMAP_MODE_VERT_POLY_NEAREST) {
+      int index;
+      mesh_remap_interp_poly_data_get(mp,
+                                      data->loops_src,
+                                      data->vcos_src,
+                                      nearest->co,
+                                      &tls->buff_size_interp,
+                                      &tls->vcos_interp,
+                                      false,
+                                      &tls->indices_interp,
+                                      &tls->weights_interp,
+                                      false,
+                                      &index);
+
+      mesh_remap_tls_item_define(tls, i, 0, 1, &index, &full_weight);
+    }
+    else if (mode == MREMAP_MODE_VERT_POLYINTERP_NEAREST) {
+      const int sources_num = mesh_remap_interp_poly_data_get(mp,
+                                                              data->loops_src,
+                                                              data->vcos_src,
+                                                              nearest->co,
+                                                              &tls->buff_size_interp,
+                                                              &tls->vcos_interp,
+                                                              false,
+                                                              &tls->indices_interp,
+                                                              &tls->weights_interp,
+                                                              true,
+                                                              NULL);
+
+      mesh_remap_tls_item_define(
+          tls, i, 0, sources_num, tls->indices_interp, tls->weights_interp);
+    }
+  }
+}
+
 void BKE_mesh_remap_calc_verts_from_mesh(const int mode,
                                          const SpaceTransform *space_transform,
                                          const float max_dist,
@@ -482,7 +797,6 @@ void BKE_mesh_remap_calc_verts_from_mesh(const int mode,
                                          MeshPairRemap *r_map)
 {
   const float full_weight = 1.0f;
-  const float max_dist_sq = max_dist * max_dist;
   int i;
 
   BLI_assert(mode & MREMAP_MODE_VERT);
@@ -497,200 +811,320 @@ void BKE_mesh_remap_calc_verts_from_mesh(const int mode,
   }
   else {
     BVHTreeFromMesh treedata = {NULL};
-    BVHTreeNearest nearest = {0};
-    BVHTreeRayHit rayhit = {0};
-    float hit_dist;
-    float tmp_co[3], tmp_no[3];
+    MeshRemapVertsData data = {
+        .mode = mode,
+        .space_transform = space_transform,
+        .max_dist = max_dist,
+        .ray_radius = ray_radius,
+        .treedata = &treedata,
+        .verts_dst = verts_dst,
+    };
+    float(*vcos_src)[3] = NULL;
 
     if (mode == MREMAP_MODE_VERT_NEAREST) {
       BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_VERTS, 2);
-      nearest.index = -1;
-
-      for (i = 0; i < numverts_dst; i++) {
-        copy_v3_v3(tmp_co, verts_dst[i].co);
+    }
+    else if (ELEM(mode, MREMAP_MODE_VERT_EDGE_NEAREST, MREMAP_MODE_VERT_EDGEINTERP_NEAREST)) {
+      vcos_src = BKE_mesh_vert_coords_alloc(me_src, NULL);
+      data.edges_src = me_src->medge;
+      BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_EDGES, 2);
+    }
+    else if (ELEM(mode,
+                  MREMAP_MODE_VERT_POLY_NEAREST,
+                  MREMAP_MODE_VERT_POLYINTERP_NEAREST,
+                  MREMAP_MODE_VERT_POLYINTERP_VNORPROJ)) {
+      vcos_src = BKE_mesh_vert_coords_alloc(me_src, NULL);
+      data.polys_src = me_src->mpoly;
+      data.loops_src = me_src->mloop;
+      data.vert_normals_dst = BKE_mesh_vertex_normals_ensure(me_dst);
+      BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_LOOPTRI, 2);
+    }
+    else {
+      CLOG_WARN(&LOG, "Unsupported mesh-to-mesh vertex mapping mode (%d)!", mode);
+      memset(r_map->items, 0, sizeof(*r_map->items) * (size_t)numverts_dst);
+    }
 
-        /* Convert the vertex to tree coordinates, if needed. */
-        if (space_transform) {
-          BLI_space_transform_apply(space_transform, tmp_co);
-        }
+    if (treedata.tree) {
+      data.vcos_src = (const float(*)[3])vcos_src;
+      mesh_remap_parallel_range(r_map, numverts_dst, 256, &data, mesh_remap_verts_cb);
+    }
 
-        if (mesh_remap_bvhtree_query_nearest(
-                &treedata, &nearest, tmp_co, max_dist_sq, &hit_dist)) {
-          mesh_remap_item_define(r_map, i, hit_dist, 0, 1, &nearest.index, &full_weight);
-        }
-        else {
-          /* No source for this dest vertex! */
-          BKE_mesh_remap_item_define_invalid(r_map, i);
-        }
-      }
+    if (vcos_src) {
+      MEM_freeN(vcos_src);
     }
-    else if (ELEM(mode, MREMAP_MODE_VERT_EDGE_NEAREST, MREMAP_MODE_VERT_EDGEINTERP_NEAREST)) {
-      MEdge *edges_src = me_src->medge;
-      float(*vcos_src)[3] = BKE_mesh_vert_coords_alloc(me_src, NULL);
 
-      BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_EDGES, 2);
-      nearest.index = -1;
+    free_bvhtree_from_mesh(&treedata);
+  }
+}
 
-      for (i = 0; i < numverts_dst; i++) {
-        copy_v3_v3(tmp_co, verts_dst[i].co);
+/** Nearest source vertex of a destination vertex. */
+typedef struct MeshRemapVertHit {
+  float hit_dist;
+  int index;
+} MeshRemapVertHit;
+
+typedef struct MeshRemapEdgesData {
+  int mode;
+  const SpaceTransform *space_transform;
+  float max_dist;
+  float ray_radius;
+  BVHTreeFromMesh *treedata;
+
+  const MVert *verts_dst;
+  const MEdge *edges_dst;
+  const float (*vert_normals_dst)[3];
+  /** Used destination vertices, #MREMAP_MODE_EDGE_VERT_NEAREST only. */
+  const BLI_bitmap *verts_dst_used;
+  MeshRemapVertHit *v_dst_to_src_map;
+
+  const MEdge *edges_src;
+  int edges_src_num;
+  const MPoly *polys_src;
+  const MLoop *loops_src;
+  const MeshElemMap *vert_to_edge_src_map;
+  const float (*vcos_src)[3];
+} MeshRemapEdgesData;
+
+static void mesh_remap_edges_vert_hit_cb(void *__restrict userdata,
+                                         const int i,
+                                         const TaskParallelTLS *__restrict tls_v)
+{
+  const MeshRemapEdgesData *data = userdata;
+  MeshRemapTLS *tls = tls_v->userdata_chunk;
+  MeshRemapVertHit *v_hit = &data->v_dst_to_src_map[i];
+  float tmp_co[3];
+  float hit_dist;
 
-        /* Convert the vertex to tree coordinates, if needed. */
-        if (space_transform) {
-          BLI_space_transform_apply(space_transform, tmp_co);
-        }
+  if (!BLI_BITMAP_TEST(data->verts_dst_used, i)) {
+    return;
+  }
 
-        if (mesh_remap_bvhtree_query_nearest(
-                &treedata, &nearest, tmp_co, max_dist_sq, &hit_dist)) {
-          MEdge *me = &edges_src[nearest.index];
-          const float *v1cos = vcos_src[me->v1];
-          const float *v2cos = vcos_src[me->v2];
-
-          if (mode == MREMAP_MODE_VERT_EDGE_NEAREST) {
-            const float dist_v1 = len_squared_v3v3(tmp_co, v1cos);
-            const float dist_v2 = len_squared_v3v3(tmp_co, v2cos);
-            const int index = (int)((dist_v1 > dist_v2) ? me->v2 : me->v1);
-            mesh_remap_item_define(r_map, i, hit_dist, 0, 1, &index, &full_weight);
-          }
-          else if (mode == MREMAP_MODE_VERT_EDGEINTERP_NEAREST) {
-            int indices[2];
-            float weights[2];
+  copy_v3_v3(tmp_co, data->verts_dst[i].co);
+
+  /* Convert the vertex to tree coordinates, if needed. */
+  if (data->space_transform) {
+    BLI_space_transform_apply(data->space_transform, tmp_co);
+  }
+
+  if (mesh_remap_bvhtree_query_nearest(
+          data->treedata, &tls->nearest, tmp_co, data->max_dist * data->max_dist, &hit_dist)) {
+    v_hit->hit_dist = hit_dist;
+    v_hit->index = tls->nearest.index;
+  }
+  else {
+    /* No source for this dest vert! */
+    v_hit->hit_dist = FLT_MAX;
+    v_hit->index = -1;
+  }
+}
 
-            indices[0] = (int)me->v1;
-            indices[1] = (int)me->v2;
+static void mesh_remap_edges_vert_nearest_cb(void *__restrict userdata,
+                                             const int i,
+                                             const TaskParallelTLS *__restrict tls_v)
+{
+  const MeshRemapEdgesData *data = userdata;
+  MeshRemapTLS *tls = tls_v->userdata_chunk;
+  const float full_weight = 1.0f;
+  const MEdge *e_dst = &data->edges_dst[i];
+  const MVert *verts_dst = data->verts_dst;
+  const float(*vcos_src)[3] = data->vcos_src;
+  float best_totdist = FLT_MAX;
+  int best_eidx_src = -1;
+
+  /* Check all source edges of closest sources vertices,
+   * and select the one giving the smallest total verts-to-verts distance. */
+  for (int j = 2; j--;) {
+    const uint vidx_dst = j ? e_dst->v1 : e_dst->v2;
+    const float first_dist = data->v_dst_to_src_map[vidx_dst].hit_dist;
+    const int vidx_src = data->v_dst_to_src_map[vidx_dst].index;
+    const int *eidx_src;
+    int k;
+
+    if (vidx_src < 0) {
+      continue;
+    }
 
-            /* Weight is inverse of point factor here... */
-            weights[0] = line_point_factor_v3(tmp_co, v2cos, v1cos);
-            CLAMP(weights[0], 0.0f, 1.0f);
-            weights[1] = 1.0f - weights[0];
+    eidx_src = data->vert_to_edge_src_map[vidx_src].indices;
+    k = data->vert_to_edge_src_map[vidx_src].count;
 
-            mesh_remap_item_define(r_map, i, hit_dist, 0, 2, indices, weights);
-          }
-        }
-        else {
-          /* No source for this dest vertex! */
-          BKE_mesh_remap_item_define_invalid(r_map, i);
-        }
+    for (; k--; eidx_src++) {
+      const MEdge *e_src = &data->edges_src[*eidx_src];
+      const float *other_co_src = vcos_src[BKE_mesh_edge_other_vert(e_src, vidx_src)];
+      const float *other_co_dst = verts_dst[BKE_mesh_edge_other_vert(e_dst, (int)vidx_dst)].co;
+      const float totdist = first_dist + len_v3v3(other_co_src, other_co_dst);
+
+      if (totdist < best_totdist) {
+        best_totdist = totdist;
+        best_eidx_src = *eidx_src;
       }
+    }
+  }
 
-      MEM_freeN(vcos_src);
+  if (best_eidx_src >= 0) {
+    mesh_remap_tls_item_define(tls, i, 0, 1, &best_eidx_src, &full_weight);
+  }
+  else {
+    /* No source for this dest edge! */
+    BKE_mesh_remap_item_define_invalid(tls->r_map, i);
+  }
+}
+
+static void mesh_remap_edges_nearest_cb(void *__restrict userdata,
+                                        const int i,
+                                        const TaskParallelTLS *__restrict tls_v)
+{
+  const MeshRemapEdgesData *data = userdata;
+  MeshRemapTLS *tls = tls_v->userdata_chunk;
+  const float full_weight = 1.0f;
+  const MEdge *e_dst = &data->edges_dst[i];
+  float tmp_co[3];
+  float hit_dist;
+
+  interp_v3_v3v3(tmp_co, data->verts_dst[e_dst->v1].co, data->verts_dst[e_dst->v2].co, 0.5f);
+
+  /* Convert the vertex to tree coordinates, if needed. */
+  if (data->space_transform) {
+    BLI_space_transform_apply(data->space_transform, tmp_co);
+  }
+
+  if (!mesh_remap_bvhtree_query_nearest(
+          data->treedata, &tls->nearest, tmp_co, data->max_dist * data->max_dist, &hit_dist)) {
+    /* No source for this dest edge! */
+    BKE_mesh_remap_item_define_invalid(tls->r_map, i);
+    return;
+  }
+
+  if (data->mode == MREMAP_MODE_EDGE_NEAREST) {
+    mesh_remap_tls_item_define(tls, i, 0, 1, &tls->nearest.index, &full_weight);
+    return;
+  }
+
+  /* #MREMAP_MODE_EDGE_POLY_NEAREST, use the nearest edge of the nearest source poly. */
+  const MLoopTri *lt = &data->treedata->looptri[tls->nearest.index];
+  const MPoly *mp_src = &data->polys_src[lt->poly];
+  const MLoop *ml_src = &data->loops_src[mp_src->loopstart];
+  int nloops = mp_src->totloop;
+  float best_dist_sq = FLT_MAX;
+  int best_eidx_src = -1;
+
+  for (; nloops--; ml_src++) {
+    const MEdge *med_src = &data->edges_src[ml_src->e];
+    float co_src[3];
+    float dist_sq;
+
+    interp_v3_v3v3(co_src, data->vcos_src[med_src->v1], data->vcos_src[med_src->v2], 0.5f);
+    dist_sq = len_squared_v3v3(tmp_co, co_src);
+    if (dist_sq < best_dist_sq) {
+      best_dist_sq = dist_sq;
+      best_eidx_src = (int)ml_src->e;
     }
-    else if (ELEM(mode,
-                  MREMAP_MODE_VERT_POLY_NEAREST,
-                  MREMAP_MODE_VERT_POLYINTERP_NEAREST,
-                  MREMAP_MODE_VERT_POLYINTERP_VNORPROJ)) {
-      MPoly *polys_src = me_src->mpoly;
-      MLoop *loops_src = me_src->mloop;
-      float(*vcos_src)[3] = BKE_mesh_vert_coords_alloc(me_src, NULL);
-      const float(*vert_normals_dst)[3] = BKE_mesh_vertex_normals_ensure(me_dst);
+  }
+  if (best_eidx_src >= 0) {
+    mesh_remap_tls_item_define(tls, i, 0, 1, &best_eidx_src, &full_weight);
+  }
+}
 
-      size_t tmp_buff_size = MREMAP_DEFAULT_BUFSIZE;
-      float(*vcos)[3] = MEM_mallocN(sizeof(*vcos) * tmp_buff_size, __func__);
-      int *indices = MEM_mallocN(sizeof(*indices) * tmp_buff_size, __func__);
-      float *weights = MEM_mallocN(sizeof(*weights) * tmp_buff_size, __func__);
+static void mesh_remap_edges_vnorproj_cb(void *__restrict userdata,
+                                         const int i,
+                                         const TaskParallelTLS *__restrict tls_v)
+{
+  const MeshRemapEdgesData *data = userdata;
+  MeshRemapTLS *tls = tls_v->userdata_chunk;
+  const int num_rays_min = 5, num_rays_max = 100;
+  const int numedges_src = data->edges_src_num;
+  const float ray_radius = data->ray_radius;
+
+  /* For each dst edge, we sample some rays from it (interpolated from its vertices)
+   * and use their hits to interpolate from source edges. */
+  const MEdge *me = &data->edges_dst[i];
+  float v1_co[3], v2_co[3];
+  float v1_no[3], v2_no[3];
+  float tmp_co[3], tmp_no[3];
+  float hit_dist;
 
-      BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_LOOPTRI, 2);
+  int grid_size;
+  float edge_dst_len;
+  float grid_step;
+
+  float totweights = 0.0f;
+  int sources_num = 0;
+  int j;
+
+  /* Subtleness - this one we can allocate only max number of cast rays per edges!
+   * Here it's simpler to just allocate for all edges :/ */
+  mesh_remap_tls_src_ensure(
+      tls, (size_t)min_ii(numedges_src, num_rays_max), (size_t)numedges_src);
+  int *indices = tls->indices_src;
+  float *weights = tls->weights_src;
+
+  copy_v3_v3(v1_co, data->verts_dst[me->v1].co);
+  copy_v3_v3(v2_co, data->verts_dst[me->v2].co);
+
+  copy_v3_v3(v1_no, data->vert_normals_dst[me->v1]);
+  copy_v3_v3(v2_no, data->vert_normals_dst[me->v2]);
+
+  /* We do our transform here, allows to interpolate from normals already in src space. */
+  if (data->space_transform) {
+    BLI_space_transform_apply(data->space_transform, v1_co);
+    BLI_space_transform_apply(data->space_transform, v2_co);
+    BLI_space_transform_apply_normal(data->space_transform, v1_no);
+    BLI_space_transform_apply_normal(data->space_transform, v2_no);
+  }
 
-      if (mode == MREMAP_MODE_VERT_POLYINTERP_VNORPROJ) {
-        for (i = 0; i < numverts_dst; i++) {
-          copy_v3_v3(tmp_co, verts_dst[i].co);
-          copy_v3_v3(tmp_no, vert_normals_dst[i]);
+  copy_vn_fl(weights, (int)numedges_src, 0.0f);
 
-          /* Convert the vertex to tree coordinates, if needed. */
-          if (space_transform) {
-            BLI_space_transform_apply(space_transform, tmp_co);
-            BLI_space_transform_apply_normal(space_transform, tmp_no);
-          }
+  /* We adjust our ray-casting grid to ray_radius (the smaller, the more rays are cast),
+   * with lower/upper bounds. */
+  edge_dst_len = len_v3v3(v1_co, v2_co);
 
-          if (mesh_remap_bvhtree_query_raycast(
-                  &treedata, &rayhit, tmp_co, tmp_no, ray_radius, max_dist, &hit_dist)) {
-            const MLoopTri *lt = &treedata.looptri[rayhit.index];
-            MPoly *mp_src = &polys_src[lt->poly];
-            const int sources_num = mesh_remap_interp_poly_data_get(mp_src,
-                                                                    loops_src,
-                                                                    (const float(*)[3])vcos_src,
-                                                                    rayhit.co,
-                                                                    &tmp_buff_size,
-                                                                    &vcos,
-                                                                    false,
-                                                                    &indices,
-                                                                    &weights,
-                                                                    true,
-                                                                    NULL);
-
-            mesh_remap_item_define(r_map, i, hit_dist, 0, sources_num, indices, weights);
-          }
-          else {
-            /* No source for this dest vertex! */
-            BKE_mesh_remap_item_define_invalid(r_map, i);
-          }
-        }
-      }
-      else {
-        nearest.index = -1;
+  grid_size = (int)((edge_dst_len / ray_radius) + 0.5f);
+  CLAMP(grid_size, num_rays_min, num_rays_max); /* min 5 rays/edge, max 100. */
 
-        for (i = 0; i < numverts_dst; i++) {
-          copy_v3_v3(tmp_co, verts_dst[i].co);
+  grid_step = 1.0f / (float)grid_size; /* Not actual distance here, rather an interp fac... */
 
-          /* Convert the vertex to tree coordinates, if needed. */
-          if (space_transform) {
-            BLI_space_transform_apply(space_transform, tmp_co);
-          }
+  /* And now we can cast all our rays, and see what we get! */
+  for (j = 0; j < grid_size; j++) {
+    const float fac = grid_step * (float)j;
 
-          if (mesh_remap_bvhtree_query_nearest(
-                  &treedata, &nearest, tmp_co, max_dist_sq, &hit_dist)) {
-            const MLoopTri *lt = &treedata.looptri[nearest.index];
-            MPoly *mp = &polys_src[lt->poly];
-
-            if (mode == MREMAP_MODE_VERT_POLY_NEAREST) {
-              int index;
-              mesh_remap_interp_poly_data_get(mp,
-                                              loops_src,
-                                              (const float(*)[3])vcos_src,
-                                              nearest.co,
-                                              &tmp_buff_size,
-                                              &vcos,
-                                              false,
-                                              &indices,
-                                              &weights,
-                                              false,
-                                              &index);
+    int n = (ray_radius > 0.0f) ? MREMAP_RAYCAST_APPROXIMATE_NR : 1;
+    float w = 1.0f;
 
-              mesh_remap_item_define(r_map, i, hit_dist, 0, 1, &index, &full_weight);
-            }
-            else if (mode == MREMAP_MODE_VERT_POLYINTERP_NEAREST) {
-              const int sources_num = mesh_remap_interp_poly_data_get(mp,
-                                                                      loops_src,
-                                                                      (const float(*)[3])vcos_src,
-                                                                      nearest.co,
-                                                                      &tmp_buff_size,
-                                                                      &vcos,
-                                                                      false,
-                                                                      &indices,
-                                                                      &weights,
-                                                                      true,
-                                                                      NULL);
-
-              mesh_remap_item_define(r_map, i, hit_dist, 0, sources_num, indices, weights);
-            }
-          }
-          else {
-            /* No source for this dest vertex! */
-            BKE_mesh_remap_item_define_invalid(r_map, i);
-          }
-        }
-      }
+    interp_v3_v3v3(tmp_co, v1_co, v2_co, fac);
+    interp_v3_v3v3_slerp_safe(tmp_no, v1_no, v2_no, fac);
 
-      MEM_freeN(vcos_src);
-      MEM_freeN(vcos);
-      MEM_freeN(indices);
-      MEM_freeN(weights);
+    while (n--) {
+      if (mesh_remap_bvhtree_query_raycast(data->treedata,
+                                           &tls->rayhit,
+                                           tmp_co,
+                                           tmp_no,
+                                           ray_radius / w,
+                                           data->max_dist,
+                                           &hit_dist)) {
+        weights[tls->rayhit.index] += w;
+        totweights += w;
+        break;
+      }
+      /* Next iteration will get bigger radius but smaller weight! */
+      w /= MREMAP_RAYCAST_APPROXIMATE_FAC;
     }
-    else {
-      CLOG_WARN(&LOG, "Unsupported mesh-to-mesh vertex mapping mode (%d)!", mode);
-      memset(r_map->items, 0, sizeof(*r_map->items) * (size_t)numverts_dst);
+  }
+  /* A sampling is valid (as in, its result can be considered as valid sources)
+   * only if at least half of the rays found a source! */
+  if (totweights > ((float)grid_size / 2.0f)) {
+    for (j = 0; j < (int)numedges_src; j++) {
+      if (!weights[j]) {
+        continue;
+      }
+      /* NOTE: sources_num is always <= j! */
+      weights[sources_num] = weights[j] / totweights;
+      indices[sources_num] = j;
+      sources_num++;
     }
-
-    free_bvhtree_from_mesh(&treedata);
+    mesh_remap_tls_item_define(tls, i, 0, sources_num, indices, weights);
+  }
+  else {
+    /* No source for this dest edge! */
+    BKE_mesh_remap_item_define_invalid(tls->r_map, i);
   }
 }
 
@@ -708,7 +1142,6 @@ void BKE_mesh_remap_calc_edges_from_mesh(const int mode,
                                          MeshPairRemap *r_map)
 {
   const float full_weight = 1.0f;
-  const float max_dist_sq = max_dist * max_dist;
   int i;
 
   BLI_assert(mode & MREMAP_MODE_EDGE);
@@ -723,312 +1156,85 @@ void BKE_mesh_remap_calc_edges_from_mesh(const int mode,
   }
   else {
     BVHTreeFromMesh treedata = {NULL};
-    BVHTreeNearest nearest = {0};
-    BVHTreeRayHit rayhit = {0};
-    float hit_dist;
-    float tmp_co[3], tmp_no[3];
+    MeshRemapEdgesData data = {
+        .mode = mode,
+        .space_transform = space_transform,
+        .max_dist = max_dist,
+        .ray_radius = ray_radius,
+        .treedata = &treedata,
+        .verts_dst = verts_dst,
+        .edges_dst = edges_dst,
+        .edges_src = me_src->medge,
+        .edges_src_num = me_src->totedge,
+    };
 
     if (mode == MREMAP_MODE_EDGE_VERT_NEAREST) {
       const int num_verts_src = me_src->totvert;
       const int num_edges_src = me_src->totedge;
-      MEdge *edges_src = me_src->medge;
       float(*vcos_src)[3] = BKE_mesh_vert_coords_alloc(me_src, NULL);
 
       MeshElemMap *vert_to_edge_src_map;
       int *vert_to_edge_src_map_mem;
 
-      struct {
-        float hit_dist;
-        int index;
-      } *v_dst_to_src_map = MEM_mallocN(sizeof(*v_dst_to_src_map) * (size_t)numverts_dst,
-                                        __func__);
+      MeshRemapVertHit *v_dst_to_src_map = MEM_mallocN(
+          sizeof(*v_dst_to_src_map) * (size_t)numverts_dst, __func__);
+      BLI_bitmap *verts_dst_used = BLI_BITMAP_NEW(numverts_dst, __func__);
 
+      /* Compute closest verts only once, and only for the used ones! */
       for (i = 0; i < numverts_dst; i++) {
         v_dst_to_src_map[i].hit_dist = -1.0f;
+        v_dst_to_src_map[i].index = -1;
+      }
+      for (i = 0; i < numedges_dst; i++) {
+        BLI_BITMAP_ENABLE(verts_dst_used, edges_dst[i].v1);
+        BLI_BITMAP_ENABLE(verts_dst_used, edges_dst[i].v2);
       }
 
       BKE_mesh_vert_edge_map_create(&vert_to_edge_src_map,
                                     &vert_to_edge_src_map_mem,
-                                    edges_src,
+                                    me_src->medge,
                                     num_verts_src,
                                     num_edges_src);
 
       BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_VERTS, 2);
-      nearest.index = -1;
-
-      for (i = 0; i < numedges_dst; i++) {
-        const MEdge *e_dst = &edges_dst[i];
-        float best_totdist = FLT_MAX;
-        int best_eidx_src = -1;
-        int j = 2;
-
-        while (j--) {
-          const uint vidx_dst = j ? e_dst->v1 : e_dst->v2;
 
-          /* Compute closest verts only once! */
-          if (v_dst_to_src_map[vidx_dst].hit_dist == -1.0f) {
-            copy_v3_v3(tmp_co, verts_dst[vidx_dst].co);
+      data.verts_dst_used = verts_dst_used;
+      data.v_dst_to_src_map = v_dst_to_src_map;
+      data.vert_to_edge_src_map = vert_to_edge_src_map;
+      data.vcos_src = (const float(*)[3])vcos_src;
+      mesh_remap_parallel_range(r_map, numverts_dst, 256, &data, mesh_remap_edges_vert_hit_cb);
+      mesh_remap_parallel_range(
+          r_map, numedges_dst, 256, &data, mesh_remap_edges_vert_nearest_cb);
 
-            /* Convert the vertex to tree coordinates, if needed. */
-            if (space_transform) {
-              BLI_space_transform_apply(space_transform, tmp_co);
-            }
-
-            if (mesh_remap_bvhtree_query_nearest(
-                    &treedata, &nearest, tmp_co, max_dist_sq, &hit_dist)) {
-              v_dst_to_src_map[vidx_dst].hit_dist = hit_dist;
-              v_dst_to_src_map[vidx_dst].index = nearest.index;
-            }
-            else {
-              /* No source for this dest vert! */
-              v_dst_to_src_map[vidx_dst].hit_dist = FLT_MAX;
-            }
-          }
-        }
+      MEM_freeN(vcos_src);
+      MEM_freeN(v_dst_to_src_map);
+      MEM_freeN(verts_dst_used);
+      MEM_freeN(vert_to_edge_src_map);
+      MEM_freeN(vert_to_edge_src_map_mem);
+    }
+    else if (mode == MREMAP_MODE_EDGE_NEAREST) {
+      BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_EDGES, 2);
 
-        /* Now, check all source edges of closest sources vertices,
-         * and select the one giving the smallest total verts-to-verts distance. */
-        for (j = 2; j--;) {
-          const uint vidx_dst = j ? e_dst->v1 : e_dst->v2;
-          const float first_dist = v_dst_to_src_map[vidx_dst].hit_dist;
-          const int vidx_src = v_dst_to_src_map[vidx_dst].index;
-          int *eidx_src, k;
+      mesh_remap_parallel_range(r_map, numedges_dst, 256, &data, mesh_remap_edges_nearest_cb);
+    }
+    else if (mode == MREMAP_MODE_EDGE_POLY_NEAREST) {
+      float(*vcos_src)[3] = BKE_mesh_vert_coords_alloc(me_src, NULL);
 
-          if (vidx_src < 0) {
-            continue;
-          }
+      BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_LOOPTRI, 2);
 
-          eidx_src = vert_to_edge_src_map[vidx_src].indices;
-          k = vert_to_edge_src_map[vidx_src].count;
+      data.polys_src = me_src->mpoly;
+      data.loops_src = me_src->mloop;
+      data.vcos_src = (const float(*)[3])vcos_src;
+      mesh_remap_parallel_range(r_map, numedges_dst, 256, &data, mesh_remap_edges_nearest_cb);
 
-          for (; k--; eidx_src++) {
-            MEdge *e_src = &edges_src[*eidx_src];
-            const float *other_co_src = vcos_src[BKE_mesh_edge_other_vert(e_src, vidx_src)];
-            const float *other_co_dst =
-                verts_dst[BKE_mesh_edge_other_vert(e_dst, (int)vidx_dst)].co;
-            const float totdist = first_dist + len_v3v3(other_co_src, other_co_dst);
+      MEM_freeN(vcos_src);
+    }
+    else if (mode == MREMAP_MODE_EDGE_EDGEINTERP_VNORPROJ) {
+      BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_EDGES, 2);
 
-            if (totdist < best_totdist) {
-              best_totdist = totdist;
-              best_eidx_src = *eidx_src;
-            }
-          }
-        }
-
-        if (best_eidx_src >= 0) {
-          const float *co1_src = vcos_src[edges_src[best_eidx_src].v1];
-          const float *co2_src = vcos_src[edges_src[best_eidx_src].v2];
-          const float *co1_dst = verts_dst[e_dst->v1].co;
-          const float *co2_dst = verts_dst[e_dst->v2].co;
-          float co_src[3], co_dst[3];
-
-          /* TODO: would need an isect_seg_seg_v3(), actually! */
-          const int isect_type = isect_line_line_v3(
-              co1_src, co2_src, co1_dst, co2_dst, co_src, co_dst);
-          if (isect_type != 0) {
-            const float fac_src = line_point_factor_v3(co_src, co1_src, co2_src);
-            const float fac_dst = line_point_factor_v3(co_dst, co1_dst, co2_dst);
-            if (fac_src < 0.0f) {
-              copy_v3_v3(co_src, co1_src);
-            }
-            else if (fac_src > 1.0f) {
-              copy_v3_v3(co_src, co2_src);
-            }
-            if (fac_dst < 0.0f) {
-              copy_v3_v3(co_dst, co1_dst);
-            }
-            else if (fac_dst > 1.0f) {
-              copy_v3_v3(co_dst, co2_dst);
-            }
-          }
-          hit_dist = len_v3v3(co_dst, co_src);
-          mesh_remap_item_define(r_map, i, hit_dist, 0, 1, &best_eidx_src, &full_weight);
-        }
-        else {
-          /* No source for this dest edge! */
-          BKE_mesh_remap_item_define_invalid(r_map, i);
-        }
-      }
-
-      MEM_freeN(vcos_src);
-      MEM_freeN(v_dst_to_src_map);
-      MEM_freeN(vert_to_edge_src_map);
-      MEM_freeN(vert_to_edge_src_map_mem);
-    }
-    else if (mode == MREMAP_MODE_EDGE_NEAREST) {
-      BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_EDGES, 2);
-      nearest.index = -1;
-
-      for (i = 0; i < numedges_dst; i++) {
-        interp_v3_v3v3(tmp_co, verts_dst[edges_dst[i].v1].co, verts_dst[edges_dst[i].v2].co, 0.5f);
-
-        /* Convert the vertex to tree coordinates, if needed. */
-        if (space_transform) {
-          BLI_space_transform_apply(space_transform, tmp_co);
-        }
-
-        if (mesh_remap_bvhtree_query_nearest(
-                &treedata, &nearest, tmp_co, max_dist_sq, &hit_dist)) {
-          mesh_remap_item_define(r_map, i, hit_dist, 0, 1, &nearest.index, &full_weight);
-        }
-        else {
-          /* No source for this dest edge! */
-          BKE_mesh_remap_item_define_invalid(r_map, i);
-        }
-      }
-    }
-    else if (mode == MREMAP_MODE_EDGE_POLY_NEAREST) {
-      MEdge *edges_src = me_src->medge;
-      MPoly *polys_src = me_src->mpoly;
-      MLoop *loops_src = me_src->mloop;
-      float(*vcos_src)[3] = BKE_mesh_vert_coords_alloc(me_src, NULL);
-
-      BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_LOOPTRI, 2);
-
-      for (i = 0; i < numedges_dst; i++) {
-        interp_v3_v3v3(tmp_co, verts_dst[edges_dst[i].v1].co, verts_dst[edges_dst[i].v2].co, 0.5f);
-
-        /* Convert the vertex to tree coordinates, if needed. */
-        if (space_transform) {
-          BLI_space_transform_apply(space_transform, tmp_co);
-        }
-
-        if (mesh_remap_bvhtree_query_nearest(
-                &treedata, &nearest, tmp_co, max_dist_sq, &hit_dist)) {
-          const MLoopTri *lt = &treedata.looptri[nearest.index];
-          MPoly *mp_src = &polys_src[lt->poly];
-          MLoop *ml_src = &loops_src[mp_src->loopstart];
-          int nloops = mp_src->totloop;
-          float best_dist_sq = FLT_MAX;
-          int best_eidx_src = -1;
-
-          for (; nloops--; ml_src++) {
-            MEdge *med_src = &edges_src[ml_src->e];
-            float *co1_src = vcos_src[med_src->v1];
-            float *co2_src = vcos_src[med_src->v2];
-            float co_src[3];
-            float dist_sq;
-
-            interp_v3_v3v3(co_src, co1_src, co2_src, 0.5f);
-            dist_sq = len_squared_v3v3(tmp_co, co_src);
-            if (dist_sq < best_dist_sq) {
-              best_dist_sq = dist_sq;
-              best_eidx_src = (int)ml_src->e;
-            }
-          }
-          if (best_eidx_src >= 0) {
-            mesh_remap_item_define(r_map, i, hit_dist, 0, 1, &best_eidx_src, &full_weight);
-          }
-        }
-        else {
-          /* No source for this dest edge! */
-          BKE_mesh_remap_item_define_invalid(r_map, i);
-        }
-      }
-
-      MEM_freeN(vcos_src);
-    }
-    else if (mode == MREMAP_MODE_EDGE_EDGEINTERP_VNORPROJ) {
-      const int num_rays_min = 5, num_rays_max = 100;
-      const int numedges_src = me_src->totedge;
-
-      /* Subtleness - this one we can allocate only max number of cast rays per edges! */
-      int *indices = MEM_mallocN(sizeof(*indices) * (size_t)min_ii(numedges_src, num_rays_max),
-                                 __func__);
-      /* Here it's simpler to just allocate for all edges :/ */
-      float *weights = MEM_mallocN(sizeof(*weights) * (size_t)numedges_src, __func__);
-
-      BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_EDGES, 2);
-
-      const float(*vert_normals_dst)[3] = BKE_mesh_vertex_normals_ensure(me_dst);
-
-      for (i = 0; i < numedges_dst; i++) {
-        /* For each dst edge, we sample some rays from it (interpolated from its vertices)
-         * and use their hits to interpolate from source edges. */
-        const MEdge *me = &edges_dst[i];
-        float v1_co[3], v2_co[3];
-        float v1_no[3], v2_no[3];
-
-        int grid_size;
-        float edge_dst_len;
-        float grid_step;
-
-        float totweights = 0.0f;
-        float hit_dist_accum = 0.0f;
-        int sources_num = 0;
-        int j;
-
-        copy_v3_v3(v1_co, verts_dst[me->v1].co);
-        copy_v3_v3(v2_co, verts_dst[me->v2].co);
-
-        copy_v3_v3(v1_no, vert_normals_dst[me->v1]);
-        copy_v3_v3(v2_no, vert_normals_dst[me->v2]);
-
-        /* We do our transform here, allows to interpolate from normals already in src space. */
-        if (space_transform) {
-          BLI_space_transform_apply(space_transform, v1_co);
-          BLI_space_transform_apply(space_transform, v2_co);
-          BLI_space_transform_apply_normal(space_transform, v1_no);
-          BLI_space_transform_apply_normal(space_transform, v2_no);
-        }
-
-        copy_vn_fl(weights, (int)numedges_src, 0.0f);
-
-        /* We adjust our ray-casting grid to ray_radius (the smaller, the more rays are cast),
-         * with lower/upper bounds. */
-        edge_dst_len = len_v3v3(v1_co, v2_co);
-
-        grid_size = (int)((edge_dst_len / ray_radius) + 0.5f);
-        CLAMP(grid_size, num_rays_min, num_rays_max); /* min 5 rays/edge, max 100. */
-
-        grid_step = 1.0f /
-                    (float)grid_size; /* Not actual distance here, rather an interp fac... */
-
-        /* And now we can cast all our rays, and see what we get! */
-        for (j = 0; j < grid_size; j++) {
-          const float fac = grid_step * (float)j;
-
-          int n = (ray_radius > 0.0f) ? MREMAP_RAYCAST_APPROXIMATE_NR : 1;
-          float w = 1.0f;
-
-          interp_v3_v3v3(tmp_co, v1_co, v2_co, fac);
-          interp_v3_v3v3_slerp_safe(tmp_no, v1_no, v2_no, fac);
-
-          while (n--) {
-            if (mesh_remap_bvhtree_query_raycast(
-                    &treedata, &rayhit, tmp_co, tmp_no, ray_radius / w, max_dist, &hit_dist)) {
-              weights[rayhit.index] += w;
-              totweights += w;
-              hit_dist_accum += hit_dist;
-              break;
-            }
-            /* Next iteration will get bigger radius but smaller weight! */
-            w /= MREMAP_RAYCAST_APPROXIMATE_FAC;
-          }
-        }
-        /* A sampling is valid (as in, its result can be considered as valid sources)
-         * only if at least half of the rays found a source! */
-        if (totweights > ((float)grid_size / 2.0f)) {
-          for (j = 0; j < (int)numedges_src; j++) {
-            if (!weights[j]) {
-              continue;
-            }
-            /* NOTE: sources_num is always <= j! */
-            weights[sources_num] = weights[j] / totweights;
-            indices[sources_num] = j;
-            sources_num++;
-          }
-          mesh_remap_item_define(
-              r_map, i, hit_dist_accum / totweights, 0, sources_num, indices, weights);
-        }
-        else {
-          /* No source for this dest edge! */
-          BKE_mesh_remap_item_define_invalid(r_map, i);
-        }
-      }
-
-      MEM_freeN(indices);
-      MEM_freeN(weights);
+      data.vert_normals_dst = BKE_mesh_vertex_normals_ensure(me_dst);
+      /* Every edge casts up to a hundred rays, use smaller tasks. */
+      mesh_remap_parallel_range(r_map, numedges_dst, 16, &data, mesh_remap_edges_vnorproj_cb);
     }
     else {
       CLOG_WARN(&LOG, "Unsupported mesh-to-mesh edge mapping mode (%d)!", mode);
@@ -1229,159 +1435,742 @@ static float mesh_remap_calc_loops_astar_f_cost(BLI_AStarGraph *as_graph,
 
 #define ASTAR_STEPS_MAX 64
 
-void BKE_mesh_remap_calc_loops_from_mesh(const int mode,
-                                         const SpaceTransform *space_transform,
-                                         const float max_dist,
-                                         const float ray_radius,
-                                         Mesh *mesh_dst,
-                                         MVert *verts_dst,
-                                         const int numverts_dst,
-                                         MEdge *edges_dst,
-                                         const int numedges_dst,
-                                         MLoop *loops_dst,
-                                         const int numloops_dst,
-                                         MPoly *polys_dst,
-                                         const int numpolys_dst,
-                                         CustomData *ldata_dst,
-                                         const bool use_split_nors_dst,
-                                         const float split_angle_dst,
-                                         const bool dirty_nors_dst,
-                                         Mesh *me_src,
-                                         MeshRemapIslandsCalc gen_islands_src,
-                                         const float islands_precision_src,
-                                         MeshPairRemap *r_map)
+typedef struct MeshRemapLoopsData {
+  int mode;
+  const SpaceTransform *space_transform;
+  float max_dist;
+  float ray_radius;
+
+  /** One tree (and one AStar graph) per source island. */
+  BVHTreeFromMesh *treedata;
+  BLI_AStarGraph *as_graphdata;
+  int num_trees;
+  const MeshIslandStore *island_store;
+  bool use_islands;
+  bool use_from_vert;
+  int isld_steps_src;
+
+  MVert *verts_dst;
+  MLoop *loops_dst;
+  MPoly *polys_dst;
+  const float (*poly_nors_dst)[3];
+  float (*loop_nors_dst)[3];
+
+  MVert *verts_src;
+  MLoop *loops_src;
+  MPoly *polys_src;
+  float (*vcos_src)[3];
+  const float (*poly_nors_src)[3];
+  const float (*loop_nors_src)[3];
+  float (*poly_cents_src)[3];
+  const MLoopTri *looptri_src;
+  MeshElemMap *vert_to_loop_map_src;
+  MeshElemMap *vert_to_poly_map_src;
+  MeshElemMap *poly_to_looptri_map_src;
+  int *loop_to_poly_map_src;
+} MeshRemapLoopsData;
+
+/**
+ * Map all loops of a destination poly, first against every source island, then selecting the
+ * best island and walking its AStar graph to keep all loops on the same side of its inner cuts.
+ */
+static void mesh_remap_loops_poly_cb(void *__restrict userdata,
+                                     const int pidx_dst,
+                                     const TaskParallelTLS *__restrict tls_v)
 {
+  const MeshRemapLoopsData *data = userdata;
+  MeshRemapTLS *tls = tls_v->userdata_chunk;
   const float full_weight = 1.0f;
+
+  const int mode = data->mode;
+  const SpaceTransform *space_transform = data->space_transform;
+  const float max_dist = data->max_dist;
   const float max_dist_sq = max_dist * max_dist;
+  const float ray_radius = data->ray_radius;
+
+  BVHTreeFromMesh *treedata = data->treedata;
+  BLI_AStarGraph *as_graphdata = data->as_graphdata;
+  BLI_AStarSolution *as_solution = &tls->as_solution;
+  const int num_trees = data->num_trees;
+  const MeshIslandStore *island_store = data->island_store;
+  const bool use_islands = data->use_islands;
+  const bool use_from_vert = data->use_from_vert;
+  const int isld_steps_src = data->isld_steps_src;
+
+  MVert *verts_dst = data->verts_dst;
+  MLoop *loops_dst = data->loops_dst;
+  const float(*poly_nors_dst)[3] = data->poly_nors_dst;
+  float(*loop_nors_dst)[3] = data->loop_nors_dst;
+
+  MVert *verts_src = data->verts_src;
+  MLoop *loops_src = data->loops_src;
+  MPoly *polys_src = data->polys_src;
+  float(*vcos_src)[3] = data->vcos_src;
+  const float(*poly_nors_src)[3] = data->poly_nors_src;
+  const float(*loop_nors_src)[3] = data->loop_nors_src;
+  float(*poly_cents_src)[3] = data->poly_cents_src;
+  const MLoopTri *looptri_src = data->looptri_src;
+  MeshElemMap *vert_to_loop_map_src = data->vert_to_loop_map_src;
+  MeshElemMap *vert_to_poly_map_src = data->vert_to_poly_map_src;
+  MeshElemMap *poly_to_looptri_map_src = data->poly_to_looptri_map_src;
+  int *loop_to_poly_map_src = data->loop_to_poly_map_src;
+
+  IslandResult **islands_res;
+  float hit_dist;
+  float tmp_co[3], tmp_no[3];
 
+  MLoop *ml_src, *ml_dst;
+  MPoly *mp_src;
+  const MPoly *mp_dst = &data->polys_dst[pidx_dst];
+  int tindex, lidx_dst, plidx_dst, pidx_src, lidx_src, plidx_src;
   int i;
 
-  BLI_assert(mode & MREMAP_MODE_LOOP);
-  BLI_assert((islands_precision_src >= 0.0f) && (islands_precision_src <= 1.0f));
+  float pnor_dst[3];
 
-  BKE_mesh_remap_init(r_map, numloops_dst);
+  /* Only in use_from_vert case, we may need polys' centers as fallback
+   * in case we cannot decide which corner to use from normals only. */
+  float pcent_dst[3];
+  bool pcent_dst_valid = false;
 
-  if (mode == MREMAP_MODE_TOPOLOGY) {
-    /* In topology mapping, we assume meshes are identical, islands included! */
-    BLI_assert(numloops_dst == me_src->totloop);
-    for (i = 0; i < numloops_dst; i++) {
-      mesh_remap_item_define(r_map, i, FLT_MAX, 0, 1, &i, &full_weight);
+  if (mode == MREMAP_MODE_LOOP_NEAREST_POLYNOR) {
+    copy_v3_v3(pnor_dst, poly_nors_dst[pidx_dst]);
+    if (space_transform) {
+      BLI_space_transform_apply_normal(space_transform, pnor_dst);
     }
   }
-  else {
-    BVHTreeFromMesh *treedata = NULL;
-    BVHTreeNearest nearest = {0};
-    BVHTreeRayHit rayhit = {0};
-    int num_trees = 0;
-    float hit_dist;
-    float tmp_co[3], tmp_no[3];
 
-    const bool use_from_vert = (mode & MREMAP_USE_VERT);
+  if (tls->islands_res == NULL) {
+    tls->islands_res_num = num_trees;
+    tls->islands_res_buff_size = MREMAP_DEFAULT_BUFSIZE;
+    tls->islands_res = MEM_mallocN(sizeof(*tls->islands_res) * (size_t)num_trees, __func__);
+    for (tindex = 0; tindex < num_trees; tindex++) {
+      tls->islands_res[tindex] = MEM_mallocN(
+          sizeof(**tls->islands_res) * tls->islands_res_buff_size, __func__);
+    }
+  }
+  if ((size_t)mp_dst->totloop > tls->islands_res_buff_size) {
+    tls->islands_res_buff_size = (size_t)mp_dst->totloop + MREMAP_DEFAULT_BUFSIZE;
+    for (tindex = 0; tindex < num_trees; tindex++) {
+      tls->islands_res[tindex] = MEM_reallocN(
+          tls->islands_res[tindex], sizeof(**tls->islands_res) * tls->islands_res_buff_size);
+    }
+  }
+  islands_res = tls->islands_res;
+  if (!use_from_vert) {
+    mesh_remap_tls_interp_ensure(tls);
+  }
 
-    MeshIslandStore island_store = {0};
-    bool use_islands = false;
+  for (tindex = 0; tindex < num_trees; tindex++) {
+    BVHTreeFromMesh *tdata = &treedata[tindex];
 
-    BLI_AStarGraph *as_graphdata = NULL;
-    BLI_AStarSolution as_solution = {0};
-    const int isld_steps_src = (islands_precision_src ?
-                                    max_ii((int)(ASTAR_STEPS_MAX * islands_precision_src + 0.499f),
-                                           1) :
-                                    0);
+    ml_dst = &loops_dst[mp_dst->loopstart];
+    for (plidx_dst = 0; plidx_dst < mp_dst->totloop; plidx_dst++, ml_dst++) {
+      if (use_from_vert) {
+        MeshElemMap *vert_to_refelem_map_src = NULL;
 
-    const float(*poly_nors_src)[3] = NULL;
-    const float(*loop_nors_src)[3] = NULL;
-    const float(*poly_nors_dst)[3] = NULL;
-    float(*loop_nors_dst)[3] = NULL;
+        copy_v3_v3(tmp_co, verts_dst[ml_dst->v].co);
+        tls->nearest.index = -1;
 
-    float(*poly_cents_src)[3] = NULL;
+        /* Convert the vertex to tree coordinates, if needed. */
+        if (space_transform) {
+          BLI_space_transform_apply(space_transform, tmp_co);
+        }
 
-    MeshElemMap *vert_to_loop_map_src = NULL;
-    int *vert_to_loop_map_src_buff = NULL;
-    MeshElemMap *vert_to_poly_map_src = NULL;
-    int *vert_to_poly_map_src_buff = NULL;
-    MeshElemMap *edge_to_poly_map_src = NULL;
-    int *edge_to_poly_map_src_buff = NULL;
-    MeshElemMap *poly_to_looptri_map_src = NULL;
-    int *poly_to_looptri_map_src_buff = NULL;
+        if (mesh_remap_bvhtree_query_nearest(
+                tdata, &tls->nearest, tmp_co, max_dist_sq, &hit_dist)) {
+          float(*nor_dst)[3];
+          const float(*nors_src)[3];
+          float best_nor_dot = -2.0f;
+          float best_sqdist_fallback = FLT_MAX;
+          int best_index_src = -1;
+
+          if (mode == MREMAP_MODE_LOOP_NEAREST_LOOPNOR) {
+            copy_v3_v3(tmp_no, loop_nors_dst[plidx_dst + mp_dst->loopstart]);
+            if (space_transform) {
+              BLI_space_transform_apply_normal(space_transform, tmp_no);
+            }
+            nor_dst = &tmp_no;
+            nors_src = loop_nors_src;
+            vert_to_refelem_map_src = vert_to_loop_map_src;
+          }
+          else { /* if (mode == MREMAP_MODE_LOOP_NEAREST_POLYNOR) { */
+            nor_dst = &pnor_dst;
+            nors_src = poly_nors_src;
+            vert_to_refelem_map_src = vert_to_poly_map_src;
+          }
 
-    /* Unlike above, those are one-to-one mappings, simpler! */
-    int *loop_to_poly_map_src = NULL;
+          for (i = vert_to_refelem_map_src[tls->nearest.index].count; i--;) {
+            const int index_src = vert_to_refelem_map_src[tls->nearest.index].indices[i];
+            BLI_assert(index_src != -1);
+            const float dot = dot_v3v3(nors_src[index_src], *nor_dst);
+
+            pidx_src = ((mode == MREMAP_MODE_LOOP_NEAREST_LOOPNOR) ?
+                            loop_to_poly_map_src[index_src] :
+                            index_src);
+            /* WARNING! This is not the *real* lidx_src in case of POLYNOR, we only use it
+             *          to check we stay on current island (all loops from a given poly are
+             *          on same island!). */
+            lidx_src = ((mode == MREMAP_MODE_LOOP_NEAREST_LOOPNOR) ?
+                            index_src :
+                            polys_src[pidx_src].loopstart);
+
+            /* A same vert may be at the boundary of several islands! Hence, we have to ensure
+             * poly/loop we are currently considering *belongs* to current island! */
+            if (use_islands && island_store->items_to_islands[lidx_src] != tindex) {
+              continue;
+            }
 
-    MVert *verts_src = me_src->mvert;
-    const int num_verts_src = me_src->totvert;
-    float(*vcos_src)[3] = NULL;
-    MEdge *edges_src = me_src->medge;
-    const int num_edges_src = me_src->totedge;
-    MLoop *loops_src = me_src->mloop;
-    const int num_loops_src = me_src->totloop;
-    MPoly *polys_src = me_src->mpoly;
-    const int num_polys_src = me_src->totpoly;
-    const MLoopTri *looptri_src = NULL;
-    int num_looptri_src = 0;
+            if (dot > best_nor_dot - 1e-6f) {
+              /* We need something as fallback decision in case dest normal matches several
+               * source normals (see T44522), using distance between polys' centers here. */
+              float *pcent_src;
+              float sqdist;
 
-    size_t buff_size_interp = MREMAP_DEFAULT_BUFSIZE;
-    float(*vcos_interp)[3] = NULL;
-    int *indices_interp = NULL;
-    float *weights_interp = NULL;
+              mp_src = &polys_src[pidx_src];
+              ml_src = &loops_src[mp_src->loopstart];
+
+              if (!pcent_dst_valid) {
+                BKE_mesh_calc_poly_center(
+                    mp_dst, &loops_dst[mp_dst->loopstart], verts_dst, pcent_dst);
+                pcent_dst_valid = true;
+              }
+              pcent_src = poly_cents_src[pidx_src];
+              sqdist = len_squared_v3v3(pcent_dst, pcent_src);
 
-    MLoop *ml_src, *ml_dst;
-    MPoly *mp_src, *mp_dst;
-    int tindex, pidx_dst, lidx_dst, plidx_dst, pidx_src, lidx_src, plidx_src;
+              if ((dot > best_nor_dot + 1e-6f) || (sqdist < best_sqdist_fallback)) {
+                best_nor_dot = dot;
+                best_sqdist_fallback = sqdist;
+                best_index_src = index_src;
+              }
+            }
+          }
+          if (best_index_src == -1) {
+            /* We found no item to map back from closest vertex... */
+            best_nor_dot = -1.0f;
+            hit_dist = FLT_MAX;
+          }
+          else if (mode == MREMAP_MODE_LOOP_NEAREST_POLYNOR) {
+            /* Our best_index_src is a poly one for now!
+             * Have to find its loop matching our closest vertex. */
+            mp_src = &polys_src[best_index_src];
+            ml_src = &loops_src[mp_src->loopstart];
+            for (plidx_src = 0; plidx_src < mp_src->totloop; plidx_src++, ml_src++) {
+              if ((int)ml_src->v == tls->nearest.index) {
+                best_index_src = plidx_src + mp_src->loopstart;
+                break;
+              }
+            }
+          }
+          best_nor_dot = (best_nor_dot + 1.0f) * 0.5f;
+          islands_res[tindex][plidx_dst].factor = hit_dist ? (best_nor_dot / hit_dist) : 1e18f;
+          islands_res[tindex][plidx_dst].hit_dist = hit_dist;
+          islands_res[tindex][plidx_dst].index_src = best_index_src;
+        }
+        else {
+          /* No source for this dest loop! */
+          islands_res[tindex][plidx_dst].factor = 0.0f;
+          islands_res[tindex][plidx_dst].hit_dist = FLT_MAX;
+          islands_res[tindex][plidx_dst].index_src = -1;
+        }
+      }
+      else if (mode & MREMAP_USE_NORPROJ) {
+        int n = (ray_radius > 0.0f) ? MREMAP_RAYCAST_APPROXIMATE_NR : 1;
+        float w = 1.0f;
 
-    IslandResult **islands_res;
-    size_t islands_res_buff_size = MREMAP_DEFAULT_BUFSIZE;
+        copy_v3_v3(tmp_co, verts_dst[ml_dst->v].co);
+        copy_v3_v3(tmp_no, loop_nors_dst[plidx_dst + mp_dst->loopstart]);
 
-    if (!use_from_vert) {
-      vcos_src = BKE_mesh_vert_coords_alloc(me_src, NULL);
+        /* We do our transform here, since we may do several raycast/nearest queries. */
+        if (space_transform) {
+          BLI_space_transform_apply(space_transform, tmp_co);
+          BLI_space_transform_apply_normal(space_transform, tmp_no);
+        }
 
-      vcos_interp = MEM_mallocN(sizeof(*vcos_interp) * buff_size_interp, __func__);
-      indices_interp = MEM_mallocN(sizeof(*indices_interp) * buff_size_interp, __func__);
-      weights_interp = MEM_mallocN(sizeof(*weights_interp) * buff_size_interp, __func__);
-    }
+        while (n--) {
+          if (mesh_remap_bvhtree_query_raycast(
+                  tdata, &tls->rayhit, tmp_co, tmp_no, ray_radius / w, max_dist, &hit_dist)) {
+            islands_res[tindex][plidx_dst].factor = (hit_dist ? (1.0f / hit_dist) : 1e18f) * w;
+            islands_res[tindex][plidx_dst].hit_dist = hit_dist;
+            islands_res[tindex][plidx_dst].index_src = (int)tdata->looptri[tls->rayhit.index].poly;
+            copy_v3_v3(islands_res[tindex][plidx_dst].hit_point, tls->rayhit.co);
+            break;
+          }
+          /* Next iteration will get bigger radius but smaller weight! */
+          w /= MREMAP_RAYCAST_APPROXIMATE_FAC;
+        }
+        if (n == -1) {
+          /* Fallback to 'nearest' hit here, loops usually comes in 'face group', not good to
+           * have only part of one dest face's loops to map to source.
+           * Note that since we give this a null weight, if whole weight for a given face
+           * is null, it means none of its loop mapped to this source island,
+           * hence we can skip it later.
+           */
+          copy_v3_v3(tmp_co, verts_dst[ml_dst->v].co);
+          tls->nearest.index = -1;
 
-    {
-      const bool need_lnors_src = (mode & MREMAP_USE_LOOP) && (mode & MREMAP_USE_NORMAL);
-      const bool need_lnors_dst = need_lnors_src || (mode & MREMAP_USE_NORPROJ);
-      const bool need_pnors_src = need_lnors_src ||
-                                  ((mode & MREMAP_USE_POLY) && (mode & MREMAP_USE_NORMAL));
-      const bool need_pnors_dst = need_lnors_dst || need_pnors_src;
+          /* Convert the vertex to tree coordinates, if needed. */
+          if (space_transform) {
+            BLI_space_transform_apply(space_transform, tmp_co);
+          }
 
-      if (need_pnors_dst) {
-        poly_nors_dst = BKE_mesh_poly_normals_ensure(mesh_dst);
-      }
-      if (need_lnors_dst) {
-        short(*custom_nors_dst)[2] = CustomData_get_layer(ldata_dst, CD_CUSTOMLOOPNORMAL);
+          /* In any case, this fallback nearest hit should have no weight at all
+           * in 'best island' decision! */
+          islands_res[tindex][plidx_dst].factor = 0.0f;
 
-        /* Cache loop normals into a temporary custom data layer. */
-        loop_nors_dst = CustomData_get_layer(ldata_dst, CD_NORMAL);
-        const bool do_loop_nors_dst = (loop_nors_dst == NULL);
-        if (!loop_nors_dst) {
-          loop_nors_dst = CustomData_add_layer(
-              ldata_dst, CD_NORMAL, CD_CALLOC, NULL, numloops_dst);
-          CustomData_set_layer_flag(ldata_dst, CD_NORMAL, CD_FLAG_TEMPORARY);
-        }
-        if (dirty_nors_dst || do_loop_nors_dst) {
-          BKE_mesh_normals_loop_split(verts_dst,
-                                      BKE_mesh_vertex_normals_ensure(mesh_dst),
-                                      numverts_dst,
-                                      edges_dst,
-                                      numedges_dst,
-                                      loops_dst,
-                                      loop_nors_dst,
-                                      numloops_dst,
-                                      polys_dst,
-                                      poly_nors_dst,
-                                      numpolys_dst,
-                                      use_split_nors_dst,
-                                      split_angle_dst,
-                                      NULL,
-                                      custom_nors_dst,
-                                      NULL);
+          if (mesh_remap_bvhtree_query_nearest(
+                  tdata, &tls->nearest, tmp_co, max_dist_sq, &hit_dist)) {
+            islands_res[tindex][plidx_dst].hit_dist = hit_dist;
+            islands_res[tindex][plidx_dst].index_src = (int)tdata->looptri[tls->nearest.index].poly;
+            copy_v3_v3(islands_res[tindex][plidx_dst].hit_point, tls->nearest.co);
+          }
+          else {
+            /* No source for this dest loop! */
+            islands_res[tindex][plidx_dst].hit_dist = FLT_MAX;
+            islands_res[tindex][plidx_dst].index_src = -1;
+          }
         }
       }
-      if (need_pnors_src || need_lnors_src) {
-        if (need_pnors_src) {
-          poly_nors_src = BKE_mesh_poly_normals_ensure(me_src);
+      else { /* Nearest poly either to use all its loops/verts or just closest one. */
+        copy_v3_v3(tmp_co, verts_dst[ml_dst->v].co);
+        tls->nearest.index = -1;
+
+        /* Convert the vertex to tree coordinates, if needed. */
+        if (space_transform) {
+          BLI_space_transform_apply(space_transform, tmp_co);
+        }
+
+        if (mesh_remap_bvhtree_query_nearest(
+                tdata, &tls->nearest, tmp_co, max_dist_sq, &hit_dist)) {
+          islands_res[tindex][plidx_dst].factor = hit_dist ? (1.0f / hit_dist) : 1e18f;
+          islands_res[tindex][plidx_dst].hit_dist = hit_dist;
+          islands_res[tindex][plidx_dst].index_src = (int)tdata->looptri[tls->nearest.index].poly;
+          copy_v3_v3(islands_res[tindex][plidx_dst].hit_point, tls->nearest.co);
+        }
+        else {
+          /* No source for this dest loop! */
+          islands_res[tindex][plidx_dst].factor = 0.0f;
+          islands_res[tindex][plidx_dst].hit_dist = FLT_MAX;
+          islands_res[tindex][plidx_dst].index_src = -1;
+        }
+      }
+    }
+  }
+
+  /* And now, find best island to use! */
+  /* We have to first select the 'best source island' for given dst poly and its loops.
+   * Then, we have to check that poly does not 'spread' across some island's limits
+   * (like inner seams for UVs, etc.).
+   * Note we only still partially support that kind of situation here, i.e.
+   * Polys spreading over actual cracks
+   * (like a narrow space without faces on src, splitting a 'tube-like' geometry).
+   * That kind of situation should be relatively rare, though.
+   */
+  /* XXX This block in itself is big and complex enough to be a separate function but...
+   *     it uses a bunch of locale vars.
+   *     Not worth sending all that through parameters (for now at least). */
+  {
+    BLI_AStarGraph *as_graph = NULL;
+    int *poly_island_index_map = NULL;
+    int pidx_src_prev = -1;
+
+    MeshElemMap *best_island = NULL;
+    float best_island_fac = 0.0f;
+    int best_island_index = -1;
+
+    for (tindex = 0; tindex < num_trees; tindex++) {
+      float island_fac = 0.0f;
+
+      for (plidx_dst = 0; plidx_dst < mp_dst->totloop; plidx_dst++) {
+        island_fac += islands_res[tindex][plidx_dst].factor;
+      }
+      island_fac /= (float)mp_dst->totloop;
+
+      if (island_fac > best_island_fac) {
+        best_island_fac = island_fac;
+        best_island_index = tindex;
+      }
+    }
+
+    if (best_island_index != -1 && isld_steps_src) {
+      best_island = use_islands ? island_store->islands[best_island_index] : NULL;
+      as_graph = &as_graphdata[best_island_index];
+      poly_island_index_map = (int *)as_graph->custom_data;
+      BLI_astar_solution_init(as_graph, as_solution, NULL);
+    }
+
+    for (plidx_dst = 0; plidx_dst < mp_dst->totloop; plidx_dst++) {
+      IslandResult *isld_res;
+      lidx_dst = plidx_dst + mp_dst->loopstart;
+
+      if (best_island_index == -1) {
+        /* No source for any loops of our dest poly in any source islands. */
+        BKE_mesh_remap_item_define_invalid(tls->r_map, lidx_dst);
+        continue;
+      }
+
+      as_solution->custom_data = POINTER_FROM_INT(false);
+
+      isld_res = &islands_res[best_island_index][plidx_dst];
+      if (use_from_vert) {
+        /* Indices stored in islands_res are those of loops, one per dest loop. */
+        lidx_src = isld_res->index_src;
+        if (lidx_src >= 0) {
+          pidx_src = loop_to_poly_map_src[lidx_src];
+          /* If prev and curr poly are the same, no need to do anything more!!! */
+          if (!ELEM(pidx_src_prev, -1, pidx_src) && isld_steps_src) {
+            int pidx_isld_src, pidx_isld_src_prev;
+            if (poly_island_index_map) {
+              pidx_isld_src = poly_island_index_map[pidx_src];
+              pidx_isld_src_prev = poly_island_index_map[pidx_src_prev];
+            }
+            else {
+              pidx_isld_src = pidx_src;
+              pidx_isld_src_prev = pidx_src_prev;
+            }
+
+            BLI_astar_graph_solve(as_graph,
+                                  pidx_isld_src_prev,
+                                  pidx_isld_src,
+                                  mesh_remap_calc_loops_astar_f_cost,
+                                  as_solution,
+                                  isld_steps_src);
+            if (POINTER_AS_INT(as_solution->custom_data) && (as_solution->steps > 0)) {
+              /* Find first 'cutting edge' on path, and bring back lidx_src on poly just
+               * before that edge.
+               * Note we could try to be much smarter, g.g. Storing a whole poly's indices,
+               * and making decision (on which side of cutting edge(s!) to be) on the end,
+               * but this is one more level of complexity, better to first see if
+               * simple solution works!
+               */
+              int last_valid_pidx_isld_src = -1;
+              /* Note we go backward here, from dest to src poly. */
+              for (i = as_solution->steps - 1; i--;) {
+                BLI_AStarGNLink *as_link = as_solution->prev_links[pidx_isld_src];
+                const int eidx = POINTER_AS_INT(as_link->custom_data);
+                pidx_isld_src = as_solution->prev_nodes[pidx_isld_src];
+                BLI_assert(pidx_isld_src != -1);
+                if (eidx != -1) {
+                  /* we are 'crossing' a cutting edge. */
+                  last_valid_pidx_isld_src = pidx_isld_src;
+                }
+              }
+              if (last_valid_pidx_isld_src != -1) {
+                /* Find a new valid loop in that new poly (nearest one for now).
+                 * Note we could be much more subtle here, again that's for later... */
+                int j;
+                float best_dist_sq = FLT_MAX;
+
+                ml_dst = &loops_dst[lidx_dst];
+                copy_v3_v3(tmp_co, verts_dst[ml_dst->v].co);
+
+                /* We do our transform here,
+                 * since we may do several raycast/nearest queries. */
+                if (space_transform) {
+                  BLI_space_transform_apply(space_transform, tmp_co);
+                }
+
+                pidx_src = (use_islands ? best_island->indices[last_valid_pidx_isld_src] :
+                                          last_valid_pidx_isld_src);
+                mp_src = &polys_src[pidx_src];
+                ml_src = &loops_src[mp_src->loopstart];
+                for (j = 0; j < mp_src->totloop; j++, ml_src++) {
+                  const float dist_sq = len_squared_v3v3(verts_src[ml_src->v].co, tmp_co);
+                  if (dist_sq < best_dist_sq) {
+                    best_dist_sq = dist_sq;
+                    lidx_src = mp_src->loopstart + j;
+                  }
+                }
+              }
+            }
+          }
+          mesh_remap_tls_item_define(tls, lidx_dst, best_island_index, 1, &lidx_src, &full_weight);
+          pidx_src_prev = pidx_src;
+        }
+        else {
+          /* No source for this loop in this island. */
+          /* TODO: would probably be better to get a source
+           * at all cost in best island anyway? */
+          mesh_remap_tls_item_define(tls, lidx_dst, best_island_index, 0, NULL, NULL);
+        }
+      }
+      else {
+        /* Else, we use source poly, indices stored in islands_res are those of polygons. */
+        pidx_src = isld_res->index_src;
+        if (pidx_src >= 0) {
+          float *hit_co = isld_res->hit_point;
+          int best_loop_index_src;
+
+          mp_src = &polys_src[pidx_src];
+          /* If prev and curr poly are the same, no need to do anything more!!! */
+          if (!ELEM(pidx_src_prev, -1, pidx_src) && isld_steps_src) {
+            int pidx_isld_src, pidx_isld_src_prev;
+            if (poly_island_index_map) {
+              pidx_isld_src = poly_island_index_map[pidx_src];
+              pidx_isld_src_prev = poly_island_index_map[pidx_src_prev];
+            }
+            else {
+              pidx_isld_src = pidx_src;
+              pidx_isld_src_prev = pidx_src_prev;
+            }
+
+            BLI_astar_graph_solve(as_graph,
+                                  pidx_isld_src_prev,
+                                  pidx_isld_src,
+                                  mesh_remap_calc_loops_astar_f_cost,
+                                  as_solution,
+                                  isld_steps_src);
+            if (POINTER_AS_INT(as_solution->custom_data) && (as_solution->steps > 0)) {
+              /* Find first 'cutting edge' on path, and bring back lidx_src on poly just
+               * before that edge.
+               * Note we could try to be much smarter: e.g. Storing a whole poly's indices,
+               * and making decision (one which side of cutting edge(s)!) to be on the end,
+               * but this is one more level of complexity, better to first see if
+               * simple solution works!
+               */
+              int last_valid_pidx_isld_src = -1;
+              /* Note we go backward here, from dest to src poly. */
+              for (i = as_solution->steps - 1; i--;) {
+                BLI_AStarGNLink *as_link = as_solution->prev_links[pidx_isld_src];
+                int eidx = POINTER_AS_INT(as_link->custom_data);
+
+                pidx_isld_src = as_solution->prev_nodes[pidx_isld_src];
+                BLI_assert(pidx_isld_src != -1);
+                if (eidx != -1) {
+                  /* we are 'crossing' a cutting edge. */
+                  last_valid_pidx_isld_src = pidx_isld_src;
+                }
+              }
+              if (last_valid_pidx_isld_src != -1) {
+                /* Find a new valid loop in that new poly (nearest point on poly for now).
+                 * Note we could be much more subtle here, again that's for later... */
+                float best_dist_sq = FLT_MAX;
+                int j;
+
+                ml_dst = &loops_dst[lidx_dst];
+                copy_v3_v3(tmp_co, verts_dst[ml_dst->v].co);
+
+                /* We do our transform here,
+                 * since we may do several raycast/nearest queries. */
+                if (space_transform) {
+                  BLI_space_transform_apply(space_transform, tmp_co);
+                }
+
+                pidx_src = (use_islands ? best_island->indices[last_valid_pidx_isld_src] :
+                                          last_valid_pidx_isld_src);
+                mp_src = &polys_src[pidx_src];
+
+                /* Created beforehand, cannot be done on demand from parallel tasks. */
+                BLI_assert(poly_to_looptri_map_src != NULL);
+
+                for (j = poly_to_looptri_map_src[pidx_src].count; j--;) {
+                  float h[3];
+                  const MLoopTri *lt =
+                      &looptri_src[poly_to_looptri_map_src[pidx_src].indices[j]];
+                  float dist_sq;
+
+                  closest_on_tri_to_point_v3(h,
+                                             tmp_co,
+                                             vcos_src[loops_src[lt->tri[0]].v],
+                                             vcos_src[loops_src[lt->tri[1]].v],
+                                             vcos_src[loops_src[lt->tri[2]].v]);
+                  dist_sq = len_squared_v3v3(tmp_co, h);
+                  if (dist_sq < best_dist_sq) {
+                    copy_v3_v3(hit_co, h);
+                    best_dist_sq = dist_sq;
+                  }
+                }
+              }
+            }
+          }
+
+          if (mode == MREMAP_MODE_LOOP_POLY_NEAREST) {
+            mesh_remap_interp_poly_data_get(mp_src,
+                                            loops_src,
+                                            (const float(*)[3])vcos_src,
+                                            hit_co,
+                                            &tls->buff_size_interp,
+                                            &tls->vcos_interp,
+                                            true,
+                                            &tls->indices_interp,
+                                            &tls->weights_interp,
+                                            false,
+                                            &best_loop_index_src);
+
+            mesh_remap_tls_item_define(
+                tls, lidx_dst, best_island_index, 1, &best_loop_index_src, &full_weight);
+          }
+          else {
+            const int sources_num = mesh_remap_interp_poly_data_get(
+                mp_src,
+                loops_src,
+                (const float(*)[3])vcos_src,
+                hit_co,
+                &tls->buff_size_interp,
+                &tls->vcos_interp,
+                true,
+                &tls->indices_interp,
+                &tls->weights_interp,
+                true,
+                NULL);
+
+            mesh_remap_tls_item_define(tls,
+                                       lidx_dst,
+                                       best_island_index,
+                                       sources_num,
+                                       tls->indices_interp,
+                                       tls->weights_interp);
+          }
+
+          pidx_src_prev = pidx_src;
+        }
+        else {
+          /* No source for this loop in this island. */
+          /* TODO: would probably be better to get a source
+           * at all cost in best island anyway? */
+          mesh_remap_tls_item_define(tls, lidx_dst, best_island_index, 0, NULL, NULL);
+        }
+      }
+    }
+
+    BLI_astar_solution_clear(as_solution);
+  }
+}
+
+void BKE_mesh_remap_calc_loops_from_mesh(const int mode,
+                                         const SpaceTransform *space_transform,
+                                         const float max_dist,
+                                         const float ray_radius,
+                                         Mesh *mesh_dst,
+                                         MVert *verts_dst,
+                                         const int numverts_dst,
+                                         MEdge *edges_dst,
+                                         const int numedges_dst,
+                                         MLoop *loops_dst,
+                                         const int numloops_dst,
+                                         MPoly *polys_dst,
+                                         const int numpolys_dst,
+                                         CustomData *ldata_dst,
+                                         const bool use_split_nors_dst,
+                                         const float split_angle_dst,
+                                         const bool dirty_nors_dst,
+                                         Mesh *me_src,
+                                         MeshRemapIslandsCalc gen_islands_src,
+                                         const float islands_precision_src,
+                                         MeshPairRemap *r_map)
+{
+  const float full_weight = 1.0f;
+
+  int i;
+
+  BLI_assert(mode & MREMAP_MODE_LOOP);
+  BLI_assert((islands_precision_src >= 0.0f) && (islands_precision_src <= 1.0f));
+
+  BKE_mesh_remap_init(r_map, numloops_dst);
+
+  if (mode == MREMAP_MODE_TOPOLOGY) {
+    /* In topology mapping, we assume meshes are identical, islands included! */
+    BLI_assert(numloops_dst == me_src->totloop);
+    for (i = 0; i < numloops_dst; i++) {
+      mesh_remap_item_define(r_map, i, FLT_MAX, 0, 1, &i, &full_weight);
+    }
+  }
+  else {
+    BVHTreeFromMesh *treedata = NULL;
+    int num_trees = 0;
+
+    const bool use_from_vert = (mode & MREMAP_USE_VERT);
+
+    MeshIslandStore island_store = {0};
+    bool use_islands = false;
+
+    BLI_AStarGraph *as_graphdata = NULL;
+    const int isld_steps_src = (islands_precision_src ?
+                                    max_ii((int)(ASTAR_STEPS_MAX * islands_precision_src + 0.499f),
+                                           1) :
+                                    0);
+
+    const float(*poly_nors_src)[3] = NULL;
+    const float(*loop_nors_src)[3] = NULL;
+    const float(*poly_nors_dst)[3] = NULL;
+    float(*loop_nors_dst)[3] = NULL;
+
+    float(*poly_cents_src)[3] = NULL;
+
+    MeshElemMap *vert_to_loop_map_src = NULL;
+    int *vert_to_loop_map_src_buff = NULL;
+    MeshElemMap *vert_to_poly_map_src = NULL;
+    int *vert_to_poly_map_src_buff = NULL;
+    MeshElemMap *edge_to_poly_map_src = NULL;
+    int *edge_to_poly_map_src_buff = NULL;
+    MeshElemMap *poly_to_looptri_map_src = NULL;
+    int *poly_to_looptri_map_src_buff = NULL;
+
+    /* Unlike above, those are one-to-one mappings, simpler! */
+    int *loop_to_poly_map_src = NULL;
+
+    MVert *verts_src = me_src->mvert;
+    const int num_verts_src = me_src->totvert;
+    float(*vcos_src)[3] = NULL;
+    MEdge *edges_src = me_src->medge;
+    const int num_edges_src = me_src->totedge;
+    MLoop *loops_src = me_src->mloop;
+    const int num_loops_src = me_src->totloop;
+    MPoly *polys_src = me_src->mpoly;
+    const int num_polys_src = me_src->totpoly;
+    const MLoopTri *looptri_src = NULL;
+    int num_looptri_src = 0;
+
+    MLoop *ml_src;
+    MPoly *mp_src;
+    int tindex, pidx_src, lidx_src, plidx_src;
+
+    if (!use_from_vert) {
+      vcos_src = BKE_mesh_vert_coords_alloc(me_src, NULL);
+    }
+
+    {
+      const bool need_lnors_src = (mode & MREMAP_USE_LOOP) && (mode & MREMAP_USE_NORMAL);
+      const bool need_lnors_dst = need_lnors_src || (mode & MREMAP_USE_NORPROJ);
+      const bool need_pnors_src = need_lnors_src ||
+                                  ((mode & MREMAP_USE_POLY) && (mode & MREMAP_USE_NORMAL));
+      const bool need_pnors_dst = need_lnors_dst || need_pnors_src;
+
+      if (need_pnors_dst) {
+        poly_nors_dst = BKE_mesh_poly_normals_ensure(mesh_dst);
+      }
+      if (need_lnors_dst) {
+        short(*custom_nors_dst)[2] = CustomData_get_layer(ldata_dst, CD_CUSTOMLOOPNORMAL);
+
+        /* Cache loop normals into a temporary custom data layer. */
+        loop_nors_dst = CustomData_get_layer(ldata_dst, CD_NORMAL);
+        const bool do_loop_nors_dst = (loop_nors_dst == NULL);
+        if (!loop_nors_dst) {
+          loop_nors_dst = CustomData_add_layer(
+              ldata_dst, CD_NORMAL, CD_CALLOC, NULL, numloops_dst);
+          CustomData_set_layer_flag(ldata_dst, CD_NORMAL, CD_FLAG_TEMPORARY);
+        }
+        if (dirty_nors_dst || do_loop_nors_dst) {
+          BKE_mesh_normals_loop_split(verts_dst,
+                                      BKE_mesh_vertex_normals_ensure(mesh_dst),
+                                      numverts_dst,
+                                      edges_dst,
+                                      numedges_dst,
+                                      loops_dst,
+                                      loop_nors_dst,
+                                      numloops_dst,
+                                      polys_dst,
+                                      poly_nors_dst,
+                                      numpolys_dst,
+                                      use_split_nors_dst,
+                                      split_angle_dst,
+                                      NULL,
+                                      custom_nors_dst,
+                                      NULL);
+        }
+      }
+      if (need_pnors_src || need_lnors_src) {
+        if (need_pnors_src) {
+          poly_nors_src = BKE_mesh_poly_normals_ensure(me_src);
         }
         if (need_lnors_src) {
           loop_nors_src = CustomData_get_layer(&me_src->ldata, CD_NORMAL);
@@ -1566,542 +2355,62 @@ void BKE_mesh_remap_calc_loops_from_mesh(const int mode,
     }
 
     /* And check each dest poly! */
-    islands_res = MEM_mallocN(sizeof(*islands_res) * (size_t)num_trees, __func__);
-    for (tindex = 0; tindex < num_trees; tindex++) {
-      islands_res[tindex] = MEM_mallocN(sizeof(**islands_res) * islands_res_buff_size, __func__);
-    }
-
-    for (pidx_dst = 0, mp_dst = polys_dst; pidx_dst < numpolys_dst; pidx_dst++, mp_dst++) {
-      float pnor_dst[3];
-
-      /* Only in use_from_vert case, we may need polys' centers as fallback
-       * in case we cannot decide which corner to use from normals only. */
-      float pcent_dst[3];
-      bool pcent_dst_valid = false;
-
-      if (mode == MREMAP_MODE_LOOP_NEAREST_POLYNOR) {
-        copy_v3_v3(pnor_dst, poly_nors_dst[pidx_dst]);
-        if (space_transform) {
-          BLI_space_transform_apply_normal(space_transform, pnor_dst);
-        }
-      }
-
-      if ((size_t)mp_dst->totloop > islands_res_buff_size) {
-        islands_res_buff_size = (size_t)mp_dst->totloop + MREMAP_DEFAULT_BUFSIZE;
-        for (tindex = 0; tindex < num_trees; tindex++) {
-          islands_res[tindex] = MEM_reallocN(islands_res[tindex],
-                                             sizeof(**islands_res) * islands_res_buff_size);
-        }
-      }
-
-      for (tindex = 0; tindex < num_trees; tindex++) {
-        BVHTreeFromMesh *tdata = &treedata[tindex];
-
-        ml_dst = &loops_dst[mp_dst->loopstart];
-        for (plidx_dst = 0; plidx_dst < mp_dst->totloop; plidx_dst++, ml_dst++) {
-          if (use_from_vert) {
-            MeshElemMap *vert_to_refelem_map_src = NULL;
-
-            copy_v3_v3(tmp_co, verts_dst[ml_dst->v].co);
-            nearest.index = -1;
-
-            /* Convert the vertex to tree coordinates, if needed. */
-            if (space_transform) {
-              BLI_space_transform_apply(space_transform, tmp_co);
-            }
-
-            if (mesh_remap_bvhtree_query_nearest(
-                    tdata, &nearest, tmp_co, max_dist_sq, &hit_dist)) {
-              float(*nor_dst)[3];
-              const float(*nors_src)[3];
-              float best_nor_dot = -2.0f;
-              float best_sqdist_fallback = FLT_MAX;
-              int best_index_src = -1;
-
-              if (mode == MREMAP_MODE_LOOP_NEAREST_LOOPNOR) {
-                copy_v3_v3(tmp_no, loop_nors_dst[plidx_dst + mp_dst->loopstart]);
-                if (space_transform) {
-                  BLI_space_transform_apply_normal(space_transform, tmp_no);
-                }
-                nor_dst = &tmp_no;
-                nors_src = loop_nors_src;
-                vert_to_refelem_map_src = vert_to_loop_map_src;
-              }
-              else { /* if (mode == MREMAP_MODE_LOOP_NEAREST_POLYNOR) { */
-                nor_dst = &pnor_dst;
-                nors_src = poly_nors_src;
-                vert_to_refelem_map_src = vert_to_poly_map_src;
-              }
-
-              for (i = vert_to_refelem_map_src[nearest.index].count; i--;) {
-                const int index_src = vert_to_refelem_map_src[nearest.index].indices[i];
-                BLI_assert(index_src != -1);
-                const float dot = dot_v3v3(nors_src[index_src], *nor_dst);
-
-                pidx_src = ((mode == MREMAP_MODE_LOOP_NEAREST_LOOPNOR) ?
-                                loop_to_poly_map_src[index_src] :
-                                index_src);
-                /* WARNING! This is not the *real* lidx_src in case of POLYNOR, we only use it
-                 *          to check we stay on current island (all loops from a given poly are
-                 *          on same island!). */
-                lidx_src = ((mode == MREMAP_MODE_LOOP_NEAREST_LOOPNOR) ?
-                                index_src :
-                                polys_src[pidx_src].loopstart);
-
-                /* A same vert may be at the boundary of several islands! Hence, we have to ensure
-                 * poly/loop we are currently considering *belongs* to current island! */
-                if (use_islands && island_store.items_to_islands[lidx_src] != tindex) {
-                  continue;
-                }
-
-                if (dot > best_nor_dot - 1e-6f) {
-                  /* We need something as fallback decision in case dest normal matches several
-                   * source normals (see T44522), using distance between polys' centers here. */
-                  float *pcent_src;
-                  float sqdist;
-
-                  mp_src = &polys_src[pidx_src];
-                  ml_src = &loops_src[mp_src->loopstart];
-
-                  if (!pcent_dst_valid) {
-                    BKE_mesh_calc_poly_center(
-                        mp_dst, &loops_dst[mp_dst->loopstart], verts_dst, pcent_dst);
-                    pcent_dst_valid = true;
-                  }
-                  pcent_src = poly_cents_src[pidx_src];
-                  sqdist = len_squared_v3v3(pcent_dst, pcent_src);
-
-                  if ((dot > best_nor_dot + 1e-6f) || (sqdist < best_sqdist_fallback)) {
-                    best_nor_dot = dot;
-                    best_sqdist_fallback = sqdist;
-                    best_index_src = index_src;
-                  }
-                }
-              }
-              if (best_index_src == -1) {
-                /* We found no item to map back from closest vertex... */
-                best_nor_dot = -1.0f;
-                hit_dist = FLT_MAX;
-              }
-              else if (mode == MREMAP_MODE_LOOP_NEAREST_POLYNOR) {
-                /* Our best_index_src is a poly one for now!
-                 * Have to find its loop matching our closest vertex. */
-                mp_src = &polys_src[best_index_src];
-                ml_src = &loops_src[mp_src->loopstart];
-                for (plidx_src = 0; plidx_src < mp_src->totloop; plidx_src++, ml_src++) {
-                  if ((int)ml_src->v == nearest.index) {
-                    best_index_src = plidx_src + mp_src->loopstart;
-                    break;
-                  }
-                }
-              }
-              best_nor_dot = (best_nor_dot + 1.0f) * 0.5f;
-              islands_res[tindex][plidx_dst].factor = hit_dist ? (best_nor_dot / hit_dist) : 1e18f;
-              islands_res[tindex][plidx_dst].hit_dist = hit_dist;
-              islands_res[tindex][plidx_dst].index_src = best_index_src;
-            }
-            else {
-              /* No source for this dest loop! */
-              islands_res[tindex][plidx_dst].factor = 0.0f;
-              islands_res[tindex][plidx_dst].hit_dist = FLT_MAX;
-              islands_res[tindex][plidx_dst].index_src = -1;
-            }
-          }
-          else if (mode & MREMAP_USE_NORPROJ) {
-            int n = (ray_radius > 0.0f) ? MREMAP_RAYCAST_APPROXIMATE_NR : 1;
-            float w = 1.0f;
-
-            copy_v3_v3(tmp_co, verts_dst[ml_dst->v].co);
-            copy_v3_v3(tmp_no, loop_nors_dst[plidx_dst + mp_dst->loopstart]);
-
-            /* We do our transform here, since we may do several raycast/nearest queries. */
-            if (space_transform) {
-              BLI_space_transform_apply(space_transform, tmp_co);
-              BLI_space_transform_apply_normal(space_transform, tmp_no);
-            }
-
-            while (n--) {
-              if (mesh_remap_bvhtree_query_raycast(
-                      tdata, &rayhit, tmp_co, tmp_no, ray_radius / w, max_dist, &hit_dist)) {
-                islands_res[tindex][plidx_dst].factor = (hit_dist ? (1.0f / hit_dist) : 1e18f) * w;
-                islands_res[tindex][plidx_dst].hit_dist = hit_dist;
-                islands_res[tindex][plidx_dst].index_src = (int)tdata->looptri[rayhit.index].poly;
-                copy_v3_v3(islands_res[tindex][plidx_dst].hit_point, rayhit.co);
-                break;
-              }
-              /* Next iteration will get bigger radius but smaller weight! */
-              w /= MREMAP_RAYCAST_APPROXIMATE_FAC;
-            }
-            if (n == -1) {
-              /* Fallback to 'nearest' hit here, loops usually comes in 'face group', not good to
-               * have only part of one dest face's loops to map to source.
-               * Note that since we give this a null weight, if whole weight for a given face
-               * is null, it means none of its loop mapped to this source island,
-               * hence we can skip it later.
-               */
-              copy_v3_v3(tmp_co, verts_dst[ml_dst->v].co);
-              nearest.index = -1;
-
-              /* Convert the vertex to tree coordinates, if needed. */
-              if (space_transform) {
-                BLI_space_transform_apply(space_transform, tmp_co);
-              }
-
-              /* In any case, this fallback nearest hit should have no weight at all
-               * in 'best island' decision! */
-              islands_res[tindex][plidx_dst].factor = 0.0f;
-
-              if (mesh_remap_bvhtree_query_nearest(
-                      tdata, &nearest, tmp_co, max_dist_sq, &hit_dist)) {
-                islands_res[tindex][plidx_dst].hit_dist = hit_dist;
-                islands_res[tindex][plidx_dst].index_src = (int)tdata->looptri[nearest.index].poly;
-                copy_v3_v3(islands_res[tindex][plidx_dst].hit_point, nearest.co);
-              }
-              else {
-                /* No source for this dest loop! */
-                islands_res[tindex][plidx_dst].hit_dist = FLT_MAX;
-                islands_res[tindex][plidx_dst].index_src = -1;
-              }
-            }
-          }
-          else { /* Nearest poly either to use all its loops/verts or just closest one. */
-            copy_v3_v3(tmp_co, verts_dst[ml_dst->v].co);
-            nearest.index = -1;
-
-            /* Convert the vertex to tree coordinates, if needed. */
-            if (space_transform) {
-              BLI_space_transform_apply(space_transform, tmp_co);
-            }
-
-            if (mesh_remap_bvhtree_query_nearest(
-                    tdata, &nearest, tmp_co, max_dist_sq, &hit_dist)) {
-              islands_res[tindex][plidx_dst].factor = hit_dist ? (1.0f / hit_dist) : 1e18f;
-              islands_res[tindex][plidx_dst].hit_dist = hit_dist;
-              islands_res[tindex][plidx_dst].index_src = (int)tdata->looptri[nearest.index].poly;
-              copy_v3_v3(islands_res[tindex][plidx_dst].hit_point, nearest.co);
-            }
-            else {
-              /* No source for this dest loop! */
-              islands_res[tindex][plidx_dst].factor = 0.0f;
-              islands_res[tindex][plidx_dst].hit_dist = FLT_MAX;
-              islands_res[tindex][plidx_dst].index_src = -1;
-            }
-          }
-        }
-      }
-
-      /* And now, find best island to use! */
-      /* We have to first select the 'best source island' for given dst poly and its loops.
-       * Then, we have to check that poly does not 'spread' across some island's limits
-       * (like inner seams for UVs, etc.).
-       * Note we only still partially support that kind of situation here, i.e.
-       * Polys spreading over actual cracks
-       * (like a narrow space without faces on src, splitting a 'tube-like' geometry).
-       * That kind of situation should be relatively rare, though.
-       */
-      /* XXX This block in itself is big and complex enough to be a separate function but...
-       *     it uses a bunch of locale vars.
-       *     Not worth sending all that through parameters (for now at least). */
-      {
-        BLI_AStarGraph *as_graph = NULL;
-        int *poly_island_index_map = NULL;
-        int pidx_src_prev = -1;
-
-        MeshElemMap *best_island = NULL;
-        float best_island_fac = 0.0f;
-        int best_island_index = -1;
-
-        for (tindex = 0; tindex < num_trees; tindex++) {
-          float island_fac = 0.0f;
-
-          for (plidx_dst = 0; plidx_dst < mp_dst->totloop; plidx_dst++) {
-            island_fac += islands_res[tindex][plidx_dst].factor;
-          }
-          island_fac /= (float)mp_dst->totloop;
-
-          if (island_fac > best_island_fac) {
-            best_island_fac = island_fac;
-            best_island_index = tindex;
-          }
-        }
-
-        if (best_island_index != -1 && isld_steps_src) {
-          best_island = use_islands ? island_store.islands[best_island_index] : NULL;
-          as_graph = &as_graphdata[best_island_index];
-          poly_island_index_map = (int *)as_graph->custom_data;
-          BLI_astar_solution_init(as_graph, &as_solution, NULL);
-        }
-
-        for (plidx_dst = 0; plidx_dst < mp_dst->totloop; plidx_dst++) {
-          IslandResult *isld_res;
-          lidx_dst = plidx_dst + mp_dst->loopstart;
-
-          if (best_island_index == -1) {
-            /* No source for any loops of our dest poly in any source islands. */
-            BKE_mesh_remap_item_define_invalid(r_map, lidx_dst);
-            continue;
-          }
-
-          as_solution.custom_data = POINTER_FROM_INT(false);
-
-          isld_res = &islands_res[best_island_index][plidx_dst];
-          if (use_from_vert) {
-            /* Indices stored in islands_res are those of loops, one per dest loop. */
-            lidx_src = isld_res->index_src;
-            if (lidx_src >= 0) {
-              pidx_src = loop_to_poly_map_src[lidx_src];
-              /* If prev and curr poly are the same, no need to do anything more!!! */
-              if (!ELEM(pidx_src_prev, -1, pidx_src) && isld_steps_src) {
-                int pidx_isld_src, pidx_isld_src_prev;
-                if (poly_island_index_map) {
-                  pidx_isld_src = poly_island_index_map[pidx_src];
-                  pidx_isld_src_prev = poly_island_index_map[pidx_src_prev];
-                }
-                else {
-                  pidx_isld_src = pidx_src;
-                  pidx_isld_src_prev = pidx_src_prev;
-                }
-
-                BLI_astar_graph_solve(as_graph,
-                                      pidx_isld_src_prev,
-                                      pidx_isld_src,
-                                      mesh_remap_calc_loops_astar_f_cost,
-                                      &as_solution,
-                                      isld_steps_src);
-                if (POINTER_AS_INT(as_solution.custom_data) && (as_solution.steps > 0)) {
-                  /* Find first 'cutting edge' on path, and bring back lidx_src on poly just
-                   * before that edge.
-                   * Note we could try to be much smarter, g.g. Storing a whole poly's indices,
-                   * and making decision (on which side of cutting edge(s!) to be) on the end,
-                   * but this is one more level of complexity, better to first see if
-                   * simple solution works!
-                   */
-                  int last_valid_pidx_isld_src = -1;
-                  /* Note we go backward here, from dest to src poly. */
-                  for (i = as_solution.steps - 1; i--;) {
-                    BLI_AStarGNLink *as_link = as_solution.prev_links[pidx_isld_src];
-                    const int eidx = POINTER_AS_INT(as_link->custom_data);
-                    pidx_isld_src = as_solution.prev_nodes[pidx_isld_src];
-                    BLI_assert(pidx_isld_src != -1);
-                    if (eidx != -1) {
-                      /* we are 'crossing' a cutting edge. */
-                      last_valid_pidx_isld_src = pidx_isld_src;
-                    }
-                  }
-                  if (last_valid_pidx_isld_src != -1) {
-                    /* Find a new valid loop in that new poly (nearest one for now).
-                     * Note we could be much more subtle here, again that's for later... */
-                    int j;
-                    float best_dist_sq = FLT_MAX;
-
-                    ml_dst = &loops_dst[lidx_dst];
-                    copy_v3_v3(tmp_co, verts_dst[ml_dst->v].co);
-
-                    /* We do our transform here,
-                     * since we may do several raycast/nearest queries. */
-                    if (space_transform) {
-                      BLI_space_transform_apply(space_transform, tmp_co);
-                    }
-
-                    pidx_src = (use_islands ? best_island->indices[last_valid_pidx_isld_src] :
-                                              last_valid_pidx_isld_src);
-                    mp_src = &polys_src[pidx_src];
-                    ml_src = &loops_src[mp_src->loopstart];
-                    for (j = 0; j < mp_src->totloop; j++, ml_src++) {
-                      const float dist_sq = len_squared_v3v3(verts_src[ml_src->v].co, tmp_co);
-                      if (dist_sq < best_dist_sq) {
-                        best_dist_sq = dist_sq;
-                        lidx_src = mp_src->loopstart + j;
-                      }
-                    }
-                  }
-                }
-              }
-              mesh_remap_item_define(r_map,
-                                     lidx_dst,
-                                     isld_res->hit_dist,
-                                     best_island_index,
-                                     1,
-                                     &lidx_src,
-                                     &full_weight);
-              pidx_src_prev = pidx_src;
-            }
-            else {
-              /* No source for this loop in this island. */
-              /* TODO: would probably be better to get a source
-               * at all cost in best island anyway? */
-              mesh_remap_item_define(r_map, lidx_dst, FLT_MAX, best_island_index, 0, NULL, NULL);
-            }
-          }
-          else {
-            /* Else, we use source poly, indices stored in islands_res are those of polygons. */
-            pidx_src = isld_res->index_src;
-            if (pidx_src >= 0) {
-              float *hit_co = isld_res->hit_point;
-              int best_loop_index_src;
-
-              mp_src = &polys_src[pidx_src];
-              /* If prev and curr poly are the same, no need to do anything more!!! */
-              if (!ELEM(pidx_src_prev, -1, pidx_src) && isld_steps_src) {
-                int pidx_isld_src, pidx_isld_src_prev;
-                if (poly_island_index_map) {
-                  pidx_isld_src = poly_island_index_map[pidx_src];
-                  pidx_isld_src_prev = poly_island_index_map[pidx_src_prev];
-                }
-                else {
-                  pidx_isld_src = pidx_src;
-                  pidx_isld_src_prev = pidx_src_prev;
-                }
-
-                BLI_astar_graph_solve(as_graph,
-                                      pidx_isld_src_prev,
-                                      pidx_isld_src,
-                                      mesh_remap_calc_loops_astar_f_cost,
-                                      &as_solution,
-                                      isld_steps_src);
-                if (POINTER_AS_INT(as_solution.custom_data) && (as_solution.steps > 0)) {
-                  /* Find first 'cutting edge' on path, and bring back lidx_src on poly just
-                   * before that edge.
-                   * Note we could try to be much smarter: e.g. Storing a whole poly's indices,
-                   * and making decision (one which side of cutting edge(s)!) to be on the end,
-                   * but this is one more level of complexity, better to first see if
-                   * simple solution works!
-                   */
-                  int last_valid_pidx_isld_src = -1;
-                  /* Note we go backward here, from dest to src poly. */
-                  for (i = as_solution.steps - 1; i--;) {
-                    BLI_AStarGNLink *as_link = as_solution.prev_links[pidx_isld_src];
-                    int eidx = POINTER_AS_INT(as_link->custom_data);
-
-                    pidx_isld_src = as_solution.prev_nodes[pidx_isld_src];
-                    BLI_assert(pidx_isld_src != -1);
-                    if (eidx != -1) {
-                      /* we are 'crossing' a cutting edge. */
-                      last_valid_pidx_isld_src = pidx_isld_src;
-                    }
-                  }
-                  if (last_valid_pidx_isld_src != -1) {
-                    /* Find a new valid loop in that new poly (nearest point on poly for now).
-                     * Note we could be much more subtle here, again that's for later... */
-                    float best_dist_sq = FLT_MAX;
-                    int j;
-
-                    ml_dst = &loops_dst[lidx_dst];
-                    copy_v3_v3(tmp_co, verts_dst[ml_dst->v].co);
-
-                    /* We do our transform here,
-                     * since we may do several raycast/nearest queries. */
-                    if (space_transform) {
-                      BLI_space_transform_apply(space_transform, tmp_co);
-                    }
-
-                    pidx_src = (use_islands ? best_island->indices[last_valid_pidx_isld_src] :
-                                              last_valid_pidx_isld_src);
-                    mp_src = &polys_src[pidx_src];
-
-                    /* Create that one on demand. */
-                    if (poly_to_looptri_map_src == NULL) {
-                      BKE_mesh_origindex_map_create_looptri(&poly_to_looptri_map_src,
-                                                            &poly_to_looptri_map_src_buff,
-                                                            polys_src,
-                                                            num_polys_src,
-                                                            looptri_src,
-                                                            num_looptri_src);
-                    }
-
-                    for (j = poly_to_looptri_map_src[pidx_src].count; j--;) {
-                      float h[3];
-                      const MLoopTri *lt =
-                          &looptri_src[poly_to_looptri_map_src[pidx_src].indices[j]];
-                      float dist_sq;
-
-                      closest_on_tri_to_point_v3(h,
-                                                 tmp_co,
-                                                 vcos_src[loops_src[lt->tri[0]].v],
-                                                 vcos_src[loops_src[lt->tri[1]].v],
-                                                 vcos_src[loops_src[lt->tri[2]].v]);
-                      dist_sq = len_squared_v3v3(tmp_co, h);
-                      if (dist_sq < best_dist_sq) {
-                        copy_v3_v3(hit_co, h);
-                        best_dist_sq = dist_sq;
-                      }
-                    }
-                  }
-                }
-              }
-
-              if (mode == MREMAP_MODE_LOOP_POLY_NEAREST) {
-                mesh_remap_interp_poly_data_get(mp_src,
-                                                loops_src,
-                                                (const float(*)[3])vcos_src,
-                                                hit_co,
-                                                &buff_size_interp,
-                                                &vcos_interp,
-                                                true,
-                                                &indices_interp,
-                                                &weights_interp,
-                                                false,
-                                                &best_loop_index_src);
-
-                mesh_remap_item_define(r_map,
-                                       lidx_dst,
-                                       isld_res->hit_dist,
-                                       best_island_index,
-                                       1,
-                                       &best_loop_index_src,
-                                       &full_weight);
-              }
-              else {
-                const int sources_num = mesh_remap_interp_poly_data_get(
-                    mp_src,
-                    loops_src,
-                    (const float(*)[3])vcos_src,
-                    hit_co,
-                    &buff_size_interp,
-                    &vcos_interp,
-                    true,
-                    &indices_interp,
-                    &weights_interp,
-                    true,
-                    NULL);
-
-                mesh_remap_item_define(r_map,
-                                       lidx_dst,
-                                       isld_res->hit_dist,
-                                       best_island_index,
-                                       sources_num,
-                                       indices_interp,
-                                       weights_interp);
-              }
-
-              pidx_src_prev = pidx_src;
-            }
-            else {
-              /* No source for this loop in this island. */
-              /* TODO: would probably be better to get a source
-               * at all cost in best island anyway? */
-              mesh_remap_item_define(r_map, lidx_dst, FLT_MAX, best_island_index, 0, NULL, NULL);
-            }
-          }
-        }
-
-        BLI_astar_solution_clear(&as_solution);
+    if (!use_from_vert && isld_steps_src) {
+      /* Needed to find back a valid hit point when crossing islands' inner cuts. */
+      if (looptri_src == NULL) {
+        looptri_src = BKE_mesh_runtime_looptri_ensure(me_src);
+        num_looptri_src = me_src->runtime.looptris.len;
       }
+      BKE_mesh_origindex_map_create_looptri(&poly_to_looptri_map_src,
+                                            &poly_to_looptri_map_src_buff,
+                                            polys_src,
+                                            num_polys_src,
+                                            looptri_src,
+                                            num_looptri_src);
     }
 
+    MeshRemapLoopsData data = {
+        .mode = mode,
+        .space_transform = space_transform,
+        .max_dist = max_dist,
+        .ray_radius = ray_radius,
+        .treedata = treedata,
+        .as_graphdata = as_graphdata,
+        .num_trees = num_trees,
+        .island_store = &island_store,
+        .use_islands = use_islands,
+        .use_from_vert = use_from_vert,
+        .isld_steps_src = isld_steps_src,
+        .verts_dst = verts_dst,
+        .loops_dst = loops_dst,
+        .polys_dst = polys_dst,
+        .poly_nors_dst = poly_nors_dst,
+        .loop_nors_dst = loop_nors_dst,
+        .verts_src = verts_src,
+        .loops_src = loops_src,
+        .polys_src = polys_src,
+        .vcos_src = vcos_src,
+        .poly_nors_src = poly_nors_src,
+        .loop_nors_src = loop_nors_src,
+        .poly_cents_src = poly_cents_src,
+        .looptri_src = looptri_src,
+        .vert_to_loop_map_src = vert_to_loop_map_src,
+        .vert_to_poly_map_src = vert_to_poly_map_src,
+        .poly_to_looptri_map_src = poly_to_looptri_map_src,
+        .loop_to_poly_map_src = loop_to_poly_map_src,
+    };
+    mesh_remap_parallel_range(r_map, numpolys_dst, 64, &data, mesh_remap_loops_poly_cb);
+
     for (tindex = 0; tindex < num_trees; tindex++) {
-      MEM_freeN(islands_res[tindex]);
       free_bvhtree_from_mesh(&treedata[tindex]);
       if (isld_steps_src) {
         BLI_astar_graph_free(&as_graphdata[tindex]);
       }
     }
-    MEM_freeN(islands_res);
     BKE_mesh_loop_islands_free(&island_store);
     MEM_freeN(treedata);
     if (isld_steps_src) {
       MEM_freeN(as_graphdata);
-      BLI_astar_solution_free(&as_solution);
     }
 
     if (vcos_src) {
@@ -2137,15 +2446,276 @@ void BKE_mesh_remap_calc_loops_from_mesh(const int mode,
     if (poly_cents_src) {
       MEM_freeN(poly_cents_src);
     }
-    if (vcos_interp) {
-      MEM_freeN(vcos_interp);
+  }
+}
+
+typedef struct MeshRemapPolysData {
+  const SpaceTransform *space_transform;
+  float max_dist;
+  float ray_radius;
+  BVHTreeFromMesh *treedata;
+
+  const MVert *verts_dst;
+  const MLoop *loops_dst;
+  const MPoly *polys_dst;
+  const float (*poly_nors_dst)[3];
+
+  int polys_src_num;
+} MeshRemapPolysData;
+
+static void mesh_remap_polys_nearest_cb(void *__restrict userdata,
+                                        const int i,
+                                        const TaskParallelTLS *__restrict tls_v)
+{
+  const MeshRemapPolysData *data = userdata;
+  MeshRemapTLS *tls = tls_v->userdata_chunk;
+  const float full_weight = 1.0f;
+  const MPoly *mp = &data->polys_dst[i];
+  float tmp_co[3];
+  float hit_dist;
+
+  BKE_mesh_calc_poly_center(mp, &data->loops_dst[mp->loopstart], data->verts_dst, tmp_co);
+
+  /* Convert the vertex to tree coordinates, if needed. */
+  if (data->space_transform) {
+    BLI_space_transform_apply(data->space_transform, tmp_co);
+  }
+
+  if (mesh_remap_bvhtree_query_nearest(
+          data->treedata, &tls->nearest, tmp_co, data->max_dist * data->max_dist, &hit_dist)) {
+    const MLoopTri *lt = &data->treedata->looptri[tls->nearest.index];
+    const int poly_index = (int)lt->poly;
+    mesh_remap_tls_item_define(tls, i, 0, 1, &poly_index, &full_weight);
+  }
+  else {
+    /* No source for this dest poly! */
+    BKE_mesh_remap_item_define_invalid(tls->r_map, i);
+  }
+}
+
+static void mesh_remap_polys_nor_cb(void *__restrict userdata,
+                                    const int i,
+                                    const TaskParallelTLS *__restrict tls_v)
+{
+  const MeshRemapPolysData *data = userdata;
+  MeshRemapTLS *tls = tls_v->userdata_chunk;
+  const float full_weight = 1.0f;
+  const MPoly *mp = &data->polys_dst[i];
+  float tmp_co[3], tmp_no[3];
+  float hit_dist;
+
+  BKE_mesh_calc_poly_center(mp, &data->loops_dst[mp->loopstart], data->verts_dst, tmp_co);
+  copy_v3_v3(tmp_no, data->poly_nors_dst[i]);
+
+  /* Convert the vertex to tree coordinates, if needed. */
+  if (data->space_transform) {
+    BLI_space_transform_apply(data->space_transform, tmp_co);
+    BLI_space_transform_apply_normal(data->space_transform, tmp_no);
+  }
+
+  if (mesh_remap_bvhtree_query_raycast(data->treedata,
+                                       &tls->rayhit,
+                                       tmp_co,
+                                       tmp_no,
+                                       data->ray_radius,
+                                       data->max_dist,
+                                       &hit_dist)) {
+    const MLoopTri *lt = &data->treedata->looptri[tls->rayhit.index];
+    const int poly_index = (int)lt->poly;
+
+    mesh_remap_tls_item_define(tls, i, 0, 1, &poly_index, &full_weight);
+  }
+  else {
+    /* No source for this dest poly! */
+    BKE_mesh_remap_item_define_invalid(tls->r_map, i);
+  }
+}
+
+static void mesh_remap_polys_pnorproj_cb(void *__restrict userdata,
+                                         const int i,
+                                         const TaskParallelTLS *__restrict tls_v)
+{
+  const MeshRemapPolysData *data = userdata;
+  MeshRemapTLS *tls = tls_v->userdata_chunk;
+  const SpaceTransform *space_transform = data->space_transform;
+  const float ray_radius = data->ray_radius;
+  const size_t numpolys_src = (size_t)data->polys_src_num;
+
+  /* For each dst poly, we sample some rays from it (2D grid in pnor space)
+   * and use their hits to interpolate from source polys. */
+  /* NOTE: dst poly is early-converted into src space! */
+  const MPoly *mp = &data->polys_dst[i];
+
+  int tot_rays, done_rays = 0;
+  float poly_area_2d_inv, done_area = 0.0f;
+
+  float pcent_dst[3];
+  float to_pnor_2d_mat[3][3], from_pnor_2d_mat[3][3];
+  float poly_dst_2d_min[2], poly_dst_2d_max[2], poly_dst_2d_z;
+  float poly_dst_2d_size[2];
+  float tmp_co[3], tmp_no[3];
+  float hit_dist;
+
+  float totweights = 0.0f;
+  int sources_num = 0;
+  const int tris_num = mp->totloop - 2;
+  int j;
+
+  /* Here it's simpler to just allocate for all polys :/ */
+  mesh_remap_tls_src_ensure(tls, numpolys_src, numpolys_src);
+  int *indices = tls->indices_src;
+  float *weights = tls->weights_src;
+
+  /* Seed by destination poly, so that the result does not depend on how polys are split
+   * between threads. */
+  if (tls->rng == NULL) {
+    tls->rng = BLI_rng_new((uint)i);
+  }
+  else {
+    BLI_rng_seed(tls->rng, (uint)i);
+  }
+
+  if (tls->poly_vcos_2d == NULL) {
+    tls->tmp_poly_size = MREMAP_DEFAULT_BUFSIZE;
+    tls->poly_vcos_2d = MEM_mallocN(sizeof(*tls->poly_vcos_2d) * tls->tmp_poly_size, __func__);
+    /* Tessellated 2D poly, always (num_loops - 2) triangles. */
+    tls->tri_vidx_2d = MEM_mallocN(sizeof(*tls->tri_vidx_2d) * (tls->tmp_poly_size - 2),
+                                   __func__);
+  }
+  if (UNLIKELY((size_t)mp->totloop > tls->tmp_poly_size)) {
+    tls->tmp_poly_size = (size_t)mp->totloop;
+    tls->poly_vcos_2d = MEM_reallocN(tls->poly_vcos_2d,
+                                     sizeof(*tls->poly_vcos_2d) * tls->tmp_poly_size);
+    tls->tri_vidx_2d = MEM_reallocN(tls->tri_vidx_2d,
+                                    sizeof(*tls->tri_vidx_2d) * (tls->tmp_poly_size - 2));
+  }
+  float(*poly_vcos_2d)[2] = tls->poly_vcos_2d;
+  int(*tri_vidx_2d)[3] = tls->tri_vidx_2d;
+
+  BKE_mesh_calc_poly_center(mp, &data->loops_dst[mp->loopstart], data->verts_dst, pcent_dst);
+  copy_v3_v3(tmp_no, data->poly_nors_dst[i]);
+
+  /* We do our transform here, else it'd be redone by raycast helper for each ray, ugh! */
+  if (space_transform) {
+    BLI_space_transform_apply(space_transform, pcent_dst);
+    BLI_space_transform_apply_normal(space_transform, tmp_no);
+  }
+
+  copy_vn_fl(weights, (int)numpolys_src, 0.0f);
+
+  axis_dominant_v3_to_m3(to_pnor_2d_mat, tmp_no);
+  invert_m3_m3(from_pnor_2d_mat, to_pnor_2d_mat);
+
+  mul_m3_v3(to_pnor_2d_mat, pcent_dst);
+  poly_dst_2d_z = pcent_dst[2];
+
+  /* Get (2D) bounding square of our poly. */
+  INIT_MINMAX2(poly_dst_2d_min, poly_dst_2d_max);
+
+  for (j = 0; j < mp->totloop; j++) {
+    const MLoop *ml = &data->loops_dst[j + mp->loopstart];
+    copy_v3_v3(tmp_co, data->verts_dst[ml->v].co);
+    if (space_transform) {
+      BLI_space_transform_apply(space_transform, tmp_co);
     }
-    if (indices_interp) {
-      MEM_freeN(indices_interp);
+    mul_v2_m3v3(poly_vcos_2d[j], to_pnor_2d_mat, tmp_co);
+    minmax_v2v2_v2(poly_dst_2d_min, poly_dst_2d_max, poly_vcos_2d[j]);
+  }
+
+  /* We adjust our ray-casting grid to ray_radius (the smaller, the more rays are cast),
+   * with lower/upper bounds. */
+  sub_v2_v2v2(poly_dst_2d_size, poly_dst_2d_max, poly_dst_2d_min);
+
+  if (ray_radius) {
+    tot_rays = (int)((max_ff(poly_dst_2d_size[0], poly_dst_2d_size[1]) / ray_radius) + 0.5f);
+    CLAMP(tot_rays, MREMAP_RAYCAST_TRI_SAMPLES_MIN, MREMAP_RAYCAST_TRI_SAMPLES_MAX);
+  }
+  else {
+    /* If no radius (pure rays), give max number of rays! */
+    tot_rays = MREMAP_RAYCAST_TRI_SAMPLES_MIN;
+  }
+  tot_rays *= tot_rays;
+
+  poly_area_2d_inv = area_poly_v2(poly_vcos_2d, (uint)mp->totloop);
+  /* In case we have a null-area degenerated poly... */
+  poly_area_2d_inv = 1.0f / max_ff(poly_area_2d_inv, 1e-9f);
+
+  /* Tessellate our poly. */
+  if (mp->totloop == 3) {
+    tri_vidx_2d[0][0] = 0;
+    tri_vidx_2d[0][1] = 1;
+    tri_vidx_2d[0][2] = 2;
+  }
+  if (mp->totloop == 4) {
+    tri_vidx_2d[0][0] = 0;
+    tri_vidx_2d[0][1] = 1;
+    tri_vidx_2d[0][2] = 2;
+    tri_vidx_2d[1][0] = 0;
+    tri_vidx_2d[1][1] = 2;
+    tri_vidx_2d[1][2] = 3;
+  }
+  else {
+    BLI_polyfill_calc(poly_vcos_2d, (uint)mp->totloop, -1, (uint(*)[3])tri_vidx_2d);
+  }
+
+  for (j = 0; j < tris_num; j++) {
+    float *v1 = poly_vcos_2d[tri_vidx_2d[j][0]];
+    float *v2 = poly_vcos_2d[tri_vidx_2d[j][1]];
+    float *v3 = poly_vcos_2d[tri_vidx_2d[j][2]];
+    int rays_num;
+
+    /* All this allows us to get 'absolute' number of rays for each tri,
+     * avoiding accumulating errors over iterations, and helping better even distribution. */
+    done_area += area_tri_v2(v1, v2, v3);
+    rays_num = max_ii((int)((float)tot_rays * done_area * poly_area_2d_inv + 0.5f) - done_rays,
+                      0);
+    done_rays += rays_num;
+
+    while (rays_num--) {
+      int n = (ray_radius > 0.0f) ? MREMAP_RAYCAST_APPROXIMATE_NR : 1;
+      float w = 1.0f;
+
+      BLI_rng_get_tri_sample_float_v2(tls->rng, v1, v2, v3, tmp_co);
+
+      tmp_co[2] = poly_dst_2d_z;
+      mul_m3_v3(from_pnor_2d_mat, tmp_co);
+
+      /* At this point, tmp_co is a point on our poly surface, in mesh_src space! */
+      while (n--) {
+        if (mesh_remap_bvhtree_query_raycast(data->treedata,
+                                             &tls->rayhit,
+                                             tmp_co,
+                                             tmp_no,
+                                             ray_radius / w,
+                                             data->max_dist,
+                                             &hit_dist)) {
+          const MLoopTri *lt = &data->treedata->looptri[tls->rayhit.index];
+
+          weights[lt->poly] += w;
+          totweights += w;
+          break;
+        }
+        /* Next iteration will get bigger radius but smaller weight! */
+        w /= MREMAP_RAYCAST_APPROXIMATE_FAC;
+      }
     }
-    if (weights_interp) {
-      MEM_freeN(weights_interp);
+  }
+
+  if (totweights > 0.0f) {
+    for (j = 0; j < (int)numpolys_src; j++) {
+      if (!weights[j]) {
+        continue;
+      }
+      /* NOTE: sources_num is always <= j! */
+      weights[sources_num] = weights[j] / totweights;
+      indices[sources_num] = j;
+      sources_num++;
     }
+    mesh_remap_tls_item_define(tls, i, 0, sources_num, indices, weights);
+  }
+  else {
+    /* No source for this dest poly! */
+    BKE_mesh_remap_item_define_invalid(tls->r_map, i);
   }
 }
 
@@ -2162,9 +2732,7 @@ void BKE_mesh_remap_calc_polys_from_mesh(const int mode,
                                          MeshPairRemap *r_map)
 {
   const float full_weight = 1.0f;
-  const float max_dist_sq = max_dist * max_dist;
   const float(*poly_nors_dst)[3] = NULL;
-  float tmp_co[3], tmp_no[3];
   int i;
 
   BLI_assert(mode & MREMAP_MODE_POLY);
@@ -2183,238 +2751,35 @@ void BKE_mesh_remap_calc_polys_from_mesh(const int mode,
   }
   else {
     BVHTreeFromMesh treedata = {NULL};
-    BVHTreeNearest nearest = {0};
-    BVHTreeRayHit rayhit = {0};
-    float hit_dist;
+    MeshRemapPolysData data = {
+        .space_transform = space_transform,
+        .max_dist = max_dist,
+        .ray_radius = ray_radius,
+        .treedata = &treedata,
+        .verts_dst = verts_dst,
+        .loops_dst = loops_dst,
+        .polys_dst = polys_dst,
+        .poly_nors_dst = poly_nors_dst,
+        .polys_src_num = me_src->totpoly,
+    };
 
     BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_LOOPTRI, 2);
 
     if (mode == MREMAP_MODE_POLY_NEAREST) {
-      nearest.index = -1;
-
-      for (i = 0; i < numpolys_dst; i++) {
-        MPoly *mp = &polys_dst[i];
-
-        BKE_mesh_calc_poly_center(mp, &loops_dst[mp->loopstart], verts_dst, tmp_co);
-
-        /* Convert the vertex to tree coordinates, if needed. */
-        if (space_transform) {
-          BLI_space_transform_apply(space_transform, tmp_co);
-        }
-
-        if (mesh_remap_bvhtree_query_nearest(
-                &treedata, &nearest, tmp_co, max_dist_sq, &hit_dist)) {
-          const MLoopTri *lt = &treedata.looptri[nearest.index];
-          const int poly_index = (int)lt->poly;
-          mesh_remap_item_define(r_map, i, hit_dist, 0, 1, &poly_index, &full_weight);
-        }
-        else {
-          /* No source for this dest poly! */
-          BKE_mesh_remap_item_define_invalid(r_map, i);
-        }
-      }
+      mesh_remap_parallel_range(r_map, numpolys_dst, 256, &data, mesh_remap_polys_nearest_cb);
     }
     else if (mode == MREMAP_MODE_POLY_NOR) {
       BLI_assert(poly_nors_dst);
 
-      for (i = 0; i < numpolys_dst; i++) {
-        MPoly *mp = &polys_dst[i];
-
-        BKE_mesh_calc_poly_center(mp, &loops_dst[mp->loopstart], verts_dst, tmp_co);
-        copy_v3_v3(tmp_no, poly_nors_dst[i]);
-
-        /* Convert the vertex to tree coordinates, if needed. */
-        if (space_transform) {
-          BLI_space_transform_apply(space_transform, tmp_co);
-          BLI_space_transform_apply_normal(space_transform, tmp_no);
-        }
-
-        if (mesh_remap_bvhtree_query_raycast(
-                &treedata, &rayhit, tmp_co, tmp_no, ray_radius, max_dist, &hit_dist)) {
-          const MLoopTri *lt = &treedata.looptri[rayhit.index];
-          const int poly_index = (int)lt->poly;
-
-          mesh_remap_item_define(r_map, i, hit_dist, 0, 1, &poly_index, &full_weight);
-        }
-        else {
-          /* No source for this dest poly! */
-          BKE_mesh_remap_item_define_invalid(r_map, i);
-        }
-      }
+      mesh_remap_parallel_range(r_map, numpolys_dst, 256, &data, mesh_remap_polys_nor_cb);
     }
     else if (mode == MREMAP_MODE_POLY_POLYINTERP_PNORPROJ) {
       /* We cast our rays randomly, with a pseudo-even distribution
        * (since we spread across tessellated tris,
        * with additional weighting based on each tri's relative area).
+       * Every poly casts many rays, use smaller tasks.
        */
-      RNG *rng = BLI_rng_new(0);
-
-      const size_t numpolys_src = (size_t)me_src->totpoly;
-
-      /* Here it's simpler to just allocate for all polys :/ */
-      int *indices = MEM_mallocN(sizeof(*indices) * numpolys_src, __func__);
-      float *weights = MEM_mallocN(sizeof(*weights) * numpolys_src, __func__);
-
-      size_t tmp_poly_size = MREMAP_DEFAULT_BUFSIZE;
-      float(*poly_vcos_2d)[2] = MEM_mallocN(sizeof(*poly_vcos_2d) * tmp_poly_size, __func__);
-      /* Tessellated 2D poly, always (num_loops - 2) triangles. */
-      int(*tri_vidx_2d)[3] = MEM_mallocN(sizeof(*tri_vidx_2d) * (tmp_poly_size - 2), __func__);
-
-      for (i = 0; i < numpolys_dst; i++) {
-        /* For each dst poly, we sample some rays from it (2D grid in pnor space)
-         * and use their hits to interpolate from source polys. */
-        /* NOTE: dst poly is early-converted into src space! */
-        MPoly *mp = &polys_dst[i];
-
-        int tot_rays, done_rays = 0;
-        float poly_area_2d_inv, done_area = 0.0f;
-
-        float pcent_dst[3];
-        float to_pnor_2d_mat[3][3], from_pnor_2d_mat[3][3];
-        float poly_dst_2d_min[2], poly_dst_2d_max[2], poly_dst_2d_z;
-        float poly_dst_2d_size[2];
-
-        float totweights = 0.0f;
-        float hit_dist_accum = 0.0f;
-        int sources_num = 0;
-        const int tris_num = mp->totloop - 2;
-        int j;
-
-        BKE_mesh_calc_poly_center(mp, &loops_dst[mp->loopstart], verts_dst, pcent_dst);
-        copy_v3_v3(tmp_no, poly_nors_dst[i]);
-
-        /* We do our transform here, else it'd be redone by raycast helper for each ray, ugh! */
-        if (space_transform) {
-          BLI_space_transform_apply(space_transform, pcent_dst);
-          BLI_space_transform_apply_normal(space_transform, tmp_no);
-        }
-
-        copy_vn_fl(weights, (int)numpolys_src, 0.0f);
-
-        if (UNLIKELY((size_t)mp->totloop > tmp_poly_size)) {
-          tmp_poly_size = (size_t)mp->totloop;
-          poly_vcos_2d = MEM_reallocN(poly_vcos_2d, sizeof(*poly_vcos_2d) * tmp_poly_size);
-          tri_vidx_2d = MEM_reallocN(tri_vidx_2d, sizeof(*tri_vidx_2d) * (tmp_poly_size - 2));
-        }
-
-        axis_dominant_v3_to_m3(to_pnor_2d_mat, tmp_no);
-        invert_m3_m3(from_pnor_2d_mat, to_pnor_2d_mat);
-
-        mul_m3_v3(to_pnor_2d_mat, pcent_dst);
-        poly_dst_2d_z = pcent_dst[2];
-
-        /* Get (2D) bounding square of our poly. */
-        INIT_MINMAX2(poly_dst_2d_min, poly_dst_2d_max);
-
-        for (j = 0; j < mp->totloop; j++) {
-          MLoop *ml = &loops_dst[j + mp->loopstart];
-          copy_v3_v3(tmp_co, verts_dst[ml->v].co);
-          if (space_transform) {
-            BLI_space_transform_apply(space_transform, tmp_co);
-          }
-          mul_v2_m3v3(poly_vcos_2d[j], to_pnor_2d_mat, tmp_co);
-          minmax_v2v2_v2(poly_dst_2d_min, poly_dst_2d_max, poly_vcos_2d[j]);
-        }
-
-        /* We adjust our ray-casting grid to ray_radius (the smaller, the more rays are cast),
-         * with lower/upper bounds. */
-        sub_v2_v2v2(poly_dst_2d_size, poly_dst_2d_max, poly_dst_2d_min);
-
-        if (ray_radius) {
-          tot_rays = (int)((max_ff(poly_dst_2d_size[0], poly_dst_2d_size[1]) / ray_radius) + 0.5f);
-          CLAMP(tot_rays, MREMAP_RAYCAST_TRI_SAMPLES_MIN, MREMAP_RAYCAST_TRI_SAMPLES_MAX);
-        }
-        else {
-          /* If no radius (pure rays), give max number of rays! */
-          tot_rays = MREMAP_RAYCAST_TRI_SAMPLES_MIN;
-        }
-        tot_rays *= tot_rays;
-
-        poly_area_2d_inv = area_poly_v2(poly_vcos_2d, (uint)mp->totloop);
-        /* In case we have a null-area degenerated poly... */
-        poly_area_2d_inv = 1.0f / max_ff(poly_area_2d_inv, 1e-9f);
-
-        /* Tessellate our poly. */
-        if (mp->totloop == 3) {
-          tri_vidx_2d[0][0] = 0;
-          tri_vidx_2d[0][1] = 1;
-          tri_vidx_2d[0][2] = 2;
-        }
-        if (mp->totloop == 4) {
-          tri_vidx_2d[0][0] = 0;
-          tri_vidx_2d[0][1] = 1;
-          tri_vidx_2d[0][2] = 2;
-          tri_vidx_2d[1][0] = 0;
-          tri_vidx_2d[1][1] = 2;
-          tri_vidx_2d[1][2] = 3;
-        }
-        else {
-          BLI_polyfill_calc(poly_vcos_2d, (uint)mp->totloop, -1, (uint(*)[3])tri_vidx_2d);
-        }
-
-        for (j = 0; j < tris_num; j++) {
-          float *v1 = poly_vcos_2d[tri_vidx_2d[j][0]];
-          float *v2 = poly_vcos_2d[tri_vidx_2d[j][1]];
-          float *v3 = poly_vcos_2d[tri_vidx_2d[j][2]];
-          int rays_num;
-
-          /* All this allows us to get 'absolute' number of rays for each tri,
-           * avoiding accumulating errors over iterations, and helping better even distribution. */
-          done_area += area_tri_v2(v1, v2, v3);
-          rays_num = max_ii(
-              (int)((float)tot_rays * done_area * poly_area_2d_inv + 0.5f) - done_rays, 0);
-          done_rays += rays_num;
-
-          while (rays_num--) {
-            int n = (ray_radius > 0.0f) ? MREMAP_RAYCAST_APPROXIMATE_NR : 1;
-            float w = 1.0f;
-
-            BLI_rng_get_tri_sample_float_v2(rng, v1, v2, v3, tmp_co);
-
-            tmp_co[2] = poly_dst_2d_z;
-            mul_m3_v3(from_pnor_2d_mat, tmp_co);
-
-            /* At this point, tmp_co is a point on our poly surface, in mesh_src space! */
-            while (n--) {
-              if (mesh_remap_bvhtree_query_raycast(
-                      &treedata, &rayhit, tmp_co, tmp_no, ray_radius / w, max_dist, &hit_dist)) {
-                const MLoopTri *lt = &treedata.looptri[rayhit.index];
-
-                weights[lt->poly] += w;
-                totweights += w;
-                hit_dist_accum += hit_dist;
-                break;
-              }
-              /* Next iteration will get bigger radius but smaller weight! */
-              w /= MREMAP_RAYCAST_APPROXIMATE_FAC;
-            }
-          }
-        }
-
-        if (totweights > 0.0f) {
-          for (j = 0; j < (int)numpolys_src; j++) {
-            if (!weights[j]) {
-              continue;
-            }
-            /* NOTE: sources_num is always <= j! */
-            weights[sources_num] = weights[j] / totweights;
-            indices[sources_num] = j;
-            sources_num++;
-          }
-          mesh_remap_item_define(
-              r_map, i, hit_dist_accum / totweights, 0, sources_num, indices, weights);
-        }
-        else {
-          /* No source for this dest poly! */
-          BKE_mesh_remap_item_define_invalid(r_map, i);
-        }
-      }
-
-      MEM_freeN(tri_vidx_2d);
-      MEM_freeN(poly_vcos_2d);
-      MEM_freeN(indices);
-      MEM_freeN(weights);
-      BLI_rng_free(rng);
+      mesh_remap_parallel_range(r_map, numpolys_dst, 16, &data, mesh_remap_polys_pnorproj_cb);
     }
     else {
       CLOG_WARN(&LOG, "Unsupported mesh-to-mesh poly mapping mode (%d)!", mode);
@@ -5,6 +5,7 @@
  * \ingroup bke
  */
 
+#include <algorithm>
 #include <climits>
 #include <cstdio>
 #include <cstdlib>
@@ -19,10 +20,17 @@
 
 #include "BLI_sys_types.h"
 
+#include "BLI_array.hh"
 #include "BLI_edgehash.h"
+#include "BLI_enumerable_thread_specific.hh"
+#include "BLI_hash.h"
 #include "BLI_math_base.h"
 #include "BLI_math_vector.h"
+#include "BLI_span.hh"
+#include "BLI_task.hh"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "BKE_customdata.h"
 #include "BKE_deform.h"
@@ -32,6 +40,14 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
+using blender::Array;
+using blender::IndexRange;
+using blender::MutableSpan;
+using blender::Span;
+using blender::Vector;
+
 /* loop v/e are unsigned, so using max uint_32 value as invalid marker... */
 #define INVALID_LOOP_EDGE_MARKER 4294967295u
 
@@ -1069,21 +1085,27 @@ bool BKE_mesh_validate(Mesh *me, const bool do_verbose, const bool cddata_check_
                                    true,
                                    &changed);
 
-  BKE_mesh_validate_arrays(me,
-                           me->mvert,
-                           me->totvert,
-                           me->medge,
-                           me->totedge,
-                           me->mface,
-                           me->totface,
-                           me->mloop,
-                           me->totloop,
-                           me->mpoly,
-                           me->totpoly,
-                           me->dvert,
-                           do_verbose,
-                           true,
-                           &changed);
+  /* The full validation is serial, only run it when there is something to fix. */
+  int defects_num;
+  MeshDefect *defects = BKE_mesh_validate_defects(me, false, &defects_num);
+  if (defects) {
+    MEM_freeN(defects);
+    BKE_mesh_validate_arrays(me,
+                             me->mvert,
+                             me->totvert,
+                             me->medge,
+                             me->totedge,
+                             me->mface,
+                             me->totface,
+                             me->mloop,
+                             me->totloop,
+                             me->mpoly,
+                             me->totpoly,
+                             me->dvert,
+                             do_verbose,
+                             true,
+                             &changed);
+  }
 
   if (changed) {
     DEG_id_tag_update(&me->id, ID_RECALC_GEOMETRY_ALL_MODES);
@@ -1117,21 +1139,28 @@ bool BKE_mesh_is_valid(Mesh *me)
       do_fixes,
       &changed);
 
-  is_valid &= BKE_mesh_validate_arrays(me,
-                                       me->mvert,
-                                       me->totvert,
-                                       me->medge,
-                                       me->totedge,
-                                       me->mface,
-                                       me->totface,
-                                       me->mloop,
-                                       me->totloop,
-                                       me->mpoly,
-                                       me->totpoly,
-                                       me->dvert,
-                                       do_verbose,
-                                       do_fixes,
-                                       &changed);
+  /* Only run the full validation to report the defects. */
+  int defects_num;
+  MeshDefect *defects = BKE_mesh_validate_defects(me, true, &defects_num);
+  if (defects) {
+    MEM_freeN(defects);
+    BKE_mesh_validate_arrays(me,
+                             me->mvert,
+                             me->totvert,
+                             me->medge,
+                             me->totedge,
+                             me->mface,
+                             me->totface,
+                             me->mloop,
+                             me->totloop,
+                             me->mpoly,
+                             me->totpoly,
+                             me->dvert,
+                             do_verbose,
+                             do_fixes,
+                             &changed);
+    is_valid = false;
+  }
 
   BLI_assert(changed == false);
 
@@ -1164,6 +1193,559 @@ bool BKE_mesh_validate_material_indices(Mesh *me)
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Parallel Validation
+ *
+ * The checks of #BKE_mesh_validate_arrays without the fixes. The arrays are only read, so the
+ * elements can be checked in parallel, and the full validation only has to run on meshes that
+ * need to be fixed.
+ * \{ */
+
+enum {
+  MESH_VALIDATE_VERTS = 1 << 0,
+  MESH_VALIDATE_VERT_NORMALS = 1 << 1,
+  MESH_VALIDATE_EDGES = 1 << 2,
+  MESH_VALIDATE_POLYS = 1 << 3,
+  MESH_VALIDATE_OTHER = 1 << 4,
+};
+
+struct MeshValidateCache {
+  /** The arrays and sizes the layers were last checked with. */
+  const MVert *mvert;
+  const float (*vert_normals)[3];
+  const MEdge *medge;
+  const MPoly *mpoly;
+  const MLoop *mloop;
+  int totvert, totedge, totpoly, totloop;
+  /** The `MESH_VALIDATE_*` layers that had no defects. */
+  int valid_layers;
+};
+
+using DefectsTLS = blender::threading::EnumerableThreadSpecific<Vector<MeshDefect>>;
+
+static void mesh_defect_add(DefectsTLS &defects,
+                            const eMeshDefectType type,
+                            const int index,
+                            const int other = -1)
+{
+  defects.local().append({type, index, other});
+}
+
+/** The layer that has to be checked again after a defect of this type was found. */
+static int mesh_defect_layer(const eMeshDefectType type)
+{
+  switch (type) {
+    case MESH_DEFECT_VERT_CO_NONFINITE:
+      return MESH_VALIDATE_VERTS;
+    case MESH_DEFECT_VERT_NORMAL_ZERO:
+      return MESH_VALIDATE_VERT_NORMALS;
+    case MESH_DEFECT_EDGE_VERTS_EQUAL:
+    case MESH_DEFECT_EDGE_VERT_RANGE:
+    case MESH_DEFECT_EDGE_DUPLICATE:
+      return MESH_VALIDATE_EDGES;
+    case MESH_DEFECT_POLY_MATERIAL:
+    case MESH_DEFECT_POLY_LOOP_RANGE:
+    case MESH_DEFECT_POLY_VERT_DUPLICATE:
+    case MESH_DEFECT_POLY_DUPLICATE:
+    case MESH_DEFECT_LOOP_VERT_RANGE:
+    case MESH_DEFECT_LOOP_EDGE_RANGE:
+    case MESH_DEFECT_LOOP_EDGE_MISMATCH:
+    case MESH_DEFECT_LOOP_UNUSED:
+    case MESH_DEFECT_LOOP_SHARED:
+      return MESH_VALIDATE_POLYS;
+    case MESH_DEFECT_FACES_LEGACY:
+    case MESH_DEFECT_DVERT_WEIGHT:
+    case MESH_DEFECT_DVERT_GROUP:
+    case MESH_DEFECT_SELECT_INDEX:
+      return MESH_VALIDATE_OTHER;
+  }
+  BLI_assert_unreachable();
+  return MESH_VALIDATE_OTHER;
+}
+
+/** The layers found valid by a previous check that still use the same arrays. */
+static int mesh_validate_cache_layers(const MeshValidateCache *cache,
+                                      const Mesh *mesh,
+                                      const float (*vert_normals)[3])
+{
+  if (cache == nullptr || cache->totvert != mesh->totvert) {
+    return 0;
+  }
+  int layers = cache->valid_layers;
+  if (cache->mvert != mesh->mvert) {
+    layers &= ~(MESH_VALIDATE_VERTS | MESH_VALIDATE_VERT_NORMALS);
+  }
+  if (cache->vert_normals != vert_normals) {
+    layers &= ~MESH_VALIDATE_VERT_NORMALS;
+  }
+  if (cache->medge != mesh->medge || cache->totedge != mesh->totedge) {
+    layers &= ~(MESH_VALIDATE_EDGES | MESH_VALIDATE_POLYS);
+  }
+  if (cache->mpoly != mesh->mpoly || cache->mloop != mesh->mloop ||
+      cache->totpoly != mesh->totpoly || cache->totloop != mesh->totloop) {
+    layers &= ~MESH_VALIDATE_POLYS;
+  }
+  /* Deform weights and the selection history are cheap to check, and changed without tagging. */
+  return layers & ~MESH_VALIDATE_OTHER;
+}
+
+void BKE_mesh_validate_cache_free(Mesh *me)
+{
+  MEM_SAFE_FREE(me->runtime.validate_cache);
+}
+
+void BKE_mesh_validate_cache_tag_verts_changed(Mesh *me)
+{
+  if (me->runtime.validate_cache != nullptr) {
+    me->runtime.validate_cache->valid_layers &= ~(MESH_VALIDATE_VERTS |
+                                                  MESH_VALIDATE_VERT_NORMALS);
+  }
+}
+
+/**
+ * Find the items that are equal to an earlier item. The items are partitioned by the low bits of
+ * their hash so the partitions can be searched in parallel. Within a partition the items are
+ * sorted by hash and index, so only items with the same hash are compared, and the first item
+ * of a group of equal items is the one with the lowest index.
+ *
+ * \param use_item: Whether an item should be compared at all.
+ * \param r_first: The index of the first equal item, or -1 for items without an earlier one.
+ */
+template<typename UseFn, typename EqualFn>
+static void mesh_validate_find_duplicates(const Span<uint32_t> hashes,
+                                          const UseFn &use_item,
+                                          const EqualFn &is_equal,
+                                          MutableSpan<int> r_first)
+{
+  const int items_num = int(hashes.size());
+  const int chunk_size = 1 << 16;
+  const int chunks_num = int(divide_ceil_u(uint(items_num), chunk_size));
+  const int parts_num = chunks_num > 1 ? 256 : 1;
+  const uint32_t parts_mask = uint32_t(parts_num - 1);
+
+  auto chunk_range = [&](const int chunk) {
+    return IndexRange(chunk * chunk_size, std::min(chunk_size, items_num - chunk * chunk_size));
+  };
+
+  /* Count the items of every partition in every chunk, ordered by partition first, so the
+   * prefix sum gives the start of every chunk within its partition. */
+  Array<int> offsets(parts_num * chunks_num + 1, 0);
+  blender::threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange chunks) {
+    for (const int chunk : chunks) {
+      for (const int i : chunk_range(chunk)) {
+        r_first[i] = -1;
+        if (use_item(i)) {
+          offsets[int(hashes[i] & parts_mask) * chunks_num + chunk]++;
+        }
+      }
+    }
+  });
+  int offset = 0;
+  for (int &count : offsets) {
+    const int count_prev = count;
+    count = offset;
+    offset += count_prev;
+  }
+
+  Array<int> part_items(offset);
+  blender::threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange chunks) {
+    Array<int> part_offsets(parts_num);
+    for (const int chunk : chunks) {
+      for (const int part : IndexRange(parts_num)) {
+        part_offsets[part] = offsets[part * chunks_num + chunk];
+      }
+      for (const int i : chunk_range(chunk)) {
+        if (use_item(i)) {
+          part_items[part_offsets[int(hashes[i] & parts_mask)]++] = i;
+        }
+      }
+    }
+  });
+
+  blender::threading::parallel_for(IndexRange(parts_num), 1, [&](const IndexRange parts) {
+    for (const int part : parts) {
+      const int part_start = offsets[part * chunks_num];
+      const int part_end = offsets[(part + 1) * chunks_num];
+      MutableSpan<int> items = part_items.as_mutable_span().slice(part_start,
+                                                                 part_end - part_start);
+      std::sort(items.begin(), items.end(), [&](const int a, const int b) {
+        return hashes[a] != hashes[b] ? hashes[a] < hashes[b] : a < b;
+      });
+
+      int group_start = 0;
+      while (group_start < items.size()) {
+        int group_end = group_start + 1;
+        while (group_end < items.size() && hashes[items[group_end]] == hashes[items[group_start]]) {
+          group_end++;
+        }
+        for (const int k : IndexRange(group_start + 1, group_end - group_start - 1)) {
+          for (const int k_prev : IndexRange(group_start, k - group_start)) {
+            if (r_first[items[k_prev]] == -1 && is_equal(items[k_prev], items[k])) {
+              r_first[items[k]] = items[k_prev];
+              break;
+            }
+          }
+        }
+        group_start = group_end;
+      }
+    }
+  });
+}
+
+static void mesh_validate_verts(const Mesh *mesh,
+                                const bool check_co,
+                                const float (*vert_normals)[3],
+                                DefectsTLS &defects)
+{
+  const Span<MVert> verts(mesh->mvert, mesh->totvert);
+  blender::threading::parallel_for(verts.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      const float *co = verts[i].co;
+      if (check_co && !(isfinite(co[0]) && isfinite(co[1]) && isfinite(co[2]))) {
+        mesh_defect_add(defects, MESH_DEFECT_VERT_CO_NONFINITE, i);
+      }
+      /* See the zero normal check of #BKE_mesh_validate_arrays. */
+      if (vert_normals && is_zero_v3(vert_normals[i]) && !is_zero_v3(co)) {
+        mesh_defect_add(defects, MESH_DEFECT_VERT_NORMAL_ZERO, i);
+      }
+    }
+  });
+}
+
+static void mesh_validate_edges(const Mesh *mesh, DefectsTLS &defects)
+{
+  const Span<MEdge> edges(mesh->medge, mesh->totedge);
+  const uint totvert = uint(mesh->totvert);
+
+  Array<uint32_t> hashes(edges.size());
+  blender::threading::parallel_for(edges.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      const MEdge &edge = edges[i];
+      if (edge.v1 == edge.v2) {
+        mesh_defect_add(defects, MESH_DEFECT_EDGE_VERTS_EQUAL, i, int(edge.v1));
+      }
+      if (edge.v1 >= totvert) {
+        mesh_defect_add(defects, MESH_DEFECT_EDGE_VERT_RANGE, i, int(edge.v1));
+      }
+      if (edge.v2 >= totvert) {
+        mesh_defect_add(defects, MESH_DEFECT_EDGE_VERT_RANGE, i, int(edge.v2));
+      }
+      hashes[i] = BLI_hash_int_2d(std::min(edge.v1, edge.v2), std::max(edge.v1, edge.v2));
+    }
+  });
+
+  Array<int> first_edges(edges.size());
+  mesh_validate_find_duplicates(
+      hashes,
+      [&](const int i) {
+        return edges[i].v1 != edges[i].v2 && edges[i].v1 < totvert && edges[i].v2 < totvert;
+      },
+      [&](const int a, const int b) {
+        return (edges[a].v1 == edges[b].v1 && edges[a].v2 == edges[b].v2) ||
+               (edges[a].v1 == edges[b].v2 && edges[a].v2 == edges[b].v1);
+      },
+      first_edges);
+
+  blender::threading::parallel_for(edges.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      if (first_edges[i] != -1) {
+        mesh_defect_add(defects, MESH_DEFECT_EDGE_DUPLICATE, i, first_edges[i]);
+      }
+    }
+  });
+}
+
+static void mesh_validate_poly_sorted_verts(const Span<MLoop> poly_loops,
+                                            Vector<int, 32> &r_verts)
+{
+  r_verts.clear();
+  for (const MLoop &loop : poly_loops) {
+    r_verts.append(int(loop.v));
+  }
+  std::sort(r_verts.begin(), r_verts.end());
+}
+
+static void mesh_validate_polys(const Mesh *mesh, DefectsTLS &defects)
+{
+  const Span<MEdge> edges(mesh->medge, mesh->totedge);
+  const Span<MPoly> polys(mesh->mpoly, mesh->totpoly);
+  const Span<MLoop> loops(mesh->mloop, mesh->totloop);
+  const uint totvert = uint(mesh->totvert);
+  const uint totedge = uint(mesh->totedge);
+
+  auto poly_loops_valid = [&](const MPoly &poly) {
+    return poly.loopstart >= 0 && poly.totloop >= 3 &&
+           int64_t(poly.loopstart) + int64_t(poly.totloop) <= loops.size();
+  };
+
+  /* Polygons with valid and unique vertices, these are compared to find duplicates. */
+  Array<bool> polys_verts_valid(polys.size());
+  Array<uint32_t> hashes(polys.size());
+  blender::threading::EnumerableThreadSpecific<Vector<int, 32>> sorted_verts_tls;
+
+  blender::threading::parallel_for(polys.index_range(), 1024, [&](const IndexRange range) {
+    Vector<int, 32> &sorted_verts = sorted_verts_tls.local();
+    for (const int i : range) {
+      const MPoly &poly = polys[i];
+      polys_verts_valid[i] = false;
+
+      if (poly.mat_nr < 0) {
+        mesh_defect_add(defects, MESH_DEFECT_POLY_MATERIAL, i, poly.mat_nr);
+      }
+      if (!poly_loops_valid(poly)) {
+        mesh_defect_add(defects, MESH_DEFECT_POLY_LOOP_RANGE, i);
+        continue;
+      }
+
+      const Span<MLoop> poly_loops = loops.slice(poly.loopstart, poly.totloop);
+      bool verts_valid = true;
+      /* The hash doesn't depend on the order of the vertices. */
+      uint32_t hash = uint32_t(poly.totloop);
+      for (const int corner : poly_loops.index_range()) {
+        const uint vert = poly_loops[corner].v;
+        if (vert >= totvert) {
+          mesh_defect_add(
+              defects, MESH_DEFECT_LOOP_VERT_RANGE, poly.loopstart + corner, int(vert));
+          verts_valid = false;
+        }
+        hash += BLI_hash_int(vert);
+      }
+      if (!verts_valid) {
+        continue;
+      }
+
+      mesh_validate_poly_sorted_verts(poly_loops, sorted_verts);
+      for (const int j : sorted_verts.index_range().drop_front(1)) {
+        if (sorted_verts[j] == sorted_verts[j - 1] &&
+            (j == 1 || sorted_verts[j - 1] != sorted_verts[j - 2])) {
+          mesh_defect_add(defects, MESH_DEFECT_POLY_VERT_DUPLICATE, i, sorted_verts[j]);
+          verts_valid = false;
+        }
+      }
+      if (!verts_valid) {
+        continue;
+      }
+
+      for (const int corner : poly_loops.index_range()) {
+        const MLoop &loop = poly_loops[corner];
+        if (loop.e >= totedge) {
+          mesh_defect_add(
+              defects, MESH_DEFECT_LOOP_EDGE_RANGE, poly.loopstart + corner, int(loop.e));
+          continue;
+        }
+        const uint vert_next = poly_loops[(corner + 1) % poly_loops.size()].v;
+        const MEdge &edge = edges[loop.e];
+        if (!((edge.v1 == loop.v && edge.v2 == vert_next) ||
+              (edge.v1 == vert_next && edge.v2 == loop.v))) {
+          mesh_defect_add(
+              defects, MESH_DEFECT_LOOP_EDGE_MISMATCH, poly.loopstart + corner, int(loop.e));
+        }
+      }
+
+      polys_verts_valid[i] = true;
+      hashes[i] = hash;
+    }
+  });
+
+  Array<int> first_polys(polys.size());
+  mesh_validate_find_duplicates(
+      hashes,
+      [&](const int i) { return polys_verts_valid[i]; },
+      [&](const int a, const int b) {
+        if (polys[a].totloop != polys[b].totloop) {
+          return false;
+        }
+        Vector<int, 32> verts_a, verts_b;
+        mesh_validate_poly_sorted_verts(loops.slice(polys[a].loopstart, polys[a].totloop),
+                                        verts_a);
+        mesh_validate_poly_sorted_verts(loops.slice(polys[b].loopstart, polys[b].totloop),
+                                        verts_b);
+        return verts_a.as_span() == verts_b.as_span();
+      },
+      first_polys);
+
+  blender::threading::parallel_for(polys.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      if (first_polys[i] != -1) {
+        mesh_defect_add(defects, MESH_DEFECT_POLY_DUPLICATE, i, first_polys[i]);
+      }
+    }
+  });
+
+  /* Usually every polygon uses the loops after the ones of the previous polygon, then every
+   * loop is used exactly once, and the loops don't have to be counted. */
+  bool loops_contiguous = polys.is_empty() ? loops.is_empty() :
+                                             polys.first().loopstart == 0 &&
+                                                 int64_t(polys.last().loopstart) +
+                                                         int64_t(polys.last().totloop) ==
+                                                     loops.size();
+  if (loops_contiguous) {
+    loops_contiguous = blender::threading::parallel_reduce(
+        polys.index_range(),
+        4096,
+        true,
+        [&](const IndexRange range, const bool contiguous) {
+          for (const int i : range) {
+            if (!contiguous || polys[i].totloop <= 0) {
+              return false;
+            }
+            if (i > 0 && polys[i].loopstart != polys[i - 1].loopstart + polys[i - 1].totloop) {
+              return false;
+            }
+          }
+          return contiguous;
+        },
+        [](const bool a, const bool b) { return a && b; });
+  }
+  if (loops_contiguous) {
+    return;
+  }
+
+  Array<int> loop_users(loops.size(), 0);
+  blender::threading::parallel_for(polys.index_range(), 1024, [&](const IndexRange range) {
+    for (const int i : range) {
+      if (poly_loops_valid(polys[i])) {
+        for (const int loop : IndexRange(polys[i].loopstart, polys[i].totloop)) {
+          atomic_add_and_fetch_int32(&loop_users[loop], 1);
+        }
+      }
+    }
+  });
+  blender::threading::parallel_for(loops.index_range(), 4096, [&](const IndexRange range) {
+    for (const int loop : range) {
+      if (loop_users[loop] == 0) {
+        mesh_defect_add(defects, MESH_DEFECT_LOOP_UNUSED, loop);
+      }
+      else if (loop_users[loop] > 1) {
+        mesh_defect_add(defects, MESH_DEFECT_LOOP_SHARED, loop);
+      }
+    }
+  });
+}
+
+static void mesh_validate_other(const Mesh *mesh, DefectsTLS &defects)
+{
+  if (mesh->mface && mesh->totface != 0 && mesh->totpoly == 0) {
+    mesh_defect_add(defects, MESH_DEFECT_FACES_LEGACY, 0);
+  }
+
+  if (mesh->dvert) {
+    const Span<MDeformVert> dverts(mesh->dvert, mesh->totvert);
+    blender::threading::parallel_for(dverts.index_range(), 4096, [&](const IndexRange range) {
+      for (const int i : range) {
+        for (const MDeformWeight &dw : Span<MDeformWeight>(dverts[i].dw, dverts[i].totweight)) {
+          if (!isfinite(dw.weight) || dw.weight < 0.0f || dw.weight > 1.0f) {
+            mesh_defect_add(defects, MESH_DEFECT_DVERT_WEIGHT, i, int(dw.def_nr));
+          }
+          /* See the group check of #BKE_mesh_validate_arrays. */
+          if (dw.def_nr >= INT_MAX) {
+            mesh_defect_add(defects, MESH_DEFECT_DVERT_GROUP, i, int(dw.def_nr));
+          }
+        }
+      }
+    });
+  }
+
+  for (const int i : IndexRange(mesh->mselect ? mesh->totselect : 0)) {
+    const MSelect &msel = mesh->mselect[i];
+    int tot_elem = 0;
+    switch (msel.type) {
+      case ME_VSEL:
+        tot_elem = mesh->totvert;
+        break;
+      case ME_ESEL:
+        tot_elem = mesh->totedge;
+        break;
+      case ME_FSEL:
+        tot_elem = mesh->totpoly;
+        break;
+    }
+    if (msel.index < 0 || msel.index > tot_elem) {
+      mesh_defect_add(defects, MESH_DEFECT_SELECT_INDEX, i, msel.index);
+    }
+  }
+}
+
+MeshDefect *BKE_mesh_validate_defects(Mesh *me, const bool use_cache, int *r_defects_num)
+{
+  const float(*vert_normals)[3] = nullptr;
+  BKE_mesh_assert_normals_dirty_or_calculated(me);
+  if (!BKE_mesh_vertex_normals_are_dirty(me)) {
+    vert_normals = BKE_mesh_vertex_normals_ensure(me);
+  }
+
+  ThreadMutex *mesh_eval_mutex = (ThreadMutex *)me->runtime.eval_mutex;
+  int valid_layers = 0;
+  if (use_cache) {
+    BLI_mutex_lock(mesh_eval_mutex);
+    valid_layers = mesh_validate_cache_layers(me->runtime.validate_cache, me, vert_normals);
+    BLI_mutex_unlock(mesh_eval_mutex);
+  }
+
+  DefectsTLS defects;
+  int checked_layers = MESH_VALIDATE_OTHER;
+  const bool check_co = !(valid_layers & MESH_VALIDATE_VERTS);
+  const bool check_normals = vert_normals && !(valid_layers & MESH_VALIDATE_VERT_NORMALS);
+  if (check_co || check_normals) {
+    mesh_validate_verts(me, check_co, check_normals ? vert_normals : nullptr, defects);
+    checked_layers |= (check_co ? MESH_VALIDATE_VERTS : 0) |
+                      (check_normals ? MESH_VALIDATE_VERT_NORMALS : 0);
+  }
+  if (!(valid_layers & MESH_VALIDATE_EDGES)) {
+    mesh_validate_edges(me, defects);
+    checked_layers |= MESH_VALIDATE_EDGES;
+  }
+  if (!(valid_layers & MESH_VALIDATE_POLYS)) {
+    mesh_validate_polys(me, defects);
+    checked_layers |= MESH_VALIDATE_POLYS;
+  }
+  mesh_validate_other(me, defects);
+
+  Vector<MeshDefect> defects_all;
+  for (const Vector<MeshDefect> &defects_local : defects) {
+    defects_all.extend(defects_local);
+  }
+  std::sort(defects_all.begin(), defects_all.end(), [](const MeshDefect &a, const MeshDefect &b) {
+    if (a.type != b.type) {
+      return a.type < b.type;
+    }
+    return a.index != b.index ? a.index < b.index : a.other < b.other;
+  });
+
+  int defect_layers = 0;
+  for (const MeshDefect &defect : defects_all) {
+    defect_layers |= mesh_defect_layer(defect.type);
+  }
+
+  BLI_mutex_lock(mesh_eval_mutex);
+  if (me->runtime.validate_cache == nullptr) {
+    me->runtime.validate_cache = MEM_cnew<MeshValidateCache>(__func__);
+  }
+  MeshValidateCache &cache = *me->runtime.validate_cache;
+  cache.mvert = me->mvert;
+  cache.vert_normals = vert_normals;
+  cache.medge = me->medge;
+  cache.mpoly = me->mpoly;
+  cache.mloop = me->mloop;
+  cache.totvert = me->totvert;
+  cache.totedge = me->totedge;
+  cache.totpoly = me->totpoly;
+  cache.totloop = me->totloop;
+  cache.valid_layers = (valid_layers | checked_layers) & ~defect_layers;
+  BLI_mutex_unlock(mesh_eval_mutex);
+
+  *r_defects_num = int(defects_all.size());
+  if (defects_all.is_empty()) {
+    return nullptr;
+  }
+  MeshDefect *r_defects = static_cast<MeshDefect *>(
+      MEM_malloc_arrayN(defects_all.size(), sizeof(MeshDefect), __func__));
+  std::copy(defects_all.begin(), defects_all.end(), r_defects);
+  return r_defects;
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Mesh Stripping (removing invalid data)
  * \{ */
@@ -0,0 +1,175 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_index_range.hh"
+#include "BLI_math_base.h"
+
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+namespace blender::bke::tests {
+
+class MeshValidateTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+};
+
+static void set_loop(MLoop &loop, const uint v, const uint e)
+{
+  loop.v = v;
+  loop.e = e;
+}
+
+/**
+ * Two quads sharing an edge:
+ * \code{.unparsed}
+ * 3---4---5
+ * |   |   |
+ * 0---1---2
+ * \endcode
+ */
+static Mesh *create_quads_mesh()
+{
+  Mesh *mesh = BKE_mesh_new_nomain(6, 7, 0, 8, 2);
+  for (const int i : IndexRange(6)) {
+    mesh->mvert[i].co[0] = float(i % 3);
+    mesh->mvert[i].co[1] = float(i / 3);
+    mesh->mvert[i].co[2] = 0.0f;
+  }
+  const uint edge_verts[7][2] = {{0, 1}, {1, 2}, {3, 4}, {4, 5}, {0, 3}, {1, 4}, {2, 5}};
+  for (const int i : IndexRange(7)) {
+    mesh->medge[i].v1 = edge_verts[i][0];
+    mesh->medge[i].v2 = edge_verts[i][1];
+  }
+  set_loop(mesh->mloop[0], 0, 0);
+  set_loop(mesh->mloop[1], 1, 5);
+  set_loop(mesh->mloop[2], 4, 2);
+  set_loop(mesh->mloop[3], 3, 4);
+  set_loop(mesh->mloop[4], 1, 1);
+  set_loop(mesh->mloop[5], 2, 6);
+  set_loop(mesh->mloop[6], 5, 3);
+  set_loop(mesh->mloop[7], 4, 5);
+  mesh->mpoly[0].loopstart = 0;
+  mesh->mpoly[0].totloop = 4;
+  mesh->mpoly[1].loopstart = 4;
+  mesh->mpoly[1].totloop = 4;
+  return mesh;
+}
+
+static void expect_defect(const MeshDefect &defect,
+                          const eMeshDefectType type,
+                          const int index,
+                          const int other)
+{
+  EXPECT_EQ(defect.type, type);
+  EXPECT_EQ(defect.index, index);
+  EXPECT_EQ(defect.other, other);
+}
+
+TEST_F(MeshValidateTest, valid)
+{
+  Mesh *mesh = create_quads_mesh();
+  int defects_num;
+  MeshDefect *defects = BKE_mesh_validate_defects(mesh, false, &defects_num);
+  EXPECT_EQ(defects, nullptr);
+  EXPECT_EQ(defects_num, 0);
+  EXPECT_TRUE(BKE_mesh_is_valid(mesh));
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(MeshValidateTest, defects)
+{
+  Mesh *mesh = create_quads_mesh();
+  /* Duplicate of edge 1 with reversed vertices. */
+  mesh->medge[3].v1 = 2;
+  mesh->medge[3].v2 = 1;
+  mesh->mvert[0].co[2] = NAN_FLT;
+  mesh->mpoly[1].mat_nr = -1;
+
+  int defects_num;
+  MeshDefect *defects = BKE_mesh_validate_defects(mesh, false, &defects_num);
+  ASSERT_EQ(defects_num, 4);
+  expect_defect(defects[0], MESH_DEFECT_VERT_CO_NONFINITE, 0, -1);
+  expect_defect(defects[1], MESH_DEFECT_EDGE_DUPLICATE, 3, 1);
+  expect_defect(defects[2], MESH_DEFECT_POLY_MATERIAL, 1, -1);
+  /* The loop from vertex 5 to 4 uses the edge that used to connect them. */
+  expect_defect(defects[3], MESH_DEFECT_LOOP_EDGE_MISMATCH, 6, 3);
+  MEM_freeN(defects);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(MeshValidateTest, loops)
+{
+  Mesh *mesh = create_quads_mesh();
+  /* The second quad reuses a loop of the first one, so its last loop is unused. */
+  mesh->mpoly[1].loopstart = 3;
+
+  int defects_num;
+  MeshDefect *defects = BKE_mesh_validate_defects(mesh, false, &defects_num);
+  ASSERT_GE(defects_num, 2);
+  expect_defect(defects[defects_num - 2], MESH_DEFECT_LOOP_UNUSED, 7, -1);
+  expect_defect(defects[defects_num - 1], MESH_DEFECT_LOOP_SHARED, 3, -1);
+  MEM_freeN(defects);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(MeshValidateTest, duplicate_edges_large)
+{
+  /* Enough edges to partition the hash table. */
+  const int edges_num = 200000;
+  Mesh *mesh = BKE_mesh_new_nomain(edges_num + 1, edges_num, 0, 0, 0);
+  for (const int i : IndexRange(edges_num)) {
+    mesh->medge[i].v1 = uint(i);
+    mesh->medge[i].v2 = uint(i + 1);
+  }
+  mesh->medge[150000].v1 = 11;
+  mesh->medge[150000].v2 = 10;
+  mesh->medge[199999].v1 = 10;
+  mesh->medge[199999].v2 = 11;
+
+  int defects_num;
+  MeshDefect *defects = BKE_mesh_validate_defects(mesh, false, &defects_num);
+  ASSERT_EQ(defects_num, 2);
+  expect_defect(defects[0], MESH_DEFECT_EDGE_DUPLICATE, 150000, 10);
+  expect_defect(defects[1], MESH_DEFECT_EDGE_DUPLICATE, 199999, 10);
+  MEM_freeN(defects);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(MeshValidateTest, cache)
+{
+  Mesh *mesh = create_quads_mesh();
+  int defects_num;
+  EXPECT_EQ(BKE_mesh_validate_defects(mesh, true, &defects_num), nullptr);
+
+  /* Untagged changes aren't noticed when using the cache. */
+  mesh->mvert[4].co[0] = NAN_FLT;
+  EXPECT_EQ(BKE_mesh_validate_defects(mesh, true, &defects_num), nullptr);
+
+  BKE_mesh_tag_coords_changed(mesh);
+  MeshDefect *defects = BKE_mesh_validate_defects(mesh, true, &defects_num);
+  ASSERT_EQ(defects_num, 1);
+  expect_defect(defects[0], MESH_DEFECT_VERT_CO_NONFINITE, 4, -1);
+  MEM_freeN(defects);
+
+  /* Without the cache everything is checked. */
+  mesh->mvert[4].co[0] = 1.0f;
+  mesh->medge[0].v2 = 100;
+  defects = BKE_mesh_validate_defects(mesh, false, &defects_num);
+  ASSERT_GE(defects_num, 1);
+  expect_defect(defects[0], MESH_DEFECT_EDGE_VERT_RANGE, 0, 100);
+  MEM_freeN(defects);
+  BKE_id_free(nullptr, mesh);
+}
+
+}  // namespace blender::bke::tests
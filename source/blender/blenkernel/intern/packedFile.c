@@ -40,6 +40,7 @@
 #include "IMB_imbuf_types.h"
 
 #include "BLO_read_write.h"
+#include "BLO_readfile.h"
 
 int BKE_packedfile_seek(PackedFile *pf, int offset, int whence)
 {
@@ -142,7 +143,9 @@ void BKE_packedfile_free(PackedFile *pf)
   if (pf) {
     BLI_assert(pf->data != NULL);
 
-    MEM_SAFE_FREE(pf->data);
+    if (!BLO_packed_data_release(pf->data)) {
+      MEM_SAFE_FREE(pf->data);
+    }
     MEM_freeN(pf);
   }
   else {
@@ -158,7 +161,13 @@ PackedFile *BKE_packedfile_duplicate(const PackedFile *pf_src)
   PackedFile *pf_dst;
 
   pf_dst = MEM_dupallocN(pf_src);
-  pf_dst->data = MEM_dupallocN(pf_src->data);
+  if (BLO_packed_data_user_add(pf_src->data)) {
+    /* Share the read-only mapping, it is released in #BKE_packedfile_free. */
+    pf_dst->data = pf_src->data;
+  }
+  else {
+    pf_dst->data = MEM_dupallocN(pf_src->data);
+  }
 
   return pf_dst;
 }
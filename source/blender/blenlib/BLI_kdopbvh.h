@@ -226,6 +226,21 @@ int BLI_bvhtree_find_nearest(BVHTree *tree,
                              BVHTree_NearestPointCallback callback,
                              void *userdata);
 
+/**
+ * Find the nearest node for many coordinates at once, the queries run in parallel.
+ *
+ * \param nearest: Array of \a co_num results, initialized like \a nearest of
+ * #BLI_bvhtree_find_nearest_ex (or with `index = -1` and `dist_sq = FLT_MAX`).
+ * \note The \a callback is called from multiple threads.
+ */
+void BLI_bvhtree_find_nearest_batch(BVHTree *tree,
+                                    const float (*co)[3],
+                                    int co_num,
+                                    BVHTreeNearest *nearest,
+                                    BVHTree_NearestPointCallback callback,
+                                    void *userdata,
+                                    int flag);
+
 /**
  * Find the first node nearby.
  * Favors speed over quality since it doesn't find the best target node.
@@ -33,6 +33,10 @@ bool BLI_mmap_read(BLI_mmap_file *file, void *dest, size_t offset, size_t length
 
 void *BLI_mmap_get_pointer(BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT;
 
+/* Hints the OS to start reading the given range of the file in the background, so that later
+ * reads from it don't have to wait for the disk. Ranges beyond the file end are ignored. */
+void BLI_mmap_prefetch(BLI_mmap_file *file, size_t offset, size_t length) ATTR_NONNULL(1);
+
 void BLI_mmap_free(BLI_mmap_file *file) ATTR_NONNULL(1);
 
 #ifdef __cplusplus
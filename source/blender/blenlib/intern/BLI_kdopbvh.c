@@ -20,6 +20,9 @@
  *   #BLI_bvhtree_overlap, #BVHOverlapData_Shared, #BVHOverlapData_Thread
  * - Range Query:
  *   #BLI_bvhtree_range_query
+ *
+ * Nearest point queries also have a batched variant that runs many queries in parallel,
+ * #BLI_bvhtree_find_nearest_batch.
  */
 
 #include "MEM_guardedalloc.h"
@@ -54,6 +57,13 @@
 #  define KDOPBVH_THREAD_LEAF_THRESHOLD 1024
 #endif
 
+/* Refitting a node with more leafs than this is done in parallel (mostly the top levels of the
+ * tree, where there are fewer nodes than threads). */
+#define KDOPBVH_THREAD_NODE_LEAF_THRESHOLD 16384
+
+/* Parallel queries of #BLI_bvhtree_find_nearest_batch. */
+#define KDOPBVH_BATCH_QUERY_CHUNK 64
+
 /* -------------------------------------------------------------------- */
 /** \name Struct Definitions
  * \{ */
@@ -368,33 +378,61 @@ static void create_kdop_hull(
   }
 }
 
+BLI_INLINE void kdop_hull_join(const BVHTree *tree,
+                               float *__restrict bv,
+                               const float *__restrict node_bv)
+{
+  /* for all Axes. */
+  for (axis_t axis_iter = tree->start_axis; axis_iter < tree->stop_axis; axis_iter++) {
+    const float newmin = node_bv[(2 * axis_iter)];
+    if ((newmin < bv[(2 * axis_iter)])) {
+      bv[(2 * axis_iter)] = newmin;
+    }
+
+    const float newmax = node_bv[(2 * axis_iter) + 1];
+    if ((newmax > bv[(2 * axis_iter) + 1])) {
+      bv[(2 * axis_iter) + 1] = newmax;
+    }
+  }
+}
+
+static void refit_kdop_hull_task_cb(void *__restrict userdata,
+                                    const int j,
+                                    const TaskParallelTLS *__restrict tls)
+{
+  const BVHTree *tree = userdata;
+  kdop_hull_join(tree, tls->userdata_chunk, tree->nodes[j]->bv);
+}
+
+static void refit_kdop_hull_reduce(const void *__restrict userdata,
+                                   void *__restrict chunk_join,
+                                   void *__restrict chunk)
+{
+  kdop_hull_join(userdata, chunk_join, chunk);
+}
+
 /**
  * \note depends on the fact that the BVH's for each face is already built
  */
 static void refit_kdop_hull(const BVHTree *tree, BVHNode *node, int start, int end)
 {
-  float newmin, newmax;
   float *__restrict bv = node->bv;
   int j;
-  axis_t axis_iter;
 
   node_minmax_init(tree, node);
 
-  for (j = start; j < end; j++) {
-    float *__restrict node_bv = tree->nodes[j]->bv;
-
-    /* for all Axes. */
-    for (axis_iter = tree->start_axis; axis_iter < tree->stop_axis; axis_iter++) {
-      newmin = node_bv[(2 * axis_iter)];
-      if ((newmin < bv[(2 * axis_iter)])) {
-        bv[(2 * axis_iter)] = newmin;
-      }
+  if (end - start > KDOPBVH_THREAD_NODE_LEAF_THRESHOLD) {
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.userdata_chunk = bv;
+    settings.userdata_chunk_size = sizeof(float) * tree->axis;
+    settings.func_reduce = refit_kdop_hull_reduce;
+    BLI_task_parallel_range(start, end, (void *)tree, refit_kdop_hull_task_cb, &settings);
+    return;
+  }
 
-      newmax = node_bv[(2 * axis_iter) + 1];
-      if ((newmax > bv[(2 * axis_iter) + 1])) {
-        bv[(2 * axis_iter) + 1] = newmax;
-      }
-    }
+  for (j = start; j < end; j++) {
+    kdop_hull_join(tree, bv, tree->nodes[j]->bv);
   }
 }
 
@@ -1622,6 +1660,47 @@ int BLI_bvhtree_find_nearest(BVHTree *tree,
   return BLI_bvhtree_find_nearest_ex(tree, co, nearest, callback, userdata, 0);
 }
 
+typedef struct BVHNearestBatchData {
+  BVHTree *tree;
+  const float (*co)[3];
+  BVHTreeNearest *nearest;
+  BVHTree_NearestPointCallback callback;
+  void *userdata;
+  int flag;
+} BVHNearestBatchData;
+
+static void bvhtree_find_nearest_batch_task_cb(void *__restrict userdata,
+                                               const int i,
+                                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BVHNearestBatchData *data = userdata;
+  BLI_bvhtree_find_nearest_ex(
+      data->tree, data->co[i], &data->nearest[i], data->callback, data->userdata, data->flag);
+}
+
+void BLI_bvhtree_find_nearest_batch(BVHTree *tree,
+                                    const float (*co)[3],
+                                    int co_num,
+                                    BVHTreeNearest *nearest,
+                                    BVHTree_NearestPointCallback callback,
+                                    void *userdata,
+                                    int flag)
+{
+  BVHNearestBatchData data = {
+      .tree = tree,
+      .co = co,
+      .nearest = nearest,
+      .callback = callback,
+      .userdata = userdata,
+      .flag = flag,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = KDOPBVH_BATCH_QUERY_CHUNK;
+  BLI_task_parallel_range(0, co_num, &data, bvhtree_find_nearest_batch_task_cb, &settings);
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -8,6 +8,7 @@
 #include "BLI_mmap.h"
 #include "BLI_fileops.h"
 #include "BLI_listbase.h"
+#include "BLI_threads.h"
 #include "MEM_guardedalloc.h"
 
 #include <string.h>
@@ -49,6 +50,10 @@ struct BLI_mmap_file {
  * set after it's done reading.
  * If the error occurred outside of a memory-mapped region, we call the previous
  * handler if one was configured and abort the process otherwise.
+ *
+ * Files are mapped and freed from several threads at once, e.g. by modifiers of different
+ * objects, so changes to the list and the handler setup are serialized by #error_handler_mutex.
+ * The signal handler itself can't take the lock, it only walks the list.
  */
 
 static struct error_handler_data {
@@ -57,6 +62,8 @@ static struct error_handler_data {
   void (*next_handler)(int, siginfo_t *, void *);
 } error_handler = {0};
 
+static ThreadMutex error_handler_mutex = BLI_MUTEX_INITIALIZER;
+
 static void sigbus_handler(int sig, siginfo_t *siginfo, void *ptr)
 {
   /* We only handle SIGBUS here for now. */
@@ -95,6 +102,9 @@ static void sigbus_handler(int sig, siginfo_t *siginfo, void *ptr)
 /* Ensures that the error handler is set up and ready. */
 static bool sigbus_handler_setup(void)
 {
+  bool success = true;
+
+  BLI_mutex_lock(&error_handler_mutex);
   if (!error_handler.configured) {
     struct sigaction newact = {0}, oldact = {0};
 
@@ -102,29 +112,39 @@ static bool sigbus_handler_setup(void)
     newact.sa_flags = SA_SIGINFO;
 
     if (sigaction(SIGBUS, &newact, &oldact)) {
-      return false;
+      success = false;
+    }
+    else {
+      /* Remember the previously configured handler to fall back to it if the error
+       * does not belong to any of the mapped files. */
+      error_handler.next_handler = oldact.sa_sigaction;
+      error_handler.configured = 1;
     }
-
-    /* Remember the previously configured handler to fall back to it if the error
-     * does not belong to any of the mapped files. */
-    error_handler.next_handler = oldact.sa_sigaction;
-    error_handler.configured = 1;
   }
+  BLI_mutex_unlock(&error_handler_mutex);
 
-  return true;
+  return success;
 }
 
 /* Adds a file to the list that the error handler checks. */
 static void sigbus_handler_add(BLI_mmap_file *file)
 {
-  BLI_addtail(&error_handler.open_mmaps, BLI_genericNodeN(file));
+  LinkData *link = BLI_genericNodeN(file);
+
+  BLI_mutex_lock(&error_handler_mutex);
+  BLI_addtail(&error_handler.open_mmaps, link);
+  BLI_mutex_unlock(&error_handler_mutex);
 }
 
 /* Removes a file from the list that the error handler checks. */
 static void sigbus_handler_remove(BLI_mmap_file *file)
 {
+  BLI_mutex_lock(&error_handler_mutex);
   LinkData *link = BLI_findptr(&error_handler.open_mmaps, file, offsetof(LinkData, data));
-  BLI_freelinkN(&error_handler.open_mmaps, link);
+  BLI_remlink(&error_handler.open_mmaps, link);
+  BLI_mutex_unlock(&error_handler_mutex);
+
+  MEM_freeN(link);
 }
 #endif
 
@@ -207,11 +227,33 @@ void *BLI_mmap_get_pointer(BLI_mmap_file *file)
   return file->memory;
 }
 
+void BLI_mmap_prefetch(BLI_mmap_file *file, size_t offset, size_t length)
+{
+  if (file->io_error || offset >= file->length) {
+    return;
+  }
+  length = MIN2(length, file->length - offset);
+
+#ifndef WIN32
+  /* The advised range has to start at a page boundary. */
+  const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+  const size_t offset_aligned = offset - (offset % page_size);
+  posix_madvise(
+      file->memory + offset_aligned, length + (offset - offset_aligned), POSIX_MADV_WILLNEED);
+#else
+  WIN32_MEMORY_RANGE_ENTRY range;
+  range.VirtualAddress = file->memory + offset;
+  range.NumberOfBytes = length;
+  PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#endif
+}
+
 void BLI_mmap_free(BLI_mmap_file *file)
 {
 #ifndef WIN32
-  munmap((void *)file->memory, file->length);
+  /* Unregister first, the handler must not see a range that is no longer mapped. */
   sigbus_handler_remove(file);
+  munmap((void *)file->memory, file->length);
 #else
   UnmapViewOfFile(file->memory);
   CloseHandle(file->handle);
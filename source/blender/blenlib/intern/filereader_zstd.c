@@ -12,10 +12,40 @@
 #include "BLI_endian_switch.h"
 #include "BLI_filereader.h"
 #include "BLI_math_base.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 
 #include "MEM_guardedalloc.h"
 
-typedef struct {
+/* Upper bound of frames decompressed ahead of the one being read, to bound memory usage. */
+#define ZSTD_READ_AHEAD_FRAMES_MAX 32
+
+typedef enum eZstdSlotState {
+  ZSTD_SLOT_EMPTY = 0,
+  /* A task to decompress the frame has been pushed, but nobody started working on it. */
+  ZSTD_SLOT_QUEUED,
+  ZSTD_SLOT_RUNNING,
+  ZSTD_SLOT_READY,
+  ZSTD_SLOT_ERROR,
+} eZstdSlotState;
+
+/**
+ * Buffer holding one decompressed frame. Frame `i` always goes into slot `i % slots_num`, so
+ * the slots form a ring over the upcoming frames of a sequential read.
+ */
+typedef struct ZstdFrameSlot {
+  int frame;
+  eZstdSlotState state;
+
+  /* Each slot is only decompressed by one thread at a time, so it can own a context. */
+  ZSTD_DCtx *ctx;
+  char *compressed_data;
+  size_t compressed_size_max;
+  char *uncompressed_data;
+  size_t uncompressed_size_max;
+} ZstdFrameSlot;
+
+typedef struct ZstdReader {
   FileReader reader;
 
   FileReader *base;
@@ -29,8 +59,17 @@ typedef struct {
     size_t *compressed_ofs;
     size_t *uncompressed_ofs;
 
-    char *cached_content;
-    int cached_frame;
+    ZstdFrameSlot *slots;
+    int slots_num;
+    /* Last frame returned by #zstd_ensure_cache, used to detect sequential reads. */
+    int last_frame;
+
+    TaskPool *task_pool;
+    /* Protects the state of the slots. */
+    ThreadMutex mutex;
+    ThreadCondition condition;
+    /* Protects the base reader, which is shared with the read-ahead tasks. */
+    ThreadMutex base_mutex;
   } seek;
 } ZstdReader;
 
@@ -126,8 +165,6 @@ static bool zstd_read_seek_table(ZstdReader *zstd)
     return false;
   }
 
-  zstd->seek.cached_frame = -1;
-
   return true;
 }
 
@@ -154,41 +191,142 @@ static int zstd_frame_from_pos(ZstdReader *zstd, size_t pos)
   return low;
 }
 
-/* Ensure that the currently loaded frame is the correct one. */
-static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
+/* Read and decompress the frame of a slot that the calling thread set to running. */
+static bool zstd_decompress_slot(ZstdReader *zstd, ZstdFrameSlot *slot)
 {
-  if (zstd->seek.cached_frame == frame) {
-    /* Cached frame matches, so just return it. */
-    return zstd->seek.cached_content;
-  }
-
-  /* Cached frame doesn't match, so discard it and cache the wanted one instead. */
-  MEM_SAFE_FREE(zstd->seek.cached_content);
-
+  const int frame = slot->frame;
   size_t compressed_size = zstd->seek.compressed_ofs[frame + 1] - zstd->seek.compressed_ofs[frame];
   size_t uncompressed_size = zstd->seek.uncompressed_ofs[frame + 1] -
                              zstd->seek.uncompressed_ofs[frame];
 
-  char *uncompressed_data = MEM_mallocN(uncompressed_size, __func__);
-  char *compressed_data = MEM_mallocN(compressed_size, __func__);
-  if (zstd->base->seek(zstd->base, zstd->seek.compressed_ofs[frame], SEEK_SET) < 0 ||
-      zstd->base->read(zstd->base, compressed_data, compressed_size) < compressed_size) {
-    MEM_freeN(compressed_data);
-    MEM_freeN(uncompressed_data);
-    return NULL;
+  /* Frames have mostly the same size, so the buffers are only reallocated when they grow. */
+  if (slot->compressed_size_max < compressed_size) {
+    MEM_SAFE_FREE(slot->compressed_data);
+    slot->compressed_data = MEM_mallocN(compressed_size, __func__);
+    slot->compressed_size_max = compressed_size;
+  }
+  if (slot->uncompressed_size_max < uncompressed_size) {
+    MEM_SAFE_FREE(slot->uncompressed_data);
+    slot->uncompressed_data = MEM_mallocN(uncompressed_size, __func__);
+    slot->uncompressed_size_max = uncompressed_size;
+  }
+
+  BLI_mutex_lock(&zstd->seek.base_mutex);
+  const bool read_ok = zstd->base->seek(zstd->base, zstd->seek.compressed_ofs[frame], SEEK_SET) >=
+                           0 &&
+                       zstd->base->read(zstd->base, slot->compressed_data, compressed_size) >=
+                           compressed_size;
+  BLI_mutex_unlock(&zstd->seek.base_mutex);
+  if (!read_ok) {
+    return false;
   }
 
+  if (slot->ctx == NULL) {
+    slot->ctx = ZSTD_createDCtx();
+  }
   size_t res = ZSTD_decompressDCtx(
-      zstd->ctx, uncompressed_data, uncompressed_size, compressed_data, compressed_size);
-  MEM_freeN(compressed_data);
-  if (ZSTD_isError(res) || res < uncompressed_size) {
-    MEM_freeN(uncompressed_data);
-    return NULL;
+      slot->ctx, slot->uncompressed_data, uncompressed_size, slot->compressed_data, compressed_size);
+  return !ZSTD_isError(res) && res >= uncompressed_size;
+}
+
+static void zstd_finish_slot(ZstdReader *zstd, ZstdFrameSlot *slot, bool success)
+{
+  BLI_mutex_lock(&zstd->seek.mutex);
+  slot->state = success ? ZSTD_SLOT_READY : ZSTD_SLOT_ERROR;
+  BLI_mutex_unlock(&zstd->seek.mutex);
+  BLI_condition_notify_all(&zstd->seek.condition);
+}
+
+static void zstd_read_ahead_task(TaskPool *__restrict pool, void *taskdata)
+{
+  ZstdReader *zstd = BLI_task_pool_user_data(pool);
+  ZstdFrameSlot *slot = taskdata;
+
+  BLI_mutex_lock(&zstd->seek.mutex);
+  if (slot->state != ZSTD_SLOT_QUEUED) {
+    /* The reader needed the frame before this task started and decompressed it itself. */
+    BLI_mutex_unlock(&zstd->seek.mutex);
+    return;
   }
+  slot->state = ZSTD_SLOT_RUNNING;
+  BLI_mutex_unlock(&zstd->seek.mutex);
 
-  zstd->seek.cached_frame = frame;
-  zstd->seek.cached_content = uncompressed_data;
-  return uncompressed_data;
+  zstd_finish_slot(zstd, slot, zstd_decompress_slot(zstd, slot));
+}
+
+/* Queue decompression of the frames following the given one into the slots they map to. */
+static void zstd_schedule_read_ahead(ZstdReader *zstd, int frame)
+{
+  ZstdFrameSlot *pushed_slots[ZSTD_READ_AHEAD_FRAMES_MAX];
+  int pushed_slots_num = 0;
+  const int last_frame = min_ii(frame + zstd->seek.slots_num - 1, zstd->seek.frames_num - 1);
+
+  BLI_mutex_lock(&zstd->seek.mutex);
+  for (int next_frame = frame + 1; next_frame <= last_frame; next_frame++) {
+    ZstdFrameSlot *slot = &zstd->seek.slots[next_frame % zstd->seek.slots_num];
+    if (slot->frame == next_frame && slot->state != ZSTD_SLOT_ERROR) {
+      continue;
+    }
+    if (slot->state == ZSTD_SLOT_RUNNING) {
+      /* Still busy with a frame from before a seek, it is scheduled again on a later read. */
+      continue;
+    }
+    /* Slots that are already queued are just retargeted, their pending task picks up the new
+     * frame. */
+    if (slot->state != ZSTD_SLOT_QUEUED) {
+      pushed_slots[pushed_slots_num++] = slot;
+    }
+    slot->frame = next_frame;
+    slot->state = ZSTD_SLOT_QUEUED;
+  }
+  BLI_mutex_unlock(&zstd->seek.mutex);
+
+  /* Push outside of the lock, tasks may run immediately in the calling thread. */
+  for (int i = 0; i < pushed_slots_num; i++) {
+    BLI_task_pool_push(zstd->seek.task_pool, zstd_read_ahead_task, pushed_slots[i], false, NULL);
+  }
+}
+
+/* Ensure that the given frame is decompressed, and return its contents. */
+static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
+{
+  ZstdFrameSlot *slot = &zstd->seek.slots[frame % zstd->seek.slots_num];
+  if (frame == zstd->seek.last_frame) {
+    /* Read-ahead never touches the slot of the frame being read, so no need to lock. */
+    return slot->uncompressed_data;
+  }
+
+  BLI_mutex_lock(&zstd->seek.mutex);
+  /* Wait for a read-ahead task working on the slot, whether it is the wanted frame or not. */
+  while (slot->state == ZSTD_SLOT_RUNNING) {
+    BLI_condition_wait(&zstd->seek.condition, &zstd->seek.mutex);
+  }
+  /* Frames that are not ready yet are decompressed here, taking over queued tasks. This also
+   * guarantees progress when the task pool has no worker threads available. */
+  const bool decompress = slot->frame != frame || slot->state != ZSTD_SLOT_READY;
+  if (decompress) {
+    slot->frame = frame;
+    slot->state = ZSTD_SLOT_RUNNING;
+  }
+  BLI_mutex_unlock(&zstd->seek.mutex);
+
+  /* Only read ahead once the file is read sequentially, reading the header or thumbnail of a
+   * file only needs its first frame. */
+  const bool is_sequential = zstd->seek.last_frame != -1 && zstd->seek.last_frame == frame - 1;
+  if (is_sequential && zstd->seek.slots_num > 1) {
+    zstd_schedule_read_ahead(zstd, frame);
+  }
+
+  if (decompress) {
+    const bool success = zstd_decompress_slot(zstd, slot);
+    zstd_finish_slot(zstd, slot, success);
+    if (!success) {
+      zstd->seek.last_frame = -1;
+      return NULL;
+    }
+  }
+  zstd->seek.last_frame = frame;
+  return slot->uncompressed_data;
 }
 
 static ssize_t zstd_read_seekable(FileReader *reader, void *buffer, size_t size)
@@ -279,12 +417,25 @@ static void zstd_close(FileReader *reader)
 
   ZSTD_freeDCtx(zstd->ctx);
   if (zstd->reader.seek) {
+    /* Stop the read-ahead before freeing the buffers it decompresses into. */
+    BLI_task_pool_cancel(zstd->seek.task_pool);
+    BLI_task_pool_free(zstd->seek.task_pool);
+    BLI_mutex_end(&zstd->seek.mutex);
+    BLI_mutex_end(&zstd->seek.base_mutex);
+    BLI_condition_end(&zstd->seek.condition);
+
+    for (int i = 0; i < zstd->seek.slots_num; i++) {
+      ZstdFrameSlot *slot = &zstd->seek.slots[i];
+      if (slot->ctx) {
+        ZSTD_freeDCtx(slot->ctx);
+      }
+      /* When an error has occurred these may be NULL, see: T99744. */
+      MEM_SAFE_FREE(slot->compressed_data);
+      MEM_SAFE_FREE(slot->uncompressed_data);
+    }
+    MEM_freeN(zstd->seek.slots);
     MEM_freeN(zstd->seek.uncompressed_ofs);
     MEM_freeN(zstd->seek.compressed_ofs);
-    /* When an error has occurred this may be NULL, see: T99744. */
-    if (zstd->seek.cached_content) {
-      MEM_freeN(zstd->seek.cached_content);
-    }
   }
   else {
     MEM_freeN((void *)zstd->in_buf.src);
@@ -304,6 +455,23 @@ FileReader *BLI_filereader_new_zstd(FileReader *base)
   if (zstd_read_seek_table(zstd)) {
     zstd->reader.read = zstd_read_seekable;
     zstd->reader.seek = zstd_seek;
+
+    /* Two slots per thread keep the workers busy while the reader consumes a frame. Without
+     * worker threads a single slot behaves like a plain cache of the last frame. */
+    const int threads_num = BLI_task_scheduler_num_threads();
+    zstd->seek.slots_num = threads_num > 1 ? min_iii(2 * threads_num,
+                                                     ZSTD_READ_AHEAD_FRAMES_MAX,
+                                                     max_ii(zstd->seek.frames_num, 1)) :
+                                             1;
+    zstd->seek.slots = MEM_callocN(sizeof(ZstdFrameSlot) * zstd->seek.slots_num, __func__);
+    for (int i = 0; i < zstd->seek.slots_num; i++) {
+      zstd->seek.slots[i].frame = -1;
+    }
+    zstd->seek.last_frame = -1;
+    zstd->seek.task_pool = BLI_task_pool_create(zstd, TASK_PRIORITY_HIGH);
+    BLI_mutex_init(&zstd->seek.mutex);
+    BLI_mutex_init(&zstd->seek.base_mutex);
+    BLI_condition_init(&zstd->seek.condition);
   }
   else {
     zstd->reader.read = zstd_read;
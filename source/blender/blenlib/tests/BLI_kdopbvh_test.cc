@@ -132,3 +132,41 @@ TEST(kdopbvh, OptimalFindNearest_500)
 {
   find_nearest_points_test(500, 1.0, 1000, 12, true);
 }
+
+TEST(kdopbvh, FindNearestBatch)
+{
+  const int points_len = 500;
+  struct RNG *rng = BLI_rng_new(12);
+  BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 4, 6);
+
+  float(*points)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+  float(*queries)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+  BVHTreeNearest *nearest = (BVHTreeNearest *)MEM_mallocN(sizeof(BVHTreeNearest) * points_len,
+                                                          __func__);
+
+  for (int i = 0; i < points_len; i++) {
+    rng_v3_round(points[i], 3, rng, 1000, 1.0f);
+    rng_v3_round(queries[i], 3, rng, 1000, 1.0f);
+    BLI_bvhtree_insert(tree, i, points[i], 1);
+    nearest[i].index = -1;
+    nearest[i].dist_sq = FLT_MAX;
+  }
+  BLI_bvhtree_balance(tree);
+
+  BLI_bvhtree_find_nearest_batch(tree, queries, points_len, nearest, nullptr, nullptr, 0);
+
+  for (int i = 0; i < points_len; i++) {
+    BVHTreeNearest expected;
+    expected.index = -1;
+    expected.dist_sq = FLT_MAX;
+    BLI_bvhtree_find_nearest(tree, queries[i], &expected, nullptr, nullptr);
+    EXPECT_EQ(nearest[i].index, expected.index);
+    EXPECT_FLOAT_EQ(nearest[i].dist_sq, expected.dist_sq);
+  }
+
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+  MEM_freeN(points);
+  MEM_freeN(queries);
+  MEM_freeN(nearest);
+}
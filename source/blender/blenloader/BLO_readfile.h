@@ -173,6 +173,25 @@ BlendFileData *BLO_read_from_memfile(struct Main *oldmain,
  */
 void BLO_blendfiledata_free(BlendFileData *bfd);
 
+/**
+ * With #G_FILE_LAZY_PACKED_DATA, large packed file payloads point directly into a read-only
+ * memory mapping of the blend file they were read from, instead of being allocated.
+ * Such data must not be modified or freed with `MEM_freeN`.
+ */
+bool BLO_packed_data_is_mapped(const void *data);
+/**
+ * Add a user to the mapping \a data points into, so a copy of the packed file can share it.
+ *
+ * \return false when \a data is a regular allocation, which the caller has to duplicate.
+ */
+bool BLO_packed_data_user_add(const void *data);
+/**
+ * Release packed file data that points into a memory mapped blend file.
+ *
+ * \return false when \a data is a regular allocation, which the caller has to free.
+ */
+bool BLO_packed_data_release(const void *data);
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
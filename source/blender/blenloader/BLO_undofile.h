@@ -43,6 +43,13 @@ typedef struct MemFileWriteData {
 
   /** Maps an ID session uuid to its first reference MemFileChunk, if existing. */
   struct GHash *id_session_uuid_mapping;
+
+  /** State of the comparison started by #BLO_memfile_id_compare_begin. */
+  uint compare_id_session_uuid;
+  MemFileChunk *compare_first_chunk;
+  MemFileChunk *compare_chunk;
+  size_t compare_chunk_offset;
+  bool compare_is_equal;
 } MemFileWriteData;
 
 typedef struct MemFileUndoData {
@@ -69,6 +76,22 @@ void BLO_memfile_write_init(MemFileWriteData *mem_data,
 void BLO_memfile_write_finalize(MemFileWriteData *mem_data);
 
 void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t size);
+/**
+ * Start comparing the data written for an ID with the chunks the reference memfile stores for
+ * it, see #BLO_memfile_id_compare_data. Nothing is added to the written memfile meanwhile.
+ *
+ * \return false when the reference memfile has no chunks for that ID.
+ */
+bool BLO_memfile_id_compare_begin(MemFileWriteData *mem_data, uint id_session_uuid);
+void BLO_memfile_id_compare_data(MemFileWriteData *mem_data, const char *buf, size_t size);
+/**
+ * End the comparison started by #BLO_memfile_id_compare_begin.
+ *
+ * \return true when the compared data exactly matches all the reference chunks of the ID. Those
+ * chunks are then added to the written memfile, sharing their memory. Otherwise the ID still has
+ * to be written.
+ */
+bool BLO_memfile_id_compare_end(MemFileWriteData *mem_data);
 
 /* exports */
 
@@ -53,6 +53,8 @@
 #include "BLI_math.h"
 #include "BLI_memarena.h"
 #include "BLI_mempool.h"
+#include "BLI_mmap.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
 #include "PIL_time.h"
@@ -1137,6 +1139,170 @@ static int *read_file_thumbnail(FileData *fd)
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Lazy Packed Data
+ *
+ * With #G_FILE_LAZY_PACKED_DATA, large raw data blocks of uncompressed files are not read along
+ * with their data-block. When they turn out to be packed file payloads, the packed file points
+ * into a memory mapping of the blend file, so the OS only loads them when they are accessed.
+ * Other raw data is read as usual on first lookup.
+ *
+ * Mappings stay alive as long as the #FileData reading them or any packed file uses them.
+ * \{ */
+
+/* Smaller payloads are read as usual, mapping them is not worth the page granularity. */
+#define LAZY_PACKED_DATA_SIZE_MIN (256 * 1024)
+
+typedef struct LazyFileMapping {
+  struct LazyFileMapping *next, *prev;
+  BLI_mmap_file *mmap;
+  const char *data;
+  size_t length;
+  int users;
+} LazyFileMapping;
+
+static ListBase lazy_file_mappings = {NULL, NULL};
+static ThreadMutex lazy_file_mappings_mutex = BLI_MUTEX_INITIALIZER;
+
+static LazyFileMapping *lazy_file_mapping_open(int filedes)
+{
+  BLI_mmap_file *mmap = BLI_mmap_open(filedes);
+  if (mmap == NULL) {
+    return NULL;
+  }
+  LazyFileMapping *mapping = MEM_callocN(sizeof(LazyFileMapping), __func__);
+  mapping->mmap = mmap;
+  mapping->data = BLI_mmap_get_pointer(mmap);
+  mapping->length = (size_t)BLI_lseek(filedes, 0, SEEK_END);
+  /* The user is the #FileData reading the file. */
+  mapping->users = 1;
+
+  BLI_mutex_lock(&lazy_file_mappings_mutex);
+  BLI_addtail(&lazy_file_mappings, mapping);
+  BLI_mutex_unlock(&lazy_file_mappings_mutex);
+  return mapping;
+}
+
+static void lazy_file_mapping_user_remove_locked(LazyFileMapping *mapping)
+{
+  BLI_assert(mapping->users > 0);
+  mapping->users--;
+  if (mapping->users == 0) {
+    BLI_remlink(&lazy_file_mappings, mapping);
+    BLI_mmap_free(mapping->mmap);
+    MEM_freeN(mapping);
+  }
+}
+
+static LazyFileMapping *lazy_file_mapping_find_locked(const void *data)
+{
+  LISTBASE_FOREACH (LazyFileMapping *, mapping, &lazy_file_mappings) {
+    if ((const char *)data >= mapping->data &&
+        (const char *)data < mapping->data + mapping->length) {
+      return mapping;
+    }
+  }
+  return NULL;
+}
+
+bool BLO_packed_data_is_mapped(const void *data)
+{
+  BLI_mutex_lock(&lazy_file_mappings_mutex);
+  const bool is_mapped = lazy_file_mapping_find_locked(data) != NULL;
+  BLI_mutex_unlock(&lazy_file_mappings_mutex);
+  return is_mapped;
+}
+
+bool BLO_packed_data_user_add(const void *data)
+{
+  BLI_mutex_lock(&lazy_file_mappings_mutex);
+  LazyFileMapping *mapping = lazy_file_mapping_find_locked(data);
+  if (mapping) {
+    mapping->users++;
+  }
+  BLI_mutex_unlock(&lazy_file_mappings_mutex);
+  return mapping != NULL;
+}
+
+bool BLO_packed_data_release(const void *data)
+{
+  BLI_mutex_lock(&lazy_file_mappings_mutex);
+  LazyFileMapping *mapping = lazy_file_mapping_find_locked(data);
+  if (mapping) {
+    lazy_file_mapping_user_remove_locked(mapping);
+  }
+  BLI_mutex_unlock(&lazy_file_mappings_mutex);
+  return mapping != NULL;
+}
+
+static void lazy_file_mapping_free(FileData *fd)
+{
+  if (fd->lazymap) {
+    BLI_ghash_free(fd->lazymap, NULL, NULL);
+  }
+  if (fd->lazy_mapping) {
+    BLI_mutex_lock(&lazy_file_mappings_mutex);
+    lazy_file_mapping_user_remove_locked(fd->lazy_mapping);
+    BLI_mutex_unlock(&lazy_file_mappings_mutex);
+  }
+}
+
+/* Whether reading the data of this #BHead is deferred until it is looked up. */
+static bool lazy_packed_data_use(FileData *fd, BHead *bhead)
+{
+#ifdef USE_BHEAD_READ_ON_DEMAND
+  /* Packed file payloads are written with #BLO_write_raw. */
+  return fd->lazymap != NULL && bhead->SDNAnr == 0 && bhead->nr == 1 &&
+         bhead->len >= LAZY_PACKED_DATA_SIZE_MIN && !BHEADN_FROM_BHEAD(bhead)->has_data &&
+         (size_t)BHEADN_FROM_BHEAD(bhead)->file_offset + (size_t)bhead->len <=
+             fd->lazy_mapping->length;
+#else
+  UNUSED_VARS(fd, bhead);
+  return false;
+#endif
+}
+
+/* Point packed file data into the mapping of the file. */
+static void *lazy_packed_data_map(FileData *fd, const void *adr)
+{
+#ifdef USE_BHEAD_READ_ON_DEMAND
+  BHead *bhead = BLI_ghash_popkey(fd->lazymap, adr, NULL);
+  if (bhead == NULL) {
+    return NULL;
+  }
+  BLI_mutex_lock(&lazy_file_mappings_mutex);
+  fd->lazy_mapping->users++;
+  BLI_mutex_unlock(&lazy_file_mappings_mutex);
+  return (void *)(fd->lazy_mapping->data + BHEADN_FROM_BHEAD(bhead)->file_offset);
+#else
+  UNUSED_VARS(fd, adr);
+  return NULL;
+#endif
+}
+
+/* Deferred data that is not a packed file payload is read as usual. */
+static void *lazy_packed_data_read(FileData *fd, const void *adr, const bool increase_users)
+{
+  BHead *bhead = BLI_ghash_popkey(fd->lazymap, adr, NULL);
+  if (bhead == NULL) {
+    return NULL;
+  }
+  void *data = read_struct(fd, bhead, "Data from lazy read");
+  if (data) {
+    oldnewmap_insert(fd->datamap, adr, data, increase_users ? 1 : 0);
+  }
+  return data;
+}
+
+static void lazy_packed_data_clear(FileData *fd)
+{
+  if (fd->lazymap) {
+    BLI_ghash_clear(fd->lazymap, NULL, NULL);
+  }
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name File Data API
  * \{ */
@@ -1188,6 +1354,7 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
   char header[7];
   FileReader *rawfile = BLI_filereader_new_file(filedes);
   FileReader *file = NULL;
+  LazyFileMapping *lazy_mapping = NULL;
 
   errno = 0;
   /* If opening the file failed or we can't read the header, give up. */
@@ -1213,6 +1380,12 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
   if (memcmp(header, "BLENDER", sizeof(header)) == 0) {
     /* Try opening the file with memory-mapped IO. */
     file = BLI_filereader_new_mmap(filedes);
+#ifndef WIN32
+    /* Windows cannot replace a file that is still mapped, saving over it would fail. */
+    if (file != NULL && (G.fileflags & G_FILE_LAZY_PACKED_DATA)) {
+      lazy_mapping = lazy_file_mapping_open(filedes);
+    }
+#endif
     if (file == NULL) {
       /* mmap failed, so just keep using rawfile. */
       file = rawfile;
@@ -1243,6 +1416,10 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
 
   FileData *fd = filedata_new(reports);
   fd->file = file;
+  if (lazy_mapping) {
+    fd->lazy_mapping = lazy_mapping;
+    fd->lazymap = BLI_ghash_ptr_new(__func__);
+  }
 
   return fd;
 }
@@ -1375,6 +1552,7 @@ void blo_filedata_free(FileData *fd)
     if (fd->packedmap) {
       oldnewmap_free(fd->packedmap);
     }
+    lazy_file_mapping_free(fd);
     if (fd->libmap && !(fd->flags & FD_FLAGS_NOT_MY_LIBMAP)) {
       oldnewmap_free(fd->libmap);
     }
@@ -1507,13 +1685,21 @@ BlendThumbnail *BLO_thumbnail_from_file(const char *filepath)
 /* Only direct data-blocks. */
 static void *newdataadr(FileData *fd, const void *adr)
 {
-  return oldnewmap_lookup_and_inc(fd->datamap, adr, true);
+  void *newp = oldnewmap_lookup_and_inc(fd->datamap, adr, true);
+  if (UNLIKELY(newp == NULL && fd->lazymap && adr)) {
+    newp = lazy_packed_data_read(fd, adr, true);
+  }
+  return newp;
 }
 
 /* Only direct data-blocks. */
 static void *newdataadr_no_us(FileData *fd, const void *adr)
 {
-  return oldnewmap_lookup_and_inc(fd->datamap, adr, false);
+  void *newp = oldnewmap_lookup_and_inc(fd->datamap, adr, false);
+  if (UNLIKELY(newp == NULL && fd->lazymap && adr)) {
+    newp = lazy_packed_data_read(fd, adr, false);
+  }
+  return newp;
 }
 
 void *blo_read_get_new_globaldata_address(FileData *fd, const void *adr)
@@ -1528,7 +1714,11 @@ static void *newpackedadr(FileData *fd, const void *adr)
     return oldnewmap_lookup_and_inc(fd->packedmap, adr, true);
   }
 
-  return oldnewmap_lookup_and_inc(fd->datamap, adr, true);
+  void *newp = oldnewmap_lookup_and_inc(fd->datamap, adr, true);
+  if (newp == NULL && fd->lazymap && adr) {
+    newp = lazy_packed_data_map(fd, adr);
+  }
+  return newp;
 }
 
 /* only lib data */
@@ -1861,6 +2051,41 @@ static void switch_endian_structs(const struct SDNA *filesdna, BHead *bhead)
   }
 }
 
+/**
+ * Whether the data of the block has to be converted from the file DNA, which requires the data to
+ * be in memory, see #read_struct_convert.
+ */
+static bool read_struct_needs_convert(const FileData *fd, const BHead *bh)
+{
+  return bh->len && ((bh->SDNAnr && (fd->flags & FD_FLAGS_SWITCH_ENDIAN)) ||
+                     fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL);
+}
+
+/**
+ * Convert the data of a block that is in memory to the current DNA.
+ * Only reads from \a fd, so different blocks can be converted from multiple threads.
+ */
+static void *read_struct_convert(const FileData *fd, BHead *bh, const char *blockname)
+{
+  /* switch is based on file dna */
+  if (bh->SDNAnr && (fd->flags & FD_FLAGS_SWITCH_ENDIAN)) {
+    switch_endian_structs(fd->filesdna, bh);
+  }
+
+  switch (fd->compflags[bh->SDNAnr]) {
+    case SDNA_CMP_REMOVED:
+      return NULL;
+    case SDNA_CMP_NOT_EQUAL:
+      return DNA_struct_reconstruct(fd->reconstruct_info, bh->SDNAnr, bh->nr, (bh + 1));
+    default: {
+      /* SDNA_CMP_EQUAL */
+      void *temp = MEM_mallocN(bh->len, blockname);
+      memcpy(temp, (bh + 1), bh->len);
+      return temp;
+    }
+  }
+}
+
 static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
 {
   void *temp = NULL;
@@ -1870,8 +2095,7 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
     BHead *bh_orig = bh;
 #endif
 
-    /* switch is based on file dna */
-    if (bh->SDNAnr && (fd->flags & FD_FLAGS_SWITCH_ENDIAN)) {
+    if (read_struct_needs_convert(fd, bh)) {
 #ifdef USE_BHEAD_READ_ON_DEMAND
       if (BHEADN_FROM_BHEAD(bh)->has_data == false) {
         bh = blo_bhead_read_full(fd, bh);
@@ -1881,42 +2105,27 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
         }
       }
 #endif
-      switch_endian_structs(fd->filesdna, bh);
+      temp = read_struct_convert(fd, bh, blockname);
     }
-
-    if (fd->compflags[bh->SDNAnr] != SDNA_CMP_REMOVED) {
-      if (fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL) {
+    else if (fd->compflags[bh->SDNAnr] != SDNA_CMP_REMOVED) {
+      /* SDNA_CMP_EQUAL */
+      temp = MEM_mallocN(bh->len, blockname);
 #ifdef USE_BHEAD_READ_ON_DEMAND
-        if (BHEADN_FROM_BHEAD(bh)->has_data == false) {
-          bh = blo_bhead_read_full(fd, bh);
-          if (UNLIKELY(bh == NULL)) {
-            fd->flags &= ~FD_FLAGS_FILE_OK;
-            return NULL;
-          }
-        }
-#endif
-        temp = DNA_struct_reconstruct(fd->reconstruct_info, bh->SDNAnr, bh->nr, (bh + 1));
+      if (BHEADN_FROM_BHEAD(bh)->has_data) {
+        memcpy(temp, (bh + 1), bh->len);
       }
       else {
-        /* SDNA_CMP_EQUAL */
-        temp = MEM_mallocN(bh->len, blockname);
-#ifdef USE_BHEAD_READ_ON_DEMAND
-        if (BHEADN_FROM_BHEAD(bh)->has_data) {
-          memcpy(temp, (bh + 1), bh->len);
-        }
-        else {
-          /* Instead of allocating the bhead, then copying it,
-           * read the data from the file directly into the memory. */
-          if (UNLIKELY(!blo_bhead_read_data(fd, bh, temp))) {
-            fd->flags &= ~FD_FLAGS_FILE_OK;
-            MEM_freeN(temp);
-            temp = NULL;
-          }
+        /* Instead of allocating the bhead, then copying it,
+         * read the data from the file directly into the memory. */
+        if (UNLIKELY(!blo_bhead_read_data(fd, bh, temp))) {
+          fd->flags &= ~FD_FLAGS_FILE_OK;
+          MEM_freeN(temp);
+          temp = NULL;
         }
+      }
 #else
-        memcpy(temp, (bh + 1), bh->len);
+      memcpy(temp, (bh + 1), bh->len);
 #endif
-      }
     }
 
 #ifdef USE_BHEAD_READ_ON_DEMAND
@@ -3056,9 +3265,94 @@ static bool direct_link_id(FileData *fd, Main *main, const int tag, ID *id, ID *
   return success;
 }
 
-/* Read all data associated with a datablock into datamap. */
+/** A data block of an ID, read in order but converted to the current DNA in parallel. */
+typedef struct ReadDataBlock {
+  BHead *bhead;
+  /** The block with its data in memory, only set when it needs to be converted. */
+  BHead *bhead_full;
+  void *data;
+} ReadDataBlock;
+
+typedef struct ReadDataBlocks {
+  const FileData *fd;
+  const char *allocname;
+
+  ReadDataBlock *blocks;
+  int blocks_len;
+  int blocks_alloc;
+  /** Number of blocks and size of the data waiting to be converted. */
+  int convert_len;
+  size_t convert_size;
+} ReadDataBlocks;
+
+/** Limit the memory used by the data read from the file but not converted yet. */
+#define READ_DATA_CONVERT_SIZE_MAX (64 * 1024 * 1024)
+
+static void read_data_blocks_convert_fn(void *__restrict userdata,
+                                        const int index,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ReadDataBlocks *data_blocks = userdata;
+  ReadDataBlock *block = &data_blocks->blocks[index];
+  if (block->bhead_full != NULL) {
+    block->data = read_struct_convert(data_blocks->fd, block->bhead_full, data_blocks->allocname);
+  }
+}
+
+/** Convert the pending blocks and add them to the datamap, in the order they were read. */
+static void read_data_blocks_flush(FileData *fd, ReadDataBlocks *data_blocks)
+{
+  if (data_blocks->convert_len != 0) {
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.use_threading = data_blocks->convert_len > 1;
+    settings.min_iter_per_thread = 1;
+    BLI_task_parallel_range(
+        0, data_blocks->blocks_len, data_blocks, read_data_blocks_convert_fn, &settings);
+  }
+
+  for (int i = 0; i < data_blocks->blocks_len; i++) {
+    ReadDataBlock *block = &data_blocks->blocks[i];
+    if (block->data) {
+      oldnewmap_insert(fd->datamap, block->bhead->old, block->data, 0);
+    }
+#ifdef USE_BHEAD_READ_ON_DEMAND
+    if (!ELEM(block->bhead_full, NULL, block->bhead)) {
+      MEM_freeN(BHEADN_FROM_BHEAD(block->bhead_full));
+    }
+#endif
+  }
+
+  data_blocks->blocks_len = 0;
+  data_blocks->convert_len = 0;
+  data_blocks->convert_size = 0;
+}
+
+static ReadDataBlock *read_data_blocks_add(ReadDataBlocks *data_blocks, BHead *bhead)
+{
+  if (data_blocks->blocks_len == data_blocks->blocks_alloc) {
+    data_blocks->blocks_alloc = max_ii(16, data_blocks->blocks_alloc * 2);
+    data_blocks->blocks = MEM_reallocN(data_blocks->blocks,
+                                       sizeof(*data_blocks->blocks) * data_blocks->blocks_alloc);
+  }
+  ReadDataBlock *block = &data_blocks->blocks[data_blocks->blocks_len++];
+  block->bhead = bhead;
+  block->bhead_full = NULL;
+  block->data = NULL;
+  return block;
+}
+
+/**
+ * Read all data associated with a datablock into datamap.
+ *
+ * When the file was written with another DNA or endianness, converting the data is the most
+ * expensive part of reading it, so that is done for all blocks of the ID in parallel. Reading
+ * from the file and filling the datamap stays serial.
+ */
 static BHead *read_data_into_datamap(FileData *fd, BHead *bhead, const char *allocname)
 {
+  ReadDataBlocks data_blocks = {fd, allocname};
+
   bhead = blo_bhead_next(fd, bhead);
 
   while (bhead && bhead->code == DATA) {
@@ -3078,14 +3372,41 @@ static BHead *read_data_into_datamap(FileData *fd, BHead *bhead, const char *all
     }
 #endif
 
-    void *data = read_struct(fd, bhead, allocname);
-    if (data) {
-      oldnewmap_insert(fd->datamap, bhead->old, data, 0);
+    if (lazy_packed_data_use(fd, bhead)) {
+      /* Read when looked up, see #newpackedadr and #newdataadr. */
+      BLI_ghash_reinsert(fd->lazymap, (void *)bhead->old, bhead, NULL, NULL);
+    }
+    else if (read_struct_needs_convert(fd, bhead)) {
+      BHead *bhead_full = bhead;
+#ifdef USE_BHEAD_READ_ON_DEMAND
+      if (BHEADN_FROM_BHEAD(bhead)->has_data == false) {
+        bhead_full = blo_bhead_read_full(fd, bhead);
+        if (UNLIKELY(bhead_full == NULL)) {
+          fd->flags &= ~FD_FLAGS_FILE_OK;
+        }
+      }
+#endif
+      if (bhead_full != NULL) {
+        ReadDataBlock *block = read_data_blocks_add(&data_blocks, bhead);
+        block->bhead_full = bhead_full;
+        data_blocks.convert_len++;
+        data_blocks.convert_size += (size_t)bhead->len;
+        if (data_blocks.convert_size > READ_DATA_CONVERT_SIZE_MAX) {
+          read_data_blocks_flush(fd, &data_blocks);
+        }
+      }
+    }
+    else {
+      ReadDataBlock *block = read_data_blocks_add(&data_blocks, bhead);
+      block->data = read_struct(fd, bhead, allocname);
     }
 
     bhead = blo_bhead_next(fd, bhead);
   }
 
+  read_data_blocks_flush(fd, &data_blocks);
+  MEM_SAFE_FREE(data_blocks.blocks);
+
   return bhead;
 }
 
@@ -3431,6 +3752,7 @@ static BHead *read_libblock(FileData *fd,
   bhead = read_data_into_datamap(fd, bhead, allocname);
   const bool success = direct_link_id(fd, main, id_tag, id, id_old);
   oldnewmap_clear(fd->datamap);
+  lazy_packed_data_clear(fd);
 
   if (!success) {
     /* XXX This is probably working OK currently given the very limited scope of that flag.
@@ -3474,6 +3796,7 @@ BHead *blo_read_asset_data_block(FileData *fd, BHead *bhead, AssetMetaData **r_a
   BKE_asset_metadata_read(&reader, *r_asset_data);
 
   oldnewmap_clear(fd->datamap);
+  lazy_packed_data_clear(fd);
 
   return bhead;
 }
@@ -3821,6 +4144,7 @@ static BHead *read_userdef(BlendFileData *bfd, FileData *fd, BHead *bhead)
 
   /* free fd->datamap again */
   oldnewmap_clear(fd->datamap);
+  lazy_packed_data_clear(fd);
 
   return bhead;
 }
@@ -21,6 +21,7 @@ struct BLI_mmap_file;
 struct BLOCacheStorage;
 struct IDNameLib_Map;
 struct Key;
+struct LazyFileMapping;
 struct MemFile;
 struct Object;
 struct OldNewMap;
@@ -92,6 +93,11 @@ typedef struct FileData {
   struct OldNewMap *packedmap;
   struct BLOCacheStorage *cache_storage;
 
+  /** Mapping of the file for #G_FILE_LAZY_PACKED_DATA, NULL when not reading lazily. */
+  struct LazyFileMapping *lazy_mapping;
+  /** Data #BHead that were not read yet because they may be packed file payloads. */
+  struct GHash *lazymap;
+
   struct BHeadSort *bheadmap;
   int tot_bheadmap;
 
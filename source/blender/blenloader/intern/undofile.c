@@ -172,6 +172,81 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
   }
 }
 
+bool BLO_memfile_id_compare_begin(MemFileWriteData *mem_data, const uint id_session_uuid)
+{
+  if (mem_data->id_session_uuid_mapping == NULL) {
+    return false;
+  }
+  MemFileChunk *compchunk = BLI_ghash_lookup(mem_data->id_session_uuid_mapping,
+                                             POINTER_FROM_UINT(id_session_uuid));
+  if (compchunk == NULL) {
+    return false;
+  }
+
+  mem_data->compare_id_session_uuid = id_session_uuid;
+  mem_data->compare_first_chunk = compchunk;
+  mem_data->compare_chunk = compchunk;
+  mem_data->compare_chunk_offset = 0;
+  mem_data->compare_is_equal = true;
+  return true;
+}
+
+void BLO_memfile_id_compare_data(MemFileWriteData *mem_data, const char *buf, size_t size)
+{
+  /* The written data is compared as one stream, it does not have to be split in chunks the same
+   * way as the reference data. */
+  while (size > 0 && mem_data->compare_is_equal) {
+    MemFileChunk *compchunk = mem_data->compare_chunk;
+    if (compchunk == NULL || compchunk->id_session_uuid != mem_data->compare_id_session_uuid) {
+      mem_data->compare_is_equal = false;
+      break;
+    }
+
+    const size_t len = MIN2(size, compchunk->size - mem_data->compare_chunk_offset);
+    if (memcmp(compchunk->buf + mem_data->compare_chunk_offset, buf, len) != 0) {
+      mem_data->compare_is_equal = false;
+      break;
+    }
+    buf += len;
+    size -= len;
+    mem_data->compare_chunk_offset += len;
+
+    if (mem_data->compare_chunk_offset == compchunk->size) {
+      mem_data->compare_chunk = compchunk->next;
+      mem_data->compare_chunk_offset = 0;
+    }
+  }
+}
+
+bool BLO_memfile_id_compare_end(MemFileWriteData *mem_data)
+{
+  const uint id_session_uuid = mem_data->compare_id_session_uuid;
+  MemFileChunk *compchunk_end = mem_data->compare_chunk;
+
+  /* All the reference chunks of the ID must have been entirely matched. */
+  if (!mem_data->compare_is_equal ||
+      (compchunk_end != NULL && compchunk_end->id_session_uuid == id_session_uuid)) {
+    return false;
+  }
+
+  MemFile *memfile = mem_data->written_memfile;
+  for (MemFileChunk *compchunk = mem_data->compare_first_chunk; compchunk != compchunk_end;
+       compchunk = compchunk->next) {
+    MemFileChunk *curchunk = MEM_mallocN(sizeof(MemFileChunk), "MemFileChunk");
+    curchunk->buf = compchunk->buf;
+    curchunk->size = compchunk->size;
+    curchunk->is_identical = true;
+    curchunk->is_identical_future = true;
+    curchunk->id_session_uuid = id_session_uuid;
+    BLI_addtail(&memfile->chunks, curchunk);
+
+    compchunk->is_identical_future = true;
+  }
+
+  mem_data->reference_current_chunk = compchunk_end;
+  return true;
+}
+
 struct Main *BLO_memfile_main_get(struct MemFile *memfile,
                                   struct Main *bmain,
                                   struct Scene **r_scene)
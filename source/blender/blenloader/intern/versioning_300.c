@@ -26,6 +26,7 @@
 #include "DNA_constraint_types.h"
 #include "DNA_curve_types.h"
 #include "DNA_curves_types.h"
+#include "DNA_defaults.h"
 #include "DNA_genfile.h"
 #include "DNA_gpencil_modifier_types.h"
 #include "DNA_lineart_types.h"
@@ -3318,5 +3319,23 @@ void blo_do_versions_300(FileData *fd, Library *UNUSED(lib), Main *bmain)
    */
   {
     /* Keep this block, even when empty. */
+
+    /* OpenMfx bake cache settings. */
+    if (!DNA_struct_elem_find(fd->filesdna, "OpenMfxModifierData", "int", "cache_readahead")) {
+      const OpenMfxModifierData *fxmd_default = DNA_struct_default_get(OpenMfxModifierData);
+      LISTBASE_FOREACH (Object *, ob, &bmain->objects) {
+        LISTBASE_FOREACH (ModifierData *, md, &ob->modifiers) {
+          if (md->type != eModifierType_OpenMfx) {
+            continue;
+          }
+          OpenMfxModifierData *fxmd = (OpenMfxModifierData *)md;
+          STRNCPY(fxmd->cache_directory, "//cache_openmfx");
+          fxmd->flag = fxmd_default->flag;
+          fxmd->cache_frame_start = fxmd_default->cache_frame_start;
+          fxmd->cache_frame_end = fxmd_default->cache_frame_end;
+          fxmd->cache_readahead = fxmd_default->cache_readahead;
+        }
+      }
+    }
   }
 }
@@ -81,12 +81,15 @@
 #include "DNA_collection_types.h"
 #include "DNA_fileglobal_types.h"
 #include "DNA_genfile.h"
+#include "DNA_mesh_types.h"
+#include "DNA_object_types.h"
 #include "DNA_sdna_types.h"
 
 #include "BLI_bitmap.h"
 #include "BLI_blenlib.h"
 #include "BLI_endian_defines.h"
 #include "BLI_endian_switch.h"
+#include "BLI_ghash.h"
 #include "BLI_link_utils.h"
 #include "BLI_linklist.h"
 #include "BLI_math_base.h"
@@ -421,6 +424,11 @@ typedef struct {
   MemFileWriteData mem;
   /** When true, write to #WriteData.current, could also call 'is_undo'. */
   bool use_memfile;
+  /**
+   * When true, written data is only compared with the reference #MemFile,
+   * see #BLO_memfile_id_compare_begin.
+   */
+  bool use_memfile_compare;
 
   /**
    * Wrap writing, so we can use zstd or
@@ -525,6 +533,11 @@ static void mywrite(WriteData *wd, const void *adr, size_t len)
     return;
   }
 
+  if (wd->use_memfile_compare) {
+    BLO_memfile_id_compare_data(&wd->mem, adr, len);
+    return;
+  }
+
 #ifdef USE_WRITE_DATA_LEN
   wd->write_len += len;
 #endif
@@ -1075,6 +1088,107 @@ static void write_thumb(WriteData *wd, const BlendThumbnail *thumb)
   }
 }
 
+/**
+ * Object data that may have changed since the last undo push without its own ID being tagged for
+ * update: sculpt and paint modes edit the mesh arrays in place and only tag the object.
+ */
+static GSet *write_memfile_modified_object_data(Main *mainvar)
+{
+  const int ob_recalc_ignored = ID_RECALC_TRANSFORM | ID_RECALC_SELECT | ID_RECALC_BASE_FLAGS;
+
+  GSet *modified_data = BLI_gset_ptr_new(__func__);
+  LISTBASE_FOREACH (Object *, ob, &mainvar->objects) {
+    if (ob->data == NULL) {
+      continue;
+    }
+    if (ob->mode != OB_MODE_OBJECT || (ob->id.recalc_after_undo_push & ~ob_recalc_ignored) != 0) {
+      BLI_gset_add(modified_data, ob->data);
+    }
+  }
+  return modified_data;
+}
+
+/**
+ * Whether that ID is expected to be unchanged since the reference undo step, based on the
+ * depsgraph tags accumulated since the last undo push. This is limited to meshes, whose
+ * (potentially huge) geometry usually is tagged when modified. Data can still be changed without
+ * any tag (e.g. from Python), so this only selects the IDs worth comparing without writing them,
+ * see #write_memfile_id_compare.
+ *
+ * \note Must be called before the ID recalc flags are reset for the next undo push.
+ */
+static bool write_memfile_id_is_unchanged(const ID *id, GSet *modified_object_data)
+{
+  if (modified_object_data == NULL || GS(id->name) != ID_ME) {
+    return false;
+  }
+  /* Also require the flags stored in the previous step to be cleared, otherwise the ID struct
+   * written now would differ from the stored one. */
+  if (id->recalc_after_undo_push != 0 || id->recalc_up_to_undo_push != 0) {
+    return false;
+  }
+  if (((const Mesh *)id)->edit_mesh != NULL) {
+    return false;
+  }
+  return !BLI_gset_haskey(modified_object_data, id);
+}
+
+/**
+ * Write an ID and all of its data, using `id_buffer` as temporary storage for the ID struct.
+ */
+static void write_id(BlendWriter *writer, ID *id, void *id_buffer, const IDTypeInfo *id_type)
+{
+  memcpy(id_buffer, id, id_type->struct_size);
+
+  /* Clear runtime data to reduce false detection of changed data in undo/redo context. */
+  ((ID *)id_buffer)->tag = 0;
+  ((ID *)id_buffer)->us = 0;
+  ((ID *)id_buffer)->icon_id = 0;
+  /* Those listbase data change every time we add/remove an ID, and also often when
+   * renaming one (due to re-sorting). This avoids generating a lot of false 'is changed'
+   * detections between undo steps. */
+  ((ID *)id_buffer)->prev = NULL;
+  ((ID *)id_buffer)->next = NULL;
+  /* Those runtime pointers should never be set during writing stage, but just in case clear
+   * them too. */
+  ((ID *)id_buffer)->orig_id = NULL;
+  ((ID *)id_buffer)->newid = NULL;
+  /* Even though in theory we could be able to preserve this python instance across undo even
+   * when we need to re-read the ID into its original address, this is currently cleared in
+   * #direct_link_id_common in `readfile.c` anyway, */
+  ((ID *)id_buffer)->py_instance = NULL;
+
+  if (id_type->blend_write != NULL) {
+    id_type->blend_write(writer, (ID *)id_buffer, id);
+  }
+}
+
+/**
+ * Compare the data of an ID expected to be unchanged with the one stored in the reference undo
+ * step, and share the stored chunks if it matches. Unlike regular writing, the data is compared
+ * directly, without being copied to the write buffer, and the comparison stops at the first
+ * difference.
+ *
+ * \return false when the ID differs, it then has to be written.
+ */
+static bool write_memfile_id_compare(WriteData *wd,
+                                     BlendWriter *writer,
+                                     ID *id,
+                                     void *id_buffer,
+                                     const IDTypeInfo *id_type)
+{
+  mywrite_flush(wd);
+  if (!BLO_memfile_id_compare_begin(&wd->mem, id->session_uuid)) {
+    return false;
+  }
+
+  wd->use_memfile_compare = true;
+  write_id(writer, id, id_buffer, id_type);
+  wd->use_memfile_compare = false;
+
+  return BLO_memfile_id_compare_end(&wd->mem);
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -1120,6 +1234,13 @@ static bool write_file_handle(Main *mainvar,
                                                  NULL :
                                                  BKE_lib_override_library_operations_store_init();
 
+  /* Unchanged meshes are not written again for undo steps, but share the memory of the previous
+   * step. A full barrier means the previous step cannot be trusted to match current data. */
+  GSet *modified_object_data = (wd->use_memfile && wd->mem.id_session_uuid_mapping != NULL &&
+                                !mainvar->use_memfile_full_barrier) ?
+                                   write_memfile_modified_object_data(mainvar) :
+                                   NULL;
+
 #define ID_BUFFER_STATIC_SIZE 8192
   /* This outer loop allows to save first data-blocks from real mainvar,
    * then the temp ones from override process,
@@ -1170,7 +1291,10 @@ static bool write_file_handle(Main *mainvar,
           BKE_lib_override_library_operations_store_start(bmain, override_storage, id);
         }
 
+        bool is_unchanged = false;
         if (wd->use_memfile) {
+          is_unchanged = write_memfile_id_is_unchanged(id, modified_object_data);
+
           /* Record the changes that happened up to this undo push in
            * recalc_up_to_undo_push, and clear recalc_after_undo_push again
            * to start accumulating for the next undo push. */
@@ -1192,31 +1316,14 @@ static bool write_file_handle(Main *mainvar,
           }
         }
 
+        if (is_unchanged && write_memfile_id_compare(wd, &writer, id, id_buffer, id_type)) {
+          BLI_assert(!do_override);
+          continue;
+        }
+
         mywrite_id_begin(wd, id);
 
-        memcpy(id_buffer, id, idtype_struct_size);
-
-        /* Clear runtime data to reduce false detection of changed data in undo/redo context. */
-        ((ID *)id_buffer)->tag = 0;
-        ((ID *)id_buffer)->us = 0;
-        ((ID *)id_buffer)->icon_id = 0;
-        /* Those listbase data change every time we add/remove an ID, and also often when
-         * renaming one (due to re-sorting). This avoids generating a lot of false 'is changed'
-         * detections between undo steps. */
-        ((ID *)id_buffer)->prev = NULL;
-        ((ID *)id_buffer)->next = NULL;
-        /* Those runtime pointers should never be set during writing stage, but just in case clear
-         * them too. */
-        ((ID *)id_buffer)->orig_id = NULL;
-        ((ID *)id_buffer)->newid = NULL;
-        /* Even though in theory we could be able to preserve this python instance across undo even
-         * when we need to re-read the ID into its original address, this is currently cleared in
-         * #direct_link_id_common in `readfile.c` anyway, */
-        ((ID *)id_buffer)->py_instance = NULL;
-
-        if (id_type->blend_write != NULL) {
-          id_type->blend_write(&writer, (ID *)id_buffer, id);
-        }
+        write_id(&writer, id, id_buffer, id_type);
 
         if (do_override) {
           BKE_lib_override_library_operations_store_end(override_storage, id);
@@ -1238,6 +1345,10 @@ static bool write_file_handle(Main *mainvar,
     override_storage = NULL;
   }
 
+  if (modified_object_data != NULL) {
+    BLI_gset_free(modified_object_data, NULL);
+  }
+
   /* Special handling, operating over split Mains... */
   write_libraries(wd, mainvar->next);
 
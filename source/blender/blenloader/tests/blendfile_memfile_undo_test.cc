@@ -0,0 +1,134 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+#include "blendfile_loading_base_test.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BKE_customdata.h"
+#include "BKE_main.h"
+#include "BKE_mesh.h"
+
+#include "BLI_listbase.h"
+#include "BLI_vector.hh"
+
+#include "BLO_undofile.h"
+#include "BLO_writefile.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include <memory>
+
+using blender::Vector;
+
+class MemfileUndoTest : public BlendfileLoadingBaseTest {
+ protected:
+  Main *bmain = nullptr;
+  Vector<std::unique_ptr<MemFile>> memfiles;
+
+  void SetUp() override
+  {
+    BlendfileLoadingBaseTest::SetUp();
+    bmain = BKE_main_new();
+  }
+
+  void TearDown() override
+  {
+    /* Newer steps share the memory of older ones, free them first. */
+    while (!memfiles.is_empty()) {
+      BLO_memfile_free(memfiles.last().get());
+      memfiles.remove_last();
+    }
+    BKE_main_free(bmain);
+    BlendfileLoadingBaseTest::TearDown();
+  }
+
+  /**
+   * Write an undo step of #bmain, compared with the previous one like global undo does.
+   */
+  const MemFile *write_undo_step()
+  {
+    MemFile *reference = memfiles.is_empty() ? nullptr : memfiles.last().get();
+    memfiles.append(std::make_unique<MemFile>());
+    BLO_write_file_mem(bmain, reference, memfiles.last().get(), 0);
+    return memfiles.last().get();
+  }
+
+  Mesh *add_mesh(const char *name, int verts_num)
+  {
+    Mesh *mesh = BKE_mesh_add(bmain, name);
+    CustomData_add_layer(&mesh->vdata, CD_MVERT, CD_CALLOC, nullptr, verts_num);
+    mesh->totvert = verts_num;
+    BKE_mesh_update_customdata_pointers(mesh, false);
+    for (int i = 0; i < verts_num; i++) {
+      mesh->mvert[i].co[0] = float(i);
+    }
+    return mesh;
+  }
+
+  /**
+   * Chunks that store the data of an ID in a step.
+   */
+  static Vector<const MemFileChunk *> id_chunks(const MemFile *memfile, const ID *id)
+  {
+    Vector<const MemFileChunk *> chunks;
+    LISTBASE_FOREACH (const MemFileChunk *, chunk, &memfile->chunks) {
+      if (chunk->id_session_uuid == id->session_uuid) {
+        chunks.append(chunk);
+      }
+    }
+    return chunks;
+  }
+
+  /**
+   * Whether all the chunks of an ID share the memory of the previous step.
+   */
+  static bool id_is_reused(const MemFile *memfile, const MemFile *previous, const ID *id)
+  {
+    const Vector<const MemFileChunk *> chunks = id_chunks(memfile, id);
+    const Vector<const MemFileChunk *> previous_chunks = id_chunks(previous, id);
+    if (chunks.is_empty() || chunks.size() != previous_chunks.size()) {
+      return false;
+    }
+    for (const int i : chunks.index_range()) {
+      if (!chunks[i]->is_identical || chunks[i]->buf != previous_chunks[i]->buf) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+TEST_F(MemfileUndoTest, unchanged_meshes_are_reused)
+{
+  Mesh *mesh_a = add_mesh("A", 1000);
+  Mesh *mesh_b = add_mesh("B", 1000);
+
+  /* The first steps also record the tags of the newly created meshes. */
+  write_undo_step();
+  const MemFile *previous = write_undo_step();
+  const MemFile *current = write_undo_step();
+  EXPECT_TRUE(id_is_reused(current, previous, &mesh_a->id));
+  EXPECT_TRUE(id_is_reused(current, previous, &mesh_b->id));
+
+  /* Edited in place without any depsgraph tag, like Python can do. */
+  mesh_a->mvert[500].co[1] = 42.0f;
+  previous = current;
+  current = write_undo_step();
+  EXPECT_FALSE(id_is_reused(current, previous, &mesh_a->id));
+  EXPECT_TRUE(id_is_reused(current, previous, &mesh_b->id));
+
+  /* The new data of the edited mesh is stored in the step. */
+  bool has_new_data = false;
+  for (const MemFileChunk *chunk : id_chunks(current, &mesh_a->id)) {
+    if (!chunk->is_identical) {
+      has_new_data = true;
+    }
+  }
+  EXPECT_TRUE(has_new_data);
+
+  /* And that mesh is reused again once it stops changing. */
+  previous = current;
+  current = write_undo_step();
+  EXPECT_TRUE(id_is_reused(current, previous, &mesh_a->id));
+  EXPECT_TRUE(id_is_reused(current, previous, &mesh_b->id));
+}
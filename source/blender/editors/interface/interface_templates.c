@@ -6690,15 +6690,14 @@ void uiTemplateCacheFileProcedural(uiLayout *layout, const bContext *C, PointerR
   uiLayoutSetActive(row, engine_supports_procedural);
   uiItemR(row, fileptr, "use_render_procedural", 0, NULL, ICON_NONE);
 
-  const bool use_render_procedural = RNA_boolean_get(fileptr, "use_render_procedural");
   const bool use_prefetch = RNA_boolean_get(fileptr, "use_prefetch");
 
+  /* Prefetching also applies to the playback of meshes in the viewport. */
   row = uiLayoutRow(layout, false);
-  uiLayoutSetEnabled(row, use_render_procedural);
   uiItemR(row, fileptr, "use_prefetch", 0, NULL, ICON_NONE);
 
   sub = uiLayoutRow(layout, false);
-  uiLayoutSetEnabled(sub, use_prefetch && use_render_procedural);
+  uiLayoutSetEnabled(sub, use_prefetch);
   uiItemR(sub, fileptr, "prefetch_cache_size", 0, NULL, ICON_NONE);
 }
 
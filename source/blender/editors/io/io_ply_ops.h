@@ -0,0 +1,12 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup editor/io
+ */
+
+#pragma once
+
+struct wmOperatorType;
+
+void WM_OT_ply_export(struct wmOperatorType *ot);
+void WM_OT_ply_import(struct wmOperatorType *ot);
@@ -85,6 +85,8 @@
 
 #include "MOD_nodes.h"
 
+#include "MFX_modifier.h"
+
 #include "UI_interface.h"
 
 #include "WM_api.h"
@@ -3158,6 +3160,110 @@ void OBJECT_OT_ocean_bake(wmOperatorType *ot)
 
 /** \} */
 
+/* ------------------------------------------------------------------- */
+/** \name OpenMfx Bake Operator
+ * \{ */
+
+static bool openmfx_bake_poll(bContext *C)
+{
+  return edit_modifier_poll_generic(C, &RNA_OpenMfxModifier, 0, true, false);
+}
+
+static int openmfx_bake_exec(bContext *C, wmOperator *op)
+{
+  Object *ob = ED_object_active_context(C);
+  OpenMfxModifierData *fxmd = (OpenMfxModifierData *)edit_modifier_property_get(
+      op, ob, eModifierType_OpenMfx);
+  Scene *scene = CTX_data_scene(C);
+  Depsgraph *depsgraph = CTX_data_ensure_evaluated_depsgraph(C);
+  const bool free = RNA_boolean_get(op->ptr, "free");
+
+  if (!fxmd) {
+    return OPERATOR_CANCELLED;
+  }
+
+  /* Frames of a previous bake are removed in both cases, so that no stale frame remains in the
+   * cache if the new range is shorter. */
+  MFX_modifier_bake_free(fxmd, depsgraph, ob);
+
+  if (free) {
+    DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
+    WM_event_add_notifier(C, NC_OBJECT | ND_MODIFIER, ob);
+    return OPERATOR_FINISHED;
+  }
+
+  if (fxmd->cache_frame_end < fxmd->cache_frame_start) {
+    BKE_report(op->reports, RPT_ERROR, "Bake end frame is before start frame");
+    return OPERATOR_CANCELLED;
+  }
+
+  const int cfra = scene->r.cfra;
+
+  /* The evaluated copy of the modifier writes each frame it cooks while the flag is set.
+   * Frames are evaluated one after the other through the depsgraph since the inputs of the
+   * effect may be animated, and the cache files get written in the background meanwhile. */
+  fxmd->flag |= MOD_OPENMFX_CACHE_BAKING;
+  DEG_id_tag_update(&ob->id, ID_RECALC_COPY_ON_WRITE | ID_RECALC_GEOMETRY);
+
+  WM_cursor_wait(true);
+  WM_progress_set(CTX_wm_window(C), 0.0f);
+
+  const int frame_count = fxmd->cache_frame_end - fxmd->cache_frame_start + 1;
+  for (int f = fxmd->cache_frame_start; f <= fxmd->cache_frame_end; f++) {
+    scene->r.cfra = f;
+    BKE_scene_graph_update_for_newframe(depsgraph);
+    WM_progress_set(CTX_wm_window(C), float(f - fxmd->cache_frame_start + 1) / frame_count);
+  }
+
+  const bool success = MFX_modifier_bake_wait(op->reports);
+
+  fxmd->flag &= ~MOD_OPENMFX_CACHE_BAKING;
+  if (success) {
+    fxmd->flag |= MOD_OPENMFX_CACHED;
+  }
+  else {
+    /* A partial bake would silently mix cached and cooked frames on playback. */
+    MFX_modifier_bake_free(fxmd, depsgraph, ob);
+  }
+  scene->r.cfra = cfra;
+  DEG_id_tag_update(&ob->id, ID_RECALC_COPY_ON_WRITE | ID_RECALC_GEOMETRY);
+  BKE_scene_graph_update_for_newframe(depsgraph);
+
+  WM_progress_clear(CTX_wm_window(C));
+  WM_cursor_wait(false);
+
+  WM_event_add_notifier(C, NC_OBJECT | ND_MODIFIER, ob);
+
+  return success ? OPERATOR_FINISHED : OPERATOR_CANCELLED;
+}
+
+static int openmfx_bake_invoke(bContext *C, wmOperator *op, const wmEvent *UNUSED(event))
+{
+  if (edit_modifier_invoke_properties(C, op)) {
+    return openmfx_bake_exec(C, op);
+  }
+  return OPERATOR_CANCELLED;
+}
+
+void OBJECT_OT_openmfx_bake(wmOperatorType *ot)
+{
+  ot->name = "Bake OpenMfx";
+  ot->description = "Cook the OpenMfx effect over a frame range and store the result on disk";
+  ot->idname = "OBJECT_OT_openmfx_bake";
+
+  ot->poll = openmfx_bake_poll;
+  ot->invoke = openmfx_bake_invoke;
+  ot->exec = openmfx_bake_exec;
+
+  /* flags */
+  ot->flag = OPTYPE_REGISTER | OPTYPE_INTERNAL;
+  edit_modifier_properties(ot);
+
+  RNA_def_boolean(ot->srna, "free", false, "Free", "Free the bake, rather than generating it");
+}
+
+/** \} */
+
 /* ------------------------------------------------------------------- */
 /** \name Laplacian-Deform Bind Operator
  * \{ */
@@ -94,6 +94,9 @@ struct CacheArchiveHandle *ABC_create_handle(struct Main *bmain,
 
 void ABC_free_handle(struct CacheArchiveHandle *handle);
 
+/* Memory budget in bytes for the samples read ahead of the current frame, zero disables it. */
+void ABC_set_prefetch_budget(struct CacheArchiveHandle *handle, size_t budget);
+
 void ABC_get_transform(struct CacheReader *reader,
                        float r_mat_world[4][4],
                        double time,
@@ -6,6 +6,7 @@
  */
 
 #include "abc_reader_archive.h"
+#include "abc_reader_prefetch.h"
 
 #include "Alembic/AbcCoreLayer/Read.h"
 
@@ -13,11 +14,13 @@
 
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_threads.h"
 
 #ifdef WIN32
 #  include "utfconv.h"
 #endif
 
+#include <algorithm>
 #include <fstream>
 
 using Alembic::Abc::ErrorHandler;
@@ -27,6 +30,9 @@ using Alembic::Abc::kWrapExisting;
 
 namespace blender::io::alembic {
 
+/* Upper bound of the number of streams opened per file. */
+static const int ARCHIVE_STREAMS_MAX = 4;
+
 static IArchive open_archive(const std::string &filename,
                              const std::vector<std::istream *> &input_streams)
 {
@@ -108,22 +114,37 @@ ArchiveReader::ArchiveReader(struct Main *bmain, const char *filename)
   BLI_strncpy(abs_filename, filename, FILE_MAX);
   BLI_path_abs(abs_filename, BKE_main_blendfile_path(bmain));
 
+  const int streams_num = std::min(BLI_system_thread_count(), ARCHIVE_STREAMS_MAX);
+  for (int i = 0; i < streams_num; i++) {
+    std::unique_ptr<std::ifstream> infile = std::make_unique<std::ifstream>();
 #ifdef WIN32
-  UTF16_ENCODE(abs_filename);
-  std::wstring wstr(abs_filename_16);
-  m_infile.open(wstr.c_str(), std::ios::in | std::ios::binary);
-  UTF16_UN_ENCODE(abs_filename);
+    UTF16_ENCODE(abs_filename);
+    std::wstring wstr(abs_filename_16);
+    infile->open(wstr.c_str(), std::ios::in | std::ios::binary);
+    UTF16_UN_ENCODE(abs_filename);
 #else
-  m_infile.open(abs_filename, std::ios::in | std::ios::binary);
+    infile->open(abs_filename, std::ios::in | std::ios::binary);
 #endif
 
-  m_streams.push_back(&m_infile);
+    if (!infile->is_open() && !m_infiles.empty()) {
+      /* Out of file handles, the streams that are already open are enough. */
+      break;
+    }
+
+    m_streams.push_back(infile.get());
+    m_infiles.push_back(std::move(infile));
+  }
 
   m_archive = open_archive(abs_filename, m_streams);
 }
 
 ArchiveReader::~ArchiveReader()
 {
+  /* Readers may keep the prefetcher alive, but it must not use the streams anymore. */
+  if (m_prefetcher) {
+    m_prefetcher->cancel();
+  }
+
   for (ArchiveReader *reader : m_readers) {
     delete reader;
   }
@@ -139,4 +160,13 @@ Alembic::Abc::IObject ArchiveReader::getTop()
   return m_archive.getTop();
 }
 
+std::shared_ptr<MeshSamplePrefetcher> ArchiveReader::prefetcher()
+{
+  std::lock_guard lock(m_prefetcher_mutex);
+  if (!m_prefetcher) {
+    m_prefetcher = std::make_shared<MeshSamplePrefetcher>();
+  }
+  return m_prefetcher;
+}
+
 }  // namespace blender::io::alembic
@@ -10,6 +10,8 @@
 #include <Alembic/AbcCoreOgawa/All.h>
 
 #include <fstream>
+#include <memory>
+#include <mutex>
 
 struct Main;
 
@@ -20,11 +22,18 @@ namespace blender::io::alembic {
  * the stream objects remain valid as long as the archives are open.
  */
 
+class MeshSamplePrefetcher;
+
 class ArchiveReader {
   Alembic::Abc::IArchive m_archive;
-  std::ifstream m_infile;
+  /* Several streams on the same file, so that Ogawa can serve concurrent reads, e.g. from the
+   * evaluation of different objects and from the sample prefetcher. */
+  std::vector<std::unique_ptr<std::ifstream>> m_infiles;
   std::vector<std::istream *> m_streams;
 
+  std::shared_ptr<MeshSamplePrefetcher> m_prefetcher;
+  std::mutex m_prefetcher_mutex;
+
   std::vector<ArchiveReader *> m_readers;
 
   ArchiveReader(const std::vector<ArchiveReader *> &readers);
@@ -39,6 +48,9 @@ class ArchiveReader {
   bool valid() const;
 
   Alembic::Abc::IObject getTop();
+
+  /** Shared by the readers of this archive, created on the first call. */
+  std::shared_ptr<MeshSamplePrefetcher> prefetcher();
 };
 
 }  // namespace blender::io::alembic
@@ -6,6 +6,7 @@
 
 #include "abc_reader_mesh.h"
 #include "abc_axis_conversion.h"
+#include "abc_reader_prefetch.h"
 #include "abc_reader_transform.h"
 #include "abc_util.h"
 
@@ -19,6 +20,7 @@
 #include "DNA_meshdata_types.h"
 #include "DNA_object_types.h"
 
+#include "BLI_array.hh"
 #include "BLI_compiler_compat.h"
 #include "BLI_edgehash.h"
 #include "BLI_index_range.hh"
@@ -26,12 +28,14 @@
 #include "BLI_math_geom.h"
 
 #include "BKE_attribute.h"
+#include "BKE_customdata.h"
 #include "BKE_main.h"
 #include "BKE_material.h"
 #include "BKE_mesh.h"
 #include "BKE_modifier.h"
 #include "BKE_object.h"
 
+using Alembic::Abc::ArraySampleKey;
 using Alembic::Abc::FloatArraySamplePtr;
 using Alembic::Abc::Int32ArraySamplePtr;
 using Alembic::Abc::IV3fArrayProperty;
@@ -105,10 +109,23 @@ static void assign_materials(Main *bmain,
 
 } /* namespace utils */
 
+struct AbcMeshTopology {
+  ArraySampleKey face_counts_key;
+  ArraySampleKey face_indices_key;
+
+  Array<MLoop> loops;
+  Array<MEdge> edges;
+};
+
 struct AbcMeshData {
   Int32ArraySamplePtr face_indices;
   Int32ArraySamplePtr face_counts;
 
+  /* Topology of a previous sample with the same face counts and indices, if any. */
+  const AbcMeshTopology *topology = nullptr;
+  /* Filled with the topology of this sample, when it can be reused. */
+  AbcMeshTopology *r_topology = nullptr;
+
   P3fArraySamplePtr positions;
   P3fArraySamplePtr ceil_positions;
 
@@ -170,13 +187,11 @@ void read_mverts(Mesh &mesh, const P3fArraySamplePtr positions, const N3fArraySa
   }
 }
 
-static void read_mpolys(CDStreamConfig &config, const AbcMeshData &mesh_data)
+static void read_mloopuvs(CDStreamConfig &config, const AbcMeshData &mesh_data)
 {
-  MPoly *mpolys = config.mpoly;
-  MLoop *mloops = config.mloop;
   MLoopUV *mloopuvs = config.mloopuv;
+  const MLoop *mloops = config.mloop;
 
-  const Int32ArraySamplePtr &face_indices = mesh_data.face_indices;
   const Int32ArraySamplePtr &face_counts = mesh_data.face_counts;
   const V2fArraySamplePtr &uvs = mesh_data.uvs;
   const size_t uvs_size = uvs == nullptr ? 0 : uvs->size();
@@ -184,11 +199,82 @@ static void read_mpolys(CDStreamConfig &config, const AbcMeshData &mesh_data)
   const UInt32ArraySamplePtr &uvs_indices = mesh_data.uvs_indices;
 
   const bool do_uvs = (mloopuvs && uvs && uvs_indices);
-  const bool do_uvs_per_loop = do_uvs && mesh_data.uv_scope == ABC_UV_SCOPE_LOOP;
-  BLI_assert(!do_uvs || mesh_data.uv_scope != ABC_UV_SCOPE_NONE);
+  if (!do_uvs) {
+    return;
+  }
+  const bool do_uvs_per_loop = mesh_data.uv_scope == ABC_UV_SCOPE_LOOP;
+  BLI_assert(mesh_data.uv_scope != ABC_UV_SCOPE_NONE);
   unsigned int loop_index = 0;
   unsigned int rev_loop_index = 0;
   unsigned int uv_index = 0;
+
+  for (int i = 0; i < face_counts->size(); i++) {
+    const int face_size = (*face_counts)[i];
+
+    /* NOTE: Alembic data is stored in the reverse order. */
+    rev_loop_index = loop_index + (face_size - 1);
+
+    for (int f = 0; f < face_size; f++, loop_index++, rev_loop_index--) {
+      MLoopUV &loopuv = mloopuvs[rev_loop_index];
+      uv_index = (*uvs_indices)[do_uvs_per_loop ? loop_index : mloops[rev_loop_index].v];
+
+      /* Some Alembic files are broken (or at least export UVs in a way we don't expect). */
+      if (uv_index >= uvs_size) {
+        continue;
+      }
+
+      loopuv.uv[0] = (*uvs)[uv_index][0];
+      loopuv.uv[1] = (*uvs)[uv_index][1];
+    }
+  }
+}
+
+static void read_mpolys_from_topology(CDStreamConfig &config,
+                                      const AbcMeshData &mesh_data,
+                                      const AbcMeshTopology &topology)
+{
+  Mesh *mesh = config.mesh;
+  const Int32ArraySamplePtr &face_counts = mesh_data.face_counts;
+
+  unsigned int loop_index = 0;
+  for (int i = 0; i < face_counts->size(); i++) {
+    MPoly &poly = config.mpoly[i];
+    poly.loopstart = loop_index;
+    poly.totloop = (*face_counts)[i];
+    poly.flag |= ME_SMOOTH;
+    loop_index += poly.totloop;
+  }
+
+  std::copy(topology.loops.begin(), topology.loops.end(), config.mloop);
+  read_mloopuvs(config, mesh_data);
+
+  /* Replace the edges the same way #BKE_mesh_calc_edges does. */
+  const int totedge = int(topology.edges.size());
+  MEdge *medge = static_cast<MEdge *>(MEM_malloc_arrayN(totedge, sizeof(MEdge), __func__));
+  std::copy(topology.edges.begin(), topology.edges.end(), medge);
+
+  CustomData_free(&mesh->edata, mesh->totedge);
+  CustomData_reset(&mesh->edata);
+  CustomData_add_layer(&mesh->edata, CD_MEDGE, CD_ASSIGN, medge, totedge);
+  mesh->totedge = totedge;
+  mesh->medge = medge;
+}
+
+static void read_mpolys(CDStreamConfig &config, const AbcMeshData &mesh_data)
+{
+  MPoly *mpolys = config.mpoly;
+  MLoop *mloops = config.mloop;
+
+  const Int32ArraySamplePtr &face_indices = mesh_data.face_indices;
+  const Int32ArraySamplePtr &face_counts = mesh_data.face_counts;
+
+  if (mesh_data.topology && size_t(mesh_data.topology->loops.size()) == face_indices->size()) {
+    read_mpolys_from_topology(config, mesh_data, *mesh_data.topology);
+    return;
+  }
+
+  unsigned int loop_index = 0;
+  unsigned int rev_loop_index = 0;
   bool seen_invalid_geometry = false;
 
   for (int i = 0; i < face_counts->size(); i++) {
@@ -216,28 +302,24 @@ static void read_mpolys(CDStreamConfig &config, const AbcMeshData &mesh_data)
         seen_invalid_geometry = true;
       }
       last_vertex_index = loop.v;
-
-      if (do_uvs) {
-        MLoopUV &loopuv = mloopuvs[rev_loop_index];
-        uv_index = (*uvs_indices)[do_uvs_per_loop ? loop_index : loop.v];
-
-        /* Some Alembic files are broken (or at least export UVs in a way we don't expect). */
-        if (uv_index >= uvs_size) {
-          continue;
-        }
-
-        loopuv.uv[0] = (*uvs)[uv_index][0];
-        loopuv.uv[1] = (*uvs)[uv_index][1];
-      }
     }
   }
 
+  read_mloopuvs(config, mesh_data);
+
   BKE_mesh_calc_edges(config.mesh, false, false);
   if (seen_invalid_geometry) {
     if (config.modifier_error_message) {
       *config.modifier_error_message = "Mesh hash invalid geometry; more details on the console";
     }
     BKE_mesh_validate(config.mesh, true, true);
+    return;
+  }
+
+  if (mesh_data.r_topology) {
+    Mesh *mesh = config.mesh;
+    mesh_data.r_topology->loops = Span<MLoop>(mesh->mloop, mesh->totloop);
+    mesh_data.r_topology->edges = Span<MEdge>(mesh->medge, mesh->totedge);
   }
 }
 
@@ -467,15 +549,18 @@ static void read_velocity(const V3fArraySamplePtr &velocities,
 static void read_mesh_sample(const std::string &iobject_full_name,
                              ImportSettings *settings,
                              const IPolyMeshSchema &schema,
+                             const IPolyMeshSchema::Sample &sample,
                              const ISampleSelector &selector,
-                             CDStreamConfig &config)
+                             CDStreamConfig &config,
+                             const AbcMeshTopology *topology,
+                             AbcMeshTopology *r_topology)
 {
-  const IPolyMeshSchema::Sample sample = schema.getValue(selector);
-
   AbcMeshData abc_mesh_data;
   abc_mesh_data.face_counts = sample.getFaceCounts();
   abc_mesh_data.face_indices = sample.getFaceIndices();
   abc_mesh_data.positions = sample.getPositions();
+  abc_mesh_data.topology = topology;
+  abc_mesh_data.r_topology = r_topology;
 
   get_weight_and_index(config, schema.getTimeSampling(), schema.getNumSamples());
 
@@ -534,7 +619,7 @@ CDStreamConfig get_config(Mesh *mesh, const bool use_vertex_interpolation)
 /* ************************************************************************** */
 
 AbcMeshReader::AbcMeshReader(const IObject &object, ImportSettings &settings)
-    : AbcObjectReader(object, settings)
+    : AbcObjectReader(object, settings), m_prefetch_reader_id(0)
 {
   m_settings->read_flag |= MOD_MESHSEQ_READ_ALL;
 
@@ -544,11 +629,45 @@ AbcMeshReader::AbcMeshReader(const IObject &object, ImportSettings &settings)
   get_min_max_time(m_iobject, m_schema, m_min_time, m_max_time);
 }
 
+AbcMeshReader::~AbcMeshReader()
+{
+  if (m_prefetch_reader_id != 0) {
+    m_prefetcher->unregister_reader(m_prefetch_reader_id);
+  }
+}
+
 bool AbcMeshReader::valid() const
 {
   return m_schema.valid();
 }
 
+void AbcMeshReader::read_sample(const ISampleSelector &sample_sel, IPolyMeshSchema::Sample &r_sample)
+{
+  if (!m_prefetcher) {
+    m_schema.get(r_sample, sample_sel);
+    return;
+  }
+
+  uint64_t reader_id;
+  {
+    std::lock_guard lock(m_mutex);
+    if (m_prefetch_reader_id == 0) {
+      m_prefetch_reader_id = m_prefetcher->register_reader();
+    }
+    reader_id = m_prefetch_reader_id;
+  }
+
+  const size_t samples_num = m_schema.getNumSamples();
+  const MeshSamplePrefetcher::SampleIndex index = sample_sel.getIndex(m_schema.getTimeSampling(),
+                                                                      samples_num);
+  if (!m_prefetcher->take(reader_id, index, r_sample)) {
+    m_schema.get(r_sample, ISampleSelector(index));
+  }
+
+  /* Playback mostly moves forward, read the next samples while this one is converted. */
+  m_prefetcher->request(reader_id, m_schema, index, MeshSamplePrefetcher::sample_size(r_sample));
+}
+
 template<class typedGeomParam>
 bool is_valid_animated(const ICompoundProperty arbGeomParams, const PropertyHeader &prop_header)
 {
@@ -670,6 +789,12 @@ bool AbcMeshReader::topology_changed(const Mesh *existing_mesh, const ISampleSel
     return false;
   }
 
+  return topology_changed(existing_mesh, sample);
+}
+
+bool AbcMeshReader::topology_changed(const Mesh *existing_mesh,
+                                     const IPolyMeshSchema::Sample &sample) const
+{
   const P3fArraySamplePtr &positions = sample.getPositions();
   const Alembic::Abc::Int32ArraySamplePtr &face_indices = sample.getFaceIndices();
   const Alembic::Abc::Int32ArraySamplePtr &face_counts = sample.getFaceCounts();
@@ -688,7 +813,7 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
 {
   IPolyMeshSchema::Sample sample;
   try {
-    sample = m_schema.getValue(sample_sel);
+    read_sample(sample_sel, sample);
   }
   catch (Alembic::Util::Exception &ex) {
     if (err_str != nullptr) {
@@ -729,7 +854,7 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
   settings.velocity_name = velocity_name;
   settings.velocity_scale = velocity_scale;
 
-  if (topology_changed(existing_mesh, sample_sel)) {
+  if (topology_changed(existing_mesh, sample)) {
     new_mesh = BKE_mesh_new_nomain_from_template(
         existing_mesh, positions->size(), 0, 0, face_indices->size(), face_counts->size());
 
@@ -757,7 +882,41 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
   config.time = sample_sel.getRequestedTime();
   config.modifier_error_message = err_str;
 
-  read_mesh_sample(m_iobject.getFullName(), &settings, m_schema, sample_sel, config);
+  /* Edges are only computed again when the face counts or indices of the sample differ from the
+   * ones of the last sample, e.g. not for deforming meshes. */
+  std::shared_ptr<const AbcMeshTopology> topology;
+  std::unique_ptr<AbcMeshTopology> new_topology;
+  if ((settings.read_flag & MOD_MESHSEQ_READ_POLY) != 0) {
+    ArraySampleKey face_counts_key;
+    ArraySampleKey face_indices_key;
+    if (m_schema.getFaceCountsProperty().getKey(face_counts_key, sample_sel) &&
+        m_schema.getFaceIndicesProperty().getKey(face_indices_key, sample_sel)) {
+      std::lock_guard lock(m_mutex);
+      if (m_topology && m_topology->face_counts_key == face_counts_key &&
+          m_topology->face_indices_key == face_indices_key) {
+        topology = m_topology;
+      }
+      else {
+        new_topology = std::make_unique<AbcMeshTopology>();
+        new_topology->face_counts_key = face_counts_key;
+        new_topology->face_indices_key = face_indices_key;
+      }
+    }
+  }
+
+  read_mesh_sample(m_iobject.getFullName(),
+                   &settings,
+                   m_schema,
+                   sample,
+                   sample_sel,
+                   config,
+                   topology.get(),
+                   new_topology.get());
+
+  if (new_topology && !new_topology->loops.is_empty()) {
+    std::lock_guard lock(m_mutex);
+    m_topology = std::move(new_topology);
+  }
 
   if (new_mesh) {
     /* Here we assume that the number of materials doesn't change, i.e. that
@@ -8,15 +8,27 @@
 #include "abc_customdata.h"
 #include "abc_reader_object.h"
 
+#include <memory>
+#include <mutex>
+
 struct Mesh;
 
 namespace blender::io::alembic {
 
+struct AbcMeshTopology;
+
 class AbcMeshReader final : public AbcObjectReader {
   Alembic::AbcGeom::IPolyMeshSchema m_schema;
 
+  /* Loops and edges of the last sample read, reused while the topology doesn't change. */
+  std::shared_ptr<const AbcMeshTopology> m_topology;
+  uint64_t m_prefetch_reader_id;
+  /* The same reader can be evaluated by multiple depsgraphs at the same time. */
+  std::mutex m_mutex;
+
  public:
   AbcMeshReader(const Alembic::Abc::IObject &object, ImportSettings &settings);
+  ~AbcMeshReader() override;
 
   bool valid() const override;
   bool accepts_object_type(const Alembic::AbcCoreAbstract::ObjectHeader &alembic_header,
@@ -34,6 +46,12 @@ class AbcMeshReader final : public AbcObjectReader {
                         const Alembic::Abc::ISampleSelector &sample_sel) override;
 
  private:
+  /** Read a sample, from the prefetcher when it was read ahead. */
+  void read_sample(const Alembic::Abc::ISampleSelector &sample_sel,
+                   Alembic::AbcGeom::IPolyMeshSchema::Sample &r_sample);
+  bool topology_changed(const Mesh *existing_mesh,
+                        const Alembic::AbcGeom::IPolyMeshSchema::Sample &sample) const;
+
   void readFaceSetsSample(Main *bmain,
                           Mesh *mesh,
                           const Alembic::AbcGeom::ISampleSelector &sample_sel);
@@ -97,6 +97,11 @@ void AbcObjectReader::object(Object *ob)
   m_object = ob;
 }
 
+void AbcObjectReader::prefetcher(std::shared_ptr<MeshSamplePrefetcher> prefetcher)
+{
+  m_prefetcher = std::move(prefetcher);
+}
+
 static Imath::M44d blend_matrices(const Imath::M44d &m0,
                                   const Imath::M44d &m1,
                                   const double weight)
@@ -10,6 +10,8 @@
 
 #include "DNA_ID.h"
 
+#include <memory>
+
 struct CacheFile;
 struct Main;
 struct Mesh;
@@ -19,6 +21,8 @@ using Alembic::AbcCoreAbstract::chrono_t;
 
 namespace blender::io::alembic {
 
+class MeshSamplePrefetcher;
+
 struct ImportSettings {
   bool do_convert_mat;
   float conversion_mat[4][4];
@@ -79,6 +83,9 @@ class AbcObjectReader {
 
   ImportSettings *m_settings;
 
+  /* Reads upcoming samples in the background when streaming from a cache file. */
+  std::shared_ptr<MeshSamplePrefetcher> m_prefetcher;
+
   chrono_t m_min_time;
   chrono_t m_max_time;
 
@@ -109,6 +116,8 @@ class AbcObjectReader {
   Object *object() const;
   void object(Object *ob);
 
+  void prefetcher(std::shared_ptr<MeshSamplePrefetcher> prefetcher);
+
   const std::string &name() const
   {
     return m_name;
@@ -0,0 +1,223 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup balembic
+ */
+
+#include "abc_reader_prefetch.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "BLI_task.h"
+
+using Alembic::AbcGeom::IPolyMeshSchema;
+using Alembic::AbcGeom::ISampleSelector;
+
+namespace blender::io::alembic {
+
+struct MeshSampleReadTask {
+  MeshSamplePrefetcher *prefetcher;
+  uint64_t reader_id;
+  MeshSamplePrefetcher::SampleIndex index;
+  IPolyMeshSchema schema;
+};
+
+MeshSamplePrefetcher::MeshSamplePrefetcher()
+{
+  m_task_pool = BLI_task_pool_create_background(this, TASK_PRIORITY_LOW);
+}
+
+MeshSamplePrefetcher::~MeshSamplePrefetcher()
+{
+  cancel();
+  BLI_task_pool_free(m_task_pool);
+}
+
+void MeshSamplePrefetcher::cancel()
+{
+  {
+    std::lock_guard lock(m_mutex);
+    m_canceled = true;
+    m_budget = 0;
+  }
+
+  /* Wait for the running reads outside of the lock, they take it when they finish. */
+  BLI_task_pool_cancel(m_task_pool);
+
+  std::lock_guard lock(m_mutex);
+  m_entries.clear();
+  m_used = 0;
+}
+
+void MeshSamplePrefetcher::set_budget(const size_t budget)
+{
+  std::lock_guard lock(m_mutex);
+  if (m_canceled) {
+    return;
+  }
+
+  m_budget = budget;
+  while (m_used > m_budget && !m_entries.empty()) {
+    erase(m_entries.begin());
+  }
+}
+
+uint64_t MeshSamplePrefetcher::register_reader()
+{
+  std::lock_guard lock(m_mutex);
+  const uint64_t reader_id = m_next_reader_id++;
+  m_readers.insert({reader_id, 0});
+  return reader_id;
+}
+
+void MeshSamplePrefetcher::unregister_reader(const uint64_t reader_id)
+{
+  std::lock_guard lock(m_mutex);
+  m_readers.erase(reader_id);
+
+  /* Reads that are still running for this reader are discarded when they finish. */
+  auto iter = m_entries.lower_bound({reader_id, 0});
+  while (iter != m_entries.end() && iter->first.first == reader_id) {
+    erase(iter++);
+  }
+}
+
+bool MeshSamplePrefetcher::take(const uint64_t reader_id,
+                                const SampleIndex index,
+                                IPolyMeshSchema::Sample &r_sample)
+{
+  std::lock_guard lock(m_mutex);
+  auto iter = m_entries.find({reader_id, index});
+  if (iter == m_entries.end() || !iter->second.ready) {
+    return false;
+  }
+
+  r_sample = std::move(iter->second.sample);
+  erase(iter);
+  return true;
+}
+
+void MeshSamplePrefetcher::request(const uint64_t reader_id,
+                                   const IPolyMeshSchema &schema,
+                                   const SampleIndex index,
+                                   const size_t sample_size)
+{
+  std::vector<MeshSampleReadTask *> tasks;
+
+  {
+    std::lock_guard lock(m_mutex);
+    auto reader_iter = m_readers.find(reader_id);
+    if (m_budget == 0 || reader_iter == m_readers.end()) {
+      return;
+    }
+    reader_iter->second = sample_size;
+
+    /* Drop the samples outside of the window, e.g. after jumping to another frame. */
+    auto iter = m_entries.lower_bound({reader_id, 0});
+    while (iter != m_entries.end() && iter->first.first == reader_id) {
+      const SampleIndex entry_index = iter->first.second;
+      if (entry_index <= index || entry_index > index + samples_ahead) {
+        erase(iter++);
+      }
+      else {
+        ++iter;
+      }
+    }
+
+    const SampleIndex last_index = std::min<SampleIndex>(index + samples_ahead,
+                                                         SampleIndex(schema.getNumSamples()) - 1);
+    for (SampleIndex next_index = index + 1; next_index <= last_index; next_index++) {
+      if (m_entries.find({reader_id, next_index}) != m_entries.end()) {
+        continue;
+      }
+      if (m_used + sample_size > m_budget) {
+        break;
+      }
+
+      /* Reserve the estimated size until the actual one is known. */
+      Entry &entry = m_entries[{reader_id, next_index}];
+      entry.size = sample_size;
+      m_used += sample_size;
+
+      tasks.push_back(new MeshSampleReadTask{this, reader_id, next_index, schema});
+    }
+  }
+
+  /* Push outside of the lock, the tasks take it when they finish. */
+  for (MeshSampleReadTask *task : tasks) {
+    BLI_task_pool_push(m_task_pool, read_task, task, true, free_task);
+  }
+}
+
+size_t MeshSamplePrefetcher::sample_size(const IPolyMeshSchema::Sample &sample)
+{
+  size_t size = 0;
+  if (sample.getPositions()) {
+    size += sample.getPositions()->size() * sizeof(Imath::V3f);
+  }
+  if (sample.getFaceIndices()) {
+    size += sample.getFaceIndices()->size() * sizeof(int32_t);
+  }
+  if (sample.getFaceCounts()) {
+    size += sample.getFaceCounts()->size() * sizeof(int32_t);
+  }
+  return size;
+}
+
+void MeshSamplePrefetcher::read_task(TaskPool *__restrict pool, void *taskdata)
+{
+  MeshSampleReadTask *task = static_cast<MeshSampleReadTask *>(taskdata);
+  if (BLI_task_pool_current_canceled(pool)) {
+    return;
+  }
+
+  IPolyMeshSchema::Sample sample;
+  bool success = true;
+  try {
+    task->schema.get(sample, ISampleSelector(task->index));
+  }
+  catch (Alembic::Util::Exception &) {
+    /* The error is reported when the sample is read synchronously. */
+    success = false;
+  }
+
+  task->prefetcher->finish(task->reader_id, task->index, std::move(sample), success);
+}
+
+void MeshSamplePrefetcher::free_task(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  delete static_cast<MeshSampleReadTask *>(taskdata);
+}
+
+void MeshSamplePrefetcher::finish(const uint64_t reader_id,
+                                  const SampleIndex index,
+                                  IPolyMeshSchema::Sample &&sample,
+                                  const bool success)
+{
+  std::lock_guard lock(m_mutex);
+  auto iter = m_entries.find({reader_id, index});
+  if (iter == m_entries.end() || iter->second.ready) {
+    /* Dropped or already read while this read was running. */
+    return;
+  }
+  if (!success) {
+    erase(iter);
+    return;
+  }
+
+  Entry &entry = iter->second;
+  m_used -= entry.size;
+  entry.size = sample_size(sample);
+  entry.sample = std::move(sample);
+  entry.ready = true;
+  m_used += entry.size;
+}
+
+void MeshSamplePrefetcher::erase(std::map<Key, Entry>::iterator iter)
+{
+  m_used -= iter->second.size;
+  m_entries.erase(iter);
+}
+
+}  // namespace blender::io::alembic
@@ -0,0 +1,100 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+#pragma once
+
+/** \file
+ * \ingroup balembic
+ */
+
+#include <Alembic/AbcGeom/All.h>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+
+struct TaskPool;
+
+namespace blender::io::alembic {
+
+/**
+ * Reads upcoming samples of the meshes streamed from an archive on a background thread, so that
+ * playback does not have to wait for the file when the mesh is evaluated.
+ *
+ * One prefetcher is shared by all readers of an archive, so that the memory budget covers the
+ * whole cache file. Readers register themselves, request the samples following the one that was
+ * just evaluated, and take them out of the prefetcher when evaluating the next frames.
+ */
+class MeshSamplePrefetcher {
+ public:
+  using SampleIndex = Alembic::AbcCoreAbstract::index_t;
+
+  /** Number of samples read ahead of the last evaluated one, per reader. */
+  static constexpr int samples_ahead = 4;
+
+ private:
+  struct Entry {
+    Alembic::AbcGeom::IPolyMeshSchema::Sample sample;
+    size_t size = 0;
+    bool ready = false;
+  };
+
+  using Key = std::pair<uint64_t, SampleIndex>;
+
+  std::mutex m_mutex;
+  TaskPool *m_task_pool = nullptr;
+
+  /** Zero disables prefetching. */
+  size_t m_budget = 0;
+  bool m_canceled = false;
+  /** Size of the cached samples, including an estimate for the ones being read. */
+  size_t m_used = 0;
+
+  std::map<Key, Entry> m_entries;
+  /** Registered readers and the size of their last sample, used to estimate the next ones. */
+  std::map<uint64_t, size_t> m_readers;
+  uint64_t m_next_reader_id = 1;
+
+ public:
+  MeshSamplePrefetcher();
+  ~MeshSamplePrefetcher();
+
+  MeshSamplePrefetcher(const MeshSamplePrefetcher &) = delete;
+  MeshSamplePrefetcher &operator=(const MeshSamplePrefetcher &) = delete;
+
+  /** Set the memory budget in bytes, samples that no longer fit are dropped. */
+  void set_budget(size_t budget);
+
+  /** Cancel all reads, the archive streams cannot be used after this. */
+  void cancel();
+
+  uint64_t register_reader();
+  void unregister_reader(uint64_t reader_id);
+
+  /**
+   * Move a prefetched sample out of the cache.
+   * \return false when the sample is not (yet) available and has to be read synchronously.
+   */
+  bool take(uint64_t reader_id,
+            SampleIndex index,
+            Alembic::AbcGeom::IPolyMeshSchema::Sample &r_sample);
+
+  /** Read the samples following \a index in the background, within the budget. */
+  void request(uint64_t reader_id,
+               const Alembic::AbcGeom::IPolyMeshSchema &schema,
+               SampleIndex index,
+               size_t sample_size);
+
+  static size_t sample_size(const Alembic::AbcGeom::IPolyMeshSchema::Sample &sample);
+
+ private:
+  static void read_task(TaskPool *__restrict pool, void *taskdata);
+  static void free_task(TaskPool *__restrict pool, void *taskdata);
+
+  void finish(uint64_t reader_id,
+              SampleIndex index,
+              Alembic::AbcGeom::IPolyMeshSchema::Sample &&sample,
+              bool success);
+  void erase(std::map<Key, Entry>::iterator iter);
+};
+
+}  // namespace blender::io::alembic
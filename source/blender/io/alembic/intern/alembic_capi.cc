@@ -16,6 +16,7 @@
 #include "abc_reader_mesh.h"
 #include "abc_reader_nurbs.h"
 #include "abc_reader_points.h"
+#include "abc_reader_prefetch.h"
 #include "abc_reader_transform.h"
 #include "abc_util.h"
 
@@ -181,6 +182,15 @@ void ABC_free_handle(CacheArchiveHandle *handle)
   delete archive_from_handle(handle);
 }
 
+void ABC_set_prefetch_budget(CacheArchiveHandle *handle, const size_t budget)
+{
+  ArchiveReader *archive = archive_from_handle(handle);
+  if (archive == nullptr) {
+    return;
+  }
+  archive->prefetcher()->set_budget(budget);
+}
+
 int ABC_get_version()
 {
   return ALEMBIC_LIBRARY_VERSION;
@@ -878,6 +888,7 @@ CacheReader *CacheReader_open_alembic_object(CacheArchiveHandle *handle,
     return nullptr;
   }
   abc_reader->object(object);
+  abc_reader->prefetcher(archive->prefetcher());
   abc_reader->incref();
 
   return reinterpret_cast<CacheReader *>(abc_reader);
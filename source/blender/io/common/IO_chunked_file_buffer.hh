@@ -0,0 +1,77 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup io
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "BLI_string_ref.hh"
+#include "BLI_utility_mixins.hh"
+
+namespace blender::io {
+
+/**
+ * File format agnostic buffer of file contents, like the OBJ exporter's `FormatHandler`.
+ * All writes are done into an internal chunked memory buffer
+ * (list of default 64 kilobyte blocks), so that several tasks can format parts of a file
+ * into their own buffer at the same time. Call #write_to_file to write the buffers into the
+ * file, in order.
+ */
+class ChunkedFileBuffer : NonCopyable {
+ private:
+  static constexpr size_t block_size_ = 64 * 1024;
+  std::vector<std::vector<char>> blocks_;
+
+ public:
+  ChunkedFileBuffer() = default;
+  ChunkedFileBuffer(ChunkedFileBuffer &&other) = default;
+  ChunkedFileBuffer &operator=(ChunkedFileBuffer &&other) = default;
+
+  /* Write contents of the buffer into a file, and clear the buffer.
+   * Returns false if the file could not be written. */
+  bool write_to_file(FILE *f)
+  {
+    bool ok = true;
+    for (const std::vector<char> &block : blocks_) {
+      ok &= fwrite(block.data(), 1, block.size(), f) == block.size();
+    }
+    blocks_.clear();
+    return ok;
+  }
+
+  void append(const char *data, size_t len)
+  {
+    std::vector<char> &block = ensure_space(len);
+    block.insert(block.end(), data, data + len);
+  }
+
+  void append(StringRef str)
+  {
+    append(str.data(), size_t(str.size()));
+  }
+
+  /* Append the bytes of a trivially copyable value. */
+  template<typename T> void append_bytes(const T &value)
+  {
+    append(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+ private:
+  /* Ensure the last block contains at least this amount of free space.
+   * If not, add a new block with max of block size & the amount of space needed. */
+  std::vector<char> &ensure_space(size_t at_least)
+  {
+    if (blocks_.empty() || (blocks_.back().capacity() - blocks_.back().size() < at_least)) {
+      std::vector<char> &block = blocks_.emplace_back();
+      block.reserve(std::max(at_least, block_size_));
+    }
+    return blocks_.back();
+  }
+};
+
+}  // namespace blender::io
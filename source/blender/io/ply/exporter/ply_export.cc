@@ -0,0 +1,388 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup ply
+ */
+
+#include <cstdio>
+#include <optional>
+#include <string>
+
+#include "BKE_attribute.h"
+#include "BKE_attribute.hh"
+#include "BKE_blender_version.h"
+#include "BKE_context.h"
+#include "BKE_mesh.h"
+#include "BKE_object.h"
+#include "BKE_report.h"
+
+#include "BLI_array.hh"
+#include "BLI_color.hh"
+#include "BLI_endian_defines.h"
+#include "BLI_fileops.h"
+#include "BLI_float4x4.hh"
+#include "BLI_math_matrix.h"
+#include "BLI_math_rotation.h"
+#include "BLI_math_vector.h"
+#include "BLI_memory_utils.hh"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+
+#include "DEG_depsgraph.h"
+#include "DEG_depsgraph_query.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+#include "DNA_pointcloud_types.h"
+#include "DNA_scene_types.h"
+
+#include "ED_object.h"
+
+#include "IO_chunked_file_buffer.hh"
+
+/* SEP macro from BLI path utils clashes with SEP symbol in fmt headers. */
+#undef SEP
+#define FMT_HEADER_ONLY
+#include <fmt/format.h>
+
+#include "ply_export.hh"
+
+namespace blender::io::ply {
+
+/* Number of vertices or faces formatted by one task. */
+static constexpr int EXPORT_CHUNK_SIZE = 32 * 1024;
+/* Number of chunks formatted before they are written to the file, to bound memory usage. */
+static constexpr int CHUNKS_PER_WRITE = 64;
+
+/** A mesh or point cloud to export, with its vertex data in the exported space. */
+struct PLYExportGeometry {
+  /* Null for point clouds. */
+  const Mesh *mesh;
+  int verts_num;
+  VArray<float3> positions;
+  VArray<float3> normals;
+  VArray<ColorGeometry4f> colors;
+  float4x4 transform;
+  float normal_transform[3][3];
+  /* Negative scales flip the winding of faces, reverse their corners to keep normals outside. */
+  bool flip_winding;
+  /* Index of the first vertex of the geometry in the file. */
+  int vertex_offset;
+};
+
+struct PLYExportChunk {
+  int geometry_index;
+  IndexRange range;
+};
+
+static void gather_export_geometry(const Object *object,
+                                   const PLYExportParams &export_params,
+                                   const float4x4 &global_transform,
+                                   Vector<PLYExportGeometry> &r_geometries)
+{
+  PLYExportGeometry geometry;
+  std::optional<bke::AttributeAccessor> attributes;
+  if (object->type == OB_MESH) {
+    const Mesh *mesh = export_params.apply_modifiers ? BKE_object_get_evaluated_mesh(object) :
+                                                       BKE_object_get_pre_modified_mesh(object);
+    if (mesh == nullptr || mesh->totvert == 0) {
+      return;
+    }
+    geometry.mesh = mesh;
+    geometry.verts_num = mesh->totvert;
+    attributes = bke::mesh_attributes(*mesh);
+    if (export_params.export_normals) {
+      geometry.normals = VArray<float3>::ForSpan(
+          {reinterpret_cast<const float3 *>(BKE_mesh_vertex_normals_ensure(mesh)),
+           mesh->totvert});
+    }
+  }
+  else if (object->type == OB_POINTCLOUD) {
+    const PointCloud *pointcloud = static_cast<const PointCloud *>(object->data);
+    if (pointcloud->totpoint == 0) {
+      return;
+    }
+    geometry.mesh = nullptr;
+    geometry.verts_num = pointcloud->totpoint;
+    attributes = bke::pointcloud_attributes(*pointcloud);
+    if (export_params.export_normals) {
+      geometry.normals = attributes->lookup_or_default<float3>(
+          "normal", ATTR_DOMAIN_POINT, float3(0.0f));
+    }
+  }
+  else {
+    return;
+  }
+
+  geometry.positions = attributes->lookup<float3>("position", ATTR_DOMAIN_POINT);
+  if (export_params.export_colors) {
+    const CustomDataLayer *color_layer = BKE_id_attributes_active_color_get(
+        static_cast<const ID *>(object->data));
+    const ColorGeometry4f white(1.0f, 1.0f, 1.0f, 1.0f);
+    geometry.colors = color_layer ? attributes->lookup_or_default<ColorGeometry4f>(
+                                        color_layer->name, ATTR_DOMAIN_POINT, white) :
+                                    VArray<ColorGeometry4f>::ForSingle(white, geometry.verts_num);
+  }
+
+  geometry.transform = global_transform * float4x4(object->obmat);
+  copy_m3_m4(geometry.normal_transform, geometry.transform.values);
+  invert_m3(geometry.normal_transform);
+  transpose_m3(geometry.normal_transform);
+  geometry.flip_winding = is_negative_m4(geometry.transform.values);
+  r_geometries.append(std::move(geometry));
+}
+
+static Vector<PLYExportGeometry> gather_export_geometries(Depsgraph *depsgraph,
+                                                          const PLYExportParams &export_params,
+                                                          const float4x4 &global_transform)
+{
+  Vector<PLYExportGeometry> geometries;
+  const int deg_objects_visibility_flags = DEG_ITER_OBJECT_FLAG_LINKED_DIRECTLY |
+                                           DEG_ITER_OBJECT_FLAG_LINKED_VIA_SET |
+                                           DEG_ITER_OBJECT_FLAG_VISIBLE |
+                                           DEG_ITER_OBJECT_FLAG_DUPLI;
+  DEG_OBJECT_ITER_BEGIN (depsgraph, object, deg_objects_visibility_flags) {
+    if (export_params.export_selected_objects && !(object->base_flag & BASE_SELECTED)) {
+      continue;
+    }
+    gather_export_geometry(object, export_params, global_transform, geometries);
+  }
+  DEG_OBJECT_ITER_END;
+  return geometries;
+}
+
+static std::string build_header(const PLYExportParams &export_params,
+                                const int verts_num,
+                                const int faces_num,
+                                const bool short_face_sizes)
+{
+  std::string header = "ply\n";
+  if (export_params.ascii_format) {
+    header += "format ascii 1.0\n";
+  }
+  else {
+    header += ENDIAN_ORDER == B_ENDIAN ? "format binary_big_endian 1.0\n" :
+                                        "format binary_little_endian 1.0\n";
+  }
+  header += fmt::format("comment Created in Blender version {}\n", BKE_blender_version_string());
+  header += fmt::format("element vertex {}\n", verts_num);
+  header += "property float x\nproperty float y\nproperty float z\n";
+  if (export_params.export_normals) {
+    header += "property float nx\nproperty float ny\nproperty float nz\n";
+  }
+  if (export_params.export_colors) {
+    header +=
+        "property uchar red\nproperty uchar green\nproperty uchar blue\nproperty uchar alpha\n";
+  }
+  if (faces_num > 0) {
+    header += fmt::format("element face {}\n", faces_num);
+    header += short_face_sizes ? "property list uchar int vertex_indices\n" :
+                                 "property list int int vertex_indices\n";
+  }
+  header += "end_header\n";
+  return header;
+}
+
+static void write_vertex_chunk(const PLYExportGeometry &geometry,
+                               const IndexRange range,
+                               const PLYExportParams &export_params,
+                               ChunkedFileBuffer &buffer)
+{
+  fmt::memory_buffer text;
+  for (const int i : range) {
+    const float3 position = geometry.transform * geometry.positions[i];
+    float3 normal(0.0f);
+    if (export_params.export_normals) {
+      mul_v3_m3v3(normal, geometry.normal_transform, geometry.normals[i]);
+      normalize_v3(normal);
+    }
+    ColorSceneLinearByteEncoded4b<eAlpha::Premultiplied> color;
+    if (export_params.export_colors) {
+      /* Colors are written as sRGB bytes, which is what other applications expect. */
+      color = geometry.colors[i].encode();
+    }
+
+    if (export_params.ascii_format) {
+      fmt::format_to(fmt::appender(text), "{} {} {}", position.x, position.y, position.z);
+      if (export_params.export_normals) {
+        fmt::format_to(fmt::appender(text), " {} {} {}", normal.x, normal.y, normal.z);
+      }
+      if (export_params.export_colors) {
+        fmt::format_to(fmt::appender(text), " {} {} {} {}", color.r, color.g, color.b, color.a);
+      }
+      text.push_back('\n');
+      if (text.size() > 32 * 1024) {
+        buffer.append(text.data(), text.size());
+        text.clear();
+      }
+      continue;
+    }
+    buffer.append_bytes(position);
+    if (export_params.export_normals) {
+      buffer.append_bytes(normal);
+    }
+    if (export_params.export_colors) {
+      buffer.append_bytes(color);
+    }
+  }
+  buffer.append(text.data(), text.size());
+}
+
+static void write_face_chunk(const PLYExportGeometry &geometry,
+                             const IndexRange range,
+                             const PLYExportParams &export_params,
+                             const bool short_face_sizes,
+                             ChunkedFileBuffer &buffer)
+{
+  const Mesh &mesh = *geometry.mesh;
+  fmt::memory_buffer text;
+  for (const int i : range) {
+    const MPoly &poly = mesh.mpoly[i];
+    /* Vertex of the k-th corner in the written order. Flipped faces start from the same corner
+     * and then go backwards, like in the OBJ exporter. */
+    auto corner_vert = [&](const int k) -> int {
+      const int j = (geometry.flip_winding && k != 0) ? poly.totloop - k : k;
+      return geometry.vertex_offset + mesh.mloop[poly.loopstart + j].v;
+    };
+    if (export_params.ascii_format) {
+      fmt::format_to(fmt::appender(text), "{}", poly.totloop);
+      for (const int k : IndexRange(poly.totloop)) {
+        fmt::format_to(fmt::appender(text), " {}", corner_vert(k));
+      }
+      text.push_back('\n');
+      if (text.size() > 32 * 1024) {
+        buffer.append(text.data(), text.size());
+        text.clear();
+      }
+      continue;
+    }
+    if (short_face_sizes) {
+      buffer.append_bytes(uint8_t(poly.totloop));
+    }
+    else {
+      buffer.append_bytes(int32_t(poly.totloop));
+    }
+    for (const int k : IndexRange(poly.totloop)) {
+      buffer.append_bytes(int32_t(corner_vert(k)));
+    }
+  }
+  buffer.append(text.data(), text.size());
+}
+
+/**
+ * Format chunks in parallel, a window of #CHUNKS_PER_WRITE at a time, and write them in order.
+ */
+template<typename Fn>
+static bool write_chunks(Span<PLYExportChunk> chunks, FILE *file, const Fn &write_chunk)
+{
+  bool write_ok = true;
+  Array<ChunkedFileBuffer> buffers(std::min<int64_t>(chunks.size(), CHUNKS_PER_WRITE));
+  for (int64_t first_chunk = 0; first_chunk < chunks.size(); first_chunk += CHUNKS_PER_WRITE) {
+    const IndexRange batch(first_chunk,
+                           std::min<int64_t>(CHUNKS_PER_WRITE, chunks.size() - first_chunk));
+    threading::parallel_for(batch, 1, [&](IndexRange range) {
+      for (const int64_t i : range) {
+        write_chunk(chunks[i], buffers[i - first_chunk]);
+      }
+    });
+    for (const int64_t i : batch) {
+      write_ok &= buffers[i - first_chunk].write_to_file(file);
+    }
+  }
+  return write_ok;
+}
+
+bool exporter_main(bContext *C, const PLYExportParams &export_params)
+{
+  ED_object_mode_set(C, OB_MODE_OBJECT);
+  Depsgraph *depsgraph = CTX_data_ensure_evaluated_depsgraph(C);
+  Scene *scene = CTX_data_scene(C);
+
+  float global_scale = export_params.global_scale;
+  if ((scene->unit.system != USER_UNIT_NONE) && export_params.use_scene_unit) {
+    global_scale *= scene->unit.scale_length;
+  }
+
+  float axes_transform[3][3];
+  unit_m3(axes_transform);
+  /* +Y-forward and +Z-up are the Blender's default axis settings. */
+  mat3_from_axis_conversion(
+      export_params.forward_axis, export_params.up_axis, IO_AXIS_Y, IO_AXIS_Z, axes_transform);
+  float4x4 global_transform;
+  copy_m4_m3(global_transform.values, axes_transform);
+  mul_mat3_m4_fl(global_transform.values, global_scale);
+
+  Vector<PLYExportGeometry> geometries = gather_export_geometries(
+      depsgraph, export_params, global_transform);
+
+  /* Vertices of all geometries come first, then faces of all meshes. */
+  Vector<PLYExportChunk> vertex_chunks;
+  Vector<PLYExportChunk> face_chunks;
+  int verts_num = 0;
+  int faces_num = 0;
+  int max_face_size = 0;
+  for (const int geometry_index : geometries.index_range()) {
+    PLYExportGeometry &geometry = geometries[geometry_index];
+    geometry.vertex_offset = verts_num;
+    verts_num += geometry.verts_num;
+    for (int start = 0; start < geometry.verts_num; start += EXPORT_CHUNK_SIZE) {
+      vertex_chunks.append(
+          {geometry_index,
+           IndexRange(start, std::min(EXPORT_CHUNK_SIZE, geometry.verts_num - start))});
+    }
+    if (geometry.mesh == nullptr) {
+      continue;
+    }
+    const int polys_num = geometry.mesh->totpoly;
+    faces_num += polys_num;
+    for (int start = 0; start < polys_num; start += EXPORT_CHUNK_SIZE) {
+      face_chunks.append(
+          {geometry_index, IndexRange(start, std::min(EXPORT_CHUNK_SIZE, polys_num - start))});
+    }
+    for (const int i : IndexRange(polys_num)) {
+      max_face_size = std::max(max_face_size, geometry.mesh->mpoly[i].totloop);
+    }
+  }
+  const bool short_face_sizes = max_face_size <= 255;
+
+  FILE *file = BLI_fopen(export_params.filepath, "wb");
+  if (!file) {
+    BKE_reportf(export_params.reports,
+                RPT_ERROR,
+                "PLY Exporter: cannot open file '%s'",
+                export_params.filepath);
+    return false;
+  }
+
+  bool write_ok = true;
+  ChunkedFileBuffer header_buffer;
+  header_buffer.append(build_header(export_params, verts_num, faces_num, short_face_sizes));
+  write_ok &= header_buffer.write_to_file(file);
+
+  write_ok &= write_chunks(
+      vertex_chunks, file, [&](const PLYExportChunk &chunk, ChunkedFileBuffer &buffer) {
+        write_vertex_chunk(geometries[chunk.geometry_index], chunk.range, export_params, buffer);
+      });
+  write_ok &= write_chunks(
+      face_chunks, file, [&](const PLYExportChunk &chunk, ChunkedFileBuffer &buffer) {
+        write_face_chunk(geometries[chunk.geometry_index],
+                         chunk.range,
+                         export_params,
+                         short_face_sizes,
+                         buffer);
+      });
+
+  /* Buffered data is only flushed on close, which can fail too, e.g. when the disk is full. */
+  write_ok &= fclose(file) == 0;
+  if (!write_ok) {
+    BKE_reportf(export_params.reports,
+                RPT_ERROR,
+                "PLY Exporter: failed to write to file '%s'",
+                export_params.filepath);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace blender::io::ply
@@ -0,0 +1,330 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup ply
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+
+#ifndef WIN32
+#  include <unistd.h>
+#else
+#  include <io.h>
+#endif
+
+#include "BKE_attribute.h"
+#include "BKE_customdata.h"
+#include "BKE_layer.h"
+#include "BKE_lib_id.h"
+#include "BKE_main.h"
+#include "BKE_mesh.h"
+#include "BKE_object.h"
+#include "BKE_pointcloud.h"
+#include "BKE_report.h"
+
+#include "BLI_fileops.h"
+#include "BLI_math_color.h"
+#include "BLI_math_matrix.h"
+#include "BLI_math_rotation.h"
+#include "BLI_math_vector.h"
+#include "BLI_memory_utils.hh"
+#include "BLI_mmap.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+#include "BLI_task.hh"
+
+#include "DNA_collection_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+#include "DNA_pointcloud_types.h"
+#include "DNA_scene_types.h"
+
+#include "DEG_depsgraph.h"
+#include "DEG_depsgraph_build.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "ply_import.hh"
+#include "ply_import_reader.hh"
+
+namespace blender::io::ply {
+
+/**
+ * Add the generic vertex attributes and colors, which are stored the same way on meshes and
+ * point clouds.
+ */
+static void add_vertex_attributes(ID *id, const PlyData &data)
+{
+  if (!data.vertex_colors.is_empty()) {
+    CustomDataLayer *color_layer = BKE_id_attribute_new(
+        id, "Color", CD_PROP_COLOR, ATTR_DOMAIN_POINT, nullptr);
+    /* PLY colors are in sRGB, color attributes are scene linear. */
+    float4 *colors = static_cast<float4 *>(color_layer->data);
+    threading::parallel_for(data.vertex_colors.index_range(), 4096, [&](IndexRange range) {
+      for (const int i : range) {
+        srgb_to_linearrgb_v3_v3(colors[i], data.vertex_colors[i]);
+        colors[i].w = data.vertex_colors[i].w;
+      }
+    });
+    BKE_id_attributes_active_color_set(id, color_layer);
+  }
+  for (const PlyAttribute &attribute : data.vertex_attributes) {
+    CustomDataLayer *layer = BKE_id_attribute_new(id,
+                                                  attribute.name.c_str(),
+                                                  attribute.is_float ? CD_PROP_FLOAT :
+                                                                       CD_PROP_INT32,
+                                                  ATTR_DOMAIN_POINT,
+                                                  nullptr);
+    if (attribute.is_float) {
+      memcpy(layer->data,
+             attribute.float_values.data(),
+             attribute.float_values.as_span().size_in_bytes());
+    }
+    else {
+      memcpy(layer->data,
+             attribute.int_values.data(),
+             attribute.int_values.as_span().size_in_bytes());
+    }
+  }
+}
+
+static bool face_is_valid(const PlyData &data, const int face)
+{
+  const IndexRange corners(data.face_offsets[face],
+                           data.face_offsets[face + 1] - data.face_offsets[face]);
+  if (corners.size() < 3) {
+    return false;
+  }
+  for (const int corner : corners) {
+    const int vert = data.face_vertices[corner];
+    if (vert < 0 || vert >= data.vertices.size()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static Mesh *ply_data_to_mesh(Main *bmain,
+                              const PlyData &data,
+                              const char *name,
+                              ReportList *reports)
+{
+  /* Skip faces with out of range indices or less than three corners. */
+  const int faces_num = data.faces_num();
+  Array<bool> valid_faces(faces_num);
+  threading::parallel_for(IndexRange(faces_num), 4096, [&](IndexRange range) {
+    for (const int face : range) {
+      valid_faces[face] = face_is_valid(data, face);
+    }
+  });
+  Vector<int> poly_faces;
+  int loops_num = 0;
+  for (const int face : IndexRange(faces_num)) {
+    if (valid_faces[face]) {
+      poly_faces.append(face);
+      loops_num += data.face_offsets[face + 1] - data.face_offsets[face];
+    }
+  }
+  if (poly_faces.size() < faces_num) {
+    BKE_reportf(reports,
+                RPT_INFO,
+                "PLY Importer: %d invalid faces were removed",
+                int(faces_num - poly_faces.size()));
+  }
+
+  Mesh *mesh = BKE_mesh_add(bmain, name);
+  /* User count is already 1 here, but will be set later in #BKE_mesh_assign_object. */
+  id_us_min(&mesh->id);
+
+  mesh->totvert = data.vertices.size();
+  mesh->mvert = static_cast<MVert *>(
+      CustomData_add_layer(&mesh->vdata, CD_MVERT, CD_CALLOC, nullptr, mesh->totvert));
+  mesh->totpoly = poly_faces.size();
+  mesh->totloop = loops_num;
+  mesh->mpoly = static_cast<MPoly *>(
+      CustomData_add_layer(&mesh->pdata, CD_MPOLY, CD_CALLOC, nullptr, mesh->totpoly));
+  mesh->mloop = static_cast<MLoop *>(
+      CustomData_add_layer(&mesh->ldata, CD_MLOOP, CD_CALLOC, nullptr, mesh->totloop));
+
+  threading::parallel_for(data.vertices.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      copy_v3_v3(mesh->mvert[i].co, data.vertices[i]);
+    }
+  });
+
+  int loopstart = 0;
+  for (const int i : poly_faces.index_range()) {
+    const int face = poly_faces[i];
+    mesh->mpoly[i].loopstart = loopstart;
+    mesh->mpoly[i].totloop = data.face_offsets[face + 1] - data.face_offsets[face];
+    loopstart += mesh->mpoly[i].totloop;
+  }
+  threading::parallel_for(poly_faces.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      const int face = poly_faces[i];
+      const MPoly &poly = mesh->mpoly[i];
+      for (const int j : IndexRange(poly.totloop)) {
+        mesh->mloop[poly.loopstart + j].v = data.face_vertices[data.face_offsets[face] + j];
+      }
+    }
+  });
+
+  /* NOTE: edges must be calculated first before setting custom normals. */
+  BKE_mesh_calc_edges(mesh, false, false);
+
+  if (!data.vertex_normals.is_empty()) {
+    Array<float3> normals = data.vertex_normals;
+    BKE_mesh_set_custom_normals_from_vertices(mesh,
+                                              reinterpret_cast<float(*)[3]>(normals.data()));
+    mesh->flag |= ME_AUTOSMOOTH;
+  }
+
+  add_vertex_attributes(&mesh->id, data);
+  return mesh;
+}
+
+static PointCloud *ply_data_to_pointcloud(Main *bmain, const PlyData &data, const char *name)
+{
+  PointCloud *pointcloud = static_cast<PointCloud *>(BKE_pointcloud_add(bmain, name));
+  pointcloud->totpoint = data.vertices.size();
+  CustomData_realloc(&pointcloud->pdata, pointcloud->totpoint);
+
+  float3 *positions = static_cast<float3 *>(CustomData_get_layer_named(
+      &pointcloud->pdata, CD_PROP_FLOAT3, POINTCLOUD_ATTR_POSITION));
+  memcpy(positions, data.vertices.data(), data.vertices.as_span().size_in_bytes());
+
+  if (!data.vertex_normals.is_empty()) {
+    CustomDataLayer *normal_layer = BKE_id_attribute_new(
+        &pointcloud->id, "normal", CD_PROP_FLOAT3, ATTR_DOMAIN_POINT, nullptr);
+    memcpy(normal_layer->data,
+           data.vertex_normals.data(),
+           data.vertex_normals.as_span().size_in_bytes());
+  }
+
+  add_vertex_attributes(&pointcloud->id, data);
+  return pointcloud;
+}
+
+void importer_main(bContext *C, const PLYImportParams &import_params)
+{
+  Main *bmain = CTX_data_main(C);
+  Scene *scene = CTX_data_scene(C);
+  ViewLayer *view_layer = CTX_data_view_layer(C);
+  importer_main(bmain, scene, view_layer, import_params);
+}
+
+void importer_main(Main *bmain,
+                   Scene *scene,
+                   ViewLayer *view_layer,
+                   const PLYImportParams &import_params)
+{
+  const int file = BLI_open(import_params.filepath, O_BINARY | O_RDONLY, 0);
+  if (file == -1) {
+    BKE_reportf(import_params.reports,
+                RPT_ERROR,
+                "PLY Importer: cannot open file '%s'",
+                import_params.filepath);
+    return;
+  }
+  BLI_SCOPED_DEFER([&]() { close(file); });
+
+  /* Map the file, so that binary payloads can be decoded in parallel straight from it.
+   * Memory mapping is not available on all file systems, read the whole file instead in that
+   * case. */
+  const int64_t file_size = BLI_lseek(file, 0, SEEK_END);
+  BLI_mmap_file *mmap_file = file_size > 0 ? BLI_mmap_open(file) : nullptr;
+  void *buffer = nullptr;
+  Span<char> contents;
+  if (mmap_file) {
+    contents = Span<char>(static_cast<const char *>(BLI_mmap_get_pointer(mmap_file)), file_size);
+  }
+  else {
+    size_t buffer_len;
+    buffer = BLI_file_read_binary_as_mem(import_params.filepath, 0, &buffer_len);
+    if (buffer == nullptr) {
+      BKE_reportf(import_params.reports,
+                  RPT_ERROR,
+                  "PLY Importer: cannot read from file '%s'",
+                  import_params.filepath);
+      return;
+    }
+    contents = Span<char>(static_cast<const char *>(buffer), int64_t(buffer_len));
+  }
+  BLI_SCOPED_DEFER([&]() {
+    if (mmap_file) {
+      BLI_mmap_free(mmap_file);
+    }
+    MEM_SAFE_FREE(buffer);
+  });
+
+  PlyHeader header;
+  PlyData data;
+  const StringRef text(contents.data(), contents.size());
+  if (!read_ply_header(text, header, import_params.reports) ||
+      !read_ply_data(contents, header, data, import_params.reports)) {
+    BKE_reportf(import_params.reports,
+                RPT_ERROR,
+                "PLY Importer: failed to import '%s'",
+                import_params.filepath);
+    return;
+  }
+
+  /* Name used for both the geometry and the object. */
+  char ob_name[FILE_MAX];
+  BLI_strncpy(ob_name, BLI_path_basename(import_params.filepath), FILE_MAX);
+  BLI_path_extension_replace(ob_name, FILE_MAX, "");
+
+  Object *obj;
+  if (data.faces_num() > 0) {
+    Mesh *mesh = ply_data_to_mesh(bmain, data, ob_name, import_params.reports);
+    if (import_params.use_mesh_validate) {
+      bool verbose_validate = false;
+#ifdef DEBUG
+      verbose_validate = true;
+#endif
+      BKE_mesh_validate(mesh, verbose_validate, false);
+    }
+    obj = BKE_object_add_only_object(bmain, OB_MESH, ob_name);
+    BKE_mesh_assign_object(bmain, obj, mesh);
+  }
+  else {
+    /* Scans without faces are imported as point clouds. */
+    PointCloud *pointcloud = ply_data_to_pointcloud(bmain, data, ob_name);
+    obj = BKE_object_add_only_object(bmain, OB_POINTCLOUD, ob_name);
+    obj->data = pointcloud;
+  }
+
+  BKE_view_layer_base_deselect_all(view_layer);
+  LayerCollection *lc = BKE_layer_collection_get_active(view_layer);
+  BKE_collection_object_add(bmain, lc->collection, obj);
+  Base *base = BKE_view_layer_base_find(view_layer, obj);
+  BKE_view_layer_base_select_and_set_active(view_layer, base);
+
+  float global_scale = import_params.global_scale;
+  if ((scene->unit.system != USER_UNIT_NONE) && import_params.use_scene_unit) {
+    global_scale *= scene->unit.scale_length;
+  }
+  float scale_vec[3] = {global_scale, global_scale, global_scale};
+  float obmat3x3[3][3];
+  unit_m3(obmat3x3);
+  float obmat4x4[4][4];
+  unit_m4(obmat4x4);
+  /* +Y-forward and +Z-up are the Blender's default axis settings. */
+  mat3_from_axis_conversion(
+      IO_AXIS_Y, IO_AXIS_Z, import_params.forward_axis, import_params.up_axis, obmat3x3);
+  copy_m4_m3(obmat4x4, obmat3x3);
+  rescale_m4(obmat4x4, scale_vec);
+  BKE_object_apply_mat4(obj, obmat4x4, true, false);
+
+  DEG_id_tag_update(&lc->collection->id, ID_RECALC_COPY_ON_WRITE);
+  int flags = ID_RECALC_TRANSFORM | ID_RECALC_GEOMETRY | ID_RECALC_ANIMATION |
+              ID_RECALC_BASE_FLAGS;
+  DEG_id_tag_update_ex(bmain, &obj->id, flags);
+  DEG_id_tag_update(&scene->id, ID_RECALC_BASE_FLAGS);
+  DEG_relations_tag_update(bmain);
+}
+
+}  // namespace blender::io::ply
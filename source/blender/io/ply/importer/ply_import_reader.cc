@@ -0,0 +1,808 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup ply
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+
+#include "BKE_report.h"
+
+#include "BLI_endian_defines.h"
+#include "BLI_task.hh"
+
+/* NOTE: we could use C++17 <charconv> from_chars to parse
+ * floats, but even if some compilers claim full support,
+ * their standard libraries are not quite there yet.
+ * LLVM/libc++ only has a float parser since LLVM 14,
+ * and gcc/libstdc++ since 11.1. So until at least these are
+ * the minimum spec, use an external library. */
+#include "fast_float.h"
+
+#include "ply_import_reader.hh"
+
+namespace blender::io::ply {
+
+static int data_type_size(const PlyDataType type)
+{
+  switch (type) {
+    case PlyDataType::Int8:
+    case PlyDataType::UInt8:
+      return 1;
+    case PlyDataType::Int16:
+    case PlyDataType::UInt16:
+      return 2;
+    case PlyDataType::Int32:
+    case PlyDataType::UInt32:
+    case PlyDataType::Float:
+      return 4;
+    case PlyDataType::Double:
+      return 8;
+  }
+  return 0;
+}
+
+static bool data_type_is_float(const PlyDataType type)
+{
+  return ELEM(type, PlyDataType::Float, PlyDataType::Double);
+}
+
+static bool parse_data_type(StringRef name, PlyDataType &r_type)
+{
+  if (ELEM(name, "char", "int8")) {
+    r_type = PlyDataType::Int8;
+  }
+  else if (ELEM(name, "uchar", "uint8")) {
+    r_type = PlyDataType::UInt8;
+  }
+  else if (ELEM(name, "short", "int16")) {
+    r_type = PlyDataType::Int16;
+  }
+  else if (ELEM(name, "ushort", "uint16")) {
+    r_type = PlyDataType::UInt16;
+  }
+  else if (ELEM(name, "int", "int32")) {
+    r_type = PlyDataType::Int32;
+  }
+  else if (ELEM(name, "uint", "uint32")) {
+    r_type = PlyDataType::UInt32;
+  }
+  else if (ELEM(name, "float", "float32")) {
+    r_type = PlyDataType::Float;
+  }
+  else if (ELEM(name, "double", "float64")) {
+    r_type = PlyDataType::Double;
+  }
+  else {
+    return false;
+  }
+  return true;
+}
+
+int64_t PlyElement::stride() const
+{
+  int64_t stride = 0;
+  for (const PlyProperty &property : properties) {
+    if (property.is_list) {
+      return -1;
+    }
+    stride += data_type_size(property.type);
+  }
+  return stride;
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Header
+ * \{ */
+
+static Vector<StringRef> split_words(StringRef line)
+{
+  Vector<StringRef> words;
+  int64_t pos = 0;
+  while (pos < line.size()) {
+    while (pos < line.size() && line[pos] <= ' ') {
+      pos++;
+    }
+    const int64_t start = pos;
+    while (pos < line.size() && line[pos] > ' ') {
+      pos++;
+    }
+    if (pos > start) {
+      words.append(line.substr(start, pos - start));
+    }
+  }
+  return words;
+}
+
+bool read_ply_header(StringRef text, PlyHeader &r_header, ReportList *reports)
+{
+  int64_t pos = 0;
+  bool first_line = true;
+  while (pos < text.size()) {
+    int64_t line_end = text.find('\n', pos);
+    if (line_end == StringRef::not_found) {
+      break;
+    }
+    const Vector<StringRef> words = split_words(text.substr(pos, line_end - pos));
+    pos = line_end + 1;
+
+    if (first_line) {
+      if (words.size() != 1 || words[0] != "ply") {
+        BKE_report(reports, RPT_ERROR, "PLY Importer: not a PLY file");
+        return false;
+      }
+      first_line = false;
+      continue;
+    }
+    if (words.is_empty() || ELEM(words[0], "comment", "obj_info")) {
+      continue;
+    }
+    if (words[0] == "format" && words.size() >= 2) {
+      if (words[1] == "ascii") {
+        r_header.format = PlyFormat::ASCII;
+      }
+      else if (words[1] == "binary_little_endian") {
+        r_header.format = PlyFormat::BinaryLittleEndian;
+      }
+      else if (words[1] == "binary_big_endian") {
+        r_header.format = PlyFormat::BinaryBigEndian;
+      }
+      else {
+        BKE_reportf(reports,
+                    RPT_ERROR,
+                    "PLY Importer: unknown format '%s'",
+                    std::string(words[1]).c_str());
+        return false;
+      }
+    }
+    else if (words[0] == "element" && words.size() == 3) {
+      PlyElement element;
+      element.name = words[1];
+      element.count = std::strtoll(std::string(words[2]).c_str(), nullptr, 10);
+      /* Vertices and faces are indexed with int. */
+      if (element.count < 0 || element.count > INT_MAX) {
+        BKE_report(reports, RPT_ERROR, "PLY Importer: invalid element count");
+        return false;
+      }
+      r_header.elements.append(std::move(element));
+    }
+    else if (words[0] == "property" && !r_header.elements.is_empty()) {
+      PlyProperty property;
+      bool valid;
+      if (words.size() == 5 && words[1] == "list") {
+        property.is_list = true;
+        property.name = words[4];
+        valid = parse_data_type(words[2], property.count_type) &&
+                parse_data_type(words[3], property.type) &&
+                !data_type_is_float(property.count_type);
+      }
+      else {
+        property.name = words.size() == 3 ? words[2] : "";
+        valid = words.size() == 3 && parse_data_type(words[1], property.type);
+      }
+      if (!valid) {
+        BKE_report(reports, RPT_ERROR, "PLY Importer: invalid property");
+        return false;
+      }
+      r_header.elements.last().properties.append(std::move(property));
+    }
+    else if (words[0] == "end_header") {
+      r_header.size = pos;
+      return true;
+    }
+    else {
+      BKE_report(reports, RPT_ERROR, "PLY Importer: unexpected header line");
+      return false;
+    }
+  }
+  BKE_report(reports, RPT_ERROR, "PLY Importer: end of header not found");
+  return false;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Values
+ * \{ */
+
+static double read_binary_value(const char *src, const PlyDataType type, const bool swap)
+{
+  const int size = data_type_size(type);
+  char bytes[8];
+  if (swap) {
+    for (int i = 0; i < size; i++) {
+      bytes[i] = src[size - 1 - i];
+    }
+  }
+  else {
+    memcpy(bytes, src, size);
+  }
+  switch (type) {
+    case PlyDataType::Int8: {
+      int8_t value;
+      memcpy(&value, bytes, sizeof(value));
+      return value;
+    }
+    case PlyDataType::UInt8: {
+      uint8_t value;
+      memcpy(&value, bytes, sizeof(value));
+      return value;
+    }
+    case PlyDataType::Int16: {
+      int16_t value;
+      memcpy(&value, bytes, sizeof(value));
+      return value;
+    }
+    case PlyDataType::UInt16: {
+      uint16_t value;
+      memcpy(&value, bytes, sizeof(value));
+      return value;
+    }
+    case PlyDataType::Int32: {
+      int32_t value;
+      memcpy(&value, bytes, sizeof(value));
+      return value;
+    }
+    case PlyDataType::UInt32: {
+      uint32_t value;
+      memcpy(&value, bytes, sizeof(value));
+      return value;
+    }
+    case PlyDataType::Float: {
+      float value;
+      memcpy(&value, bytes, sizeof(value));
+      return value;
+    }
+    case PlyDataType::Double: {
+      double value;
+      memcpy(&value, bytes, sizeof(value));
+      return value;
+    }
+  }
+  return 0.0;
+}
+
+/** Cursor over the whitespace separated values of an ASCII body. */
+struct AsciiCursor {
+  const char *pos;
+  const char *end;
+
+  bool parse(double &r_value)
+  {
+    while (pos < end && *pos <= ' ') {
+      pos++;
+    }
+    /* Skip '+' */
+    if (pos < end && *pos == '+') {
+      pos++;
+    }
+    if (pos >= end) {
+      return false;
+    }
+    fast_float::from_chars_result res = fast_float::from_chars(pos, end, r_value);
+    if (res.ec != std::errc()) {
+      return false;
+    }
+    pos = res.ptr;
+    return true;
+  }
+
+  void skip_line()
+  {
+    const char *line_end = static_cast<const char *>(memchr(pos, '\n', end - pos));
+    pos = line_end ? line_end + 1 : end;
+  }
+};
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Vertices
+ * \{ */
+
+/** Where the value of a vertex property goes. */
+struct VertexPropertyTarget {
+  enum class Kind {
+    Skip,
+    Position,
+    Normal,
+    Color,
+    Attribute,
+  };
+  Kind kind = Kind::Skip;
+  /* Component of positions, normals and colors, or index of the generic attribute. */
+  int index = 0;
+  /* Normalization factor of integer colors. */
+  float color_scale = 1.0f;
+};
+
+static float color_scale_of_type(const PlyDataType type)
+{
+  switch (type) {
+    case PlyDataType::UInt8:
+      return 1.0f / 255.0f;
+    case PlyDataType::UInt16:
+      return 1.0f / 65535.0f;
+    default:
+      return 1.0f;
+  }
+}
+
+static Vector<VertexPropertyTarget> init_vertex_targets(const PlyElement &element,
+                                                        PlyData &r_data)
+{
+  Vector<VertexPropertyTarget> targets(element.properties.size());
+  auto find = [&](StringRef name) -> int {
+    for (const int i : element.properties.index_range()) {
+      if (!element.properties[i].is_list && element.properties[i].name == name) {
+        return i;
+      }
+    }
+    return -1;
+  };
+  auto assign = [&](Span<const char *> names, VertexPropertyTarget::Kind kind) -> bool {
+    Vector<int> indices;
+    for (const char *name : names) {
+      const int index = find(name);
+      if (index == -1) {
+        return false;
+      }
+      indices.append(index);
+    }
+    for (const int component : indices.index_range()) {
+      VertexPropertyTarget &target = targets[indices[component]];
+      target.kind = kind;
+      target.index = component;
+      target.color_scale = color_scale_of_type(element.properties[indices[component]].type);
+    }
+    return true;
+  };
+
+  const int64_t count = element.count;
+  if (assign({"x", "y", "z"}, VertexPropertyTarget::Kind::Position)) {
+    r_data.vertices.reinitialize(count);
+  }
+  if (assign({"nx", "ny", "nz"}, VertexPropertyTarget::Kind::Normal)) {
+    r_data.vertex_normals.reinitialize(count);
+  }
+  if (assign({"red", "green", "blue"}, VertexPropertyTarget::Kind::Color)) {
+    r_data.vertex_colors = Array<float4>(count, float4(0.0f, 0.0f, 0.0f, 1.0f));
+    assign({"alpha"}, VertexPropertyTarget::Kind::Color);
+    const int alpha = find("alpha");
+    if (alpha != -1) {
+      targets[alpha].index = 3;
+    }
+  }
+
+  /* Any other property becomes a generic attribute. */
+  for (const int i : element.properties.index_range()) {
+    const PlyProperty &property = element.properties[i];
+    if (targets[i].kind != VertexPropertyTarget::Kind::Skip || property.is_list) {
+      continue;
+    }
+    r_data.vertex_attributes.append_as();
+    PlyAttribute &attribute = r_data.vertex_attributes.last();
+    attribute.name = property.name;
+    attribute.is_float = data_type_is_float(property.type);
+    if (attribute.is_float) {
+      attribute.float_values.reinitialize(count);
+    }
+    else {
+      attribute.int_values.reinitialize(count);
+    }
+    targets[i].kind = VertexPropertyTarget::Kind::Attribute;
+    targets[i].index = r_data.vertex_attributes.size() - 1;
+  }
+  return targets;
+}
+
+static void store_vertex_value(PlyData &data,
+                               const VertexPropertyTarget &target,
+                               const int64_t vertex,
+                               const double value)
+{
+  switch (target.kind) {
+    case VertexPropertyTarget::Kind::Skip:
+      break;
+    case VertexPropertyTarget::Kind::Position:
+      data.vertices[vertex][target.index] = float(value);
+      break;
+    case VertexPropertyTarget::Kind::Normal:
+      data.vertex_normals[vertex][target.index] = float(value);
+      break;
+    case VertexPropertyTarget::Kind::Color:
+      data.vertex_colors[vertex][target.index] = float(value) * target.color_scale;
+      break;
+    case VertexPropertyTarget::Kind::Attribute: {
+      PlyAttribute &attribute = data.vertex_attributes[target.index];
+      if (attribute.is_float) {
+        attribute.float_values[vertex] = float(value);
+      }
+      else {
+        /* Unsigned values above the int range are clamped instead of overflowing. */
+        attribute.int_values[vertex] = int(std::min(value, double(INT_MAX)));
+      }
+      break;
+    }
+  }
+}
+
+static bool read_binary_vertices(const char *&pos,
+                                 const char *end,
+                                 const PlyElement &element,
+                                 const bool swap,
+                                 PlyData &r_data)
+{
+  const int64_t stride = element.stride();
+  /* Check the size before allocating anything, the count comes straight from the header. */
+  if (stride > 0 && element.count > (end - pos) / stride) {
+    return false;
+  }
+  const Vector<VertexPropertyTarget> targets = init_vertex_targets(element, r_data);
+
+  if (stride != -1) {
+    /* All vertices have the same size, decode them in parallel straight from the file data. */
+    Vector<int> offsets;
+    int offset = 0;
+    for (const PlyProperty &property : element.properties) {
+      offsets.append(offset);
+      offset += data_type_size(property.type);
+    }
+    const char *vertices_data = pos;
+    threading::parallel_for(IndexRange(element.count), 4096, [&](IndexRange range) {
+      for (const int64_t vertex : range) {
+        const char *vertex_data = vertices_data + vertex * stride;
+        for (const int i : targets.index_range()) {
+          if (targets[i].kind != VertexPropertyTarget::Kind::Skip) {
+            const double value = read_binary_value(
+                vertex_data + offsets[i], element.properties[i].type, swap);
+            store_vertex_value(r_data, targets[i], vertex, value);
+          }
+        }
+      }
+    });
+    pos += element.count * stride;
+    return true;
+  }
+
+  /* Lists in vertices are unusual, walk through them one by one. */
+  for (const int64_t vertex : IndexRange(element.count)) {
+    for (const int i : element.properties.index_range()) {
+      const PlyProperty &property = element.properties[i];
+      const int size = data_type_size(property.type);
+      if (property.is_list) {
+        const int count_size = data_type_size(property.count_type);
+        if (end - pos < count_size) {
+          return false;
+        }
+        const int64_t count = int64_t(read_binary_value(pos, property.count_type, swap));
+        pos += count_size;
+        if (count < 0 || end - pos < count * size) {
+          return false;
+        }
+        pos += count * size;
+        continue;
+      }
+      if (end - pos < size) {
+        return false;
+      }
+      store_vertex_value(r_data, targets[i], vertex, read_binary_value(pos, property.type, swap));
+      pos += size;
+    }
+  }
+  return true;
+}
+
+static bool read_ascii_vertices(const char *&pos,
+                                const char *end,
+                                const PlyElement &element,
+                                PlyData &r_data)
+{
+  const Vector<VertexPropertyTarget> targets = init_vertex_targets(element, r_data);
+
+  /* There is one vertex per line, find where lines start and parse them in parallel. */
+  Array<const char *> line_starts(element.count + 1);
+  for (const int64_t vertex : IndexRange(element.count)) {
+    if (pos >= end) {
+      return false;
+    }
+    line_starts[vertex] = pos;
+    const char *line_end = static_cast<const char *>(memchr(pos, '\n', end - pos));
+    pos = line_end ? line_end + 1 : end;
+  }
+  line_starts[element.count] = pos;
+
+  std::atomic<bool> valid = true;
+  threading::parallel_for(IndexRange(element.count), 1024, [&](IndexRange range) {
+    for (const int64_t vertex : range) {
+      AsciiCursor cursor{line_starts[vertex], line_starts[vertex + 1]};
+      for (const int i : element.properties.index_range()) {
+        double value;
+        if (!cursor.parse(value)) {
+          valid = false;
+          return;
+        }
+        if (element.properties[i].is_list) {
+          /* Each item takes at least one character. */
+          if (value < 0.0 || value > double(cursor.end - cursor.pos)) {
+            valid = false;
+            return;
+          }
+          double item;
+          for (int64_t j = 0; j < int64_t(value); j++) {
+            cursor.parse(item);
+          }
+          continue;
+        }
+        store_vertex_value(r_data, targets[i], vertex, value);
+      }
+    }
+  });
+  return valid;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Faces
+ * \{ */
+
+static int find_face_indices_property(const PlyElement &element)
+{
+  for (const int i : element.properties.index_range()) {
+    const PlyProperty &property = element.properties[i];
+    if (property.is_list && ELEM(property.name, "vertex_indices", "vertex_index")) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * Faces are usually triangles or quads, reserve for that without going beyond the number of
+ * indices the rest of the file can hold.
+ */
+static void reserve_faces(const PlyElement &element,
+                          const int64_t indices_max,
+                          PlyData &r_data)
+{
+  r_data.face_offsets.reserve(element.count + 1);
+  r_data.face_vertices.reserve(std::min(element.count * 3, indices_max));
+}
+
+/**
+ * Face corners are stored as int, like mesh loops. Indices out of the range of vertices are only
+ * checked when building the mesh, where such faces are skipped.
+ */
+static bool face_index_is_valid(const double index)
+{
+  return index >= double(INT_MIN) && index <= double(INT_MAX);
+}
+
+static bool read_binary_faces(const char *&pos,
+                              const char *end,
+                              const PlyElement &element,
+                              const bool swap,
+                              PlyData &r_data)
+{
+  const int indices_property = find_face_indices_property(element);
+  if (indices_property != -1) {
+    const int index_size = data_type_size(element.properties[indices_property].type);
+    reserve_faces(element, (end - pos) / index_size, r_data);
+  }
+  r_data.face_offsets.append(0);
+
+  /* Faces have a variable size, which makes decoding them in parallel impractical. They are
+   * usually much fewer than vertices in the large scans this is most useful for. */
+  for (int64_t face = 0; face < element.count; face++) {
+    for (const int i : element.properties.index_range()) {
+      const PlyProperty &property = element.properties[i];
+      const int size = data_type_size(property.type);
+      if (!property.is_list) {
+        if (end - pos < size) {
+          return false;
+        }
+        pos += size;
+        continue;
+      }
+      const int count_size = data_type_size(property.count_type);
+      if (end - pos < count_size) {
+        return false;
+      }
+      const int64_t count = int64_t(read_binary_value(pos, property.count_type, swap));
+      pos += count_size;
+      if (count < 0 || end - pos < count * size) {
+        return false;
+      }
+      if (i == indices_property) {
+        if (count > INT_MAX - r_data.face_vertices.size()) {
+          return false;
+        }
+        for (int64_t j = 0; j < count; j++) {
+          const double index = read_binary_value(pos + j * size, property.type, swap);
+          if (!face_index_is_valid(index)) {
+            return false;
+          }
+          r_data.face_vertices.append(int(index));
+        }
+        r_data.face_offsets.append(r_data.face_vertices.size());
+      }
+      pos += count * size;
+    }
+  }
+  return true;
+}
+
+static bool read_ascii_faces(const char *&pos,
+                             const char *end,
+                             const PlyElement &element,
+                             PlyData &r_data)
+{
+  const int indices_property = find_face_indices_property(element);
+  if (indices_property != -1) {
+    /* Each index takes at least a digit and a separator. */
+    reserve_faces(element, (end - pos) / 2 + 1, r_data);
+  }
+  r_data.face_offsets.append(0);
+
+  AsciiCursor cursor{pos, end};
+  for (int64_t face = 0; face < element.count; face++) {
+    for (const int i : element.properties.index_range()) {
+      double value;
+      if (!cursor.parse(value)) {
+        return false;
+      }
+      if (!element.properties[i].is_list) {
+        continue;
+      }
+      /* Each item takes at least one character, which also bounds the number of indices. */
+      if (value < 0.0 || value > double(cursor.end - cursor.pos)) {
+        return false;
+      }
+      for (int64_t j = 0; j < int64_t(value); j++) {
+        double index;
+        if (!cursor.parse(index)) {
+          return false;
+        }
+        if (i == indices_property) {
+          if (!face_index_is_valid(index)) {
+            return false;
+          }
+          r_data.face_vertices.append(int(index));
+        }
+      }
+      if (i == indices_property) {
+        r_data.face_offsets.append(r_data.face_vertices.size());
+      }
+    }
+    cursor.skip_line();
+  }
+  pos = cursor.pos;
+  return true;
+}
+
+/** \} */
+
+static bool skip_element(const char *&pos,
+                         const char *end,
+                         const PlyElement &element,
+                         const PlyFormat format,
+                         const bool swap)
+{
+  if (format == PlyFormat::ASCII) {
+    AsciiCursor cursor{pos, end};
+    for (int64_t i = 0; i < element.count; i++) {
+      cursor.skip_line();
+    }
+    pos = cursor.pos;
+    return true;
+  }
+  const int64_t stride = element.stride();
+  if (stride != -1) {
+    if (stride > 0 && element.count > (end - pos) / stride) {
+      return false;
+    }
+    pos += element.count * stride;
+    return true;
+  }
+  for (int64_t i = 0; i < element.count; i++) {
+    for (const PlyProperty &property : element.properties) {
+      const int size = data_type_size(property.type);
+      int64_t count = 1;
+      if (property.is_list) {
+        const int count_size = data_type_size(property.count_type);
+        if (end - pos < count_size) {
+          return false;
+        }
+        count = int64_t(read_binary_value(pos, property.count_type, swap));
+        pos += count_size;
+      }
+      if (count < 0 || end - pos < count * size) {
+        return false;
+      }
+      pos += count * size;
+    }
+  }
+  return true;
+}
+
+/**
+ * Smallest size in bytes an element can take in the file, lists being empty and ASCII values a
+ * single character followed by a separator. At least one byte, so that counts larger than the
+ * file can hold are rejected before anything is allocated for them.
+ */
+static int64_t element_min_size(const PlyElement &element, const PlyFormat format)
+{
+  int64_t size = 0;
+  for (const PlyProperty &property : element.properties) {
+    if (format == PlyFormat::ASCII) {
+      size += 2;
+    }
+    else {
+      size += data_type_size(property.is_list ? property.count_type : property.type);
+    }
+  }
+  return std::max<int64_t>(size, 1);
+}
+
+bool read_ply_data(Span<char> data,
+                   const PlyHeader &header,
+                   PlyData &r_data,
+                   ReportList *reports)
+{
+  const char *pos = data.data() + header.size;
+  const char *end = data.data() + data.size();
+  const bool is_big_endian = header.format == PlyFormat::BinaryBigEndian;
+  const bool swap = (header.format != PlyFormat::ASCII) &&
+                    (is_big_endian != (ENDIAN_ORDER == B_ENDIAN));
+  const bool is_ascii = header.format == PlyFormat::ASCII;
+
+  bool has_vertices = false;
+  bool has_faces = false;
+  for (const PlyElement &element : header.elements) {
+    /* The last line of ASCII files may have no newline. */
+    const int64_t available = (end - pos) + (is_ascii ? 1 : 0);
+    if (element.count > available / element_min_size(element, header.format)) {
+      BKE_reportf(reports,
+                  RPT_ERROR,
+                  "PLY Importer: the file is too small for %lld '%s' elements",
+                  (long long)element.count,
+                  element.name.c_str());
+      return false;
+    }
+    bool ok;
+    if (element.name == "vertex" && !has_vertices) {
+      ok = is_ascii ? read_ascii_vertices(pos, end, element, r_data) :
+                      read_binary_vertices(pos, end, element, swap, r_data);
+      has_vertices = true;
+      if (ok && r_data.vertices.size() != element.count) {
+        BKE_report(reports, RPT_ERROR, "PLY Importer: vertices have no position");
+        return false;
+      }
+    }
+    else if (element.name == "face" && !has_faces) {
+      ok = is_ascii ? read_ascii_faces(pos, end, element, r_data) :
+                      read_binary_faces(pos, end, element, swap, r_data);
+      has_faces = true;
+    }
+    else {
+      ok = skip_element(pos, end, element, header.format, swap);
+    }
+    if (!ok) {
+      BKE_reportf(reports,
+                  RPT_ERROR,
+                  "PLY Importer: invalid data or unexpected end of file in '%s' element",
+                  element.name.c_str());
+      return false;
+    }
+    if (has_vertices && has_faces) {
+      break;
+    }
+  }
+  return true;
+}
+
+}  // namespace blender::io::ply
@@ -0,0 +1,121 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup ply
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "BLI_array.hh"
+#include "BLI_math_vec_types.hh"
+#include "BLI_string_ref.hh"
+#include "BLI_vector.hh"
+
+struct ReportList;
+
+/**
+ * PLY spec:
+ * <pre>
+ * ply
+ * format ascii|binary_little_endian|binary_big_endian 1.0
+ * comment ...
+ * element vertex 8
+ * property float x
+ * ...
+ * element face 6
+ * property list uchar int vertex_indices
+ * end_header
+ * ...body, one element after the other...
+ * </pre>
+ */
+
+namespace blender::io::ply {
+
+enum class PlyFormat {
+  ASCII,
+  BinaryLittleEndian,
+  BinaryBigEndian,
+};
+
+enum class PlyDataType {
+  Int8,
+  UInt8,
+  Int16,
+  UInt16,
+  Int32,
+  UInt32,
+  Float,
+  Double,
+};
+
+struct PlyProperty {
+  std::string name;
+  PlyDataType type;
+  /* Type of the element count of list properties. */
+  PlyDataType count_type;
+  bool is_list = false;
+};
+
+struct PlyElement {
+  std::string name;
+  int64_t count = 0;
+  Vector<PlyProperty> properties;
+
+  /* Size in bytes of one element in binary files, or -1 if it contains lists. */
+  int64_t stride() const;
+};
+
+struct PlyHeader {
+  PlyFormat format = PlyFormat::ASCII;
+  Vector<PlyElement> elements;
+  /* Size of the header in bytes, including the "end_header" line. */
+  int64_t size = 0;
+};
+
+/** A vertex property that is not part of the known ones, imported as a generic attribute. */
+struct PlyAttribute {
+  std::string name;
+  bool is_float;
+  Array<float> float_values;
+  Array<int> int_values;
+};
+
+/** Contents of a PLY file, as needed to build a mesh or a point cloud. */
+struct PlyData {
+  Array<float3> vertices;
+  /* Only when "nx", "ny" and "nz" vertex properties are present. */
+  Array<float3> vertex_normals;
+  /* Only when "red", "green" and "blue" vertex properties are present, alpha is optional. */
+  Array<float4> vertex_colors;
+  Vector<PlyAttribute> vertex_attributes;
+
+  /* Faces in compressed form: face_offsets[i] to face_offsets[i + 1] are the indices into
+   * face_vertices of face i. */
+  Vector<int> face_offsets;
+  Vector<int> face_vertices;
+
+  int faces_num() const
+  {
+    return face_offsets.is_empty() ? 0 : face_offsets.size() - 1;
+  }
+};
+
+/**
+ * Parse the header at the start of a PLY file. Returns false and adds the reason to the reports
+ * if it is not a valid PLY header.
+ */
+bool read_ply_header(StringRef text, PlyHeader &r_header, ReportList *reports);
+
+/**
+ * Read the vertex and face elements of a PLY file. \a data is the whole file contents, mapped or
+ * read in memory. Vertices of binary files are decoded in parallel.
+ */
+bool read_ply_data(Span<char> data,
+                   const PlyHeader &header,
+                   PlyData &r_data,
+                   ReportList *reports);
+
+}  // namespace blender::io::ply
@@ -0,0 +1,377 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include <climits>
+#include <cstring>
+
+#include "testing/testing.h"
+
+#include "ply_import_reader.hh"
+
+namespace blender::io::ply {
+
+class ply_importer_test : public testing::Test {
+ public:
+  /**
+   * Parse the header and body of the file contents, return false if any of them is invalid.
+   */
+  bool read(const std::string &contents)
+  {
+    header = PlyHeader();
+    data = PlyData();
+    if (!read_ply_header(contents, header, nullptr)) {
+      return false;
+    }
+    return read_ply_data(Span<char>(contents.data(), contents.size()), header, data, nullptr);
+  }
+
+  PlyHeader header;
+  PlyData data;
+};
+
+/** Binary body of a PLY file, written in either byte order. */
+class BinaryWriter {
+ private:
+  std::string &text_;
+  bool big_endian_;
+
+  void append(const void *value, const int size)
+  {
+    char bytes[8];
+    memcpy(bytes, value, size);
+    for (int i = 0; i < size; i++) {
+      text_ += bytes[big_endian_ ? size - 1 - i : i];
+    }
+  }
+
+ public:
+  /* Assumes a little endian machine, like the other binary IO tests. */
+  BinaryWriter(std::string &text, bool big_endian) : text_(text), big_endian_(big_endian)
+  {
+  }
+  template<typename T> BinaryWriter &operator<<(const T value)
+  {
+    append(&value, sizeof(T));
+    return *this;
+  }
+};
+
+static const char *cube_face_header =
+    "element face 2\n"
+    "property list uchar int vertex_indices\n"
+    "end_header\n";
+
+TEST_F(ply_importer_test, import_ascii)
+{
+  const std::string contents =
+      "ply\n"
+      "format ascii 1.0\n"
+      "comment made by hand\n"
+      "element vertex 4\n"
+      "property float x\n"
+      "property float y\n"
+      "property float z\n"
+      "property float nx\n"
+      "property float ny\n"
+      "property float nz\n"
+      "property uchar red\n"
+      "property uchar green\n"
+      "property uchar blue\n"
+      "element face 2\n"
+      "property list uchar int vertex_indices\n"
+      "end_header\n"
+      "0 0 0 0 0 1 255 0 0\n"
+      "1 0 0 0 0 1 0 255 0\n"
+      "1 1 0 0 0 1 0 0 255\n"
+      "-0.5 +1 2.5e1 0 0 1 51 102 153\n"
+      "4 0 1 2 3\n"
+      "3 0 2 3\n";
+  ASSERT_TRUE(read(contents));
+  EXPECT_EQ(header.format, PlyFormat::ASCII);
+  ASSERT_EQ(data.vertices.size(), 4);
+  EXPECT_V3_NEAR(data.vertices[1], float3(1, 0, 0), 1e-6f);
+  EXPECT_V3_NEAR(data.vertices[3], float3(-0.5f, 1, 25), 1e-6f);
+  ASSERT_EQ(data.vertex_normals.size(), 4);
+  EXPECT_V3_NEAR(data.vertex_normals[2], float3(0, 0, 1), 1e-6f);
+  ASSERT_EQ(data.vertex_colors.size(), 4);
+  EXPECT_V4_NEAR(data.vertex_colors[0], float4(1, 0, 0, 1), 1e-6f);
+  EXPECT_V4_NEAR(data.vertex_colors[3], float4(0.2f, 0.4f, 0.6f, 1), 1e-6f);
+  EXPECT_TRUE(data.vertex_attributes.is_empty());
+  ASSERT_EQ(data.faces_num(), 2);
+  EXPECT_EQ(data.face_offsets, Vector<int>({0, 4, 7}));
+  EXPECT_EQ(data.face_vertices, Vector<int>({0, 1, 2, 3, 0, 2, 3}));
+}
+
+/* The same quad and triangle in both byte orders, with types of all sizes. */
+static std::string binary_contents(const bool big_endian)
+{
+  std::string contents = std::string("ply\nformat ") +
+                         (big_endian ? "binary_big_endian" : "binary_little_endian") +
+                         " 1.0\n"
+                         "element vertex 4\n"
+                         "property double x\n"
+                         "property float y\n"
+                         "property float z\n"
+                         "property ushort red\n"
+                         "property ushort green\n"
+                         "property ushort blue\n"
+                         "property uchar alpha\n"
+                         "property short temperature\n" +
+                         cube_face_header;
+  BinaryWriter writer(contents, big_endian);
+  writer << 0.0 << 0.0f << 0.0f << uint16_t(65535) << uint16_t(0) << uint16_t(0) << uint8_t(255)
+         << int16_t(-300);
+  writer << 1.0 << 0.0f << 0.0f << uint16_t(0) << uint16_t(65535) << uint16_t(0) << uint8_t(0)
+         << int16_t(20);
+  writer << 1.0 << 1.0f << 0.0f << uint16_t(0) << uint16_t(0) << uint16_t(65535) << uint8_t(255)
+         << int16_t(0);
+  writer << -2.5 << 1.0f << 1e10f << uint16_t(0) << uint16_t(0) << uint16_t(0) << uint8_t(51)
+         << int16_t(1000);
+  writer << uint8_t(4) << 0 << 1 << 2 << 3;
+  writer << uint8_t(3) << 0 << 2 << 3;
+  return contents;
+}
+
+static void check_binary_data(const PlyData &data)
+{
+  ASSERT_EQ(data.vertices.size(), 4);
+  EXPECT_V3_NEAR(data.vertices[2], float3(1, 1, 0), 1e-6f);
+  EXPECT_V3_NEAR(data.vertices[3], float3(-2.5f, 1, 1e10f), 1e-6f);
+  EXPECT_TRUE(data.vertex_normals.is_empty());
+  ASSERT_EQ(data.vertex_colors.size(), 4);
+  EXPECT_V4_NEAR(data.vertex_colors[0], float4(1, 0, 0, 1), 1e-6f);
+  EXPECT_V4_NEAR(data.vertex_colors[1], float4(0, 1, 0, 0), 1e-6f);
+  EXPECT_V4_NEAR(data.vertex_colors[3], float4(0, 0, 0, 0.2f), 1e-6f);
+  ASSERT_EQ(data.vertex_attributes.size(), 1);
+  const PlyAttribute &attribute = data.vertex_attributes[0];
+  EXPECT_EQ(attribute.name, "temperature");
+  EXPECT_FALSE(attribute.is_float);
+  ASSERT_EQ(attribute.int_values.size(), 4);
+  EXPECT_EQ(attribute.int_values[0], -300);
+  EXPECT_EQ(attribute.int_values[3], 1000);
+  ASSERT_EQ(data.faces_num(), 2);
+  EXPECT_EQ(data.face_offsets, Vector<int>({0, 4, 7}));
+  EXPECT_EQ(data.face_vertices, Vector<int>({0, 1, 2, 3, 0, 2, 3}));
+}
+
+TEST_F(ply_importer_test, import_binary_little_endian)
+{
+  ASSERT_TRUE(read(binary_contents(false)));
+  EXPECT_EQ(header.format, PlyFormat::BinaryLittleEndian);
+  check_binary_data(data);
+}
+
+TEST_F(ply_importer_test, import_binary_big_endian)
+{
+  ASSERT_TRUE(read(binary_contents(true)));
+  EXPECT_EQ(header.format, PlyFormat::BinaryBigEndian);
+  check_binary_data(data);
+}
+
+TEST_F(ply_importer_test, import_truncated)
+{
+  /* Header without its end. */
+  EXPECT_FALSE(read("ply\nformat ascii 1.0\nelement vertex 1\nproperty float x\n"));
+  EXPECT_FALSE(read("ply\nformat ascii 1.0\nelement vertex 1\nproperty float x\nend_hea"));
+  EXPECT_FALSE(read("plx\nformat ascii 1.0\nend_header\n"));
+
+  /* Every binary file cut short of its last byte, in the vertices or in the faces. */
+  for (const bool big_endian : {false, true}) {
+    const std::string contents = binary_contents(big_endian);
+    ASSERT_TRUE(read(contents));
+    const int64_t header_size = header.size;
+    for (int64_t size = header_size; size < int64_t(contents.size()); size++) {
+      EXPECT_FALSE(read(contents.substr(0, size))) << "Binary file cut at " << size;
+    }
+  }
+
+  /* ASCII vertices or faces missing. */
+  const std::string ascii_header =
+      "ply\n"
+      "format ascii 1.0\n"
+      "element vertex 3\n"
+      "property float x\n"
+      "property float y\n"
+      "property float z\n"
+      "element face 1\n"
+      "property list uchar int vertex_indices\n"
+      "end_header\n";
+  EXPECT_TRUE(read(ascii_header + "0 0 0\n1 0 0\n0 1 0\n3 0 1 2\n"));
+  EXPECT_TRUE(read(ascii_header + "0 0 0\n1 0 0\n0 1 0\n3 0 1 2"));
+  EXPECT_FALSE(read(ascii_header + "0 0 0\n1 0 0\n0 1 0\n3 0 1"));
+  EXPECT_FALSE(read(ascii_header + "0 0 0\n1 0 0\n0 1 0\n"));
+  EXPECT_FALSE(read(ascii_header + "0 0 0\n1 0 0\n0 1"));
+  EXPECT_FALSE(read(ascii_header + "0 0 0\n1 0 0\n"));
+  EXPECT_FALSE(read(ascii_header));
+}
+
+TEST_F(ply_importer_test, import_invalid_counts)
+{
+  const std::string vertex_properties =
+      "property float x\n"
+      "property float y\n"
+      "property float z\n";
+
+  /* Counts beyond the int range, or that do not fit in 64 bits. */
+  EXPECT_FALSE(read("ply\nformat ascii 1.0\nelement vertex 4000000000\n" + vertex_properties +
+                    "end_header\n"));
+  EXPECT_FALSE(read("ply\nformat ascii 1.0\nelement vertex 99999999999999999999\n" +
+                    vertex_properties + "end_header\n"));
+
+  /* Counts the file is far too small for are rejected before anything is allocated. */
+  for (const char *format : {"ascii", "binary_little_endian"}) {
+    std::string contents = std::string("ply\nformat ") + format + " 1.0\n" +
+                           "element vertex 2000000000\n" + vertex_properties +
+                           "end_header\n0 0 0\n";
+    EXPECT_FALSE(read(contents)) << format;
+    contents = std::string("ply\nformat ") + format + " 1.0\n" +
+               "element vertex 0\n" + vertex_properties +
+               "element face 2000000000\n"
+               "property list uchar int vertex_indices\n"
+               "end_header\n";
+    EXPECT_FALSE(read(contents + "0\n")) << format;
+  }
+  /* Elements skipped or with lists in vertices too. */
+  EXPECT_FALSE(read("ply\nformat binary_little_endian 1.0\nelement material 2000000000\n"
+                    "property list uchar uchar name\nend_header\n"));
+  EXPECT_FALSE(read("ply\nformat binary_little_endian 1.0\nelement vertex 2000000000\n" +
+                    vertex_properties + "property list uchar float samples\nend_header\n"));
+
+  /* List sizes larger than the rest of the file. */
+  const std::string ascii_header = std::string("ply\nformat ascii 1.0\nelement vertex 3\n") +
+                                   vertex_properties +
+                                   "element face 1\n"
+                                   "property list uint int vertex_indices\n"
+                                   "end_header\n"
+                                   "0 0 0\n1 0 0\n0 1 0\n";
+  EXPECT_TRUE(read(ascii_header + "3 0 1 2\n"));
+  EXPECT_FALSE(read(ascii_header + "4000000000 0 1 2\n"));
+  EXPECT_FALSE(read(ascii_header + "-3 0 1 2\n"));
+}
+
+TEST_F(ply_importer_test, import_invalid_face_indices)
+{
+  const std::string header_text =
+      "ply\n"
+      "format binary_little_endian 1.0\n"
+      "element vertex 3\n"
+      "property float x\n"
+      "property float y\n"
+      "property float z\n"
+      "element face 1\n"
+      "property list uchar uint vertex_indices\n"
+      "end_header\n";
+  for (const uint32_t index : {2u, uint32_t(INT_MAX), uint32_t(INT_MAX) + 1u, 3000000000u}) {
+    std::string contents = header_text;
+    BinaryWriter writer(contents, false);
+    writer << 0.0f << 0.0f << 0.0f << 1.0f << 0.0f << 0.0f << 0.0f << 1.0f << 0.0f;
+    writer << uint8_t(3) << 0u << 1u << index;
+    /* Indices in the int range are read, out of range vertices are handled when building the
+     * mesh. Larger ones can not be stored and reject the file. */
+    EXPECT_EQ(read(contents), index <= uint32_t(INT_MAX)) << index;
+  }
+
+  const std::string ascii_header =
+      "ply\n"
+      "format ascii 1.0\n"
+      "element vertex 3\n"
+      "property float x\n"
+      "property float y\n"
+      "property float z\n"
+      "element face 1\n"
+      "property list uchar int vertex_indices\n"
+      "end_header\n"
+      "0 0 0\n1 0 0\n0 1 0\n";
+  ASSERT_TRUE(read(ascii_header + "3 0 1 -1\n"));
+  EXPECT_EQ(data.face_vertices, Vector<int>({0, 1, -1}));
+  EXPECT_FALSE(read(ascii_header + "3 0 1 3000000000\n"));
+  EXPECT_FALSE(read(ascii_header + "3 0 1 -3000000000\n"));
+}
+
+TEST_F(ply_importer_test, import_extra_properties)
+{
+  /* Unknown vertex properties become attributes, lists in vertices and unknown elements are
+   * skipped, and face properties other than the indices are ignored. */
+  std::string contents =
+      "ply\n"
+      "format binary_little_endian 1.0\n"
+      "obj_info scanned\n"
+      "element vertex 3\n"
+      "property float quality\n"
+      "property float x\n"
+      "property float y\n"
+      "property float z\n"
+      "property list uchar float samples\n"
+      "property int segment\n"
+      "element material 2\n"
+      "property uchar ambient_red\n"
+      "property list uchar uchar name\n"
+      "element face 1\n"
+      "property uchar flags\n"
+      "property list uchar uint vertex_index\n"
+      "property list uchar float texcoord\n"
+      "end_header\n";
+  BinaryWriter writer(contents, false);
+  writer << 0.5f << 0.0f << 0.0f << 0.0f << uint8_t(0) << 7;
+  writer << 0.25f << 1.0f << 0.0f << 0.0f << uint8_t(2) << 1.0f << 2.0f << 8;
+  writer << 0.0f << 0.0f << 1.0f << 0.0f << uint8_t(1) << 3.0f << -1;
+  writer << uint8_t(10) << uint8_t(2) << 'a' << 'b';
+  writer << uint8_t(20) << uint8_t(0);
+  writer << uint8_t(1) << uint8_t(3) << 2u << 1u << 0u << uint8_t(6) << 0.0f << 0.0f << 1.0f
+         << 0.0f << 0.0f << 1.0f;
+
+  ASSERT_TRUE(read(contents));
+  ASSERT_EQ(header.elements.size(), 3);
+  ASSERT_EQ(data.vertices.size(), 3);
+  EXPECT_V3_NEAR(data.vertices[1], float3(1, 0, 0), 1e-6f);
+  EXPECT_V3_NEAR(data.vertices[2], float3(0, 1, 0), 1e-6f);
+  EXPECT_TRUE(data.vertex_colors.is_empty());
+  ASSERT_EQ(data.vertex_attributes.size(), 2);
+  EXPECT_EQ(data.vertex_attributes[0].name, "quality");
+  EXPECT_TRUE(data.vertex_attributes[0].is_float);
+  EXPECT_NEAR(data.vertex_attributes[0].float_values[1], 0.25f, 1e-6f);
+  EXPECT_EQ(data.vertex_attributes[1].name, "segment");
+  EXPECT_FALSE(data.vertex_attributes[1].is_float);
+  EXPECT_EQ(data.vertex_attributes[1].int_values[2], -1);
+  EXPECT_EQ(data.face_offsets, Vector<int>({0, 3}));
+  EXPECT_EQ(data.face_vertices, Vector<int>({2, 1, 0}));
+
+  /* The same in ASCII. */
+  contents =
+      "ply\n"
+      "format ascii 1.0\n"
+      "element vertex 3\n"
+      "property float quality\n"
+      "property float x\n"
+      "property float y\n"
+      "property float z\n"
+      "property list uchar float samples\n"
+      "property int segment\n"
+      "element material 2\n"
+      "property uchar ambient_red\n"
+      "element face 1\n"
+      "property uchar flags\n"
+      "property list uchar uint vertex_index\n"
+      "property list uchar float texcoord\n"
+      "end_header\n"
+      "0.5 0 0 0 0 7\n"
+      "0.25 1 0 0 2 1 2 8\n"
+      "0 0 1 0 1 3 -1\n"
+      "10\n"
+      "20\n"
+      "1 3 2 1 0 6 0 0 1 0 0 1\n";
+  ASSERT_TRUE(read(contents));
+  ASSERT_EQ(data.vertices.size(), 3);
+  EXPECT_V3_NEAR(data.vertices[2], float3(0, 1, 0), 1e-6f);
+  ASSERT_EQ(data.vertex_attributes.size(), 2);
+  EXPECT_NEAR(data.vertex_attributes[0].float_values[1], 0.25f, 1e-6f);
+  EXPECT_EQ(data.vertex_attributes[1].int_values[1], 8);
+  EXPECT_EQ(data.vertex_attributes[1].int_values[2], -1);
+  EXPECT_EQ(data.face_vertices, Vector<int>({2, 1, 0}));
+
+  /* Vertices need a position. */
+  EXPECT_FALSE(read("ply\nformat ascii 1.0\nelement vertex 1\nproperty float x\nend_header\n1\n"));
+}
+
+}  // namespace blender::io::ply
@@ -14,6 +14,8 @@
 extern "C" {
 #endif
 
+struct ReportList;
+
 struct STLImportParams {
   /** Full path to the source STL file to import. */
   char filepath[FILE_MAX];
@@ -23,6 +25,22 @@ struct STLImportParams {
   bool use_scene_unit;
   float global_scale;
   bool use_mesh_validate;
+  /** Receives the errors met while reading the file, may be null. */
+  struct ReportList *reports;
+};
+
+struct STLExportParams {
+  /** Full path to the destination STL file. */
+  char filepath[FILE_MAX];
+  eIOAxis forward_axis;
+  eIOAxis up_axis;
+  float global_scale;
+  bool use_scene_unit;
+  bool export_selected_objects;
+  bool apply_modifiers;
+  bool ascii_format;
+  /** Receives the errors met while writing the file, may be null. */
+  struct ReportList *reports;
 };
 
 /**
@@ -30,6 +48,12 @@ struct STLImportParams {
  */
 void STL_import(bContext *C, const struct STLImportParams *import_params);
 
+/**
+ * C-interface for the exporter.
+ * \return false if the file could not be written, the reason is in the reports of the params.
+ */
+bool STL_export(bContext *C, const struct STLExportParams *export_params);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,225 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup stl
+ */
+
+#include <cstdio>
+#include <string>
+
+#include "BKE_blender_version.h"
+#include "BKE_context.h"
+#include "BKE_mesh.h"
+#include "BKE_mesh_runtime.h"
+#include "BKE_object.h"
+#include "BKE_report.h"
+
+#include "BLI_array.hh"
+#include "BLI_fileops.h"
+#include "BLI_float4x4.hh"
+#include "BLI_math_matrix.h"
+#include "BLI_math_rotation.h"
+#include "BLI_math_vector.h"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
+
+#include "DEG_depsgraph.h"
+#include "DEG_depsgraph_query.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "ED_object.h"
+
+#include "stl_export.hh"
+#include "stl_export_writer.hh"
+
+namespace blender::io::stl {
+
+/* Number of triangles formatted by one task. */
+static constexpr int EXPORT_CHUNK_SIZE = 16 * 1024;
+/* Number of chunks formatted before they are written to the file, to bound memory usage. */
+static constexpr int CHUNKS_PER_WRITE = 64;
+
+struct STLExportMesh {
+  const Mesh *mesh;
+  Span<MLoopTri> looptris;
+  float4x4 transform;
+  /* Negative scales flip the winding of triangles, swap two corners to keep normals outside. */
+  bool flip_winding;
+};
+
+struct STLExportChunk {
+  int mesh_index;
+  IndexRange looptris;
+};
+
+/**
+ * Gather the meshes of the objects to export, with their triangulation and transform into the
+ * exported space.
+ */
+static Vector<STLExportMesh> gather_export_meshes(Depsgraph *depsgraph,
+                                                  const STLExportParams &export_params,
+                                                  const float4x4 &global_transform)
+{
+  Vector<STLExportMesh> meshes;
+  const int deg_objects_visibility_flags = DEG_ITER_OBJECT_FLAG_LINKED_DIRECTLY |
+                                           DEG_ITER_OBJECT_FLAG_LINKED_VIA_SET |
+                                           DEG_ITER_OBJECT_FLAG_VISIBLE |
+                                           DEG_ITER_OBJECT_FLAG_DUPLI;
+  DEG_OBJECT_ITER_BEGIN (depsgraph, object, deg_objects_visibility_flags) {
+    if (export_params.export_selected_objects && !(object->base_flag & BASE_SELECTED)) {
+      continue;
+    }
+    if (object->type != OB_MESH) {
+      continue;
+    }
+    const Mesh *mesh = export_params.apply_modifiers ? BKE_object_get_evaluated_mesh(object) :
+                                                       BKE_object_get_pre_modified_mesh(object);
+    if (mesh == nullptr) {
+      continue;
+    }
+    /* Triangulation is cached on the evaluated mesh, and shared with drawing. */
+    const MLoopTri *looptris = BKE_mesh_runtime_looptri_ensure(mesh);
+    const int looptris_num = BKE_mesh_runtime_looptri_len(mesh);
+    if (looptris_num == 0) {
+      continue;
+    }
+    const float4x4 transform = global_transform * float4x4(object->obmat);
+    meshes.append({mesh,
+                   Span<MLoopTri>(looptris, looptris_num),
+                   transform,
+                   is_negative_m4(transform.values)});
+  }
+  DEG_OBJECT_ITER_END;
+  return meshes;
+}
+
+static void write_chunk(const STLExportMesh &export_mesh,
+                        const IndexRange looptris,
+                        const bool ascii_format,
+                        STLFileBuffer &buffer)
+{
+  const MVert *mvert = export_mesh.mesh->mvert;
+  const MLoop *mloop = export_mesh.mesh->mloop;
+  for (const int i : looptris) {
+    const MLoopTri &looptri = export_mesh.looptris[i];
+    const float3 v1 = export_mesh.transform * float3(mvert[mloop[looptri.tri[0]].v].co);
+    float3 v2 = export_mesh.transform * float3(mvert[mloop[looptri.tri[1]].v].co);
+    float3 v3 = export_mesh.transform * float3(mvert[mloop[looptri.tri[2]].v].co);
+    if (export_mesh.flip_winding) {
+      std::swap(v2, v3);
+    }
+    float3 normal;
+    normal_tri_v3(normal, v1, v2, v3);
+    if (ascii_format) {
+      buffer.write_ascii_triangle(normal, v1, v2, v3);
+    }
+    else {
+      buffer.write_binary_triangle(normal, v1, v2, v3);
+    }
+  }
+}
+
+bool exporter_main(bContext *C, const STLExportParams &export_params)
+{
+  ED_object_mode_set(C, OB_MODE_OBJECT);
+  Depsgraph *depsgraph = CTX_data_ensure_evaluated_depsgraph(C);
+  Scene *scene = CTX_data_scene(C);
+
+  float global_scale = export_params.global_scale;
+  if ((scene->unit.system != USER_UNIT_NONE) && export_params.use_scene_unit) {
+    global_scale *= scene->unit.scale_length;
+  }
+  float axes_transform[3][3];
+  unit_m3(axes_transform);
+  /* +Y-forward and +Z-up are the Blender's default axis settings. */
+  mat3_from_axis_conversion(
+      export_params.forward_axis, export_params.up_axis, IO_AXIS_Y, IO_AXIS_Z, axes_transform);
+  float4x4 global_transform;
+  copy_m4_m3(global_transform.values, axes_transform);
+  mul_mat3_m4_fl(global_transform.values, global_scale);
+
+  const Vector<STLExportMesh> meshes = gather_export_meshes(
+      depsgraph, export_params, global_transform);
+
+  /* Chunks of all meshes are formatted together, so that small meshes are batched. */
+  Vector<STLExportChunk> chunks;
+  int64_t tris_num = 0;
+  for (const int mesh_index : meshes.index_range()) {
+    const int looptris_num = meshes[mesh_index].looptris.size();
+    for (int start = 0; start < looptris_num; start += EXPORT_CHUNK_SIZE) {
+      chunks.append({mesh_index,
+                     IndexRange(start, std::min(EXPORT_CHUNK_SIZE, looptris_num - start))});
+    }
+    tris_num += looptris_num;
+  }
+  if (!export_params.ascii_format && tris_num > UINT32_MAX) {
+    BKE_reportf(export_params.reports,
+                RPT_ERROR,
+                "STL Exporter: too many triangles for a binary STL file (%lld)",
+                (long long)tris_num);
+    return false;
+  }
+
+  FILE *file = BLI_fopen(export_params.filepath, "wb");
+  if (!file) {
+    BKE_reportf(export_params.reports,
+                RPT_ERROR,
+                "STL Exporter: cannot open file '%s'",
+                export_params.filepath);
+    return false;
+  }
+
+  const std::string header = std::string("Exported from Blender-") +
+                             BKE_blender_version_string();
+  bool write_ok = true;
+
+  STLFileBuffer header_buffer;
+  if (export_params.ascii_format) {
+    header_buffer.write_ascii_solid_begin(header);
+  }
+  else {
+    header_buffer.write_binary_header(header, uint32_t(tris_num));
+  }
+  write_ok &= header_buffer.write_to_file(file);
+
+  Array<STLFileBuffer> buffers(std::min<int64_t>(chunks.size(), CHUNKS_PER_WRITE));
+  for (int64_t first_chunk = 0; first_chunk < chunks.size(); first_chunk += CHUNKS_PER_WRITE) {
+    const IndexRange batch(first_chunk,
+                           std::min<int64_t>(CHUNKS_PER_WRITE, chunks.size() - first_chunk));
+    threading::parallel_for(batch, 1, [&](IndexRange range) {
+      for (const int64_t i : range) {
+        const STLExportChunk &chunk = chunks[i];
+        write_chunk(meshes[chunk.mesh_index],
+                    chunk.looptris,
+                    export_params.ascii_format,
+                    buffers[i - first_chunk]);
+      }
+    });
+    for (const int64_t i : batch) {
+      write_ok &= buffers[i - first_chunk].write_to_file(file);
+    }
+  }
+
+  if (export_params.ascii_format) {
+    STLFileBuffer footer_buffer;
+    footer_buffer.write_ascii_solid_end(header);
+    write_ok &= footer_buffer.write_to_file(file);
+  }
+
+  /* Buffered data is only flushed on close, which can fail too, e.g. when the disk is full. */
+  write_ok &= fclose(file) == 0;
+  if (!write_ok) {
+    BKE_reportf(export_params.reports,
+                RPT_ERROR,
+                "STL Exporter: failed to write to file '%s'",
+                export_params.filepath);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace blender::io::stl
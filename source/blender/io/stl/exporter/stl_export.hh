@@ -0,0 +1,16 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup stl
+ */
+
+#pragma once
+
+#include "IO_stl.h"
+
+namespace blender::io::stl {
+
+/* Main export function used from within Blender. Returns false if the file was not written. */
+bool exporter_main(bContext *C, const STLExportParams &export_params);
+
+}  // namespace blender::io::stl
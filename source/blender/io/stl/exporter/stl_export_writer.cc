@@ -0,0 +1,96 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup stl
+ */
+
+#include <algorithm>
+#include <cstring>
+
+/* SEP macro from BLI path utils clashes with SEP symbol in fmt headers. */
+#undef SEP
+#define FMT_HEADER_ONLY
+#include <fmt/format.h>
+
+#include "BLI_math_vector.h"
+
+#include "stl_export_writer.hh"
+
+namespace blender::io::stl {
+
+#pragma pack(push, 1)
+struct STLBinaryTriangle {
+  float normal[3];
+  float v1[3], v2[3], v3[3];
+  uint16_t attribute_byte_count;
+};
+#pragma pack(pop)
+
+static constexpr size_t BINARY_HEADER_SIZE = 80;
+
+void STLFileBuffer::write_binary_header(StringRef header, uint32_t tris_num)
+{
+  char buffer[BINARY_HEADER_SIZE + sizeof(uint32_t)] = {0};
+  memcpy(buffer, header.data(), std::min<size_t>(header.size(), BINARY_HEADER_SIZE));
+  memcpy(buffer + BINARY_HEADER_SIZE, &tris_num, sizeof(uint32_t));
+  append(buffer, sizeof(buffer));
+}
+
+void STLFileBuffer::write_binary_triangle(const float3 &normal,
+                                          const float3 &v1,
+                                          const float3 &v2,
+                                          const float3 &v3)
+{
+  STLBinaryTriangle tri;
+  copy_v3_v3(tri.normal, normal);
+  copy_v3_v3(tri.v1, v1);
+  copy_v3_v3(tri.v2, v2);
+  copy_v3_v3(tri.v3, v3);
+  tri.attribute_byte_count = 0;
+  append_bytes(tri);
+}
+
+void STLFileBuffer::write_ascii_solid_begin(StringRef name)
+{
+  fmt::memory_buffer buf;
+  fmt::format_to(fmt::appender(buf), "solid {}\n", std::string_view(name));
+  append(buf.data(), buf.size());
+}
+
+void STLFileBuffer::write_ascii_solid_end(StringRef name)
+{
+  fmt::memory_buffer buf;
+  fmt::format_to(fmt::appender(buf), "endsolid {}\n", std::string_view(name));
+  append(buf.data(), buf.size());
+}
+
+void STLFileBuffer::write_ascii_triangle(const float3 &normal,
+                                         const float3 &v1,
+                                         const float3 &v2,
+                                         const float3 &v3)
+{
+  fmt::memory_buffer buf;
+  fmt::format_to(fmt::appender(buf),
+                 "facet normal {:e} {:e} {:e}\n"
+                 " outer loop\n"
+                 "  vertex {:e} {:e} {:e}\n"
+                 "  vertex {:e} {:e} {:e}\n"
+                 "  vertex {:e} {:e} {:e}\n"
+                 " endloop\n"
+                 "endfacet\n",
+                 normal.x,
+                 normal.y,
+                 normal.z,
+                 v1.x,
+                 v1.y,
+                 v1.z,
+                 v2.x,
+                 v2.y,
+                 v2.z,
+                 v3.x,
+                 v3.y,
+                 v3.z);
+  append(buf.data(), buf.size());
+}
+
+}  // namespace blender::io::stl
@@ -0,0 +1,37 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup stl
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "BLI_math_vec_types.hh"
+#include "BLI_string_ref.hh"
+
+#include "IO_chunked_file_buffer.hh"
+
+namespace blender::io::stl {
+
+/**
+ * Buffer of STL file contents, see #ChunkedFileBuffer.
+ */
+class STLFileBuffer : public ChunkedFileBuffer {
+ public:
+  void write_binary_header(StringRef header, uint32_t tris_num);
+  void write_binary_triangle(const float3 &normal,
+                             const float3 &v1,
+                             const float3 &v2,
+                             const float3 &v3);
+
+  void write_ascii_solid_begin(StringRef name);
+  void write_ascii_solid_end(StringRef name);
+  void write_ascii_triangle(const float3 &normal,
+                            const float3 &v1,
+                            const float3 &v2,
+                            const float3 &v3);
+};
+
+}  // namespace blender::io::stl
@@ -4,12 +4,15 @@
  * \ingroup stl
  */
 
+#include <cerrno>
 #include <cstdio>
+#include <cstring>
 
 #include "BKE_customdata.h"
 #include "BKE_layer.h"
 #include "BKE_mesh.h"
 #include "BKE_object.h"
+#include "BKE_report.h"
 
 #include "DNA_collection_types.h"
 #include "DNA_scene_types.h"
@@ -29,14 +32,13 @@
 
 namespace blender::io::stl {
 
-void stl_import_report_error(FILE *file)
+void stl_import_report_error(FILE *file, ReportList *reports)
 {
-  fprintf(stderr, "STL Importer: failed to read file");
   if (feof(file)) {
-    fprintf(stderr, ", end of file reached.\n");
+    BKE_report(reports, RPT_ERROR, "STL Importer: failed to read file, end of file reached");
   }
   else if (ferror(file)) {
-    perror("Error");
+    BKE_reportf(reports, RPT_ERROR, "STL Importer: failed to read file: %s", strerror(errno));
   }
 }
 
@@ -55,7 +57,10 @@ void importer_main(Main *bmain,
 {
   FILE *file = BLI_fopen(import_params.filepath, "rb");
   if (!file) {
-    fprintf(stderr, "Failed to open STL file:'%s'.\n", import_params.filepath);
+    BKE_reportf(import_params.reports,
+                RPT_ERROR,
+                "STL Importer: cannot open file '%s'",
+                import_params.filepath);
     return;
   }
   BLI_SCOPED_DEFER([&]() { fclose(file); });
@@ -65,13 +70,15 @@ void importer_main(Main *bmain,
    * this is the same as the old Python importer.
    */
   uint32_t num_tri = 0;
-  size_t file_size = BLI_file_size(import_params.filepath);
+  const int64_t file_size = BLI_file_size(import_params.filepath);
   fseek(file, BINARY_HEADER_SIZE, SEEK_SET);
   if (fread(&num_tri, sizeof(uint32_t), 1, file) != 1) {
-    stl_import_report_error(file);
+    stl_import_report_error(file, import_params.reports);
     return;
   }
-  bool is_ascii_stl = (file_size != (BINARY_HEADER_SIZE + 4 + BINARY_STRIDE * num_tri));
+  const int64_t binary_size = int64_t(BINARY_HEADER_SIZE + sizeof(uint32_t)) +
+                              int64_t(num_tri) * int64_t(BINARY_STRIDE);
+  bool is_ascii_stl = (file_size != binary_size);
 
   /* Name used for both mesh and object. */
   char ob_name[FILE_MAX];
@@ -80,14 +87,25 @@ void importer_main(Main *bmain,
 
   Mesh *mesh = nullptr;
   if (is_ascii_stl) {
-    mesh = read_stl_ascii(import_params.filepath, bmain, ob_name, import_params.use_facet_normal);
+    mesh = read_stl_ascii(import_params.filepath,
+                          bmain,
+                          ob_name,
+                          import_params.use_facet_normal,
+                          import_params.reports);
   }
   else {
-    mesh = read_stl_binary(file, bmain, ob_name, import_params.use_facet_normal);
+    mesh = read_stl_binary(import_params.filepath,
+                           bmain,
+                           ob_name,
+                           import_params.use_facet_normal,
+                           import_params.reports);
   }
 
   if (mesh == nullptr) {
-    fprintf(stderr, "STL Importer: Failed to import mesh '%s'\n", import_params.filepath);
+    BKE_reportf(import_params.reports,
+                RPT_ERROR,
+                "STL Importer: failed to import mesh '%s'",
+                import_params.filepath);
     return;
   }
 
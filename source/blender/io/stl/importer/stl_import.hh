@@ -10,7 +10,7 @@
 
 namespace blender::io::stl {
 
-void stl_import_report_error(FILE *file);
+void stl_import_report_error(FILE *file, ReportList *reports);
 
 /* Main import function used from within Blender. */
 void importer_main(bContext *C, const STLImportParams &import_params);
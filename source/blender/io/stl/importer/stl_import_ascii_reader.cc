@@ -4,14 +4,19 @@
  * \ingroup stl
  */
 
+#include <climits>
 #include <cstdint>
 #include <cstdio>
 
 #include "BKE_mesh.h"
+#include "BKE_report.h"
 
+#include "BLI_array.hh"
 #include "BLI_fileops.hh"
 #include "BLI_memory_utils.hh"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
 
 #include "DNA_mesh_types.h"
 
@@ -111,23 +116,50 @@ static inline void parse_float3(StringBuffer &buf, float out[3])
   }
 }
 
-Mesh *read_stl_ascii(const char *filepath, Main *bmain, char *mesh_name, bool use_custom_normals)
+/* Approximate size of the text parsed by one task. */
+static constexpr size_t ASCII_CHUNK_SIZE = 256 * 1024;
+
+/** Triangles parsed from one chunk of the file. */
+struct STLAsciiChunk {
+  const char *start;
+  const char *end;
+  Vector<float3> corner_positions;
+  Vector<float3> facet_normals;
+};
+
+static bool is_token_separator(const char c)
 {
-  size_t buffer_len;
-  void *buffer = BLI_file_read_text_as_mem(filepath, 0, &buffer_len);
-  if (buffer == nullptr) {
-    fprintf(stderr, "STL Importer: cannot read from ASCII STL file: '%s'\n", filepath);
-    return BKE_mesh_add(bmain, mesh_name);
-  }
-  BLI_SCOPED_DEFER([&]() { MEM_freeN(buffer); });
+  return c <= ' ';
+}
 
-  int num_reserved_tris = 1024;
+/**
+ * Find the first "facet" token at or after \a pos, or \a end if there is none. Chunks of the file
+ * are split at facet starts, so that each chunk can be parsed independently.
+ */
+static const char *find_facet_start(const char *pos, const char *begin, const char *end)
+{
+  const StringRef facet = "facet";
+  while (pos < end) {
+    const int64_t offset = StringRef(pos, end).find(facet);
+    if (offset == StringRef::not_found) {
+      return end;
+    }
+    const char *candidate = pos + offset;
+    const char *candidate_end = candidate + facet.size();
+    if ((candidate == begin || is_token_separator(candidate[-1])) &&
+        (candidate_end == end || is_token_separator(*candidate_end))) {
+      return candidate;
+    }
+    pos = candidate_end;
+  }
+  return end;
+}
 
-  StringBuffer str_buf(static_cast<char *>(buffer), buffer_len);
-  STLMeshHelper stl_mesh(num_reserved_tris, use_custom_normals);
-  float triangle_buf[3][3];
-  float custom_normal_buf[3];
-  str_buf.drop_line(); /* Skip header line */
+static void parse_stl_ascii_chunk(STLAsciiChunk &chunk, bool use_custom_normals)
+{
+  StringBuffer str_buf(const_cast<char *>(chunk.start), chunk.end - chunk.start);
+  float triangle_buf[3][3] = {{0.0f}};
+  float custom_normal_buf[3] = {0.0f};
   while (!str_buf.is_empty()) {
     if (str_buf.parse_token("vertex", 6)) {
       parse_float3(str_buf, triangle_buf[0]);
@@ -137,12 +169,11 @@ Mesh *read_stl_ascii(const char *filepath, Main *bmain, char *mesh_name, bool us
       if (str_buf.parse_token("vertex", 6)) {
         parse_float3(str_buf, triangle_buf[2]);
       }
+      chunk.corner_positions.append(triangle_buf[0]);
+      chunk.corner_positions.append(triangle_buf[1]);
+      chunk.corner_positions.append(triangle_buf[2]);
       if (use_custom_normals) {
-        stl_mesh.add_triangle(
-            triangle_buf[0], triangle_buf[1], triangle_buf[2], custom_normal_buf);
-      }
-      else {
-        stl_mesh.add_triangle(triangle_buf[0], triangle_buf[1], triangle_buf[2]);
+        chunk.facet_normals.append(custom_normal_buf);
       }
     }
     else if (str_buf.parse_token("facet", 5)) {
@@ -153,8 +184,84 @@ Mesh *read_stl_ascii(const char *filepath, Main *bmain, char *mesh_name, bool us
       str_buf.drop_token();
     }
   }
+}
+
+Mesh *read_stl_ascii(const char *filepath,
+                     Main *bmain,
+                     char *mesh_name,
+                     bool use_custom_normals,
+                     ReportList *reports)
+{
+  size_t buffer_len;
+  void *buffer = BLI_file_read_text_as_mem(filepath, 0, &buffer_len);
+  if (buffer == nullptr) {
+    BKE_reportf(
+        reports, RPT_ERROR, "STL Importer: cannot read from ASCII STL file: '%s'", filepath);
+    return nullptr;
+  }
+  BLI_SCOPED_DEFER([&]() { MEM_freeN(buffer); });
+
+  const char *text = static_cast<const char *>(buffer);
+  const char *text_end = text + buffer_len;
+
+  /* Skip header line. */
+  const char *body = static_cast<const char *>(memchr(text, '\n', buffer_len));
+  body = body ? body : text_end;
+
+  /* Split the file at facet starts, every #ASCII_CHUNK_SIZE bytes or so. */
+  Vector<STLAsciiChunk> chunks;
+  const char *chunk_start = body;
+  while (chunk_start < text_end) {
+    const char *chunk_end = text_end;
+    if (size_t(text_end - chunk_start) > ASCII_CHUNK_SIZE) {
+      chunk_end = find_facet_start(chunk_start + ASCII_CHUNK_SIZE, body, text_end);
+    }
+    chunks.append({chunk_start, chunk_end});
+    chunk_start = chunk_end;
+  }
+
+  threading::parallel_for(chunks.index_range(), 1, [&](IndexRange range) {
+    for (const int i : range) {
+      parse_stl_ascii_chunk(chunks[i], use_custom_normals);
+    }
+  });
+
+  Array<int64_t> chunk_tri_offsets(chunks.size() + 1);
+  int64_t tris_num = 0;
+  for (const int i : chunks.index_range()) {
+    chunk_tri_offsets[i] = tris_num;
+    tris_num += chunks[i].corner_positions.size() / 3;
+  }
+  chunk_tri_offsets[chunks.size()] = tris_num;
+  /* Mesh corners are counted with an int. */
+  if (tris_num * 3 > INT_MAX) {
+    BKE_reportf(reports,
+                RPT_ERROR,
+                "STL Importer: too many triangles (%lld) in ASCII STL file: '%s'",
+                (long long)tris_num,
+                filepath);
+    return nullptr;
+  }
+
+  STLMeshHelper stl_mesh(int(tris_num), use_custom_normals);
+  MutableSpan<float3> corner_positions = stl_mesh.corner_positions();
+  MutableSpan<float3> facet_normals = stl_mesh.facet_normals();
+  threading::parallel_for(chunks.index_range(), 1, [&](IndexRange range) {
+    for (const int i : range) {
+      const int64_t tri_offset = chunk_tri_offsets[i];
+      const int64_t chunk_tris_num = chunk_tri_offsets[i + 1] - tri_offset;
+      corner_positions.slice(3 * tri_offset, 3 * chunk_tris_num)
+          .copy_from(chunks[i].corner_positions);
+      if (use_custom_normals) {
+        facet_normals.slice(tri_offset, chunk_tris_num).copy_from(chunks[i].facet_normals);
+      }
+      /* Release chunk memory early, the helper now holds a copy. */
+      chunks[i].corner_positions.clear_and_make_inline();
+      chunks[i].facet_normals.clear_and_make_inline();
+    }
+  });
 
-  return stl_mesh.to_mesh(bmain, mesh_name);
+  return stl_mesh.to_mesh(bmain, mesh_name, reports);
 }
 
 }  // namespace blender::io::stl
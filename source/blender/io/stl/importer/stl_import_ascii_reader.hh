@@ -30,6 +30,10 @@
 
 namespace blender::io::stl {
 
-Mesh *read_stl_ascii(const char *filepath, Main *bmain, char *mesh_name, bool use_custom_normals);
+Mesh *read_stl_ascii(const char *filepath,
+                    Main *bmain,
+                    char *mesh_name,
+                    bool use_custom_normals,
+                    ReportList *reports);
 
 }  // namespace blender::io::stl
@@ -4,17 +4,31 @@
  * \ingroup stl
  */
 
+#include <climits>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+
+#ifndef WIN32
+#  include <unistd.h>
+#else
+#  include <io.h>
+#endif
 
 #include "BKE_main.h"
 #include "BKE_mesh.h"
+#include "BKE_report.h"
 
-#include "BLI_array.hh"
+#include "BLI_fileops.h"
 #include "BLI_memory_utils.hh"
+#include "BLI_mmap.h"
+#include "BLI_task.hh"
 
 #include "DNA_mesh_types.h"
 
+#include "MEM_guardedalloc.h"
+
 #include "stl_import.hh"
 #include "stl_import_binary_reader.hh"
 #include "stl_import_mesh.hh"
@@ -29,35 +43,94 @@ struct STLBinaryTriangle {
 };
 #pragma pack(pop)
 
-Mesh *read_stl_binary(FILE *file, Main *bmain, char *mesh_name, bool use_custom_normals)
+Mesh *read_stl_binary(const char *filepath,
+                      Main *bmain,
+                      char *mesh_name,
+                      bool use_custom_normals,
+                      ReportList *reports)
 {
-  const int chunk_size = 1024;
-  uint32_t num_tris = 0;
-  fseek(file, BINARY_HEADER_SIZE, SEEK_SET);
-  if (fread(&num_tris, sizeof(uint32_t), 1, file) != 1) {
-    stl_import_report_error(file);
+  const int file = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+  if (file == -1) {
+    BKE_reportf(
+        reports, RPT_ERROR, "STL Importer: cannot read from binary STL file: '%s'", filepath);
     return nullptr;
   }
+  BLI_SCOPED_DEFER([&]() { close(file); });
 
+  const int64_t file_size = BLI_lseek(file, 0, SEEK_END);
+  if (file_size < int64_t(BINARY_HEADER_SIZE + sizeof(uint32_t))) {
+    BKE_reportf(reports, RPT_ERROR, "STL Importer: binary STL file is too short: '%s'", filepath);
+    return nullptr;
+  }
+
+  /* Map the file rather than reading it, so that triangles can be decoded from all threads
+   * without going through an intermediate buffer. Memory mapping is not available on all file
+   * systems, read the whole file instead in that case. */
+  const char *data = nullptr;
+  BLI_mmap_file *mmap_file = BLI_mmap_open(file);
+  void *buffer = nullptr;
+  if (mmap_file) {
+    data = static_cast<const char *>(BLI_mmap_get_pointer(mmap_file));
+  }
+  else {
+    size_t buffer_len;
+    buffer = BLI_file_read_binary_as_mem(filepath, 0, &buffer_len);
+    if (buffer == nullptr || int64_t(buffer_len) != file_size) {
+      BKE_reportf(
+          reports, RPT_ERROR, "STL Importer: cannot read from binary STL file: '%s'", filepath);
+      MEM_SAFE_FREE(buffer);
+      return nullptr;
+    }
+    data = static_cast<const char *>(buffer);
+  }
+  BLI_SCOPED_DEFER([&]() {
+    if (mmap_file) {
+      BLI_mmap_free(mmap_file);
+    }
+    MEM_SAFE_FREE(buffer);
+  });
+
+  uint32_t num_tris = 0;
+  memcpy(&num_tris, data + BINARY_HEADER_SIZE, sizeof(uint32_t));
   if (num_tris == 0) {
     return BKE_mesh_add(bmain, mesh_name);
   }
+  /* The file type is detected from its size, but don't trust the header if called otherwise.
+   * Sizes are computed in 64 bits, the triangle count of the header can be anything. */
+  const int64_t tris_size = int64_t(num_tris) * int64_t(BINARY_STRIDE);
+  const int64_t available_size = file_size - int64_t(BINARY_HEADER_SIZE + sizeof(uint32_t));
+  if (tris_size > available_size) {
+    BKE_reportf(reports, RPT_WARNING, "STL Importer: binary STL file is truncated: '%s'", filepath);
+    num_tris = uint32_t(available_size / int64_t(BINARY_STRIDE));
+  }
+  /* Mesh corners are counted with an int. */
+  if (int64_t(num_tris) * 3 > INT_MAX) {
+    BKE_reportf(reports,
+                RPT_ERROR,
+                "STL Importer: too many triangles (%u) in binary STL file: '%s'",
+                num_tris,
+                filepath);
+    return nullptr;
+  }
 
-  Array<STLBinaryTriangle> tris_buf(chunk_size);
+  const char *tris_data = data + BINARY_HEADER_SIZE + sizeof(uint32_t);
   STLMeshHelper stl_mesh(num_tris, use_custom_normals);
-  size_t num_read_tris;
-  while ((num_read_tris = fread(tris_buf.data(), sizeof(STLBinaryTriangle), chunk_size, file))) {
-    for (size_t i = 0; i < num_read_tris; i++) {
+  MutableSpan<float3> corner_positions = stl_mesh.corner_positions();
+  MutableSpan<float3> facet_normals = stl_mesh.facet_normals();
+  threading::parallel_for(IndexRange(num_tris), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      STLBinaryTriangle tri;
+      memcpy(&tri, tris_data + int64_t(i) * BINARY_STRIDE, sizeof(STLBinaryTriangle));
+      corner_positions[3 * i] = tri.v1;
+      corner_positions[3 * i + 1] = tri.v2;
+      corner_positions[3 * i + 2] = tri.v3;
       if (use_custom_normals) {
-        stl_mesh.add_triangle(tris_buf[i].v1, tris_buf[i].v2, tris_buf[i].v3, tris_buf[i].normal);
-      }
-      else {
-        stl_mesh.add_triangle(tris_buf[i].v1, tris_buf[i].v2, tris_buf[i].v3);
+        facet_normals[i] = tri.normal;
       }
     }
-  }
+  });
 
-  return stl_mesh.to_mesh(bmain, mesh_name);
+  return stl_mesh.to_mesh(bmain, mesh_name, reports);
 }
 
 }  // namespace blender::io::stl
@@ -10,6 +10,8 @@
 
 #include "BKE_mesh.h"
 
+struct ReportList;
+
 /*  Binary STL spec.:
  *   UINT8[80]    – Header                  - 80 bytes
  *   UINT32       – Number of triangles     - 4 bytes
@@ -26,6 +28,10 @@ namespace blender::io::stl {
 const size_t BINARY_HEADER_SIZE = 80;
 const size_t BINARY_STRIDE = 12 * 4 + 2;
 
-Mesh *read_stl_binary(FILE *file, Main *bmain, char *mesh_name, bool use_custom_normals);
+Mesh *read_stl_binary(const char *filepath,
+                     Main *bmain,
+                     char *mesh_name,
+                     bool use_custom_normals,
+                     ReportList *reports);
 
 }  // namespace blender::io::stl
@@ -8,8 +8,10 @@
 #include "BKE_lib_id.h"
 #include "BKE_main.h"
 #include "BKE_mesh.h"
+#include "BKE_report.h"
 
 #include "BLI_array.hh"
+#include "BLI_map.hh"
 #include "BLI_math_vector.h"
 #include "BLI_math_vector.hh"
 #include "BLI_task.hh"
@@ -22,89 +24,259 @@
 namespace blender::io::stl {
 
 STLMeshHelper::STLMeshHelper(int tris_num, bool use_custom_normals)
-    : use_custom_normals_(use_custom_normals)
+    : corner_positions_(int64_t(tris_num) * 3, NoInitialization()),
+      facet_normals_(use_custom_normals ? tris_num : 0, NoInitialization()),
+      use_custom_normals_(use_custom_normals)
 {
-  degenerate_tris_num_ = 0;
-  duplicate_tris_num_ = 0;
-  tris_.reserve(tris_num);
-  /* Upper bound (all vertices are unique). */
-  verts_.reserve(tris_num * 3);
-  if (use_custom_normals) {
-    loop_normals_.reserve(tris_num * 3);
-  }
 }
 
-bool STLMeshHelper::add_triangle(const float3 &a, const float3 &b, const float3 &c)
+/* Number of elements per task when scattering elements into shards. */
+static constexpr int SHARD_BLOCK_SIZE = 64 * 1024;
+/* Number of shards, at most 255 so that the shard of an element fits in a byte. */
+static constexpr int SHARDS_NUM = 128;
+static constexpr uint8_t SKIPPED_SHARD = 0xFF;
+
+static int shard_of_hash(const uint64_t hash)
 {
-  int v1_id = verts_.index_of_or_add(a);
-  int v2_id = verts_.index_of_or_add(b);
-  int v3_id = verts_.index_of_or_add(c);
-  if ((v1_id == v2_id) || (v1_id == v3_id) || (v2_id == v3_id)) {
-    degenerate_tris_num_++;
-    return false;
-  }
-  if (!tris_.add({v1_id, v2_id, v3_id})) {
-    duplicate_tris_num_++;
-    return false;
+  /* Use the high bits of a multiplicative mix: the low bits of the hash select the slots of the
+   * per-shard maps, they must not be the same for all keys of a shard. */
+  return int((hash * 0x9E3779B97F4A7C15ull) >> 57) % SHARDS_NUM;
+}
+
+/**
+ * For each element, find the index of the first element that has an equal key.
+ * \param get_key: Returns a pointer to the key of an element, or null to skip it, in which case
+ * its first occurrence is -1.
+ *
+ * Elements are distributed in shards by hash, and shards are deduplicated in parallel. Within a
+ * shard elements are kept in their original order, so the result is the same as a serial merge.
+ */
+template<typename Key, typename GetKeyFn>
+static void find_first_occurrences(const int size,
+                                   const GetKeyFn &get_key,
+                                   MutableSpan<int> r_first)
+{
+  const int blocks_num = (size + SHARD_BLOCK_SIZE - 1) / SHARD_BLOCK_SIZE;
+  Array<uint8_t> element_shards(size, NoInitialization());
+  Array<int> block_shard_offsets(blocks_num * SHARDS_NUM, 0);
+
+  threading::parallel_for(IndexRange(blocks_num), 1, [&](IndexRange blocks) {
+    for (const int block : blocks) {
+      MutableSpan<int> counts = block_shard_offsets.as_mutable_span().slice(block * SHARDS_NUM,
+                                                                             SHARDS_NUM);
+      const IndexRange elements = IndexRange(block * SHARD_BLOCK_SIZE,
+                                             std::min(SHARD_BLOCK_SIZE,
+                                                      size - block * SHARD_BLOCK_SIZE));
+      for (const int i : elements) {
+        const Key *key = get_key(i);
+        if (key == nullptr) {
+          element_shards[i] = SKIPPED_SHARD;
+          r_first[i] = -1;
+          continue;
+        }
+        const int shard = shard_of_hash(DefaultHash<Key>{}(*key));
+        element_shards[i] = uint8_t(shard);
+        counts[shard]++;
+      }
+    }
+  });
+
+  /* Shard-major layout, blocks of a shard being stored one after the other. */
+  Array<int> shard_offsets(SHARDS_NUM + 1);
+  int offset = 0;
+  for (const int shard : IndexRange(SHARDS_NUM)) {
+    shard_offsets[shard] = offset;
+    for (const int block : IndexRange(blocks_num)) {
+      const int count = block_shard_offsets[block * SHARDS_NUM + shard];
+      block_shard_offsets[block * SHARDS_NUM + shard] = offset;
+      offset += count;
+    }
   }
-  return true;
+  shard_offsets[SHARDS_NUM] = offset;
+
+  Array<int> sorted_elements(offset, NoInitialization());
+  threading::parallel_for(IndexRange(blocks_num), 1, [&](IndexRange blocks) {
+    for (const int block : blocks) {
+      MutableSpan<int> offsets = block_shard_offsets.as_mutable_span().slice(block * SHARDS_NUM,
+                                                                              SHARDS_NUM);
+      const IndexRange elements = IndexRange(block * SHARD_BLOCK_SIZE,
+                                             std::min(SHARD_BLOCK_SIZE,
+                                                      size - block * SHARD_BLOCK_SIZE));
+      for (const int i : elements) {
+        if (element_shards[i] != SKIPPED_SHARD) {
+          sorted_elements[offsets[element_shards[i]]++] = i;
+        }
+      }
+    }
+  });
+
+  threading::parallel_for(IndexRange(SHARDS_NUM), 1, [&](IndexRange shards) {
+    for (const int shard : shards) {
+      const Span<int> elements = sorted_elements.as_span().slice(
+          shard_offsets[shard], shard_offsets[shard + 1] - shard_offsets[shard]);
+      Map<Key, int> first_occurrences;
+      first_occurrences.reserve(elements.size());
+      for (const int i : elements) {
+        r_first[i] = first_occurrences.lookup_or_add(*get_key(i), i);
+      }
+    }
+  });
 }
 
-void STLMeshHelper::add_triangle(const float3 &a,
-                                 const float3 &b,
-                                 const float3 &c,
-                                 const float3 &custom_normal)
+/**
+ * Number the elements that are their own first occurrence in order, and give all others the
+ * number of their first occurrence (skipped elements get -1). Returns the number of distinct
+ * elements.
+ */
+static int number_first_occurrences(Span<int> first_occurrences, MutableSpan<int> r_numbers)
 {
-  if (add_triangle(a, b, c)) {
-    loop_normals_.append_n_times(custom_normal, 3);
+  const int size = first_occurrences.size();
+  const int blocks_num = (size + SHARD_BLOCK_SIZE - 1) / SHARD_BLOCK_SIZE;
+  Array<int> block_offsets(blocks_num + 1, 0);
+
+  threading::parallel_for(IndexRange(blocks_num), 1, [&](IndexRange blocks) {
+    for (const int block : blocks) {
+      const IndexRange elements = IndexRange(block * SHARD_BLOCK_SIZE,
+                                             std::min(SHARD_BLOCK_SIZE,
+                                                      size - block * SHARD_BLOCK_SIZE));
+      int count = 0;
+      for (const int i : elements) {
+        count += first_occurrences[i] == i;
+      }
+      block_offsets[block + 1] = count;
+    }
+  });
+  for (const int block : IndexRange(blocks_num)) {
+    block_offsets[block + 1] += block_offsets[block];
   }
+
+  threading::parallel_for(IndexRange(blocks_num), 1, [&](IndexRange blocks) {
+    for (const int block : blocks) {
+      const IndexRange elements = IndexRange(block * SHARD_BLOCK_SIZE,
+                                             std::min(SHARD_BLOCK_SIZE,
+                                                      size - block * SHARD_BLOCK_SIZE));
+      int number = block_offsets[block];
+      for (const int i : elements) {
+        if (first_occurrences[i] == i) {
+          r_numbers[i] = number++;
+        }
+      }
+    }
+  });
+
+  /* All first occurrences are numbered now, the other elements can look theirs up. */
+  threading::parallel_for(first_occurrences.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      const int first = first_occurrences[i];
+      if (first == -1) {
+        r_numbers[i] = -1;
+      }
+      else if (first != i) {
+        r_numbers[i] = r_numbers[first];
+      }
+    }
+  });
+  return block_offsets[blocks_num];
 }
 
-Mesh *STLMeshHelper::to_mesh(Main *bmain, char *mesh_name)
+Mesh *STLMeshHelper::to_mesh(Main *bmain, char *mesh_name, ReportList *reports)
 {
-  if (degenerate_tris_num_ > 0) {
-    std::cout << "STL Importer: " << degenerate_tris_num_ << " degenerate triangles were removed"
-              << std::endl;
+  const int tris_num = corner_positions_.size() / 3;
+
+  /* Weld vertices. Vertices of degenerate triangles are kept, like a serial merge would. */
+  Array<int> first_corners(corner_positions_.size(), NoInitialization());
+  find_first_occurrences<float3>(
+      corner_positions_.size(),
+      [&](const int corner) { return &corner_positions_[corner]; },
+      first_corners);
+  Array<int> corner_verts(corner_positions_.size(), NoInitialization());
+  const int verts_num = number_first_occurrences(first_corners, corner_verts);
+
+  /* Remove degenerate and duplicate triangles. */
+  Array<Triangle> tris(tris_num, NoInitialization());
+  threading::parallel_for(tris.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      tris[i] = {corner_verts[3 * i], corner_verts[3 * i + 1], corner_verts[3 * i + 2]};
+    }
+  });
+  Array<int> first_tris(tris_num, NoInitialization());
+  find_first_occurrences<Triangle>(
+      tris_num,
+      [&](const int i) -> const Triangle * {
+        const Triangle &tri = tris[i];
+        if ((tri.v1 == tri.v2) || (tri.v1 == tri.v3) || (tri.v2 == tri.v3)) {
+          return nullptr;
+        }
+        return &tri;
+      },
+      first_tris);
+  Array<int> tri_indices(tris_num, NoInitialization());
+  const int kept_tris_num = number_first_occurrences(first_tris, tri_indices);
+  int degenerate_tris_num = 0;
+  for (const int i : first_tris.index_range()) {
+    degenerate_tris_num += first_tris[i] == -1;
   }
-  if (duplicate_tris_num_ > 0) {
-    std::cout << "STL Importer: " << duplicate_tris_num_ << " duplicate triangles were removed"
-              << std::endl;
+  const int duplicate_tris_num = tris_num - kept_tris_num - degenerate_tris_num;
+
+  if (degenerate_tris_num > 0) {
+    BKE_reportf(reports,
+                RPT_INFO,
+                "STL Importer: %d degenerate triangles were removed",
+                degenerate_tris_num);
+  }
+  if (duplicate_tris_num > 0) {
+    BKE_reportf(
+        reports, RPT_INFO, "STL Importer: %d duplicate triangles were removed", duplicate_tris_num);
   }
 
   Mesh *mesh = BKE_mesh_add(bmain, mesh_name);
   /* User count is already 1 here, but will be set later in #BKE_mesh_assign_object. */
   id_us_min(&mesh->id);
 
-  mesh->totvert = verts_.size();
+  mesh->totvert = verts_num;
   mesh->mvert = static_cast<MVert *>(
       CustomData_add_layer(&mesh->vdata, CD_MVERT, CD_CALLOC, nullptr, mesh->totvert));
-  for (int i = 0; i < mesh->totvert; i++) {
-    copy_v3_v3(mesh->mvert[i].co, verts_[i]);
-  }
-
-  mesh->totpoly = tris_.size();
-  mesh->totloop = tris_.size() * 3;
+  mesh->totpoly = kept_tris_num;
+  mesh->totloop = kept_tris_num * 3;
   mesh->mpoly = static_cast<MPoly *>(
       CustomData_add_layer(&mesh->pdata, CD_MPOLY, CD_CALLOC, nullptr, mesh->totpoly));
   mesh->mloop = static_cast<MLoop *>(
       CustomData_add_layer(&mesh->ldata, CD_MLOOP, CD_CALLOC, nullptr, mesh->totloop));
 
-  threading::parallel_for(tris_.index_range(), 2048, [&](IndexRange tris_range) {
+  Array<float3> loop_normals(use_custom_normals_ ? mesh->totloop : 0);
+
+  /* Only the first occurrence of each vertex and triangle writes to the mesh, so there are no
+   * concurrent writes. */
+  threading::parallel_for(IndexRange(tris_num), 2048, [&](IndexRange tris_range) {
     for (const int i : tris_range) {
-      mesh->mpoly[i].loopstart = 3 * i;
-      mesh->mpoly[i].totloop = 3;
+      for (const int corner : IndexRange(3 * i, 3)) {
+        if (first_corners[corner] == corner) {
+          copy_v3_v3(mesh->mvert[corner_verts[corner]].co, corner_positions_[corner]);
+        }
+      }
+
+      if (first_tris[i] != i) {
+        continue;
+      }
+      const int tri_index = tri_indices[i];
+      mesh->mpoly[tri_index].loopstart = 3 * tri_index;
+      mesh->mpoly[tri_index].totloop = 3;
+
+      mesh->mloop[3 * tri_index].v = tris[i].v1;
+      mesh->mloop[3 * tri_index + 1].v = tris[i].v2;
+      mesh->mloop[3 * tri_index + 2].v = tris[i].v3;
 
-      mesh->mloop[3 * i].v = tris_[i].v1;
-      mesh->mloop[3 * i + 1].v = tris_[i].v2;
-      mesh->mloop[3 * i + 2].v = tris_[i].v3;
+      if (use_custom_normals_) {
+        loop_normals.as_mutable_span().slice(3 * tri_index, 3).fill(facet_normals_[i]);
+      }
     }
   });
 
   /* NOTE: edges must be calculated first before setting custom normals. */
   BKE_mesh_calc_edges(mesh, false, false);
 
-  if (use_custom_normals_ && loop_normals_.size() == mesh->totloop) {
-    BKE_mesh_set_custom_normals(mesh, reinterpret_cast<float(*)[3]>(loop_normals_.data()));
+  if (use_custom_normals_) {
+    BKE_mesh_set_custom_normals(mesh, reinterpret_cast<float(*)[3]>(loop_normals.data()));
     mesh->flag |= ME_AUTOSMOOTH;
   }
 
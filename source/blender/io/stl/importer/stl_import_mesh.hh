@@ -8,13 +8,14 @@
 
 #include <cstdint>
 
+#include "BLI_array.hh"
 #include "BLI_math_vec_types.hh"
-#include "BLI_set.hh"
-#include "BLI_vector.hh"
-#include "BLI_vector_set.hh"
+#include "BLI_span.hh"
 
 #include "DNA_mesh_types.h"
 
+struct ReportList;
+
 namespace blender::io::stl {
 class Triangle {
  public:
@@ -45,27 +46,38 @@ class Triangle {
   }
 };
 
+/**
+ * Gathers the triangle soup of an STL file and turns it into a mesh.
+ *
+ * Readers fill the corner positions (and facet normals) of all triangles up front, possibly from
+ * several threads. Duplicate vertices and triangles are then merged in #to_mesh, by splitting the
+ * corners into shards of their hash and deduplicating each shard in parallel. Vertices and
+ * triangles are numbered in order of first appearance in the file, like a serial merge would.
+ */
 class STLMeshHelper {
  private:
-  VectorSet<float3> verts_;
-  VectorSet<Triangle> tris_;
-  Vector<float3> loop_normals_;
-  int degenerate_tris_num_;
-  int duplicate_tris_num_;
+  /* Three corners per triangle. */
+  Array<float3> corner_positions_;
+  /* One normal per triangle, only when custom normals are used. */
+  Array<float3> facet_normals_;
   const bool use_custom_normals_;
 
  public:
   STLMeshHelper(int tris_num, bool use_custom_normals);
 
-  /* Creates a new triangle from specified vertex locations,
+  MutableSpan<float3> corner_positions()
+  {
+    return corner_positions_;
+  }
+  MutableSpan<float3> facet_normals()
+  {
+    return facet_normals_;
+  }
+
+  /* Creates a mesh from the triangles,
    * duplicate vertices and triangles are merged.
    */
-  bool add_triangle(const float3 &a, const float3 &b, const float3 &c);
-  void add_triangle(const float3 &a,
-                    const float3 &b,
-                    const float3 &c,
-                    const float3 &custom_normal);
-  Mesh *to_mesh(Main *bmain, char *mesh_name);
+  Mesh *to_mesh(Main *bmain, char *mesh_name, ReportList *reports);
 };
 
 }  // namespace blender::io::stl
@@ -19,7 +19,7 @@ struct USDExporterContext {
   Depsgraph *depsgraph;
   const pxr::UsdStageRefPtr stage;
   const pxr::SdfPath usd_path;
-  const USDHierarchyIterator *hierarchy_iterator;
+  USDHierarchyIterator *hierarchy_iterator;
   const USDExportParams &export_params;
 };
 
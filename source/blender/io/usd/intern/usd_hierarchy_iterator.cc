@@ -19,6 +19,7 @@
 #include "BKE_duplilist.h"
 
 #include "BLI_assert.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "DEG_depsgraph_query.h"
@@ -55,6 +56,37 @@ std::string USDHierarchyIterator::make_valid_name(const std::string &name) const
   return pxr::TfMakeValidIdentifier(name);
 }
 
+void USDHierarchyIterator::iterate_and_write()
+{
+  AbstractHierarchyIterator::iterate_and_write();
+
+  /* Converting the meshes only reads Blender data, so it can run in parallel. The USD stage is
+   * not safe to write from multiple threads, so the results are authored one after the other. */
+  threading::parallel_for(
+      IndexRange(pending_mesh_writers_.size()), 1, [&](const IndexRange range) {
+        for (const int64_t i : range) {
+          pending_mesh_writers_[i]->compute_pending_write();
+        }
+      });
+
+  try {
+    for (USDGenericMeshWriter *writer : pending_mesh_writers_) {
+      writer->finish_pending_write();
+    }
+  }
+  catch (...) {
+    /* Writers that were not finished free their mesh when they are released. */
+    pending_mesh_writers_.clear();
+    throw;
+  }
+  pending_mesh_writers_.clear();
+}
+
+void USDHierarchyIterator::queue_mesh_write(USDGenericMeshWriter *writer)
+{
+  pending_mesh_writers_.push_back(writer);
+}
+
 void USDHierarchyIterator::set_export_frame(float frame_nr)
 {
   /* The USD stage is already set up to have FPS time-codes per frame. */
@@ -7,6 +7,7 @@
 #include "usd_exporter_context.h"
 
 #include <string>
+#include <vector>
 
 #include <pxr/usd/usd/common.h>
 #include <pxr/usd/usd/timeCode.h>
@@ -21,24 +22,35 @@ using blender::io::AbstractHierarchyIterator;
 using blender::io::AbstractHierarchyWriter;
 using blender::io::HierarchyContext;
 
+class USDGenericMeshWriter;
+
 class USDHierarchyIterator : public AbstractHierarchyIterator {
  private:
   const pxr::UsdStageRefPtr stage_;
   pxr::UsdTimeCode export_time_;
   const USDExportParams &params_;
 
+  /* Mesh writers that have been called for the current frame, see #USDGenericMeshWriter. */
+  std::vector<USDGenericMeshWriter *> pending_mesh_writers_;
+
  public:
   USDHierarchyIterator(Main *bmain,
                        Depsgraph *depsgraph,
                        pxr::UsdStageRefPtr stage,
                        const USDExportParams &params);
 
+  virtual void iterate_and_write() override;
+
   void set_export_frame(float frame_nr);
   std::string get_export_file_path() const;
   const pxr::UsdTimeCode &get_export_time_code() const;
 
   virtual std::string make_valid_name(const std::string &name) const override;
 
+  /* Postpone the write of a mesh to the end of the iteration, so that the meshes of a frame can
+   * be converted in parallel. */
+  void queue_mesh_write(USDGenericMeshWriter *writer);
+
  protected:
   virtual bool mark_as_weak_export(const Object *object) const override;
 
@@ -31,52 +31,13 @@
 
 namespace blender::io::usd {
 
-USDGenericMeshWriter::USDGenericMeshWriter(const USDExporterContext &ctx) : USDAbstractWriter(ctx)
-{
-}
-
-bool USDGenericMeshWriter::is_supported(const HierarchyContext *context) const
-{
-  if (usd_export_context_.export_params.visible_objects_only) {
-    return context->is_object_visible(usd_export_context_.export_params.evaluation_mode);
-  }
-  return true;
-}
-
-void USDGenericMeshWriter::do_write(HierarchyContext &context)
-{
-  Object *object_eval = context.object;
-  bool needsfree = false;
-  Mesh *mesh = get_export_mesh(object_eval, needsfree);
-
-  if (mesh == nullptr) {
-    return;
-  }
-
-  try {
-    write_mesh(context, mesh);
-
-    if (needsfree) {
-      free_export_mesh(mesh);
-    }
-  }
-  catch (...) {
-    if (needsfree) {
-      free_export_mesh(mesh);
-    }
-    throw;
-  }
-}
-
-void USDGenericMeshWriter::free_export_mesh(Mesh *mesh)
-{
-  BKE_id_free(nullptr, mesh);
-}
-
 struct USDMeshData {
   pxr::VtArray<pxr::GfVec3f> points;
+  /* Left empty when the topology is the same as the one already written. */
+  bool topology_is_written = false;
   pxr::VtIntArray face_vertex_counts;
   pxr::VtIntArray face_indices;
+  /* Only computed when materials are assigned. */
   std::map<short, pxr::VtIntArray> face_groups;
 
   /* The length of this array specifies the number of creases on the surface. Each element gives
@@ -100,8 +61,52 @@ struct USDMeshData {
   pxr::VtIntArray corner_indices;
   /* The per-vertex sharpnesses. The lengths of this array must match that of `corner_indices`. */
   pxr::VtFloatArray corner_sharpnesses;
+
+  /* Only computed when normals are exported. */
+  pxr::VtVec3fArray loop_normals;
 };
 
+USDGenericMeshWriter::USDGenericMeshWriter(const USDExporterContext &ctx) : USDAbstractWriter(ctx)
+{
+}
+
+USDGenericMeshWriter::~USDGenericMeshWriter()
+{
+  /* Only happens when writing another mesh of the same frame failed. */
+  if (pending_write_ && pending_write_->needsfree) {
+    USDGenericMeshWriter::free_export_mesh(pending_write_->mesh);
+  }
+}
+
+bool USDGenericMeshWriter::is_supported(const HierarchyContext *context) const
+{
+  if (usd_export_context_.export_params.visible_objects_only) {
+    return context->is_object_visible(usd_export_context_.export_params.evaluation_mode);
+  }
+  return true;
+}
+
+void USDGenericMeshWriter::do_write(HierarchyContext &context)
+{
+  Object *object_eval = context.object;
+  bool needsfree = false;
+  Mesh *mesh = get_export_mesh(object_eval, needsfree);
+
+  if (mesh == nullptr) {
+    return;
+  }
+
+  BLI_assert(!pending_write_);
+  pending_write_ = std::make_unique<PendingWrite>(
+      PendingWrite{context, mesh, needsfree, !frame_has_been_written_, nullptr});
+  usd_export_context_.hierarchy_iterator->queue_mesh_write(this);
+}
+
+void USDGenericMeshWriter::free_export_mesh(Mesh *mesh)
+{
+  BKE_id_free(nullptr, mesh);
+}
+
 void USDGenericMeshWriter::write_uv_maps(const Mesh *mesh, pxr::UsdGeomMesh usd_mesh)
 {
   pxr::UsdTimeCode timecode = get_export_time_code();
@@ -135,7 +140,10 @@ void USDGenericMeshWriter::write_uv_maps(const Mesh *mesh, pxr::UsdGeomMesh usd_
   }
 }
 
-void USDGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
+void USDGenericMeshWriter::write_mesh(HierarchyContext &context,
+                                      Mesh *mesh,
+                                      const USDMeshData &usd_mesh_data,
+                                      const bool is_first_frame)
 {
   pxr::UsdTimeCode timecode = get_export_time_code();
   pxr::UsdTimeCode defaultTime = pxr::UsdTimeCode::Default();
@@ -145,9 +153,6 @@ void USDGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
   pxr::UsdGeomMesh usd_mesh = pxr::UsdGeomMesh::Define(stage, usd_path);
   write_visibility(context, timecode, usd_mesh);
 
-  USDMeshData usd_mesh_data;
-  get_geometry_data(mesh, usd_mesh_data);
-
   if (usd_export_context_.export_params.use_instancing && context.is_instance()) {
     if (!mark_as_instance(context, usd_mesh.GetPrim())) {
       return;
@@ -170,6 +175,9 @@ void USDGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
   pxr::UsdAttribute attr_face_vertex_indices = usd_mesh.CreateFaceVertexIndicesAttr(pxr::VtValue(),
                                                                                     true);
 
+  /* Whether an earlier frame already authored the topology. */
+  const bool has_topology = attr_face_vertex_counts.HasValue();
+
   if (!attr_points.HasValue()) {
     /* Provide the initial value as default. This makes USD write the value as constant if they
      * don't change over time. */
@@ -179,10 +187,23 @@ void USDGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
   }
 
   usd_value_writer_.SetAttribute(attr_points, pxr::VtValue(usd_mesh_data.points), timecode);
-  usd_value_writer_.SetAttribute(
-      attr_face_vertex_counts, pxr::VtValue(usd_mesh_data.face_vertex_counts), timecode);
-  usd_value_writer_.SetAttribute(
-      attr_face_vertex_indices, pxr::VtValue(usd_mesh_data.face_indices), timecode);
+
+  /* Constant topology is only authored as the default value. When it changes, the earlier
+   * topology gets a time sample at the last frame it was used for, then every change is a time
+   * sample of its own. Integer arrays are held between samples, not interpolated. */
+  if (!usd_mesh_data.topology_is_written) {
+    if (has_topology) {
+      if (attr_face_vertex_counts.GetNumTimeSamples() == 0) {
+        attr_face_vertex_counts.Set(written_face_vertex_counts_, written_topology_time_);
+        attr_face_vertex_indices.Set(written_face_indices_, written_topology_time_);
+      }
+      attr_face_vertex_counts.Set(usd_mesh_data.face_vertex_counts, timecode);
+      attr_face_vertex_indices.Set(usd_mesh_data.face_indices, timecode);
+    }
+    written_face_vertex_counts_ = usd_mesh_data.face_vertex_counts;
+    written_face_indices_ = usd_mesh_data.face_indices;
+  }
+  written_topology_time_ = timecode;
 
   if (!usd_mesh_data.crease_lengths.empty()) {
     pxr::UsdAttribute attr_crease_lengths = usd_mesh.CreateCreaseLengthsAttr(pxr::VtValue(), true);
@@ -225,12 +246,12 @@ void USDGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
     write_uv_maps(mesh, usd_mesh);
   }
   if (usd_export_context_.export_params.export_normals) {
-    write_normals(mesh, usd_mesh);
+    write_normals(usd_mesh_data, usd_mesh);
   }
   write_surface_velocity(mesh, usd_mesh);
 
   /* TODO(Sybren): figure out what happens when the face groups change. */
-  if (frame_has_been_written_) {
+  if (!is_first_frame) {
     return;
   }
 
@@ -253,10 +274,6 @@ static void get_vertices(const Mesh *mesh, USDMeshData &usd_mesh_data)
 
 static void get_loops_polys(const Mesh *mesh, USDMeshData &usd_mesh_data)
 {
-  /* Only construct face groups (a.k.a. geometry subsets) when we need them for material
-   * assignments. */
-  bool construct_face_groups = mesh->totcol > 1;
-
   usd_mesh_data.face_vertex_counts.reserve(mesh->totpoly);
   usd_mesh_data.face_indices.reserve(mesh->totloop);
 
@@ -268,10 +285,20 @@ static void get_loops_polys(const Mesh *mesh, USDMeshData &usd_mesh_data)
     for (int j = 0; j < mpoly->totloop; ++j, ++loop) {
       usd_mesh_data.face_indices.push_back(loop->v);
     }
+  }
+}
 
-    if (construct_face_groups) {
-      usd_mesh_data.face_groups[mpoly->mat_nr].push_back(i);
-    }
+static void get_face_groups(const Mesh *mesh, USDMeshData &usd_mesh_data)
+{
+  /* Only construct face groups (a.k.a. geometry subsets) when we need them for material
+   * assignments. */
+  if (mesh->totcol <= 1) {
+    return;
+  }
+
+  const MPoly *mpoly = mesh->mpoly;
+  for (int i = 0; i < mesh->totpoly; ++i, ++mpoly) {
+    usd_mesh_data.face_groups[mpoly->mat_nr].push_back(i);
   }
 }
 
@@ -318,12 +345,124 @@ static void get_vert_creases(const Mesh *mesh, USDMeshData &usd_mesh_data)
   }
 }
 
-void USDGenericMeshWriter::get_geometry_data(const Mesh *mesh, USDMeshData &usd_mesh_data)
+static void get_loop_normals(const Mesh *mesh, USDMeshData &usd_mesh_data)
+{
+  const float(*lnors)[3] = static_cast<float(*)[3]>(CustomData_get_layer(&mesh->ldata, CD_NORMAL));
+
+  pxr::VtVec3fArray &loop_normals = usd_mesh_data.loop_normals;
+  loop_normals.reserve(mesh->totloop);
+
+  if (lnors != nullptr) {
+    /* Export custom loop normals. */
+    for (int loop_idx = 0, totloop = mesh->totloop; loop_idx < totloop; ++loop_idx) {
+      loop_normals.push_back(pxr::GfVec3f(lnors[loop_idx]));
+    }
+  }
+  else {
+    /* Compute the loop normals based on the 'smooth' flag. */
+    const float(*vert_normals)[3] = BKE_mesh_vertex_normals_ensure(mesh);
+    const float(*face_normals)[3] = BKE_mesh_poly_normals_ensure(mesh);
+    MPoly *mpoly = mesh->mpoly;
+    for (int poly_idx = 0, totpoly = mesh->totpoly; poly_idx < totpoly; ++poly_idx, ++mpoly) {
+      MLoop *mloop = mesh->mloop + mpoly->loopstart;
+
+      if ((mpoly->flag & ME_SMOOTH) == 0) {
+        /* Flat shaded, use common normal for all verts. */
+        pxr::GfVec3f pxr_normal(face_normals[poly_idx]);
+        for (int loop_idx = 0; loop_idx < mpoly->totloop; ++loop_idx) {
+          loop_normals.push_back(pxr_normal);
+        }
+      }
+      else {
+        /* Smooth shaded, use individual vert normals. */
+        for (int loop_idx = 0; loop_idx < mpoly->totloop; ++loop_idx, ++mloop) {
+          loop_normals.push_back(pxr::GfVec3f(vert_normals[mloop->v]));
+        }
+      }
+    }
+  }
+}
+
+bool USDGenericMeshWriter::topology_is_written(const Mesh *mesh) const
+{
+  if (written_face_vertex_counts_.size() != size_t(mesh->totpoly) ||
+      written_face_indices_.size() != size_t(mesh->totloop)) {
+    return false;
+  }
+
+  const int *written_count = written_face_vertex_counts_.cdata();
+  const int *written_index = written_face_indices_.cdata();
+  const MPoly *mpoly = mesh->mpoly;
+  for (int i = 0; i < mesh->totpoly; ++i, ++mpoly) {
+    if (written_count[i] != mpoly->totloop) {
+      return false;
+    }
+    const MLoop *loop = mesh->mloop + mpoly->loopstart;
+    for (int j = 0; j < mpoly->totloop; ++j, ++loop, ++written_index) {
+      if (*written_index != int(loop->v)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void USDGenericMeshWriter::get_geometry_data(const Mesh *mesh,
+                                             const bool is_first_frame,
+                                             USDMeshData &usd_mesh_data)
 {
   get_vertices(mesh, usd_mesh_data);
-  get_loops_polys(mesh, usd_mesh_data);
+
+  /* Deforming meshes keep their topology, comparing is cheaper than building it again. */
+  usd_mesh_data.topology_is_written = !is_first_frame && topology_is_written(mesh);
+  if (!usd_mesh_data.topology_is_written) {
+    get_loops_polys(mesh, usd_mesh_data);
+  }
+
   get_edge_creases(mesh, usd_mesh_data);
   get_vert_creases(mesh, usd_mesh_data);
+
+  if (usd_export_context_.export_params.export_normals) {
+    get_loop_normals(mesh, usd_mesh_data);
+  }
+}
+
+void USDGenericMeshWriter::compute_pending_write()
+{
+  BLI_assert(pending_write_);
+  const Mesh *mesh = pending_write_->mesh;
+  pending_write_->usd_mesh_data = std::make_unique<USDMeshData>();
+  USDMeshData &usd_mesh_data = *pending_write_->usd_mesh_data;
+  get_geometry_data(mesh, pending_write_->is_first_frame, usd_mesh_data);
+
+  /* Materials are only assigned on the first frame, or every frame for instances. */
+  if (pending_write_->is_first_frame || (usd_export_context_.export_params.use_instancing &&
+                                         pending_write_->context.is_instance())) {
+    get_face_groups(mesh, usd_mesh_data);
+  }
+}
+
+void USDGenericMeshWriter::finish_pending_write()
+{
+  std::unique_ptr<PendingWrite> pending_write = std::move(pending_write_);
+  BLI_assert(pending_write && pending_write->usd_mesh_data);
+
+  try {
+    write_mesh(pending_write->context,
+               pending_write->mesh,
+               *pending_write->usd_mesh_data,
+               pending_write->is_first_frame);
+
+    if (pending_write->needsfree) {
+      free_export_mesh(pending_write->mesh);
+    }
+  }
+  catch (...) {
+    if (pending_write->needsfree) {
+      free_export_mesh(pending_write->mesh);
+    }
+    throw;
+  }
 }
 
 void USDGenericMeshWriter::assign_materials(const HierarchyContext &context,
@@ -388,43 +527,11 @@ void USDGenericMeshWriter::assign_materials(const HierarchyContext &context,
   }
 }
 
-void USDGenericMeshWriter::write_normals(const Mesh *mesh, pxr::UsdGeomMesh usd_mesh)
+void USDGenericMeshWriter::write_normals(const USDMeshData &usd_mesh_data,
+                                         pxr::UsdGeomMesh usd_mesh)
 {
   pxr::UsdTimeCode timecode = get_export_time_code();
-  const float(*lnors)[3] = static_cast<float(*)[3]>(CustomData_get_layer(&mesh->ldata, CD_NORMAL));
-
-  pxr::VtVec3fArray loop_normals;
-  loop_normals.reserve(mesh->totloop);
-
-  if (lnors != nullptr) {
-    /* Export custom loop normals. */
-    for (int loop_idx = 0, totloop = mesh->totloop; loop_idx < totloop; ++loop_idx) {
-      loop_normals.push_back(pxr::GfVec3f(lnors[loop_idx]));
-    }
-  }
-  else {
-    /* Compute the loop normals based on the 'smooth' flag. */
-    const float(*vert_normals)[3] = BKE_mesh_vertex_normals_ensure(mesh);
-    const float(*face_normals)[3] = BKE_mesh_poly_normals_ensure(mesh);
-    MPoly *mpoly = mesh->mpoly;
-    for (int poly_idx = 0, totpoly = mesh->totpoly; poly_idx < totpoly; ++poly_idx, ++mpoly) {
-      MLoop *mloop = mesh->mloop + mpoly->loopstart;
-
-      if ((mpoly->flag & ME_SMOOTH) == 0) {
-        /* Flat shaded, use common normal for all verts. */
-        pxr::GfVec3f pxr_normal(face_normals[poly_idx]);
-        for (int loop_idx = 0; loop_idx < mpoly->totloop; ++loop_idx) {
-          loop_normals.push_back(pxr_normal);
-        }
-      }
-      else {
-        /* Smooth shaded, use individual vert normals. */
-        for (int loop_idx = 0; loop_idx < mpoly->totloop; ++loop_idx, ++mloop) {
-          loop_normals.push_back(pxr::GfVec3f(vert_normals[mloop->v]));
-        }
-      }
-    }
-  }
+  const pxr::VtVec3fArray &loop_normals = usd_mesh_data.loop_normals;
 
   pxr::UsdAttribute attr_normals = usd_mesh.CreateNormalsAttr(pxr::VtValue(), true);
   if (!attr_normals.HasValue()) {
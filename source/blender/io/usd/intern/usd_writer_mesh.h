@@ -6,14 +6,24 @@
 
 #include <pxr/usd/usdGeom/mesh.h>
 
+#include <memory>
+
 namespace blender::io::usd {
 
 struct USDMeshData;
 
-/* Writer for USD geometry. Does not assume the object is a mesh object. */
+/* Writer for USD geometry. Does not assume the object is a mesh object.
+ *
+ * Writing is split in two steps: the mesh data is converted by #compute_pending_write(), which
+ * the hierarchy iterator runs in parallel for all meshes of a frame, and is then authored on the
+ * stage by #finish_pending_write(), which is called for one writer at a time. */
 class USDGenericMeshWriter : public USDAbstractWriter {
  public:
   USDGenericMeshWriter(const USDExporterContext &ctx);
+  ~USDGenericMeshWriter() override;
+
+  void compute_pending_write();
+  void finish_pending_write();
 
  protected:
   virtual bool is_supported(const HierarchyContext *context) const override;
@@ -26,13 +36,33 @@ class USDGenericMeshWriter : public USDAbstractWriter {
   /* Mapping from material slot number to array of face indices with that material. */
   typedef std::map<short, pxr::VtIntArray> MaterialFaceGroups;
 
-  void write_mesh(HierarchyContext &context, Mesh *mesh);
-  void get_geometry_data(const Mesh *mesh, struct USDMeshData &usd_mesh_data);
+  /* Write queued on the hierarchy iterator, valid until the end of the current frame. */
+  struct PendingWrite {
+    HierarchyContext context;
+    Mesh *mesh;
+    bool needsfree;
+    bool is_first_frame;
+    std::unique_ptr<USDMeshData> usd_mesh_data;
+  };
+  std::unique_ptr<PendingWrite> pending_write_;
+
+  /* Topology written for a previous frame, and the last frame it was used for. It is only
+   * written again when it changes, see #write_mesh. */
+  pxr::VtIntArray written_face_vertex_counts_;
+  pxr::VtIntArray written_face_indices_;
+  pxr::UsdTimeCode written_topology_time_;
+
+  void write_mesh(HierarchyContext &context,
+                  Mesh *mesh,
+                  const USDMeshData &usd_mesh_data,
+                  bool is_first_frame);
+  void get_geometry_data(const Mesh *mesh, bool is_first_frame, USDMeshData &usd_mesh_data);
+  bool topology_is_written(const Mesh *mesh) const;
   void assign_materials(const HierarchyContext &context,
                         pxr::UsdGeomMesh usd_mesh,
                         const MaterialFaceGroups &usd_face_groups);
   void write_uv_maps(const Mesh *mesh, pxr::UsdGeomMesh usd_mesh);
-  void write_normals(const Mesh *mesh, pxr::UsdGeomMesh usd_mesh);
+  void write_normals(const USDMeshData &usd_mesh_data, pxr::UsdGeomMesh usd_mesh);
   void write_surface_velocity(const Mesh *mesh, pxr::UsdGeomMesh usd_mesh);
 };
 
@@ -4,17 +4,30 @@
  * \ingroup obj
  */
 
+#include "BLI_array.hh"
 #include "BLI_map.hh"
 #include "BLI_math_color.h"
 #include "BLI_math_vector.h"
+#include "BLI_mmap.h"
+#include "BLI_string.h"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 #include "BLI_vector.hh"
 
+#include "MEM_guardedalloc.h"
+
 #include "obj_import_file_reader.hh"
 #include "obj_import_string_utils.hh"
 
 #include <algorithm>
 #include <charconv>
+#include <fcntl.h>
+#include <iostream>
+#ifndef WIN32
+#  include <unistd.h> /* for close */
+#else
+#  include <io.h> /* for close */
+#endif
 
 namespace blender::io::obj {
 
@@ -63,11 +76,122 @@ static Geometry *create_geometry(Geometry *const prev_geometry,
   return new_geometry();
 }
 
-static void geom_add_vertex(const char *p, const char *end, GlobalVertices &r_global_vertices)
+/**
+ * The OBJ file is parsed in two phases. It is first split at line boundaries into chunks that are
+ * parsed in parallel: vertex data gets written straight to its place in the global arrays, which
+ * is known from the prefix sums of a quick counting pass over the chunks, and the indices of faces
+ * and edges are resolved. Then the chunks are replayed in order on the calling thread to assign
+ * faces to objects, groups and materials, since this state depends on all the lines before.
+ */
+
+/** Lines of a chunk that depend on the parser state, replayed in order. */
+enum class eChunkCommand {
+  /* A run of consecutive faces or edges. */
+  Faces,
+  Edges,
+  Object,
+  Group,
+  SmoothGroup,
+  UseMaterial,
+  MaterialLibrary,
+  CurveType,
+  CurveDegree,
+  CurveIndices,
+  CurveParameters,
+};
+
+struct ChunkCommand {
+  eChunkCommand type;
+  /* Rest of the line after the keyword. */
+  StringRef line;
+  /* Number of elements, for runs of faces or edges. */
+  int count = 0;
+  /* Number of vertices defined before the line, for curve indices. */
+  int vertex_count = 0;
+};
+
+struct ChunkFace {
+  int start_index = 0;
+  int corner_count = 0;
+  bool valid = true;
+};
+
+struct ObjChunk {
+  StringRef text;
+  /* Copy of the text with line continuations turned into spaces, only if it had any. */
+  Array<char, 0> fixed_text;
+
+  /* Number of elements in the chunk, and in all chunks before it. */
+  int vertex_count = 0, uv_count = 0, normal_count = 0;
+  int vertex_start = 0, uv_start = 0, normal_start = 0;
+
+  /* Vertex colors, indexed with global vertex indices. The first block may actually continue the
+   * last one of the previous chunk, see #append_vertex_colors. */
+  Vector<GlobalVertices::VertexColorsBlock> color_blocks;
+  int first_color_block_start = -1;
+
+  /* Invalid faces are kept so that the vertices they use are still tracked. In their corners, a
+   * negative vertex index marks an invalid vertex. */
+  Vector<PolyCorner> face_corners;
+  Vector<ChunkFace> faces;
+  Vector<MEdge> edges;
+  Vector<ChunkCommand> commands;
+
+  /* Chunks are parsed on several threads, so their warnings are only printed once they are
+   * replayed, to keep them in the order of the file. */
+  Vector<std::string> warnings;
+};
+
+static void chunk_add_command(ObjChunk &chunk,
+                              const eChunkCommand type,
+                              const StringRef line,
+                              const int vertex_count = 0)
+{
+  ChunkCommand command;
+  command.type = type;
+  command.line = line;
+  command.vertex_count = vertex_count;
+  chunk.commands.append(command);
+}
+
+static void chunk_add_to_run(ObjChunk &chunk, const eChunkCommand type)
+{
+  if (!chunk.commands.is_empty() && chunk.commands.last().type == type) {
+    chunk.commands.last().count++;
+    return;
+  }
+  ChunkCommand command;
+  command.type = type;
+  command.count = 1;
+  chunk.commands.append(command);
+}
+
+static void chunk_add_vertex_color(ObjChunk &chunk, const int vertex_index, const float3 &color)
+{
+  auto &blocks = chunk.color_blocks;
+  /* If we don't have vertex colors yet, or the previous vertex
+   * was without color, we need to start a new vertex colors block. */
+  if (blocks.is_empty() || (blocks.last().start_vertex_index + blocks.last().colors.size() !=
+                            vertex_index)) {
+    if (blocks.is_empty()) {
+      chunk.first_color_block_start = vertex_index;
+    }
+    GlobalVertices::VertexColorsBlock block;
+    block.start_vertex_index = vertex_index;
+    blocks.append(block);
+  }
+  blocks.last().colors.append(color);
+}
+
+static void parse_vertex(const char *p,
+                         const char *end,
+                         const int vertex_index,
+                         MutableSpan<float3> r_vertices,
+                         ObjChunk &r_chunk)
 {
   float3 vert;
   p = parse_floats(p, end, 0.0f, vert, 3);
-  r_global_vertices.vertices.append(vert);
+  r_vertices[vertex_index] = vert;
   /* OBJ extension: `xyzrgb` vertex colors, when the vertex position
    * is followed by 3 more RGB color components. See
    * http://paulbourke.net/dataformats/obj/colour.html */
@@ -77,22 +201,15 @@ static void geom_add_vertex(const char *p, const char *end, GlobalVertices &r_gl
     if (srgb.x >= 0 && srgb.y >= 0 && srgb.z >= 0) {
       float3 linear;
       srgb_to_linearrgb_v3_v3(linear, srgb);
-
-      auto &blocks = r_global_vertices.vertex_colors;
-      /* If we don't have vertex colors yet, or the previous vertex
-       * was without color, we need to start a new vertex colors block. */
-      if (blocks.is_empty() || (blocks.last().start_vertex_index + blocks.last().colors.size() !=
-                                r_global_vertices.vertices.size() - 1)) {
-        GlobalVertices::VertexColorsBlock block;
-        block.start_vertex_index = r_global_vertices.vertices.size() - 1;
-        blocks.append(block);
-      }
-      blocks.last().colors.append(linear);
+      chunk_add_vertex_color(r_chunk, vertex_index, linear);
     }
   }
 }
 
-static void geom_add_mrgb_colors(const char *p, const char *end, GlobalVertices &r_global_vertices)
+static void parse_mrgb_colors(const char *p,
+                              const char *end,
+                              const int vertex_count,
+                              ObjChunk &r_chunk)
 {
   /* MRGB color extension, in the form of
    * "#MRGB MMRRGGBBMMRRGGBB ..."
@@ -113,79 +230,89 @@ static void geom_add_mrgb_colors(const char *p, const char *end, GlobalVertices
     float linear[4];
     srgb_to_linearrgb_uchar4(linear, srgb);
 
-    auto &blocks = r_global_vertices.vertex_colors;
-    /* If we don't have vertex colors yet, or the previous vertex
-     * was without color, we need to start a new vertex colors block. */
-    if (blocks.is_empty() || (blocks.last().start_vertex_index + blocks.last().colors.size() !=
-                              r_global_vertices.vertices.size())) {
-      GlobalVertices::VertexColorsBlock block;
-      block.start_vertex_index = r_global_vertices.vertices.size();
-      blocks.append(block);
-    }
-    blocks.last().colors.append({linear[0], linear[1], linear[2]});
+    chunk_add_vertex_color(r_chunk, vertex_count, {linear[0], linear[1], linear[2]});
     /* MRGB colors are specified after vertex positions; each new color
      * "pushes" the vertex colors block further back into which vertices it is for. */
-    blocks.last().start_vertex_index--;
+    r_chunk.color_blocks.last().start_vertex_index--;
 
     p += mrgb_length;
   }
 }
 
-static void geom_add_vertex_normal(const char *p,
-                                   const char *end,
-                                   GlobalVertices &r_global_vertices)
+/**
+ * Append the vertex colors of a chunk to the global ones, merging its first block into the last
+ * global one when parsing the whole file at once would have done so.
+ */
+static void append_vertex_colors(const ObjChunk &chunk, GlobalVertices &r_global_vertices)
+{
+  if (chunk.color_blocks.is_empty()) {
+    return;
+  }
+  auto &blocks = r_global_vertices.vertex_colors;
+  Span<GlobalVertices::VertexColorsBlock> chunk_blocks = chunk.color_blocks;
+  if (!blocks.is_empty() && blocks.last().start_vertex_index + blocks.last().colors.size() ==
+                                chunk.first_color_block_start) {
+    const GlobalVertices::VertexColorsBlock &first = chunk_blocks.first();
+    /* MRGB colors of the first block moved its start back, move the merged block as well. */
+    blocks.last().start_vertex_index -= chunk.first_color_block_start - first.start_vertex_index;
+    blocks.last().colors.extend(first.colors);
+    chunk_blocks = chunk_blocks.drop_front(1);
+  }
+  blocks.extend(chunk_blocks);
+}
+
+static void parse_vertex_normal(const char *p, const char *end, float3 &r_normal)
 {
-  float3 normal;
-  parse_floats(p, end, 0.0f, normal, 3);
+  parse_floats(p, end, 0.0f, r_normal, 3);
   /* Normals can be printed with only several digits in the file,
    * making them ever-so-slightly non unit length. Make sure they are
    * normalized. */
-  normalize_v3(normal);
-  r_global_vertices.vertex_normals.append(normal);
+  normalize_v3(r_normal);
 }
 
-static void geom_add_uv_vertex(const char *p, const char *end, GlobalVertices &r_global_vertices)
+static void parse_uv_vertex(const char *p, const char *end, float2 &r_uv)
 {
-  float2 uv;
-  parse_floats(p, end, 0.0f, uv, 2);
-  r_global_vertices.uv_vertices.append(uv);
+  parse_floats(p, end, 0.0f, r_uv, 2);
 }
 
-static void geom_add_edge(Geometry *geom,
-                          const char *p,
-                          const char *end,
-                          GlobalVertices &r_global_vertices)
+static void parse_edge(const char *p, const char *end, const int vertex_count, ObjChunk &r_chunk)
 {
   int edge_v1, edge_v2;
   p = parse_int(p, end, -1, edge_v1);
   p = parse_int(p, end, -1, edge_v2);
   /* Always keep stored indices non-negative and zero-based. */
-  edge_v1 += edge_v1 < 0 ? r_global_vertices.vertices.size() : -1;
-  edge_v2 += edge_v2 < 0 ? r_global_vertices.vertices.size() : -1;
+  edge_v1 += edge_v1 < 0 ? vertex_count : -1;
+  edge_v2 += edge_v2 < 0 ? vertex_count : -1;
   BLI_assert(edge_v1 >= 0 && edge_v2 >= 0);
-  geom->edges_.append({static_cast<uint>(edge_v1), static_cast<uint>(edge_v2)});
-  geom->track_vertex_index(edge_v1);
-  geom->track_vertex_index(edge_v2);
+  r_chunk.edges.append({static_cast<uint>(edge_v1), static_cast<uint>(edge_v2)});
+  chunk_add_to_run(r_chunk, eChunkCommand::Edges);
 }
 
-static void geom_add_polygon(Geometry *geom,
-                             const char *p,
-                             const char *end,
-                             const GlobalVertices &global_vertices,
-                             const int material_index,
-                             const int group_index,
-                             const bool shaded_smooth)
+static std::string invalid_index_warning(const char *element, const int index, const int count)
 {
-  PolyElem curr_face;
-  curr_face.shaded_smooth = shaded_smooth;
-  curr_face.material_index = material_index;
-  if (group_index >= 0) {
-    curr_face.vertex_group_index = group_index;
-    geom->has_vertex_groups_ = true;
-  }
+  char message[128];
+  BLI_snprintf(message,
+               sizeof(message),
+               "Invalid %s index %i (valid range [0, %i)), ignoring face",
+               element,
+               index,
+               count);
+  return message;
+}
 
-  const int orig_corners_size = geom->face_corners_.size();
-  curr_face.start_index_ = orig_corners_size;
+/**
+ * Parse the corners of a face. The element counts are the numbers of vertices, UVs and normals
+ * defined before the line, which relative indices refer to.
+ */
+static void parse_polygon(const char *p,
+                          const char *end,
+                          const int vertex_count,
+                          const int uv_count,
+                          const int normal_count,
+                          ObjChunk &r_chunk)
+{
+  ChunkFace curr_face;
+  curr_face.start_index = r_chunk.face_corners.size();
 
   bool face_valid = true;
   p = drop_whitespace(p, end);
@@ -210,59 +337,84 @@ static void geom_add_polygon(Geometry *geom,
       }
     }
     /* Always keep stored indices non-negative and zero-based. */
-    corner.vert_index += corner.vert_index < 0 ? global_vertices.vertices.size() : -1;
-    if (corner.vert_index < 0 || corner.vert_index >= global_vertices.vertices.size()) {
-      fprintf(stderr,
-              "Invalid vertex index %i (valid range [0, %zu)), ignoring face\n",
-              corner.vert_index,
-              (size_t)global_vertices.vertices.size());
+    corner.vert_index += corner.vert_index < 0 ? vertex_count : -1;
+    if (corner.vert_index < 0 || corner.vert_index >= vertex_count) {
+      r_chunk.warnings.append(invalid_index_warning("vertex", corner.vert_index, vertex_count));
+      corner.vert_index = -1;
       face_valid = false;
     }
-    else {
-      geom->track_vertex_index(corner.vert_index);
-    }
     if (got_uv) {
-      corner.uv_vert_index += corner.uv_vert_index < 0 ? global_vertices.uv_vertices.size() : -1;
-      if (corner.uv_vert_index < 0 || corner.uv_vert_index >= global_vertices.uv_vertices.size()) {
-        fprintf(stderr,
-                "Invalid UV index %i (valid range [0, %zu)), ignoring face\n",
-                corner.uv_vert_index,
-                (size_t)global_vertices.uv_vertices.size());
+      corner.uv_vert_index += corner.uv_vert_index < 0 ? uv_count : -1;
+      if (corner.uv_vert_index < 0 || corner.uv_vert_index >= uv_count) {
+        r_chunk.warnings.append(invalid_index_warning("UV", corner.uv_vert_index, uv_count));
         face_valid = false;
       }
     }
     /* Ignore corner normal index, if the geometry does not have any normals.
      * Some obj files out there do have face definitions that refer to normal indices,
      * without any normals being present (T98782). */
-    if (got_normal && !global_vertices.vertex_normals.is_empty()) {
-      corner.vertex_normal_index += corner.vertex_normal_index < 0 ?
-                                        global_vertices.vertex_normals.size() :
-                                        -1;
-      if (corner.vertex_normal_index < 0 ||
-          corner.vertex_normal_index >= global_vertices.vertex_normals.size()) {
-        fprintf(stderr,
-                "Invalid normal index %i (valid range [0, %zu)), ignoring face\n",
-                corner.vertex_normal_index,
-                (size_t)global_vertices.vertex_normals.size());
+    if (got_normal && normal_count > 0) {
+      corner.vertex_normal_index += corner.vertex_normal_index < 0 ? normal_count : -1;
+      if (corner.vertex_normal_index < 0 || corner.vertex_normal_index >= normal_count) {
+        r_chunk.warnings.append(
+            invalid_index_warning("normal", corner.vertex_normal_index, normal_count));
         face_valid = false;
       }
     }
-    geom->face_corners_.append(corner);
-    curr_face.corner_count_++;
+    r_chunk.face_corners.append(corner);
+    curr_face.corner_count++;
 
     /* Skip whitespace to get to the next face corner. */
     p = drop_whitespace(p, end);
   }
 
-  if (face_valid) {
-    geom->face_elements_.append(curr_face);
-    geom->total_loops_ += curr_face.corner_count_;
+  curr_face.valid = face_valid;
+  r_chunk.faces.append(curr_face);
+  chunk_add_to_run(r_chunk, eChunkCommand::Faces);
+}
+
+static void geom_add_polygon(Geometry *geom,
+                             const ChunkFace &face,
+                             Span<PolyCorner> chunk_corners,
+                             const int material_index,
+                             const int group_index,
+                             const bool shaded_smooth)
+{
+  PolyElem curr_face;
+  curr_face.shaded_smooth = shaded_smooth;
+  curr_face.material_index = material_index;
+  if (group_index >= 0) {
+    curr_face.vertex_group_index = group_index;
+    geom->has_vertex_groups_ = true;
   }
-  else {
-    /* Remove just-added corners for the invalid face. */
-    geom->face_corners_.resize(orig_corners_size);
+
+  const Span<PolyCorner> corners = chunk_corners.slice(face.start_index, face.corner_count);
+  if (!face.valid) {
+    /* Vertices of the corners read before the face was found invalid are still used. */
+    for (const PolyCorner &corner : corners) {
+      if (corner.vert_index >= 0) {
+        geom->track_vertex_index(corner.vert_index);
+      }
+    }
     geom->has_invalid_polys_ = true;
+    return;
   }
+
+  curr_face.start_index_ = geom->face_corners_.size();
+  curr_face.corner_count_ = face.corner_count;
+  for (const PolyCorner &corner : corners) {
+    geom->track_vertex_index(corner.vert_index);
+  }
+  geom->face_corners_.extend(corners);
+  geom->face_elements_.append(curr_face);
+  geom->total_loops_ += curr_face.corner_count_;
+}
+
+static void geom_add_edge(Geometry *geom, const MEdge &edge)
+{
+  geom->edges_.append(edge);
+  geom->track_vertex_index(edge.v1);
+  geom->track_vertex_index(edge.v2);
 }
 
 static Geometry *geom_set_curve_type(Geometry *geom,
@@ -289,7 +441,7 @@ static void geom_set_curve_degree(Geometry *geom, const char *p, const char *end
 static void geom_add_curve_vertex_indices(Geometry *geom,
                                           const char *p,
                                           const char *end,
-                                          const GlobalVertices &global_vertices)
+                                          const int vertex_count)
 {
   /* Curve lines always have "0.0" and "1.0", skip over them. */
   float dummy[2];
@@ -302,7 +454,7 @@ static void geom_add_curve_vertex_indices(Geometry *geom,
       return;
     }
     /* Always keep stored indices non-negative and zero-based. */
-    index += index < 0 ? global_vertices.vertices.size() : -1;
+    index += index < 0 ? vertex_count : -1;
     geom->nurbs_element_.curv_indices.append(index);
   }
 }
@@ -362,17 +514,46 @@ static void geom_update_smooth_group(const char *p, const char *end, bool &r_sta
 OBJParser::OBJParser(const OBJImportParams &import_params, size_t read_buffer_size = 64 * 1024)
     : import_params_(import_params), read_buffer_size_(read_buffer_size)
 {
-  obj_file_ = BLI_fopen(import_params_.filepath, "rb");
-  if (!obj_file_) {
+  obj_file_ = BLI_open(import_params_.filepath, O_BINARY | O_RDONLY, 0);
+  if (obj_file_ == -1) {
+    fprintf(stderr, "Cannot read from OBJ file:'%s'.\n", import_params_.filepath);
+    return;
+  }
+
+  const int64_t file_size = BLI_lseek(obj_file_, 0, SEEK_END);
+  if (file_size <= 0) {
+    /* Nothing to map in an empty file. */
+    return;
+  }
+
+  obj_mmap_ = BLI_mmap_open(obj_file_);
+  if (obj_mmap_) {
+    obj_text_ = StringRef(static_cast<const char *>(BLI_mmap_get_pointer(obj_mmap_)), file_size);
+    return;
+  }
+
+  /* Memory mapping is not available on all file systems, read the whole file instead. */
+  size_t buffer_len;
+  obj_buffer_ = BLI_file_read_binary_as_mem(import_params_.filepath, 0, &buffer_len);
+  if (!obj_buffer_) {
     fprintf(stderr, "Cannot read from OBJ file:'%s'.\n", import_params_.filepath);
+    close(obj_file_);
+    obj_file_ = -1;
     return;
   }
+  obj_text_ = StringRef(static_cast<const char *>(obj_buffer_), (int64_t)buffer_len);
 }
 
 OBJParser::~OBJParser()
 {
-  if (obj_file_) {
-    fclose(obj_file_);
+  if (obj_mmap_) {
+    BLI_mmap_free(obj_mmap_);
+  }
+  if (obj_buffer_) {
+    MEM_freeN(obj_buffer_);
+  }
+  if (obj_file_ != -1) {
+    close(obj_file_);
   }
 }
 
@@ -411,13 +592,202 @@ static void use_all_vertices_if_no_faces(Geometry *geom,
   }
 }
 
+/* Whether the newline at the given position is escaped by a backslash, see
+ * #fixup_line_continuations. */
+static bool is_line_continuation(const char *begin, const char *newline)
+{
+  const char *p = newline;
+  while (p > begin && p[-1] <= ' ' && p[-1] != '\n') {
+    --p;
+  }
+  return p > begin && p[-1] == '\\';
+}
+
+/**
+ * Split the text in chunks of roughly the given size, ending at the end of a line that is not
+ * continued on the next one.
+ */
+static Vector<ObjChunk> split_into_chunks(const StringRef text, const size_t chunk_size)
+{
+  Vector<ObjChunk> chunks;
+  const char *p = text.begin();
+  const char *end = text.end();
+  while (p < end) {
+    const char *chunk_end = p + std::min<size_t>(chunk_size, end - p);
+    while (chunk_end < end) {
+      const char *newline = std::find(chunk_end, end, '\n');
+      chunk_end = newline == end ? end : newline + 1;
+      if (newline == end || !is_line_continuation(text.begin(), newline)) {
+        break;
+      }
+    }
+    chunks.append_as();
+    chunks.last().text = StringRef(p, chunk_end);
+    p = chunk_end;
+  }
+  return chunks;
+}
+
+/**
+ * Fix up the line continuations of the chunk and count the vertex data it defines, so that the
+ * chunks can later be parsed independently.
+ */
+static void prepare_chunk(ObjChunk &chunk)
+{
+  if (std::find(chunk.text.begin(), chunk.text.end(), '\\') != chunk.text.end()) {
+    chunk.fixed_text.reinitialize(chunk.text.size());
+    std::copy(chunk.text.begin(), chunk.text.end(), chunk.fixed_text.begin());
+    /* Take care of line continuations now (turn them into spaces);
+     * the rest of the parsing code does not need to worry about them anymore. */
+    fixup_line_continuations(chunk.fixed_text.begin(), chunk.fixed_text.end());
+    chunk.text = StringRef(chunk.fixed_text.data(), chunk.fixed_text.size());
+  }
+
+  StringRef buffer_str = chunk.text;
+  while (!buffer_str.is_empty()) {
+    StringRef line = read_next_line(buffer_str);
+    const char *p = line.begin(), *end = line.end();
+    p = drop_whitespace(p, end);
+    if (p == end || *p != 'v') {
+      continue;
+    }
+    if (parse_keyword(p, end, "v")) {
+      chunk.vertex_count++;
+    }
+    else if (parse_keyword(p, end, "vn")) {
+      chunk.normal_count++;
+    }
+    else if (parse_keyword(p, end, "vt")) {
+      chunk.uv_count++;
+    }
+  }
+}
+
+/**
+ * Parse all the lines of a chunk. Vertex data is written to the global arrays, at the offsets
+ * computed from the counts of the previous chunks, and everything else is stored in the chunk.
+ */
+static void parse_chunk(ObjChunk &chunk, GlobalVertices &r_global_vertices)
+{
+  MutableSpan<float3> vertices = r_global_vertices.vertices;
+  MutableSpan<float2> uv_vertices = r_global_vertices.uv_vertices;
+  MutableSpan<float3> vertex_normals = r_global_vertices.vertex_normals;
+  int vertex_index = chunk.vertex_start;
+  int uv_index = chunk.uv_start;
+  int normal_index = chunk.normal_start;
+
+  StringRef buffer_str = chunk.text;
+  while (!buffer_str.is_empty()) {
+    StringRef line = read_next_line(buffer_str);
+    const char *p = line.begin(), *end = line.end();
+    p = drop_whitespace(p, end);
+    if (p == end) {
+      continue;
+    }
+    /* Most common things that start with 'v': vertices, normals, UVs. */
+    if (*p == 'v') {
+      if (parse_keyword(p, end, "v")) {
+        parse_vertex(p, end, vertex_index++, vertices, chunk);
+      }
+      else if (parse_keyword(p, end, "vn")) {
+        parse_vertex_normal(p, end, vertex_normals[normal_index++]);
+      }
+      else if (parse_keyword(p, end, "vt")) {
+        parse_uv_vertex(p, end, uv_vertices[uv_index++]);
+      }
+    }
+    /* Faces. */
+    else if (parse_keyword(p, end, "f")) {
+      parse_polygon(p, end, vertex_index, uv_index, normal_index, chunk);
+    }
+    /* Faces. */
+    else if (parse_keyword(p, end, "l")) {
+      parse_edge(p, end, vertex_index, chunk);
+    }
+    /* Objects. */
+    else if (parse_keyword(p, end, "o")) {
+      chunk_add_command(chunk, eChunkCommand::Object, StringRef(p, end).trim());
+    }
+    /* Groups. */
+    else if (parse_keyword(p, end, "g")) {
+      chunk_add_command(chunk, eChunkCommand::Group, StringRef(p, end).trim());
+    }
+    /* Smoothing groups. */
+    else if (parse_keyword(p, end, "s")) {
+      chunk_add_command(chunk, eChunkCommand::SmoothGroup, StringRef(p, end));
+    }
+    /* Materials and their libraries. */
+    else if (parse_keyword(p, end, "usemtl")) {
+      chunk_add_command(chunk, eChunkCommand::UseMaterial, StringRef(p, end).trim());
+    }
+    else if (parse_keyword(p, end, "mtllib")) {
+      chunk_add_command(chunk, eChunkCommand::MaterialLibrary, StringRef(p, end).trim());
+    }
+    else if (parse_keyword(p, end, "#MRGB")) {
+      parse_mrgb_colors(p, end, vertex_index, chunk);
+    }
+    /* Comments. */
+    else if (*p == '#') {
+      /* Nothing to do. */
+    }
+    /* Curve related things. */
+    else if (parse_keyword(p, end, "cstype")) {
+      chunk_add_command(chunk, eChunkCommand::CurveType, StringRef(p, end));
+    }
+    else if (parse_keyword(p, end, "deg")) {
+      chunk_add_command(chunk, eChunkCommand::CurveDegree, StringRef(p, end));
+    }
+    else if (parse_keyword(p, end, "curv")) {
+      chunk_add_command(chunk, eChunkCommand::CurveIndices, StringRef(p, end), vertex_index);
+    }
+    else if (parse_keyword(p, end, "parm")) {
+      chunk_add_command(chunk, eChunkCommand::CurveParameters, StringRef(p, end));
+    }
+    else if (StringRef(p, end).startswith("end")) {
+      /* End of curve definition, nothing else to do. */
+    }
+    else {
+      chunk.warnings.append("OBJ element not recognized: '" + std::string(p, end) + "'");
+    }
+  }
+}
+
 void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
                       GlobalVertices &r_global_vertices)
 {
-  if (!obj_file_) {
+  if (obj_file_ == -1) {
     return;
   }
 
+  /* Parse the chunks in parallel. */
+  Vector<ObjChunk> chunks = split_into_chunks(obj_text_, read_buffer_size_);
+  threading::parallel_for(chunks.index_range(), 1, [&](IndexRange range) {
+    for (const int i : range) {
+      prepare_chunk(chunks[i]);
+    }
+  });
+
+  int vertex_count = r_global_vertices.vertices.size();
+  int uv_count = r_global_vertices.uv_vertices.size();
+  int normal_count = r_global_vertices.vertex_normals.size();
+  for (ObjChunk &chunk : chunks) {
+    chunk.vertex_start = vertex_count;
+    chunk.uv_start = uv_count;
+    chunk.normal_start = normal_count;
+    vertex_count += chunk.vertex_count;
+    uv_count += chunk.uv_count;
+    normal_count += chunk.normal_count;
+  }
+  r_global_vertices.vertices.resize(vertex_count);
+  r_global_vertices.uv_vertices.resize(uv_count);
+  r_global_vertices.vertex_normals.resize(normal_count);
+
+  threading::parallel_for(chunks.index_range(), 1, [&](IndexRange range) {
+    for (const int i : range) {
+      parse_chunk(chunks[i], r_global_vertices);
+    }
+  });
+
   /* Use the filename as the default name given to the initial object. */
   char ob_name[FILE_MAXFILE];
   BLI_strncpy(ob_name, BLI_path_basename(import_params_.filepath), FILE_MAXFILE);
@@ -433,159 +803,81 @@ void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
   string state_material_name;
   int state_material_index = -1;
 
-  /* Read the input file in chunks. We need up to twice the possible chunk size,
-   * to possibly store remainder of the previous input line that got broken mid-chunk. */
-  Array<char> buffer(read_buffer_size_ * 2);
-
-  size_t buffer_offset = 0;
-  size_t line_number = 0;
-  while (true) {
-    /* Read a chunk of input from the file. */
-    size_t bytes_read = fread(buffer.data() + buffer_offset, 1, read_buffer_size_, obj_file_);
-    if (bytes_read == 0 && buffer_offset == 0) {
-      break; /* No more data to read. */
-    }
-
-    /* Take care of line continuations now (turn them into spaces);
-     * the rest of the parsing code does not need to worry about them anymore. */
-    fixup_line_continuations(buffer.data() + buffer_offset,
-                             buffer.data() + buffer_offset + bytes_read);
-
-    /* Ensure buffer ends in a newline. */
-    if (bytes_read < read_buffer_size_) {
-      if (bytes_read == 0 || buffer[buffer_offset + bytes_read - 1] != '\n') {
-        buffer[buffer_offset + bytes_read] = '\n';
-        bytes_read++;
-      }
-    }
-
-    size_t buffer_end = buffer_offset + bytes_read;
-    if (buffer_end == 0) {
-      break;
-    }
-
-    /* Find last newline. */
-    size_t last_nl = buffer_end;
-    while (last_nl > 0) {
-      --last_nl;
-      if (buffer[last_nl] == '\n') {
-        break;
-      }
+  /* Replay the chunks in order. */
+  for (const ObjChunk &chunk : chunks) {
+    for (const std::string &warning : chunk.warnings) {
+      std::cerr << warning << std::endl;
     }
-    if (buffer[last_nl] != '\n') {
-      /* Whole line did not fit into our read buffer. Warn and exit. */
-      fprintf(stderr,
-              "OBJ file contains a line #%zu that is too long (max. length %zu)\n",
-              line_number,
-              read_buffer_size_);
-      break;
-    }
-    ++last_nl;
-
-    /* Parse the buffer (until last newline) that we have so far,
-     * line by line. */
-    StringRef buffer_str{buffer.data(), (int64_t)last_nl};
-    while (!buffer_str.is_empty()) {
-      StringRef line = read_next_line(buffer_str);
-      const char *p = line.begin(), *end = line.end();
-      p = drop_whitespace(p, end);
-      ++line_number;
-      if (p == end) {
-        continue;
-      }
-      /* Most common things that start with 'v': vertices, normals, UVs. */
-      if (*p == 'v') {
-        if (parse_keyword(p, end, "v")) {
-          geom_add_vertex(p, end, r_global_vertices);
-        }
-        else if (parse_keyword(p, end, "vn")) {
-          geom_add_vertex_normal(p, end, r_global_vertices);
-        }
-        else if (parse_keyword(p, end, "vt")) {
-          geom_add_uv_vertex(p, end, r_global_vertices);
+    append_vertex_colors(chunk, r_global_vertices);
+
+    int face_index = 0;
+    int edge_index = 0;
+    for (const ChunkCommand &command : chunk.commands) {
+      const char *p = command.line.begin(), *end = command.line.end();
+      switch (command.type) {
+        case eChunkCommand::Faces:
+          for (const ChunkFace &face : chunk.faces.as_span().slice(face_index, command.count)) {
+            geom_add_polygon(curr_geom,
+                             face,
+                             chunk.face_corners,
+                             state_material_index,
+                             state_group_index,
+                             state_shaded_smooth);
+          }
+          face_index += command.count;
+          break;
+        case eChunkCommand::Edges:
+          for (const MEdge &edge : chunk.edges.as_span().slice(edge_index, command.count)) {
+            geom_add_edge(curr_geom, edge);
+          }
+          edge_index += command.count;
+          break;
+        case eChunkCommand::Object:
+          state_shaded_smooth = false;
+          state_group_name = "";
+          state_material_name = "";
+          curr_geom = create_geometry(curr_geom, GEOM_MESH, command.line, r_all_geometries);
+          break;
+        case eChunkCommand::Group: {
+          geom_update_group(command.line, state_group_name);
+          int new_index = curr_geom->group_indices_.size();
+          state_group_index = curr_geom->group_indices_.lookup_or_add(state_group_name,
+                                                                      new_index);
+          if (new_index == state_group_index) {
+            curr_geom->group_order_.append(state_group_name);
+          }
+          break;
         }
-      }
-      /* Faces. */
-      else if (parse_keyword(p, end, "f")) {
-        geom_add_polygon(curr_geom,
-                         p,
-                         end,
-                         r_global_vertices,
-                         state_material_index,
-                         state_group_index,
-                         state_shaded_smooth);
-      }
-      /* Faces. */
-      else if (parse_keyword(p, end, "l")) {
-        geom_add_edge(curr_geom, p, end, r_global_vertices);
-      }
-      /* Objects. */
-      else if (parse_keyword(p, end, "o")) {
-        state_shaded_smooth = false;
-        state_group_name = "";
-        state_material_name = "";
-        curr_geom = create_geometry(
-            curr_geom, GEOM_MESH, StringRef(p, end).trim(), r_all_geometries);
-      }
-      /* Groups. */
-      else if (parse_keyword(p, end, "g")) {
-        geom_update_group(StringRef(p, end).trim(), state_group_name);
-        int new_index = curr_geom->group_indices_.size();
-        state_group_index = curr_geom->group_indices_.lookup_or_add(state_group_name, new_index);
-        if (new_index == state_group_index) {
-          curr_geom->group_order_.append(state_group_name);
-        }
-      }
-      /* Smoothing groups. */
-      else if (parse_keyword(p, end, "s")) {
-        geom_update_smooth_group(p, end, state_shaded_smooth);
-      }
-      /* Materials and their libraries. */
-      else if (parse_keyword(p, end, "usemtl")) {
-        state_material_name = StringRef(p, end).trim();
-        int new_mat_index = curr_geom->material_indices_.size();
-        state_material_index = curr_geom->material_indices_.lookup_or_add(state_material_name,
-                                                                          new_mat_index);
-        if (new_mat_index == state_material_index) {
-          curr_geom->material_order_.append(state_material_name);
+        case eChunkCommand::SmoothGroup:
+          geom_update_smooth_group(p, end, state_shaded_smooth);
+          break;
+        case eChunkCommand::UseMaterial: {
+          state_material_name = command.line;
+          int new_mat_index = curr_geom->material_indices_.size();
+          state_material_index = curr_geom->material_indices_.lookup_or_add(state_material_name,
+                                                                            new_mat_index);
+          if (new_mat_index == state_material_index) {
+            curr_geom->material_order_.append(state_material_name);
+          }
+          break;
         }
-      }
-      else if (parse_keyword(p, end, "mtllib")) {
-        add_mtl_library(StringRef(p, end).trim());
-      }
-      else if (parse_keyword(p, end, "#MRGB")) {
-        geom_add_mrgb_colors(p, end, r_global_vertices);
-      }
-      /* Comments. */
-      else if (*p == '#') {
-        /* Nothing to do. */
-      }
-      /* Curve related things. */
-      else if (parse_keyword(p, end, "cstype")) {
-        curr_geom = geom_set_curve_type(curr_geom, p, end, state_group_name, r_all_geometries);
-      }
-      else if (parse_keyword(p, end, "deg")) {
-        geom_set_curve_degree(curr_geom, p, end);
-      }
-      else if (parse_keyword(p, end, "curv")) {
-        geom_add_curve_vertex_indices(curr_geom, p, end, r_global_vertices);
-      }
-      else if (parse_keyword(p, end, "parm")) {
-        geom_add_curve_parameters(curr_geom, p, end);
-      }
-      else if (StringRef(p, end).startswith("end")) {
-        /* End of curve definition, nothing else to do. */
-      }
-      else {
-        std::cout << "OBJ element not recognized: '" << std::string(p, end) << "'" << std::endl;
+        case eChunkCommand::MaterialLibrary:
+          add_mtl_library(command.line);
+          break;
+        case eChunkCommand::CurveType:
+          curr_geom = geom_set_curve_type(curr_geom, p, end, state_group_name, r_all_geometries);
+          break;
+        case eChunkCommand::CurveDegree:
+          geom_set_curve_degree(curr_geom, p, end);
+          break;
+        case eChunkCommand::CurveIndices:
+          geom_add_curve_vertex_indices(curr_geom, p, end, command.vertex_count);
+          break;
+        case eChunkCommand::CurveParameters:
+          geom_add_curve_parameters(curr_geom, p, end);
+          break;
       }
     }
-
-    /* We might have a line that was cut in the middle by the previous buffer;
-     * copy it over for next chunk reading. */
-    size_t left_size = buffer_end - last_nl;
-    memmove(buffer.data(), buffer.data() + last_nl, left_size);
-    buffer_offset = left_size;
   }
 
   use_all_vertices_if_no_faces(curr_geom, r_all_geometries, r_global_vertices);
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "BLI_fileops.hh"
+#include "BLI_mmap.h"
 #include "IO_wavefront_obj.h"
 #include "obj_import_mtl.hh"
 #include "obj_import_objects.hh"
@@ -18,20 +19,25 @@ namespace blender::io::obj {
 class OBJParser {
  private:
   const OBJImportParams &import_params_;
-  FILE *obj_file_;
+  int obj_file_ = -1;
+  BLI_mmap_file *obj_mmap_ = nullptr;
+  /* Contents of the file when it could not be memory-mapped. */
+  void *obj_buffer_ = nullptr;
+  StringRef obj_text_;
   Vector<std::string> mtl_libraries_;
   size_t read_buffer_size_;
 
  public:
   /**
-   * Open OBJ file at the path given in import parameters.
+   * Open and memory-map the OBJ file at the path given in import parameters.
+   * \param read_buffer_size: approximate size of the chunks of the file parsed in parallel.
    */
   OBJParser(const OBJImportParams &import_params, size_t read_buffer_size);
   ~OBJParser();
 
   /**
-   * Read the OBJ file line by line and create OBJ Geometry instances. Also store all the vertex
-   * and UV vertex coordinates in a struct accessible by all objects.
+   * Parse the OBJ file in parallel chunks and create OBJ Geometry instances. Also store all the
+   * vertex and UV vertex coordinates in a struct accessible by all objects.
    */
   void parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
              GlobalVertices &r_global_vertices);
@@ -0,0 +1,301 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include "BKE_appdir.h"
+
+#include "BLI_fileops.h"
+#include "BLI_string.h"
+
+#include "testing/testing.h"
+
+#include "obj_import_file_reader.hh"
+
+namespace blender::io::obj {
+
+class obj_parser_test : public testing::Test {
+ public:
+  /**
+   * Write the text to a temporary file and parse it, cutting it in chunks of the given size.
+   */
+  void parse_string(const std::string &text, size_t read_buffer_size)
+  {
+    BKE_tempdir_init(nullptr);
+    std::string tmp_file_path = std::string(BKE_tempdir_base()) + "/obj_parser_test.obj";
+    FILE *tmp_file = BLI_fopen(tmp_file_path.c_str(), "wb");
+    ASSERT_NE(tmp_file, nullptr);
+    fwrite(text.data(), 1, text.size(), tmp_file);
+    fclose(tmp_file);
+
+    OBJImportParams params{};
+    STRNCPY(params.filepath, tmp_file_path.c_str());
+    geometries.clear();
+    global_vertices = GlobalVertices();
+    {
+      OBJParser parser(params, read_buffer_size);
+      parser.parse(geometries, global_vertices);
+    }
+
+    BLI_delete(tmp_file_path.c_str(), false, false);
+  }
+
+  /**
+   * Vertex indices of all the face corners, face by face, as parsed in #geometries.
+   */
+  Vector<Vector<int>> faces(int geometry_index) const
+  {
+    Vector<Vector<int>> result;
+    const Geometry &geom = *geometries[geometry_index];
+    for (const PolyElem &face : geom.face_elements_) {
+      Vector<int> corners;
+      for (int i = 0; i < face.corner_count_; ++i) {
+        corners.append(geom.face_corners_[face.start_index_ + i].vert_index);
+      }
+      result.append(std::move(corners));
+    }
+    return result;
+  }
+
+  Vector<std::unique_ptr<Geometry>> geometries;
+  GlobalVertices global_vertices;
+};
+
+/* A grid of size x size points and the quads between them. */
+static std::string grid_obj_text(int size, const char *newline)
+{
+  std::string text = std::string("o Grid") + newline;
+  char line[64];
+  for (int y = 0; y < size; y++) {
+    for (int x = 0; x < size; x++) {
+      SNPRINTF(line, "v %d %d 0.5%s", x, y, newline);
+      text += line;
+    }
+  }
+  for (int y = 0; y < size - 1; y++) {
+    for (int x = 0; x < size - 1; x++) {
+      const int i = y * size + x + 1;
+      SNPRINTF(line, "f %d %d %d %d%s", i, i + 1, i + size + 1, i + size, newline);
+      text += line;
+    }
+  }
+  return text;
+}
+
+TEST_F(obj_parser_test, parse_crlf)
+{
+  const std::string text_lf = grid_obj_text(4, "\n");
+  const std::string text_crlf = grid_obj_text(4, "\r\n");
+
+  parse_string(text_lf, text_lf.size());
+  ASSERT_EQ(geometries.size(), 1);
+  const Vector<float3> vertices_lf = global_vertices.vertices;
+  const Vector<Vector<int>> faces_lf = faces(0);
+  EXPECT_EQ(vertices_lf.size(), 16);
+  EXPECT_EQ(faces_lf.size(), 9);
+
+  /* Small chunks also get cut between the carriage return and the line feed. */
+  for (const size_t read_buffer_size : {text_crlf.size(), size_t(650), size_t(16), size_t(1)}) {
+    parse_string(text_crlf, read_buffer_size);
+    ASSERT_EQ(geometries.size(), 1);
+    EXPECT_EQ(geometries[0]->geometry_name_, "Grid");
+    EXPECT_EQ(global_vertices.vertices.size(), vertices_lf.size());
+    for (int i = 0; i < vertices_lf.size() && i < global_vertices.vertices.size(); i++) {
+      EXPECT_V3_NEAR(global_vertices.vertices[i], vertices_lf[i], 1e-6f);
+    }
+    EXPECT_EQ(faces(0), faces_lf);
+    EXPECT_FALSE(geometries[0]->has_invalid_polys_);
+  }
+}
+
+TEST_F(obj_parser_test, parse_no_trailing_newline)
+{
+  /* The last line ends right at the end of the file, which is not null terminated. */
+  parse_string("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3", 650);
+  ASSERT_EQ(geometries.size(), 1);
+  EXPECT_EQ(global_vertices.vertices.size(), 3);
+  EXPECT_EQ(faces(0), Vector<Vector<int>>({{0, 1, 2}}));
+
+  parse_string("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\nv 0.25 -2 7.5", 650);
+  ASSERT_EQ(global_vertices.vertices.size(), 4);
+  EXPECT_V3_NEAR(global_vertices.vertices[3], float3(0.25f, -2.0f, 7.5f), 1e-6f);
+
+  /* Same with the last line alone in its chunk. */
+  parse_string("v 0 0 0\nv 1 0 0\nv 0 1 0\nv 0.25 -2 7.5", 8);
+  ASSERT_EQ(global_vertices.vertices.size(), 4);
+  EXPECT_V3_NEAR(global_vertices.vertices[3], float3(0.25f, -2.0f, 7.5f), 1e-6f);
+
+  parse_string("v 0 0 0\nv 1 0 0\nv 0 1 0\no Last", 650);
+  ASSERT_EQ(geometries.size(), 1);
+  EXPECT_EQ(geometries[0]->geometry_name_, "Last");
+}
+
+TEST_F(obj_parser_test, parse_line_continuation)
+{
+  const std::string text =
+      "v 0 0 0\n"
+      "v 1 0 \\\n"
+      "  0\n"
+      "v 1 1 0\n"
+      "v 0 1 0\r\n"
+      "f 1 \\\n"
+      "  2 \\ \t\n"
+      "  3 \\\r\n"
+      "  4\n"
+      "f 1 2 3\n";
+  /* Chunks as small as a single byte must not be split at an escaped newline. */
+  for (const size_t read_buffer_size : {text.size(), size_t(650), size_t(12), size_t(1)}) {
+    parse_string(text, read_buffer_size);
+    ASSERT_EQ(geometries.size(), 1);
+    ASSERT_EQ(global_vertices.vertices.size(), 4);
+    EXPECT_V3_NEAR(global_vertices.vertices[1], float3(1, 0, 0), 1e-6f);
+    EXPECT_V3_NEAR(global_vertices.vertices[2], float3(1, 1, 0), 1e-6f);
+    EXPECT_EQ(faces(0), Vector<Vector<int>>({{0, 1, 2, 3}, {0, 1, 2}}));
+  }
+}
+
+TEST_F(obj_parser_test, parse_large_file)
+{
+  /* About 8MB of text, parsed in many chunks. */
+  const int size = 400;
+  const std::string text = grid_obj_text(size, "\n");
+
+  parse_string(text, text.size());
+  ASSERT_EQ(geometries.size(), 1);
+  const Vector<Vector<int>> faces_single = faces(0);
+  ASSERT_EQ(faces_single.size(), (size - 1) * (size - 1));
+
+  parse_string(text, 64 * 1024);
+  ASSERT_EQ(geometries.size(), 1);
+  EXPECT_EQ(geometries[0]->geometry_name_, "Grid");
+  ASSERT_EQ(global_vertices.vertices.size(), size * size);
+  EXPECT_V3_NEAR(global_vertices.vertices[0], float3(0, 0, 0.5f), 1e-6f);
+  EXPECT_V3_NEAR(global_vertices.vertices[size * size - 1],
+                 float3(size - 1, size - 1, 0.5f),
+                 1e-6f);
+  EXPECT_EQ(geometries[0]->get_vertex_count(), size * size);
+  EXPECT_FALSE(geometries[0]->has_invalid_polys_);
+
+  const Vector<Vector<int>> faces_chunked = faces(0);
+  EXPECT_EQ(faces_chunked, faces_single);
+  const int last = size * size - 1;
+  EXPECT_EQ(faces_chunked.last(),
+            Vector<int>({last - size - 1, last - size, last, last - 1}));
+}
+
+/* Objects, groups, materials, smooth groups and vertex colors, whose state carries over lines. */
+static const char *state_obj_text =
+    "o First\n"
+    "v 0 0 0 1 0 0\n"
+    "v 1 0 0 0 1 0\n"
+    "v 1 1 0 0 0 1\n"
+    "v 0 1 0\n"
+    "v 2 0 0\n"
+    "#MRGB ff00ff00ffff0000\n"
+    "g g1\n"
+    "usemtl red\n"
+    "f 1 2 3\n"
+    "s 1\n"
+    "f 1 3 4\n"
+    "g g2\n"
+    "f 2 5 3\n"
+    "usemtl blue\n"
+    "f 1 2 5\n"
+    "o Second\n"
+    "v 0 0 1 1 1 1\n"
+    "v 1 0 1 0.5 0.5 0.5\n"
+    "v 1 1 1 0 0 0\n"
+    "usemtl red\n"
+    "f -3 -2 -1\n"
+    "g g1\n"
+    "s off\n"
+    "f 6 7 8\n"
+    "l 1 6\n";
+
+TEST_F(obj_parser_test, parse_state_at_chunk_boundaries)
+{
+  const std::string text = state_obj_text;
+  parse_string(text, text.size());
+  ASSERT_EQ(geometries.size(), 2);
+  EXPECT_EQ(geometries[0]->geometry_name_, "First");
+  EXPECT_EQ(geometries[0]->material_order_, Vector<std::string>({"red", "blue"}));
+  EXPECT_EQ(geometries[0]->group_order_, Vector<std::string>({"g1", "g2"}));
+  EXPECT_EQ(geometries[1]->geometry_name_, "Second");
+  EXPECT_EQ(geometries[1]->material_order_, Vector<std::string>({"red"}));
+  ASSERT_EQ(geometries[0]->face_elements_.size(), 4);
+  ASSERT_EQ(geometries[1]->face_elements_.size(), 2);
+  /* The MRGB colors go back to the vertices before them, and the colors of the second object
+   * continue that block. */
+  ASSERT_EQ(global_vertices.vertex_colors.size(), 2);
+  EXPECT_EQ(global_vertices.vertex_colors[0].start_vertex_index, 0);
+  EXPECT_EQ(global_vertices.vertex_colors[0].colors.size(), 3);
+  EXPECT_EQ(global_vertices.vertex_colors[1].start_vertex_index, 3);
+  EXPECT_EQ(global_vertices.vertex_colors[1].colors.size(), 5);
+
+  const Vector<std::unique_ptr<Geometry>> geometries_single = std::move(geometries);
+  const GlobalVertices global_vertices_single = global_vertices;
+
+  /* Chunks of a single byte are single lines, so all sizes put a chunk boundary right before each
+   * line that changes the state, and so does every chunk size in between. */
+  for (size_t read_buffer_size = 1; read_buffer_size < text.size(); read_buffer_size++) {
+    SCOPED_TRACE(read_buffer_size);
+    parse_string(text, read_buffer_size);
+    ASSERT_EQ(geometries.size(), geometries_single.size());
+    for (const int i : geometries.index_range()) {
+      const Geometry &geom = *geometries[i];
+      const Geometry &geom_single = *geometries_single[i];
+      EXPECT_EQ(geom.geometry_name_, geom_single.geometry_name_);
+      EXPECT_EQ(geom.material_order_, geom_single.material_order_);
+      EXPECT_EQ(geom.group_order_, geom_single.group_order_);
+      EXPECT_EQ(geom.edges_.size(), geom_single.edges_.size());
+      ASSERT_EQ(geom.face_elements_.size(), geom_single.face_elements_.size());
+      for (const int j : geom.face_elements_.index_range()) {
+        const PolyElem &face = geom.face_elements_[j];
+        const PolyElem &face_single = geom_single.face_elements_[j];
+        EXPECT_EQ(face.material_index, face_single.material_index);
+        EXPECT_EQ(face.vertex_group_index, face_single.vertex_group_index);
+        EXPECT_EQ(face.shaded_smooth, face_single.shaded_smooth);
+      }
+    }
+
+    ASSERT_EQ(global_vertices.vertex_colors.size(), global_vertices_single.vertex_colors.size());
+    for (const int j : global_vertices.vertex_colors.index_range()) {
+      const GlobalVertices::VertexColorsBlock &block = global_vertices.vertex_colors[j];
+      const GlobalVertices::VertexColorsBlock &block_single =
+          global_vertices_single.vertex_colors[j];
+      EXPECT_EQ(block.start_vertex_index, block_single.start_vertex_index);
+      ASSERT_EQ(block.colors.size(), block_single.colors.size());
+      for (const int k : block.colors.index_range()) {
+        EXPECT_V3_NEAR(block.colors[k], block_single.colors[k], 1e-6f);
+      }
+    }
+  }
+}
+
+TEST_F(obj_parser_test, parse_warnings_in_order)
+{
+  const std::string text =
+      "v 0 0 0\n"
+      "v 1 0 0\n"
+      "v 0 1 0\n"
+      "f 1 2 4\n"
+      "bogus line\n"
+      "f 1 2 3/5\n"
+      "f 1 2 3\n"
+      "f 1 2 -4\n";
+  const std::string expected =
+      "Invalid vertex index 3 (valid range [0, 3)), ignoring face\n"
+      "OBJ element not recognized: 'bogus line'\n"
+      "Invalid UV index 4 (valid range [0, 0)), ignoring face\n"
+      "Invalid vertex index -1 (valid range [0, 3)), ignoring face\n";
+
+  /* Chunks are parsed in parallel, but their warnings are printed in the order of the file. */
+  for (const size_t read_buffer_size : {text.size(), size_t(16), size_t(1)}) {
+    testing::internal::CaptureStderr();
+    parse_string(text, read_buffer_size);
+    EXPECT_EQ(testing::internal::GetCapturedStderr(), expected);
+    EXPECT_EQ(faces(0), Vector<Vector<int>>({{0, 1, 2}}));
+    EXPECT_TRUE(geometries[0]->has_invalid_polys_);
+  }
+}
+
+}  // namespace blender::io::obj
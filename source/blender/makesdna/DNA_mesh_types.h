@@ -31,6 +31,7 @@ struct MPoly;
 struct MVert;
 struct Material;
 struct Mesh;
+struct MeshValidateCache;
 struct SubdivCCG;
 struct SubsurfRuntimeData;
 
@@ -97,6 +98,9 @@ typedef struct Mesh_Runtime {
   /** Cache of non-manifold boundary data for Shrinkwrap Target Project. */
   struct ShrinkwrapBoundaryData *shrinkwrap_data;
 
+  /** Layers found valid by #BKE_mesh_validate_defects, defined in `mesh_validate.cc`. */
+  struct MeshValidateCache *validate_cache;
+
   /** Needed in case we need to lazily initialize the mesh. */
   CustomData_MeshMasks cd_mask_extra;
 
@@ -320,7 +320,6 @@
     .verts_num = 0, \
     .repeat = 1, \
     .vertexco = NULL, \
-    .cache_system = NULL, \
     .flag = 0, \
   }
 
@@ -478,6 +477,18 @@
     .foam_fade = 0.98f, \
   }
 
+#define _DNA_DEFAULT_OpenMfxModifierData \
+  { \
+    .plugin_path = "", \
+    .active_effect_index = -1, \
+    .message = "", \
+    .cache_directory = "", \
+    .flag = MOD_OPENMFX_USE_CACHE, \
+    .cache_frame_start = 1, \
+    .cache_frame_end = 250, \
+    .cache_readahead = 4, \
+  }
+
 #define _DNA_DEFAULT_ParticleInstanceModifierData \
   { \
     .psys = 1, \
@@ -2014,10 +2014,10 @@ typedef struct LaplacianDeformModifierData {
   char anchor_grp_name[64];
   int verts_num, repeat;
   float *vertexco;
-  /** Runtime only. */
-  void *cache_system;
   short flag;
-  char _pad[6];
+  /** Runtime only, for display. See #eLaplacianDeformSolverState. */
+  char solver_state;
+  char _pad[5];
 
 } LaplacianDeformModifierData;
 
@@ -2027,6 +2027,15 @@ enum {
   MOD_LAPLACIANDEFORM_INVERT_VGROUP = 1 << 1,
 };
 
+/** #LaplacianDeformModifierData.solver_state */
+typedef enum eLaplacianDeformSolverState {
+  MOD_LAPLACIANDEFORM_SOLVER_NONE = 0,
+  /** The system matrix was factorized in the last evaluation. */
+  MOD_LAPLACIANDEFORM_SOLVER_FACTORIZED = 1,
+  /** The last evaluation reused the factorization of a previous one. */
+  MOD_LAPLACIANDEFORM_SOLVER_CACHED = 2,
+} eLaplacianDeformSolverState;
+
 /**
  * \note many of these options match 'solidify'.
  */
@@ -2455,10 +2464,28 @@ typedef struct OpenMfxModifierData {
 
   /** MOD_OPENMFX_MAX_MESSAGE */
   char message[1024];
+
+  /** Bake cache. 1024 = FILE_MAX. */
+  char cache_directory[1024];
+  /** #eOpenMfxModifierFlag. */
+  int flag;
+  int cache_frame_start, cache_frame_end;
+  /** Number of frames to read ahead of the current one when playing back the cache. */
+  int cache_readahead;
 } OpenMfxModifierData;
 
 #define MOD_OPENMFX_MAX_MESSAGE 1024
 
+/** #OpenMfxModifierData.flag */
+typedef enum eOpenMfxModifierFlag {
+  /** Read cooked frames from the bake cache when available. */
+  MOD_OPENMFX_USE_CACHE = (1 << 0),
+  /** Set while the bake operator sweeps the frame range, cooked frames get written. */
+  MOD_OPENMFX_CACHE_BAKING = (1 << 1),
+  /** Set by the bake operator once the frame range is on disk, cleared when freeing the bake. */
+  MOD_OPENMFX_CACHED = (1 << 2),
+} eOpenMfxModifierFlag;
+
 #ifdef __cplusplus
 }
 #endif
@@ -263,6 +263,7 @@ SDNA_DEFAULT_DECL_STRUCT(MirrorModifierData);
 SDNA_DEFAULT_DECL_STRUCT(MultiresModifierData);
 SDNA_DEFAULT_DECL_STRUCT(NormalEditModifierData);
 SDNA_DEFAULT_DECL_STRUCT(OceanModifierData);
+SDNA_DEFAULT_DECL_STRUCT(OpenMfxModifierData);
 SDNA_DEFAULT_DECL_STRUCT(ParticleInstanceModifierData);
 SDNA_DEFAULT_DECL_STRUCT(ParticleSystemModifierData);
 SDNA_DEFAULT_DECL_STRUCT(RemeshModifierData);
@@ -503,6 +504,7 @@ const void *DNA_default_table[SDNA_TYPE_MAX] = {
     SDNA_DEFAULT_DECL(MultiresModifierData),
     SDNA_DEFAULT_DECL(NormalEditModifierData),
     SDNA_DEFAULT_DECL(OceanModifierData),
+    SDNA_DEFAULT_DECL(OpenMfxModifierData),
     SDNA_DEFAULT_DECL(ParticleInstanceModifierData),
     SDNA_DEFAULT_DECL(ParticleSystemModifierData),
     SDNA_DEFAULT_DECL(RemeshModifierData),
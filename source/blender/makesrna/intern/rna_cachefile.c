@@ -295,15 +295,17 @@ static void rna_def_cachefile(BlenderRNA *brna)
   RNA_def_property_ui_text(
       prop,
       "Use Prefetch",
-      "When enabled, the Cycles Procedural will preload animation data for faster updates");
+      "When enabled, animated meshes are read ahead of the current frame during playback, and "
+      "the Cycles Procedural will preload animation data for faster updates");
   RNA_def_property_update(prop, 0, "rna_CacheFile_update");
 
   prop = RNA_def_property(srna, "prefetch_cache_size", PROP_INT, PROP_UNSIGNED);
   RNA_def_property_ui_text(
       prop,
       "Prefetch Cache Size",
-      "Memory usage limit in megabytes for the Cycles Procedural cache, if the data does not "
-      "fit within the limit, rendering is aborted");
+      "Memory usage limit in megabytes for the data read ahead during playback and for the "
+      "Cycles Procedural cache, if the data does not fit within the limit, rendering is "
+      "aborted");
   RNA_def_property_update(prop, 0, "rna_CacheFile_update");
 
   /* ----------------- Axis Conversion ----------------- */
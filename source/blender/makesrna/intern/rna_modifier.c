@@ -6445,6 +6445,21 @@ static void rna_def_modifier_laplaciandeform(BlenderRNA *brna)
   StructRNA *srna;
   PropertyRNA *prop;
 
+  static const EnumPropertyItem solver_state_items[] = {
+      {MOD_LAPLACIANDEFORM_SOLVER_NONE, "NONE", 0, "None", "The system has not been solved"},
+      {MOD_LAPLACIANDEFORM_SOLVER_FACTORIZED,
+       "FACTORIZED",
+       0,
+       "Factorized",
+       "The system matrix was factorized in the last evaluation"},
+      {MOD_LAPLACIANDEFORM_SOLVER_CACHED,
+       "CACHED",
+       0,
+       "Cached",
+       "The last evaluation reused the factorization of the system matrix"},
+      {0, NULL, 0, NULL, NULL},
+  };
+
   srna = RNA_def_struct(brna, "LaplacianDeformModifier", "Modifier");
   RNA_def_struct_ui_text(srna, "Laplacian Deform Modifier", "Mesh deform modifier");
   RNA_def_struct_sdna(srna, "LaplacianDeformModifierData");
@@ -6470,6 +6485,12 @@ static void rna_def_modifier_laplaciandeform(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Bound", "Whether geometry has been bound to anchors");
   RNA_def_property_clear_flag(prop, PROP_EDITABLE);
 
+  prop = RNA_def_property(srna, "solver_state", PROP_ENUM, PROP_NONE);
+  RNA_def_property_enum_items(prop, solver_state_items);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_ui_text(
+      prop, "Solver State", "Whether the last evaluation had to factorize the system matrix");
+
   prop = RNA_def_property(srna, "invert_vertex_group", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "flag", MOD_LAPLACIANDEFORM_INVERT_VGROUP);
   RNA_def_property_ui_text(prop, "Invert", "Invert vertex group influence");
@@ -7779,6 +7800,46 @@ static void rna_def_modifier_openmfx(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Message", "");
   RNA_def_property_update(prop, 0, "rna_Modifier_update");
 
+  // Bake cache
+  RNA_define_lib_overridable(true);
+
+  prop = RNA_def_property(srna, "use_cache", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", MOD_OPENMFX_USE_CACHE);
+  RNA_def_property_ui_text(
+      prop, "Use Cache", "Read the cooked mesh from the bake cache when the frame was baked");
+  RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
+  prop = RNA_def_property(srna, "cache_directory", PROP_STRING, PROP_DIRPATH);
+  RNA_def_property_ui_text(
+      prop, "Cache Directory", "Path to a folder to store the baked frames");
+  RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
+  prop = RNA_def_property(srna, "cache_frame_start", PROP_INT, PROP_TIME);
+  RNA_def_property_range(prop, 0, MAXFRAME);
+  RNA_def_property_ui_text(prop, "Bake Start", "Start frame of the baking");
+  RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
+  prop = RNA_def_property(srna, "cache_frame_end", PROP_INT, PROP_TIME);
+  RNA_def_property_range(prop, 0, MAXFRAME);
+  RNA_def_property_ui_text(prop, "Bake End", "End frame of the baking");
+  RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
+  prop = RNA_def_property(srna, "cache_readahead", PROP_INT, PROP_NONE);
+  RNA_def_property_range(prop, 0, 64);
+  RNA_def_property_ui_text(
+      prop,
+      "Read Ahead",
+      "Number of baked frames loaded in the background ahead of the current one during playback");
+  RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
+  RNA_define_lib_overridable(false);
+
+  prop = RNA_def_property(srna, "is_cached", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", MOD_OPENMFX_CACHED);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_ui_text(
+      prop, "Is Cached", "Whether baked frames are available in the cache directory");
+
   // Related structs
   rna_def_modifier_openmfx_effect(brna);
   rna_def_modifier_openmfx_parameter(brna);
@@ -12,6 +12,7 @@
 #include "BLI_utildefines.h"
 
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #include "BLT_translation.h"
 
@@ -350,6 +351,99 @@ static void mesh_merge_transform(Mesh *result,
   }
 }
 
+typedef struct ArrayCopyData {
+  const Mesh *mesh;
+  Mesh *result;
+  /** Transformation of the copies starting at #copy_offsets_start. */
+  const float (*copy_offsets)[4][4];
+  int copy_offsets_start;
+  /** NULL when the normals are recalculated later. */
+  const float (*src_vert_normals)[3];
+  float (*dst_vert_normals)[3];
+  /** NULL when the UVs are not offset. */
+  const float *uv_offset;
+} ArrayCopyData;
+
+/**
+ * Fill in one copy of the source mesh, once the data and index offsets of every copy are known
+ * all copies are independent of each other.
+ */
+static void array_copy_cb(void *__restrict userdata,
+                          const int c,
+                          const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const ArrayCopyData *data = userdata;
+  const Mesh *mesh = data->mesh;
+  Mesh *result = data->result;
+  const int chunk_nverts = mesh->totvert;
+  const int chunk_nedges = mesh->totedge;
+  const int chunk_nloops = mesh->totloop;
+  const int chunk_npolys = mesh->totpoly;
+  const float(*current_offset)[4] = data->copy_offsets[c - data->copy_offsets_start];
+  MEdge *me;
+  MLoop *ml;
+  MPoly *mp;
+  int i;
+
+  /* copy customdata to new geometry */
+  CustomData_copy_data(&mesh->vdata, &result->vdata, 0, c * chunk_nverts, chunk_nverts);
+  CustomData_copy_data(&mesh->edata, &result->edata, 0, c * chunk_nedges, chunk_nedges);
+  CustomData_copy_data(&mesh->ldata, &result->ldata, 0, c * chunk_nloops, chunk_nloops);
+  CustomData_copy_data(&mesh->pdata, &result->pdata, 0, c * chunk_npolys, chunk_npolys);
+
+  const int vert_offset = c * chunk_nverts;
+
+  /* apply offset to all new verts */
+  for (i = 0; i < chunk_nverts; i++) {
+    const int i_dst = vert_offset + i;
+    mul_m4_v3(current_offset, result->mvert[i_dst].co);
+
+    /* We have to correct normals too, if we do not tag them as dirty! */
+    if (data->src_vert_normals) {
+      copy_v3_v3(data->dst_vert_normals[i_dst], data->src_vert_normals[i]);
+      mul_mat3_m4_v3(current_offset, data->dst_vert_normals[i_dst]);
+      normalize_v3(data->dst_vert_normals[i_dst]);
+    }
+  }
+
+  /* adjust edge vertex indices */
+  me = result->medge + c * chunk_nedges;
+  for (i = 0; i < chunk_nedges; i++, me++) {
+    me->v1 += c * chunk_nverts;
+    me->v2 += c * chunk_nverts;
+  }
+
+  mp = result->mpoly + c * chunk_npolys;
+  for (i = 0; i < chunk_npolys; i++, mp++) {
+    mp->loopstart += c * chunk_nloops;
+  }
+
+  /* adjust loop vertex and edge indices */
+  ml = result->mloop + c * chunk_nloops;
+  for (i = 0; i < chunk_nloops; i++, ml++) {
+    ml->v += c * chunk_nverts;
+    ml->e += c * chunk_nedges;
+  }
+
+  /* handle UVs */
+  if (data->uv_offset) {
+    const float uv_offset[2] = {
+        data->uv_offset[0] * (float)c,
+        data->uv_offset[1] * (float)c,
+    };
+    const int totuv = CustomData_number_of_layers(&result->ldata, CD_MLOOPUV);
+    for (i = 0; i < totuv; i++) {
+      MLoopUV *dmloopuv = CustomData_get_layer_n(&result->ldata, CD_MLOOPUV, i);
+      dmloopuv += c * chunk_nloops;
+      int l_index = chunk_nloops;
+      for (; l_index-- != 0; dmloopuv++) {
+        dmloopuv->uv[0] += uv_offset[0];
+        dmloopuv->uv[1] += uv_offset[1];
+      }
+    }
+  }
+}
+
 static Mesh *arrayModifier_doArray(ArrayModifierData *amd,
                                    const ModifierEvalContext *ctx,
                                    Mesh *mesh)
@@ -357,9 +451,6 @@ static Mesh *arrayModifier_doArray(ArrayModifierData *amd,
   const MVert *src_mvert;
   MVert *result_dm_verts;
 
-  MEdge *me;
-  MLoop *ml;
-  MPoly *mp;
   int i, j, c, count;
   float length = amd->length;
   /* offset matrix */
@@ -570,7 +661,6 @@ static Mesh *arrayModifier_doArray(ArrayModifierData *amd,
   first_chunk_start = 0;
   first_chunk_nverts = chunk_nverts;
 
-  unit_m4(current_offset);
   const float(*src_vert_normals)[3] = NULL;
   float(*dst_vert_normals)[3] = NULL;
   if (!use_recalc_normals) {
@@ -579,107 +669,84 @@ static Mesh *arrayModifier_doArray(ArrayModifierData *amd,
     BKE_mesh_vertex_normals_clear_dirty(result);
   }
 
-  for (c = 1; c < count; c++) {
-    /* copy customdata to new geometry */
-    CustomData_copy_data(&mesh->vdata, &result->vdata, 0, c * chunk_nverts, chunk_nverts);
-    CustomData_copy_data(&mesh->edata, &result->edata, 0, c * chunk_nedges, chunk_nedges);
-    CustomData_copy_data(&mesh->ldata, &result->ldata, 0, c * chunk_nloops, chunk_nloops);
-    CustomData_copy_data(&mesh->pdata, &result->pdata, 0, c * chunk_npolys, chunk_npolys);
-
-    const int vert_offset = c * chunk_nverts;
-
-    /* recalculate cumulative offset here */
-    mul_m4_m4m4(current_offset, current_offset, offset);
-
-    /* apply offset to all new verts */
-    for (i = 0; i < chunk_nverts; i++) {
-      const int i_dst = vert_offset + i;
-      mul_m4_v3(current_offset, result_dm_verts[i_dst].co);
-
-      /* We have to correct normals too, if we do not tag them as dirty! */
-      if (!use_recalc_normals) {
-        copy_v3_v3(dst_vert_normals[i_dst], src_vert_normals[i]);
-        mul_mat3_m4_v3(current_offset, dst_vert_normals[i_dst]);
-        normalize_v3(dst_vert_normals[i_dst]);
+  unit_m4(current_offset);
+  if (count > 1) {
+    /* The copies are generated in parallel, in batches to bound the memory used for their
+     * cumulative offsets. */
+    const int batch_size = 4096;
+    float(*copy_offsets)[4][4] = MEM_malloc_arrayN(
+        min_ii(count - 1, batch_size), sizeof(*copy_offsets), __func__);
+
+    ArrayCopyData data = {
+        .mesh = mesh,
+        .result = result,
+        .copy_offsets = (const float(*)[4][4])copy_offsets,
+        .src_vert_normals = src_vert_normals,
+        .dst_vert_normals = dst_vert_normals,
+        .uv_offset = (chunk_nloops > 0 && is_zero_v2(amd->uv_offset) == false) ? amd->uv_offset :
+                                                                                 NULL,
+    };
+
+    /* Group copies of small meshes, so each task handles a reasonable amount of elements. */
+    const int chunk_elems_num = max_ii(1, chunk_nverts + chunk_nedges + chunk_nloops);
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = max_ii(1, 4096 / chunk_elems_num);
+
+    for (int batch_start = 1; batch_start < count; batch_start += batch_size) {
+      const int batch_end = min_ii(batch_start + batch_size, count);
+
+      /* recalculate cumulative offset here */
+      for (c = batch_start; c < batch_end; c++) {
+        mul_m4_m4m4(current_offset, current_offset, offset);
+        copy_m4_m4(copy_offsets[c - batch_start], current_offset);
       }
-    }
 
-    /* adjust edge vertex indices */
-    me = result->medge + c * chunk_nedges;
-    for (i = 0; i < chunk_nedges; i++, me++) {
-      me->v1 += c * chunk_nverts;
-      me->v2 += c * chunk_nverts;
+      data.copy_offsets_start = batch_start;
+      settings.use_threading = ((size_t)(batch_end - batch_start) * (size_t)chunk_elems_num) >
+                               4096;
+      BLI_task_parallel_range(batch_start, batch_end, &data, array_copy_cb, &settings);
     }
 
-    mp = result->mpoly + c * chunk_npolys;
-    for (i = 0; i < chunk_npolys; i++, mp++) {
-      mp->loopstart += c * chunk_nloops;
-    }
-
-    /* adjust loop vertex and edge indices */
-    ml = result->mloop + c * chunk_nloops;
-    for (i = 0; i < chunk_nloops; i++, ml++) {
-      ml->v += c * chunk_nverts;
-      ml->e += c * chunk_nedges;
-    }
+    MEM_freeN(copy_offsets);
+  }
 
-    /* Handle merge between chunk n and n-1 */
-    if (use_merge && (c >= 1)) {
-      if (!offset_has_scale && (c >= 2)) {
-        /* Mapping chunk 3 to chunk 2 is a translation of mapping 2 to 1
-         * ... that is except if scaling makes the distance grow */
-        int k;
-        int this_chunk_index = c * chunk_nverts;
-        int prev_chunk_index = (c - 1) * chunk_nverts;
-        for (k = 0; k < chunk_nverts; k++, this_chunk_index++, prev_chunk_index++) {
-          int target = full_doubles_map[prev_chunk_index];
-          if (target != -1) {
-            target += chunk_nverts; /* translate mapping */
-            while (target != -1 && !ELEM(full_doubles_map[target], -1, target)) {
-              /* If target is already mapped, we only follow that mapping if final target remains
-               * close enough from current vert (otherwise no mapping at all). */
-              if (compare_len_v3v3(result_dm_verts[this_chunk_index].co,
-                                   result_dm_verts[full_doubles_map[target]].co,
-                                   amd->merge_dist)) {
-                target = full_doubles_map[target];
-              }
-              else {
-                target = -1;
-              }
+  /* Handle merge between chunk n and n-1, each mapping depends on the previous one. */
+  for (c = 1; use_merge && (c < count); c++) {
+    if (!offset_has_scale && (c >= 2)) {
+      /* Mapping chunk 3 to chunk 2 is a translation of mapping 2 to 1
+       * ... that is except if scaling makes the distance grow */
+      int k;
+      int this_chunk_index = c * chunk_nverts;
+      int prev_chunk_index = (c - 1) * chunk_nverts;
+      for (k = 0; k < chunk_nverts; k++, this_chunk_index++, prev_chunk_index++) {
+        int target = full_doubles_map[prev_chunk_index];
+        if (target != -1) {
+          target += chunk_nverts; /* translate mapping */
+          while (target != -1 && !ELEM(full_doubles_map[target], -1, target)) {
+            /* If target is already mapped, we only follow that mapping if final target remains
+             * close enough from current vert (otherwise no mapping at all). */
+            if (compare_len_v3v3(result_dm_verts[this_chunk_index].co,
+                                 result_dm_verts[full_doubles_map[target]].co,
+                                 amd->merge_dist)) {
+              target = full_doubles_map[target];
+            }
+            else {
+              target = -1;
             }
           }
-          full_doubles_map[this_chunk_index] = target;
         }
-      }
-      else {
-        dm_mvert_map_doubles(full_doubles_map,
-                             result_dm_verts,
-                             (c - 1) * chunk_nverts,
-                             chunk_nverts,
-                             c * chunk_nverts,
-                             chunk_nverts,
-                             amd->merge_dist);
+        full_doubles_map[this_chunk_index] = target;
       }
     }
-  }
-
-  /* handle UVs */
-  if (chunk_nloops > 0 && is_zero_v2(amd->uv_offset) == false) {
-    const int totuv = CustomData_number_of_layers(&result->ldata, CD_MLOOPUV);
-    for (i = 0; i < totuv; i++) {
-      MLoopUV *dmloopuv = CustomData_get_layer_n(&result->ldata, CD_MLOOPUV, i);
-      dmloopuv += chunk_nloops;
-      for (c = 1; c < count; c++) {
-        const float uv_offset[2] = {
-            amd->uv_offset[0] * (float)c,
-            amd->uv_offset[1] * (float)c,
-        };
-        int l_index = chunk_nloops;
-        for (; l_index-- != 0; dmloopuv++) {
-          dmloopuv->uv[0] += uv_offset[0];
-          dmloopuv->uv[1] += uv_offset[1];
-        }
-      }
+    else {
+      dm_mvert_map_doubles(full_doubles_map,
+                           result_dm_verts,
+                           (c - 1) * chunk_nverts,
+                           chunk_nverts,
+                           c * chunk_nverts,
+                           chunk_nverts,
+                           amd->merge_dist);
     }
   }
 
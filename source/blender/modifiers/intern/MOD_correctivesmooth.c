@@ -10,6 +10,7 @@
 #include "BLI_utildefines.h"
 
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #include "BLT_translation.h"
 
@@ -27,6 +28,7 @@
 #include "BKE_editmesh.h"
 #include "BKE_lib_id.h"
 #include "BKE_mesh.h"
+#include "BKE_mesh_mapping.h"
 #include "BKE_mesh_wrapper.h"
 #include "BKE_screen.h"
 
@@ -37,6 +39,7 @@
 #include "RNA_prototypes.h"
 
 #include "MOD_modifiertypes.h"
+#include "MOD_smooth_util.h"
 #include "MOD_ui_common.h"
 #include "MOD_util.h"
 
@@ -90,10 +93,18 @@ static void freeBind(CorrectiveSmoothModifierData *csmd)
   csmd->bind_coords_num = 0;
 }
 
+static void freeRuntimeData(void *runtime_data_v)
+{
+  MOD_smooth_vert_map_free(runtime_data_v);
+}
+
 static void freeData(ModifierData *md)
 {
   CorrectiveSmoothModifierData *csmd = (CorrectiveSmoothModifierData *)md;
   freeBind(csmd);
+
+  freeRuntimeData(md->runtime);
+  md->runtime = NULL;
 }
 
 static void requiredDataMask(Object *UNUSED(ob),
@@ -162,181 +173,6 @@ static void mesh_get_boundaries(Mesh *mesh, float *smooth_weights)
   MEM_freeN(boundaries);
 }
 
-/* -------------------------------------------------------------------- */
-/* Simple Weighted Smoothing
- *
- * (average of surrounding verts)
- */
-static void smooth_iter__simple(CorrectiveSmoothModifierData *csmd,
-                                Mesh *mesh,
-                                float (*vertexCos)[3],
-                                uint verts_num,
-                                const float *smooth_weights,
-                                uint iterations)
-{
-  const float lambda = csmd->lambda;
-  uint i;
-
-  const uint edges_num = (uint)mesh->totedge;
-  const MEdge *edges = mesh->medge;
-  float *vertex_edge_count_div;
-
-  struct SmoothingData_Simple {
-    float delta[3];
-  } *smooth_data = MEM_calloc_arrayN(verts_num, sizeof(*smooth_data), __func__);
-
-  vertex_edge_count_div = MEM_calloc_arrayN(verts_num, sizeof(float), __func__);
-
-  /* calculate as floats to avoid int->float conversion in #smooth_iter */
-  for (i = 0; i < edges_num; i++) {
-    vertex_edge_count_div[edges[i].v1] += 1.0f;
-    vertex_edge_count_div[edges[i].v2] += 1.0f;
-  }
-
-  /* a little confusing, but we can include 'lambda' and smoothing weight
-   * here to avoid multiplying for every iteration */
-  if (smooth_weights == NULL) {
-    for (i = 0; i < verts_num; i++) {
-      vertex_edge_count_div[i] = lambda * (vertex_edge_count_div[i] ?
-                                               (1.0f / vertex_edge_count_div[i]) :
-                                               1.0f);
-    }
-  }
-  else {
-    for (i = 0; i < verts_num; i++) {
-      vertex_edge_count_div[i] = smooth_weights[i] * lambda *
-                                 (vertex_edge_count_div[i] ? (1.0f / vertex_edge_count_div[i]) :
-                                                             1.0f);
-    }
-  }
-
-  /* -------------------------------------------------------------------- */
-  /* Main Smoothing Loop */
-
-  while (iterations--) {
-    for (i = 0; i < edges_num; i++) {
-      struct SmoothingData_Simple *sd_v1;
-      struct SmoothingData_Simple *sd_v2;
-      float edge_dir[3];
-
-      sub_v3_v3v3(edge_dir, vertexCos[edges[i].v2], vertexCos[edges[i].v1]);
-
-      sd_v1 = &smooth_data[edges[i].v1];
-      sd_v2 = &smooth_data[edges[i].v2];
-
-      add_v3_v3(sd_v1->delta, edge_dir);
-      sub_v3_v3(sd_v2->delta, edge_dir);
-    }
-
-    for (i = 0; i < verts_num; i++) {
-      struct SmoothingData_Simple *sd = &smooth_data[i];
-      madd_v3_v3fl(vertexCos[i], sd->delta, vertex_edge_count_div[i]);
-      /* zero for the next iteration (saves memset on entire array) */
-      memset(sd, 0, sizeof(*sd));
-    }
-  }
-
-  MEM_freeN(vertex_edge_count_div);
-  MEM_freeN(smooth_data);
-}
-
-/* -------------------------------------------------------------------- */
-/* Edge-Length Weighted Smoothing
- */
-static void smooth_iter__length_weight(CorrectiveSmoothModifierData *csmd,
-                                       Mesh *mesh,
-                                       float (*vertexCos)[3],
-                                       uint verts_num,
-                                       const float *smooth_weights,
-                                       uint iterations)
-{
-  const float eps = FLT_EPSILON * 10.0f;
-  const uint edges_num = (uint)mesh->totedge;
-  /* NOTE: the way this smoothing method works, its approx half as strong as the simple-smooth,
-   * and 2.0 rarely spikes, double the value for consistent behavior. */
-  const float lambda = csmd->lambda * 2.0f;
-  const MEdge *edges = mesh->medge;
-  float *vertex_edge_count;
-  uint i;
-
-  struct SmoothingData_Weighted {
-    float delta[3];
-    float edge_length_sum;
-  } *smooth_data = MEM_calloc_arrayN(verts_num, sizeof(*smooth_data), __func__);
-
-  /* calculate as floats to avoid int->float conversion in #smooth_iter */
-  vertex_edge_count = MEM_calloc_arrayN(verts_num, sizeof(float), __func__);
-  for (i = 0; i < edges_num; i++) {
-    vertex_edge_count[edges[i].v1] += 1.0f;
-    vertex_edge_count[edges[i].v2] += 1.0f;
-  }
-
-  /* -------------------------------------------------------------------- */
-  /* Main Smoothing Loop */
-
-  while (iterations--) {
-    for (i = 0; i < edges_num; i++) {
-      struct SmoothingData_Weighted *sd_v1;
-      struct SmoothingData_Weighted *sd_v2;
-      float edge_dir[3];
-      float edge_dist;
-
-      sub_v3_v3v3(edge_dir, vertexCos[edges[i].v2], vertexCos[edges[i].v1]);
-      edge_dist = len_v3(edge_dir);
-
-      /* weight by distance */
-      mul_v3_fl(edge_dir, edge_dist);
-
-      sd_v1 = &smooth_data[edges[i].v1];
-      sd_v2 = &smooth_data[edges[i].v2];
-
-      add_v3_v3(sd_v1->delta, edge_dir);
-      sub_v3_v3(sd_v2->delta, edge_dir);
-
-      sd_v1->edge_length_sum += edge_dist;
-      sd_v2->edge_length_sum += edge_dist;
-    }
-
-    if (smooth_weights == NULL) {
-      /* fast-path */
-      for (i = 0; i < verts_num; i++) {
-        struct SmoothingData_Weighted *sd = &smooth_data[i];
-        /* Divide by sum of all neighbor distances (weighted) and amount of neighbors,
-         * (mean average). */
-        const float div = sd->edge_length_sum * vertex_edge_count[i];
-        if (div > eps) {
-#if 0
-          /* first calculate the new location */
-          mul_v3_fl(sd->delta, 1.0f / div);
-          /* then interpolate */
-          madd_v3_v3fl(vertexCos[i], sd->delta, lambda);
-#else
-          /* do this in one step */
-          madd_v3_v3fl(vertexCos[i], sd->delta, lambda / div);
-#endif
-        }
-        /* zero for the next iteration (saves memset on entire array) */
-        memset(sd, 0, sizeof(*sd));
-      }
-    }
-    else {
-      for (i = 0; i < verts_num; i++) {
-        struct SmoothingData_Weighted *sd = &smooth_data[i];
-        const float div = sd->edge_length_sum * vertex_edge_count[i];
-        if (div > eps) {
-          const float lambda_w = lambda * smooth_weights[i];
-          madd_v3_v3fl(vertexCos[i], sd->delta, lambda_w / div);
-        }
-
-        memset(sd, 0, sizeof(*sd));
-      }
-    }
-  }
-
-  MEM_freeN(vertex_edge_count);
-  MEM_freeN(smooth_data);
-}
-
 static void smooth_iter(CorrectiveSmoothModifierData *csmd,
                         Mesh *mesh,
                         float (*vertexCos)[3],
@@ -344,16 +180,29 @@ static void smooth_iter(CorrectiveSmoothModifierData *csmd,
                         const float *smooth_weights,
                         uint iterations)
 {
+  ModSmoothParams params = {
+      .iterations = (int)iterations,
+      .vert_factors = smooth_weights,
+      .axis_mask = (1 << 0) | (1 << 1) | (1 << 2),
+  };
+
   switch (csmd->smooth_type) {
     case MOD_CORRECTIVESMOOTH_SMOOTH_LENGTH_WEIGHT:
-      smooth_iter__length_weight(csmd, mesh, vertexCos, verts_num, smooth_weights, iterations);
+      params.weight = MOD_SMOOTH_WEIGHT_EDGE_LENGTH;
+      /* NOTE: the way this smoothing method works, its approx half as strong as the simple-smooth,
+       * and 2.0 rarely spikes, double the value for consistent behavior. */
+      params.factor = csmd->lambda * 2.0f;
       break;
 
     /* case MOD_CORRECTIVESMOOTH_SMOOTH_SIMPLE: */
     default:
-      smooth_iter__simple(csmd, mesh, vertexCos, verts_num, smooth_weights, iterations);
+      params.weight = MOD_SMOOTH_WEIGHT_UNIFORM;
+      params.factor = csmd->lambda;
       break;
   }
+
+  const MeshElemMap *vert_map = MOD_smooth_vert_map_ensure(&csmd->modifier, mesh);
+  MOD_smooth_vert_coords(vert_map, vertexCos, (int)verts_num, &params);
 }
 
 static void smooth_verts(CorrectiveSmoothModifierData *csmd,
@@ -513,6 +362,48 @@ static bool cache_settings_equal(CorrectiveSmoothModifierData *csmd)
           csmd->delta_cache.rest_source == csmd->rest_source);
 }
 
+typedef struct CorrectiveSmoothDeltaData {
+  float (*tangent_spaces)[3][3];
+  const float (*rest_coords)[3];
+  const float (*smooth_coords)[3];
+  float (*deltas)[3];
+  float (*vertexCos)[3];
+  float scale;
+} CorrectiveSmoothDeltaData;
+
+static void calc_deltas_cb(void *__restrict userdata,
+                           const int i,
+                           const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const CorrectiveSmoothDeltaData *data = userdata;
+  float imat[3][3], delta[3];
+
+#ifdef USE_TANGENT_CALC_INLINE
+  calc_tangent_ortho(data->tangent_spaces[i]);
+#endif
+
+  sub_v3_v3v3(delta, data->rest_coords[i], data->smooth_coords[i]);
+  if (UNLIKELY(!invert_m3_m3(imat, data->tangent_spaces[i]))) {
+    transpose_m3_m3(imat, data->tangent_spaces[i]);
+  }
+  mul_v3_m3v3(data->deltas[i], imat, delta);
+}
+
+static void apply_deltas_cb(void *__restrict userdata,
+                            const int i,
+                            const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const CorrectiveSmoothDeltaData *data = userdata;
+  float delta[3];
+
+#ifdef USE_TANGENT_CALC_INLINE
+  calc_tangent_ortho(data->tangent_spaces[i]);
+#endif
+
+  mul_v3_m3v3(delta, data->tangent_spaces[i], data->deltas[i]);
+  madd_v3_v3fl(data->vertexCos[i], delta, data->scale);
+}
+
 /**
  * This calculates #CorrectiveSmoothModifierData.delta_cache
  * It's not run on every update (during animation for example).
@@ -526,7 +417,6 @@ static void calc_deltas(CorrectiveSmoothModifierData *csmd,
 {
   float(*smooth_vertex_coords)[3] = MEM_dupallocN(rest_coords);
   float(*tangent_spaces)[3][3];
-  uint i;
 
   tangent_spaces = MEM_calloc_arrayN(verts_num, sizeof(float[3][3]), __func__);
 
@@ -544,19 +434,16 @@ static void calc_deltas(CorrectiveSmoothModifierData *csmd,
 
   calc_tangent_spaces(mesh, smooth_vertex_coords, tangent_spaces);
 
-  for (i = 0; i < verts_num; i++) {
-    float imat[3][3], delta[3];
-
-#ifdef USE_TANGENT_CALC_INLINE
-    calc_tangent_ortho(tangent_spaces[i]);
-#endif
-
-    sub_v3_v3v3(delta, rest_coords[i], smooth_vertex_coords[i]);
-    if (UNLIKELY(!invert_m3_m3(imat, tangent_spaces[i]))) {
-      transpose_m3_m3(imat, tangent_spaces[i]);
-    }
-    mul_v3_m3v3(csmd->delta_cache.deltas[i], imat, delta);
-  }
+  CorrectiveSmoothDeltaData data = {
+      .tangent_spaces = tangent_spaces,
+      .rest_coords = rest_coords,
+      .smooth_coords = (const float(*)[3])smooth_vertex_coords,
+      .deltas = csmd->delta_cache.deltas,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, (int)verts_num, &data, calc_deltas_cb, &settings);
 
   MEM_freeN(tangent_spaces);
   MEM_freeN(smooth_vertex_coords);
@@ -688,8 +575,6 @@ static void correctivesmooth_modifier_do(ModifierData *md,
   smooth_verts(csmd, mesh, dvert, defgrp_index, vertexCos, verts_num);
 
   {
-    uint i;
-
     float(*tangent_spaces)[3][3];
     const float scale = csmd->scale;
     /* calloc, since values are accumulated */
@@ -697,16 +582,16 @@ static void correctivesmooth_modifier_do(ModifierData *md,
 
     calc_tangent_spaces(mesh, vertexCos, tangent_spaces);
 
-    for (i = 0; i < verts_num; i++) {
-      float delta[3];
-
-#ifdef USE_TANGENT_CALC_INLINE
-      calc_tangent_ortho(tangent_spaces[i]);
-#endif
-
-      mul_v3_m3v3(delta, tangent_spaces[i], csmd->delta_cache.deltas[i]);
-      madd_v3_v3fl(vertexCos[i], delta, scale);
-    }
+    CorrectiveSmoothDeltaData data = {
+        .tangent_spaces = tangent_spaces,
+        .deltas = csmd->delta_cache.deltas,
+        .vertexCos = vertexCos,
+        .scale = scale,
+    };
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = 1024;
+    BLI_task_parallel_range(0, (int)verts_num, &data, apply_deltas_cb, &settings);
 
     MEM_freeN(tangent_spaces);
   }
@@ -861,7 +746,7 @@ ModifierTypeInfo modifierType_CorrectiveSmooth = {
     /* dependsOnNormals */ NULL,
     /* foreachIDLink */ NULL,
     /* foreachTexLink */ NULL,
-    /* freeRuntimeData */ NULL,
+    /* freeRuntimeData */ freeRuntimeData,
     /* panelRegister */ panelRegister,
     /* blendWrite */ blendWrite,
     /* blendRead */ blendRead,
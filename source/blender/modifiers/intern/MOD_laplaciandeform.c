@@ -9,6 +9,7 @@
 
 #include "BLI_math.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_utildefines_stack.h"
 
 #include "MEM_guardedalloc.h"
@@ -31,6 +32,8 @@
 #include "BKE_particle.h"
 #include "BKE_screen.h"
 
+#include "DEG_depsgraph_query.h"
+
 #include "UI_interface.h"
 #include "UI_resources.h"
 
@@ -299,107 +302,141 @@ static void initLaplacianMatrix(LaplacianSystem *sys)
   }
 }
 
-static void computeImplictRotations(LaplacianSystem *sys)
+static void laplacian_parallel_range_settings(const LaplacianSystem *sys,
+                                              TaskParallelSettings *settings)
+{
+  BLI_parallel_range_settings_defaults(settings);
+  settings->use_threading = (sys->verts_num > 1024);
+  settings->min_iter_per_thread = 1024;
+}
+
+static void computeImplictRotations_cb(void *__restrict userdata,
+                                       const int i,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
 {
+  LaplacianSystem *sys = userdata;
   int vid, *vidn = NULL;
   float minj, mjt, qj[3], vj[3];
-  int i, j, ln;
-
-  for (i = 0; i < sys->verts_num; i++) {
-    normalize_v3(sys->no[i]);
-    vidn = sys->ringv_map[i].indices;
-    ln = sys->ringv_map[i].count;
-    minj = 1000000.0f;
-    for (j = 0; j < ln; j++) {
-      vid = vidn[j];
-      copy_v3_v3(qj, sys->co[vid]);
-      sub_v3_v3v3(vj, qj, sys->co[i]);
-      normalize_v3(vj);
-      mjt = fabsf(dot_v3v3(vj, sys->no[i]));
-      if (mjt < minj) {
-        minj = mjt;
-        sys->unit_verts[i] = vidn[j];
-      }
+  int j, ln;
+
+  normalize_v3(sys->no[i]);
+  vidn = sys->ringv_map[i].indices;
+  ln = sys->ringv_map[i].count;
+  minj = 1000000.0f;
+  for (j = 0; j < ln; j++) {
+    vid = vidn[j];
+    copy_v3_v3(qj, sys->co[vid]);
+    sub_v3_v3v3(vj, qj, sys->co[i]);
+    normalize_v3(vj);
+    mjt = fabsf(dot_v3v3(vj, sys->no[i]));
+    if (mjt < minj) {
+      minj = mjt;
+      sys->unit_verts[i] = vidn[j];
     }
   }
 }
 
-static void rotateDifferentialCoordinates(LaplacianSystem *sys)
+static void computeImplictRotations(LaplacianSystem *sys)
+{
+  TaskParallelSettings settings;
+  laplacian_parallel_range_settings(sys, &settings);
+  BLI_task_parallel_range(0, sys->verts_num, sys, computeImplictRotations_cb, &settings);
+}
+
+/**
+ * Only called once the system has been solved, every vertex adds to its own right hand side
+ * entries, so vertices can be handled in parallel.
+ */
+static void rotateDifferentialCoordinates_cb(void *__restrict userdata,
+                                             const int i,
+                                             const TaskParallelTLS *__restrict UNUSED(tls))
 {
+  LaplacianSystem *sys = userdata;
   float alpha, beta, gamma;
   float pj[3], ni[3], di[3];
   float uij[3], dun[3], e2[3], pi[3], fni[3], vn[3][3];
-  int i, j, fidn_num, k, fi;
+  int j, fidn_num, k, fi;
   int *fidn;
 
-  for (i = 0; i < sys->verts_num; i++) {
-    copy_v3_v3(pi, sys->co[i]);
-    copy_v3_v3(ni, sys->no[i]);
-    k = sys->unit_verts[i];
-    copy_v3_v3(pj, sys->co[k]);
-    sub_v3_v3v3(uij, pj, pi);
-    mul_v3_v3fl(dun, ni, dot_v3v3(uij, ni));
-    sub_v3_v3(uij, dun);
-    normalize_v3(uij);
-    cross_v3_v3v3(e2, ni, uij);
-    copy_v3_v3(di, sys->delta[i]);
-    alpha = dot_v3v3(ni, di);
-    beta = dot_v3v3(uij, di);
-    gamma = dot_v3v3(e2, di);
-
-    pi[0] = EIG_linear_solver_variable_get(sys->context, 0, i);
-    pi[1] = EIG_linear_solver_variable_get(sys->context, 1, i);
-    pi[2] = EIG_linear_solver_variable_get(sys->context, 2, i);
-    zero_v3(ni);
-    fidn_num = sys->ringf_map[i].count;
-    for (fi = 0; fi < fidn_num; fi++) {
-      const uint *vin;
-      fidn = sys->ringf_map[i].indices;
-      vin = sys->tris[fidn[fi]];
-      for (j = 0; j < 3; j++) {
-        vn[j][0] = EIG_linear_solver_variable_get(sys->context, 0, vin[j]);
-        vn[j][1] = EIG_linear_solver_variable_get(sys->context, 1, vin[j]);
-        vn[j][2] = EIG_linear_solver_variable_get(sys->context, 2, vin[j]);
-        if (vin[j] == sys->unit_verts[i]) {
-          copy_v3_v3(pj, vn[j]);
-        }
+  copy_v3_v3(pi, sys->co[i]);
+  copy_v3_v3(ni, sys->no[i]);
+  k = sys->unit_verts[i];
+  copy_v3_v3(pj, sys->co[k]);
+  sub_v3_v3v3(uij, pj, pi);
+  mul_v3_v3fl(dun, ni, dot_v3v3(uij, ni));
+  sub_v3_v3(uij, dun);
+  normalize_v3(uij);
+  cross_v3_v3v3(e2, ni, uij);
+  copy_v3_v3(di, sys->delta[i]);
+  alpha = dot_v3v3(ni, di);
+  beta = dot_v3v3(uij, di);
+  gamma = dot_v3v3(e2, di);
+
+  pi[0] = EIG_linear_solver_variable_get(sys->context, 0, i);
+  pi[1] = EIG_linear_solver_variable_get(sys->context, 1, i);
+  pi[2] = EIG_linear_solver_variable_get(sys->context, 2, i);
+  zero_v3(ni);
+  fidn_num = sys->ringf_map[i].count;
+  for (fi = 0; fi < fidn_num; fi++) {
+    const uint *vin;
+    fidn = sys->ringf_map[i].indices;
+    vin = sys->tris[fidn[fi]];
+    for (j = 0; j < 3; j++) {
+      vn[j][0] = EIG_linear_solver_variable_get(sys->context, 0, vin[j]);
+      vn[j][1] = EIG_linear_solver_variable_get(sys->context, 1, vin[j]);
+      vn[j][2] = EIG_linear_solver_variable_get(sys->context, 2, vin[j]);
+      if (vin[j] == sys->unit_verts[i]) {
+        copy_v3_v3(pj, vn[j]);
       }
-
-      normal_tri_v3(fni, UNPACK3(vn));
-      add_v3_v3(ni, fni);
     }
 
-    normalize_v3(ni);
-    sub_v3_v3v3(uij, pj, pi);
-    mul_v3_v3fl(dun, ni, dot_v3v3(uij, ni));
-    sub_v3_v3(uij, dun);
-    normalize_v3(uij);
-    cross_v3_v3v3(e2, ni, uij);
-    fni[0] = alpha * ni[0] + beta * uij[0] + gamma * e2[0];
-    fni[1] = alpha * ni[1] + beta * uij[1] + gamma * e2[1];
-    fni[2] = alpha * ni[2] + beta * uij[2] + gamma * e2[2];
-
-    if (len_squared_v3(fni) > FLT_EPSILON) {
-      EIG_linear_solver_right_hand_side_add(sys->context, 0, i, fni[0]);
-      EIG_linear_solver_right_hand_side_add(sys->context, 1, i, fni[1]);
-      EIG_linear_solver_right_hand_side_add(sys->context, 2, i, fni[2]);
-    }
-    else {
-      EIG_linear_solver_right_hand_side_add(sys->context, 0, i, sys->delta[i][0]);
-      EIG_linear_solver_right_hand_side_add(sys->context, 1, i, sys->delta[i][1]);
-      EIG_linear_solver_right_hand_side_add(sys->context, 2, i, sys->delta[i][2]);
-    }
+    normal_tri_v3(fni, UNPACK3(vn));
+    add_v3_v3(ni, fni);
+  }
+
+  normalize_v3(ni);
+  sub_v3_v3v3(uij, pj, pi);
+  mul_v3_v3fl(dun, ni, dot_v3v3(uij, ni));
+  sub_v3_v3(uij, dun);
+  normalize_v3(uij);
+  cross_v3_v3v3(e2, ni, uij);
+  fni[0] = alpha * ni[0] + beta * uij[0] + gamma * e2[0];
+  fni[1] = alpha * ni[1] + beta * uij[1] + gamma * e2[1];
+  fni[2] = alpha * ni[2] + beta * uij[2] + gamma * e2[2];
+
+  if (len_squared_v3(fni) > FLT_EPSILON) {
+    EIG_linear_solver_right_hand_side_add(sys->context, 0, i, fni[0]);
+    EIG_linear_solver_right_hand_side_add(sys->context, 1, i, fni[1]);
+    EIG_linear_solver_right_hand_side_add(sys->context, 2, i, fni[2]);
   }
+  else {
+    EIG_linear_solver_right_hand_side_add(sys->context, 0, i, sys->delta[i][0]);
+    EIG_linear_solver_right_hand_side_add(sys->context, 1, i, sys->delta[i][1]);
+    EIG_linear_solver_right_hand_side_add(sys->context, 2, i, sys->delta[i][2]);
+  }
+}
+
+static void rotateDifferentialCoordinates(LaplacianSystem *sys)
+{
+  TaskParallelSettings settings;
+  laplacian_parallel_range_settings(sys, &settings);
+  BLI_task_parallel_range(0, sys->verts_num, sys, rotateDifferentialCoordinates_cb, &settings);
 }
 
-static void laplacianDeformPreview(LaplacianSystem *sys, float (*vertexCos)[3])
+static void laplacianDeformPreview(LaplacianSystem *sys,
+                                   float (*vertexCos)[3],
+                                   char *r_solver_state)
 {
   int vid, i, j, n, na;
   n = sys->verts_num;
   na = sys->anchors_num;
+  *r_solver_state = MOD_LAPLACIANDEFORM_SOLVER_NONE;
 
   if (!sys->is_matrix_computed) {
     sys->context = EIG_linear_least_squares_solver_new(n + na, n, 3);
+    /* The normal equations of the Laplacian system are symmetric positive definite as long as
+     * there are anchors, the factorization is kept for all following evaluations. */
+    EIG_linear_least_squares_solver_use_cholesky(sys->context);
 
     for (i = 0; i < n; i++) {
       EIG_linear_solver_variable_set(sys->context, 0, i, sys->co[i][0]);
@@ -452,6 +489,7 @@ static void laplacianDeformPreview(LaplacianSystem *sys, float (*vertexCos)[3])
           vertexCos[vid][1] = EIG_linear_solver_variable_get(sys->context, 1, vid);
           vertexCos[vid][2] = EIG_linear_solver_variable_get(sys->context, 2, vid);
         }
+        *r_solver_state = MOD_LAPLACIANDEFORM_SOLVER_FACTORIZED;
       }
       else {
         sys->has_solution = false;
@@ -498,6 +536,7 @@ static void laplacianDeformPreview(LaplacianSystem *sys, float (*vertexCos)[3])
           vertexCos[vid][1] = EIG_linear_solver_variable_get(sys->context, 1, vid);
           vertexCos[vid][2] = EIG_linear_solver_variable_get(sys->context, 2, vid);
         }
+        *r_solver_state = MOD_LAPLACIANDEFORM_SOLVER_CACHED;
       }
       else {
         sys->has_solution = false;
@@ -553,13 +592,13 @@ static void initSystem(
     }
 
     anchors_num = STACK_SIZE(index_anchors);
-    lmd->cache_system = initLaplacianSystem(verts_num,
-                                            mesh->totedge,
-                                            BKE_mesh_runtime_looptri_len(mesh),
-                                            anchors_num,
-                                            lmd->anchor_grp_name,
-                                            lmd->repeat);
-    sys = (LaplacianSystem *)lmd->cache_system;
+    sys = initLaplacianSystem(verts_num,
+                              mesh->totedge,
+                              BKE_mesh_runtime_looptri_len(mesh),
+                              anchors_num,
+                              lmd->anchor_grp_name,
+                              lmd->repeat);
+    lmd->modifier.runtime = sys;
     memcpy(sys->index_anchors, index_anchors, sizeof(int) * anchors_num);
     memcpy(sys->co, vertexCos, sizeof(float[3]) * verts_num);
     MEM_freeN(index_anchors);
@@ -598,7 +637,7 @@ static int isSystemDifferent(LaplacianDeformModifierData *lmd,
   float wpaint;
   MDeformVert *dvert = NULL;
   MDeformVert *dv = NULL;
-  LaplacianSystem *sys = (LaplacianSystem *)lmd->cache_system;
+  LaplacianSystem *sys = (LaplacianSystem *)lmd->modifier.runtime;
   const bool invert_vgroup = (lmd->flag & MOD_LAPLACIANDEFORM_INVERT_VGROUP) != 0;
 
   if (sys->verts_num != verts_num) {
@@ -620,6 +659,11 @@ static int isSystemDifferent(LaplacianDeformModifierData *lmd,
                              BKE_defvert_find_weight(dv, defgrp_index);
     dv++;
     if (wpaint > 0.0f) {
+      /* The system outlives copies of the modifier, so compare the anchors themselves to catch
+       * changes that keep their number, like inverting the vertex group. */
+      if (anchors_num >= sys->anchors_num || sys->index_anchors[anchors_num] != i) {
+        return LAPDEFORM_SYSTEM_ONLY_CHANGE_ANCHORS;
+      }
       anchors_num++;
     }
   }
@@ -630,26 +674,48 @@ static int isSystemDifferent(LaplacianDeformModifierData *lmd,
   return LAPDEFORM_SYSTEM_NOT_CHANGE;
 }
 
-static void LaplacianDeformModifier_do(
-    LaplacianDeformModifierData *lmd, Object *ob, Mesh *mesh, float (*vertexCos)[3], int verts_num)
+static void laplacian_deform_solver_state_set(LaplacianDeformModifierData *lmd,
+                                              const ModifierEvalContext *ctx,
+                                              const char solver_state)
 {
+  lmd->solver_state = solver_state;
+
+  if (DEG_is_active(ctx->depsgraph)) {
+    /* Update for display only. */
+    LaplacianDeformModifierData *lmd_orig = (LaplacianDeformModifierData *)
+        BKE_modifier_get_original(ctx->object, &lmd->modifier);
+    if (lmd_orig != NULL) {
+      lmd_orig->solver_state = solver_state;
+    }
+  }
+}
+
+static void LaplacianDeformModifier_do(LaplacianDeformModifierData *lmd,
+                                       const ModifierEvalContext *ctx,
+                                       Mesh *mesh,
+                                       float (*vertexCos)[3],
+                                       int verts_num)
+{
+  Object *ob = ctx->object;
   float(*filevertexCos)[3];
   int sysdif;
+  char solver_state = MOD_LAPLACIANDEFORM_SOLVER_NONE;
   LaplacianSystem *sys = NULL;
   filevertexCos = NULL;
   if (!(lmd->flag & MOD_LAPLACIANDEFORM_BIND)) {
-    if (lmd->cache_system) {
-      sys = lmd->cache_system;
+    if (lmd->modifier.runtime) {
+      sys = lmd->modifier.runtime;
       deleteLaplacianSystem(sys);
-      lmd->cache_system = NULL;
+      lmd->modifier.runtime = NULL;
     }
     lmd->verts_num = 0;
     MEM_SAFE_FREE(lmd->vertexco);
+    laplacian_deform_solver_state_set(lmd, ctx, solver_state);
     return;
   }
-  if (lmd->cache_system) {
+  if (lmd->modifier.runtime) {
     sysdif = isSystemDifferent(lmd, ob, mesh, verts_num);
-    sys = lmd->cache_system;
+    sys = lmd->modifier.runtime;
     if (sysdif) {
       if (ELEM(sysdif, LAPDEFORM_SYSTEM_ONLY_CHANGE_ANCHORS, LAPDEFORM_SYSTEM_ONLY_CHANGE_GROUP)) {
         filevertexCos = MEM_malloc_arrayN(verts_num, sizeof(float[3]), "TempModDeformCoordinates");
@@ -657,12 +723,12 @@ static void LaplacianDeformModifier_do(
         MEM_SAFE_FREE(lmd->vertexco);
         lmd->verts_num = 0;
         deleteLaplacianSystem(sys);
-        lmd->cache_system = NULL;
+        lmd->modifier.runtime = NULL;
         initSystem(lmd, ob, mesh, filevertexCos, verts_num);
-        sys = lmd->cache_system; /* may have been reallocated */
+        sys = lmd->modifier.runtime; /* may have been reallocated */
         MEM_SAFE_FREE(filevertexCos);
         if (sys) {
-          laplacianDeformPreview(sys, vertexCos);
+          laplacianDeformPreview(sys, vertexCos, &solver_state);
         }
       }
       else {
@@ -684,7 +750,7 @@ static void LaplacianDeformModifier_do(
     }
     else {
       sys->repeat = lmd->repeat;
-      laplacianDeformPreview(sys, vertexCos);
+      laplacianDeformPreview(sys, vertexCos, &solver_state);
     }
   }
   else {
@@ -701,19 +767,20 @@ static void LaplacianDeformModifier_do(
       MEM_SAFE_FREE(lmd->vertexco);
       lmd->verts_num = 0;
       initSystem(lmd, ob, mesh, filevertexCos, verts_num);
-      sys = lmd->cache_system;
+      sys = lmd->modifier.runtime;
       MEM_SAFE_FREE(filevertexCos);
-      laplacianDeformPreview(sys, vertexCos);
+      laplacianDeformPreview(sys, vertexCos, &solver_state);
     }
     else {
       initSystem(lmd, ob, mesh, vertexCos, verts_num);
-      sys = lmd->cache_system;
-      laplacianDeformPreview(sys, vertexCos);
+      sys = lmd->modifier.runtime;
+      laplacianDeformPreview(sys, vertexCos, &solver_state);
     }
   }
   if (sys && sys->is_matrix_computed && !sys->has_solution) {
     BKE_modifier_set_error(ob, &lmd->modifier, "The system did not find a solution");
   }
+  laplacian_deform_solver_state_set(lmd, ctx, solver_state);
 }
 
 static void initData(ModifierData *md)
@@ -733,7 +800,6 @@ static void copyData(const ModifierData *md, ModifierData *target, const int fla
   BKE_modifier_copydata_generic(md, target, flag);
 
   tlmd->vertexco = MEM_dupallocN(lmd->vertexco);
-  tlmd->cache_system = NULL;
 }
 
 static bool isDisabled(const struct Scene *UNUSED(scene),
@@ -768,7 +834,7 @@ static void deformVerts(ModifierData *md,
       ctx->object, NULL, mesh, NULL, verts_num, false, false);
 
   LaplacianDeformModifier_do(
-      (LaplacianDeformModifierData *)md, ctx->object, mesh_src, vertexCos, verts_num);
+      (LaplacianDeformModifierData *)md, ctx, mesh_src, vertexCos, verts_num);
 
   if (!ELEM(mesh_src, NULL, mesh)) {
     BKE_id_free(NULL, mesh_src);
@@ -791,20 +857,26 @@ static void deformVertsEM(ModifierData *md,
   }
 
   LaplacianDeformModifier_do(
-      (LaplacianDeformModifierData *)md, ctx->object, mesh_src, vertexCos, verts_num);
+      (LaplacianDeformModifierData *)md, ctx, mesh_src, vertexCos, verts_num);
 
   if (!ELEM(mesh_src, NULL, mesh)) {
     BKE_id_free(NULL, mesh_src);
   }
 }
 
+static void freeRuntimeData(void *runtime_data_v)
+{
+  if (runtime_data_v == NULL) {
+    return;
+  }
+  deleteLaplacianSystem((LaplacianSystem *)runtime_data_v);
+}
+
 static void freeData(ModifierData *md)
 {
   LaplacianDeformModifierData *lmd = (LaplacianDeformModifierData *)md;
-  LaplacianSystem *sys = (LaplacianSystem *)lmd->cache_system;
-  if (sys) {
-    deleteLaplacianSystem(sys);
-  }
+  freeRuntimeData(lmd->modifier.runtime);
+  lmd->modifier.runtime = NULL;
   MEM_SAFE_FREE(lmd->vertexco);
   lmd->verts_num = 0;
 }
@@ -835,6 +907,16 @@ static void panel_draw(const bContext *UNUSED(C), Panel *panel)
           ICON_NONE,
           "OBJECT_OT_laplaciandeform_bind");
 
+  if (is_bind) {
+    const int solver_state = RNA_enum_get(ptr, "solver_state");
+    if (solver_state == MOD_LAPLACIANDEFORM_SOLVER_CACHED) {
+      uiItemL(layout, IFACE_("Factorization: Cached"), ICON_NONE);
+    }
+    else if (solver_state == MOD_LAPLACIANDEFORM_SOLVER_FACTORIZED) {
+      uiItemL(layout, IFACE_("Factorization: Rebuilt"), ICON_NONE);
+    }
+  }
+
   modifier_panel_end(layout, ptr);
 }
 
@@ -871,7 +953,7 @@ static void blendRead(BlendDataReader *reader, ModifierData *md)
   LaplacianDeformModifierData *lmd = (LaplacianDeformModifierData *)md;
 
   BLO_read_float3_array(reader, lmd->verts_num, &lmd->vertexco);
-  lmd->cache_system = NULL;
+  lmd->solver_state = MOD_LAPLACIANDEFORM_SOLVER_NONE;
 }
 
 ModifierTypeInfo modifierType_LaplacianDeform = {
@@ -900,7 +982,7 @@ ModifierTypeInfo modifierType_LaplacianDeform = {
     /* dependsOnNormals */ NULL,
     /* foreachIDLink */ NULL,
     /* foreachTexLink */ NULL,
-    /* freeRuntimeData */ NULL,
+    /* freeRuntimeData */ freeRuntimeData,
     /* panelRegister */ panelRegister,
     /* blendWrite */ blendWrite,
     /* blendRead */ blendRead,
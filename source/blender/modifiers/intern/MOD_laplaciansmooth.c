@@ -8,6 +8,7 @@
 #include "BLI_utildefines.h"
 
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #include "BLT_translation.h"
 
@@ -337,34 +338,59 @@ static void fill_laplacian_matrix(LaplacianSystem *sys)
   }
 }
 
+typedef struct ValidateSolutionData {
+  LaplacianSystem *sys;
+  short flag;
+  float lambda;
+  float lambda_border;
+} ValidateSolutionData;
+
+static void validate_solution_cb(void *__restrict userdata,
+                                 const int i,
+                                 const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const ValidateSolutionData *data = userdata;
+  LaplacianSystem *sys = data->sys;
+  const short flag = data->flag;
+
+  if (sys->zerola[i] == false) {
+    const float lam = sys->ne_ed_num[i] == sys->ne_fa_num[i] ?
+                          (data->lambda >= 0.0f ? 1.0f : -1.0f) :
+                          (data->lambda_border >= 0.0f ? 1.0f : -1.0f);
+    if (flag & MOD_LAPLACIANSMOOTH_X) {
+      sys->vertexCos[i][0] += lam * ((float)EIG_linear_solver_variable_get(sys->context, 0, i) -
+                                     sys->vertexCos[i][0]);
+    }
+    if (flag & MOD_LAPLACIANSMOOTH_Y) {
+      sys->vertexCos[i][1] += lam * ((float)EIG_linear_solver_variable_get(sys->context, 1, i) -
+                                     sys->vertexCos[i][1]);
+    }
+    if (flag & MOD_LAPLACIANSMOOTH_Z) {
+      sys->vertexCos[i][2] += lam * ((float)EIG_linear_solver_variable_get(sys->context, 2, i) -
+                                     sys->vertexCos[i][2]);
+    }
+  }
+}
+
 static void validate_solution(LaplacianSystem *sys, short flag, float lambda, float lambda_border)
 {
-  int i;
-  float lam;
   float vini = 0.0f, vend = 0.0f;
 
   if (flag & MOD_LAPLACIANSMOOTH_PRESERVE_VOLUME) {
     vini = compute_volume(
         sys->vert_centroid, sys->vertexCos, sys->mpoly, sys->polys_num, sys->mloop);
   }
-  for (i = 0; i < sys->verts_num; i++) {
-    if (sys->zerola[i] == false) {
-      lam = sys->ne_ed_num[i] == sys->ne_fa_num[i] ? (lambda >= 0.0f ? 1.0f : -1.0f) :
-                                                     (lambda_border >= 0.0f ? 1.0f : -1.0f);
-      if (flag & MOD_LAPLACIANSMOOTH_X) {
-        sys->vertexCos[i][0] += lam * ((float)EIG_linear_solver_variable_get(sys->context, 0, i) -
-                                       sys->vertexCos[i][0]);
-      }
-      if (flag & MOD_LAPLACIANSMOOTH_Y) {
-        sys->vertexCos[i][1] += lam * ((float)EIG_linear_solver_variable_get(sys->context, 1, i) -
-                                       sys->vertexCos[i][1]);
-      }
-      if (flag & MOD_LAPLACIANSMOOTH_Z) {
-        sys->vertexCos[i][2] += lam * ((float)EIG_linear_solver_variable_get(sys->context, 2, i) -
-                                       sys->vertexCos[i][2]);
-      }
-    }
-  }
+  ValidateSolutionData data = {
+      .sys = sys,
+      .flag = flag,
+      .lambda = lambda,
+      .lambda_border = lambda_border,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, sys->verts_num, &data, validate_solution_cb, &settings);
+
   if (flag & MOD_LAPLACIANSMOOTH_PRESERVE_VOLUME) {
     vend = compute_volume(
         sys->vert_centroid, sys->vertexCos, sys->mpoly, sys->polys_num, sys->mloop);
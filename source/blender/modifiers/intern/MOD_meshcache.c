@@ -142,22 +142,30 @@ static void meshcache_do(MeshCacheModifierData *mcmd,
   /* -------------------------------------------------------------------- */
   /* Read the File (or error out when the file is bad) */
 
-  /* would be nice if we could avoid doing this _every_ frame */
   BLI_strncpy(filepath, mcmd->filepath, sizeof(filepath));
   BLI_path_abs(filepath, ID_BLEND_PATH_FROM_GLOBAL((ID *)ob));
 
-  switch (mcmd->type) {
-    case MOD_MESHCACHE_TYPE_MDD:
-      ok = MOD_meshcache_read_mdd_times(
-          filepath, vertexCos, verts_num, mcmd->interp, time, fps, mcmd->time_mode, &err_str);
-      break;
-    case MOD_MESHCACHE_TYPE_PC2:
-      ok = MOD_meshcache_read_pc2_times(
-          filepath, vertexCos, verts_num, mcmd->interp, time, fps, mcmd->time_mode, &err_str);
-      break;
-    default:
-      ok = false;
-      break;
+  /* The file stays opened (and mapped) between evaluations. */
+  MeshCacheFile *file = MOD_meshcache_file_ensure(mcmd->modifier.runtime, filepath, &err_str);
+  mcmd->modifier.runtime = file;
+
+  if (file == NULL) {
+    ok = false;
+  }
+  else {
+    switch (mcmd->type) {
+      case MOD_MESHCACHE_TYPE_MDD:
+        ok = MOD_meshcache_read_mdd_times(
+            file, vertexCos, verts_num, mcmd->interp, time, fps, mcmd->time_mode, &err_str);
+        break;
+      case MOD_MESHCACHE_TYPE_PC2:
+        ok = MOD_meshcache_read_pc2_times(
+            file, vertexCos, verts_num, mcmd->interp, time, fps, mcmd->time_mode, &err_str);
+        break;
+      default:
+        ok = false;
+        break;
+    }
   }
 
   /* -------------------------------------------------------------------- */
@@ -334,6 +342,20 @@ static void deformVertsEM(ModifierData *md,
   }
 }
 
+static void freeRuntimeData(void *runtime_data_v)
+{
+  if (runtime_data_v == NULL) {
+    return;
+  }
+  MOD_meshcache_file_free((MeshCacheFile *)runtime_data_v);
+}
+
+static void freeData(ModifierData *md)
+{
+  freeRuntimeData(md->runtime);
+  md->runtime = NULL;
+}
+
 static void panel_draw(const bContext *UNUSED(C), Panel *panel)
 {
   uiLayout *layout = panel->layout;
@@ -436,14 +458,14 @@ ModifierTypeInfo modifierType_MeshCache = {
 
     /* initData */ initData,
     /* requiredDataMask */ NULL,
-    /* freeData */ NULL,
+    /* freeData */ freeData,
     /* isDisabled */ isDisabled,
     /* updateDepsgraph */ NULL,
     /* dependsOnTime */ dependsOnTime,
     /* dependsOnNormals */ NULL,
     /* foreachIDLink */ NULL,
     /* foreachTexLink */ NULL,
-    /* freeRuntimeData */ NULL,
+    /* freeRuntimeData */ freeRuntimeData,
     /* panelRegister */ panelRegister,
     /* blendWrite */ NULL,
     /* blendRead */ NULL,
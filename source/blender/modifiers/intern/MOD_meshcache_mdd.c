@@ -8,16 +8,14 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "MEM_guardedalloc.h"
+
 #include "BLI_utildefines.h"
 
-#include "BLI_fileops.h"
 #include "BLI_math.h"
 #ifdef __LITTLE_ENDIAN__
 #  include "BLI_endian_switch.h"
 #endif
-#ifdef WIN32
-#  include "BLI_winstuff.h"
-#endif
 
 #include "DNA_modifier_types.h"
 
@@ -28,12 +26,19 @@ typedef struct MDDHead {
   int verts_tot;
 } MDDHead; /* frames, verts */
 
-static bool meshcache_read_mdd_head(FILE *fp,
+/* MDD files are big endian. */
+#ifdef __LITTLE_ENDIAN__
+#  define MDD_USE_ENDIAN_SWITCH true
+#else
+#  define MDD_USE_ENDIAN_SWITCH false
+#endif
+
+static bool meshcache_read_mdd_head(MeshCacheFile *file,
                                     const int verts_tot,
                                     MDDHead *mdd_head,
                                     const char **err_str)
 {
-  if (!fread(mdd_head, sizeof(*mdd_head), 1, fp)) {
+  if (!MOD_meshcache_file_read(file, mdd_head, 0, sizeof(*mdd_head))) {
     *err_str = "Missing header";
     return false;
   }
@@ -51,36 +56,20 @@ static bool meshcache_read_mdd_head(FILE *fp,
     *err_str = "Invalid frame total";
     return false;
   }
-  /* Intentionally don't seek back. */
 
   return true;
 }
 
 /**
- * Gets the index range and factor.
+ * The header is followed by the time of every frame, then the vertex coordinates of every frame.
  */
-static bool meshcache_read_mdd_range(FILE *fp,
-                                     const int verts_tot,
-                                     const float frame,
-                                     const char interp,
-                                     int r_index_range[2],
-                                     float *r_factor,
-                                     const char **err_str)
+static size_t meshcache_mdd_frame_offset(const MDDHead *mdd_head, const int index)
 {
-  MDDHead mdd_head;
-
-  /* first check interpolation and get the vert locations */
-
-  if (meshcache_read_mdd_head(fp, verts_tot, &mdd_head, err_str) == false) {
-    return false;
-  }
-
-  MOD_meshcache_calc_range(frame, interp, mdd_head.frame_tot, r_index_range, r_factor);
-
-  return true;
+  return sizeof(*mdd_head) + sizeof(float) * (size_t)mdd_head->frame_tot +
+         sizeof(float[3]) * (size_t)index * (size_t)mdd_head->verts_tot;
 }
 
-static bool meshcache_read_mdd_range_from_time(FILE *fp,
+static bool meshcache_read_mdd_range_from_time(MeshCacheFile *file,
                                                const int verts_tot,
                                                const float time,
                                                const float UNUSED(fps),
@@ -92,29 +81,29 @@ static bool meshcache_read_mdd_range_from_time(FILE *fp,
   float f_time, f_time_prev = FLT_MAX;
   float frame;
 
-  if (meshcache_read_mdd_head(fp, verts_tot, &mdd_head, err_str) == false) {
+  if (meshcache_read_mdd_head(file, verts_tot, &mdd_head, err_str) == false) {
     return false;
   }
 
-  size_t frames_num_read = 0;
-  size_t frames_num_expect = mdd_head.frame_tot;
-  errno = 0;
-  for (i = 0; i < mdd_head.frame_tot; i++) {
-    frames_num_read += fread(&f_time, sizeof(float), 1, fp);
+  float *times = MEM_malloc_arrayN((size_t)mdd_head.frame_tot, sizeof(float), __func__);
+  if (!MOD_meshcache_file_read(
+          file, times, sizeof(mdd_head), sizeof(float) * (size_t)mdd_head.frame_tot)) {
+    MEM_freeN(times);
+    *err_str = "Timestamp read failed";
+    return false;
+  }
 #ifdef __LITTLE_ENDIAN__
-    BLI_endian_switch_float(&f_time);
+  BLI_endian_switch_float_array(times, mdd_head.frame_tot);
 #endif
+
+  for (i = 0; i < mdd_head.frame_tot; i++) {
+    f_time = times[i];
     if (f_time >= time) {
-      frames_num_expect = i + 1;
       break;
     }
     f_time_prev = f_time;
   }
-
-  if (frames_num_read != frames_num_expect) {
-    *err_str = errno ? strerror(errno) : "Timestamp read failed";
-    return false;
-  }
+  MEM_freeN(times);
 
   if (i == mdd_head.frame_tot) {
     frame = (float)(mdd_head.frame_tot - 1);
@@ -137,125 +126,47 @@ static bool meshcache_read_mdd_range_from_time(FILE *fp,
   return true;
 }
 
-bool MOD_meshcache_read_mdd_index(FILE *fp,
-                                  float (*vertexCos)[3],
-                                  const int verts_tot,
-                                  const int index,
-                                  const float factor,
-                                  const char **err_str)
-{
-  MDDHead mdd_head;
-
-  if (meshcache_read_mdd_head(fp, verts_tot, &mdd_head, err_str) == false) {
-    return false;
-  }
-
-  if (BLI_fseek(fp, mdd_head.frame_tot * sizeof(int), SEEK_CUR) != 0) {
-    *err_str = "Header seek failed";
-    return false;
-  }
-
-  if (BLI_fseek(fp, sizeof(float[3]) * index * mdd_head.verts_tot, SEEK_CUR) != 0) {
-    *err_str = "Failed to seek frame";
-    return false;
-  }
-
-  size_t verts_read_num = 0;
-  errno = 0;
-  if (factor >= 1.0f) {
-#if 1
-    float *vco = *vertexCos;
-    uint i;
-    for (i = mdd_head.verts_tot; i != 0; i--, vco += 3) {
-      verts_read_num += fread(vco, sizeof(float[3]), 1, fp);
-
-#  ifdef __LITTLE_ENDIAN__
-      BLI_endian_switch_float(vco + 0);
-      BLI_endian_switch_float(vco + 1);
-      BLI_endian_switch_float(vco + 2);
-#  endif /* __LITTLE_ENDIAN__ */
-    }
-#else
-    /* no blending */
-    if (!fread(vertexCos, sizeof(float[3]), mdd_head.verts_tot, f)) {
-      *err_str = errno ? strerror(errno) : "Failed to read frame";
-      return false;
-    }
-#  ifdef __LITTLE_ENDIAN__
-    BLI_endian_switch_float_array(vertexCos[0], mdd_head.verts_tot * 3);
-#  endif
-#endif
-  }
-  else {
-    const float ifactor = 1.0f - factor;
-    float *vco = *vertexCos;
-    uint i;
-    for (i = mdd_head.verts_tot; i != 0; i--, vco += 3) {
-      float tvec[3];
-      verts_read_num += fread(tvec, sizeof(float[3]), 1, fp);
-
-#ifdef __LITTLE_ENDIAN__
-      BLI_endian_switch_float(tvec + 0);
-      BLI_endian_switch_float(tvec + 1);
-      BLI_endian_switch_float(tvec + 2);
-#endif
-
-      vco[0] = (vco[0] * ifactor) + (tvec[0] * factor);
-      vco[1] = (vco[1] * ifactor) + (tvec[1] * factor);
-      vco[2] = (vco[2] * ifactor) + (tvec[2] * factor);
-    }
-  }
-
-  if (verts_read_num != mdd_head.verts_tot) {
-    *err_str = errno ? strerror(errno) : "Vertex coordinate read failed";
-    return false;
-  }
-
-  return true;
-}
-
-bool MOD_meshcache_read_mdd_frame(FILE *fp,
+bool MOD_meshcache_read_mdd_frame(MeshCacheFile *file,
                                   float (*vertexCos)[3],
                                   const int verts_tot,
                                   const char interp,
                                   const float frame,
                                   const char **err_str)
 {
+  MDDHead mdd_head;
   int index_range[2];
   float factor;
 
-  if (meshcache_read_mdd_range(fp,
-                               verts_tot,
-                               frame,
-                               interp,
-                               index_range,
-                               &factor, /* read into these values */
-                               err_str) == false) {
+  if (meshcache_read_mdd_head(file, verts_tot, &mdd_head, err_str) == false) {
     return false;
   }
 
-  if (index_range[0] == index_range[1]) {
-    /* read single */
-    if ((BLI_fseek(fp, 0, SEEK_SET) == 0) &&
-        MOD_meshcache_read_mdd_index(fp, vertexCos, verts_tot, index_range[0], 1.0f, err_str)) {
-      return true;
-    }
+  MOD_meshcache_calc_range(frame, interp, mdd_head.frame_tot, index_range, &factor);
 
+  /* Read both frames at once and interpolate, or only the first when they match. */
+  errno = 0;
+  if (!MOD_meshcache_file_read_coords(file,
+                                      vertexCos,
+                                      verts_tot,
+                                      meshcache_mdd_frame_offset(&mdd_head, index_range[0]),
+                                      meshcache_mdd_frame_offset(&mdd_head, index_range[1]),
+                                      factor,
+                                      MDD_USE_ENDIAN_SWITCH)) {
+    *err_str = errno ? strerror(errno) : "Vertex coordinate read failed";
     return false;
   }
 
-  /* read both and interpolate */
-  if ((BLI_fseek(fp, 0, SEEK_SET) == 0) &&
-      MOD_meshcache_read_mdd_index(fp, vertexCos, verts_tot, index_range[0], 1.0f, err_str) &&
-      (BLI_fseek(fp, 0, SEEK_SET) == 0) &&
-      MOD_meshcache_read_mdd_index(fp, vertexCos, verts_tot, index_range[1], factor, err_str)) {
-    return true;
+  /* Playback is most likely to continue with the following frame. */
+  if (index_range[1] + 1 < mdd_head.frame_tot) {
+    MOD_meshcache_file_prefetch(file,
+                                meshcache_mdd_frame_offset(&mdd_head, index_range[1] + 1),
+                                sizeof(float[3]) * (size_t)verts_tot);
   }
 
-  return false;
+  return true;
 }
 
-bool MOD_meshcache_read_mdd_times(const char *filepath,
+bool MOD_meshcache_read_mdd_times(MeshCacheFile *file,
                                   float (*vertexCos)[3],
                                   const int verts_tot,
                                   const char interp,
@@ -266,14 +177,6 @@ bool MOD_meshcache_read_mdd_times(const char *filepath,
 {
   float frame;
 
-  FILE *fp = BLI_fopen(filepath, "rb");
-  bool ok;
-
-  if (fp == NULL) {
-    *err_str = errno ? strerror(errno) : "Unknown error opening file";
-    return false;
-  }
-
   switch (time_mode) {
     case MOD_MESHCACHE_TIME_FRAME: {
       frame = time;
@@ -281,29 +184,23 @@ bool MOD_meshcache_read_mdd_times(const char *filepath,
     }
     case MOD_MESHCACHE_TIME_SECONDS: {
       /* we need to find the closest time */
-      if (meshcache_read_mdd_range_from_time(fp, verts_tot, time, fps, &frame, err_str) == false) {
-        fclose(fp);
+      if (meshcache_read_mdd_range_from_time(file, verts_tot, time, fps, &frame, err_str) ==
+          false) {
         return false;
       }
-      rewind(fp);
       break;
     }
     case MOD_MESHCACHE_TIME_FACTOR:
     default: {
       MDDHead mdd_head;
-      if (meshcache_read_mdd_head(fp, verts_tot, &mdd_head, err_str) == false) {
-        fclose(fp);
+      if (meshcache_read_mdd_head(file, verts_tot, &mdd_head, err_str) == false) {
         return false;
       }
 
       frame = CLAMPIS(time, 0.0f, 1.0f) * (float)mdd_head.frame_tot;
-      rewind(fp);
       break;
     }
   }
 
-  ok = MOD_meshcache_read_mdd_frame(fp, vertexCos, verts_tot, interp, frame, err_str);
-
-  fclose(fp);
-  return ok;
+  return MOD_meshcache_read_mdd_frame(file, vertexCos, verts_tot, interp, frame, err_str);
 }
@@ -4,9 +4,27 @@
  * \ingroup modifiers
  */
 
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+
+#ifndef WIN32
+#  include <unistd.h> /* For read close. */
+#else
+#  include "BLI_winstuff.h"
+#  include <io.h> /* For open close read. */
+#endif
+
+#include "MEM_guardedalloc.h"
+
 #include "BLI_utildefines.h"
 
+#include "BLI_endian_switch.h"
+#include "BLI_fileops.h"
 #include "BLI_math.h"
+#include "BLI_mmap.h"
+#include "BLI_string.h"
+#include "BLI_task.h"
 
 #include "DNA_modifier_types.h"
 
@@ -48,3 +66,155 @@ void MOD_meshcache_calc_range(const float frame,
     }
   }
 }
+
+/* -------------------------------------------------------------------- */
+/** \name Cache File Access
+ * \{ */
+
+MeshCacheFile *MOD_meshcache_file_ensure(MeshCacheFile *file,
+                                         const char *filepath,
+                                         const char **err_str)
+{
+  BLI_stat_t st;
+  errno = 0;
+  if (BLI_stat(filepath, &st) != 0) {
+    *err_str = errno ? strerror(errno) : "Unknown error opening file";
+    if (file) {
+      MOD_meshcache_file_free(file);
+    }
+    return NULL;
+  }
+
+  if (file) {
+    if (STREQ(file->filepath, filepath) && (file->size == (int64_t)st.st_size) &&
+        (file->mtime == (int64_t)st.st_mtime)) {
+      return file;
+    }
+    MOD_meshcache_file_free(file);
+  }
+
+  const int fd = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+  if (fd == -1) {
+    *err_str = errno ? strerror(errno) : "Unknown error opening file";
+    return NULL;
+  }
+
+  file = MEM_callocN(sizeof(*file), __func__);
+  BLI_strncpy(file->filepath, filepath, sizeof(file->filepath));
+  file->size = (int64_t)st.st_size;
+  file->mtime = (int64_t)st.st_mtime;
+  file->fd = fd;
+
+  /* Mapping fails for empty files and on some file systems, #fd is read from then. */
+  if (st.st_size > 0) {
+    file->mmap = BLI_mmap_open(fd);
+  }
+
+  return file;
+}
+
+void MOD_meshcache_file_free(MeshCacheFile *file)
+{
+  if (file->mmap) {
+    BLI_mmap_free(file->mmap);
+  }
+  close(file->fd);
+  MEM_freeN(file);
+}
+
+bool MOD_meshcache_file_read(MeshCacheFile *file, void *dest, size_t offset, size_t length)
+{
+  if (file->mmap) {
+    return BLI_mmap_read(file->mmap, dest, offset, length);
+  }
+  if (BLI_lseek(file->fd, (int64_t)offset, SEEK_SET) != (int64_t)offset) {
+    return false;
+  }
+  return read(file->fd, dest, length) == (int64_t)length;
+}
+
+void MOD_meshcache_file_prefetch(MeshCacheFile *file, size_t offset, size_t length)
+{
+  if (file->mmap) {
+    BLI_mmap_prefetch(file->mmap, offset, length);
+  }
+}
+
+/** Number of vertices read at once, small enough for the interpolated frame to stay in cache. */
+#define MESHCACHE_CHUNK_VERTS 1024
+
+typedef struct MeshCacheReadCoordsData {
+  MeshCacheFile *file;
+  float (*vertexCos)[3];
+  int verts_tot;
+  size_t offset;
+  size_t offset_next;
+  float factor;
+  bool use_endian_switch;
+  bool read_error;
+} MeshCacheReadCoordsData;
+
+static void meshcache_read_coords_chunk_cb(void *__restrict userdata,
+                                           const int chunk,
+                                           const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  MeshCacheReadCoordsData *data = userdata;
+  const int vert_start = chunk * MESHCACHE_CHUNK_VERTS;
+  const int verts_num = min_ii(MESHCACHE_CHUNK_VERTS, data->verts_tot - vert_start);
+  const size_t chunk_offset = sizeof(float[3]) * (size_t)vert_start;
+  const size_t chunk_size = sizeof(float[3]) * (size_t)verts_num;
+  float(*co)[3] = data->vertexCos + vert_start;
+
+  if (!MOD_meshcache_file_read(data->file, co, data->offset + chunk_offset, chunk_size)) {
+    data->read_error = true;
+    return;
+  }
+  if (data->use_endian_switch) {
+    BLI_endian_switch_float_array(co[0], verts_num * 3);
+  }
+
+  if (data->factor < 1.0f) {
+    float co_next[MESHCACHE_CHUNK_VERTS][3];
+    if (!MOD_meshcache_file_read(
+            data->file, co_next, data->offset_next + chunk_offset, chunk_size)) {
+      data->read_error = true;
+      return;
+    }
+    if (data->use_endian_switch) {
+      BLI_endian_switch_float_array(co_next[0], verts_num * 3);
+    }
+    interp_vn_vn(co[0], co_next[0], data->factor, verts_num * 3);
+  }
+}
+
+bool MOD_meshcache_file_read_coords(MeshCacheFile *file,
+                                    float (*vertexCos)[3],
+                                    const int verts_tot,
+                                    const size_t offset,
+                                    const size_t offset_next,
+                                    const float factor,
+                                    const bool use_endian_switch)
+{
+  MeshCacheReadCoordsData data = {
+      .file = file,
+      .vertexCos = vertexCos,
+      .verts_tot = verts_tot,
+      .offset = offset,
+      .offset_next = offset_next,
+      .factor = (offset == offset_next) ? 1.0f : factor,
+      .use_endian_switch = use_endian_switch,
+      .read_error = false,
+  };
+
+  const int chunks_num = (verts_tot + MESHCACHE_CHUNK_VERTS - 1) / MESHCACHE_CHUNK_VERTS;
+
+  /* Reading the file descriptor moves its position, only mapped files are read in parallel. */
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (file->mmap != NULL) && (chunks_num > 1);
+  BLI_task_parallel_range(0, chunks_num, &data, meshcache_read_coords_chunk_cb, &settings);
+
+  return !data.read_error;
+}
+
+/** \} */
@@ -6,21 +6,32 @@
 
 #pragma once
 
+struct BLI_mmap_file;
+
+/**
+ * An opened cache file, kept in the modifier runtime data so the file is only opened and mapped
+ * once instead of on every evaluation.
+ */
+typedef struct MeshCacheFile {
+  /** Absolute path of the opened file. */
+  char filepath[1024]; /* FILE_MAX */
+  /** Size and modification time of the opened file, to open it again when it's overwritten. */
+  int64_t size;
+  int64_t mtime;
+  /** The mapped file, NULL when mapping isn't supported, then #fd is read from instead. */
+  struct BLI_mmap_file *mmap;
+  int fd;
+} MeshCacheFile;
+
 /* MOD_meshcache_mdd.c */
 
-bool MOD_meshcache_read_mdd_index(FILE *fp,
-                                  float (*vertexCos)[3],
-                                  int vertex_tot,
-                                  int index,
-                                  float factor,
-                                  const char **err_str);
-bool MOD_meshcache_read_mdd_frame(FILE *fp,
+bool MOD_meshcache_read_mdd_frame(MeshCacheFile *file,
                                   float (*vertexCos)[3],
                                   int verts_tot,
                                   char interp,
                                   float frame,
                                   const char **err_str);
-bool MOD_meshcache_read_mdd_times(const char *filepath,
+bool MOD_meshcache_read_mdd_times(MeshCacheFile *file,
                                   float (*vertexCos)[3],
                                   int verts_tot,
                                   char interp,
@@ -31,15 +42,13 @@ bool MOD_meshcache_read_mdd_times(const char *filepath,
 
 /* MOD_meshcache_pc2.c */
 
-bool MOD_meshcache_read_pc2_index(
-    FILE *fp, float (*vertexCos)[3], int verts_tot, int index, float factor, const char **err_str);
-bool MOD_meshcache_read_pc2_frame(FILE *fp,
+bool MOD_meshcache_read_pc2_frame(MeshCacheFile *file,
                                   float (*vertexCos)[3],
                                   int verts_tot,
                                   char interp,
                                   float frame,
                                   const char **err_str);
-bool MOD_meshcache_read_pc2_times(const char *filepath,
+bool MOD_meshcache_read_pc2_times(MeshCacheFile *file,
                                   float (*vertexCos)[3],
                                   int verts_tot,
                                   char interp,
@@ -53,4 +62,31 @@ bool MOD_meshcache_read_pc2_times(const char *filepath,
 void MOD_meshcache_calc_range(
     float frame, char interp, int frame_tot, int r_index_range[2], float *r_factor);
 
+/**
+ * Return the opened \a filepath, reusing \a file when it's still valid for it and freeing it
+ * otherwise. Returns NULL when the file can't be opened.
+ */
+MeshCacheFile *MOD_meshcache_file_ensure(MeshCacheFile *file,
+                                         const char *filepath,
+                                         const char **err_str);
+void MOD_meshcache_file_free(MeshCacheFile *file);
+
+bool MOD_meshcache_file_read(MeshCacheFile *file, void *dest, size_t offset, size_t length);
+/**
+ * Read the vertex coordinates of a frame stored at \a offset, interpolating them with the ones of
+ * the frame at \a offset_next by \a factor when it's below one.
+ */
+bool MOD_meshcache_file_read_coords(MeshCacheFile *file,
+                                    float (*vertexCos)[3],
+                                    int verts_tot,
+                                    size_t offset,
+                                    size_t offset_next,
+                                    float factor,
+                                    bool use_endian_switch);
+/**
+ * Start reading the given range in the background, used for the frames that will likely be
+ * played next.
+ */
+void MOD_meshcache_file_prefetch(MeshCacheFile *file, size_t offset, size_t length);
+
 #define FRAME_SNAP_EPS 0.0001f
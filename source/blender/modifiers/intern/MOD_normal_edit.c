@@ -10,8 +10,8 @@
 
 #include "BLI_utildefines.h"
 
-#include "BLI_bitmap.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #include "BLT_translation.h"
 
@@ -39,6 +39,17 @@
 #include "MOD_ui_common.h"
 #include "MOD_util.h"
 
+static void normal_edit_parallel_range(const int items_num,
+                                       void *userdata,
+                                       TaskParallelRangeFunc func)
+{
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = items_num > 1024;
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, items_num, userdata, func, &settings);
+}
+
 static void generate_vert_coordinates(Mesh *mesh,
                                       Object *ob,
                                       Object *ob_center,
@@ -115,6 +126,49 @@ static void generate_vert_coordinates(Mesh *mesh,
   }
 }
 
+typedef struct MixNormalsData {
+  const float *facs;
+  float mix_factor;
+  float mix_limit;
+  short mix_mode;
+  const float (*nos_old)[3];
+  float (*nos_new)[3];
+} MixNormalsData;
+
+static void mix_normals_cb(void *__restrict userdata,
+                           const int i,
+                           const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const MixNormalsData *data = userdata;
+  const float *no_old = data->nos_old[i];
+  float *no_new = data->nos_new[i];
+  const float fac = data->facs ? data->facs[i] * data->mix_factor : data->mix_factor;
+  const float mix_limit = data->mix_limit;
+
+  switch (data->mix_mode) {
+    case MOD_NORMALEDIT_MIX_ADD:
+      add_v3_v3(no_new, no_old);
+      normalize_v3(no_new);
+      break;
+    case MOD_NORMALEDIT_MIX_SUB:
+      sub_v3_v3(no_new, no_old);
+      normalize_v3(no_new);
+      break;
+    case MOD_NORMALEDIT_MIX_MUL:
+      mul_v3_v3(no_new, no_old);
+      normalize_v3(no_new);
+      break;
+    case MOD_NORMALEDIT_MIX_COPY:
+      break;
+  }
+
+  interp_v3_v3v3_slerp_safe(
+      no_new,
+      no_old,
+      no_new,
+      (mix_limit < (float)M_PI) ? min_ff(fac, mix_limit / angle_v3v3(no_new, no_old)) : fac);
+}
+
 /* Note this modifies nos_new in-place. */
 static void mix_normals(const float mix_factor,
                         MDeformVert *dvert,
@@ -129,9 +183,7 @@ static void mix_normals(const float mix_factor,
                         const int loops_num)
 {
   /* Mix with org normals... */
-  float *facs = NULL, *wfac;
-  float(*no_new)[3], (*no_old)[3];
-  int i;
+  float *facs = NULL;
 
   if (dvert) {
     facs = MEM_malloc_arrayN((size_t)loops_num, sizeof(*facs), __func__);
@@ -139,35 +191,41 @@ static void mix_normals(const float mix_factor,
         dvert, defgrp_index, verts_num, mloop, loops_num, use_invert_vgroup, facs);
   }
 
-  for (i = loops_num, no_new = nos_new, no_old = nos_old, wfac = facs; i--;
-       no_new++, no_old++, wfac++) {
-    const float fac = facs ? *wfac * mix_factor : mix_factor;
-
-    switch (mix_mode) {
-      case MOD_NORMALEDIT_MIX_ADD:
-        add_v3_v3(*no_new, *no_old);
-        normalize_v3(*no_new);
-        break;
-      case MOD_NORMALEDIT_MIX_SUB:
-        sub_v3_v3(*no_new, *no_old);
-        normalize_v3(*no_new);
-        break;
-      case MOD_NORMALEDIT_MIX_MUL:
-        mul_v3_v3(*no_new, *no_old);
-        normalize_v3(*no_new);
-        break;
-      case MOD_NORMALEDIT_MIX_COPY:
-        break;
-    }
+  MixNormalsData data = {
+      .facs = facs,
+      .mix_factor = mix_factor,
+      .mix_limit = mix_limit,
+      .mix_mode = mix_mode,
+      .nos_old = (const float(*)[3])nos_old,
+      .nos_new = nos_new,
+  };
+  normal_edit_parallel_range(loops_num, &data, mix_normals_cb);
+
+  MEM_SAFE_FREE(facs);
+}
+
+typedef struct PolygonsCheckFlipData {
+  const MPoly *mpoly;
+  const float (*nos)[3];
+  const float (*polynors)[3];
+  bool *r_do_flip;
+} PolygonsCheckFlipData;
+
+static void polygons_check_flip_cb(void *__restrict userdata,
+                                   const int mp_index,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const PolygonsCheckFlipData *data = userdata;
+  const MPoly *mp = &data->mpoly[mp_index];
+  float norsum[3] = {0.0f};
 
-    interp_v3_v3v3_slerp_safe(
-        *no_new,
-        *no_old,
-        *no_new,
-        (mix_limit < (float)M_PI) ? min_ff(fac, mix_limit / angle_v3v3(*no_new, *no_old)) : fac);
+  for (int j = 0; j < mp->totloop; j++) {
+    add_v3_v3(norsum, data->nos[mp->loopstart + j]);
   }
 
-  MEM_SAFE_FREE(facs);
+  /* If average of new loop normals is opposed to polygon normal, flip polygon. */
+  data->r_do_flip[mp_index] = normalize_v3(norsum) != 0.0f &&
+                              dot_v3v3(data->polynors[mp_index], norsum) < 0.0f;
 }
 
 /* Check poly normals and new loop normals are compatible, otherwise flip polygons
@@ -179,35 +237,87 @@ static bool polygons_check_flip(MLoop *mloop,
                                 float (*polynors)[3],
                                 const int polys_num)
 {
-  MPoly *mp;
   MDisps *mdisp = CustomData_get_layer(ldata, CD_MDISPS);
-  int i;
+  bool *do_flip = MEM_malloc_arrayN((size_t)polys_num, sizeof(*do_flip), __func__);
   bool flipped = false;
 
-  for (i = 0, mp = mpoly; i < polys_num; i++, mp++) {
-    float norsum[3] = {0.0f};
-    float(*no)[3];
-    int j;
-
-    for (j = 0, no = &nos[mp->loopstart]; j < mp->totloop; j++, no++) {
-      add_v3_v3(norsum, *no);
-    }
-
-    if (!normalize_v3(norsum)) {
-      continue;
-    }
-
-    /* If average of new loop normals is opposed to polygon normal, flip polygon. */
-    if (dot_v3v3(polynors[i], norsum) < 0.0f) {
-      BKE_mesh_polygon_flip_ex(mp, mloop, ldata, nos, mdisp, true);
+  /* Only the flipping itself (which reorders loop data) is done serially. */
+  PolygonsCheckFlipData data = {
+      .mpoly = mpoly,
+      .nos = (const float(*)[3])nos,
+      .polynors = (const float(*)[3])polynors,
+      .r_do_flip = do_flip,
+  };
+  normal_edit_parallel_range(polys_num, &data, polygons_check_flip_cb);
+
+  for (int i = 0; i < polys_num; i++) {
+    if (do_flip[i]) {
+      BKE_mesh_polygon_flip_ex(&mpoly[i], mloop, ldata, nos, mdisp, true);
       negate_v3(polynors[i]);
       flipped = true;
     }
   }
 
+  MEM_freeN(do_flip);
   return flipped;
 }
 
+typedef struct NormalEditVertsData {
+  /* Vertex coordinates, replaced by their new normal. */
+  float (*cos)[3];
+  /* Radial mode spheroid coefficients. */
+  float m2, n2;
+  /* Directional mode target. */
+  const float *target_co;
+} NormalEditVertsData;
+
+static void normal_edit_radial_vert_cb(void *__restrict userdata,
+                                       const int mv_index,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const NormalEditVertsData *data = userdata;
+  const float m2 = data->m2;
+  const float n2 = data->n2;
+  float *co = data->cos[mv_index];
+
+  const float x2 = co[0] * co[0];
+  const float y2 = co[1] * co[1];
+  const float z2 = co[2] * co[2];
+  const float a2 = x2 + (y2 / m2) + (z2 / n2);
+  const float b2 = (m2 * x2) + y2 + (m2 * z2 / n2);
+  const float c2 = (n2 * x2) + (n2 * y2 / m2) + z2;
+
+  co[0] /= a2;
+  co[1] /= b2;
+  co[2] /= c2;
+  normalize_v3(co);
+}
+
+static void normal_edit_directional_vert_cb(void *__restrict userdata,
+                                            const int mv_index,
+                                            const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const NormalEditVertsData *data = userdata;
+  float *co = data->cos[mv_index];
+
+  sub_v3_v3v3(co, data->target_co, co);
+  normalize_v3(co);
+}
+
+typedef struct NormalEditLoopsData {
+  const MLoop *mloop;
+  const float (*vert_nos)[3];
+  float (*r_nos)[3];
+} NormalEditLoopsData;
+
+static void normal_edit_loop_from_vert_cb(void *__restrict userdata,
+                                          const int ml_index,
+                                          const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const NormalEditLoopsData *data = userdata;
+  copy_v3_v3(data->r_nos[ml_index], data->vert_nos[data->mloop[ml_index].v]);
+}
+
 static void normalEditModifier_do_radial(NormalEditModifierData *enmd,
                                          const ModifierEvalContext *UNUSED(ctx),
                                          Object *ob,
@@ -228,19 +338,17 @@ static void normalEditModifier_do_radial(NormalEditModifierData *enmd,
                                          MLoop *mloop,
                                          const int loops_num,
                                          MPoly *mpoly,
-                                         const int polys_num)
+                                         const int polys_num,
+                                         MLoopNorSpaceArray *lnors_spacearr)
 {
   Object *ob_target = enmd->target;
 
   const bool do_polynors_fix = (enmd->flag & MOD_NORMALEDIT_NO_POLYNORS_FIX) == 0;
-  int i;
 
   float(*cos)[3] = MEM_malloc_arrayN((size_t)verts_num, sizeof(*cos), __func__);
   float(*nos)[3] = MEM_malloc_arrayN((size_t)loops_num, sizeof(*nos), __func__);
   float size[3];
 
-  BLI_bitmap *done_verts = BLI_BITMAP_NEW((size_t)verts_num, __func__);
-
   generate_vert_coordinates(mesh, ob, ob_target, enmd->offset, verts_num, cos, size);
 
   /**
@@ -276,34 +384,21 @@ static void normalEditModifier_do_radial(NormalEditModifierData *enmd,
    */
   {
     const float a = size[0], b = size[1], c = size[2];
-    const float m2 = (b * b) / (a * a);
-    const float n2 = (c * c) / (a * a);
-
-    MLoop *ml;
-    float(*no)[3];
 
     /* We reuse cos to now store the ellipsoid-normal of the verts! */
-    for (i = loops_num, ml = mloop, no = nos; i--; ml++, no++) {
-      const int vidx = ml->v;
-      float *co = cos[vidx];
-
-      if (!BLI_BITMAP_TEST(done_verts, vidx)) {
-        const float x2 = co[0] * co[0];
-        const float y2 = co[1] * co[1];
-        const float z2 = co[2] * co[2];
-        const float a2 = x2 + (y2 / m2) + (z2 / n2);
-        const float b2 = (m2 * x2) + y2 + (m2 * z2 / n2);
-        const float c2 = (n2 * x2) + (n2 * y2 / m2) + z2;
-
-        co[0] /= a2;
-        co[1] /= b2;
-        co[2] /= c2;
-        normalize_v3(co);
-
-        BLI_BITMAP_ENABLE(done_verts, vidx);
-      }
-      copy_v3_v3(*no, co);
-    }
+    NormalEditVertsData verts_data = {
+        .cos = cos,
+        .m2 = (b * b) / (a * a),
+        .n2 = (c * c) / (a * a),
+    };
+    normal_edit_parallel_range(verts_num, &verts_data, normal_edit_radial_vert_cb);
+
+    NormalEditLoopsData loops_data = {
+        .mloop = mloop,
+        .vert_nos = (const float(*)[3])cos,
+        .r_nos = nos,
+    };
+    normal_edit_parallel_range(loops_num, &loops_data, normal_edit_loop_from_vert_cb);
   }
 
   if (loopnors) {
@@ -325,24 +420,26 @@ static void normalEditModifier_do_radial(NormalEditModifierData *enmd,
           mloop, nos, &mesh->ldata, mpoly, BKE_mesh_poly_normals_for_write(mesh), polys_num)) {
     /* We need to recompute vertex normals! */
     BKE_mesh_normals_tag_dirty(mesh);
+    /* And loop normal spaces no longer match the flipped polygons. */
+    lnors_spacearr = NULL;
   }
 
-  BKE_mesh_normals_loop_custom_set(mvert,
-                                   BKE_mesh_vertex_normals_ensure(mesh),
-                                   verts_num,
-                                   medge,
-                                   edges_num,
-                                   mloop,
-                                   nos,
-                                   loops_num,
-                                   mpoly,
-                                   polynors,
-                                   polys_num,
-                                   clnors);
+  BKE_mesh_normals_loop_custom_set_ex(mvert,
+                                      BKE_mesh_vertex_normals_ensure(mesh),
+                                      verts_num,
+                                      medge,
+                                      edges_num,
+                                      mloop,
+                                      nos,
+                                      loops_num,
+                                      mpoly,
+                                      polynors,
+                                      polys_num,
+                                      clnors,
+                                      lnors_spacearr);
 
   MEM_freeN(cos);
   MEM_freeN(nos);
-  MEM_freeN(done_verts);
 }
 
 static void normalEditModifier_do_directional(NormalEditModifierData *enmd,
@@ -365,7 +462,8 @@ static void normalEditModifier_do_directional(NormalEditModifierData *enmd,
                                               MLoop *mloop,
                                               const int loops_num,
                                               MPoly *mpoly,
-                                              const int polys_num)
+                                              const int polys_num,
+                                              MLoopNorSpaceArray *lnors_spacearr)
 {
   Object *ob_target = enmd->target;
 
@@ -398,26 +496,20 @@ static void normalEditModifier_do_directional(NormalEditModifierData *enmd,
     float(*cos)[3] = MEM_malloc_arrayN((size_t)verts_num, sizeof(*cos), __func__);
     generate_vert_coordinates(mesh, ob, ob_target, NULL, verts_num, cos, NULL);
 
-    BLI_bitmap *done_verts = BLI_BITMAP_NEW((size_t)verts_num, __func__);
-    MLoop *ml;
-    float(*no)[3];
-
     /* We reuse cos to now store the 'to target' normal of the verts! */
-    for (i = loops_num, no = nos, ml = mloop; i--; no++, ml++) {
-      const int vidx = ml->v;
-      float *co = cos[vidx];
-
-      if (!BLI_BITMAP_TEST(done_verts, vidx)) {
-        sub_v3_v3v3(co, target_co, co);
-        normalize_v3(co);
+    NormalEditVertsData verts_data = {
+        .cos = cos,
+        .target_co = target_co,
+    };
+    normal_edit_parallel_range(verts_num, &verts_data, normal_edit_directional_vert_cb);
+
+    NormalEditLoopsData loops_data = {
+        .mloop = mloop,
+        .vert_nos = (const float(*)[3])cos,
+        .r_nos = nos,
+    };
+    normal_edit_parallel_range(loops_num, &loops_data, normal_edit_loop_from_vert_cb);
 
-        BLI_BITMAP_ENABLE(done_verts, vidx);
-      }
-
-      copy_v3_v3(*no, co);
-    }
-
-    MEM_freeN(done_verts);
     MEM_freeN(cos);
   }
 
@@ -439,20 +531,22 @@ static void normalEditModifier_do_directional(NormalEditModifierData *enmd,
       polygons_check_flip(
           mloop, nos, &mesh->ldata, mpoly, BKE_mesh_poly_normals_for_write(mesh), polys_num)) {
     BKE_mesh_normals_tag_dirty(mesh);
+    lnors_spacearr = NULL;
   }
 
-  BKE_mesh_normals_loop_custom_set(mvert,
-                                   BKE_mesh_vertex_normals_ensure(mesh),
-                                   verts_num,
-                                   medge,
-                                   edges_num,
-                                   mloop,
-                                   nos,
-                                   loops_num,
-                                   mpoly,
-                                   polynors,
-                                   polys_num,
-                                   clnors);
+  BKE_mesh_normals_loop_custom_set_ex(mvert,
+                                      BKE_mesh_vertex_normals_ensure(mesh),
+                                      verts_num,
+                                      medge,
+                                      edges_num,
+                                      mloop,
+                                      nos,
+                                      loops_num,
+                                      mpoly,
+                                      polynors,
+                                      polys_num,
+                                      clnors,
+                                      lnors_spacearr);
 
   MEM_freeN(nos);
 }
@@ -532,6 +626,7 @@ static Mesh *normalEditModifier_do(NormalEditModifierData *enmd,
   MDeformVert *dvert;
 
   float(*loopnors)[3] = NULL;
+  MLoopNorSpaceArray lnors_spacearr = {NULL};
 
   CustomData *ldata = &result->ldata;
 
@@ -543,6 +638,10 @@ static Mesh *normalEditModifier_do(NormalEditModifierData *enmd,
     clnors = CustomData_duplicate_referenced_layer(ldata, CD_CUSTOMLOOPNORMAL, loops_num);
     loopnors = MEM_malloc_arrayN((size_t)loops_num, sizeof(*loopnors), __func__);
 
+    /* Loop normal spaces can be shared with #BKE_mesh_normals_loop_custom_set_ex when the smooth
+     * fans do not depend on the split angle. */
+    const bool share_lnors_spacearr = clnors != NULL || result->smoothresh >= (float)M_PI;
+
     BKE_mesh_normals_loop_split(mvert,
                                 vert_normals,
                                 verts_num,
@@ -556,7 +655,7 @@ static Mesh *normalEditModifier_do(NormalEditModifierData *enmd,
                                 polys_num,
                                 true,
                                 result->smoothresh,
-                                NULL,
+                                share_lnors_spacearr ? &lnors_spacearr : NULL,
                                 clnors,
                                 NULL);
   }
@@ -588,7 +687,8 @@ static Mesh *normalEditModifier_do(NormalEditModifierData *enmd,
                                  mloop,
                                  loops_num,
                                  mpoly,
-                                 polys_num);
+                                 polys_num,
+                                 &lnors_spacearr);
   }
   else if (enmd->mode == MOD_NORMALEDIT_MODE_DIRECTIONAL) {
     normalEditModifier_do_directional(enmd,
@@ -611,10 +711,14 @@ static Mesh *normalEditModifier_do(NormalEditModifierData *enmd,
                                       mloop,
                                       loops_num,
                                       mpoly,
-                                      polys_num);
+                                      polys_num,
+                                      &lnors_spacearr);
   }
 
   MEM_SAFE_FREE(loopnors);
+  if (lnors_spacearr.mem != NULL) {
+    BKE_lnor_spacearr_free(&lnors_spacearr);
+  }
 
   result->runtime.is_original = false;
 
@@ -31,12 +31,17 @@
 #include "BKE_anim_data.h"
 #include "BKE_lib_query.h"
 
+#include "BLT_translation.h"
+
 #include "UI_interface.h"
 #include "UI_resources.h"
 
 #include "RNA_access.h"
 #include "RNA_prototypes.h"
 
+#include "WM_types.h"
+
+#include "DNA_defaults.h"
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
 #include "DNA_screen_types.h"
@@ -50,6 +55,7 @@
 #include "MFX_modifier.h"
 
 #include <stdio.h>
+#include <string.h>
 
 // Modifier API
 
@@ -64,14 +70,13 @@ static Mesh *modifyMesh(ModifierData *md,
 static void initData(struct ModifierData *md)
 {
   OpenMfxModifierData *fxmd = (OpenMfxModifierData *)md;
-  fxmd->active_effect_index = -1;
-  fxmd->num_effects = 0;
-  fxmd->effects = NULL;
-  fxmd->num_parameters = 0;
-  fxmd->parameters = NULL;
-  fxmd->num_extra_inputs = 0;
-  fxmd->extra_inputs = NULL;
-  fxmd->message[0] = '\0';
+
+  BLI_assert(MEMCMP_STRUCT_AFTER_IS_ZERO(fxmd, modifier));
+
+  MEMCPY_STRUCT_AFTER(fxmd, DNA_struct_default_get(OpenMfxModifierData), modifier);
+
+  BKE_modifier_path_init(
+      fxmd->cache_directory, sizeof(fxmd->cache_directory), "cache_openmfx");
 }
 
 static void copyData(const ModifierData *md, ModifierData *target, const int flag)
@@ -96,7 +101,7 @@ static void requiredDataMask(Object *UNUSED(ob),
      maybe there could be a mechanism in OpenMfx to have a plugin explicitely
      ask for input attributes, so that we can avoid feeding all of them to addons
      that are not using it. */
-  r_cddata_masks->lmask |= CD_MLOOPUV;
+  r_cddata_masks->lmask |= CD_MASK_MLOOPUV | CD_MASK_PROP_BYTE_COLOR | CD_MASK_PROP_COLOR;
 }
 
 static void updateDepsgraph(ModifierData *md, const ModifierUpdateDepsgraphContext *ctx)
@@ -254,9 +259,51 @@ static void panel_draw(const bContext *C, Panel *panel)
   modifier_panel_end(layout, ptr);
 }
 
+static void bake_panel_draw(const bContext *UNUSED(C), Panel *panel)
+{
+  uiLayout *col;
+  uiLayout *layout = panel->layout;
+
+  PointerRNA *ptr = modifier_panel_get_property_pointers(panel, NULL);
+
+  uiLayoutSetPropSep(layout, true);
+
+  bool is_cached = RNA_boolean_get(ptr, "is_cached");
+
+  if (is_cached) {
+    PointerRNA op_ptr;
+    uiItemFullO(layout,
+                "OBJECT_OT_openmfx_bake",
+                IFACE_("Delete Bake"),
+                ICON_NONE,
+                NULL,
+                WM_OP_EXEC_DEFAULT,
+                0,
+                &op_ptr);
+    RNA_boolean_set(&op_ptr, "free", true);
+  }
+  else {
+    uiItemO(layout, NULL, ICON_NONE, "OBJECT_OT_openmfx_bake");
+  }
+
+  uiItemR(layout, ptr, "cache_directory", 0, NULL, ICON_NONE);
+
+  col = uiLayoutColumn(layout, true);
+  uiLayoutSetEnabled(col, !is_cached);
+  uiItemR(col, ptr, "cache_frame_start", 0, IFACE_("Frame Start"), ICON_NONE);
+  uiItemR(col, ptr, "cache_frame_end", 0, IFACE_("End"), ICON_NONE);
+
+  col = uiLayoutColumn(layout, false);
+  uiItemR(col, ptr, "use_cache", 0, NULL, ICON_NONE);
+  col = uiLayoutColumn(layout, false);
+  uiLayoutSetActive(col, RNA_boolean_get(ptr, "use_cache"));
+  uiItemR(col, ptr, "cache_readahead", 0, NULL, ICON_NONE);
+}
+
 static void panelRegister(ARegionType *region_type)
 {
   PanelType *panel_type = modifier_panel_register(region_type, eModifierType_OpenMfx, panel_draw);
+  modifier_subpanel_register(region_type, "bake", "Bake", NULL, bake_panel_draw, panel_type);
 }
 
 static void blendWrite(BlendWriter *writer,
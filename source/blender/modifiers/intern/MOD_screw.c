@@ -13,6 +13,7 @@
 #include "BLI_alloca.h"
 #include "BLI_bitmap.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #include "BLT_translation.h"
 
@@ -175,6 +176,307 @@ static Mesh *mesh_remove_doubles_on_axis(Mesh *result,
   return result;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Parallel Slice & Face Generation
+ *
+ * Every step adds the same number of vertices and edges and every original edge adds the
+ * same number of faces, so the destination of each element is known up-front
+ * and the slices and faces can be filled in parallel.
+ * \{ */
+
+typedef struct ScrewStepData {
+  const Mesh *mesh;
+  Mesh *result;
+  MVert *mvert_new;
+  /** The edges connecting each slice to the previous one, #totvert for every step. */
+  MEdge *medge_step;
+  const ScrewVertConnect *vert_connect;
+  float (*vert_normals_new)[3];
+  const BLI_bitmap *vert_tag;
+  uint totvert;
+  uint step_tot;
+  bool close;
+  float angle;
+  float screw_ofs;
+  const float *axis_vec;
+  char axis_char;
+  /** Location of the axis object, NULL when using the objects own axis. */
+  const float *axis_co;
+} ScrewStepData;
+
+static void screw_step_cb(void *__restrict userdata,
+                          const int iter,
+                          const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const ScrewStepData *data = userdata;
+  const uint step = (uint)iter;
+  const uint totvert = data->totvert;
+  const uint varray_stride = totvert * step;
+  float mat3[3][3];
+  float mat[4][4];
+
+  /* Rotation Matrix */
+  const float step_angle = (data->angle / (float)(data->step_tot - (!data->close))) *
+                           (float)step;
+
+  if (data->axis_co != NULL) {
+    axis_angle_normalized_to_mat3(mat3, data->axis_vec, step_angle);
+  }
+  else {
+    axis_angle_to_mat3_single(mat3, data->axis_char, step_angle);
+  }
+  copy_m4_m3(mat, mat3);
+
+  if (data->screw_ofs) {
+    madd_v3_v3fl(
+        mat[3], data->axis_vec, data->screw_ofs * ((float)step / (float)(data->step_tot - 1)));
+  }
+
+  /* copy a slice */
+  CustomData_copy_data(
+      &data->mesh->vdata, &data->result->vdata, 0, (int)varray_stride, (int)totvert);
+
+  const MVert *mv_new_base = data->mvert_new;
+  MVert *mv_new = &data->mvert_new[varray_stride]; /* advance to the next slice */
+  MEdge *med_new = &data->medge_step[(step - 1) * totvert];
+
+  for (uint j = 0; j < totvert; j++, mv_new_base++, mv_new++, med_new++) {
+    /* set normal */
+    if (data->vert_connect && data->vert_normals_new) {
+      /* Set the normal now its transformed. */
+      mul_v3_m3v3(data->vert_normals_new[varray_stride + j], mat3, data->vert_connect[j].no);
+    }
+
+    /* set location */
+    copy_v3_v3(mv_new->co, mv_new_base->co);
+
+    if (data->axis_co != NULL) {
+      sub_v3_v3(mv_new->co, data->axis_co);
+
+      mul_m4_v3(mat, mv_new->co);
+
+      add_v3_v3(mv_new->co, data->axis_co);
+    }
+    else {
+      mul_m4_v3(mat, mv_new->co);
+    }
+
+    /* add the new edge */
+    med_new->v1 = varray_stride + j;
+    med_new->v2 = med_new->v1 - totvert;
+    med_new->flag = ME_EDGEDRAW | ME_EDGERENDER;
+    if (!BLI_BITMAP_TEST(data->vert_tag, j)) {
+      med_new->flag |= ME_LOOSEEDGE;
+    }
+  }
+}
+
+typedef struct ScrewEdgeData {
+  const ScrewModifierData *ltmd;
+  const Mesh *mesh;
+  Mesh *result;
+
+  uint totvert;
+  uint totedge;
+  uint step_tot;
+  bool close;
+  /** Index of the first edge connecting the revolved copies of the original edges. */
+  uint edge_offset;
+
+  const uint *edge_poly_map;
+  const uint *vert_loop_map;
+  const MPoly *mpoly_orig;
+  const MVert *mvert_new;
+  MEdge *medge_new;
+  MPoly *mpoly_new;
+  MLoop *mloop_new;
+  int *origindex;
+  char mpoly_flag;
+
+  const int *quad_ord;
+  const int *quad_ord_ofs;
+
+  MLoopUV **mloopuv_layers;
+  uint mloopuv_layers_tot;
+  const float *uv_axis_plane;
+  const float *uv_v_minmax;
+  float uv_v_range_inv;
+  float uv_u_scale;
+} ScrewEdgeData;
+
+static void screw_edge_cb(void *__restrict userdata,
+                          const int iter,
+                          const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const ScrewEdgeData *data = userdata;
+  const Mesh *mesh = data->mesh;
+  Mesh *result = data->result;
+  const uint i = (uint)iter;
+  const uint totvert = data->totvert;
+  const uint totedge = data->totedge;
+  const uint step_tot = data->step_tot;
+  const bool close = data->close;
+  const uint edge_offset = data->edge_offset;
+  const int *quad_ord = data->quad_ord;
+  const int *quad_ord_ofs = data->quad_ord_ofs;
+  const uint mloopuv_layers_tot = data->mloopuv_layers_tot;
+
+  const uint step_last = step_tot - (close ? 1 : 2);
+  const MEdge *med_new_firstloop = &data->medge_new[i];
+  const uint mpoly_index_orig = data->edge_poly_map ? data->edge_poly_map[i] : UINT_MAX;
+  const bool has_mpoly_orig = (mpoly_index_orig != UINT_MAX);
+  float uv_v_offset_a = 0.0f, uv_v_offset_b = 0.0f;
+
+  const uint mloop_index_orig[2] = {
+      data->vert_loop_map ? data->vert_loop_map[med_new_firstloop->v1] : UINT_MAX,
+      data->vert_loop_map ? data->vert_loop_map[med_new_firstloop->v2] : UINT_MAX,
+  };
+  const bool has_mloop_orig = mloop_index_orig[0] != UINT_MAX;
+
+  /* Every edge makes `step_last + 1` faces and `step_tot - 1` vertical edges. */
+  int mpoly_index = (int)(i * (step_last + 1));
+  MPoly *mp_new = &data->mpoly_new[mpoly_index];
+  MLoop *ml_new = &data->mloop_new[mpoly_index * 4];
+  MEdge *med_new = &data->medge_new[edge_offset + (i * (step_tot - 1))];
+
+  short mat_nr;
+
+  /* for each edge, make a cylinder of quads */
+  uint i1 = med_new_firstloop->v1;
+  uint i2 = med_new_firstloop->v2;
+
+  if (has_mpoly_orig) {
+    mat_nr = data->mpoly_orig[mpoly_index_orig].mat_nr;
+  }
+  else {
+    mat_nr = 0;
+  }
+
+  if (has_mloop_orig == false && mloopuv_layers_tot) {
+    uv_v_offset_a = dist_signed_to_plane_v3(data->mvert_new[med_new_firstloop->v1].co,
+                                            data->uv_axis_plane);
+    uv_v_offset_b = dist_signed_to_plane_v3(data->mvert_new[med_new_firstloop->v2].co,
+                                            data->uv_axis_plane);
+
+    if (data->ltmd->flag & MOD_SCREW_UV_STRETCH_V) {
+      uv_v_offset_a = (uv_v_offset_a - data->uv_v_minmax[0]) * data->uv_v_range_inv;
+      uv_v_offset_b = (uv_v_offset_b - data->uv_v_minmax[0]) * data->uv_v_range_inv;
+    }
+  }
+
+  for (uint step = 0; step <= step_last; step++) {
+
+    /* Polygon */
+    if (has_mpoly_orig) {
+      CustomData_copy_data(
+          &mesh->pdata, &result->pdata, (int)mpoly_index_orig, (int)mpoly_index, 1);
+      data->origindex[mpoly_index] = (int)mpoly_index_orig;
+    }
+    else {
+      data->origindex[mpoly_index] = ORIGINDEX_NONE;
+      mp_new->flag = data->mpoly_flag;
+      mp_new->mat_nr = mat_nr;
+    }
+    mp_new->loopstart = mpoly_index * 4;
+    mp_new->totloop = 4;
+
+    /* Loop-Custom-Data */
+    if (has_mloop_orig) {
+      int l_index = (int)(ml_new - data->mloop_new);
+
+      CustomData_copy_data(
+          &mesh->ldata, &result->ldata, (int)mloop_index_orig[0], l_index + 0, 1);
+      CustomData_copy_data(
+          &mesh->ldata, &result->ldata, (int)mloop_index_orig[1], l_index + 1, 1);
+      CustomData_copy_data(
+          &mesh->ldata, &result->ldata, (int)mloop_index_orig[1], l_index + 2, 1);
+      CustomData_copy_data(
+          &mesh->ldata, &result->ldata, (int)mloop_index_orig[0], l_index + 3, 1);
+
+      if (mloopuv_layers_tot) {
+        uint uv_lay;
+        const float uv_u_offset_a = (float)(step)*data->uv_u_scale;
+        const float uv_u_offset_b = (float)(step + 1) * data->uv_u_scale;
+        for (uv_lay = 0; uv_lay < mloopuv_layers_tot; uv_lay++) {
+          MLoopUV *mluv = &data->mloopuv_layers[uv_lay][l_index];
+
+          mluv[quad_ord[0]].uv[0] += uv_u_offset_a;
+          mluv[quad_ord[1]].uv[0] += uv_u_offset_a;
+          mluv[quad_ord[2]].uv[0] += uv_u_offset_b;
+          mluv[quad_ord[3]].uv[0] += uv_u_offset_b;
+        }
+      }
+    }
+    else {
+      if (mloopuv_layers_tot) {
+        int l_index = (int)(ml_new - data->mloop_new);
+
+        uint uv_lay;
+        const float uv_u_offset_a = (float)(step)*data->uv_u_scale;
+        const float uv_u_offset_b = (float)(step + 1) * data->uv_u_scale;
+        for (uv_lay = 0; uv_lay < mloopuv_layers_tot; uv_lay++) {
+          MLoopUV *mluv = &data->mloopuv_layers[uv_lay][l_index];
+
+          copy_v2_fl2(mluv[quad_ord[0]].uv, uv_u_offset_a, uv_v_offset_a);
+          copy_v2_fl2(mluv[quad_ord[1]].uv, uv_u_offset_a, uv_v_offset_b);
+          copy_v2_fl2(mluv[quad_ord[2]].uv, uv_u_offset_b, uv_v_offset_b);
+          copy_v2_fl2(mluv[quad_ord[3]].uv, uv_u_offset_b, uv_v_offset_a);
+        }
+      }
+    }
+
+    /* Loop-Data */
+    if (!(close && step == step_last)) {
+      /* regular segments */
+      ml_new[quad_ord[0]].v = i1;
+      ml_new[quad_ord[1]].v = i2;
+      ml_new[quad_ord[2]].v = i2 + totvert;
+      ml_new[quad_ord[3]].v = i1 + totvert;
+
+      ml_new[quad_ord_ofs[0]].e = step == 0 ? i :
+                                              (edge_offset + step + (i * (step_tot - 1))) - 1;
+      ml_new[quad_ord_ofs[1]].e = totedge + i2;
+      ml_new[quad_ord_ofs[2]].e = edge_offset + step + (i * (step_tot - 1));
+      ml_new[quad_ord_ofs[3]].e = totedge + i1;
+
+      /* new vertical edge */
+      if (step) { /* The first set is already done */
+        med_new->v1 = i1;
+        med_new->v2 = i2;
+        med_new->flag = med_new_firstloop->flag;
+        med_new->crease = med_new_firstloop->crease;
+        med_new++;
+      }
+      i1 += totvert;
+      i2 += totvert;
+    }
+    else {
+      /* last segment */
+      ml_new[quad_ord[0]].v = i1;
+      ml_new[quad_ord[1]].v = i2;
+      ml_new[quad_ord[2]].v = med_new_firstloop->v2;
+      ml_new[quad_ord[3]].v = med_new_firstloop->v1;
+
+      ml_new[quad_ord_ofs[0]].e = (edge_offset + step + (i * (step_tot - 1))) - 1;
+      ml_new[quad_ord_ofs[1]].e = totedge + i2;
+      ml_new[quad_ord_ofs[2]].e = i;
+      ml_new[quad_ord_ofs[3]].e = totedge + i1;
+    }
+
+    mp_new++;
+    ml_new += 4;
+    mpoly_index++;
+  }
+
+  /* new vertical edge */
+  med_new->v1 = i1;
+  med_new->v2 = i2;
+  med_new->flag = med_new_firstloop->flag & ~ME_LOOSEEDGE;
+  med_new->crease = med_new_firstloop->crease;
+}
+
+/** \} */
+
 static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *meshData)
 {
   Mesh *mesh = meshData;
@@ -182,10 +484,7 @@ static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *
   ScrewModifierData *ltmd = (ScrewModifierData *)md;
   const bool use_render_params = (ctx->flag & MOD_APPLY_RENDER) != 0;
 
-  int mpoly_index = 0;
-  uint step;
   uint i, j;
-  uint i1, i2;
   uint step_tot = use_render_params ? ltmd->render_steps : ltmd->steps;
   const bool do_flip = (ltmd->flag & MOD_SCREW_NORMAL_FLIP) != 0;
 
@@ -215,7 +514,7 @@ static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *
   MLoopUV **mloopuv_layers = BLI_array_alloca(mloopuv_layers, mloopuv_layers_tot);
   float uv_u_scale;
   float uv_v_minmax[2] = {FLT_MAX, -FLT_MAX};
-  float uv_v_range_inv;
+  float uv_v_range_inv = 0.0f;
   float uv_axis_plane[4];
 
   char axis_char = 'X';
@@ -224,7 +523,6 @@ static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *
   float screw_ofs = ltmd->screw_ofs;
   float axis_vec[3] = {0.0f, 0.0f, 0.0f};
   float tmp_vec1[3], tmp_vec2[3];
-  float mat3[3][3];
   /* transform the coords by an object relative to this objects transformation */
   float mtx_tx[4][4];
   float mtx_tx_inv[4][4]; /* inverted */
@@ -236,10 +534,10 @@ static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *
 
   uint edge_offset;
 
-  MPoly *mpoly_orig, *mpoly_new, *mp_new;
-  MLoop *mloop_orig, *mloop_new, *ml_new;
-  MEdge *medge_orig, *med_orig, *med_new, *med_new_firstloop, *medge_new;
-  MVert *mvert_new, *mvert_orig, *mv_orig, *mv_new, *mv_new_base;
+  MPoly *mpoly_orig, *mpoly_new;
+  MLoop *mloop_orig, *mloop_new;
+  MEdge *medge_orig, *med_orig, *med_new, *medge_new;
+  MVert *mvert_new, *mvert_orig, *mv_orig, *mv_new;
 
   Object *ob_axis = ltmd->ob_axis;
 
@@ -852,66 +1150,32 @@ static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *
   /* done with edge connectivity based normal flipping */
 
   /* Add Faces */
-  for (step = 1; step < step_tot; step++) {
-    const uint varray_stride = totvert * step;
-    float step_angle;
-    float mat[4][4];
-    /* Rotation Matrix */
-    step_angle = (angle / (float)(step_tot - (!close))) * (float)step;
-
-    if (ob_axis != NULL) {
-      axis_angle_normalized_to_mat3(mat3, axis_vec, step_angle);
-    }
-    else {
-      axis_angle_to_mat3_single(mat3, axis_char, step_angle);
-    }
-    copy_m4_m3(mat, mat3);
-
-    if (screw_ofs) {
-      madd_v3_v3fl(mat[3], axis_vec, screw_ofs * ((float)step / (float)(step_tot - 1)));
-    }
-
-    /* copy a slice */
-    CustomData_copy_data(&mesh->vdata, &result->vdata, 0, (int)varray_stride, (int)totvert);
-
-    mv_new_base = mvert_new;
-    mv_new = &mvert_new[varray_stride]; /* advance to the next slice */
-
-    for (j = 0; j < totvert; j++, mv_new_base++, mv_new++) {
-      /* set normal */
-      if (vert_connect) {
-        if (do_normal_create) {
-          /* Set the normal now its transformed. */
-          mul_v3_m3v3(vert_normals_new[mv_new - mvert_new], mat3, vert_connect[j].no);
-        }
-      }
-
-      /* set location */
-      copy_v3_v3(mv_new->co, mv_new_base->co);
-
-      /* only need to set these if using non cleared memory */
-      // mv_new->mat_nr = mv_new->flag = 0;
-
-      if (ob_axis != NULL) {
-        sub_v3_v3(mv_new->co, mtx_tx[3]);
+  {
+    ScrewStepData data = {
+        .mesh = mesh,
+        .result = result,
+        .mvert_new = mvert_new,
+        .medge_step = med_new,
+        .vert_connect = vert_connect,
+        .vert_normals_new = vert_normals_new,
+        .vert_tag = vert_tag,
+        .totvert = totvert,
+        .step_tot = step_tot,
+        .close = close,
+        .angle = angle,
+        .screw_ofs = screw_ofs,
+        .axis_vec = axis_vec,
+        .axis_char = axis_char,
+        .axis_co = (ob_axis != NULL) ? mtx_tx[3] : NULL,
+    };
 
-        mul_m4_v3(mat, mv_new->co);
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.use_threading = (totvert * (step_tot - 1)) > 1024;
+    settings.min_iter_per_thread = (int)max_uu(1, 1024 / totvert);
+    BLI_task_parallel_range(1, (int)step_tot, &data, screw_step_cb, &settings);
 
-        add_v3_v3(mv_new->co, mtx_tx[3]);
-      }
-      else {
-        mul_m4_v3(mat, mv_new->co);
-      }
-
-      /* add the new edge */
-      med_new->v1 = varray_stride + j;
-      med_new->v2 = med_new->v1 - totvert;
-      med_new->flag = ME_EDGEDRAW | ME_EDGERENDER;
-      if (!BLI_BITMAP_TEST(vert_tag, j)) {
-        med_new->flag |= ME_LOOSEEDGE;
-      }
-      med_new++;
-    }
+    med_new += totvert * (step_tot - 1);
   }
 
   /* we can avoid if using vert alloc trick */
@@ -935,158 +1199,46 @@ static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *
     }
   }
 
-  mp_new = mpoly_new;
-  ml_new = mloop_new;
-  med_new_firstloop = medge_new;
-
   /* more of an offset in this case */
   edge_offset = totedge + (totvert * (step_tot - (close ? 0 : 1)));
+  BLI_assert(med_new == &medge_new[edge_offset]);
 
-  for (i = 0; i < totedge; i++, med_new_firstloop++) {
-    const uint step_last = step_tot - (close ? 1 : 2);
-    const uint mpoly_index_orig = totpoly ? edge_poly_map[i] : UINT_MAX;
-    const bool has_mpoly_orig = (mpoly_index_orig != UINT_MAX);
-    float uv_v_offset_a, uv_v_offset_b;
-
-    const uint mloop_index_orig[2] = {
-        vert_loop_map ? vert_loop_map[medge_new[i].v1] : UINT_MAX,
-        vert_loop_map ? vert_loop_map[medge_new[i].v2] : UINT_MAX,
+  {
+    ScrewEdgeData data = {
+        .ltmd = ltmd,
+        .mesh = mesh,
+        .result = result,
+        .totvert = totvert,
+        .totedge = totedge,
+        .step_tot = step_tot,
+        .close = close,
+        .edge_offset = edge_offset,
+        .edge_poly_map = totpoly ? edge_poly_map : NULL,
+        .vert_loop_map = vert_loop_map,
+        .mpoly_orig = mesh->mpoly,
+        .mvert_new = mvert_new,
+        .medge_new = medge_new,
+        .mpoly_new = mpoly_new,
+        .mloop_new = mloop_new,
+        .origindex = origindex,
+        .mpoly_flag = mpoly_flag,
+        .quad_ord = quad_ord,
+        .quad_ord_ofs = quad_ord_ofs,
+        .mloopuv_layers = mloopuv_layers,
+        .mloopuv_layers_tot = mloopuv_layers_tot,
+        .uv_axis_plane = uv_axis_plane,
+        .uv_v_minmax = uv_v_minmax,
+        .uv_v_range_inv = uv_v_range_inv,
+        .uv_u_scale = uv_u_scale,
     };
-    const bool has_mloop_orig = mloop_index_orig[0] != UINT_MAX;
-
-    short mat_nr;
-
-    /* for each edge, make a cylinder of quads */
-    i1 = med_new_firstloop->v1;
-    i2 = med_new_firstloop->v2;
-
-    if (has_mpoly_orig) {
-      mat_nr = mpoly_orig[mpoly_index_orig].mat_nr;
-    }
-    else {
-      mat_nr = 0;
-    }
-
-    if (has_mloop_orig == false && mloopuv_layers_tot) {
-      uv_v_offset_a = dist_signed_to_plane_v3(mvert_new[medge_new[i].v1].co, uv_axis_plane);
-      uv_v_offset_b = dist_signed_to_plane_v3(mvert_new[medge_new[i].v2].co, uv_axis_plane);
-
-      if (ltmd->flag & MOD_SCREW_UV_STRETCH_V) {
-        uv_v_offset_a = (uv_v_offset_a - uv_v_minmax[0]) * uv_v_range_inv;
-        uv_v_offset_b = (uv_v_offset_b - uv_v_minmax[0]) * uv_v_range_inv;
-      }
-    }
-
-    for (step = 0; step <= step_last; step++) {
-
-      /* Polygon */
-      if (has_mpoly_orig) {
-        CustomData_copy_data(
-            &mesh->pdata, &result->pdata, (int)mpoly_index_orig, (int)mpoly_index, 1);
-        origindex[mpoly_index] = (int)mpoly_index_orig;
-      }
-      else {
-        origindex[mpoly_index] = ORIGINDEX_NONE;
-        mp_new->flag = mpoly_flag;
-        mp_new->mat_nr = mat_nr;
-      }
-      mp_new->loopstart = mpoly_index * 4;
-      mp_new->totloop = 4;
-
-      /* Loop-Custom-Data */
-      if (has_mloop_orig) {
-        int l_index = (int)(ml_new - mloop_new);
-
-        CustomData_copy_data(
-            &mesh->ldata, &result->ldata, (int)mloop_index_orig[0], l_index + 0, 1);
-        CustomData_copy_data(
-            &mesh->ldata, &result->ldata, (int)mloop_index_orig[1], l_index + 1, 1);
-        CustomData_copy_data(
-            &mesh->ldata, &result->ldata, (int)mloop_index_orig[1], l_index + 2, 1);
-        CustomData_copy_data(
-            &mesh->ldata, &result->ldata, (int)mloop_index_orig[0], l_index + 3, 1);
-
-        if (mloopuv_layers_tot) {
-          uint uv_lay;
-          const float uv_u_offset_a = (float)(step)*uv_u_scale;
-          const float uv_u_offset_b = (float)(step + 1) * uv_u_scale;
-          for (uv_lay = 0; uv_lay < mloopuv_layers_tot; uv_lay++) {
-            MLoopUV *mluv = &mloopuv_layers[uv_lay][l_index];
-
-            mluv[quad_ord[0]].uv[0] += uv_u_offset_a;
-            mluv[quad_ord[1]].uv[0] += uv_u_offset_a;
-            mluv[quad_ord[2]].uv[0] += uv_u_offset_b;
-            mluv[quad_ord[3]].uv[0] += uv_u_offset_b;
-          }
-        }
-      }
-      else {
-        if (mloopuv_layers_tot) {
-          int l_index = (int)(ml_new - mloop_new);
-
-          uint uv_lay;
-          const float uv_u_offset_a = (float)(step)*uv_u_scale;
-          const float uv_u_offset_b = (float)(step + 1) * uv_u_scale;
-          for (uv_lay = 0; uv_lay < mloopuv_layers_tot; uv_lay++) {
-            MLoopUV *mluv = &mloopuv_layers[uv_lay][l_index];
-
-            copy_v2_fl2(mluv[quad_ord[0]].uv, uv_u_offset_a, uv_v_offset_a);
-            copy_v2_fl2(mluv[quad_ord[1]].uv, uv_u_offset_a, uv_v_offset_b);
-            copy_v2_fl2(mluv[quad_ord[2]].uv, uv_u_offset_b, uv_v_offset_b);
-            copy_v2_fl2(mluv[quad_ord[3]].uv, uv_u_offset_b, uv_v_offset_a);
-          }
-        }
-      }
-
-      /* Loop-Data */
-      if (!(close && step == step_last)) {
-        /* regular segments */
-        ml_new[quad_ord[0]].v = i1;
-        ml_new[quad_ord[1]].v = i2;
-        ml_new[quad_ord[2]].v = i2 + totvert;
-        ml_new[quad_ord[3]].v = i1 + totvert;
-
-        ml_new[quad_ord_ofs[0]].e = step == 0 ? i :
-                                                (edge_offset + step + (i * (step_tot - 1))) - 1;
-        ml_new[quad_ord_ofs[1]].e = totedge + i2;
-        ml_new[quad_ord_ofs[2]].e = edge_offset + step + (i * (step_tot - 1));
-        ml_new[quad_ord_ofs[3]].e = totedge + i1;
-
-        /* new vertical edge */
-        if (step) { /* The first set is already done */
-          med_new->v1 = i1;
-          med_new->v2 = i2;
-          med_new->flag = med_new_firstloop->flag;
-          med_new->crease = med_new_firstloop->crease;
-          med_new++;
-        }
-        i1 += totvert;
-        i2 += totvert;
-      }
-      else {
-        /* last segment */
-        ml_new[quad_ord[0]].v = i1;
-        ml_new[quad_ord[1]].v = i2;
-        ml_new[quad_ord[2]].v = med_new_firstloop->v2;
-        ml_new[quad_ord[3]].v = med_new_firstloop->v1;
-
-        ml_new[quad_ord_ofs[0]].e = (edge_offset + step + (i * (step_tot - 1))) - 1;
-        ml_new[quad_ord_ofs[1]].e = totedge + i2;
-        ml_new[quad_ord_ofs[2]].e = i;
-        ml_new[quad_ord_ofs[3]].e = totedge + i1;
-      }
-
-      mp_new++;
-      ml_new += 4;
-      mpoly_index++;
-    }
 
-    /* new vertical edge */
-    med_new->v1 = i1;
-    med_new->v2 = i2;
-    med_new->flag = med_new_firstloop->flag & ~ME_LOOSEEDGE;
-    med_new->crease = med_new_firstloop->crease;
-    med_new++;
+    /* Each edge makes `step_tot - 1` (or `step_tot` when closed) faces. */
+    const uint polys_per_edge = maxPolys / max_uu(totedge, 1);
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.use_threading = maxPolys > 1024;
+    settings.min_iter_per_thread = (int)max_uu(1, 1024 / max_uu(polys_per_edge, 1));
+    BLI_task_parallel_range(0, (int)totedge, &data, screw_edge_cb, &settings);
   }
 
   /* validate loop edges */
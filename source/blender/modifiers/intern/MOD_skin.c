@@ -46,6 +46,7 @@
 #include "BLI_math.h"
 #include "BLI_math_geom.h"
 #include "BLI_stack.h"
+#include "BLI_task.h"
 
 #include "BLT_translation.h"
 
@@ -374,6 +375,115 @@ static bool build_hull(SkinOutput *so, Frame **frames, int totframe)
 #endif
 }
 
+typedef struct SkinBranchHull {
+  /* Frames around the branch node, see collect_hull_frames() */
+  Frame **frames;
+  int totframe;
+  /* Copy of the frames using the vertices of the mesh the hull is built in */
+  Frame *hull_frames;
+  /* Output triangles, using the vertices of the skin mesh */
+  BMVert *(*tris)[3];
+  int tris_num;
+  bool is_valid;
+} SkinBranchHull;
+
+static int skin_vert_index_cmp(const void *a_v, const void *b_v)
+{
+  const int a = BM_elem_index_get(*(BMVert *const *)a_v);
+  const int b = BM_elem_index_get(*(BMVert *const *)b_v);
+  return (a > b) - (a < b);
+}
+
+/* Build the hull of a branch node in its own mesh, so that branches can be
+ * processed in parallel. Frame vertices must have valid indices, the hull
+ * triangles are added to the skin mesh afterwards (see
+ * skin_output_branch_hulls()). */
+static void build_branch_hull(SkinBranchHull *hull, SkinModifierData *smd)
+{
+  SkinOutput so;
+  BMVert **verts_skin, **verts_hull;
+  Frame **hull_frames;
+  BMIter iter;
+  BMFace *f;
+  int verts_num, i, j, k;
+
+  so.smd = smd;
+  so.mat_nr = 0;
+  so.bm = BM_mesh_create(&bm_mesh_allocsize_default,
+                         &((struct BMeshCreateParams){
+                             .use_toolflags = true,
+                         }));
+  BM_mesh_elem_toolflags_ensure(so.bm);
+  BMO_push(so.bm, NULL);
+
+  /* Add the frame vertices in the same order as in the skin mesh (merged
+   * corners only once), so the hull doesn't depend on the edge order */
+  verts_skin = MEM_malloc_arrayN(
+      (size_t)hull->totframe * 4, sizeof(*verts_skin), "build_branch_hull.verts_skin");
+  for (i = 0, verts_num = 0; i < hull->totframe; i++) {
+    for (j = 0; j < 4; j++) {
+      verts_skin[verts_num++] = hull->frames[i]->verts[j];
+    }
+  }
+  qsort(verts_skin, (size_t)verts_num, sizeof(*verts_skin), skin_vert_index_cmp);
+  for (i = 0, j = 0; i < verts_num; i++) {
+    if (j == 0 || verts_skin[i] != verts_skin[j - 1]) {
+      verts_skin[j++] = verts_skin[i];
+    }
+  }
+  verts_num = j;
+
+  verts_hull = MEM_malloc_arrayN(
+      (size_t)verts_num, sizeof(*verts_hull), "build_branch_hull.verts_hull");
+  for (i = 0; i < verts_num; i++) {
+    verts_hull[i] = BM_vert_create(so.bm, verts_skin[i]->co, NULL, BM_CREATE_NOP);
+  }
+
+  hull->hull_frames = MEM_malloc_arrayN(
+      (size_t)hull->totframe, sizeof(*hull->hull_frames), "build_branch_hull.hull_frames");
+  hull_frames = MEM_malloc_arrayN(
+      (size_t)hull->totframe, sizeof(*hull_frames), "build_branch_hull.hull_frames_p");
+  for (i = 0; i < hull->totframe; i++) {
+    Frame *frame = &hull->hull_frames[i];
+
+    *frame = *hull->frames[i];
+    for (j = 0; j < 4; j++) {
+      for (k = 0; verts_skin[k] != frame->verts[j]; k++) {
+        /* pass */
+      }
+      frame->verts[j] = verts_hull[k];
+    }
+    hull_frames[i] = frame;
+  }
+
+  hull->is_valid = build_hull(&so, hull_frames, hull->totframe);
+
+  if (hull->is_valid) {
+    /* Vertices are never removed, indices match verts_skin */
+    BM_mesh_elem_index_ensure(so.bm, BM_VERT);
+
+    hull->tris = MEM_malloc_arrayN(
+        (size_t)so.bm->totface, sizeof(*hull->tris), "build_branch_hull.tris");
+    BM_ITER_MESH (f, &iter, so.bm, BM_FACES_OF_MESH) {
+      BMVert *tri[3];
+
+      BLI_assert(f->len == 3);
+      BM_face_as_array_vert_tri(f, tri);
+      for (j = 0; j < 3; j++) {
+        hull->tris[hull->tris_num][j] = verts_skin[BM_elem_index_get(tri[j])];
+      }
+      hull->tris_num++;
+    }
+  }
+
+  MEM_freeN(hull_frames);
+  MEM_freeN(verts_hull);
+  MEM_freeN(verts_skin);
+
+  BMO_pop(so.bm);
+  BM_mesh_free(so.bm);
+}
+
 /* Returns the average frame side length (frames are rectangular, so
  * just the average of two adjacent edge lengths) */
 static float frame_len(const Frame *frame)
@@ -648,25 +758,53 @@ static void connection_node_frames(int v,
   create_frame(&skin_nodes[v].frames[0], mvert[v].co, rad, mat, 0);
 }
 
+typedef struct BuildFramesData {
+  SkinNode *skin_nodes;
+  const MVert *mvert;
+  const MVertSkin *nodes;
+  const MeshElemMap *emap;
+  EMat *emat;
+} BuildFramesData;
+
+static void build_frames_cb(void *__restrict userdata,
+                            const int v,
+                            const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BuildFramesData *data = userdata;
+  const MeshElemMap *emap = data->emap;
+
+  /* Frames of a node only depend on its own edge matrices */
+  if (emap[v].count <= 1) {
+    end_node_frames(v, data->skin_nodes, data->mvert, data->nodes, emap, data->emat);
+  }
+  else if (emap[v].count == 2) {
+    connection_node_frames(v, data->skin_nodes, data->mvert, data->nodes, emap, data->emat);
+  }
+  else {
+    /* Branch node generates no frames */
+  }
+}
+
 static SkinNode *build_frames(
     const MVert *mvert, int verts_num, const MVertSkin *nodes, const MeshElemMap *emap, EMat *emat)
 {
   SkinNode *skin_nodes;
-  int v;
 
   skin_nodes = MEM_calloc_arrayN(verts_num, sizeof(SkinNode), "build_frames.skin_nodes");
 
-  for (v = 0; v < verts_num; v++) {
-    if (emap[v].count <= 1) {
-      end_node_frames(v, skin_nodes, mvert, nodes, emap, emat);
-    }
-    else if (emap[v].count == 2) {
-      connection_node_frames(v, skin_nodes, mvert, nodes, emap, emat);
-    }
-    else {
-      /* Branch node generates no frames */
-    }
-  }
+  BuildFramesData data = {
+      .skin_nodes = skin_nodes,
+      .mvert = mvert,
+      .nodes = nodes,
+      .emap = emap,
+      .emat = emat,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = verts_num > 1024;
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, verts_num, &data, build_frames_cb, &settings);
 
   return skin_nodes;
 }
@@ -879,14 +1017,138 @@ static int calc_edge_subdivisions(const MVert *mvert,
 #undef NUM_SUBDIVISIONS_MAX
 }
 
+typedef struct SubdivideBaseData {
+  const MVert *origvert;
+  const MEdge *origedge;
+  const MVertSkin *orignode;
+  const MDeformVert *origdvert;
+  const int *degree;
+  int orig_vert_num;
+
+  /* Per edge, number of subdivisions and index of its first new vertex */
+  int *edge_subd;
+  const int *edge_subd_offset;
+
+  MVert *outvert;
+  MEdge *outedge;
+  MVertSkin *outnode;
+  MDeformVert *outdvert;
+} SubdivideBaseData;
+
+static void subdivide_base_count_cb(void *__restrict userdata,
+                                    const int i,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const SubdivideBaseData *data = userdata;
+
+  data->edge_subd[i] = calc_edge_subdivisions(
+      data->origvert, data->orignode, &data->origedge[i], data->degree);
+  BLI_assert(data->edge_subd[i] >= 0);
+}
+
+static void subdivide_base_edge_cb(void *__restrict userdata,
+                                   const int i,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const SubdivideBaseData *data = userdata;
+  const MEdge *e = &data->origedge[i];
+  const MDeformVert *origdvert = data->origdvert;
+  const MVertSkin *orignode = data->orignode;
+  MVert *outvert = data->outvert;
+  MVertSkin *outnode = data->outnode;
+  MDeformVert *outdvert = data->outdvert;
+  const int subd_num = data->edge_subd[i];
+  int j, k, u, v;
+  float radrat;
+
+  /* Each original edge is replaced by (subd_num + 1) segments, in order */
+  MEdge *outedge = &data->outedge[i + data->edge_subd_offset[i]];
+  v = data->orig_vert_num + data->edge_subd_offset[i];
+
+  struct {
+    /* Vertex group number */
+    int def_nr;
+    float w1, w2;
+  } *vgroups = NULL, *vg;
+  int vgroups_num = 0;
+
+  if (origdvert) {
+    const MDeformVert *dv1 = &origdvert[e->v1];
+    const MDeformVert *dv2 = &origdvert[e->v2];
+    vgroups = MEM_calloc_arrayN(dv1->totweight, sizeof(*vgroups), "vgroup");
+
+    /* Only want vertex groups used by both vertices */
+    for (j = 0; j < dv1->totweight; j++) {
+      vg = NULL;
+      for (k = 0; k < dv2->totweight; k++) {
+        if (dv1->dw[j].def_nr == dv2->dw[k].def_nr) {
+          vg = &vgroups[vgroups_num];
+          vgroups_num++;
+          break;
+        }
+      }
+
+      if (vg) {
+        vg->def_nr = dv1->dw[j].def_nr;
+        vg->w1 = dv1->dw[j].weight;
+        vg->w2 = dv2->dw[k].weight;
+      }
+    }
+  }
+
+  u = e->v1;
+  radrat = (half_v2(outnode[e->v2].radius) / half_v2(outnode[e->v1].radius));
+  if (isfinite(radrat)) {
+    radrat = (radrat + 1) / 2;
+  }
+  else {
+    /* Happens when skin is scaled to zero. */
+    radrat = 1.0f;
+  }
+
+  /* Add vertices and edge segments */
+  for (j = 0; j < subd_num; j++, v++, outedge++) {
+    float r = (j + 1) / (float)(subd_num + 1);
+    float t = powf(r, radrat);
+
+    /* Interpolate vertex coord */
+    interp_v3_v3v3(outvert[v].co, outvert[e->v1].co, outvert[e->v2].co, t);
+
+    /* Interpolate skin radii */
+    interp_v3_v3v3(outnode[v].radius, orignode[e->v1].radius, orignode[e->v2].radius, t);
+
+    /* Interpolate vertex group weights */
+    for (k = 0; k < vgroups_num; k++) {
+      float weight;
+
+      vg = &vgroups[k];
+      weight = interpf(vg->w2, vg->w1, t);
+
+      if (weight > 0) {
+        BKE_defvert_add_index_notest(&outdvert[v], vg->def_nr, weight);
+      }
+    }
+
+    outedge->v1 = u;
+    outedge->v2 = v;
+    u = v;
+  }
+
+  if (vgroups) {
+    MEM_freeN(vgroups);
+  }
+
+  /* Link up to final vertex */
+  outedge->v1 = u;
+  outedge->v2 = e->v2;
+}
+
 /* Take a Mesh and subdivide its edges to keep skin nodes
  * reasonably close. */
 static Mesh *subdivide_base(const Mesh *orig)
 {
-  const MEdge *e;
   int subd_num;
-  int i, j, k, u, v;
-  float radrat;
+  int i;
 
   const MVertSkin *orignode = CustomData_get_layer(&orig->vdata, CD_MVERT_SKIN);
   const MVert *origvert = orig->mvert;
@@ -904,110 +1166,52 @@ static Mesh *subdivide_base(const Mesh *orig)
 
   /* Per edge, store how many subdivisions are needed */
   int *edge_subd = MEM_calloc_arrayN((uint)orig_edge_num, sizeof(int), "edge_subd");
+  int *edge_subd_offset = MEM_malloc_arrayN((uint)orig_edge_num, sizeof(int), "edge_subd_offset");
+
+  SubdivideBaseData data = {
+      .origvert = origvert,
+      .origedge = origedge,
+      .orignode = orignode,
+      .origdvert = origdvert,
+      .degree = degree,
+      .orig_vert_num = orig_vert_num,
+      .edge_subd = edge_subd,
+      .edge_subd_offset = edge_subd_offset,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = orig_edge_num > 1024;
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, orig_edge_num, &data, subdivide_base_count_cb, &settings);
+
   for (i = 0, subd_num = 0; i < orig_edge_num; i++) {
-    edge_subd[i] += calc_edge_subdivisions(origvert, orignode, &origedge[i], degree);
-    BLI_assert(edge_subd[i] >= 0);
+    edge_subd_offset[i] = subd_num;
     subd_num += edge_subd[i];
   }
 
   MEM_freeN(degree);
+  data.degree = NULL;
 
   /* Allocate output mesh */
   Mesh *result = BKE_mesh_new_nomain_from_template(
       orig, orig_vert_num + subd_num, orig_edge_num + subd_num, 0, 0, 0);
 
-  MVert *outvert = result->mvert;
-  MEdge *outedge = result->medge;
-  MVertSkin *outnode = CustomData_get_layer(&result->vdata, CD_MVERT_SKIN);
-  MDeformVert *outdvert = result->dvert;
+  data.outvert = result->mvert;
+  data.outedge = result->medge;
+  data.outnode = CustomData_get_layer(&result->vdata, CD_MVERT_SKIN);
+  data.outdvert = result->dvert;
 
   /* Copy original vertex data */
   CustomData_copy_data(&orig->vdata, &result->vdata, 0, 0, orig_vert_num);
 
-  /* Subdivide edges */
-  for (i = 0, v = orig_vert_num; i < orig_edge_num; i++) {
-    struct {
-      /* Vertex group number */
-      int def_nr;
-      float w1, w2;
-    } *vgroups = NULL, *vg;
-    int vgroups_num = 0;
-
-    e = &origedge[i];
-
-    if (origdvert) {
-      const MDeformVert *dv1 = &origdvert[e->v1];
-      const MDeformVert *dv2 = &origdvert[e->v2];
-      vgroups = MEM_calloc_arrayN(dv1->totweight, sizeof(*vgroups), "vgroup");
-
-      /* Only want vertex groups used by both vertices */
-      for (j = 0; j < dv1->totweight; j++) {
-        vg = NULL;
-        for (k = 0; k < dv2->totweight; k++) {
-          if (dv1->dw[j].def_nr == dv2->dw[k].def_nr) {
-            vg = &vgroups[vgroups_num];
-            vgroups_num++;
-            break;
-          }
-        }
-
-        if (vg) {
-          vg->def_nr = dv1->dw[j].def_nr;
-          vg->w1 = dv1->dw[j].weight;
-          vg->w2 = dv2->dw[k].weight;
-        }
-      }
-    }
-
-    u = e->v1;
-    radrat = (half_v2(outnode[e->v2].radius) / half_v2(outnode[e->v1].radius));
-    if (isfinite(radrat)) {
-      radrat = (radrat + 1) / 2;
-    }
-    else {
-      /* Happens when skin is scaled to zero. */
-      radrat = 1.0f;
-    }
-
-    /* Add vertices and edge segments */
-    for (j = 0; j < edge_subd[i]; j++, v++, outedge++) {
-      float r = (j + 1) / (float)(edge_subd[i] + 1);
-      float t = powf(r, radrat);
-
-      /* Interpolate vertex coord */
-      interp_v3_v3v3(outvert[v].co, outvert[e->v1].co, outvert[e->v2].co, t);
-
-      /* Interpolate skin radii */
-      interp_v3_v3v3(outnode[v].radius, orignode[e->v1].radius, orignode[e->v2].radius, t);
-
-      /* Interpolate vertex group weights */
-      for (k = 0; k < vgroups_num; k++) {
-        float weight;
-
-        vg = &vgroups[k];
-        weight = interpf(vg->w2, vg->w1, t);
-
-        if (weight > 0) {
-          BKE_defvert_add_index_notest(&outdvert[v], vg->def_nr, weight);
-        }
-      }
-
-      outedge->v1 = u;
-      outedge->v2 = v;
-      u = v;
-    }
-
-    if (vgroups) {
-      MEM_freeN(vgroups);
-    }
-
-    /* Link up to final vertex */
-    outedge->v1 = u;
-    outedge->v2 = e->v2;
-    outedge++;
-  }
+  /* Subdivide edges, every edge writes its own range of new vertices and edges */
+  settings.min_iter_per_thread = 256;
+  settings.use_threading = orig_edge_num > 256;
+  BLI_task_parallel_range(0, orig_edge_num, &data, subdivide_base_edge_cb, &settings);
 
   MEM_freeN(edge_subd);
+  MEM_freeN(edge_subd_offset);
 
   return result;
 }
@@ -1706,12 +1910,59 @@ static void skin_output_connections(SkinOutput *so,
   }
 }
 
+typedef struct SmoothHullsData {
+  BMesh *bm;
+  int skey;
+  float branch_smoothing;
+} SmoothHullsData;
+
+static void skin_smooth_hulls_vert_cb(void *userdata,
+                                      MempoolIterData *mp_v,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const SmoothHullsData *data = userdata;
+  BMesh *bm = data->bm;
+  BMVert *v = (BMVert *)mp_v;
+  BMIter eiter;
+  BMEdge *e;
+  float avg[3];
+  float weight = data->branch_smoothing;
+  int totv = 1;
+
+  if (BM_elem_flag_test(v, BM_ELEM_TAG)) {
+    weight *= 0.5f;
+  }
+
+  /* Only the original coordinates of the neighbors are read, so vertices can be
+   * smoothed in parallel */
+  copy_v3_v3(avg, v->co);
+  BM_ITER_ELEM (e, &eiter, v, BM_EDGES_OF_VERT) {
+    BMVert *other = BM_edge_other_vert(e, v);
+
+    add_v3_v3(
+        avg, CustomData_bmesh_get_n(&bm->vdata, other->head.data, CD_SHAPEKEY, data->skey));
+    totv++;
+  }
+
+  if (totv > 1) {
+    mul_v3_fl(avg, 1.0f / (float)totv);
+    interp_v3_v3v3(v->co, v->co, avg, weight);
+  }
+}
+
+static void skin_smooth_hulls_face_cb(void *UNUSED(userdata),
+                                      MempoolIterData *mp_f,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BM_face_normal_update((BMFace *)mp_f);
+}
+
 static void skin_smooth_hulls(BMesh *bm,
                               SkinNode *skin_nodes,
                               int verts_num,
                               const SkinModifierData *smd)
 {
-  BMIter iter, eiter;
+  BMIter iter;
   BMVert *v;
   int i, j, k, skey;
 
@@ -1741,37 +1992,35 @@ static void skin_smooth_hulls(BMesh *bm,
   /* Smooth vertices, weight unmarked vertices more strongly (helps
    * to smooth frame vertices, but don't want to alter them too
    * much) */
-  BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
-    BMEdge *e;
-    float avg[3];
-    float weight = smd->branch_smoothing;
-    int totv = 1;
-
-    if (BM_elem_flag_test(v, BM_ELEM_TAG)) {
-      weight *= 0.5f;
-    }
-
-    copy_v3_v3(avg, v->co);
-    BM_ITER_ELEM (e, &eiter, v, BM_EDGES_OF_VERT) {
-      BMVert *other = BM_edge_other_vert(e, v);
-
-      add_v3_v3(avg, CustomData_bmesh_get_n(&bm->vdata, other->head.data, CD_SHAPEKEY, skey));
-      totv++;
-    }
+  SmoothHullsData data = {
+      .bm = bm,
+      .skey = skey,
+      .branch_smoothing = smd->branch_smoothing,
+  };
 
-    if (totv > 1) {
-      mul_v3_fl(avg, 1.0f / (float)totv);
-      interp_v3_v3v3(v->co, v->co, avg, weight);
-    }
-  }
+  TaskParallelSettings settings;
+  BLI_parallel_mempool_settings_defaults(&settings);
+  settings.use_threading = bm->totvert >= BM_OMP_LIMIT;
+  BM_iter_parallel(bm, BM_VERTS_OF_MESH, skin_smooth_hulls_vert_cb, &data, &settings);
 
   /* Done with original coordinates */
   BM_data_layer_free_n(bm, &bm->vdata, CD_SHAPEKEY, skey);
 
-  BMFace *f;
-  BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
-    BM_face_normal_update(f);
-  }
+  settings.use_threading = bm->totface >= BM_OMP_LIMIT;
+  BM_iter_parallel(bm, BM_FACES_OF_MESH, skin_smooth_hulls_face_cb, NULL, &settings);
+}
+
+typedef struct BranchHullsData {
+  SkinBranchHull *hulls;
+  SkinModifierData *smd;
+} BranchHullsData;
+
+static void skin_branch_hull_cb(void *__restrict userdata,
+                                const int i,
+                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BranchHullsData *data = userdata;
+  build_branch_hull(&data->hulls[i], data->smd);
 }
 
 /* Returns true if all hulls are successfully built, false otherwise */
@@ -1781,26 +2030,83 @@ static bool skin_output_branch_hulls(SkinOutput *so,
                                      const MeshElemMap *emap,
                                      const MEdge *medge)
 {
+  BMesh *bm = so->bm;
+  SkinBranchHull *hulls;
   bool result = true;
-  int v;
+  int hulls_num = 0;
+  int v, i, j, k;
 
   for (v = 0; v < verts_num; v++) {
-    SkinNode *sn = &skin_nodes[v];
+    if (!skin_nodes[v].totframe) {
+      hulls_num++;
+    }
+  }
+  if (hulls_num == 0) {
+    return result;
+  }
+
+  /* Branch node hulls only share frames with their neighbors, build
+   * them in parallel, then add them to the skin mesh in order */
+  hulls = MEM_calloc_arrayN((size_t)hulls_num, sizeof(*hulls), "skin_output_branch_hulls.hulls");
+  for (v = 0, i = 0; v < verts_num; v++) {
+    if (!skin_nodes[v].totframe) {
+      hulls[i].frames = collect_hull_frames(v, skin_nodes, emap, medge, &hulls[i].totframe);
+      i++;
+    }
+  }
 
-    /* Branch node hulls */
-    if (!sn->totframe) {
-      Frame **hull_frames;
-      int tothullframe;
+  BM_mesh_elem_index_ensure(bm, BM_VERT);
 
-      hull_frames = collect_hull_frames(v, skin_nodes, emap, medge, &tothullframe);
-      if (!build_hull(so, hull_frames, tothullframe)) {
-        result = false;
+  BranchHullsData data = {
+      .hulls = hulls,
+      .smd = so->smd,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = hulls_num > 1;
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, hulls_num, &data, skin_branch_hull_cb, &settings);
+
+  for (i = 0; i < hulls_num; i++) {
+    SkinBranchHull *hull = &hulls[i];
+
+    if (!hull->is_valid) {
+      result = false;
+    }
+    else {
+      for (j = 0; j < hull->tris_num; j++) {
+        BMFace *f = BM_face_exists(hull->tris[j], 3);
+
+        if (f == NULL) {
+          f = BM_face_create_verts(bm, hull->tris[j], 3, NULL, BM_CREATE_NO_DOUBLE, true);
+        }
+        BM_face_normal_update(f);
+        if (so->smd->flag & MOD_SKIN_SMOOTH_SHADING) {
+          BM_elem_flag_enable(f, BM_ELEM_SMOOTH);
+        }
+        f->mat_nr = so->mat_nr;
       }
 
-      MEM_freeN(hull_frames);
+      /* Copy back interior and detached frames */
+      for (j = 0; j < hull->totframe; j++) {
+        Frame *frame = hull->frames[j];
+        const Frame *hull_frame = &hull->hull_frames[j];
+
+        for (k = 0; k < 4; k++) {
+          frame->inside_hull[k] |= hull_frame->inside_hull[k];
+        }
+        frame->detached |= hull_frame->detached;
+      }
     }
+
+    MEM_SAFE_FREE(hull->tris);
+    MEM_SAFE_FREE(hull->hull_frames);
+    MEM_freeN(hull->frames);
   }
 
+  MEM_freeN(hulls);
+
   return result;
 }
 
@@ -24,6 +24,7 @@
 #include "BKE_editmesh.h"
 #include "BKE_lib_id.h"
 #include "BKE_mesh.h"
+#include "BKE_mesh_mapping.h"
 #include "BKE_mesh_wrapper.h"
 #include "BKE_particle.h"
 #include "BKE_screen.h"
@@ -35,6 +36,7 @@
 #include "RNA_prototypes.h"
 
 #include "MOD_modifiertypes.h"
+#include "MOD_smooth_util.h"
 #include "MOD_ui_common.h"
 #include "MOD_util.h"
 
@@ -82,102 +84,62 @@ static void smoothModifier_do(
     return;
   }
 
-  float(*accumulated_vecs)[3] = MEM_calloc_arrayN(
-      (size_t)verts_num, sizeof(*accumulated_vecs), __func__);
-  if (!accumulated_vecs) {
-    return;
-  }
-
-  uint *accumulated_vecs_count = MEM_calloc_arrayN(
-      (size_t)verts_num, sizeof(*accumulated_vecs_count), __func__);
-  if (!accumulated_vecs_count) {
-    MEM_freeN(accumulated_vecs);
-    return;
-  }
-
   const float fac_new = smd->fac;
-  const float fac_orig = 1.0f - fac_new;
   const bool invert_vgroup = (smd->flag & MOD_SMOOTH_INVERT_VGROUP) != 0;
 
-  MEdge *medges = mesh->medge;
-  const int edges_num = mesh->totedge;
-
   MDeformVert *dvert;
   int defgrp_index;
   MOD_get_vgroup(ob, mesh, smd->defgrp_name, &dvert, &defgrp_index);
 
-  for (int j = 0; j < smd->repeat; j++) {
-    if (j != 0) {
-      memset(accumulated_vecs, 0, sizeof(*accumulated_vecs) * (size_t)verts_num);
-      memset(accumulated_vecs_count, 0, sizeof(*accumulated_vecs_count) * (size_t)verts_num);
+  float *vert_factors = NULL;
+  if (dvert) {
+    vert_factors = MEM_malloc_arrayN((size_t)verts_num, sizeof(*vert_factors), __func__);
+    MDeformVert *dv = dvert;
+    for (int i = 0; i < verts_num; i++, dv++) {
+      const float f_new = invert_vgroup ?
+                              (1.0f - BKE_defvert_find_weight(dv, defgrp_index)) * fac_new :
+                              BKE_defvert_find_weight(dv, defgrp_index) * fac_new;
+      vert_factors[i] = max_ff(f_new, 0.0f);
     }
+  }
 
-    for (int i = 0; i < edges_num; i++) {
-      float fvec[3];
-      const uint idx1 = medges[i].v1;
-      const uint idx2 = medges[i].v2;
-
-      mid_v3_v3v3(fvec, vertexCos[idx1], vertexCos[idx2]);
-
-      accumulated_vecs_count[idx1]++;
-      add_v3_v3(accumulated_vecs[idx1], fvec);
-
-      accumulated_vecs_count[idx2]++;
-      add_v3_v3(accumulated_vecs[idx2], fvec);
-    }
-
-    const short flag = smd->flag;
-    if (dvert) {
-      MDeformVert *dv = dvert;
-      for (int i = 0; i < verts_num; i++, dv++) {
-        float *vco_orig = vertexCos[i];
-        if (accumulated_vecs_count[i] > 0) {
-          mul_v3_fl(accumulated_vecs[i], 1.0f / (float)accumulated_vecs_count[i]);
-        }
-        float *vco_new = accumulated_vecs[i];
-
-        const float f_new = invert_vgroup ?
-                                (1.0f - BKE_defvert_find_weight(dv, defgrp_index)) * fac_new :
-                                BKE_defvert_find_weight(dv, defgrp_index) * fac_new;
-        if (f_new <= 0.0f) {
-          continue;
-        }
-        const float f_orig = 1.0f - f_new;
-
-        if (flag & MOD_SMOOTH_X) {
-          vco_orig[0] = f_orig * vco_orig[0] + f_new * vco_new[0];
-        }
-        if (flag & MOD_SMOOTH_Y) {
-          vco_orig[1] = f_orig * vco_orig[1] + f_new * vco_new[1];
-        }
-        if (flag & MOD_SMOOTH_Z) {
-          vco_orig[2] = f_orig * vco_orig[2] + f_new * vco_new[2];
-        }
-      }
-    }
-    else { /* no vertex group */
-      for (int i = 0; i < verts_num; i++) {
-        float *vco_orig = vertexCos[i];
-        if (accumulated_vecs_count[i] > 0) {
-          mul_v3_fl(accumulated_vecs[i], 1.0f / (float)accumulated_vecs_count[i]);
-        }
-        float *vco_new = accumulated_vecs[i];
+  int axis_mask = 0;
+  if (smd->flag & MOD_SMOOTH_X) {
+    axis_mask |= 1 << 0;
+  }
+  if (smd->flag & MOD_SMOOTH_Y) {
+    axis_mask |= 1 << 1;
+  }
+  if (smd->flag & MOD_SMOOTH_Z) {
+    axis_mask |= 1 << 2;
+  }
 
-        if (flag & MOD_SMOOTH_X) {
-          vco_orig[0] = fac_orig * vco_orig[0] + fac_new * vco_new[0];
-        }
-        if (flag & MOD_SMOOTH_Y) {
-          vco_orig[1] = fac_orig * vco_orig[1] + fac_new * vco_new[1];
-        }
-        if (flag & MOD_SMOOTH_Z) {
-          vco_orig[2] = fac_orig * vco_orig[2] + fac_new * vco_new[2];
+  /* Vertices without edges have no average to move towards, they move towards the origin. */
+  const MeshElemMap *vert_map = MOD_smooth_vert_map_ensure(&smd->modifier, mesh);
+  for (int i = 0; i < verts_num; i++) {
+    if (vert_map[i].count == 0) {
+      const float f_orig = powf(1.0f - (vert_factors ? vert_factors[i] : fac_new),
+                                (float)smd->repeat);
+      for (int axis = 0; axis < 3; axis++) {
+        if (axis_mask & (1 << axis)) {
+          vertexCos[i][axis] *= f_orig;
         }
       }
     }
   }
 
-  MEM_freeN(accumulated_vecs);
-  MEM_freeN(accumulated_vecs_count);
+  /* Each vertex moves towards the average of its edge centers, which is half way to the average
+   * of the connected vertices. The vertex factors already include #SmoothModifierData.fac. */
+  const ModSmoothParams params = {
+      .weight = MOD_SMOOTH_WEIGHT_UNIFORM,
+      .iterations = smd->repeat,
+      .factor = vert_factors ? 0.5f : fac_new * 0.5f,
+      .vert_factors = vert_factors,
+      .axis_mask = axis_mask,
+  };
+  MOD_smooth_vert_coords(vert_map, vertexCos, verts_num, &params);
+
+  MEM_SAFE_FREE(vert_factors);
 }
 
 static void deformVerts(ModifierData *md,
@@ -222,6 +184,17 @@ static void deformVertsEM(ModifierData *md,
   }
 }
 
+static void freeRuntimeData(void *runtime_data_v)
+{
+  MOD_smooth_vert_map_free(runtime_data_v);
+}
+
+static void freeData(ModifierData *md)
+{
+  freeRuntimeData(md->runtime);
+  md->runtime = NULL;
+}
+
 static void panel_draw(const bContext *UNUSED(C), Panel *panel)
 {
   uiLayout *row, *col;
@@ -273,14 +246,14 @@ ModifierTypeInfo modifierType_Smooth = {
 
     /* initData */ initData,
     /* requiredDataMask */ requiredDataMask,
-    /* freeData */ NULL,
+    /* freeData */ freeData,
     /* isDisabled */ isDisabled,
     /* updateDepsgraph */ NULL,
     /* dependsOnTime */ NULL,
     /* dependsOnNormals */ NULL,
     /* foreachIDLink */ NULL,
     /* foreachTexLink */ NULL,
-    /* freeRuntimeData */ NULL,
+    /* freeRuntimeData */ freeRuntimeData,
     /* panelRegister */ panelRegister,
     /* blendWrite */ NULL,
     /* blendRead */ NULL,
@@ -0,0 +1,211 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup modifiers
+ */
+
+#include <string.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_utildefines.h"
+
+#include "BLI_math.h"
+#include "BLI_task.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_modifier_types.h"
+
+#include "BKE_mesh_mapping.h"
+
+#include "MOD_smooth_util.h"
+
+#include "BLI_strict_flags.h"
+
+typedef struct SmoothVertMapCache {
+  MeshElemMap *vert_map;
+  int *vert_map_mem;
+  /** Vertex indices of the edges the map was built from, to detect topology changes. */
+  uint (*edge_verts)[2];
+  int verts_num;
+  int edges_num;
+} SmoothVertMapCache;
+
+static bool smooth_vert_map_cache_matches(const SmoothVertMapCache *cache, const Mesh *mesh)
+{
+  if (cache->verts_num != mesh->totvert || cache->edges_num != mesh->totedge) {
+    return false;
+  }
+  const MEdge *medge = mesh->medge;
+  for (int i = 0; i < mesh->totedge; i++) {
+    if (cache->edge_verts[i][0] != medge[i].v1 || cache->edge_verts[i][1] != medge[i].v2) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const MeshElemMap *MOD_smooth_vert_map_ensure(ModifierData *md, const Mesh *mesh)
+{
+  SmoothVertMapCache *cache = md->runtime;
+
+  if (cache != NULL) {
+    if (smooth_vert_map_cache_matches(cache, mesh)) {
+      return cache->vert_map;
+    }
+    MOD_smooth_vert_map_free(cache);
+  }
+
+  cache = MEM_callocN(sizeof(*cache), __func__);
+  BKE_mesh_vert_edge_vert_map_create(
+      &cache->vert_map, &cache->vert_map_mem, mesh->medge, mesh->totvert, mesh->totedge);
+  cache->edge_verts = MEM_malloc_arrayN(
+      (size_t)mesh->totedge, sizeof(*cache->edge_verts), __func__);
+  for (int i = 0; i < mesh->totedge; i++) {
+    cache->edge_verts[i][0] = mesh->medge[i].v1;
+    cache->edge_verts[i][1] = mesh->medge[i].v2;
+  }
+  cache->verts_num = mesh->totvert;
+  cache->edges_num = mesh->totedge;
+
+  md->runtime = cache;
+  return cache->vert_map;
+}
+
+void MOD_smooth_vert_map_free(void *runtime_data)
+{
+  SmoothVertMapCache *cache = runtime_data;
+  if (cache == NULL) {
+    return;
+  }
+  MEM_SAFE_FREE(cache->vert_map);
+  MEM_SAFE_FREE(cache->vert_map_mem);
+  MEM_SAFE_FREE(cache->edge_verts);
+  MEM_freeN(cache);
+}
+
+typedef struct SmoothIterData {
+  const MeshElemMap *vert_map;
+  const ModSmoothParams *params;
+  const float (*coords_prev)[3];
+  float (*coords_next)[3];
+} SmoothIterData;
+
+BLI_INLINE void smooth_vert_apply(const SmoothIterData *data,
+                                  const int i,
+                                  const float delta[3],
+                                  const float fac)
+{
+  const float *co_prev = data->coords_prev[i];
+  float *co_next = data->coords_next[i];
+  const int axis_mask = data->params->axis_mask;
+
+  for (int axis = 0; axis < 3; axis++) {
+    co_next[axis] = (axis_mask & (1 << axis)) ? co_prev[axis] + delta[axis] * fac : co_prev[axis];
+  }
+}
+
+BLI_INLINE float smooth_vert_factor(const ModSmoothParams *params, const int i)
+{
+  return params->vert_factors ? params->factor * params->vert_factors[i] : params->factor;
+}
+
+static void smooth_iter_uniform_cb(void *__restrict userdata,
+                                   const int i,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const SmoothIterData *data = userdata;
+  const MeshElemMap *map = &data->vert_map[i];
+  const float *co = data->coords_prev[i];
+
+  if (map->count == 0) {
+    copy_v3_v3(data->coords_next[i], co);
+    return;
+  }
+
+  float delta[3] = {0.0f, 0.0f, 0.0f};
+  for (int j = 0; j < map->count; j++) {
+    const float *co_other = data->coords_prev[map->indices[j]];
+    delta[0] += co_other[0] - co[0];
+    delta[1] += co_other[1] - co[1];
+    delta[2] += co_other[2] - co[2];
+  }
+
+  smooth_vert_apply(data, i, delta, smooth_vert_factor(data->params, i) / (float)map->count);
+}
+
+static void smooth_iter_edge_length_cb(void *__restrict userdata,
+                                       const int i,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const float eps = FLT_EPSILON * 10.0f;
+  const SmoothIterData *data = userdata;
+  const MeshElemMap *map = &data->vert_map[i];
+  const float *co = data->coords_prev[i];
+
+  float delta[3] = {0.0f, 0.0f, 0.0f};
+  float edge_length_sum = 0.0f;
+  for (int j = 0; j < map->count; j++) {
+    float edge_dir[3];
+    sub_v3_v3v3(edge_dir, data->coords_prev[map->indices[j]], co);
+    const float edge_length = len_v3(edge_dir);
+    madd_v3_v3fl(delta, edge_dir, edge_length);
+    edge_length_sum += edge_length;
+  }
+
+  /* Divide by sum of all neighbor distances (weighted) and amount of neighbors,
+   * (mean average). */
+  const float div = edge_length_sum * (float)map->count;
+  if (div > eps) {
+    smooth_vert_apply(data, i, delta, smooth_vert_factor(data->params, i) / div);
+  }
+  else {
+    copy_v3_v3(data->coords_next[i], co);
+  }
+}
+
+void MOD_smooth_vert_coords(const MeshElemMap *vert_map,
+                            float (*vertexCos)[3],
+                            const int verts_num,
+                            const ModSmoothParams *params)
+{
+  if (params->iterations <= 0 || verts_num == 0) {
+    return;
+  }
+
+  float(*coords_tmp)[3] = MEM_malloc_arrayN((size_t)verts_num, sizeof(*coords_tmp), __func__);
+
+  SmoothIterData data = {
+      .vert_map = vert_map,
+      .params = params,
+      .coords_prev = (const float(*)[3])vertexCos,
+      .coords_next = coords_tmp,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = verts_num > 1024;
+  settings.min_iter_per_thread = 1024;
+
+  /* Jacobi iterations, alternating between the two buffers. */
+  for (int iter = 0; iter < params->iterations; iter++) {
+    BLI_task_parallel_range(0,
+                            verts_num,
+                            &data,
+                            (params->weight == MOD_SMOOTH_WEIGHT_EDGE_LENGTH) ?
+                                smooth_iter_edge_length_cb :
+                                smooth_iter_uniform_cb,
+                            &settings);
+
+    float(*coords_prev)[3] = (float(*)[3])data.coords_prev;
+    data.coords_prev = (const float(*)[3])data.coords_next;
+    data.coords_next = coords_prev;
+  }
+
+  if (data.coords_prev != vertexCos) {
+    memcpy(vertexCos, data.coords_prev, sizeof(*vertexCos) * (size_t)verts_num);
+  }
+
+  MEM_freeN(coords_tmp);
+}
@@ -0,0 +1,49 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup modifiers
+ *
+ * Iterative smoothing shared by the smoothing modifiers.
+ */
+
+#pragma once
+
+struct MeshElemMap;
+struct Mesh;
+struct ModifierData;
+
+typedef enum eModSmoothWeight {
+  /** Move vertices towards the average of the vertices connected by an edge. */
+  MOD_SMOOTH_WEIGHT_UNIFORM = 0,
+  /** Like #MOD_SMOOTH_WEIGHT_UNIFORM, with the neighbors weighted by the edge length. */
+  MOD_SMOOTH_WEIGHT_EDGE_LENGTH = 1,
+} eModSmoothWeight;
+
+typedef struct ModSmoothParams {
+  eModSmoothWeight weight;
+  int iterations;
+  /** How far vertices move towards the average in each iteration. */
+  float factor;
+  /** Optional factor per vertex, multiplied with #factor. */
+  const float *vert_factors;
+  /** Only change the axes in this mask (bits 0-2 for X, Y and Z). */
+  int axis_mask;
+} ModSmoothParams;
+
+/**
+ * The vertices connected to each vertex by an edge, see #BKE_mesh_vert_edge_vert_map_create.
+ * The map is cached in #ModifierData.runtime, which is kept between evaluations, and is only
+ * rebuilt when the edges of \a mesh change. Free it with #MOD_smooth_vert_map_free.
+ */
+const struct MeshElemMap *MOD_smooth_vert_map_ensure(struct ModifierData *md,
+                                                     const struct Mesh *mesh);
+void MOD_smooth_vert_map_free(void *runtime_data);
+
+/**
+ * Smooth \a vertexCos in place. Every iteration reads the coordinates of the previous one, so
+ * vertices are updated in parallel.
+ */
+void MOD_smooth_vert_coords(const struct MeshElemMap *vert_map,
+                            float (*vertexCos)[3],
+                            int verts_num,
+                            const ModSmoothParams *params);
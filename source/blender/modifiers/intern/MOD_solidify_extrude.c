@@ -8,6 +8,7 @@
 
 #include "BLI_bitmap.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 #include "BLI_utildefines_stack.h"
 
 #include "DNA_mesh_types.h"
@@ -150,6 +151,326 @@ static void mesh_calc_hq_normal(Mesh *mesh, const float (*poly_nors)[3], float (
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Parallel Element Generation
+ *
+ * The number of new elements is counted first, their indices are then known
+ * (#old_vert_arr and #new_edge_arr hold the prefix-sums), so the new elements can be filled in
+ * parallel.
+ * \{ */
+
+static void solidify_parallel_range(const uint items_num,
+                                    void *userdata,
+                                    TaskParallelRangeFunc func)
+{
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = items_num > 1024;
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, (int)items_num, userdata, func, &settings);
+}
+
+typedef struct SolidifyShellData {
+  const Mesh *mesh;
+  Mesh *result;
+  short mat_ofs;
+  short mat_nr_max;
+} SolidifyShellData;
+
+/** Reverse the winding of the shell copy of each face. */
+static void solidify_shell_flip_cb(void *__restrict userdata,
+                                   const int iter,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const SolidifyShellData *data = userdata;
+  const Mesh *mesh = data->mesh;
+  Mesh *result = data->result;
+  MPoly *mp = &result->mpoly[mesh->totpoly + iter];
+  const int loop_end = mp->totloop - 1;
+  MLoop *ml2;
+  uint e;
+  int j;
+
+  /* reverses the loop direction (MLoop.v as well as custom-data)
+   * MLoop.e also needs to be corrected too, done in a separate loop below. */
+  ml2 = result->mloop + mp->loopstart + mesh->totloop;
+
+  /* slightly more involved, keep the first vertex the same for the copy,
+   * ensures the diagonals in the new face match the original. */
+  j = 0;
+  for (int j_prev = loop_end; j < mp->totloop; j_prev = j++) {
+    CustomData_copy_data(&mesh->ldata,
+                         &result->ldata,
+                         mp->loopstart + j,
+                         mp->loopstart + (loop_end - j_prev) + mesh->totloop,
+                         1);
+  }
+
+  if (data->mat_ofs) {
+    mp->mat_nr += data->mat_ofs;
+    CLAMP(mp->mat_nr, 0, data->mat_nr_max);
+  }
+
+  e = ml2[0].e;
+  for (j = 0; j < loop_end; j++) {
+    ml2[j].e = ml2[j + 1].e;
+  }
+  ml2[loop_end].e = e;
+
+  mp->loopstart += mesh->totloop;
+
+  for (j = 0; j < mp->totloop; j++) {
+    ml2[j].e += (uint)mesh->totedge;
+    ml2[j].v += (uint)mesh->totvert;
+  }
+}
+
+typedef struct SolidifyOffsetData {
+  /** The first vertex to offset. */
+  MVert *mvert;
+  /** Maps offset vertices to original vertices, NULL when they are aligned. */
+  const uint *new_vert_arr;
+  const float (*vert_nors)[3];
+  float ofs;
+
+  /* Simple thickness. */
+  const MDeformVert *dvert;
+  int defgrp_index;
+  bool defgrp_invert;
+  float offset_fac_vg;
+  float offset_fac_vg_inv;
+  bool do_clamp;
+  bool do_angle_clamp;
+  /** Use the angle clamp of the original (not the new) side. */
+  bool is_ofs_orig;
+  float offset;
+  float offset_sq;
+  const float *vert_lens;
+  const float *vert_angs;
+
+  /* Even thickness. */
+  const float *vert_angles;
+  const float *vert_accum;
+} SolidifyOffsetData;
+
+static void solidify_offset_cb(void *__restrict userdata,
+                               const int iter,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const SolidifyOffsetData *data = userdata;
+  const uint i_orig = (uint)iter;
+  const uint i = data->new_vert_arr ? data->new_vert_arr[i_orig] : i_orig;
+  float ofs_new_vgroup = data->ofs;
+
+  if (data->dvert) {
+    const MDeformVert *dv = &data->dvert[i];
+    if (data->defgrp_invert) {
+      ofs_new_vgroup = 1.0f - BKE_defvert_find_weight(dv, data->defgrp_index);
+    }
+    else {
+      ofs_new_vgroup = BKE_defvert_find_weight(dv, data->defgrp_index);
+    }
+    ofs_new_vgroup = (data->offset_fac_vg + (ofs_new_vgroup * data->offset_fac_vg_inv)) *
+                     data->ofs;
+  }
+  if (data->do_clamp && data->offset > FLT_EPSILON) {
+    const float offset = data->offset;
+    if (data->do_angle_clamp) {
+      float cos_ang = data->is_ofs_orig ? cosf(data->vert_angs[i_orig] * 0.5f) :
+                                          cosf(((2 * M_PI) - data->vert_angs[i]) * 0.5f);
+      if (cos_ang > 0) {
+        float max_off = sqrtf(data->vert_lens[i]) * 0.5f / cos_ang;
+        if (max_off < offset * 0.5f) {
+          ofs_new_vgroup *= max_off / offset * 2;
+        }
+      }
+    }
+    else {
+      if (data->vert_lens[i] < data->offset_sq) {
+        float scalar = sqrtf(data->vert_lens[i]) / offset;
+        ofs_new_vgroup *= scalar;
+      }
+    }
+  }
+  madd_v3_v3fl(data->mvert[i_orig].co, data->vert_nors[i], ofs_new_vgroup);
+}
+
+static void solidify_offset_even_cb(void *__restrict userdata,
+                                    const int iter,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const SolidifyOffsetData *data = userdata;
+  const uint i_orig = (uint)iter;
+  const uint i_other = data->new_vert_arr ? data->new_vert_arr[i_orig] : i_orig;
+
+  if (data->vert_accum[i_other]) { /* zero if unselected */
+    madd_v3_v3fl(data->mvert[i_orig].co,
+                 data->vert_nors[i_other],
+                 data->ofs * (data->vert_angles[i_other] / data->vert_accum[i_other]));
+  }
+}
+
+typedef struct SolidifyRimData {
+  const Mesh *mesh;
+  Mesh *result;
+  const uint *new_vert_arr;
+  const uint *new_edge_arr;
+  const uint *old_vert_arr;
+  const uint *edge_users;
+  const int *edge_order;
+  uint stride;
+  uint newEdges;
+  bool do_shell;
+  short mat_ofs_rim;
+  short mat_nr_max;
+  uchar crease_outer;
+  uchar crease_inner;
+} SolidifyRimData;
+
+/** Copy the rim vertices when there is no shell. */
+static void solidify_rim_vert_copy_cb(void *__restrict userdata,
+                                      const int iter,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const SolidifyRimData *data = userdata;
+  CustomData_copy_data(&data->mesh->vdata,
+                       &data->result->vdata,
+                       (int)data->new_vert_arr[iter],
+                       data->mesh->totvert + iter,
+                       1);
+}
+
+/** Copy the edges opposite to the rim faces when there is no shell. */
+static void solidify_rim_edge_copy_cb(void *__restrict userdata,
+                                      const int iter,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const SolidifyRimData *data = userdata;
+  const uint verts_num = (uint)data->mesh->totvert;
+  const int i = (int)data->new_edge_arr[iter];
+  const int j = data->mesh->totedge + iter;
+  MEdge *medge = data->result->medge;
+
+  CustomData_copy_data(&data->mesh->edata, &data->result->edata, i, j, 1);
+
+  const MEdge *ed_src = &medge[i];
+  MEdge *ed_dst = &medge[j];
+  ed_dst->v1 = data->old_vert_arr[ed_src->v1] + verts_num;
+  ed_dst->v2 = data->old_vert_arr[ed_src->v2] + verts_num;
+}
+
+/** Each rim face is a quad, so its loops are known from its index. */
+static void solidify_rim_face_cb(void *__restrict userdata,
+                                 const int iter,
+                                 const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const SolidifyRimData *data = userdata;
+  const Mesh *mesh = data->mesh;
+  Mesh *result = data->result;
+  const uint verts_num = (uint)mesh->totvert;
+  const uint edges_num = (uint)mesh->totedge;
+  const uint polys_num = (uint)mesh->totpoly;
+  const uint loops_num = (uint)mesh->totloop;
+  const uint stride = data->stride;
+  const uint newEdges = data->newEdges;
+  const bool do_shell = data->do_shell;
+  const uint *old_vert_arr = data->old_vert_arr;
+  MPoly *mpoly = result->mpoly;
+  MEdge *medge = result->medge;
+
+  const uint i = (uint)iter;
+  uint j = i * 4;
+  MPoly *mp = &mpoly[(polys_num * stride) + i];
+  MLoop *ml = &result->mloop[loops_num * stride];
+  uint eidx = data->new_edge_arr[i];
+  uint pidx = data->edge_users[eidx];
+  int k1, k2;
+  bool flip;
+
+  if (pidx >= polys_num) {
+    pidx -= polys_num;
+    flip = true;
+  }
+  else {
+    flip = false;
+  }
+
+  MEdge *ed = medge + eidx;
+
+  /* copy most of the face settings */
+  CustomData_copy_data(
+      &mesh->pdata, &result->pdata, (int)pidx, (int)((polys_num * stride) + i), 1);
+  mp->loopstart = (int)(j + (loops_num * stride));
+  mp->flag = mpoly[pidx].flag;
+
+  /* notice we use 'mp->totloop' which is later overwritten,
+   * we could lookup the original face but there's no point since this is a copy
+   * and will have the same value, just take care when changing order of assignment */
+
+  /* prev loop */
+  k1 = mpoly[pidx].loopstart + (((data->edge_order[eidx] - 1) + mp->totloop) % mp->totloop);
+
+  k2 = mpoly[pidx].loopstart + (data->edge_order[eidx]);
+
+  mp->totloop = 4;
+
+  CustomData_copy_data(&mesh->ldata, &result->ldata, k2, (int)((loops_num * stride) + j + 0), 1);
+  CustomData_copy_data(&mesh->ldata, &result->ldata, k1, (int)((loops_num * stride) + j + 1), 1);
+  CustomData_copy_data(&mesh->ldata, &result->ldata, k1, (int)((loops_num * stride) + j + 2), 1);
+  CustomData_copy_data(&mesh->ldata, &result->ldata, k2, (int)((loops_num * stride) + j + 3), 1);
+
+  if (flip == false) {
+    ml[j].v = ed->v1;
+    ml[j++].e = eidx;
+
+    ml[j].v = ed->v2;
+    ml[j++].e = (edges_num * stride) + old_vert_arr[ed->v2] + newEdges;
+
+    ml[j].v = (do_shell ? ed->v2 : old_vert_arr[ed->v2]) + verts_num;
+    ml[j++].e = (do_shell ? eidx : i) + edges_num;
+
+    ml[j].v = (do_shell ? ed->v1 : old_vert_arr[ed->v1]) + verts_num;
+    ml[j++].e = (edges_num * stride) + old_vert_arr[ed->v1] + newEdges;
+  }
+  else {
+    ml[j].v = ed->v2;
+    ml[j++].e = eidx;
+
+    ml[j].v = ed->v1;
+    ml[j++].e = (edges_num * stride) + old_vert_arr[ed->v1] + newEdges;
+
+    ml[j].v = (do_shell ? ed->v1 : old_vert_arr[ed->v1]) + verts_num;
+    ml[j++].e = (do_shell ? eidx : i) + edges_num;
+
+    ml[j].v = (do_shell ? ed->v2 : old_vert_arr[ed->v2]) + verts_num;
+    ml[j++].e = (edges_num * stride) + old_vert_arr[ed->v2] + newEdges;
+  }
+
+  /* The rim edges used by this face already have their original index cleared,
+   * they are shared with the neighboring rim faces. */
+
+  /* use the next material index if option enabled */
+  if (data->mat_ofs_rim) {
+    mp->mat_nr += data->mat_ofs_rim;
+    CLAMP(mp->mat_nr, 0, data->mat_nr_max);
+  }
+  if (data->crease_outer) {
+    /* crease += crease_outer; without wrapping */
+    char *cr = &(ed->crease);
+    int tcr = *cr + data->crease_outer;
+    *cr = tcr > 255 ? 255 : tcr;
+  }
+
+  if (data->crease_inner) {
+    /* crease += crease_inner; without wrapping */
+    char *cr = &(medge[edges_num + (do_shell ? eidx : i)].crease);
+    int tcr = *cr + data->crease_inner;
+    *cr = tcr > 255 ? 255 : tcr;
+  }
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Main Solidify Function
  * \{ */
@@ -359,29 +680,19 @@ Mesh *MOD_solidify_extrude_modifyMesh(ModifierData *md, const ModifierEvalContex
     CustomData_copy_data(&mesh->pdata, &result->pdata, 0, (int)polys_num, (int)polys_num);
   }
   else {
-    int i, j;
+    SolidifyRimData data = {
+        .mesh = mesh,
+        .result = result,
+        .new_vert_arr = new_vert_arr,
+        .new_edge_arr = new_edge_arr,
+        .old_vert_arr = old_vert_arr,
+    };
+
     CustomData_copy_data(&mesh->vdata, &result->vdata, 0, 0, (int)verts_num);
-    for (i = 0, j = (int)verts_num; i < verts_num; i++) {
-      if (old_vert_arr[i] != INVALID_UNUSED) {
-        CustomData_copy_data(&mesh->vdata, &result->vdata, i, j, 1);
-        j++;
-      }
-    }
+    solidify_parallel_range(rimVerts, &data, solidify_rim_vert_copy_cb);
 
     CustomData_copy_data(&mesh->edata, &result->edata, 0, 0, (int)edges_num);
-
-    for (i = 0, j = (int)edges_num; i < edges_num; i++) {
-      if (!ELEM(edge_users[i], INVALID_UNUSED, INVALID_PAIR)) {
-        MEdge *ed_src, *ed_dst;
-        CustomData_copy_data(&mesh->edata, &result->edata, i, j, 1);
-
-        ed_src = &medge[i];
-        ed_dst = &medge[j];
-        ed_dst->v1 = old_vert_arr[ed_src->v1] + verts_num;
-        ed_dst->v2 = old_vert_arr[ed_src->v2] + verts_num;
-        j++;
-      }
-    }
+    solidify_parallel_range(newEdges, &data, solidify_rim_edge_copy_cb);
 
     /* will be created later */
     CustomData_copy_data(&mesh->ldata, &result->ldata, 0, 0, (int)loops_num);
@@ -413,55 +724,13 @@ Mesh *MOD_solidify_extrude_modifyMesh(ModifierData *md, const ModifierEvalContex
   if (do_shell) {
     uint i;
 
-    mp = mpoly + polys_num;
-    for (i = 0; i < mesh->totpoly; i++, mp++) {
-      const int loop_end = mp->totloop - 1;
-      MLoop *ml2;
-      uint e;
-      int j;
-
-      /* reverses the loop direction (MLoop.v as well as custom-data)
-       * MLoop.e also needs to be corrected too, done in a separate loop below. */
-      ml2 = mloop + mp->loopstart + mesh->totloop;
-#if 0
-      for (j = 0; j < mp->totloop; j++) {
-        CustomData_copy_data(&mesh->ldata,
-                             &result->ldata,
-                             mp->loopstart + j,
-                             mp->loopstart + (loop_end - j) + mesh->totloop,
-                             1);
-      }
-#else
-      /* slightly more involved, keep the first vertex the same for the copy,
-       * ensures the diagonals in the new face match the original. */
-      j = 0;
-      for (int j_prev = loop_end; j < mp->totloop; j_prev = j++) {
-        CustomData_copy_data(&mesh->ldata,
-                             &result->ldata,
-                             mp->loopstart + j,
-                             mp->loopstart + (loop_end - j_prev) + mesh->totloop,
-                             1);
-      }
-#endif
-
-      if (mat_ofs) {
-        mp->mat_nr += mat_ofs;
-        CLAMP(mp->mat_nr, 0, mat_nr_max);
-      }
-
-      e = ml2[0].e;
-      for (j = 0; j < loop_end; j++) {
-        ml2[j].e = ml2[j + 1].e;
-      }
-      ml2[loop_end].e = e;
-
-      mp->loopstart += mesh->totloop;
-
-      for (j = 0; j < mp->totloop; j++) {
-        ml2[j].e += edges_num;
-        ml2[j].v += verts_num;
-      }
-    }
+    SolidifyShellData data = {
+        .mesh = mesh,
+        .result = result,
+        .mat_ofs = mat_ofs,
+        .mat_nr_max = mat_nr_max,
+    };
+    solidify_parallel_range(polys_num, &data, solidify_shell_flip_cb);
 
     for (i = 0, ed = medge + edges_num; i < edges_num; i++, ed++) {
       ed->v1 += verts_num;
@@ -472,7 +741,6 @@ Mesh *MOD_solidify_extrude_modifyMesh(ModifierData *md, const ModifierEvalContex
   /* NOTE: copied vertex layers don't have flipped normals yet. do this after applying offset. */
   if ((smd->flag & MOD_SOLIDIFY_EVEN) == 0) {
     /* no even thickness, very simple */
-    float ofs_new_vgroup;
 
     /* for clamping */
     float *vert_lens = NULL;
@@ -558,104 +826,58 @@ Mesh *MOD_solidify_extrude_modifyMesh(ModifierData *md, const ModifierEvalContex
     }
 
     if (ofs_new != 0.0f) {
-      uint i_orig, i_end;
+      uint i_end;
       bool do_shell_align;
 
-      ofs_new_vgroup = ofs_new;
-
       INIT_VERT_ARRAY_OFFSETS(false);
 
-      for (i_orig = 0; i_orig < i_end; i_orig++, mv++) {
-        const uint i = do_shell_align ? i_orig : new_vert_arr[i_orig];
-        if (dvert) {
-          MDeformVert *dv = &dvert[i];
-          if (defgrp_invert) {
-            ofs_new_vgroup = 1.0f - BKE_defvert_find_weight(dv, defgrp_index);
-          }
-          else {
-            ofs_new_vgroup = BKE_defvert_find_weight(dv, defgrp_index);
-          }
-          ofs_new_vgroup = (offset_fac_vg + (ofs_new_vgroup * offset_fac_vg_inv)) * ofs_new;
-        }
-        if (do_clamp && offset > FLT_EPSILON) {
-          /* always reset because we may have set before */
-          if (dvert == NULL) {
-            ofs_new_vgroup = ofs_new;
-          }
-          if (do_angle_clamp) {
-            float cos_ang = cosf(((2 * M_PI) - vert_angs[i]) * 0.5f);
-            if (cos_ang > 0) {
-              float max_off = sqrtf(vert_lens[i]) * 0.5f / cos_ang;
-              if (max_off < offset * 0.5f) {
-                ofs_new_vgroup *= max_off / offset * 2;
-              }
-            }
-          }
-          else {
-            if (vert_lens[i] < offset_sq) {
-              float scalar = sqrtf(vert_lens[i]) / offset;
-              ofs_new_vgroup *= scalar;
-            }
-          }
-        }
-        if (vert_nors) {
-          madd_v3_v3fl(mv->co, vert_nors[i], ofs_new_vgroup);
-        }
-        else {
-          madd_v3_v3fl(mv->co, mesh_vert_normals[i], ofs_new_vgroup);
-        }
-      }
+      SolidifyOffsetData data = {
+          .mvert = mv,
+          .new_vert_arr = do_shell_align ? NULL : new_vert_arr,
+          .vert_nors = vert_nors ? (const float(*)[3])vert_nors : mesh_vert_normals,
+          .ofs = ofs_new,
+          .dvert = dvert,
+          .defgrp_index = defgrp_index,
+          .defgrp_invert = defgrp_invert,
+          .offset_fac_vg = offset_fac_vg,
+          .offset_fac_vg_inv = offset_fac_vg_inv,
+          .do_clamp = do_clamp,
+          .do_angle_clamp = do_angle_clamp,
+          .is_ofs_orig = false,
+          .offset = offset,
+          .offset_sq = offset_sq,
+          .vert_lens = vert_lens,
+          .vert_angs = vert_angs,
+      };
+      solidify_parallel_range(i_end, &data, solidify_offset_cb);
     }
 
     if (ofs_orig != 0.0f) {
-      uint i_orig, i_end;
+      uint i_end;
       bool do_shell_align;
 
-      ofs_new_vgroup = ofs_orig;
-
       /* as above but swapped */
       INIT_VERT_ARRAY_OFFSETS(true);
 
-      for (i_orig = 0; i_orig < i_end; i_orig++, mv++) {
-        const uint i = do_shell_align ? i_orig : new_vert_arr[i_orig];
-        if (dvert) {
-          MDeformVert *dv = &dvert[i];
-          if (defgrp_invert) {
-            ofs_new_vgroup = 1.0f - BKE_defvert_find_weight(dv, defgrp_index);
-          }
-          else {
-            ofs_new_vgroup = BKE_defvert_find_weight(dv, defgrp_index);
-          }
-          ofs_new_vgroup = (offset_fac_vg + (ofs_new_vgroup * offset_fac_vg_inv)) * ofs_orig;
-        }
-        if (do_clamp && offset > FLT_EPSILON) {
-          /* always reset because we may have set before */
-          if (dvert == NULL) {
-            ofs_new_vgroup = ofs_orig;
-          }
-          if (do_angle_clamp) {
-            float cos_ang = cosf(vert_angs[i_orig] * 0.5f);
-            if (cos_ang > 0) {
-              float max_off = sqrtf(vert_lens[i]) * 0.5f / cos_ang;
-              if (max_off < offset * 0.5f) {
-                ofs_new_vgroup *= max_off / offset * 2;
-              }
-            }
-          }
-          else {
-            if (vert_lens[i] < offset_sq) {
-              float scalar = sqrtf(vert_lens[i]) / offset;
-              ofs_new_vgroup *= scalar;
-            }
-          }
-        }
-        if (vert_nors) {
-          madd_v3_v3fl(mv->co, vert_nors[i], ofs_new_vgroup);
-        }
-        else {
-          madd_v3_v3fl(mv->co, mesh_vert_normals[i], ofs_new_vgroup);
-        }
-      }
+      SolidifyOffsetData data = {
+          .mvert = mv,
+          .new_vert_arr = do_shell_align ? NULL : new_vert_arr,
+          .vert_nors = vert_nors ? (const float(*)[3])vert_nors : mesh_vert_normals,
+          .ofs = ofs_orig,
+          .dvert = dvert,
+          .defgrp_index = defgrp_index,
+          .defgrp_invert = defgrp_invert,
+          .offset_fac_vg = offset_fac_vg,
+          .offset_fac_vg_inv = offset_fac_vg_inv,
+          .do_clamp = do_clamp,
+          .do_angle_clamp = do_angle_clamp,
+          .is_ofs_orig = true,
+          .offset = offset,
+          .offset_sq = offset_sq,
+          .vert_lens = vert_lens,
+          .vert_angs = vert_angs,
+      };
+      solidify_parallel_range(i_end, &data, solidify_offset_cb);
     }
 
     if (do_bevel_convex) {
@@ -916,34 +1138,38 @@ Mesh *MOD_solidify_extrude_modifyMesh(ModifierData *md, const ModifierEvalContex
 #undef INVALID_PAIR
 
     if (ofs_new != 0.0f) {
-      uint i_orig, i_end;
+      uint i_end;
       bool do_shell_align;
 
       INIT_VERT_ARRAY_OFFSETS(false);
 
-      for (i_orig = 0; i_orig < i_end; i_orig++, mv++) {
-        const uint i_other = do_shell_align ? i_orig : new_vert_arr[i_orig];
-        if (vert_accum[i_other]) { /* zero if unselected */
-          madd_v3_v3fl(
-              mv->co, vert_nors[i_other], ofs_new * (vert_angles[i_other] / vert_accum[i_other]));
-        }
-      }
+      SolidifyOffsetData data = {
+          .mvert = mv,
+          .new_vert_arr = do_shell_align ? NULL : new_vert_arr,
+          .vert_nors = (const float(*)[3])vert_nors,
+          .ofs = ofs_new,
+          .vert_angles = vert_angles,
+          .vert_accum = vert_accum,
+      };
+      solidify_parallel_range(i_end, &data, solidify_offset_even_cb);
     }
 
     if (ofs_orig != 0.0f) {
-      uint i_orig, i_end;
+      uint i_end;
       bool do_shell_align;
 
       /* same as above but swapped, intentional use of 'ofs_new' */
       INIT_VERT_ARRAY_OFFSETS(true);
 
-      for (i_orig = 0; i_orig < i_end; i_orig++, mv++) {
-        const uint i_other = do_shell_align ? i_orig : new_vert_arr[i_orig];
-        if (vert_accum[i_other]) { /* zero if unselected */
-          madd_v3_v3fl(
-              mv->co, vert_nors[i_other], ofs_orig * (vert_angles[i_other] / vert_accum[i_other]));
-        }
-      }
+      SolidifyOffsetData data = {
+          .mvert = mv,
+          .new_vert_arr = do_shell_align ? NULL : new_vert_arr,
+          .vert_nors = (const float(*)[3])vert_nors,
+          .ofs = ofs_orig,
+          .vert_angles = vert_angles,
+          .vert_accum = vert_accum,
+      };
+      solidify_parallel_range(i_end, &data, solidify_offset_even_cb);
     }
 
     MEM_freeN(vert_angles);
@@ -1025,7 +1251,6 @@ Mesh *MOD_solidify_extrude_modifyMesh(ModifierData *md, const ModifierEvalContex
 
     int *origindex_edge;
     int *orig_ed;
-    uint j;
 
     if (crease_rim || crease_outer || crease_inner) {
       result->cd_flag |= ME_CDFLAG_EDGE_CREASE;
@@ -1051,115 +1276,37 @@ Mesh *MOD_solidify_extrude_modifyMesh(ModifierData *md, const ModifierEvalContex
     }
 
     /* faces */
-    mp = mpoly + (polys_num * stride);
-    ml = mloop + (loops_num * stride);
-    j = 0;
-    for (i = 0; i < newPolys; i++, mp++) {
-      uint eidx = new_edge_arr[i];
-      uint pidx = edge_users[eidx];
-      int k1, k2;
-      bool flip;
-
-      if (pidx >= polys_num) {
-        pidx -= polys_num;
-        flip = true;
-      }
-      else {
-        flip = false;
-      }
-
-      ed = medge + eidx;
-
-      /* copy most of the face settings */
-      CustomData_copy_data(
-          &mesh->pdata, &result->pdata, (int)pidx, (int)((polys_num * stride) + i), 1);
-      mp->loopstart = (int)(j + (loops_num * stride));
-      mp->flag = mpoly[pidx].flag;
-
-      /* notice we use 'mp->totloop' which is later overwritten,
-       * we could lookup the original face but there's no point since this is a copy
-       * and will have the same value, just take care when changing order of assignment */
-
-      /* prev loop */
-      k1 = mpoly[pidx].loopstart + (((edge_order[eidx] - 1) + mp->totloop) % mp->totloop);
-
-      k2 = mpoly[pidx].loopstart + (edge_order[eidx]);
-
-      mp->totloop = 4;
-
-      CustomData_copy_data(
-          &mesh->ldata, &result->ldata, k2, (int)((loops_num * stride) + j + 0), 1);
-      CustomData_copy_data(
-          &mesh->ldata, &result->ldata, k1, (int)((loops_num * stride) + j + 1), 1);
-      CustomData_copy_data(
-          &mesh->ldata, &result->ldata, k1, (int)((loops_num * stride) + j + 2), 1);
-      CustomData_copy_data(
-          &mesh->ldata, &result->ldata, k2, (int)((loops_num * stride) + j + 3), 1);
-
-      if (flip == false) {
-        ml[j].v = ed->v1;
-        ml[j++].e = eidx;
-
-        ml[j].v = ed->v2;
-        ml[j++].e = (edges_num * stride) + old_vert_arr[ed->v2] + newEdges;
-
-        ml[j].v = (do_shell ? ed->v2 : old_vert_arr[ed->v2]) + verts_num;
-        ml[j++].e = (do_shell ? eidx : i) + edges_num;
-
-        ml[j].v = (do_shell ? ed->v1 : old_vert_arr[ed->v1]) + verts_num;
-        ml[j++].e = (edges_num * stride) + old_vert_arr[ed->v1] + newEdges;
-      }
-      else {
-        ml[j].v = ed->v2;
-        ml[j++].e = eidx;
-
-        ml[j].v = ed->v1;
-        ml[j++].e = (edges_num * stride) + old_vert_arr[ed->v1] + newEdges;
-
-        ml[j].v = (do_shell ? ed->v1 : old_vert_arr[ed->v1]) + verts_num;
-        ml[j++].e = (do_shell ? eidx : i) + edges_num;
-
-        ml[j].v = (do_shell ? ed->v2 : old_vert_arr[ed->v2]) + verts_num;
-        ml[j++].e = (edges_num * stride) + old_vert_arr[ed->v2] + newEdges;
-      }
-
-      if (origindex_edge) {
-        origindex_edge[ml[j - 3].e] = ORIGINDEX_NONE;
-        origindex_edge[ml[j - 1].e] = ORIGINDEX_NONE;
-      }
-
-      /* use the next material index if option enabled */
-      if (mat_ofs_rim) {
-        mp->mat_nr += mat_ofs_rim;
-        CLAMP(mp->mat_nr, 0, mat_nr_max);
-      }
-      if (crease_outer) {
-        /* crease += crease_outer; without wrapping */
-        char *cr = &(ed->crease);
-        int tcr = *cr + crease_outer;
-        *cr = tcr > 255 ? 255 : tcr;
-      }
-
-      if (crease_inner) {
-        /* crease += crease_inner; without wrapping */
-        char *cr = &(medge[edges_num + (do_shell ? eidx : i)].crease);
-        int tcr = *cr + crease_inner;
-        *cr = tcr > 255 ? 255 : tcr;
-      }
+    SolidifyRimData data = {
+        .mesh = mesh,
+        .result = result,
+        .new_vert_arr = new_vert_arr,
+        .new_edge_arr = new_edge_arr,
+        .old_vert_arr = old_vert_arr,
+        .edge_users = edge_users,
+        .edge_order = edge_order,
+        .stride = stride,
+        .newEdges = newEdges,
+        .do_shell = do_shell,
+        .mat_ofs_rim = mat_ofs_rim,
+        .mat_nr_max = mat_nr_max,
+        .crease_outer = crease_outer,
+        .crease_inner = crease_inner,
+    };
+    solidify_parallel_range(newPolys, &data, solidify_rim_face_cb);
 
 #ifdef SOLIDIFY_SIDE_NORMALS
-      if (do_side_normals) {
-        normal_quad_v3(nor,
-                       mvert[ml[j - 4].v].co,
-                       mvert[ml[j - 3].v].co,
-                       mvert[ml[j - 2].v].co,
-                       mvert[ml[j - 1].v].co);
+    if (do_side_normals) {
+      ml = mloop + (loops_num * stride);
+      for (i = 0; i < newPolys; i++, ml += 4) {
+        ed = medge + new_edge_arr[i];
+        normal_quad_v3(
+            nor, mvert[ml[0].v].co, mvert[ml[1].v].co, mvert[ml[2].v].co, mvert[ml[3].v].co);
 
         add_v3_v3(edge_vert_nos[ed->v1], nor);
         add_v3_v3(edge_vert_nos[ed->v2], nor);
       }
-#endif
     }
+#endif
 
 #ifdef SOLIDIFY_SIDE_NORMALS
     if (do_side_normals) {
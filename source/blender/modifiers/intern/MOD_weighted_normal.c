@@ -6,9 +6,9 @@
 
 #include "MEM_guardedalloc.h"
 
-#include "BLI_bitmap.h"
 #include "BLI_linklist.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #include "BLT_translation.h"
 
@@ -23,6 +23,7 @@
 #include "BKE_deform.h"
 #include "BKE_lib_id.h"
 #include "BKE_mesh.h"
+#include "BKE_mesh_mapping.h"
 #include "BKE_screen.h"
 
 #include "UI_interface.h"
@@ -44,13 +45,17 @@ typedef struct ModePair {
   int index; /* Index value per poly or per loop. */
 } ModePair;
 
-/* Sorting function used in modifier, sorts in decreasing order. */
+/* Sorting function used in modifier, sorts in decreasing order.
+ * Equal values are sorted by index, so the result does not depend on the sort implementation. */
 static int modepair_cmp_by_val_inverse(const void *p1, const void *p2)
 {
   ModePair *r1 = (ModePair *)p1;
   ModePair *r2 = (ModePair *)p2;
 
-  return (r1->val < r2->val) ? 1 : ((r1->val > r2->val) ? -1 : 0);
+  if (r1->val != r2->val) {
+    return (r1->val < r2->val) ? 1 : -1;
+  }
+  return (r1->index > r2->index) ? 1 : ((r1->index < r2->index) ? -1 : 0);
 }
 
 /* There will be one of those per vertex
@@ -94,9 +99,8 @@ typedef struct WeightedNormalData {
   /* Lower-level, internal processing data. */
   float cached_inverse_powers_of_weight[NUM_CACHED_INVERSE_POWERS_OF_WEIGHT];
 
-  WeightedNormalDataAggregateItem *items_data;
-
-  ModePair *mode_pair;
+  /* Mode based value of each loop (face area / corner angle / both). */
+  float *loop_values;
 
   int *loop_to_poly;
 } WeightedNormalData;
@@ -139,7 +143,7 @@ static void aggregate_item_normal(WeightedNormalModifierData *wnmd,
 
   const float weight = wn_data->weight;
 
-  float *cached_inverse_powers_of_weight = wn_data->cached_inverse_powers_of_weight;
+  const float *cached_inverse_powers_of_weight = wn_data->cached_inverse_powers_of_weight;
 
   const bool has_vgroup = dvert != NULL;
   const bool vert_of_group = has_vgroup &&
@@ -165,12 +169,9 @@ static void aggregate_item_normal(WeightedNormalModifierData *wnmd,
   }
 
   /* Exponentially divided weight for each normal
-   * (since a few values will be used by most cases, we cache those). */
+   * (since a few values will be used by most cases, we cache those, read-only here since items
+   * are processed in parallel). */
   const int loops_num = item_data->loops_num;
-  if (loops_num < NUM_CACHED_INVERSE_POWERS_OF_WEIGHT &&
-      cached_inverse_powers_of_weight[loops_num] == 0.0f) {
-    cached_inverse_powers_of_weight[loops_num] = 1.0f / powf(weight, loops_num);
-  }
   const float inverted_n_weight = loops_num < NUM_CACHED_INVERSE_POWERS_OF_WEIGHT ?
                                       cached_inverse_powers_of_weight[loops_num] :
                                       1.0f / powf(weight, loops_num);
@@ -178,6 +179,151 @@ static void aggregate_item_normal(WeightedNormalModifierData *wnmd,
   madd_v3_v3fl(item_data->normal, polynors[mp_index], curr_val * inverted_n_weight);
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Parallel Item Processing
+ *
+ * Each item (vertex or smooth fan) only depends on its own loops. Sorting those by decreasing
+ * value gives the same aggregation order as sorting all loops of the mesh, so items are
+ * computed independently and in parallel.
+ * \{ */
+
+typedef struct WeightedNormalItemsData {
+  WeightedNormalModifierData *wnmd;
+  WeightedNormalData *wn_data;
+  bool use_face_influence;
+
+  /* Per vertex items. */
+  const MeshElemMap *vert_to_loop;
+  float (*r_vert_normals)[3];
+
+  /* Per smooth fan items, the loop normals are only overwritten by valid weighted normals. */
+  const MLoopNorSpaceArray *lnors_spacearr;
+  float (*r_loop_normals)[3];
+} WeightedNormalItemsData;
+
+typedef struct WeightedNormalItemsTLS {
+  ModePair *item_loops;
+  int item_loops_len;
+} WeightedNormalItemsTLS;
+
+static ModePair *wn_items_tls_loops_ensure(WeightedNormalItemsTLS *tls, const int len)
+{
+  if (len > tls->item_loops_len) {
+    MEM_SAFE_FREE(tls->item_loops);
+    tls->item_loops_len = max_ii(len, 32);
+    tls->item_loops = MEM_malloc_arrayN(
+        (size_t)tls->item_loops_len, sizeof(*tls->item_loops), __func__);
+  }
+  return tls->item_loops;
+}
+
+static void wn_items_tls_free(const void *__restrict UNUSED(userdata), void *__restrict tls_v)
+{
+  WeightedNormalItemsTLS *tls = tls_v;
+  MEM_SAFE_FREE(tls->item_loops);
+}
+
+/**
+ * Compute the weighted normal of an item from its loops (their #ModePair.val is filled from
+ * #WeightedNormalData.loop_values here). Zero if no valid normal could be computed.
+ */
+static void item_normal_compute(const WeightedNormalItemsData *data,
+                                ModePair *item_loops,
+                                const int item_loops_num,
+                                float r_normal[3])
+{
+  WeightedNormalData *wn_data = data->wn_data;
+  WeightedNormalDataAggregateItem item_data = {{0.0f}};
+  item_data.curr_strength = FACE_STRENGTH_WEAK;
+
+  for (int i = 0; i < item_loops_num; i++) {
+    item_loops[i].val = wn_data->loop_values[item_loops[i].index];
+  }
+  qsort(item_loops, (size_t)item_loops_num, sizeof(*item_loops), modepair_cmp_by_val_inverse);
+
+  for (int i = 0; i < item_loops_num; i++) {
+    const int ml_index = item_loops[i].index;
+    aggregate_item_normal(data->wnmd,
+                          wn_data,
+                          &item_data,
+                          (int)wn_data->mloop[ml_index].v,
+                          wn_data->loop_to_poly[ml_index],
+                          item_loops[i].val,
+                          data->use_face_influence);
+  }
+
+  /* Validate computed weighted normal. */
+  if (normalize_v3(item_data.normal) < CLNORS_VALID_VEC_LEN) {
+    zero_v3(item_data.normal);
+  }
+  copy_v3_v3(r_normal, item_data.normal);
+}
+
+static void wn_vert_item_cb(void *__restrict userdata,
+                            const int mv_index,
+                            const TaskParallelTLS *__restrict tls)
+{
+  const WeightedNormalItemsData *data = userdata;
+  const MeshElemMap *vert_loops = &data->vert_to_loop[mv_index];
+
+  ModePair *item_loops = wn_items_tls_loops_ensure(tls->userdata_chunk, vert_loops->count);
+  for (int i = 0; i < vert_loops->count; i++) {
+    item_loops[i].index = vert_loops->indices[i];
+  }
+  item_normal_compute(data, item_loops, vert_loops->count, data->r_vert_normals[mv_index]);
+}
+
+static void wn_fan_item_cb(void *__restrict userdata,
+                           const int ml_index,
+                           const TaskParallelTLS *__restrict tls)
+{
+  const WeightedNormalItemsData *data = userdata;
+  const MLoopNorSpace *lnor_space = data->lnors_spacearr->lspacearr[ml_index];
+  ModePair *item_loops;
+  int item_loops_num;
+  float normal[3];
+
+  if (lnor_space->flags & MLNOR_SPACE_IS_SINGLE) {
+    item_loops = wn_items_tls_loops_ensure(tls->userdata_chunk, 1);
+    item_loops[0].index = ml_index;
+    item_loops_num = 1;
+  }
+  else {
+    /* Only the first loop of the smooth fan processes it. */
+    if (POINTER_AS_INT(lnor_space->loops->link) != ml_index) {
+      return;
+    }
+    item_loops_num = BLI_linklist_count(lnor_space->loops);
+    item_loops = wn_items_tls_loops_ensure(tls->userdata_chunk, item_loops_num);
+    int i = 0;
+    for (const LinkNode *lnode = lnor_space->loops; lnode; lnode = lnode->next, i++) {
+      item_loops[i].index = POINTER_AS_INT(lnode->link);
+    }
+  }
+
+  item_normal_compute(data, item_loops, item_loops_num, normal);
+
+  if (is_zero_v3(normal)) {
+    return;
+  }
+  for (int i = 0; i < item_loops_num; i++) {
+    copy_v3_v3(data->r_loop_normals[item_loops[i].index], normal);
+  }
+}
+
+static void wn_loop_normal_from_vert_cb(void *__restrict userdata,
+                                        const int ml_index,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const WeightedNormalItemsData *data = userdata;
+  const float *normal = data->r_vert_normals[data->wn_data->mloop[ml_index].v];
+  if (!is_zero_v3(normal)) {
+    copy_v3_v3(data->r_loop_normals[ml_index], normal);
+  }
+}
+
+/** \} */
+
 static void apply_weights_vertex_normal(WeightedNormalModifierData *wnmd,
                                         WeightedNormalData *wn_data)
 {
@@ -199,9 +345,6 @@ static void apply_weights_vertex_normal(WeightedNormalModifierData *wnmd,
 
   MDeformVert *dvert = wn_data->dvert;
 
-  const short mode = wn_data->mode;
-  ModePair *mode_pair = wn_data->mode_pair;
-
   const bool has_clnors = wn_data->has_clnors;
   const float split_angle = wn_data->split_angle;
   MLoopNorSpaceArray lnors_spacearr = {NULL};
@@ -211,16 +354,27 @@ static void apply_weights_vertex_normal(WeightedNormalModifierData *wnmd,
                                   poly_strength != NULL;
   const bool has_vgroup = dvert != NULL;
 
+  /* Smooth fans computed here only match the ones used to set custom normals when they do not
+   * depend on the split angle, the loop normal spaces can then be shared. */
+  const bool share_lnors_spacearr = has_clnors || split_angle >= (float)M_PI;
+
   float(*loop_normals)[3] = NULL;
 
-  WeightedNormalDataAggregateItem *items_data = NULL;
-  int items_num = 0;
-  if (keep_sharp) {
-    BLI_bitmap *done_loops = BLI_BITMAP_NEW(loops_num, __func__);
+  WeightedNormalItemsData items_data = {
+      .wnmd = wnmd,
+      .wn_data = wn_data,
+      .use_face_influence = use_face_influence,
+  };
+  WeightedNormalItemsTLS items_tls = {NULL};
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
 
-    /* This will give us loop normal spaces,
-     * we do not actually care about computed loop_normals for now... */
-    loop_normals = MEM_calloc_arrayN((size_t)loops_num, sizeof(*loop_normals), __func__);
+  if (keep_sharp) {
+    /* This will give us loop normal spaces (one item per smooth fan), and the loop normals
+     * (including current clnors) kept where no valid weighted normal can be computed. */
+    loop_normals = MEM_malloc_arrayN((size_t)loops_num, sizeof(*loop_normals), __func__);
     BKE_mesh_normals_loop_split(mvert,
                                 wn_data->vert_normals,
                                 verts_num,
@@ -238,147 +392,56 @@ static void apply_weights_vertex_normal(WeightedNormalModifierData *wnmd,
                                 has_clnors ? clnors : NULL,
                                 loop_to_poly);
 
-    items_num = lnors_spacearr.spaces_num;
-    items_data = MEM_calloc_arrayN((size_t)items_num, sizeof(*items_data), __func__);
-
-    /* In this first loop, we assign each WeightedNormalDataAggregateItem
-     * to its smooth fan of loops (aka lnor space). */
-    MPoly *mp;
-    int mp_index;
-    int item_index;
-    for (mp = mpoly, mp_index = 0, item_index = 0; mp_index < polys_num; mp++, mp_index++) {
-      int ml_index = mp->loopstart;
-      const int ml_end_index = ml_index + mp->totloop;
-
-      for (; ml_index < ml_end_index; ml_index++) {
-        if (BLI_BITMAP_TEST(done_loops, ml_index)) {
-          /* Smooth fan of this loop has already been processed, skip it. */
-          continue;
-        }
-        BLI_assert(item_index < items_num);
-
-        WeightedNormalDataAggregateItem *itdt = &items_data[item_index];
-        itdt->curr_strength = FACE_STRENGTH_WEAK;
-
-        MLoopNorSpace *lnor_space = lnors_spacearr.lspacearr[ml_index];
-        lnor_space->user_data = itdt;
-
-        if (!(lnor_space->flags & MLNOR_SPACE_IS_SINGLE)) {
-          for (LinkNode *lnode = lnor_space->loops; lnode; lnode = lnode->next) {
-            const int ml_fan_index = POINTER_AS_INT(lnode->link);
-            BLI_BITMAP_ENABLE(done_loops, ml_fan_index);
-          }
-        }
-        else {
-          BLI_BITMAP_ENABLE(done_loops, ml_index);
-        }
-
-        item_index++;
-      }
-    }
-
-    MEM_freeN(done_loops);
+    items_data.lnors_spacearr = &lnors_spacearr;
+    items_data.r_loop_normals = loop_normals;
+
+    settings.use_threading = loops_num > 1024;
+    settings.userdata_chunk = &items_tls;
+    settings.userdata_chunk_size = sizeof(items_tls);
+    settings.func_free = wn_items_tls_free;
+    BLI_task_parallel_range(0, loops_num, &items_data, wn_fan_item_cb, &settings);
+
+    BKE_mesh_normals_loop_custom_set_ex(mvert,
+                                        wn_data->vert_normals,
+                                        verts_num,
+                                        medge,
+                                        edges_num,
+                                        mloop,
+                                        loop_normals,
+                                        loops_num,
+                                        mpoly,
+                                        polynors,
+                                        polys_num,
+                                        clnors,
+                                        share_lnors_spacearr ? &lnors_spacearr : NULL);
   }
   else {
-    items_num = verts_num;
-    items_data = MEM_calloc_arrayN((size_t)items_num, sizeof(*items_data), __func__);
-    if (use_face_influence) {
-      for (int item_index = 0; item_index < items_num; item_index++) {
-        items_data[item_index].curr_strength = FACE_STRENGTH_WEAK;
-      }
-    }
-  }
-  wn_data->items_data = items_data;
-
-  switch (mode) {
-    case MOD_WEIGHTEDNORMAL_MODE_FACE:
-      for (int i = 0; i < polys_num; i++) {
-        const int mp_index = mode_pair[i].index;
-        const float mp_val = mode_pair[i].val;
-
-        int ml_index = mpoly[mp_index].loopstart;
-        const int ml_index_end = ml_index + mpoly[mp_index].totloop;
-        for (; ml_index < ml_index_end; ml_index++) {
-          const int mv_index = mloop[ml_index].v;
-          WeightedNormalDataAggregateItem *item_data =
-              keep_sharp ? lnors_spacearr.lspacearr[ml_index]->user_data : &items_data[mv_index];
-
-          aggregate_item_normal(
-              wnmd, wn_data, item_data, mv_index, mp_index, mp_val, use_face_influence);
-        }
-      }
-      break;
-    case MOD_WEIGHTEDNORMAL_MODE_ANGLE:
-    case MOD_WEIGHTEDNORMAL_MODE_FACE_ANGLE:
-      BLI_assert(loop_to_poly != NULL);
+    MeshElemMap *vert_to_loop;
+    int *vert_to_loop_mem;
+    BKE_mesh_vert_loop_map_create(
+        &vert_to_loop, &vert_to_loop_mem, mpoly, mloop, verts_num, polys_num, loops_num);
 
-      for (int i = 0; i < loops_num; i++) {
-        const int ml_index = mode_pair[i].index;
-        const float ml_val = mode_pair[i].val;
+    /* Loose vertices get a zero normal. */
+    float(*vert_normals)[3] = MEM_malloc_arrayN((size_t)verts_num, sizeof(*vert_normals), __func__);
 
-        const int mp_index = loop_to_poly[ml_index];
-        const int mv_index = mloop[ml_index].v;
-        WeightedNormalDataAggregateItem *item_data =
-            keep_sharp ? lnors_spacearr.lspacearr[ml_index]->user_data : &items_data[mv_index];
+    items_data.vert_to_loop = vert_to_loop;
+    items_data.r_vert_normals = vert_normals;
 
-        aggregate_item_normal(
-            wnmd, wn_data, item_data, mv_index, mp_index, ml_val, use_face_influence);
-      }
-      break;
-    default:
-      BLI_assert_unreachable();
-  }
-
-  /* Validate computed weighted normals. */
-  for (int item_index = 0; item_index < items_num; item_index++) {
-    if (normalize_v3(items_data[item_index].normal) < CLNORS_VALID_VEC_LEN) {
-      zero_v3(items_data[item_index].normal);
-    }
-  }
+    settings.use_threading = verts_num > 1024;
+    settings.userdata_chunk = &items_tls;
+    settings.userdata_chunk_size = sizeof(items_tls);
+    settings.func_free = wn_items_tls_free;
+    BLI_task_parallel_range(0, verts_num, &items_data, wn_vert_item_cb, &settings);
 
-  if (keep_sharp) {
-    /* Set loop normals for normal computed for each lnor space (smooth fan).
-     * Note that loop_normals is already populated with clnors
-     * (before this modifier is applied, at start of this function),
-     * so no need to recompute them here. */
-    for (int ml_index = 0; ml_index < loops_num; ml_index++) {
-      WeightedNormalDataAggregateItem *item_data = lnors_spacearr.lspacearr[ml_index]->user_data;
-      if (!is_zero_v3(item_data->normal)) {
-        copy_v3_v3(loop_normals[ml_index], item_data->normal);
-      }
-    }
+    MEM_freeN(vert_to_loop);
+    MEM_freeN(vert_to_loop_mem);
 
-    BKE_mesh_normals_loop_custom_set(mvert,
-                                     wn_data->vert_normals,
-                                     verts_num,
-                                     medge,
-                                     edges_num,
-                                     mloop,
-                                     loop_normals,
-                                     loops_num,
-                                     mpoly,
-                                     polynors,
-                                     polys_num,
-                                     clnors);
-  }
-  else {
     /* TODO: Ideally, we could add an option to BKE_mesh_normals_loop_custom_[from_vertices_]set()
      * to keep current clnors instead of resetting them to default auto-computed ones,
      * when given new custom normal is zero-vec.
      * But this is not exactly trivial change, better to keep this optimization for later...
      */
     if (!has_vgroup) {
-      /* NOTE: in theory, we could avoid this extra allocation & copying...
-       * But think we can live with it for now,
-       * and it makes code simpler & cleaner. */
-      float(*vert_normals)[3] = MEM_calloc_arrayN(
-          (size_t)verts_num, sizeof(*loop_normals), __func__);
-
-      for (int ml_index = 0; ml_index < loops_num; ml_index++) {
-        const int mv_index = mloop[ml_index].v;
-        copy_v3_v3(vert_normals[mv_index], items_data[mv_index].normal);
-      }
-
       BKE_mesh_normals_loop_custom_from_vertices_set(mvert,
                                                      wn_data->vert_normals,
                                                      vert_normals,
@@ -391,11 +454,9 @@ static void apply_weights_vertex_normal(WeightedNormalModifierData *wnmd,
                                                      polynors,
                                                      polys_num,
                                                      clnors);
-
-      MEM_freeN(vert_normals);
     }
     else {
-      loop_normals = MEM_calloc_arrayN((size_t)loops_num, sizeof(*loop_normals), __func__);
+      loop_normals = MEM_malloc_arrayN((size_t)loops_num, sizeof(*loop_normals), __func__);
 
       BKE_mesh_normals_loop_split(mvert,
                                   wn_data->vert_normals,
@@ -410,145 +471,78 @@ static void apply_weights_vertex_normal(WeightedNormalModifierData *wnmd,
                                   polys_num,
                                   true,
                                   split_angle,
-                                  NULL,
+                                  share_lnors_spacearr ? &lnors_spacearr : NULL,
                                   has_clnors ? clnors : NULL,
                                   loop_to_poly);
 
-      for (int ml_index = 0; ml_index < loops_num; ml_index++) {
-        const int item_index = mloop[ml_index].v;
-        if (!is_zero_v3(items_data[item_index].normal)) {
-          copy_v3_v3(loop_normals[ml_index], items_data[item_index].normal);
-        }
-      }
-
-      BKE_mesh_normals_loop_custom_set(mvert,
-                                       wn_data->vert_normals,
-                                       verts_num,
-                                       medge,
-                                       edges_num,
-                                       mloop,
-                                       loop_normals,
-                                       loops_num,
-                                       mpoly,
-                                       polynors,
-                                       polys_num,
-                                       clnors);
+      items_data.r_loop_normals = loop_normals;
+
+      settings.use_threading = loops_num > 4096;
+      settings.min_iter_per_thread = 4096;
+      settings.userdata_chunk = NULL;
+      settings.userdata_chunk_size = 0;
+      settings.func_free = NULL;
+      BLI_task_parallel_range(0, loops_num, &items_data, wn_loop_normal_from_vert_cb, &settings);
+
+      BKE_mesh_normals_loop_custom_set_ex(mvert,
+                                          wn_data->vert_normals,
+                                          verts_num,
+                                          medge,
+                                          edges_num,
+                                          mloop,
+                                          loop_normals,
+                                          loops_num,
+                                          mpoly,
+                                          polynors,
+                                          polys_num,
+                                          clnors,
+                                          share_lnors_spacearr ? &lnors_spacearr : NULL);
     }
+
+    MEM_freeN(vert_normals);
   }
 
-  if (keep_sharp) {
+  if (lnors_spacearr.mem != NULL) {
     BKE_lnor_spacearr_free(&lnors_spacearr);
   }
   MEM_SAFE_FREE(loop_normals);
 }
 
-static void wn_face_area(WeightedNormalModifierData *wnmd, WeightedNormalData *wn_data)
-{
-  const int polys_num = wn_data->polys_num;
-
-  MVert *mvert = wn_data->mvert;
-  MLoop *mloop = wn_data->mloop;
-  MPoly *mpoly = wn_data->mpoly;
-
-  MPoly *mp;
-  int mp_index;
-
-  ModePair *face_area = MEM_malloc_arrayN((size_t)polys_num, sizeof(*face_area), __func__);
-
-  ModePair *f_area = face_area;
-  for (mp_index = 0, mp = mpoly; mp_index < polys_num; mp_index++, mp++, f_area++) {
-    f_area->val = BKE_mesh_calc_poly_area(mp, &mloop[mp->loopstart], mvert);
-    f_area->index = mp_index;
-  }
-
-  qsort(face_area, polys_num, sizeof(*face_area), modepair_cmp_by_val_inverse);
-
-  wn_data->mode_pair = face_area;
-  apply_weights_vertex_normal(wnmd, wn_data);
-}
-
-static void wn_corner_angle(WeightedNormalModifierData *wnmd, WeightedNormalData *wn_data)
+static void wn_loop_values_cb(void *__restrict userdata,
+                              const int mp_index,
+                              const TaskParallelTLS *__restrict UNUSED(tls))
 {
-  const int loops_num = wn_data->loops_num;
-  const int polys_num = wn_data->polys_num;
-
-  MVert *mvert = wn_data->mvert;
-  MLoop *mloop = wn_data->mloop;
-  MPoly *mpoly = wn_data->mpoly;
-
-  MPoly *mp;
-  int mp_index;
-
-  int *loop_to_poly = MEM_malloc_arrayN((size_t)loops_num, sizeof(*loop_to_poly), __func__);
-
-  ModePair *corner_angle = MEM_malloc_arrayN((size_t)loops_num, sizeof(*corner_angle), __func__);
-
-  for (mp_index = 0, mp = mpoly; mp_index < polys_num; mp_index++, mp++) {
-    MLoop *ml_start = &mloop[mp->loopstart];
-
-    float *index_angle = MEM_malloc_arrayN((size_t)mp->totloop, sizeof(*index_angle), __func__);
-    BKE_mesh_calc_poly_angles(mp, ml_start, mvert, index_angle);
-
-    ModePair *c_angl = &corner_angle[mp->loopstart];
-    float *angl = index_angle;
-    for (int ml_index = mp->loopstart; ml_index < mp->loopstart + mp->totloop;
-         ml_index++, c_angl++, angl++) {
-      c_angl->val = (float)M_PI - *angl;
-      c_angl->index = ml_index;
-
-      loop_to_poly[ml_index] = mp_index;
+  WeightedNormalData *wn_data = userdata;
+  const MPoly *mp = &wn_data->mpoly[mp_index];
+  const MLoop *ml_start = &wn_data->mloop[mp->loopstart];
+  float *values = &wn_data->loop_values[mp->loopstart];
+
+  switch (wn_data->mode) {
+    case MOD_WEIGHTEDNORMAL_MODE_FACE: {
+      const float face_area = BKE_mesh_calc_poly_area(mp, ml_start, wn_data->mvert);
+      copy_vn_fl(values, mp->totloop, face_area);
+      break;
     }
-    MEM_freeN(index_angle);
-  }
-
-  qsort(corner_angle, loops_num, sizeof(*corner_angle), modepair_cmp_by_val_inverse);
-
-  wn_data->loop_to_poly = loop_to_poly;
-  wn_data->mode_pair = corner_angle;
-  apply_weights_vertex_normal(wnmd, wn_data);
-}
-
-static void wn_face_with_angle(WeightedNormalModifierData *wnmd, WeightedNormalData *wn_data)
-{
-  const int loops_num = wn_data->loops_num;
-  const int polys_num = wn_data->polys_num;
-
-  MVert *mvert = wn_data->mvert;
-  MLoop *mloop = wn_data->mloop;
-  MPoly *mpoly = wn_data->mpoly;
-
-  MPoly *mp;
-  int mp_index;
-
-  int *loop_to_poly = MEM_malloc_arrayN((size_t)loops_num, sizeof(*loop_to_poly), __func__);
-
-  ModePair *combined = MEM_malloc_arrayN((size_t)loops_num, sizeof(*combined), __func__);
-
-  for (mp_index = 0, mp = mpoly; mp_index < polys_num; mp_index++, mp++) {
-    MLoop *ml_start = &mloop[mp->loopstart];
-
-    float face_area = BKE_mesh_calc_poly_area(mp, ml_start, mvert);
-    float *index_angle = MEM_malloc_arrayN((size_t)mp->totloop, sizeof(*index_angle), __func__);
-    BKE_mesh_calc_poly_angles(mp, ml_start, mvert, index_angle);
-
-    ModePair *cmbnd = &combined[mp->loopstart];
-    float *angl = index_angle;
-    for (int ml_index = mp->loopstart; ml_index < mp->loopstart + mp->totloop;
-         ml_index++, cmbnd++, angl++) {
-      /* In this case val is product of corner angle and face area. */
-      cmbnd->val = ((float)M_PI - *angl) * face_area;
-      cmbnd->index = ml_index;
-
-      loop_to_poly[ml_index] = mp_index;
+    case MOD_WEIGHTEDNORMAL_MODE_ANGLE:
+      BKE_mesh_calc_poly_angles(mp, ml_start, wn_data->mvert, values);
+      for (int i = 0; i < mp->totloop; i++) {
+        values[i] = (float)M_PI - values[i];
+      }
+      break;
+    case MOD_WEIGHTEDNORMAL_MODE_FACE_ANGLE: {
+      const float face_area = BKE_mesh_calc_poly_area(mp, ml_start, wn_data->mvert);
+      BKE_mesh_calc_poly_angles(mp, ml_start, wn_data->mvert, values);
+      for (int i = 0; i < mp->totloop; i++) {
+        /* In this case val is product of corner angle and face area. */
+        values[i] = ((float)M_PI - values[i]) * face_area;
+      }
+      break;
     }
-    MEM_freeN(index_angle);
+    default:
+      BLI_assert_unreachable();
   }
 
-  qsort(combined, loops_num, sizeof(*combined), modepair_cmp_by_val_inverse);
-
-  wn_data->loop_to_poly = loop_to_poly;
-  wn_data->mode_pair = combined;
-  apply_weights_vertex_normal(wnmd, wn_data);
+  copy_vn_i(&wn_data->loop_to_poly[mp->loopstart], mp->totloop, mp_index);
 }
 
 static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *mesh)
@@ -644,21 +638,25 @@ static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *
       .mode = wnmd->mode,
   };
 
-  switch (wnmd->mode) {
-    case MOD_WEIGHTEDNORMAL_MODE_FACE:
-      wn_face_area(wnmd, &wn_data);
-      break;
-    case MOD_WEIGHTEDNORMAL_MODE_ANGLE:
-      wn_corner_angle(wnmd, &wn_data);
-      break;
-    case MOD_WEIGHTEDNORMAL_MODE_FACE_ANGLE:
-      wn_face_with_angle(wnmd, &wn_data);
-      break;
+  for (int i = 0; i < NUM_CACHED_INVERSE_POWERS_OF_WEIGHT; i++) {
+    wn_data.cached_inverse_powers_of_weight[i] = 1.0f / powf(weight, i);
   }
 
-  MEM_SAFE_FREE(wn_data.loop_to_poly);
-  MEM_SAFE_FREE(wn_data.mode_pair);
-  MEM_SAFE_FREE(wn_data.items_data);
+  wn_data.loop_values = MEM_malloc_arrayN(
+      (size_t)loops_num, sizeof(*wn_data.loop_values), __func__);
+  wn_data.loop_to_poly = MEM_malloc_arrayN(
+      (size_t)loops_num, sizeof(*wn_data.loop_to_poly), __func__);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = polys_num > 1024;
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, polys_num, &wn_data, wn_loop_values_cb, &settings);
+
+  apply_weights_vertex_normal(wnmd, &wn_data);
+
+  MEM_freeN(wn_data.loop_values);
+  MEM_freeN(wn_data.loop_to_poly);
 
   result->runtime.is_original = false;
 
@@ -42,10 +42,12 @@
 #include "intern/BlenderMfxHost.h"
 #include "TinyTimer.h"
 
+#include <OpenMfx/Sdk/Cpp/Host/EffectInstancePool>
 #include <OpenMfx/Sdk/Cpp/Host/MeshEffect>
 #include <OpenMfx/Sdk/Cpp/Host/Properties>
 
 using MeshInternalDataNode = BlenderMfxHost::MeshInternalDataNode;
+using OpenMfx::EffectInstancePool;
 using OpenMfx::AttributeProps;
 
 namespace blender::nodes::node_geo_open_mfx_cc {
@@ -131,6 +133,9 @@ static void MFX_node_add_attrib_input(NodeDeclarationBuilder &b, const OfxAttrib
       }
       break;
     case OpenMfx::AttributeType::Int:
+    case OpenMfx::AttributeType::Int8:
+    case OpenMfx::AttributeType::Int16:
+      // Compact integers are widened to int
       if (componentCount == 1) {
         b.add_input<decl::Int>(name).supports_field();
       }
@@ -139,6 +144,7 @@ static void MFX_node_add_attrib_input(NodeDeclarationBuilder &b, const OfxAttrib
       }
       break;
     case OpenMfx::AttributeType::UByte:
+    default:
       BLI_assert(false);  // Unsupported combination
       break;
   }
@@ -166,6 +172,9 @@ static void MFX_node_add_attrib_output(NodeDeclarationBuilder &b, const OfxAttri
       }
       break;
     case OpenMfx::AttributeType::Int:
+    case OpenMfx::AttributeType::Int8:
+    case OpenMfx::AttributeType::Int16:
+      // Compact integers are widened to int
       if (componentCount == 1) {
         b.add_output<decl::Int>(name).field_source();
       }
@@ -174,6 +183,7 @@ static void MFX_node_add_attrib_output(NodeDeclarationBuilder &b, const OfxAttri
       }
       break;
     case OpenMfx::AttributeType::UByte:
+    default:
       BLI_assert(false);  // Unsupported combination
       break;
   }
@@ -308,6 +318,15 @@ static void MFX_node_extract_param(GeoNodeExecParams &b, OfxParamStruct &param)
   }
 }
 
+/**
+ * Integer attributes, exposed as int sockets whatever their width.
+ */
+static bool MFX_is_integer(OpenMfx::AttributeType mfxType)
+{
+  return mfxType == OpenMfx::AttributeType::Int || mfxType == OpenMfx::AttributeType::Int8 ||
+         mfxType == OpenMfx::AttributeType::Int16;
+}
+
 static const CPPType &MFX_to_cpptype(OpenMfx::AttributeType mfxType, int componentCount)
 {
   // TODO: use componentCount
@@ -323,6 +342,8 @@ static const CPPType &MFX_to_cpptype(OpenMfx::AttributeType mfxType, int compone
         return CPPType::get<int>();
       }
     case OfxAttributeStruct::AttributeType::Int:
+    case OfxAttributeStruct::AttributeType::Int8:
+    case OfxAttributeStruct::AttributeType::Int16:
       return CPPType::get<int>();
     default:
       BLI_assert(false);  // not implemented
@@ -766,7 +787,18 @@ static void node_geo_exec(GeoNodeExecParams params)
 {
   TinyTimer::Timer timer;
   const NodeGeometryOpenMfx &storage = node_storage(params.node());
-  OfxMeshEffectHandle effect = storage.runtime->effectInstance();
+  EffectInstancePool *pool = storage.runtime->instancePool();
+
+  if (pool == nullptr) {
+    params.error_message_add(NodeWarningType::Info, TIP_("Could not load effect"));
+    params.set_default_remaining_outputs();
+    return;
+  }
+
+  // The same node may be evaluated in several contexts at once, each of which needs its own
+  // instance since the inputs and parameters are stored in it.
+  EffectInstancePool::Lease lease(*pool);
+  OfxMeshEffectHandle effect = lease.get();
 
   if (effect == nullptr) {
     params.error_message_add(NodeWarningType::Info, TIP_("Could not load effect"));
@@ -861,6 +893,8 @@ static void node_geo_exec(GeoNodeExecParams params)
               
               break;
             case OfxAttributeStruct::AttributeType::Int:
+            case OfxAttributeStruct::AttributeType::Int8:
+            case OfxAttributeStruct::AttributeType::Int16:
               field = params.get_input<Field<int>>(def.name());
               break;
             default:
@@ -900,6 +934,10 @@ static void node_geo_exec(GeoNodeExecParams params)
             
           attrib.properties[kOfxMeshAttribPropData].value[0].as_pointer = data;
           attrib.properties[kOfxMeshAttribPropStride].value[0].as_int = type.size();
+          if (MFX_is_integer(def.type())) {
+            // Compact integers were evaluated into an int buffer
+            attrib.setType(OpenMfx::AttributeType::Int);
+          }
         }
 
         // --------
@@ -948,7 +986,10 @@ static void node_geo_exec(GeoNodeExecParams params)
   }
 
   TinyTimer::Timer subtimer;
-  bool success = host.Cook(effect);
+  // Cooks of thread unsafe effects wait for each other, make sure that the waiting thread does
+  // not pick up another evaluation of an unsafe effect meanwhile.
+  bool success = false;
+  threading::isolate_task([&]() { success = host.Cook(effect); });
   PERF(1).add_sample(subtimer);
 
   if (!success) {
@@ -1029,10 +1070,17 @@ static void node_geo_exec(GeoNodeExecParams params)
       const auto &attribInfo = outputIt->requestedAttributes[j];
       const auto &attrib = outputIt->outputAttributes[j];
       //if (params.output_is_required(attribInfo.name())) {
-        // TODO: switch on type
-        params.set_output(attribInfo.name(),
-                          AnonymousAttributeFieldInput::Create<float>(
-                              std::move(attrib), params.attribute_producer_name()));
+        // TODO: switch on the number of components
+        if (MFX_is_integer(attribInfo.type())) {
+          params.set_output(attribInfo.name(),
+                            AnonymousAttributeFieldInput::Create<int>(
+                                std::move(attrib), params.attribute_producer_name()));
+        }
+        else {
+          params.set_output(attribInfo.name(),
+                            AnonymousAttributeFieldInput::Create<float>(
+                                std::move(attrib), params.attribute_producer_name()));
+        }
 
         outputIt->outputAttributes[j] = {};
       //}
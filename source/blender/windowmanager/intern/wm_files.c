@@ -2650,6 +2650,9 @@ static int wm_open_mainfile__open(bContext *C, wmOperator *op)
   wm_open_init_use_scripts(op, false);
 
   SET_FLAG_FROM_TEST(G.fileflags, !RNA_boolean_get(op->ptr, "load_ui"), G_FILE_NO_UI);
+  SET_FLAG_FROM_TEST(G.fileflags,
+                     RNA_boolean_get(op->ptr, "use_lazy_packed_data"),
+                     G_FILE_LAZY_PACKED_DATA);
   SET_FLAG_FROM_TEST(G.f, RNA_boolean_get(op->ptr, "use_scripts"), G_FLAG_SCRIPT_AUTOEXEC);
   success = wm_file_read_opwrap(C, filepath, op->reports);
 
@@ -2818,7 +2821,15 @@ void WM_OT_open_mainfile(wmOperatorType *ot)
   wm_open_mainfile_def_property_use_scripts(ot);
 
   PropertyRNA *prop = RNA_def_boolean(
-      ot->srna, "display_file_selector", true, "Display File Selector", "");
+      ot->srna,
+      "use_lazy_packed_data",
+      false,
+      "Lazy Packed Data",
+      "Only load large packed files from uncompressed .blend files when they are accessed, "
+      "this file and the libraries it links stay mapped in memory until the data is freed");
+  RNA_def_property_flag(prop, PROP_SKIP_SAVE);
+
+  prop = RNA_def_boolean(ot->srna, "display_file_selector", true, "Display File Selector", "");
   RNA_def_property_flag(prop, PROP_SKIP_SAVE);
 
   create_operator_state(ot, OPEN_MAINFILE_STATE_DISCARD_CHANGES);